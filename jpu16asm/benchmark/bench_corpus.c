@@ -0,0 +1,204 @@
+//+-----------------------------------------------------------------------------------------------+
+//| bench_corpus.c                                                                                |
+//| Prueba de rendimiento del ensamblador con programas sinteticos                                |
+//|                                                                                               |
+//| Este programa genera programas de distintos tamaños (corpus) y los ensambla con las memorias  |
+//| de mayor capacidad (-p 16384 -r 32768), generando todos los formatos de salida hacia          |
+//| /dev/null. Cada corpus tiene muchas etiquetas, referencias hacia adelante en expresiones      |
+//| (que pasan por las reglas exp_sim y la cola de acciones), tablas largas de datos con word y   |
+//| constantes definidas con equ. Cuando el codigo y los datos llenan las memorias, el resto de   |
+//| las lineas son constantes, de manera que el tamaño del corpus no esta limitado por las        |
+//| memorias.                                                                                     |
+//| Reporta el costo de cada etapa (medido con las mismas funciones de la opcion -stats) y las    |
+//| lineas por segundo, tomando la mejor de varias repeticiones.                                  |
+//| Con los argumentos -g lineas archivo solo escribe un corpus en un archivo, util para          |
+//| ensamblarlo con jpu16asm y sus opciones.                                                      |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdio.h>                      //Permite imprimir los resultados y escribir archivos
+#include <stdlib.h>                     //Permite invocar malloc, realloc, atoi y free
+#include <string.h>                     //Permite manejar cadenas
+#include <stdarg.h>                     //Permite manejar listas variables de argumentos
+#include "../j16asm.h"                  //Importa el contexto de ensamblado
+#include "../j16asm_ensamblador.h"      //Permite crear contextos y ejecutar los pasos
+#include "../j16asm_salida.h"           //Permite generar los archivos de salida
+#include "../j16asm_output_vhdl.h"      //Importa los formatos de salida
+#include "../j16asm_output_vhdl_ramb16.h"
+#include "../j16asm_output_mem_bmm.h"
+#include "../j16asm_output_desensamblado.h"
+#include "../j16asm_estadisticas.h"     //Permite medir cada etapa
+
+#define TAM_PRG 16384                   //Capacidad de la memoria de programa (la mayor)
+#define TAM_RAM 32768                   //Capacidad de la memoria RAM (la mayor)
+#define CONSTANTES 256                  //Constantes que usan las instrucciones y los datos
+#define INSTR_BLOQUE 4                  //Instrucciones de cada bloque
+#define PALABRAS_BLOQUE 8               //Palabras de la tabla de cada bloque
+#define REPETICIONES 5                  //Cada corpus se ensambla varias veces (se toma la mejor)
+
+//Texto que crece a medida que se le agregan lineas
+typedef struct _TEXTO {
+  char *datos;                          //Texto acumulado
+  size_t usado;                         //Cantidad de caracteres del texto
+  size_t capacidad;                     //Tamaño del arreglo alojado
+  int lineas;                           //Cantidad de lineas del texto
+} TEXTO;
+
+//Funcion para agregar texto con formato (cuenta una linea si el texto termina en fin de linea)
+static void agregar(TEXTO *texto, const char *formato, ...) {
+  va_list argumentos;
+  size_t longitud;
+
+  //Las piezas del corpus son cortas, asi que basta con dejar 256 caracteres libres
+  if (texto->capacidad - texto->usado < 256) {
+    texto->capacidad = texto->capacidad ? texto->capacidad * 2 : 65536;
+    texto->datos = realloc(texto->datos, texto->capacidad);
+  }
+  va_start(argumentos, formato);
+  longitud = vsnprintf(texto->datos + texto->usado, 256, formato, argumentos);
+  va_end(argumentos);
+  texto->usado += longitud;
+  if (longitud && texto->datos[texto->usado - 1] == '\n') texto->lineas++;
+}
+
+//Funcion para generar un corpus con aproximadamente la cantidad de lineas indicada. El codigo se
+//divide en bloques de 4 instrucciones con una tabla de 8 palabras cada uno; las instrucciones
+//usan la tabla y el bloque siguientes (aun no definidos) y las tablas usan etiquetas de codigo
+static void generar_corpus(TEXTO *texto, int lineas) {
+  int bloques, extra, i, j;
+
+  //Cantidad de bloques que caben en las memorias (y en las lineas pedidas)
+  bloques = (lineas - CONSTANTES - 4) / 5;
+  if (bloques > (TAM_PRG - 1) / INSTR_BLOQUE) bloques = (TAM_PRG - 1) / INSTR_BLOQUE;
+  if (bloques > (TAM_RAM - 1) / PALABRAS_BLOQUE) bloques = (TAM_RAM - 1) / PALABRAS_BLOQUE;
+  if (bloques < 1) bloques = 1;
+  extra = lineas - CONSTANTES - 4 - bloques * 5;
+
+  texto->usado = 0;
+  texto->lineas = 0;
+
+  //Constantes (las adicionales se encadenan, de manera que cada una busca la anterior)
+  for (i=0; i<CONSTANTES; i++)
+    agregar(texto, "c_%d equ %d * 3 + 1\n", i, i);
+  if (extra > 0) agregar(texto, "x_0 equ 0\n");
+  for (i=1; i<extra; i++)
+    agregar(texto, "x_%d equ x_%d + 1 ; constante adicional\n", i, i - 1);
+
+  //Bloques de codigo
+  agregar(texto, "code\n");
+  for (i=0; i<bloques; i++) {
+    agregar(texto, "r_%d: move r1, t_%d + c_%d\n", i, i + 1, i % CONSTANTES);
+    agregar(texto, "  add r2, (r_%d - r_%d) << 1\n", i + 1, i);
+    agregar(texto, "  jmpz r_%d\n", i + 1);
+    agregar(texto, "  call r_%d\n", bloques);
+  }
+  agregar(texto, "r_%d: return\n", bloques);
+
+  //Tablas de datos
+  agregar(texto, "data\n");
+  for (i=0; i<bloques; i++) {
+    agregar(texto, "t_%d: word r_%d, t_%d - t_%d, c_%d", i, i, i + 1, i, (i * 7) % CONSTANTES);
+    for (j=3; j<PALABRAS_BLOQUE; j++) agregar(texto, ", 0x%X", (i * 31 + j) & 0xFFFF);
+    agregar(texto, "\n");
+  }
+  agregar(texto, "t_%d: word 0\n", bloques);
+}
+
+//Funcion para ensamblar un corpus y generar todas las salidas, midiendo cada etapa
+static bool ensamblar_corpus(CONTEXTO_ASM *ctx, const TEXTO *texto,
+                             ESTADISTICAS_ENSAMBLADO *estadisticas) {
+  static const FORMATO_SALIDA *formatos[] = {
+    &formato_vhdl, &formato_vhdl_ramb16, &formato_mem, &formato_bmm, &formato_desensamblado
+  };
+  static const char *nombres[] = {
+    "/dev/null", "/dev/null", "/dev/null", "/dev/null", "/dev/null"
+  };
+  MARCA_MEDICION marca;
+  bool exito;
+
+  reiniciar_contexto(ctx);
+  memset(estadisticas, 0, sizeof(ESTADISTICAS_ENSAMBLADO));
+  ctx->estadisticas = estadisticas;
+
+  tomar_marca(ctx, &marca);
+  exito = proceso_paso_1_memoria(ctx, texto->datos, texto->usado);
+  medir_etapa(ctx, EM_PASO_1, &marca);
+  if (!exito) return false;
+  medir_estructuras(ctx);
+
+  tomar_marca(ctx, &marca);
+  exito = proceso_paso_2(ctx);
+  medir_etapa(ctx, EM_PASO_2, &marca);
+  if (!exito) return false;
+
+  return generar_salidas(ctx, formatos, nombres, 5);
+}
+
+//Funcion que suma el tiempo de todas las salidas
+static double tiempo_salidas(const ESTADISTICAS_ENSAMBLADO *estadisticas) {
+  double segundos = 0;
+  int i;
+
+  for (i=0; i<estadisticas->num_salidas; i++) segundos += estadisticas->salidas[i].segundos;
+  return segundos;
+}
+
+int main(int argc, char *argv[]) {
+  static const int tamanos[] = { 2000, 20000, 200000, 1000000, 0 };
+  TEXTO texto = { NULL, 0, 0, 0 };
+  ESTADISTICAS_ENSAMBLADO estadisticas, mejor;
+  CONTEXTO_ASM *ctx;
+  FILE *fp_archivo;
+  double total, mejor_total;
+  int i, n;
+
+  //Con -g solo se escribe un corpus en el archivo indicado
+  if (argc == 4 && strcmp(argv[1], "-g") == 0) {
+    generar_corpus(&texto, atoi(argv[2]));
+    fp_archivo = fopen(argv[3], "w");
+    if (!fp_archivo || fwrite(texto.datos, 1, texto.usado, fp_archivo) != texto.usado) {
+      printf("Error al escribir el archivo: %s\n", argv[3]);
+      return 1;
+    }
+    fclose(fp_archivo);
+    printf("%s: %d lineas (ensamblar con -p %d -r %d)\n", argv[3], texto.lineas, TAM_PRG,
+           TAM_RAM);
+    free(texto.datos);
+    return 0;
+  }
+
+  ctx = crear_contexto(TAM_PRG, TAM_RAM);
+  snprintf(ctx->nombre_archivo_ent, sizeof(ctx->nombre_archivo_ent), "corpus.asm");
+  printf("%9s %10s %10s %10s %10s %12s %9s %9s %11s\n", "lineas", "paso 1 ms", "paso 2 ms",
+         "salidas ms", "total ms", "lineas/s", "simbolos", "acciones", "alojamient.");
+
+  for (n=0; tamanos[n]; n++) {
+    generar_corpus(&texto, tamanos[n]);
+
+    //Se toma la repeticion mas rapida (la primera suele pagar el costo de las paginas nuevas)
+    mejor_total = 0;
+    for (i=0; i<REPETICIONES; i++) {
+      if (!ensamblar_corpus(ctx, &texto, &estadisticas)) {
+        printf("Error al ensamblar el corpus de %d lineas\n", texto.lineas);
+        destruir_contexto(ctx);
+        free(texto.datos);
+        return 1;
+      }
+      total = estadisticas.etapas[EM_PASO_1].segundos + estadisticas.etapas[EM_PASO_2].segundos +
+              tiempo_salidas(&estadisticas);
+      if (!i || total < mejor_total) {
+        mejor_total = total;
+        mejor = estadisticas;
+      }
+    }
+
+    printf("%9d %10.3f %10.3f %10.3f %10.3f %12.0f %9u %9d %11lu\n", texto.lineas,
+           mejor.etapas[EM_PASO_1].segundos * 1e3, mejor.etapas[EM_PASO_2].segundos * 1e3,
+           tiempo_salidas(&mejor) * 1e3, mejor_total * 1e3, texto.lineas / mejor_total,
+           mejor.simbolos, mejor.max_acciones,
+           mejor.etapas[EM_PASO_1].alojamientos + mejor.etapas[EM_PASO_2].alojamientos);
+  }
+
+  ctx->estadisticas = NULL;
+  destruir_contexto(ctx);
+  free(texto.datos);
+  return 0;
+}
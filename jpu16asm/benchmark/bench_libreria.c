@@ -0,0 +1,77 @@
+//+-----------------------------------------------------------------------------------------------+
+//| bench_libreria.c                                                                              |
+//| Prueba de rendimiento de la libreria del ensamblador                                          |
+//|                                                                                               |
+//| Este programa genera en memoria miles de fragmentos de codigo (con etiquetas, constantes y    |
+//| referencias hacia adelante, de manera que intervengan ambos pasos) y los ensambla uno tras    |
+//| otro con el mismo ensamblador, sin crear procesos ni tocar el sistema de archivos. Reporta el |
+//| tiempo promedio por fragmento y verifica que cada uno genere la cantidad esperada de          |
+//| instrucciones.                                                                                |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdio.h>                      //Permite imprimir los resultados
+#include <time.h>                       //Permite medir el tiempo transcurrido
+#include "../j16asm_libreria.h"         //Importa la interfaz publica del ensamblador
+
+#define FRAGMENTOS 20000                //Cantidad de fragmentos ensamblados en cada medicion
+#define TAM_TEXTO 65536                //Tamaño del buffer donde se genera cada fragmento
+
+//Funcion para obtener el tiempo actual en nanosegundos
+static double tiempo_ns() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+//Funcion para generar un fragmento con la cantidad de instrucciones indicada (cada una salta a la
+//siguiente etiqueta, la cual aun no esta definida)
+static int generar_fragmento(char *texto, int semilla, int instrucciones) {
+  int n = 0;
+  int i;
+
+  n += sprintf(texto + n, "limite equ %d\n", semilla & 0xFF);
+  for (i=0; i<instrucciones; i++) {
+    n += sprintf(texto + n, "et_%d: add r%d, limite + %d\n", i, i & 15, (semilla + i) & 0x7F);
+    n += sprintf(texto + n, "jmpz et_%d\n", i + 1);
+  }
+  n += sprintf(texto + n, "et_%d: return\n", instrucciones);
+  return n;
+}
+
+int main() {
+  static const int tamanos[] = { 4, 32, 128, 0 };
+  static char texto[TAM_TEXTO];
+  double inicio, t_total;
+  int i, n, tam;
+  JPU16ASM *ensamblador;
+
+  ensamblador = jpu16asm_crear(16384, 1024);
+  printf("%14s %16s %18s\n", "instrucciones", "us/fragmento", "fragmentos/s");
+
+  for (n=0; tamanos[n]; n++) {
+    //Se ensambla cada fragmento recien generado (cada uno con valores distintos)
+    inicio = tiempo_ns();
+    for (i=0; i<FRAGMENTOS; i++) {
+      tam = generar_fragmento(texto, i, tamanos[n]);
+      if (!jpu16asm_ensamblar(ensamblador, "fragmento.asm", texto, tam) ||
+          jpu16asm_contar_prg(ensamblador) != tamanos[n] * 2 + 1) {
+        printf("Error al ensamblar el fragmento %d\n", i);
+        jpu16asm_destruir(ensamblador);
+        return 1;
+      }
+    }
+    t_total = tiempo_ns() - inicio;
+
+    //Descuenta el costo de generar los fragmentos para aislar el costo del ensamblado
+    inicio = tiempo_ns();
+    for (i=0; i<FRAGMENTOS; i++)
+      generar_fragmento(texto, i, tamanos[n]);
+    t_total -= tiempo_ns() - inicio;
+
+    printf("%14d %16.2f %18.0f\n", tamanos[n] * 2 + 1,
+           t_total / FRAGMENTOS / 1e3, FRAGMENTOS / (t_total / 1e9));
+  }
+
+  jpu16asm_destruir(ensamblador);
+  return 0;
+}
@@ -0,0 +1,74 @@
+//+-----------------------------------------------------------------------------------------------+
+//| bench_simbolos.c                                                                              |
+//| Prueba de rendimiento de la lista de simbolos                                                 |
+//|                                                                                               |
+//| Este programa llena la lista de simbolos con cantidades crecientes de nombres (similares a    |
+//| las etiquetas que genera un programa de gran tamaño) y mide el tiempo promedio de busqueda    |
+//| con buscar_simbolo(). Con la tabla hash el costo por busqueda debe mantenerse practicamente   |
+//| constante sin importar la cantidad de simbolos almacenados.                                   |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdio.h>                      //Permite imprimir los resultados
+#include <stdlib.h>                     //Permite invocar atoi()
+#include <time.h>                       //Permite medir el tiempo transcurrido
+#include "../j16asm_dat_struct.h"       //Importa las funciones de la lista de simbolos
+
+#define BUSQUEDAS 2000000               //Cantidad de busquedas realizadas en cada medicion
+
+//Funcion para obtener el tiempo actual en nanosegundos
+static double tiempo_ns() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(int argc, char *argv[]) {
+  static const int cantidades[] = { 100, 1000, 10000, 100000, 0 };
+  char nombre[32];
+  double inicio, t_insercion, t_busqueda;
+  unsigned int semilla = 12345;
+  int i, n, encontrados;
+  LISTA_SIMBOLOS lista = LISTA_SIMBOLOS_VACIA;
+
+  printf("%10s %16s %16s\n", "simbolos", "ns/insercion", "ns/busqueda");
+
+  for (n=0; cantidades[n]; n++) {
+    //Llena la lista con nombres de etiqueta generados
+    inicio = tiempo_ns();
+    for (i=0; i<cantidades[n]; i++) {
+      sprintf(nombre, "etiqueta_%d", i);
+      agregar_simbolo(&lista, nombre, i, i);
+    }
+    t_insercion = tiempo_ns() - inicio;
+
+    //Busca nombres existentes elegidos de forma pseudoaleatoria
+    encontrados = 0;
+    inicio = tiempo_ns();
+    for (i=0; i<BUSQUEDAS; i++) {
+      semilla = semilla * 1103515245 + 12345;
+      sprintf(nombre, "etiqueta_%d", (semilla >> 8) % cantidades[n]);
+      if (buscar_simbolo(&lista, nombre)) encontrados++;
+    }
+    t_busqueda = tiempo_ns() - inicio;
+
+    //Descuenta el costo de generar los nombres para aislar el costo de la busqueda
+    inicio = tiempo_ns();
+    for (i=0; i<BUSQUEDAS; i++) {
+      semilla = semilla * 1103515245 + 12345;
+      sprintf(nombre, "etiqueta_%d", (semilla >> 8) % cantidades[n]);
+    }
+    t_busqueda -= tiempo_ns() - inicio;
+
+    if (encontrados != BUSQUEDAS) {
+      printf("Error: %d simbolos no encontrados\n", BUSQUEDAS - encontrados);
+      return 1;
+    }
+
+    printf("%10d %16.1f %16.1f\n", cantidades[n],
+           t_insercion / cantidades[n], t_busqueda / BUSQUEDAS);
+
+    desalojar_simbolos(&lista);
+  }
+
+  return 0;
+}
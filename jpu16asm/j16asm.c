@@ -2,89 +2,50 @@
 //| j16asm.c                                                                                      |
 //| Modulo principal del programa                                                                 |
 //|                                                                                               |
-//| Este modulo provee la funcion principal del ensamblador y se encarga de llevar a cabo las     |
-//| tareas principales del mismo. El paso 1 de compilacion se lleva a cabo por medio de invocar   |
-//| la funcion  yyparse(), la cual es provista por bison en el modulo de codigo fuente que genera |
-//| mediante el archivo de gramatica asociado.                                                    |
-//| El paso 2 de compilacion se lleva a cabo mediante la funcion proceso_paso_2(), las funciones  |
-//| agregar_dato_ram() y agregar_dato_prg() proveen mecanismos para agregar datos a los espacios  |
-//| de memoria que maneja JPU16 durante el paso 1 y la generacion de los datos de salida (codigo  |
-//| de maquina) se lleva a cabo en la funcion generar_salida().                                   |
-//|                                                                                               |
-//| Las actividades generadas en el paso 1 son las siguientes:                                    |
-//| - Analisis lexico - yylex() (leer el archivo de entrada y reconocer las palabras)             |
-//| - Analisis sintactico - yyparse (identificar el orden de las palabras y las estructuras que   |
-//|   forman, asociando significados a sus agrupaciones).                                         |
-//| - Identificacion de simbolos y creacion de la tabla de simbolos.                              |
-//| - Alojamiento de espacio en la memoria RAM y de programa e inicializacion de los datos.       |
-//| - Evaluacion de expresiones aritmeticas literales.                                            |
-//| - Evaluacion de expresiones simbolicas en aquellos casos donde los valores de los simbolos    |
-//|   son previamente conocidos                                                                   |
-//| - Identificacion de expresiones simbolicas en aquellos casos donde no se sabe el valor de     |
-//|   todos los simbolos con anterioridad, para ser postergadas al paso 2 mediante una cola de    |
-//|   acciones.                                                                                   |
-//|                                                                                               |
-//| Las actividades generadas en el paso 2 son las siguientes:                                    |
-//| - Realizacion de todas las actividades guardadas en la cola de acciones, las cuales indican   |
-//|   las operaciones postergadas del paso 1.                                                     |
-//| - Determinacion de los valores de los simbolos cuyo valor no era conocido en el paso 1,       |
-//|   mediante los datos registrados en la tabla de simbolos que ahora esta completa.             |
-//| - Calculo de expresiones aritmeticas mediante una pila de datos, usando notacion polaca       |
-//|   inversa.                                                                                    |
-//| - Almacenamiento de los resultados generados en la memoria RAM y de programa.                 |
+//| Este modulo provee la funcion principal del ensamblador de linea de comandos. Se encarga de   |
+//| interpretar los argumentos, crear un contexto de ensamblado con las capacidades de memoria    |
+//| indicadas, invocar los pasos del ensamblador (provistos por el modulo j16asm_ensamblador) o   |
+//| el enlazador, y finalmente generar los archivos de salida solicitados.                        |
+//| Con la opcion -lote, en vez de un unico ensamblado se ejecutan todos los trabajos de un       |
+//| manifiesto (ver el modulo j16asm_lote), y con -watch el ensamblado se repite cada vez que     |
+//| cambia alguno de los archivos de entrada (ver el modulo j16asm_vigilancia).                   |
 //+-----------------------------------------------------------------------------------------------+
 #include <stdbool.h>                   //Incluye la definicion del tipo de dato bool
-#include <math.h>                      //Permite invocar la funcion pow()
 #include <stdio.h>                     //Permite manejar archivos
 #include <string.h>                    //Permite manejar cadenas
 #include <stdlib.h>                    //Permite invocar la funcion atoi()
-#include "j16asm.h"                    //Cabecera propia
-#include "j16asm_dat_struct.h"         //Importa las estructuras de datos
-#include "j16asm_output_vhdl.h"        //Permite generar la definicion de la memoria en VHDL
-#include "j16asm_output_vhdl_ramb16.h" //Permite generar la salida en VHDL con primitivas RAMB16
-#include "j16asm_output_mem_bmm.h"     //Permite generar los otros archivos de salida
+#include "j16asm.h"                    //Importa el contexto de ensamblado
+#include "j16asm_ensamblador.h"        //Permite crear contextos y ejecutar los pasos
+#include "j16asm_imagen_mem.h"         //Importa la imagen de las memorias de programa y RAM
+#include "j16asm_opciones.h"           //Permite interpretar las opciones de ensamblado
+#include "j16asm_lote.h"               //Permite ensamblar los trabajos de un manifiesto
+#include "j16asm_salida.h"             //Permite generar todos los archivos de salida en una pasada
+#include "j16asm_objeto.h"             //Permite generar y enlazar objetos reubicables
+#include "j16asm_fuentes.h"            //Permite registrar los archivos fuente y sus dependencias
+#include "j16asm_optimizador.h"        //Permite optimizar la memoria de programa
+#include "j16asm_disposicion.h"        //Permite reordenar el programa segun un perfil
+#include "j16asm_recolector.h"         //Permite eliminar el codigo y los datos inalcanzables
+#include "j16asm_estadisticas.h"       //Permite medir el tiempo y la memoria de cada etapa
+#include "j16asm_vigilancia.h"         //Permite reensamblar cada vez que cambia la entrada
+#include "j16asm_mapa.h"               //Permite elegir las capacidades y generar el mapa
+#include "j16asm_delta.h"              //Permite generar el MEM con los bloques que cambiaron
 #include "j16asm_messages.h"           //Permite enviar mensajes al usuario
 
-//Dependencias externas
-extern int yyparse ();          //Funcion que implementa el analizador sintactico
-extern FILE *yyin;              //Puntero al handle del archivo procesado
-
-//Variables compartidas con otros modulos
-char nombre_archivo_ent[256];    //Nombre del archivo de entrada
-char nombre_archivo_vhd[256];    //Nombre del archivo que se genera en formato vhdl
-char nombre_archivo_vhd_r[256];  //Nombre del archivo que se genera en formato vhdl (RAMB16)
-char nombre_archivo_mem[256];    //Nombre del archivo que se genera en formato mem
-char nombre_archivo_bmm[256];    //Nombre del archivo que se genera en formato bmm
-int tam_prg = 512;               //Cantidad maxima de instrucciones para la memoria de programa
-int tam_ram = 1024;              //Cantidad maxima de palabras para la memoria RAM
-int datos_prg[65536];            //Arreglo con el espacio de datos de la memoria de programa
-int datos_ram[65536];            //Arreglo con el espacio de datos de la memoria RAM
-int pos_prg = 0;                 //Posicion actual en la memoria de programa
-int pos_ram = 0;                 //Posicion actual en la memoria RAM
-
-//Declaracion previa de las funciones compartidas con otros modulos
-bool agregar_dato_ram(int dato, int num_lin);
-bool agregar_dato_prg(int dato, int num_lin);
-
-//Variables locales al modulo
-static bool arglc_v = false;     //Indica la presencia del argumento -v en la linea de comando
-static bool arglc_vr = false;    //Indica la presencia del argumento -vr
-static bool arglc_m = false;     //Indica la presencia del argumento -m
-static bool arglc_b = false;     //Indica la presencia del argumento -b
-
 //Declaracion previa de las funciones locales al modulo
-static bool proceso_paso_2();
-static void marcar_memoria_libre_completa();
-static void contar_memoria_usada();
+static void contar_memoria_usada(CONTEXTO_ASM *ctx);
+static int ejecutar(CONTEXTO_ASM *ctx, OPCIONES_ENSAMBLADO *opciones);
+static int ejecutar_y_reportar(CONTEXTO_ASM *ctx, OPCIONES_ENSAMBLADO *opciones);
+static int ejecutar_lote(int argc, char *argv[]);
 
 //+------------------------------+
 //| Inicio del codigo del modulo |
 //+------------------------------+-----------------------------------------------------------------
 //Funcion principal del programa
 int main (int argc, char *argv[]) {
-  int i;
   int valor_retorno;
-  FILE *fp_archivo = NULL;
+  CONTEXTO_ASM *ctx;                  //Contexto donde se lleva a cabo el ensamblado
+  OPCIONES_ENSAMBLADO opciones;       //Opciones indicadas en la linea de comandos
+  ESTADISTICAS_ENSAMBLADO estadisticas = { 0 };  //Mediciones del ensamblado (-stats)
 
   //Verifica si se invoco el programa sin argumentos
   if (argc < 2) {
@@ -92,78 +53,54 @@ int main (int argc, char *argv[]) {
     return 0;
   }
 
-  //Verifica si se invoco el programa con al menos 1 argumento
-  if (argc >= 2)
-    //De ser asi toma el segundo argumento como nombre de archivo de entrada
-    strcpy(nombre_archivo_ent, argv[1]);
+  //En el modo de lotes los ensamblados se toman de un manifiesto
+  if (strcmp(argv[1], "-lote") == 0) return ejecutar_lote(argc, argv);
 
-  //Recorre la linea de comandos tomando cada par de argumentos (las opciones van en pares)
-  for (i=2; i<argc; i+=2) {
-    //Verifica si el argumento actual es -v
-    if (strcmp(argv[i], "-v") == 0) {
-      //De ser asi, verifica que exista otro argumento mas adelante
-      if (i+1 >= argc) {
-        msg_lc_error_argumentos_faltantes();    //Si este es el ultimo argumento, emite un mensaje de error
-        return 1;
-      }
-      arglc_v = true;                           //Marca el argumento como presente
-      strcpy(nombre_archivo_vhd, argv[i+1]);    //Toma el siguiente argumento (nombre de archivo)
-    }
-
-    //Verifica si el argumento actual es -vr
-    else if (strcmp(argv[i], "-vr") == 0) {
-      if (i+1 >= argc) {
-        msg_lc_error_argumentos_faltantes();
-        return 1;
-      }
-      arglc_vr = true;
-      strcpy(nombre_archivo_vhd_r, argv[i+1]);
-    }
+  //Interpreta el archivo de entrada y las opciones que le siguen
+  if (!interpretar_opciones(&opciones, argc - 1, argv + 1)) {
+    liberar_opciones(&opciones);
+    return 1;
+  }
 
-    //Verifica si el argumento es -m
-    else if (strcmp(argv[i], "-m") == 0) {
-      if (i+1 >= argc) {
-        msg_lc_error_argumentos_faltantes();
-        return 1;
-      }
-      arglc_m = true;
-      strcpy(nombre_archivo_mem, argv[i+1]);
-    }
+  //Una vez validados los argumentos se crea el contexto de ensamblado con el nombre del archivo
+  //de entrada (usado en los mensajes). Las capacidades automaticas se fijan en cada ensamblado
+  ctx = crear_contexto(opciones.tam_prg, opciones.tam_ram);
+  ctx->modo_objeto = opciones.nombre_archivo_obj != NULL;
+  snprintf(ctx->nombre_archivo_ent, sizeof(ctx->nombre_archivo_ent), "%s", argv[1]);
+
+  //Las mediciones solo se toman si se solicitaron
+  if (opciones.estadisticas || opciones.nombre_archivo_json) ctx->estadisticas = &estadisticas;
+
+  //Se lleva a cabo todo el proceso (una vez, o cada vez que cambie la entrada con -watch) y al
+  //terminar se libera el contexto
+  if (opciones.vigilar) valor_retorno = vigilar_ensamblado(ctx, &opciones, ejecutar_y_reportar);
+  else valor_retorno = ejecutar_y_reportar(ctx, &opciones);
+  destruir_contexto(ctx);
+  liberar_opciones(&opciones);
+  return valor_retorno;
+}
 
-    //Verifica si el argumento es -b
-    else if (strcmp(argv[i], "-b") == 0) {
-      if (i+1 >= argc) {
-        msg_lc_error_argumentos_faltantes();
-        return 1;
-      }
-      arglc_b = true;
-      strcpy(nombre_archivo_bmm, argv[i+1]);
-    }
+//Funcion que interpreta los argumentos del modo de lotes (-lote manifiesto [-j hilos]) y ensambla
+//todos los trabajos del manifiesto
+static int ejecutar_lote(int argc, char *argv[]) {
+  int num_hilos = 0;                  //Cero indica un hilo por cada procesador disponible
+  int i;
 
-    //Verifica si el argumento es -p
-    else if (strcmp(argv[i], "-p") == 0) {
-      if (i+1 >= argc) {
-        msg_lc_error_argumentos_faltantes();
-        return 1;
-      }
-      tam_prg = atoi(argv[i+1]);
-      if (tam_prg != 512 && tam_prg != 1024 && tam_prg != 2048 && tam_prg != 4096 &&
-          tam_prg != 8192 && tam_prg != 16384) {
-        msg_lc_error_capacidad_prg(tam_prg);
-        return 1;
-      }
-    }
+  if (argc < 3) {
+    msg_lc_error_argumentos_faltantes();
+    return 1;
+  }
 
-    //Verifica si el argumento es -r
-    else if (strcmp(argv[i], "-r") == 0) {
+  for (i=3; i<argc; i+=2) {
+    //Verifica si el argumento es -j
+    if (strcmp(argv[i], "-j") == 0) {
       if (i+1 >= argc) {
         msg_lc_error_argumentos_faltantes();
         return 1;
       }
-      tam_ram = atoi(argv[i+1]);
-      if (tam_ram != 1024 && tam_ram != 2048 && tam_ram != 4096 && tam_ram != 8192 &&
-          tam_ram != 16384 && tam_ram != 32768) {
-        msg_lc_error_capacidad_ram(tam_ram);
+      num_hilos = atoi(argv[i+1]);
+      if (num_hilos < 1) {
+        msg_lc_error_cantidad_hilos(argv[i+1]);
         return 1;
       }
     }
@@ -175,226 +112,235 @@ int main (int argc, char *argv[]) {
     }
   }
 
-  //A continuacion se intenta abrir el archivo
-  fp_archivo = fopen(nombre_archivo_ent, "r");
-  if (!fp_archivo) {
-    //Si no se puede abrir, se reporta el mensaje de error
-    msg_error_abrir_archivo_entrada();
-    return 1;
-  }
-  //Luego redirije la entrada del analizador sintactico para que tome datos de el
-  yyin = fp_archivo;
-
-  //Antes de comenzar el proceso, se marca toda la memoria (programa y datos) como libre
-  marcar_memoria_libre_completa();
-
-  //En la primera etapa, se invoca la funcion del analizador sintactico
-  valor_retorno = yyparse();
-  if (valor_retorno) return valor_retorno;
+  return ensamblar_lote(argv[2], num_hilos);
+}
 
-  //Muestra el mensaje de exito para la primera etapa
-  msg_exito_etapa(1);
+//Funcion que ensambla (o enlaza) el archivo de entrada y, si el proceso tuvo exito, reporta las
+//mediciones que se hayan solicitado (cada ensamblado se mide desde cero)
+static int ejecutar_y_reportar(CONTEXTO_ASM *ctx, OPCIONES_ENSAMBLADO *opciones) {
+  int valor_retorno;
 
-  //En la segunda etapa se aplica la cola de acciones
-  if (!proceso_paso_2()) return 1;
+  if (ctx->estadisticas) memset(ctx->estadisticas, 0, sizeof(ESTADISTICAS_ENSAMBLADO));
+  valor_retorno = ejecutar(ctx, opciones);
+  if (!valor_retorno && opciones->estadisticas) msg_estadisticas(ctx->estadisticas);
+  if (!valor_retorno && opciones->nombre_archivo_json &&
+      !escribir_estadisticas_json(ctx, opciones->nombre_archivo_json))
+    valor_retorno = 1;
+  return valor_retorno;
+}
 
-  //Muestra el mensaje de exito para la segunda etapa
-  msg_exito_etapa(2);
+//Funcion que ensambla (o enlaza) el archivo de entrada y genera las salidas solicitadas
+static int ejecutar(CONTEXTO_ASM *ctx, OPCIONES_ENSAMBLADO *opciones) {
+  FILE *fp_archivo = NULL;
+  bool exito;
+  const FORMATO_SALIDA *formatos[MAX_SALIDAS];  //Formatos de las salidas solicitadas
+  const char *nombres[MAX_SALIDAS];             //Nombres de los archivos de salida
+  int num_salidas;                    //Cantidad de archivos de salida solicitados
+  const char **requisitos;            //Archivos de los que dependen las salidas (para -MD)
+  int num_requisitos;                 //Cantidad de archivos de los que dependen las salidas
+  ESTADISTICAS_OPTIMIZACION estadisticas;  //Resultado de la optimizacion (-O)
+  ESTADISTICAS_RECOLECCION recoleccion;    //Resultado de la recoleccion (-gc)
+  ESTADISTICAS_DISPOSICION disposicion;    //Resultado de la disposicion (-prof)
+  MARCA_MEDICION marca;                    //Inicio de la etapa que se mide (-stats)
+  bool prg_automatica = opciones->tam_prg == CAPACIDAD_AUTOMATICA;  //Se pidio -p auto
+  bool ram_automatica = opciones->tam_ram == CAPACIDAD_AUTOMATICA;  //Se pidio -r auto
+
+  //La optimizacion requiere conocer todo el programa, lo cual no ocurre con los objetos
+  if (opciones->nivel_optimizacion &&
+      (ctx->modo_objeto || es_archivo_objeto(opciones->nombre_archivo_ent))) {
+    msg_lc_error_optimizacion_objeto();
+    return 1;
+  }
+  if (opciones->recolectar &&
+      (ctx->modo_objeto || es_archivo_objeto(opciones->nombre_archivo_ent))) {
+    msg_lc_error_recoleccion_objeto();
+    return 1;
+  }
+  if (opciones->nombre_archivo_lst &&
+      (ctx->modo_objeto || es_archivo_objeto(opciones->nombre_archivo_ent))) {
+    msg_lc_error_listado_objeto();
+    return 1;
+  }
+  if (opciones->nombre_archivo_map &&
+      (ctx->modo_objeto || es_archivo_objeto(opciones->nombre_archivo_ent))) {
+    msg_lc_error_mapa_objeto();
+    return 1;
+  }
+  if (opciones->nombre_archivo_perfil &&
+      (ctx->modo_objeto || es_archivo_objeto(opciones->nombre_archivo_ent))) {
+    msg_lc_error_perfil_objeto();
+    return 1;
+  }
+  if (opciones->nombre_archivo_mdelta && ctx->modo_objeto) {
+    msg_lc_error_delta_objeto();
+    return 1;
+  }
 
-  //Cuenta la cantidad de memoria usada y la reporta
-  contar_memoria_usada();
+  //Las capacidades automaticas inician con el maximo y se reducen una vez ubicado el programa
+  //(tambien en cada ensamblado de -watch, ya que el contexto conserva la capacidad anterior)
+  if (prg_automatica) ctx->tam_prg = TAM_PRG_MAXIMO;
+  if (ram_automatica) ctx->tam_ram = TAM_RAM_MAXIMO;
 
-  //Procede a generar los archivos de salida segun las banderas
-  if (arglc_v)
-    if (!generar_salida_vhdl())
+  //Si el archivo de entrada es un objeto, en vez de ensamblar se enlaza junto con los objetos
+  //indicados mediante -l (el paso 2 de cada objeto se realiza durante el enlace)
+  if (es_archivo_objeto(opciones->nombre_archivo_ent)) {
+    if (ctx->modo_objeto) {
+      msg_lc_error_objeto_enlazado();
       return 1;
-
-  if (arglc_vr)
-    if (!generar_salida_vhdl_ramb16())
+    }
+    tomar_marca(ctx, &marca);
+    if (!enlazar_objetos(ctx, opciones->objetos, opciones->num_objetos + 1)) return 1;
+    medir_etapa(ctx, EM_ENLACE, &marca);
+    msg_exito_enlace(opciones->num_objetos + 1);
+    ajustar_capacidades(ctx, prg_automatica, ram_automatica);
+
+    //Las salidas del enlace dependen de los objetos enlazados
+    requisitos = opciones->objetos;
+    num_requisitos = opciones->num_objetos + 1;
+  }
+  else {
+    //Los objetos adicionales solo tienen sentido si se esta enlazando
+    if (opciones->num_objetos) {
+      msg_lc_error_objeto_requerido();
       return 1;
+    }
 
-  if (arglc_m)
-    if (!generar_salida_mem())
+    //A continuacion se intenta abrir el archivo
+    fp_archivo = fopen(opciones->nombre_archivo_ent, "r");
+    if (!fp_archivo) {
+      //Si no se puede abrir, se reporta el mensaje de error
+      msg_error_abrir_archivo_entrada(ctx);
       return 1;
+    }
 
-  if (arglc_b)
-    if (!generar_salida_bmm())
-      return 1;
+    //Nota: No es necesario preparar la memoria antes de comenzar, la imagen de memoria inicia
+    //con todas sus localidades libres
+
+    //En la primera etapa, se invoca el analizador sintactico sobre el archivo (con -gc se
+    //registran ademas los bloques y los usos de direcciones, y con -lst la linea de cada
+    //instruccion)
+    ctx->info_recoleccion.registrar = opciones->recolectar;
+    ctx->info_listado.registrar = opciones->nombre_archivo_lst != NULL;
+    tomar_marca(ctx, &marca);
+    exito = proceso_paso_1(ctx, fp_archivo);
+    medir_etapa(ctx, EM_PASO_1, &marca);
+    fclose(fp_archivo);
+    if (!exito) return 1;
+    medir_estructuras(ctx);
+
+    //Muestra el mensaje de exito para la primera etapa
+    msg_exito_etapa(1);
+
+    //Las salidas dependen del archivo de entrada y de todos los que se incluyeron
+    requisitos = obtener_fuentes(&ctx->registro_fuentes, &num_requisitos);
+
+    //En modo objeto, el paso 2 se posterga hasta el enlace y solo se genera el objeto
+    if (ctx->modo_objeto) {
+      if (!escribir_objeto(ctx, opciones->nombre_archivo_obj)) return 1;
+      nombres[0] = opciones->nombre_archivo_obj;  //El objeto es la unica salida
+      if (opciones->nombre_archivo_dep &&
+          !escribir_dependencias(ctx, opciones->nombre_archivo_dep, nombres, 1,
+                                 requisitos, num_requisitos))
+        return 1;
+      contar_memoria_usada(ctx);
+      msg_exito_etapa(3);
+      return 0;
+    }
 
-  //Finalmente muestra el ultimo mensaje de exito
-  msg_exito_etapa(3);
-  return 0;
-}
+    //En la segunda etapa se aplica la cola de acciones
+    tomar_marca(ctx, &marca);
+    if (!proceso_paso_2(ctx)) return 1;
+    medir_etapa(ctx, EM_PASO_2, &marca);
+
+    //Muestra el mensaje de exito para la segunda etapa
+    msg_exito_etapa(2);
+
+    //Las capacidades automaticas se reducen antes de -gc y -O, los cuales usan la ultima
+    //direccion de programa como vector de interrupcion
+    ajustar_capacidades(ctx, prg_automatica, ram_automatica);
+
+    //Si se solicito, elimina lo inalcanzable volviendo a ensamblar el archivo (el registro de
+    //fuentes se vuelve a armar, asi que tambien se vuelven a obtener los requisitos)
+    if (opciones->recolectar) {
+      tomar_marca(ctx, &marca);
+      if (!recolectar_basura(ctx, opciones->nombre_archivo_ent, &recoleccion)) return 1;
+      medir_etapa(ctx, EM_RECOLECCION, &marca);
+      medir_estructuras(ctx);
+      msg_recoleccion(&recoleccion);
+      requisitos = obtener_fuentes(&ctx->registro_fuentes, &num_requisitos);
+    }
 
-//Funcion que implementa el paso 2 de compilacion
-bool proceso_paso_2() {
-  int valor;                    //Valor a operar en caso de operaciones unarias
-  int valor_izquierda;          //Valor o argumento de mano izquierda
-  int valor_derecha;            //Valor o argumento de mano derecha
-  int valor_previo;             //Valor literal contenido previamente en la memoria de programa
-  ACCION_PASO_2 *accion;        //Puntero a la accion de la cola
-  SIMBOLO *p_simbolo;
-
-  //El proceso del paso 2 se realiza una cantidad indeterminada de veces
-  while (1) {
-    accion = desencolar_accion();       //Toma la siguiente accion de la cola
-    if (!accion) break;                 //Si ya no quedan acciones pendientes, termina
-
-    //Se realiza una accion diferente dependiendo del valor almacenado en la cola
-    switch (accion->tipo & MASC_OPER) {
-    case TPA_APILAR_LITERAL:
-      apilar_dato(accion->valor);       //Para esta accion solo se apila el valor numerico
-      break;
-    case TPA_APILAR_SIMBOLO:
-      //Para poder apilar un simbolo, se ubica primero en la lista de simbolos
-      p_simbolo = buscar_simbolo(accion->nombre);
-      if (!p_simbolo) {
-        //Si no se encontro el simbolo en la lista, se regresa un mensaje de error
-        msg_simbolo_no_definido(accion->num_lin, accion->nombre);
-        return false;
-      }
+    //Si se solicito, optimiza la memoria de programa (aun con la lista de simbolos, ya que las
+    //etiquetas se corrigen si se mueven instrucciones)
+    if (opciones->nivel_optimizacion) {
+      tomar_marca(ctx, &marca);
+      optimizar_programa(ctx, &estadisticas);
+      medir_etapa(ctx, EM_OPTIMIZACION, &marca);
+      msg_optimizacion(&estadisticas);
+    }
 
-      //Una vez ubicado el simbolo, se apila su valor equivalente
-      apilar_dato(p_simbolo->valor);
-      break;
-    case TPA_OPERACION_ARITMETICA:
-      //Primeramente se determina si la operacion indicada es de caracter unario o binario
-      if((accion->op & MASC_OPER) == OPER_NEG ||
-         (accion->op & MASC_OPER) == OPER_NOT) {
-        //En caso de ser unaria, solo desapila un valor
-        desapilar_dato(&valor);
-      }
-      else {
-        //En caso de ser binaria, verifica si los argumentos deben ser intercambiados
-        if (accion->op & OPER_INTERCAMBIO) {
-          //En caso de ser intercambiados, los desapila acordemente
-          desapilar_dato(&valor_izquierda);
-          desapilar_dato(&valor_derecha);
-        }
-        else {
-          //De no estar intercambiados, los desapila de forma normal
-          desapilar_dato(&valor_derecha);
-          desapilar_dato(&valor_izquierda);
-        }
-      }
+    //Si se solicito, reordena el programa segun el perfil de ejecucion (despues de -O, ya que
+    //el perfil corresponde al programa optimizado). El perfil se agrega a los requisitos
+    if (opciones->nombre_archivo_perfil) {
+      tomar_marca(ctx, &marca);
+      if (!disponer_programa(ctx, opciones->nombre_archivo_perfil, &disposicion)) return 1;
+      medir_etapa(ctx, EM_DISPOSICION, &marca);
+      msg_disposicion(&disposicion);
+      requisitos = obtener_fuentes(&ctx->registro_fuentes, &num_requisitos);
+    }
 
-      //Realiza la operacion segun lo indicado en la accion y guarda el resultado de regreso en la
-      //pila de datos
-      switch (accion->op & MASC_OPER) {
-      case OPER_OR:  apilar_dato(valor_izquierda | valor_derecha);     break;
-      case OPER_XOR: apilar_dato(valor_izquierda ^ valor_derecha);     break;
-      case OPER_AND: apilar_dato(valor_izquierda & valor_derecha);     break;
-      case OPER_SHL: apilar_dato(valor_izquierda << valor_derecha);    break;
-      case OPER_SHR: apilar_dato(valor_izquierda >> valor_derecha);    break;
-      case OPER_SUM: apilar_dato(valor_izquierda + valor_derecha);     break;
-      case OPER_RES: apilar_dato(valor_izquierda - valor_derecha);     break;
-      case OPER_MUL: apilar_dato(valor_izquierda * valor_derecha);     break;
-      case OPER_DIV: apilar_dato(valor_izquierda / valor_derecha);     break;
-      case OPER_MOD: apilar_dato(valor_izquierda % valor_derecha);     break;
-      case OPER_NEG: apilar_dato(-valor);                              break;
-      case OPER_NOT: apilar_dato(~valor);                              break;
-      case OPER_EXP: apilar_dato(pow(valor_izquierda, valor_derecha)); break;
-      }
+    //Lo que se haya eliminado u optimizado al final de las memorias puede reducirlas aun mas
+    ajustar_capacidades(ctx, prg_automatica, ram_automatica);
 
-      break;
-    case TPA_GUARDAR_RESULTADO_RAM:
-      //Para este caso se desapila el valor del tope de la pila (que deberia tener un resultado) y
-      //se guarda en el espacio de la memoria RAM
-      desapilar_dato(&valor);
-      datos_ram[accion->direccion] = valor & 0xFFFF;
-      break;
-    case TPA_GUARDAR_RESULTADO_PRG:
-      //Para este caso se desapila el valor del tope de la pila (que deberia tener un resultado) y
-      //se guarda en el espacio de la memoria de programa
-      desapilar_dato(&valor);
-      valor_previo = datos_prg[accion->direccion] & 0xFFFF;     //Se obtiene el literal del opcode
-      datos_prg[accion->direccion] &= 0xFFFF0000;               //Se suplantara el literal
-      datos_prg[accion->direccion] |= (valor + valor_previo) & 0xFFFF;
-      //Nota: Se hace la suma del resultado de la pila mas el valor que existia como literal del
-      //opcode (usualmente 0x0000) asi que el valor final es normalmente el mismo valor del
-      //resultado. Sin embargo, en saltos relativos este valor no es necesariamente cero (se trata
-      //de la misma direccion donde se encuentra el salto con signo negativo), de manera que al
-      //sumar, se obtiene automaticamente el offset del salto.
-      break;
+    //Si se solicito, genera el listado (requiere las etiquetas, asi que va antes de desalojarlas)
+    if (opciones->nombre_archivo_lst) {
+      tomar_marca(ctx, &marca);
+      if (!escribir_listado(ctx, opciones->nombre_archivo_lst)) return 1;
+      medir_etapa(ctx, EM_LISTADO, &marca);
     }
 
-    //Una vez procesada la accion, se desaloja la misma de memoria
-    desalojar_accion(accion);
+    //Si se solicito, genera el mapa de memoria (tambien requiere las etiquetas)
+    if (opciones->nombre_archivo_map &&
+        !escribir_mapa(ctx, opciones->nombre_archivo_map, prg_automatica, ram_automatica))
+      return 1;
   }
 
-  //Una vez terminado el paso 2, la lista de simbolos ya no es necesaria
-  desalojar_simbolos();
+  //Una vez terminado el paso 2, la lista de simbolos y la cola de acciones ya no son necesarias
+  desalojar_simbolos(&ctx->lista_simbolos);
+  desalojar_acciones(&ctx->cola_acciones);
 
-  return true;
-}
+  //Cuenta la cantidad de memoria usada y la reporta (junto con las capacidades elegidas)
+  contar_memoria_usada(ctx);
+  if (prg_automatica || ram_automatica)
+    msg_capacidades_automaticas(ctx->tam_prg, ctx->tam_ram, prg_automatica, ram_automatica);
 
-//Funcion para marcar toda la memoria de JPU16 como disponible
-void marcar_memoria_libre_completa() {
-  int i;
+  //Procede a generar los archivos de salida solicitados (todos se generan en una sola pasada
+  //sobre la imagen de memoria)
+  num_salidas = listar_salidas(opciones, formatos, nombres);
+  if (num_salidas && !generar_salidas(ctx, formatos, nombres, num_salidas))
+    return 1;
 
-  for (i=0; i<65536; i++) {
-    datos_prg[i] = MASC_LIBRE;
-    datos_ram[i] = MASC_LIBRE;
-  }
-}
+  //Si se solicito, genera el MEM con los bloques que cambiaron desde la generacion anterior
+  if (opciones->nombre_archivo_mdelta &&
+      !escribir_mem_delta(ctx, opciones->nombre_archivo_mdelta))
+    return 1;
 
-void contar_memoria_usada() {
-  int i;
-  int conteo_ram = 0;
-  int conteo_prg = 0;
+  //Si se solicito, genera el archivo de dependencias para make con las salidas como objetivos
+  if (opciones->nombre_archivo_dep &&
+      !escribir_dependencias(ctx, opciones->nombre_archivo_dep, nombres, num_salidas,
+                             requisitos, num_requisitos))
+    return 1;
 
-  //Realiza el proceso de conteo de acuerdo a las localidades ocupadas
-  for (i=0; i<65536; i++) {
-    if (!(datos_prg[i] & MASC_LIBRE)) conteo_ram++;
-    if (!(datos_ram[i] & MASC_LIBRE)) conteo_prg++;
-  }
+  //Finalmente muestra el ultimo mensaje de exito
+  msg_exito_etapa(3);
+  return 0;
+}
 
+//Funcion para contar la cantidad de memoria usada y reportarla
+static void contar_memoria_usada(CONTEXTO_ASM *ctx) {
+  //El conteo se obtiene directamente de los mapas de ocupacion de la imagen de memoria
   //Indica la cantidad de instrucciones generadas
-  msg_mem_prg_usada(conteo_ram);
+  msg_mem_prg_usada(contar_localidades_prg(&ctx->imagen));
   //Indica la cantidad de palabras generadas
-  msg_mem_ram_usada(conteo_prg);
-}
-
-//Funcion para agregar y reservar un dato en la memoria RAM
-bool agregar_dato_ram(int dato, int num_lin) {
-  //Primeramente determina si la direccion actual excede el limite de la memoria disponible
-  if (pos_ram >= tam_ram) {
-    //De exceder el limite, regresa con mensaje de error
-    msg_fin_ram(num_lin);
-    return false;
-  }
-
-  //Luego determina si la localidad esta libre
-  if (!(datos_ram[pos_ram] & MASC_LIBRE)) {
-    //De no estar libre, regresa con mensaje de error
-    msg_colision_ram(num_lin, pos_ram);
-    return false;
-  }
-
-  //Si todo esta bien, guarda el dato en la memoria RAM y desmarca la localidad como disponible
-  datos_ram[pos_ram] = dato & 0xFFFF;
-  pos_ram++;                    //Apunta a la siguiente posicion de la memoria
-  return true;
-}
-
-//Funcion para agregar y reservar un dato en la memoria de programa
-bool agregar_dato_prg(int dato, int num_lin) {
-  //Primeramente determina si la direccion actual excede el limite de la memoria disponible
-  if (pos_prg >= tam_prg) {
-    //De exceder el limite, regresa con mensaje de error
-    msg_fin_prg(num_lin);
-    return false;
-  }
-
-  //Luego determina si la localidad esta libre
-  if (!(datos_prg[pos_prg] & MASC_LIBRE)) {
-    //De no estar libre, regresa con mensaje de error
-    msg_colision_prg(num_lin, pos_prg);
-    return false;
-  }
-
-  //Si todo esta bien, guarda el dato en la memoria de programa y desmarca la localidad como disponible
-  datos_prg[pos_prg] = dato;
-  pos_prg++;                    //Apunta a la siguiente posicion de la memoria
-  return true;
+  msg_mem_ram_usada(contar_localidades_ram(&ctx->imagen));
 }
@@ -2,26 +2,83 @@
 #define j16asm_h_Incluida
 
 #include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdio.h>                      //Incluye la definicion del tipo de dato FILE
+#include "j16asm_dat_struct.h"          //Incluye la cola de acciones y la lista de simbolos
+#include "j16asm_imagen_mem.h"          //Incluye la imagen de las memorias de programa y RAM
+#include "j16asm_fuentes.h"             //Incluye el registro de archivos fuente
+#include "j16asm_optimizador.h"         //Incluye la informacion que recoge el optimizador
+#include "j16asm_recolector.h"          //Incluye la informacion que recoge el recolector
+#include "j16asm_listado.h"             //Incluye la informacion que recoge el listado
+#include "j16asm_macros.h"              //Incluye la tabla de macros
 
-//Variables exportadas
-//--------------------
-#define MASC_LIBRE 0x80000000       //Mascara de bits que define si una localidad de RAM o programa esta libre
-extern char nombre_archivo_ent[];   //Nombre del archivo de entrada
-extern char nombre_archivo_vhd[];   //Nombre del archivo que se genera en formato vhdl
-extern char nombre_archivo_vhd_r[]; //Nombre del archivo que se genera en formato vhdl (RAMB16)
-extern char nombre_archivo_mem[];   //Nombre del archivo que se genera en formato mem
-extern char nombre_archivo_bmm[];   //Nombre del archivo que se genera en formato bmm
-extern int tam_prg;                 //Cantidad maxima de instrucciones para la memoria de programa
-extern int tam_ram;                 //Cantidad maxima de palabras para la memoria RAM
-extern int datos_prg[];             //Arreglo con el espacio de datos de la memoria de programa
-extern int datos_ram[];             //Arreglo con el espacio de datos de la memoria RAM
-extern int pos_prg;                 //Posicion actual en la memoria de programa
-extern int pos_ram;                 //Posicion actual en la memoria RAM
-
-//Funciones exportadas
-//--------------------
-//Funciones para agregar datos a la memoria RAM y de programa
-extern bool agregar_dato_ram(int dato, int num_lin);
-extern bool agregar_dato_prg(int dato, int num_lin);
+//Constantes exportadas
+//---------------------
+#define PROFUNDIDAD_MAX_INCLUSION 16    //Cantidad maxima de inclusiones y expansiones anidadas
+
+//Tipos de datos exportados
+//-------------------------
+//Enumeracion de las posibles secciones de memoria donde se generan datos
+typedef enum _TIPO_SECCION {
+  TS_DATOS, TS_PROG,
+} TIPO_SECCION;
+
+//Estructura con la ubicacion donde aparece una directiva include, una invocacion de macro o una
+//directiva rept (las expansiones se leen igual que un archivo incluido)
+typedef struct _INCLUSION {
+  int num_lin;                          //Numero de linea de la directiva
+  int fuente;                           //Indice del archivo que contiene la directiva
+  FILE *fp;                             //Handle del archivo incluido (NULL en una expansion)
+  const char *cuerpo;                   //Cuerpo de la repeticion (NULL si no es una repeticion)
+  int lin_cuerpo;                       //Linea de la directiva rept (donde inicia cada vuelta)
+  int vueltas;                          //Vueltas de la repeticion que faltan por expandir
+} INCLUSION;
+
+//Declaracion previa de las mediciones de un ensamblado (definidas en j16asm_estadisticas.h)
+struct _ESTADISTICAS_ENSAMBLADO;
+
+//Funcion que recibe los mensajes de error del ensamblador (ya con formato y fin de linea)
+typedef void (*FUNCION_REPORTE)(void *datos, const char *mensaje);
+
+//Estructura con todo el estado de un ensamblado (contexto). Cada contexto es independiente de
+//los demas, de manera que se pueden ensamblar varios programas en el mismo proceso
+typedef struct _CONTEXTO_ASM {
+  //Configuracion
+  int tam_prg;                          //Capacidad de la memoria de programa (instrucciones)
+  int tam_ram;                          //Capacidad de la memoria RAM (palabras)
+  bool modo_objeto;                     //Indica si se genera un objeto reubicable
+  FUNCION_REPORTE reportar;             //Funcion que recibe los mensajes (NULL para usar stdout)
+  void *datos_reporte;                  //Dato que se pasa a la funcion de reporte
+  struct _ESTADISTICAS_ENSAMBLADO *estadisticas;  //Mediciones (-stats), NULL si no se piden
+  bool conservar_salidas;               //Solo reemplaza las salidas que cambian (-watch)
+  int salidas_reemplazadas;             //Salidas que cambiaron en la ultima generacion
+
+  //Estado del paso 1
+  char nombre_archivo_ent[256];         //Nombre del archivo procesado (util para los mensajes)
+  int pos_prg;                          //Posicion actual en la memoria de programa
+  int pos_ram;                          //Posicion actual en la memoria RAM
+  TIPO_SECCION seccion_actual;          //Seccion actual del codigo fuente
+  int num_lin;                          //Conteo del numero de lineas del archivo actual
+  int fuente_actual;                    //Indice del archivo fuente actual
+  INCLUSION pila_inclusion[PROFUNDIDAD_MAX_INCLUSION]; //Archivos que incluyeron al actual
+  int nivel_inclusion;                  //Cantidad de archivos incluidos abiertos
+  bool inclusion_terminada;             //Indica si termino un archivo incluido
+  int nivel_lexico;                     //Buffers apilados en el analizador lexico
+  bool cuerpo_pendiente;                //La linea actual abre una macro o una repeticion
+  int nivel_cuerpo;                     //Bloques anidados abiertos en el cuerpo que se lee
+  int tam_cuerpo;                       //Caracteres leidos del cuerpo (sin la linea actual)
+  bool inicio_sentencia;                //El siguiente token inicia una sentencia
+  bool etiqueta_posible;                //El ultimo token es un nombre al inicio de una sentencia
+  void *escaner;                        //Estado del analizador lexico (reentrante)
+
+  //Estructuras de datos
+  COLA_ACCIONES_PASO_2 cola_acciones;   //Expresiones postergadas al paso 2
+  LISTA_SIMBOLOS lista_simbolos;        //Simbolos del programa
+  IMAGEN_MEM imagen;                    //Contenido de las memorias de programa y RAM
+  REGISTRO_FUENTES registro_fuentes;    //Archivos fuente que intervienen en el ensamblado
+  INFO_OPTIMIZACION info_optimizacion;  //Usos de direcciones de programa (para el optimizador)
+  INFO_RECOLECCION info_recoleccion;    //Bloques y usos de direcciones (para la opcion -gc)
+  INFO_LISTADO info_listado;            //Linea de cada instruccion (para la opcion -lst)
+  TABLA_MACROS tabla_macros;            //Macros definidas en el codigo fuente
+} CONTEXTO_ASM;
 
 #endif //j16asm_h_Incluida
@@ -0,0 +1,100 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_arena.c                                                                                |
+//| Modulo con la implementacion de las arenas de memoria                                         |
+//|                                                                                               |
+//| Una arena es un asignador de memoria que entrega porciones consecutivas de bloques grandes    |
+//| alojados con malloc, simplemente desplazando un puntero. Las porciones entregadas no se        |
+//| desalojan de forma individual, sino que toda la arena se libera de una sola vez cuando los    |
+//| datos que contiene dejan de ser necesarios. El ensamblador genera una gran cantidad de        |
+//| elementos pequeños (acciones de la cola, datos de pila y nombres de simbolos) que comparten   |
+//| el mismo tiempo de vida, por lo que agruparlos en arenas elimina casi todas las llamadas a    |
+//| malloc y free que se harian de otra forma.                                                    |
+//| Este modulo lleva ademas la cuenta de los alojamientos de memoria que hace cada hilo, la cual |
+//| usa la opcion -stats (ver j16asm_estadisticas.c). Los modulos del ensamblador cuentan ahi sus |
+//| alojamientos.                                                                                 |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdlib.h>             //Permite invocar malloc y free
+#include <string.h>             //Permite manejar cadenas
+#include "j16asm_arena.h"       //Cabecera propia
+
+//Redondea un tamaño al siguiente multiplo de la alineacion maxima de la plataforma
+#define ALINEAR(tam) (((tam) + sizeof(max_align_t) - 1) & ~(sizeof(max_align_t) - 1))
+
+//Cuenta de los alojamientos de memoria del hilo actual
+static _Thread_local unsigned long alojamientos_hilo;
+static _Thread_local unsigned long long bytes_hilo;
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion para alojar una porcion de memoria dentro de una arena
+void *arena_alojar(ARENA *arena, size_t tam) {
+  BLOQUE_ARENA *bloque;
+  size_t capacidad;
+  void *porcion;
+
+  tam = ALINEAR(tam);
+
+  //Si el bloque actual no tiene espacio suficiente, aloja uno nuevo
+  bloque = arena->bloque;
+  if (!bloque || bloque->usado + tam > bloque->capacidad) {
+    capacidad = tam > arena->tam_bloque ? tam : arena->tam_bloque;
+    bloque = malloc(sizeof(BLOQUE_ARENA) + capacidad);
+    contar_alojamiento(sizeof(BLOQUE_ARENA) + capacidad);
+    bloque->siguiente = arena->bloque;  //El bloque anterior queda enlazado para liberarlo luego
+    bloque->usado = 0;
+    bloque->capacidad = capacidad;
+    arena->bloque = bloque;
+    arena->num_bloques++;
+  }
+
+  //Entrega la porcion a continuacion del ultimo dato ocupado y desplaza el puntero
+  porcion = (char *) bloque->datos + bloque->usado;
+  bloque->usado += tam;
+  arena->num_alojamientos++;
+
+  return porcion;
+}
+
+//Funcion para crear una copia de una cadena dentro de una arena
+char *arena_duplicar_cadena(ARENA *arena, const char *cadena) {
+  size_t longitud;
+  char *copia;
+
+  longitud = strlen(cadena) + 1;        //Se incluye el terminador nulo
+  copia = arena_alojar(arena, longitud);
+  memcpy(copia, cadena, longitud);
+
+  return copia;
+}
+
+//Funcion para liberar de una sola vez toda la memoria de una arena
+void arena_liberar(ARENA *arena) {
+  BLOQUE_ARENA *p_siguiente_bloque;
+
+  while (arena->bloque) {
+    p_siguiente_bloque = arena->bloque->siguiente;
+    free(arena->bloque);
+    arena->bloque = p_siguiente_bloque;
+  }
+
+  //Deja la arena en su estado inicial vacio (conservando el tamaño de bloque), de modo que puede
+  //volver a usarse sin arrastrar las cuentas anteriores
+  arena->num_bloques = 0;
+  arena->num_alojamientos = 0;
+}
+
+//+---------------------------------------+
+//| Cuenta de los alojamientos de memoria |
+//+---------------------------------------+--------------------------------------------------------
+//Funcion que cuenta un alojamiento de memoria del hilo actual
+void contar_alojamiento(size_t tam) {
+  alojamientos_hilo++;
+  bytes_hilo += tam;
+}
+
+//Funcion que obtiene la cantidad de alojamientos y de bytes alojados por el hilo actual
+void obtener_alojamientos(unsigned long *alojamientos, unsigned long long *bytes) {
+  *alojamientos = alojamientos_hilo;
+  *bytes = bytes_hilo;
+}
@@ -0,0 +1,37 @@
+#ifndef j16asm_arena_h_Incluida
+#define j16asm_arena_h_Incluida
+
+#include <stddef.h>                     //Incluye la definicion del tipo de dato size_t
+
+//Tipos de datos exportados
+//-------------------------
+//Estructura que describe un bloque de memoria de una arena
+typedef struct _BLOQUE_ARENA {
+  struct _BLOQUE_ARENA *siguiente;      //Bloque alojado previamente (util para liberar la arena)
+  size_t usado;                         //Cantidad de bytes ocupados del bloque
+  size_t capacidad;                     //Cantidad de bytes disponibles en el bloque
+  max_align_t datos[];                  //Contenido del bloque (alineado para cualquier tipo)
+} BLOQUE_ARENA;
+
+//Estructura que describe una arena (asignador de memoria por desplazamiento de puntero)
+typedef struct _ARENA {
+  BLOQUE_ARENA *bloque;                 //Bloque actual de la arena (NULL si la arena esta vacia)
+  size_t tam_bloque;                    //Tamaño minimo de los bloques que se alojan
+  unsigned long num_bloques;            //Cantidad de bloques alojados (llamadas a malloc)
+  unsigned long num_alojamientos;       //Cantidad de alojamientos servidos por la arena
+} ARENA;
+
+//Inicializador de arenas vacias con el tamaño de bloque indicado
+#define ARENA_VACIA(tam_bloque) { NULL, (tam_bloque), 0, 0 }
+
+//Funciones exportadas
+//--------------------
+extern void *arena_alojar(ARENA *arena, size_t tam);
+extern char *arena_duplicar_cadena(ARENA *arena, const char *cadena);
+extern void arena_liberar(ARENA *arena);
+
+//Funciones para contar los alojamientos de memoria de cada hilo (para la opcion -stats)
+extern void contar_alojamiento(size_t tam);
+extern void obtener_alojamientos(unsigned long *alojamientos, unsigned long long *bytes);
+
+#endif //j16asm_arena_h_Incluida
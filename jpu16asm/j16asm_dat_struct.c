@@ -1,274 +1,304 @@
 //+-----------------------------------------------------------------------------------------------+
 //| j16asm_dat_struct.c                                                                           |
-//| Modulo con las implementaciones de las estructuras de datos: Cola de operaciones, pila de     |
-//| datos y lista de simbolos                                                                     |
+//| Modulo con las implementaciones de las estructuras de datos: Cola de acciones y lista de      |
+//| simbolos                                                                                      |
 //|                                                                                               |
-//| Este modulo implementa las estructuras de datos que usa el ensamblador. La cola de            |
-//| operaciones guarda todas las operaciones que no pueden efectuarse en el paso 1 de compilacion |
-//| y que deben postergarse a el paso 2. La pila de datos almacena los resultados parciales de    |
-//| los calculos temporales (guardados en la cola de operaciones con notacion polaca inversa).    |
+//| Este modulo implementa las estructuras de datos que usa el ensamblador. La cola de acciones   |
+//| guarda todas las operaciones que no pueden efectuarse en el paso 1 de compilacion y que deben |
+//| postergarse a el paso 2. Cada expresion postergada se almacena como un registro de codigo     |
+//| compacto (en notacion polaca inversa) dentro de un unico arreglo contiguo, de manera que el   |
+//| paso 2 se reduce a recorrer dicho arreglo de forma lineal.                                    |
 //| La lista de simbolos guarda todos los nombres de aquellas constantes, etiquetas de datos      |
 //| (variables) y etiquetas de programa que aparecen en el codigo fuente, junto con sus valores   |
-//| equivalentes (el valor de las constantes o las direcciones de las etiquetas).                 |
+//| equivalentes (el valor de las constantes o las direcciones de las etiquetas). La misma esta   |
+//| indexada mediante una tabla hash de direccionamiento abierto (sondeo lineal), de manera que   |
+//| el costo de cada busqueda se mantiene constante sin importar la cantidad de simbolos.         |
 //| Notese que este modulo solo implementa las estructuras de datos en si y se limita a ello,     |
 //| quedando la logica general de su operacion a cargo del resto de las partes del programa.      |
 //|                                                                                               |
-//| Nota acerca del alojamiento de las cadenas                                                    |
-//| Las funciones encolar_simbolo() y agregar_simbolo() no crean copias de las cadenas que        |
-//| reciben, a pesar de que alojan memoria dinamica para los elementos que crean (solo copian los |
-//| punteros de dichas cadenas). Esto es asi por motivos de eficiencia, para evitar crear 2       |
-//| copias consecutivas de las cadenas y terminar por desalojar una de ellas al dejar de          |
-//| utilizarla. En vez, la responsabilidad de desalojar las cadenas es trasladada a la estructura |
-//| de datos asociada a cada funcion (cola de acciones o lista de simbolos).                      |
-//| Notese tambien que las cadenas que recibe cada funcion provienen de origenes distintos por    |
-//| cuanto al analizador sintactico se refiere, dado que las que van a parar a la cola de         |
-//| acciones son referencias a simbolos que aun no han sido declarados en el codigo fuente,       |
-//| mientras que las que van a parar a la lista de simbolos provienen de sus mismas               |
-//| declaraciones.                                                                                |
+//| Nota acerca de los simbolos no definidos                                                      |
+//| Cada nombre que encuentra el analizador lexico se reserva en la lista de simbolos mediante la |
+//| funcion reservar_simbolo(), aun cuando el simbolo no haya sido declarado todavia. Este queda  |
+//| marcado como no definido hasta que aparece su declaracion. De esta forma las acciones de la   |
+//| cola que hacen referencia a simbolos guardan directamente el puntero a su entrada en la       |
+//| lista, y el paso 2 obtiene su valor sin necesidad de buscarlo nuevamente.                     |
+//|                                                                                               |
+//| Nota acerca de la reentrancia                                                                  |
+//| El modulo no guarda estado propio: cada contexto de ensamblado posee su cola de acciones y su |
+//| lista de simbolos, y todas las funciones reciben la estructura sobre la cual operan.          |
+//|                                                                                               |
+//| Nota acerca del alojamiento de memoria                                                        |
+//| Los simbolos y sus nombres se alojan en una arena propia de la lista (ver j16asm_arena.c), la |
+//| cual se libera de una sola vez mediante desalojar_simbolos(). La cola de acciones es un unico |
+//| arreglo que crece segun se necesita y se libera mediante desalojar_acciones().                |
 //+-----------------------------------------------------------------------------------------------+
 #include <stdlib.h>             //Permite invocar malloc y free
 #include <string.h>             //Permite manejar cadenas
 #include <stdbool.h>            //Incluye la definicion del tipo de dato bool
 #include "j16asm_dat_struct.h"  //Cabecera propia
+#include "j16asm_arena.h"       //Permite alojar memoria en arenas
 
-//Tipos y variables usados para la cola de acciones (cola fifo)
-typedef struct _COLA_ACCIONES_PASO_2 {
-  ACCION_PASO_2 *inicio;        //Puntero al inicio de la lista (util para retirar elementos)
-  ACCION_PASO_2 *final;         //Puntero al final de la lista (util para agregar elementos)
-} COLA_ACCIONES_PASO_2;
-
-static COLA_ACCIONES_PASO_2 cola_acciones = { NULL, NULL };    //La cola se inicializa vacia
-
-//Tipos y variables usados para la pila de datos
-typedef struct _DATO_PILA {
-  int valor;                    //Valor almacenado
-  struct _DATO_PILA *siguiente; //Puntero al elemento siguiente (util para desapilar datos)
-} DATO_PILA;
-
-static DATO_PILA *cima_pila = NULL;    //La pila se inicializa vacia
-
-//Tipos y variables usados para la lista de simbolos
-typedef struct _LISTA_SIMBOLOS {
-  SIMBOLO *inicio;              //Puntero al inicio de la lista (util para comenzar a recorrerla)
-  SIMBOLO *final;               //Puntero al final de la lista (util para agregar elementos)
-} LISTA_SIMBOLOS;
-
-static LISTA_SIMBOLOS lista_simbolos = { NULL, NULL }; //La lista se inicializa vacia
+//Dimensiones iniciales de las estructuras de datos
+#define CAPACIDAD_INICIAL_COLA 1024     //Cantidad inicial de acciones que puede contener la cola
+#define CAPACIDAD_INICIAL_TABLA 256     //Cantidad inicial de ranuras de la tabla hash (potencia de 2)
 
 //Declaracion previa de las funciones locales al modulo
-static void encolar(ACCION_PASO_2 *nueva_accion);
+static ACCION_PASO_2 *encolar(COLA_ACCIONES_PASO_2 *cola, TIPO_ACCION tipo, int num_lin);
+static unsigned int calcular_hash(const char *nombre);
+static void insertar_en_tabla(LISTA_SIMBOLOS *lista, SIMBOLO *simbolo);
+static void ampliar_tabla(LISTA_SIMBOLOS *lista);
 
 //+---------------------------------------------+
 //| Operaciones asociadas a la cola de acciones |
 //+---------------------------------------------+--------------------------------------------------
-//Funcion general para encolar acciones (solo gestiona memoria)
-static void encolar(ACCION_PASO_2 *nueva_accion) {
-  //Como se agregara un elemento a la cola, se asegura que el siguiente sea nulo
-  nueva_accion->siguiente = NULL;
-
-  //Si la cola esta vacia, hace que el inicio apunte al nuevo elemento
-  if (!cola_acciones.inicio)
-    cola_acciones.inicio = nueva_accion;
-  //Si la cola no esta vacia, agrega el nuevo elemento al final de la misma
-  else
-    cola_acciones.final->siguiente = nueva_accion;
+//Funcion general para encolar acciones (solo gestiona memoria y delimita las expresiones)
+static ACCION_PASO_2 *encolar(COLA_ACCIONES_PASO_2 *cola, TIPO_ACCION tipo, int num_lin) {
+  ACCION_PASO_2 *nueva_accion;
+
+  //Se asegura que haya espacio para la accion y una posible cabecera de expresion
+  if (cola->cantidad + 2 > cola->capacidad) {
+    cola->capacidad = cola->capacidad ?
+                              cola->capacidad * 2 : CAPACIDAD_INICIAL_COLA;
+    cola->acciones = realloc(cola->acciones,
+                                     cola->capacidad * sizeof(ACCION_PASO_2));
+    contar_alojamiento(cola->capacidad * sizeof(ACCION_PASO_2));
+  }
 
-  //El final de la cola siempre apuntara al nuevo elemento agregado
-  cola_acciones.final = nueva_accion;
+  //La primera accion de una expresion va precedida de una cabecera con el numero de linea y el
+  //archivo fuente, de manera que las acciones individuales no necesitan guardarlos
+  if (!cola->expresion_abierta) {
+    nueva_accion = &cola->acciones[cola->cantidad++];
+    nueva_accion->tipo = TPA_INICIO_EXPRESION;
+    nueva_accion->num_lin = num_lin;
+    nueva_accion->fuente = cola->fuente;
+    cola->expresion_abierta = true;
+    cola->profundidad = 0;
+  }
+
+  //Ocupa la siguiente posicion del arreglo con la nueva accion
+  nueva_accion = &cola->acciones[cola->cantidad++];
+  nueva_accion->tipo = tipo;
+  return nueva_accion;
 }
 
 //Funcion especifica para encolar literales (cuando se retiran, su valor es apilado)
-void encolar_literal(int valor, int num_lin) {
-  ACCION_PASO_2 *nueva_accion;
+void encolar_literal(COLA_ACCIONES_PASO_2 *cola, int valor, int num_lin) {
+  //Encola la accion y copia el valor pasado
+  encolar(cola, TPA_APILAR_LITERAL, num_lin)->valor = valor;
 
-  //Aloja memoria para el nuevo elemento de la cola
-  nueva_accion = malloc(sizeof(ACCION_PASO_2));
-  //Establece el tipo de accion para el nuevo elemento
-  nueva_accion->tipo = TPA_APILAR_LITERAL;
-  //Hace una copia del valor pasado
-  nueva_accion->valor = valor;
-  //Tambien copia el numero de linea
-  nueva_accion->num_lin = num_lin;
-
-  //Finalmente encola el elemento
-  encolar(nueva_accion);
+  //Lleva la cuenta de la profundidad que alcanzara la pila al evaluar la expresion
+  if (++cola->profundidad > cola->profundidad_maxima)
+    cola->profundidad_maxima = cola->profundidad;
 }
 
 //Funcion especifica para encolar simbolos (cuando se retiran, su valor equivalente es apilado)
-void encolar_simbolo(char *nombre, int num_lin) {
-  ACCION_PASO_2 *nueva_accion;
-
-  nueva_accion = malloc(sizeof(ACCION_PASO_2));
-  nueva_accion->tipo = TPA_APILAR_SIMBOLO;
-  nueva_accion->nombre = nombre;
-  //NOTA: El puntero de la cadena solo se traslada. No se hace una copia a una nueva locacion de
-  //memoria por motivos de eficiencia y por el hecho que la cadena sera desalojada automaticamente
-  //cuando se desaloje la accion de la cola
-  nueva_accion->num_lin = num_lin;
+void encolar_simbolo(COLA_ACCIONES_PASO_2 *cola, SIMBOLO *simbolo, int num_lin) {
+  encolar(cola, TPA_APILAR_SIMBOLO, num_lin)->simbolo = simbolo;
+  //NOTA: Se guarda el puntero a la entrada de la lista de simbolos (aun no definida), de manera
+  //que en el paso 2 su valor se obtiene directamente sin necesidad de buscarlo por su nombre
 
-  encolar(nueva_accion);
+  if (++cola->profundidad > cola->profundidad_maxima)
+    cola->profundidad_maxima = cola->profundidad;
 }
 
 //Funcion especifica para encolar operaciones (cuando se retiran, trabajan sobre datos de pila)
-void encolar_operacion(OPERACION op, int num_lin) {
-  ACCION_PASO_2 *nueva_accion;
-
-  nueva_accion = malloc(sizeof(ACCION_PASO_2));
-  nueva_accion->tipo = TPA_OPERACION_ARITMETICA;
-  nueva_accion->op = op;
-  nueva_accion->num_lin = num_lin;
+void encolar_operacion(COLA_ACCIONES_PASO_2 *cola, OPERACION op, int num_lin) {
+  encolar(cola, TPA_OPERACION_ARITMETICA, num_lin)->op = op;
 
-  encolar(nueva_accion);
+  //Las operaciones binarias retiran 2 datos y apilan 1, las unarias no alteran la profundidad
+  if ((op & MASC_OPER) != OPER_NEG && (op & MASC_OPER) != OPER_NOT)
+    cola->profundidad--;
 }
 
 //Funcion especifica para encolar almacenamientos a RAM (cuando se retiran, se guarda el dato de
 //arriba de la pila en el espacio de RAM de JPU16)
-void encolar_resultado_ram(int direccion, int num_lin) {
-  ACCION_PASO_2 *nueva_accion;
-
-  nueva_accion = malloc(sizeof(ACCION_PASO_2));
-  nueva_accion->tipo = TPA_GUARDAR_RESULTADO_RAM;
-  nueva_accion->direccion = direccion;
-  nueva_accion->num_lin = num_lin;
-
-  encolar(nueva_accion);
+void encolar_resultado_ram(COLA_ACCIONES_PASO_2 *cola, int direccion, int num_lin) {
+  encolar(cola, TPA_GUARDAR_RESULTADO_RAM, num_lin)->direccion = direccion;
+  cola->expresion_abierta = false;      //El resultado cierra la expresion
 }
 
 //Funcion especifica para encolar almacenamientos a memoria de programa (cuando se retiran, se
 //guarda el dato de arriba de la pila en el espacio de programa de JPU16)
-void encolar_resultado_prg(int direccion, int num_lin) {
-  ACCION_PASO_2 *nueva_accion;
-
-  nueva_accion = malloc(sizeof(ACCION_PASO_2));
-  nueva_accion->tipo = TPA_GUARDAR_RESULTADO_PRG;
-  nueva_accion->direccion = direccion;
-  nueva_accion->num_lin = num_lin;
+void encolar_resultado_prg(COLA_ACCIONES_PASO_2 *cola, int direccion, int num_lin) {
+  encolar(cola, TPA_GUARDAR_RESULTADO_PRG, num_lin)->direccion = direccion;
+  cola->expresion_abierta = false;
+}
 
-  encolar(nueva_accion);
+//Funcion para indicar el archivo fuente al que pertenecen las expresiones que se encolen a partir
+//de este momento (el analizador sintactico la invoca al entrar y salir de un archivo incluido)
+void fijar_fuente_acciones(COLA_ACCIONES_PASO_2 *cola, int fuente) {
+  cola->fuente = fuente;
 }
 
-//Funcion para desencolar acciones (retira el elemento de la cola y lo retorna)
-ACCION_PASO_2 *desencolar_accion() {
-  ACCION_PASO_2 *elemento;
+//Funcion para obtener el arreglo con todas las acciones encoladas (para recorrerlo en orden)
+ACCION_PASO_2 *obtener_acciones(COLA_ACCIONES_PASO_2 *cola, int *cantidad,
+                                int *profundidad_maxima) {
+  *cantidad = cola->cantidad;
+  *profundidad_maxima = cola->profundidad_maxima;
+  return cola->acciones;
+}
 
-  //Verifica que la cola tenga elementos antes de intentar removerlos
-  if (!cola_acciones.inicio) return NULL;
-  //Toma el primer elemento disponible de la cola
-  elemento = cola_acciones.inicio;
-  //Hace que el nuevo inicio de la cola sea el siguiente elemento
-  cola_acciones.inicio = elemento->siguiente;
+//Funcion para descartar las acciones encoladas a partir de una cantidad dada (deshace las
+//expresiones de un dato que finalmente no se agrega)
+void descartar_acciones(COLA_ACCIONES_PASO_2 *cola, int cantidad) {
+  cola->cantidad = cantidad;
+  cola->expresion_abierta = false;
+}
 
-  //Retorna el elemento obtenido
-  return elemento;
+//Funcion para desalojar de una sola vez la cola de acciones
+void desalojar_acciones(COLA_ACCIONES_PASO_2 *cola) {
+  free(cola->acciones);
+  cola->acciones = NULL;
+  cola->cantidad = 0;
+  cola->capacidad = 0;
+  cola->expresion_abierta = false;
+  cola->profundidad_maxima = 0;
+  cola->fuente = 0;
 }
 
-//Funcion para desalojar elementos retirados de la cola
-void desalojar_accion(ACCION_PASO_2 *accion) {
-  //Si la accion era de apilar el nombre de un simbolo, desaloja la cadena asociada
-  if (accion->tipo == TPA_APILAR_SIMBOLO)
-    free(accion->nombre);
-  //NOTA: AQUI SE DESALOJAN LAS CADENAS CREADAS CON strdup() DURANTE LA ETAPA DE ANALISIS LEXICO
+//+----------------------------------------------+
+//| Operaciones asociadas a la lista de simbolos |
+//+----------------------------------------------+-------------------------------------------------
+//Funcion para calcular el valor hash de un nombre (FNV-1a de 32 bits)
+static unsigned int calcular_hash(const char *nombre) {
+  unsigned int hash = 2166136261u;
+
+  while (*nombre) {
+    hash ^= (unsigned char) *nombre++;
+    hash *= 16777619u;
+  }
 
-  //Luego desaloja la accion en si
-  free(accion);
+  return hash;
 }
 
-//+------------------------------------------+
-//| Operaciones asociadas a la pila de datos |
-//+------------------------------------------+-----------------------------------------------------
-//Funcion para agregar datos a la pila
-void apilar_dato(int valor) {
-  DATO_PILA *nuevo_dato;
-
-  //Aloja memoria para el nuevo elemento de la pila
-  nuevo_dato = malloc(sizeof(DATO_PILA));
-  //Asigna el valor que contendra el nuevo dato
-  nuevo_dato->valor = valor;
-  //Hace que el nuevo dato apunte a la vieja cima de la pila
-  nuevo_dato->siguiente = cima_pila;
-  //La nueva cima de la pila es el dato recien agregado
-  cima_pila = nuevo_dato;
+//Funcion para ubicar un simbolo en la primera ranura libre de su secuencia de sondeo
+static void insertar_en_tabla(LISTA_SIMBOLOS *lista, SIMBOLO *simbolo) {
+  unsigned int mascara = lista->capacidad - 1;
+  unsigned int i;
+
+  //Sondeo lineal a partir de la ranura indicada por el hash
+  for (i = simbolo->hash & mascara; lista->ranuras[i]; i = (i + 1) & mascara);
+  lista->ranuras[i] = simbolo;
 }
 
-//Funcion para retirar datos de la pila
-bool desapilar_dato(int *valor) {
-  DATO_PILA *dato_retirado;
-
-  //Si la pila esta vacia, no retorna nada
-  if (!cima_pila) return false;
-  //Obtiene el elemento en la cima de la pila
-  dato_retirado = cima_pila;
-  //La nueva cima de la pila es el siguiente elemento apuntado por el elemento retirado
-  cima_pila = dato_retirado->siguiente;
-  //Obtiene el valor almacenado en el elemento
-  *valor = dato_retirado->valor;
-  //Libera la memoria usada por el elemento
-  free(dato_retirado);
-
-  //Como todo salio bien, retorna con exito
-  return true;
+//Funcion para duplicar la capacidad de la tabla hash (redistribuye todos los simbolos)
+static void ampliar_tabla(LISTA_SIMBOLOS *lista) {
+  SIMBOLO *p_simbolo;
+
+  //Aloja el nuevo arreglo de ranuras (todas libres) con el doble de capacidad
+  free(lista->ranuras);
+  lista->capacidad = lista->capacidad ?
+                             lista->capacidad * 2 : CAPACIDAD_INICIAL_TABLA;
+  lista->ranuras = calloc(lista->capacidad, sizeof(SIMBOLO *));
+  contar_alojamiento(lista->capacidad * sizeof(SIMBOLO *));
+
+  //Vuelve a insertar todos los simbolos recorriendo la lista en orden
+  for (p_simbolo = lista->inicio; p_simbolo; p_simbolo = p_simbolo->siguiente)
+    insertar_en_tabla(lista, p_simbolo);
 }
 
-//+----------------------------------------------+
-//| Operaciones asociadas a la lista de simbolos |
-//+----------------------------------------------+-------------------------------------------------
-//Funcion para agregar elementos a la lista de simbolos
-void agregar_simbolo(char *nombre, int valor, int num_lin) {
-  SIMBOLO *nuevo_simbolo;
-
-  //Aloja memoria para el nuevo simbolo
-  nuevo_simbolo = malloc(sizeof(SIMBOLO));
-  //Copia la informacion del nuevo simbolo
-  nuevo_simbolo->nombre = nombre;
-  //NOTA: El puntero de la cadena solo se traslada. No se hace una copia a una nueva locacion de
-  //memoria por motivos de eficiencia y por el hecho que la cadena sera desalojada automaticamente
-  //cuando se desaloje el simbolo de la lista
-  nuevo_simbolo->valor = valor;
+//Funcion para obtener la entrada de un nombre en la lista de simbolos, creandola (como no
+//definida) si no existe previamente
+SIMBOLO *reservar_simbolo(LISTA_SIMBOLOS *lista, const char *nombre) {
+  SIMBOLO *p_simbolo;
+  unsigned int hash;
+  unsigned int mascara;
+  unsigned int i;
+
+  //Primeramente busca el nombre en la tabla hash (si ya fue creada)
+  hash = calcular_hash(nombre);
+  if (lista->ranuras) {
+    mascara = lista->capacidad - 1;
+    for (i = hash & mascara; (p_simbolo = lista->ranuras[i]); i = (i + 1) & mascara) {
+      //Solo compara las cadenas si el hash completo coincide
+      if (p_simbolo->hash == hash && strcmp(p_simbolo->nombre, nombre) == 0)
+        return p_simbolo;
+    }
+  }
+
+  //Si no existe, aloja memoria para el nuevo simbolo (en la arena de la lista)
+  p_simbolo = arena_alojar(&lista->arena, sizeof(SIMBOLO));
+  //El nombre queda internado en la arena de la lista, de manera que el resto del programa puede
+  //hacer referencia al mismo sin necesidad de crear copias adicionales
+  p_simbolo->nombre = arena_duplicar_cadena(&lista->arena, nombre);
+  p_simbolo->hash = hash;
+  p_simbolo->valor = 0;
+  p_simbolo->reubicacion = REUB_NINGUNA;
+  p_simbolo->definido = false;          //El simbolo queda pendiente de ser declarado
+  p_simbolo->publico = false;           //Solo la directiva public exporta al simbolo
   //Como se agregara un simbolo a la lista, se asegura que el siguiente sea nulo
-  nuevo_simbolo->siguiente = NULL;
+  p_simbolo->siguiente = NULL;
 
    //Si la lista esta vacia, hace que el inicio apunte al nuevo elemento
-  if (!lista_simbolos.inicio)
-    lista_simbolos.inicio = nuevo_simbolo;
+  if (!lista->inicio)
+    lista->inicio = p_simbolo;
   //Si la lista no esta vacia, agrega el nuevo elemento al final de la misma
   else
-    lista_simbolos.final->siguiente = nuevo_simbolo;
+    lista->final->siguiente = p_simbolo;
 
   //El nuevo final de la lista apunta al nuevo simbolo
-  lista_simbolos.final = nuevo_simbolo;
+  lista->final = p_simbolo;
+  lista->cantidad++;
+
+  //Mantiene el factor de carga de la tabla hash por debajo de 1/2 antes de indexar el simbolo
+  if (lista->cantidad * 2 > lista->capacidad)
+    ampliar_tabla(lista);               //Nota: esta funcion ya indexa todos los simbolos de la lista
+  else
+    insertar_en_tabla(lista, p_simbolo);
+
+  return p_simbolo;
 }
 
-//Funcion de busqueda para la lista de simbolos
-SIMBOLO *buscar_simbolo(char *nombre) {
-  SIMBOLO *p_simbolo;
+//Funcion para asignar el valor a un simbolo reservado previamente (lo marca como definido)
+void definir_simbolo(SIMBOLO *simbolo, int valor, TIPO_REUBICACION reubicacion) {
+  simbolo->valor = valor;
+  simbolo->reubicacion = reubicacion;
+  simbolo->definido = true;
+}
+
+//Funcion para agregar elementos a la lista de simbolos
+void agregar_simbolo(LISTA_SIMBOLOS *lista, char *nombre, int valor, int num_lin) {
+  definir_simbolo(reservar_simbolo(lista, nombre), valor, REUB_NINGUNA);
+}
 
-  //Inicia la busqueda con el inicio de la lista
-  p_simbolo = lista_simbolos.inicio;
-  while (p_simbolo) {
-    //Si el nombre del simbolo buscado coincide con la entrada actual, detiene el proceso
-    if (strcmp(p_simbolo->nombre, nombre) == 0) break;
-    //Caso contrario prueba con el siguiente de la lista
-    p_simbolo = p_simbolo->siguiente;
+//Funcion de busqueda para la lista de simbolos (solo encuentra simbolos definidos)
+SIMBOLO *buscar_simbolo(LISTA_SIMBOLOS *lista, char *nombre) {
+  SIMBOLO *p_simbolo;
+  unsigned int hash;
+  unsigned int mascara;
+  unsigned int i;
+
+  //Si la tabla no ha sido creada aun, no hay nada que buscar
+  if (!lista->ranuras) return NULL;
+
+  //Recorre la secuencia de sondeo comenzando por la ranura indicada por el hash
+  hash = calcular_hash(nombre);
+  mascara = lista->capacidad - 1;
+  for (i = hash & mascara; (p_simbolo = lista->ranuras[i]); i = (i + 1) & mascara) {
+    //Solo compara las cadenas si el hash completo coincide
+    if (p_simbolo->hash == hash && strcmp(p_simbolo->nombre, nombre) == 0) break;
   }
 
-  //Al final del proceso retorna el simbolo encontrado (si lo hubo)
-  return p_simbolo;
+  //Al final del proceso retorna el simbolo encontrado, siempre que este definido
+  return p_simbolo && p_simbolo->definido ? p_simbolo : NULL;
+}
+
+//Funcion para obtener el primer simbolo de la lista (los demas se recorren mediante el campo
+//siguiente, en el orden en que fueron reservados)
+SIMBOLO *primer_simbolo(LISTA_SIMBOLOS *lista) {
+  return lista->inicio;
 }
 
 //Funcion para desalojar simultaneamente todos los simbolos de la lista
-void desalojar_simbolos() {
-  SIMBOLO *p_siguiente_simbolo;
-
-  //Comienza desde el inicio de la lista
-  p_siguiente_simbolo = lista_simbolos.inicio;
-  while (p_siguiente_simbolo) {
-    //Primero se obtiene el siguiente elemento
-    p_siguiente_simbolo = lista_simbolos.inicio->siguiente;
-    //Luego desaloja el inicio de la lista
-    //NOTA: AQUI SE DESALOJAN LAS CADENAS CREADAS CON strdup() DURANTE LA ETAPA DE ANALISIS LEXICO
-    free(lista_simbolos.inicio->nombre);
-    free(lista_simbolos.inicio);
-    //Se reubica el nuevo inicio de la lista
-    lista_simbolos.inicio = p_siguiente_simbolo;
-  }
+void desalojar_simbolos(LISTA_SIMBOLOS *lista) {
+  //Los simbolos y sus nombres internados se liberan de una sola vez junto con la arena de la lista
+  arena_liberar(&lista->arena);
+  lista->inicio = NULL;
+  lista->final = NULL;
+
+  //Finalmente desaloja la tabla hash
+  free(lista->ranuras);
+  lista->ranuras = NULL;
+  lista->capacidad = 0;
+  lista->cantidad = 0;
 }
@@ -2,6 +2,7 @@
 #define j16asm_dat_struct_h_Incluida
 
 #include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include "j16asm_arena.h"               //Incluye la definicion de las arenas de memoria
 
 //Tipos de datos exportados
 //-------------------------
@@ -21,8 +22,35 @@ typedef enum _OPERACION {
 #define OPER_INTERCAMBIO 0x10000
 #define MASC_OPER        0x0FFFF        //Mascara que permite aislar la operacion en si
 
+//Enumeracion de los tipos de reubicacion de un valor (indica si el valor es una direccion dentro
+//de la memoria de programa o RAM del modulo, la cual cambia al enlazarlo junto con otros modulos)
+typedef enum _TIPO_REUBICACION {
+  REUB_NINGUNA,                 //Valor absoluto (constantes, literales, diferencias de etiquetas)
+  REUB_PRG,                     //Direccion relativa al inicio del codigo del modulo
+  REUB_RAM,                     //Direccion relativa al inicio de los datos del modulo
+  REUB_INVALIDA,                //Combinacion de direcciones que no puede reubicarse
+} TIPO_REUBICACION;
+
+//Estructura que describe el valor de una expresion literal junto con su tipo de reubicacion
+typedef struct _VALOR_EXP {
+  int valor;                    //Valor numerico de la expresion
+  TIPO_REUBICACION reub;        //Indica si el valor es una direccion reubicable
+} VALOR_EXP;
+
+//Estructura que describe una entrada de la lista de simbolos
+typedef struct _SIMBOLO {
+  char *nombre;                 //Nombre del simbolo almacenado (internado en la lista de simbolos)
+  unsigned int hash;            //Valor hash del nombre (evita comparar cadenas al buscar)
+  int valor;                    //Valor equivalente del simbolo (valor de la constante o direccion)
+  TIPO_REUBICACION reubicacion; //Indica si el valor es una direccion reubicable del modulo
+  bool definido;                //Indica si el simbolo ya fue declarado (si su valor es conocido)
+  bool publico;                 //Indica si el simbolo se exporta a otros modulos (con public)
+  struct _SIMBOLO *siguiente;   //Puntero al elemento siguiente (util para recorrer la lista)
+} SIMBOLO;
+
 //Enumeracion de los tipos de accion que pueden entrar a la cola
 typedef enum _TIPO_ACCION {
+  TPA_INICIO_EXPRESION,         //Cabecera de una expresion postergada (guarda su linea y archivo)
   TPA_APILAR_LITERAL,           //Operacion de colocar literal en la pila
   TPA_APILAR_SIMBOLO,           //Operacion de colocar simbolo (su valor equivalente) en la pila
   TPA_OPERACION_ARITMETICA,     //Operacion de realizar una operacion aritmetica
@@ -31,43 +59,68 @@ typedef enum _TIPO_ACCION {
 } TIPO_ACCION;
 
 //Estructura que describe una accion en la cola de acciones
+//Nota: Las acciones se almacenan de forma contigua. Cada expresion postergada comienza con una
+//accion TPA_INICIO_EXPRESION, continua con sus operaciones en notacion polaca inversa y termina
+//con una accion de guardar resultado (en RAM o memoria de programa).
 typedef struct _ACCION_PASO_2 {
   TIPO_ACCION tipo;     //Tipo de accion
   union {               //Valor asociado segun el tipo de accion
+    struct {            //Ubicacion de la expresion (util para reportar errores)
+      int num_lin;      //Numero de linea donde aparece la expresion
+      int fuente;       //Indice del archivo fuente donde aparece (ver j16asm_fuentes.c)
+    };
     int valor;          //El valor del literal a apilar
-    char *nombre;       //El nombre del simbolo a apilar
+    SIMBOLO *simbolo;   //La entrada de la lista de simbolos cuyo valor se apilara
     OPERACION op;       //El tipo de operacion a realizar
     int direccion;      //La direccion de RAM o programa donde se almacenara el resultado
   };
-  int num_lin;          //Numero de linea donde aparece la accion (util para reportar errores)
-  struct _ACCION_PASO_2 *siguiente;     //Siguiente elemento de la cola
 } ACCION_PASO_2;
 
-//Estructura que describe una entrada de la lista de simbolos
-typedef struct _SIMBOLO {
-  char *nombre;                 //Nombre del simbolo almacenado (usa memoria dinamica)
-  int valor;                    //Valor equivalente del simbolo (valor de la constante o direccion)
-  struct _SIMBOLO *siguiente;   //Puntero al elemento siguiente (util para recorrer la lista)
-} SIMBOLO;
+//Estructura que describe la cola de acciones (arreglo contiguo de registros de codigo)
+typedef struct _COLA_ACCIONES_PASO_2 {
+  ACCION_PASO_2 *acciones;      //Arreglo con todas las acciones encoladas (en orden)
+  int cantidad;                 //Cantidad de acciones encoladas
+  int capacidad;                //Cantidad de acciones que caben en el arreglo actual
+  bool expresion_abierta;       //Indica si hay una expresion en curso (aun sin resultado)
+  int profundidad;              //Cantidad de datos que tendra la pila en el punto actual
+  int profundidad_maxima;       //Maxima cantidad de datos que alcanzara la pila en el paso 2
+  int fuente;                   //Archivo fuente de las expresiones que se encolan a continuacion
+} COLA_ACCIONES_PASO_2;
+
+//Estructura que describe la lista de simbolos (indexada mediante una tabla hash)
+typedef struct _LISTA_SIMBOLOS {
+  SIMBOLO *inicio;              //Puntero al inicio de la lista (util para comenzar a recorrerla)
+  SIMBOLO *final;               //Puntero al final de la lista (util para agregar elementos)
+  SIMBOLO **ranuras;            //Tabla hash con punteros a los simbolos (NULL en ranuras libres)
+  unsigned int capacidad;       //Cantidad de ranuras de la tabla hash (siempre potencia de 2)
+  unsigned int cantidad;        //Cantidad de simbolos almacenados
+  ARENA arena;                  //Arena donde se alojan los simbolos y se internan sus nombres
+} LISTA_SIMBOLOS;
+
+//Inicializadores de las estructuras vacias
+#define COLA_ACCIONES_VACIA  { NULL, 0, 0, false, 0, 0, 0 }
+#define LISTA_SIMBOLOS_VACIA { NULL, NULL, NULL, 0, 0, ARENA_VACIA(8192) }
 
 //Funciones exportadas
 //--------------------
 //Funciones asociadas a la cola de operaciones
-extern void encolar_literal(int valor, int num_lin);
-extern void encolar_simbolo(char *nombre, int num_lin);
-extern void encolar_operacion(OPERACION op, int num_lin);
-extern void encolar_resultado_ram(int direccion, int num_lin);
-extern void encolar_resultado_prg(int direccion, int num_lin);
-extern ACCION_PASO_2 *desencolar_accion();
-extern void desalojar_accion(ACCION_PASO_2 *accion);
-
-//Funciones asociadas a la pila de datos
-extern void apilar_dato(int valor);
-extern bool desapilar_dato(int *valor);
+extern void encolar_literal(COLA_ACCIONES_PASO_2 *cola, int valor, int num_lin);
+extern void encolar_simbolo(COLA_ACCIONES_PASO_2 *cola, SIMBOLO *simbolo, int num_lin);
+extern void encolar_operacion(COLA_ACCIONES_PASO_2 *cola, OPERACION op, int num_lin);
+extern void encolar_resultado_ram(COLA_ACCIONES_PASO_2 *cola, int direccion, int num_lin);
+extern void encolar_resultado_prg(COLA_ACCIONES_PASO_2 *cola, int direccion, int num_lin);
+extern void fijar_fuente_acciones(COLA_ACCIONES_PASO_2 *cola, int fuente);
+extern ACCION_PASO_2 *obtener_acciones(COLA_ACCIONES_PASO_2 *cola, int *cantidad,
+                                       int *profundidad_maxima);
+extern void descartar_acciones(COLA_ACCIONES_PASO_2 *cola, int cantidad);
+extern void desalojar_acciones(COLA_ACCIONES_PASO_2 *cola);
 
 //Funciones asociadas a la lista de simbolos
-extern void agregar_simbolo(char *nombre, int valor, int num_lin);
-extern SIMBOLO *buscar_simbolo(char *nombre);
-extern void desalojar_simbolos();
+extern SIMBOLO *reservar_simbolo(LISTA_SIMBOLOS *lista, const char *nombre);
+extern void definir_simbolo(SIMBOLO *simbolo, int valor, TIPO_REUBICACION reubicacion);
+extern void agregar_simbolo(LISTA_SIMBOLOS *lista, char *nombre, int valor, int num_lin);
+extern SIMBOLO *buscar_simbolo(LISTA_SIMBOLOS *lista, char *nombre);
+extern SIMBOLO *primer_simbolo(LISTA_SIMBOLOS *lista);
+extern void desalojar_simbolos(LISTA_SIMBOLOS *lista);
 
 #endif //j16asm_dat_struct_h_Incluida
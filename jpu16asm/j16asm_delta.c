@@ -0,0 +1,176 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_delta.c                                                                                |
+//| Modulo de la salida MEM incremental                                                           |
+//|                                                                                               |
+//| Este modulo genera un archivo MEM (opcion -mdelta) que solo contiene los bloques RAMB16 cuyo  |
+//| contenido cambio desde la ultima vez que se genero, de manera que data2mem solo tiene que     |
+//| sustituir esos bloques en el bitfile ya actualizado (en vez de partir del bitfile original    |
+//| con todos los bloques). Si no cambio ningun bloque, el archivo queda vacio y no hace falta    |
+//| invocar data2mem.                                                                             |
+//| Para saber que cambio, junto al archivo MEM se guarda un archivo de estado (con extension     |
+//| .estado) con un resumen (hash FNV-1a de 64 bits) del contenido de cada bloque de la ultima    |
+//| generacion. Si no existe, o si las capacidades de memoria cambiaron, se incluyen todos los    |
+//| bloques. El estado supone que el MEM anterior se aplico al bitfile; si no fue asi, basta con  |
+//| borrar el archivo de estado.                                                                  |
+//| Nota: el contenido de los RAMB16 no se escribe directamente en el bitfile, ya que la          |
+//| ubicacion de sus bits dentro de las tramas de configuracion depende del dispositivo y solo la |
+//| conoce data2mem.                                                                              |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+#include <stdio.h>                      //Permite manejar archivos
+#include <stdlib.h>                     //Permite invocar malloc y free
+#include <string.h>                     //Permite manejar cadenas
+#include "j16asm_delta.h"               //Cabecera propia
+#include "j16asm.h"                     //Importa el contexto de ensamblado
+#include "j16asm_imagen_mem.h"          //Importa la imagen de las memorias de programa y RAM
+#include "j16asm_salida.h"              //Permite generar el archivo MEM con algunos bloques
+#include "j16asm_output_mem_bmm.h"      //Importa el formato MEM
+#include "j16asm_arena.h"               //Permite contar los alojamientos de memoria (-stats)
+#include "j16asm_messages.h"            //Permite enviar mensajes al usuario
+
+//Constantes del modulo
+#define EXTENSION_ESTADO  ".estado"     //Extension del archivo de estado (se agrega al nombre)
+#define FIRMA_ESTADO      "jpu16asm-delta"  //Primera palabra del archivo de estado
+
+//Declaracion previa de las funciones locales al modulo
+static void resumir_bloques(CONTEXTO_ASM *ctx, uint64_t *resumen_prg, uint64_t *resumen_ram);
+static uint64_t resumir(uint64_t resumen, const void *datos, size_t tam);
+static bool leer_estado(const char *nombre, CONTEXTO_ASM *ctx, uint64_t *resumen_prg,
+                        uint64_t *resumen_ram);
+static bool escribir_estado(const char *nombre, CONTEXTO_ASM *ctx, const uint64_t *resumen_prg,
+                            const uint64_t *resumen_ram);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion para generar el archivo MEM con los bloques que cambiaron y actualizar el estado
+bool escribir_mem_delta(CONTEXTO_ASM *ctx, const char *nombre) {
+  const FORMATO_SALIDA *formatos[1] = { &formato_mem };
+  const char *nombres[1] = { nombre };
+  int num_prg = ctx->tam_prg / TAM_BLOQUE_PRG, num_ram = ctx->tam_ram / TAM_BLOQUE_RAM;
+  int num_bloques = num_prg + num_ram;
+  uint64_t *resumen = malloc(2 * num_bloques * sizeof(uint64_t));  //Actual y anterior
+  uint64_t *anterior = resumen + num_bloques;
+  bool *cambio = malloc(num_bloques * sizeof(bool));
+  char *nombre_estado = malloc(strlen(nombre) + sizeof(EXTENSION_ESTADO));
+  struct _ESTADISTICAS_ENSAMBLADO *estadisticas;  //Mediciones de las salidas normales (-stats)
+  int reemplazadas;                     //Salidas normales que cambiaron (-watch)
+  bool conocido, exito;
+  int cambiados = 0, i;
+  FILE *fp_archivo;
+
+  contar_alojamiento(2 * num_bloques * sizeof(uint64_t) + num_bloques * sizeof(bool) +
+                     strlen(nombre) + sizeof(EXTENSION_ESTADO));
+  sprintf(nombre_estado, "%s%s", nombre, EXTENSION_ESTADO);
+
+  //Compara cada bloque con el de la generacion anterior (todos cambian si no se conoce)
+  resumir_bloques(ctx, resumen, resumen + num_prg);
+  conocido = leer_estado(nombre_estado, ctx, anterior, anterior + num_prg);
+  for (i=0; i<num_bloques; i++) {
+    cambio[i] = !conocido || resumen[i] != anterior[i];
+    if (cambio[i]) cambiados++;
+  }
+
+  //Genera el archivo con los bloques que cambiaron, o lo deja vacio si no hubo cambios (esta
+  //generacion no debe reemplazar las mediciones ni el conteo de las salidas normales)
+  if (cambiados) {
+    estadisticas = ctx->estadisticas;
+    reemplazadas = ctx->salidas_reemplazadas;
+    ctx->estadisticas = NULL;
+    exito = generar_salidas_bloques(ctx, formatos, nombres, 1, cambio, cambio + num_prg);
+    ctx->estadisticas = estadisticas;
+    ctx->salidas_reemplazadas = reemplazadas;
+  }
+  else {
+    fp_archivo = fopen(nombre, "w");
+    if (!fp_archivo) msg_error_crear_archivo_salida(ctx, nombre);
+    exito = fp_archivo && !fclose(fp_archivo);
+  }
+
+  //El estado solo se actualiza si el archivo se genero completo
+  if (exito && cambiados) {
+    exito = escribir_estado(nombre_estado, ctx, resumen, resumen + num_prg);
+    if (!exito) msg_error_escribir_archivo_salida(ctx, nombre_estado);
+  }
+  if (exito) msg_mem_delta(cambiados, num_bloques);
+
+  free(resumen);
+  free(cambio);
+  free(nombre_estado);
+  return exito;
+}
+
+//Funcion que obtiene el resumen del contenido de cada bloque de ambas memorias
+static void resumir_bloques(CONTEXTO_ASM *ctx, uint64_t *resumen_prg, uint64_t *resumen_ram) {
+  uint32_t datos_prg[TAM_BLOQUE_PRG];
+  uint16_t datos_ram[TAM_BLOQUE_RAM];
+  uint64_t ocupacion[TAM_BLOQUE_RAM / 64];
+  int i;
+
+  for (i=0; i<ctx->tam_prg/TAM_BLOQUE_PRG; i++) {
+    leer_bloque_prg(&ctx->imagen, i*TAM_BLOQUE_PRG, TAM_BLOQUE_PRG, datos_prg, ocupacion);
+    resumen_prg[i] = resumir(0xCBF29CE484222325ULL, datos_prg, sizeof(datos_prg));
+  }
+  for (i=0; i<ctx->tam_ram/TAM_BLOQUE_RAM; i++) {
+    leer_bloque_ram(&ctx->imagen, i*TAM_BLOQUE_RAM, TAM_BLOQUE_RAM, datos_ram, ocupacion);
+    resumen_ram[i] = resumir(0xCBF29CE484222325ULL, datos_ram, sizeof(datos_ram));
+  }
+}
+
+//Funcion que agrega un grupo de bytes al resumen FNV-1a (de 64 bits) de un bloque
+static uint64_t resumir(uint64_t resumen, const void *datos, size_t tam) {
+  const unsigned char *p = datos;
+
+  while (tam--) resumen = (resumen ^ *p++) * 0x100000001B3ULL;
+  return resumen;
+}
+
+//Funcion para leer el estado de la generacion anterior. Retorna false si no existe, si es
+//invalido o si se genero con otras capacidades de memoria
+static bool leer_estado(const char *nombre, CONTEXTO_ASM *ctx, uint64_t *resumen_prg,
+                        uint64_t *resumen_ram) {
+  FILE *fp_archivo = fopen(nombre, "r");
+  char firma[32];
+  char memoria;
+  int tam_prg, tam_ram, indice, i;
+  unsigned long long resumen;
+  bool valido;
+
+  if (!fp_archivo) return false;
+  valido = fscanf(fp_archivo, "%31s %i %i", firma, &tam_prg, &tam_ram) == 3 &&
+           strcmp(firma, FIRMA_ESTADO) == 0 && tam_prg == ctx->tam_prg &&
+           tam_ram == ctx->tam_ram;
+
+  //Cada linea tiene la memoria (p o r), el indice del bloque y su resumen
+  for (i=0; valido && i<ctx->tam_prg/TAM_BLOQUE_PRG+ctx->tam_ram/TAM_BLOQUE_RAM; i++) {
+    valido = fscanf(fp_archivo, " %c %i %llx", &memoria, &indice, &resumen) == 3;
+    if (valido && memoria == 'p' && indice >= 0 && indice < ctx->tam_prg/TAM_BLOQUE_PRG)
+      resumen_prg[indice] = resumen;
+    else if (valido && memoria == 'r' && indice >= 0 && indice < ctx->tam_ram/TAM_BLOQUE_RAM)
+      resumen_ram[indice] = resumen;
+    else valido = false;
+  }
+
+  fclose(fp_archivo);
+  return valido;
+}
+
+//Funcion para guardar el estado de la generacion actual
+static bool escribir_estado(const char *nombre, CONTEXTO_ASM *ctx, const uint64_t *resumen_prg,
+                            const uint64_t *resumen_ram) {
+  FILE *fp_archivo = fopen(nombre, "w");
+  bool exito;
+  int i;
+
+  if (!fp_archivo) return false;
+  fprintf(fp_archivo, "%s %i %i\n", FIRMA_ESTADO, ctx->tam_prg, ctx->tam_ram);
+  for (i=0; i<ctx->tam_prg/TAM_BLOQUE_PRG; i++)
+    fprintf(fp_archivo, "p %i %.16llX\n", i, (unsigned long long) resumen_prg[i]);
+  for (i=0; i<ctx->tam_ram/TAM_BLOQUE_RAM; i++)
+    fprintf(fp_archivo, "r %i %.16llX\n", i, (unsigned long long) resumen_ram[i]);
+
+  exito = !ferror(fp_archivo);
+  if (fclose(fp_archivo)) exito = false;
+  return exito;
+}
@@ -0,0 +1,12 @@
+#ifndef j16asm_delta_h_Incluida
+#define j16asm_delta_h_Incluida
+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include "j16asm.h"                     //Incluye la definicion del contexto de ensamblado
+
+//Funciones exportadas
+//--------------------
+//Funcion para generar el archivo MEM con los bloques que cambiaron desde la ultima vez (-mdelta)
+extern bool escribir_mem_delta(CONTEXTO_ASM *ctx, const char *nombre);
+
+#endif //j16asm_delta_h_Incluida
@@ -0,0 +1,716 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_disposicion.c                                                                          |
+//| Modulo de disposicion del codigo guiada por un perfil de ejecucion                            |
+//|                                                                                               |
+//| Este modulo implementa la opcion -prof archivo, la cual reordena los bloques basicos de la    |
+//| memoria de programa segun un perfil de ejecucion (p. ej. obtenido de una simulacion), de      |
+//| manera que el camino mas frecuente siga de largo en vez de saltar. Se aplica despues de -O,   |
+//| sobre la imagen ya optimizada.                                                                |
+//|                                                                                               |
+//| El perfil es un archivo de texto con una linea por direccion: "direccion ejecuciones          |
+//| [tomados]", donde ejecuciones es la cantidad de veces que se ejecuto la instruccion y tomados |
+//| (solo para los saltos condicionales) las veces que salto. Los numeros son decimales o         |
+//| hexadecimales con el prefijo 0x, el texto a partir de ; o # se ignora y una direccion         |
+//| repetida suma sus cuentas (para juntar varias corridas). Las direcciones corresponden al      |
+//| programa ensamblado con las mismas opciones pero sin -prof.                                   |
+//|                                                                                               |
+//| Dentro de cada segmento (igual que en el optimizador: inicia en una direccion fija o despues  |
+//| de un hueco, y su inicio no se mueve) los bloques se unen en cadenas de manera voraz, tomando |
+//| primero los arcos que mas saltos evitan, y las cadenas se ubican despues de la del inicio del |
+//| segmento en orden de frecuencia. Al ubicar cada bloque:                                       |
+//| - Si el bloque termina en un salto incondicional a un bloque que se ubica justo despues, el   |
+//|   salto se elimina.                                                                           |
+//| - Si termina en un salto condicional cuyo destino se ubica justo despues, se invierte la      |
+//|   condicion (jmpz pasa a jmpnz, etc.) para que salte al bloque que antes seguia de largo.     |
+//| - Si su sucesor (el que sigue de largo, o ambos en un salto condicional) no se ubica justo    |
+//|   despues, se agrega un jmp (el salto condicional va al sucesor mas frecuente).               |
+//| Los ciclos se estiman sumando dos por cada ejecucion del perfil, mas o menos dos por cada     |
+//| ejecucion de un salto agregado o eliminado; un segmento solo se reordena si sus ciclos        |
+//| estimados disminuyen y la nueva disposicion cabe hasta la siguiente localidad ocupada (el     |
+//| vector de interrupcion nunca se ocupa). Las llamadas no terminan un bloque, y si lo que sigue |
+//| a una llamada se mueve, despues de ella se agrega un jmp para que el return regrese al mismo  |
+//| lugar.                                                                                        |
+//|                                                                                               |
+//| Nota acerca de la seguridad de la transformacion                                              |
+//| Igual que el optimizador, solo se mueven instrucciones si el ensamblador conoce todos los     |
+//| lugares donde aparecen direcciones de programa: si el programa tiene saltos o llamadas        |
+//| indirectas, o si alguna direccion de programa se usa como dato, no se reordena nada y se      |
+//| avisa al usuario. Los saltos y llamadas directas se recodifican y las etiquetas se corrigen;  |
+//| el listado (-lst) conserva la linea de cada instruccion, y un salto agregado por un salto     |
+//| condicional muestra la linea de este (con su ;@iteraciones, si lo tiene, por si pasa a ser el |
+//| que cierra el lazo).                                                                          |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+#include <stdio.h>                      //Permite leer el archivo del perfil
+#include <stdlib.h>                     //Permite invocar calloc, free y qsort
+#include <string.h>                     //Permite invocar strcspn
+#include "j16asm_disposicion.h"         //Cabecera propia
+#include "j16asm.h"                     //Importa el contexto de ensamblado
+#include "j16asm_imagen_mem.h"          //Importa la imagen de las memorias de programa y RAM
+#include "j16asm_dat_struct.h"          //Importa la lista de simbolos
+#include "j16asm_fuentes.h"             //Importa el registro de archivos fuente
+#include "j16asm_listado.h"             //Permite reacomodar las lineas del listado
+#include "j16asm_optimizador.h"         //Importa la clasificacion de los saltos
+#include "j16asm_arena.h"               //Permite contar los alojamientos de memoria (-stats)
+#include "j16asm_messages.h"            //Permite enviar mensajes al usuario
+
+//Constantes del modulo
+#define TAM_LINEA_PERFIL 256            //Longitud maxima de una linea del perfil
+#define TAM_DETALLE      96             //Longitud maxima del detalle de un error del perfil
+
+//Estados de cada localidad de la memoria de programa (banderas combinables)
+#define LOC_OCUPADA      0x01           //La localidad contiene una instruccion
+#define LOC_DESTINO      0x02           //Es el destino de algun salto o llamada directa
+#define LOC_FIJA         0x04           //Inicio de segmento (la instruccion no se puede mover)
+#define LOC_LIDER        0x08           //Primera instruccion de un bloque basico
+
+//Codigos de instruccion relevantes (ver el analizador sintactico)
+#define INSTR_JMP        (0b010000 << 20)  //Salto incondicional directo (sin el destino)
+#define INVERTIR_COND    (1 << 16)      //Bit que invierte la condicion de un salto (jmpz a jmpnz)
+#define ES_LLAMADA(instr)     ((instr) >> 22 & 1)      //Llamada directa (si es salto directo)
+#define ES_CONDICIONAL(instr) ((instr) >> 21 & 1)      //Salto condicional (si es salto directo)
+#define ES_RETORNO(instr)     ((instr) >> 23 == 0b011) //return, idret o ieret
+
+//Forma en que termina un bloque basico
+typedef enum _FIN_BLOQUE {
+  FB_SIGUE,                             //Sigue de largo (tambien las llamadas)
+  FB_SALTO,                             //Salto incondicional directo
+  FB_SALTO_COND,                        //Salto condicional directo
+  FB_RETORNO                            //return, idret o ieret
+} FIN_BLOQUE;
+
+//Estructura con un bloque basico del segmento que se esta reordenando
+typedef struct _BLOQUE {
+  int inicio;                           //Direccion de su primera instruccion
+  int fin;                              //Direccion de su ultima instruccion
+  FIN_BLOQUE tipo;                      //Forma en que termina
+  int tomado;                           //Bloque al que salta (-1 si no salta dentro del segmento)
+  int siguiente;                        //Bloque que le sigue de largo (-1 si es el ultimo)
+  unsigned long long ejecuciones;       //Ejecuciones de su ultima instruccion
+  unsigned long long tomados;           //Veces que salto (solo los saltos condicionales)
+  int cadena;                           //Cadena a la que pertenece
+  int sucesor;                          //Bloque que le sigue en su cadena (-1 si es el ultimo)
+  int proximo;                          //Bloque que queda justo despues en la nueva disposicion
+} BLOQUE;
+
+//Estructura con una cadena de bloques que se ubican uno despues del otro
+typedef struct _CADENA {
+  int cabeza;                           //Primer bloque
+  int cola;                             //Ultimo bloque
+  unsigned long long frecuencia;        //Ejecuciones de la primera instruccion de la cabeza
+  bool unida;                           //Se unio al final de otra cadena (ya no existe)
+} CADENA;
+
+//Estructura con un arco entre dos bloques (el paso de uno a otro durante la ejecucion)
+typedef struct _ARCO {
+  int origen;                           //Bloque de donde sale
+  int destino;                          //Bloque a donde llega
+  unsigned long long peso;              //Ejecuciones de saltos que se evitan si se unen
+  unsigned long long recorridos;        //Veces que se recorrio segun el perfil
+  bool de_largo;                        //El destino le seguia de largo en la disposicion original
+} ARCO;
+
+//Estructura con el programa que se esta reordenando
+typedef struct _DISPOSICION {
+  CONTEXTO_ASM *ctx;                    //Contexto de ensamblado
+  int tam;                              //Capacidad de la memoria de programa
+  uint32_t *instr;                      //Instrucciones originales (indexadas por direccion)
+  int *destino;                         //Direccion destino de cada salto o llamada directa
+  uint8_t *estado;                      //Estado de cada localidad (banderas LOC_xxx)
+  unsigned long long *ejecuciones;      //Ejecuciones de cada instruccion segun el perfil
+  unsigned long long *tomados;          //Veces que salto cada salto condicional segun el perfil
+  int *mapa;                            //Nueva direccion de cada direccion original
+  uint32_t *nuevas;                     //Instrucciones de la nueva disposicion
+  int *destino_nuevo;                   //Direccion original del destino de cada nuevo salto
+  int *linea;                           //Direccion original cuya linea toma cada nueva direccion
+  bool *ocupada;                        //Ocupacion de la nueva disposicion
+  BLOQUE *bloques;                      //Bloques del segmento actual (en el orden original)
+  int *bloque_de;                       //Bloque al que pertenece cada direccion del segmento
+  CADENA *cadenas;                      //Cadenas del segmento actual
+  ARCO *arcos;                          //Arcos del segmento actual
+  int *orden;                           //Bloques del segmento en el orden de la nueva disposicion
+  ESTADISTICAS_DISPOSICION *estadisticas;
+} DISPOSICION;
+
+//Estructura con lo que resulta de ubicar los bloques de un segmento
+typedef struct _UBICACION {
+  int inicio;                           //Inicio del segmento
+  int fin;                              //Ultima direccion original del segmento
+  int limite;                           //Primera direccion que el segmento no puede ocupar
+  int posicion;                         //Siguiente direccion libre de la nueva disposicion
+  long long ahorro;                     //Ejecuciones de saltos eliminadas menos las agregadas
+  bool salida_movil;                    //Algun salto va a la direccion posterior al fin
+  bool excedido;                        //La nueva disposicion no cupo hasta el limite
+  unsigned long long pendientes;        //Ejecuciones que siguen de largo fuera del segmento
+  int linea_pendiente;                  //Linea del salto condicional que sigue de largo fuera
+  int eliminados;                       //Saltos incondicionales eliminados
+  int agregados;                        //Saltos incondicionales agregados
+  int invertidos;                       //Saltos condicionales invertidos
+} UBICACION;
+
+//Declaracion previa de las funciones locales al modulo
+static void *alojar(size_t cantidad, size_t tam);
+static bool leer_perfil(DISPOSICION *d, const char *nombre);
+static bool leer_numero(const char **texto, unsigned long long *valor);
+static void marcar_segmentos(DISPOSICION *d);
+static void disponer_segmento(DISPOSICION *d, int inicio, int fin, int limite);
+static int dividir_bloques(DISPOSICION *d, int inicio, int fin);
+static void formar_cadenas(DISPOSICION *d, int num_bloques);
+static int agregar_arco(DISPOSICION *d, int num_arcos, int origen, int destino,
+                        unsigned long long peso, unsigned long long recorridos, bool de_largo);
+static int comparar_arcos(const void *a, const void *b);
+static void ordenar_cadenas(DISPOSICION *d, int num_bloques);
+static int comparar_cadenas(const void *a, const void *b);
+static void ubicar_bloque(DISPOSICION *d, UBICACION *u, int bloque);
+static void colocar(DISPOSICION *d, UBICACION *u, uint32_t instr, int destino, int origen,
+                    int linea);
+static void agregar_salto(DISPOSICION *d, UBICACION *u, int destino, int linea,
+                          unsigned long long ejecuciones);
+static void restaurar_segmento(DISPOSICION *d, int inicio, int fin, int posicion);
+static void reubicar(DISPOSICION *d);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion que reordena la memoria de programa del contexto segun el perfil indicado. Debe
+//invocarse despues del paso 2 (y de -O) y antes de desalojar la lista de simbolos, ya que las
+//etiquetas se corrigen. Retorna false si no se pudo leer el perfil
+bool disponer_programa(CONTEXTO_ASM *ctx, const char *nombre_perfil,
+                       ESTADISTICAS_DISPOSICION *estadisticas) {
+  DISPOSICION d;
+  INFO_OPTIMIZACION *info = &ctx->info_optimizacion;
+  int direccion, salto_indirecto = -1;
+  bool exito;
+
+  estadisticas->segmentos = 0;
+  estadisticas->bloques = 0;
+  estadisticas->saltos_eliminados = 0;
+  estadisticas->saltos_agregados = 0;
+  estadisticas->saltos_invertidos = 0;
+  estadisticas->ciclos_antes = 0;
+  estadisticas->reordenado = false;
+
+  //Copia el programa a arreglos indexados por direccion; la nueva disposicion inicia igual a la
+  //original y cada segmento que se reordena la reemplaza en su parte
+  d.ctx = ctx;
+  d.tam = ctx->tam_prg;
+  d.estadisticas = estadisticas;
+  d.instr = alojar(d.tam, sizeof(uint32_t));
+  d.destino = alojar(d.tam, sizeof(int));
+  d.estado = alojar(d.tam, sizeof(uint8_t));
+  d.ejecuciones = alojar(d.tam, sizeof(unsigned long long));
+  d.tomados = alojar(d.tam, sizeof(unsigned long long));
+  d.mapa = alojar(d.tam, sizeof(int));
+  d.nuevas = alojar(d.tam, sizeof(uint32_t));
+  d.destino_nuevo = alojar(d.tam, sizeof(int));
+  d.linea = alojar(d.tam, sizeof(int));
+  d.ocupada = alojar(d.tam, sizeof(bool));
+  d.bloques = alojar(d.tam, sizeof(BLOQUE));
+  d.bloque_de = alojar(d.tam, sizeof(int));
+  d.cadenas = alojar(d.tam, sizeof(CADENA));
+  d.arcos = alojar(2 * d.tam, sizeof(ARCO));        //Hasta dos arcos por bloque
+  d.orden = alojar(d.tam, sizeof(int));
+  for (direccion=0; direccion<d.tam; direccion++) {
+    d.destino[direccion] = -1;
+    d.mapa[direccion] = direccion;
+    d.linea[direccion] = -1;
+    if (!localidad_prg_ocupada(&ctx->imagen, direccion)) continue;
+    d.estado[direccion] = LOC_OCUPADA;
+    d.instr[direccion] = leer_dato_prg(&ctx->imagen, direccion);
+    if (ES_SALTO_DIRECTO(d.instr[direccion]))
+      d.destino[direccion] = (direccion + (int16_t) d.instr[direccion]) & (d.tam - 1);
+    if (salto_indirecto < 0 && ES_SALTO_INDIRECTO(d.instr[direccion]))
+      salto_indirecto = direccion;
+    d.nuevas[direccion] = d.instr[direccion];
+    d.destino_nuevo[direccion] = d.destino[direccion];
+    d.linea[direccion] = direccion;
+    d.ocupada[direccion] = true;
+  }
+
+  //Lee el perfil y estima los ciclos de la disposicion original
+  exito = leer_perfil(&d, nombre_perfil);
+  for (direccion=0; direccion<d.tam; direccion++)
+    estadisticas->ciclos_antes += 2 * d.ejecuciones[direccion];
+  estadisticas->ciclos_despues = estadisticas->ciclos_antes;
+
+  //Un salto indirecto puede llegar a cualquier direccion, y una direccion de programa usada como
+  //dato no se puede corregir, asi que en esos casos no se mueve nada
+  if (exito && salto_indirecto >= 0)
+    msg_disposicion_salto_indirecto(ctx, salto_indirecto);
+  else if (exito && info->referencias_prg) {
+    seleccionar_fuente(ctx, info->fuente_referencia);
+    msg_disposicion_referencia_prg(ctx, info->lin_referencia);
+  }
+  else if (exito) {
+    estadisticas->reordenado = true;
+    marcar_segmentos(&d);
+    if (estadisticas->segmentos) reubicar(&d);
+  }
+
+  free(d.instr);
+  free(d.destino);
+  free(d.estado);
+  free(d.ejecuciones);
+  free(d.tomados);
+  free(d.mapa);
+  free(d.nuevas);
+  free(d.destino_nuevo);
+  free(d.linea);
+  free(d.ocupada);
+  free(d.bloques);
+  free(d.bloque_de);
+  free(d.cadenas);
+  free(d.arcos);
+  free(d.orden);
+  return exito;
+}
+
+//Funcion que aloja un arreglo iniciado en cero y lo cuenta para las mediciones
+static void *alojar(size_t cantidad, size_t tam) {
+  contar_alojamiento(cantidad * tam);
+  return calloc(cantidad, tam);
+}
+
+//Funcion que lee el perfil de ejecucion y acumula sus cuentas (retorna false si hay un error).
+//El perfil se registra como fuente para que aparezca en las dependencias de -MD y en -watch
+static bool leer_perfil(DISPOSICION *d, const char *nombre) {
+  FILE *fp_archivo;
+  char linea[TAM_LINEA_PERFIL], detalle[TAM_DETALLE];
+  const char *texto;
+  unsigned long long valores[3];        //Direccion, ejecuciones y tomados
+  int num_valores, num_lin = 0;
+
+  fp_archivo = fopen(nombre, "r");
+  if (!fp_archivo) {
+    msg_error_abrir_perfil(d->ctx, nombre);
+    return false;
+  }
+  registrar_fuente(&d->ctx->registro_fuentes, nombre);
+
+  detalle[0] = '\0';
+  while (!detalle[0] && fgets(linea, sizeof(linea), fp_archivo)) {
+    num_lin++;
+    linea[strcspn(linea, ";#\r\n")] = '\0';       //Descarta el comentario y el fin de linea
+
+    //Lee los numeros de la linea (las lineas en blanco se ignoran)
+    for (texto=linea, num_valores=0; ; num_valores++) {
+      while (*texto == ' ' || *texto == '\t') texto++;
+      if (!*texto) break;
+      if (num_valores == 3 || !leer_numero(&texto, &valores[num_valores])) break;
+    }
+    if (!num_valores) continue;
+
+    if (*texto || num_valores < 2)
+      snprintf(detalle, sizeof(detalle), "se esperaba: direccion ejecuciones [tomados]");
+    else if (valores[0] >= (unsigned long long) d->tam)
+      snprintf(detalle, sizeof(detalle), "la direccion 0x%.4llX esta fuera de la memoria de "
+               "programa", valores[0]);
+    else if (!(d->estado[valores[0]] & LOC_OCUPADA))
+      snprintf(detalle, sizeof(detalle), "la direccion 0x%.4llX no contiene una instruccion",
+               valores[0]);
+    else if (num_valores == 3 && valores[2] > valores[1])
+      snprintf(detalle, sizeof(detalle), "los saltos tomados superan las ejecuciones");
+    else {
+      d->ejecuciones[valores[0]] += valores[1];
+      if (num_valores == 3) d->tomados[valores[0]] += valores[2];
+    }
+  }
+  fclose(fp_archivo);
+
+  if (detalle[0]) msg_perfil_invalido(d->ctx, nombre, num_lin, detalle);
+  return !detalle[0];
+}
+
+//Funcion que lee un numero decimal, o hexadecimal con el prefijo 0x, seguido de un espacio o del
+//fin de la linea. Avanza el texto hasta despues del numero (retorna false si no es valido)
+static bool leer_numero(const char **texto, unsigned long long *valor) {
+  const char *inicio = *texto, *caracter;
+  int base = 10, digito;
+
+  if (inicio[0] == '0' && (inicio[1] == 'x' || inicio[1] == 'X')) {
+    base = 16;
+    inicio += 2;
+  }
+  for (*valor=0, caracter=inicio; ; caracter++) {
+    if (*caracter >= '0' && *caracter <= '9') digito = *caracter - '0';
+    else if (base == 16 && *caracter >= 'a' && *caracter <= 'f') digito = *caracter - 'a' + 10;
+    else if (base == 16 && *caracter >= 'A' && *caracter <= 'F') digito = *caracter - 'A' + 10;
+    else break;
+    *valor = *valor * base + digito;
+  }
+  if (caracter == inicio || (*caracter && *caracter != ' ' && *caracter != '\t')) return false;
+  *texto = caracter;
+  return true;
+}
+
+//Funcion que divide la memoria de programa en segmentos (como el optimizador: inician despues de
+//un hueco o en una direccion fija) y reordena cada uno. Un segmento puede crecer hasta la
+//siguiente localidad ocupada, pero nunca hasta la ultima direccion (vector de interrupcion)
+static void marcar_segmentos(DISPOSICION *d) {
+  INFO_OPTIMIZACION *info = &d->ctx->info_optimizacion;
+  int direccion, inicio, limite, i;
+
+  for (i=0; i<info->num_fijas; i++)
+    if (info->fijas[i] >= 0 && info->fijas[i] < d->tam) d->estado[info->fijas[i]] |= LOC_FIJA;
+  d->estado[0] |= LOC_FIJA;
+  d->estado[d->tam - 1] |= LOC_FIJA;
+  for (direccion=0; direccion<d->tam; direccion++)
+    if (d->destino[direccion] >= 0) d->estado[d->destino[direccion]] |= LOC_DESTINO;
+
+  for (direccion=0; direccion<d->tam; direccion++) {
+    if (!(d->estado[direccion] & LOC_OCUPADA)) continue;
+
+    //Busca el final del segmento que inicia aqui y la siguiente localidad ocupada
+    inicio = direccion;
+    while (direccion + 1 < d->tam && (d->estado[direccion + 1] & (LOC_OCUPADA | LOC_FIJA)) ==
+           LOC_OCUPADA)
+      direccion++;
+    for (limite=direccion + 1; limite < d->tam - 1 && !(d->estado[limite] & LOC_OCUPADA); )
+      limite++;
+    disponer_segmento(d, inicio, direccion, limite);
+  }
+}
+
+//Funcion que reordena los bloques de un segmento si con ello disminuyen los ciclos estimados
+static void disponer_segmento(DISPOSICION *d, int inicio, int fin, int limite) {
+  ESTADISTICAS_DISPOSICION *estadisticas = d->estadisticas;
+  UBICACION u = { inicio, fin, limite, inicio, 0, false, false, 0, -1, 0, 0, 0 };
+  BLOQUE *bloque;
+  int num_bloques, direccion, proximo, k;
+  bool valida;
+
+  num_bloques = dividir_bloques(d, inicio, fin);
+  if (num_bloques < 2) return;
+  formar_cadenas(d, num_bloques);
+  ordenar_cadenas(d, num_bloques);
+
+  //Cada bloque tiene que saber cual queda justo despues de el. Un bloque que solo tiene un salto
+  //al que le sigue desaparece, asi que se busca de atras hacia adelante el primero que queda
+  for (k=num_bloques - 1, proximo=-1; k>=0; k--) {
+    bloque = &d->bloques[d->orden[k]];
+    bloque->proximo = proximo;
+    if (bloque->inicio != bloque->fin || bloque->tipo != FB_SALTO || bloque->tomado < 0 ||
+        bloque->tomado != proximo)
+      proximo = d->orden[k];
+  }
+
+  //Ubica los bloques en el nuevo orden
+  for (k=0; k<num_bloques; k++) ubicar_bloque(d, &u, d->orden[k]);
+
+  //Si el ultimo bloque sigue de largo fuera del segmento y el segmento cambio de tamaño, ahora
+  //tiene que saltar a donde antes llegaba
+  if (u.pendientes && u.posicion != fin + 1)
+    agregar_salto(d, &u, (fin + 1) & (d->tam - 1), u.linea_pendiente, u.pendientes);
+
+  //La nueva disposicion solo se conserva si ahorra ciclos y cabe: lo que crece solo puede ocupar
+  //localidades libres a las que no llega ningun salto
+  valida = !u.excedido && u.ahorro > 0 && !(u.salida_movil && u.posicion > fin + 1);
+  for (direccion=fin + 1; valida && direccion<u.posicion; direccion++)
+    if (d->estado[direccion] & LOC_DESTINO) valida = false;
+  if (!valida) {
+    restaurar_segmento(d, inicio, fin, u.posicion);
+    return;
+  }
+
+  //Libera lo que sobra si el segmento se redujo
+  for (direccion=u.posicion; direccion<=fin; direccion++) {
+    d->ocupada[direccion] = false;
+    d->linea[direccion] = -1;
+  }
+  estadisticas->segmentos++;
+  estadisticas->bloques += num_bloques;
+  estadisticas->saltos_eliminados += u.eliminados;
+  estadisticas->saltos_agregados += u.agregados;
+  estadisticas->saltos_invertidos += u.invertidos;
+  estadisticas->ciclos_despues -= 2 * u.ahorro;
+}
+
+//Funcion que divide un segmento en bloques basicos (retorna la cantidad). Un bloque inicia al
+//inicio del segmento, en el destino de un salto o llamada, o despues de un salto o retorno
+static int dividir_bloques(DISPOSICION *d, int inicio, int fin) {
+  BLOQUE *bloque = NULL;
+  uint32_t instr;
+  int direccion, num_bloques = 0, i;
+
+  d->estado[inicio] |= LOC_LIDER;
+  for (direccion=inicio; direccion<=fin; direccion++) {
+    instr = d->instr[direccion];
+    if (d->estado[direccion] & LOC_DESTINO) d->estado[direccion] |= LOC_LIDER;
+    if (direccion < fin &&
+        ((ES_SALTO_DIRECTO(instr) && !ES_LLAMADA(instr)) || ES_RETORNO(instr)))
+      d->estado[direccion + 1] |= LOC_LIDER;
+  }
+  for (direccion=inicio; direccion<=fin; direccion++) {
+    if (d->estado[direccion] & LOC_LIDER) {
+      bloque = &d->bloques[num_bloques++];
+      bloque->inicio = direccion;
+    }
+    bloque->fin = direccion;
+    d->bloque_de[direccion] = num_bloques - 1;
+  }
+
+  //Clasifica cada bloque segun su ultima instruccion
+  for (i=0; i<num_bloques; i++) {
+    bloque = &d->bloques[i];
+    instr = d->instr[bloque->fin];
+    bloque->ejecuciones = d->ejecuciones[bloque->fin];
+    bloque->tomados = 0;
+    bloque->tomado = -1;
+    bloque->siguiente = bloque->fin < fin ? i + 1 : -1;
+    bloque->cadena = i;
+    bloque->sucesor = -1;
+    //Un salto condicional a la instruccion siguiente (sin -O) llega al mismo lugar salte o no
+    if (ES_RETORNO(instr))
+      bloque->tipo = FB_RETORNO;
+    else if (!ES_SALTO_DIRECTO(instr) || ES_LLAMADA(instr) ||
+             (ES_CONDICIONAL(instr) && d->destino[bloque->fin] == bloque->fin + 1))
+      bloque->tipo = FB_SIGUE;
+    else {
+      bloque->tipo = ES_CONDICIONAL(instr) ? FB_SALTO_COND : FB_SALTO;
+      if (bloque->tipo == FB_SALTO_COND) bloque->tomados = d->tomados[bloque->fin];
+      if (d->destino[bloque->fin] >= inicio && d->destino[bloque->fin] <= fin)
+        bloque->tomado = d->bloque_de[d->destino[bloque->fin]];
+    }
+  }
+  return num_bloques;
+}
+
+//Funcion que une los bloques en cadenas de manera voraz: recorre los arcos del que mas ahorra al
+//que menos ahorra y une el origen con el destino si el origen es el ultimo de su cadena y el
+//destino el primero de otra. El primer bloque del segmento siempre inicia su cadena. Un salto
+//condicional tarda lo mismo si salta o no, asi que basta que cualquiera de sus sucesores quede
+//despues de el para evitar el jmp hacia el menos frecuente: ambos arcos ahorran lo mismo
+static void formar_cadenas(DISPOSICION *d, int num_bloques) {
+  BLOQUE *bloque;
+  ARCO *arco;
+  unsigned long long no_tomados, minimo;
+  int num_arcos = 0, origen, destino, bloque_unido, i;
+
+  for (i=0; i<num_bloques; i++) {
+    bloque = &d->bloques[i];
+    d->cadenas[i].cabeza = d->cadenas[i].cola = i;
+    d->cadenas[i].unida = false;
+    switch (bloque->tipo) {
+    case FB_SIGUE:
+      num_arcos = agregar_arco(d, num_arcos, i, bloque->siguiente, bloque->ejecuciones,
+                               bloque->ejecuciones, true);
+      break;
+    case FB_SALTO:
+      num_arcos = agregar_arco(d, num_arcos, i, bloque->tomado, bloque->ejecuciones,
+                               bloque->ejecuciones, false);
+      break;
+    case FB_SALTO_COND:
+      no_tomados = bloque->ejecuciones - bloque->tomados;
+      minimo = bloque->tomados < no_tomados ? bloque->tomados : no_tomados;
+      num_arcos = agregar_arco(d, num_arcos, i, bloque->tomado, minimo, bloque->tomados, false);
+      num_arcos = agregar_arco(d, num_arcos, i, bloque->siguiente, minimo, no_tomados, true);
+      break;
+    case FB_RETORNO:
+      break;
+    }
+  }
+  qsort(d->arcos, num_arcos, sizeof(ARCO), comparar_arcos);
+
+  for (i=0; i<num_arcos; i++) {
+    arco = &d->arcos[i];
+
+    //Los arcos que no ahorran nada solo unen lo que ya seguia de largo (lo que no se ejecuta
+    //conserva su forma original)
+    if (!arco->peso && !arco->de_largo) continue;
+    origen = d->bloques[arco->origen].cadena;
+    destino = d->bloques[arco->destino].cadena;
+    if (arco->destino == 0 || origen == destino || d->cadenas[origen].cola != arco->origen ||
+        d->cadenas[destino].cabeza != arco->destino)
+      continue;
+
+    d->bloques[arco->origen].sucesor = arco->destino;
+    for (bloque_unido=arco->destino; bloque_unido>=0;
+         bloque_unido=d->bloques[bloque_unido].sucesor)
+      d->bloques[bloque_unido].cadena = origen;
+    d->cadenas[origen].cola = d->cadenas[destino].cola;
+    d->cadenas[destino].unida = true;
+  }
+}
+
+//Funcion que agrega un arco a la lista si su destino esta dentro del segmento (retorna la nueva
+//cantidad de arcos)
+static int agregar_arco(DISPOSICION *d, int num_arcos, int origen, int destino,
+                        unsigned long long peso, unsigned long long recorridos, bool de_largo) {
+  if (destino < 0 || destino == origen) return num_arcos;
+  d->arcos[num_arcos].origen = origen;
+  d->arcos[num_arcos].destino = destino;
+  d->arcos[num_arcos].peso = peso;
+  d->arcos[num_arcos].recorridos = recorridos;
+  d->arcos[num_arcos].de_largo = de_largo;
+  return num_arcos + 1;
+}
+
+//Funcion de comparacion para ordenar los arcos: primero los que mas ahorran, luego los mas
+//frecuentes (el camino frecuente queda junto), los que siguen de largo (conservan la disposicion
+//original) y finalmente en el orden del programa
+static int comparar_arcos(const void *a, const void *b) {
+  const ARCO *arco_a = a, *arco_b = b;
+
+  if (arco_a->peso != arco_b->peso) return arco_a->peso > arco_b->peso ? -1 : 1;
+  if (arco_a->recorridos != arco_b->recorridos)
+    return arco_a->recorridos > arco_b->recorridos ? -1 : 1;
+  if (arco_a->de_largo != arco_b->de_largo) return arco_a->de_largo ? -1 : 1;
+  return arco_a->origen - arco_b->origen;
+}
+
+//Funcion que ordena las cadenas (primero la del inicio del segmento, luego de la mas frecuente a
+//la menos frecuente, y a igual frecuencia en el orden del programa) y arma el orden de los bloques
+static void ordenar_cadenas(DISPOSICION *d, int num_bloques) {
+  int num_cadenas = 0, bloque, k = 0, i;
+
+  for (i=0; i<num_bloques; i++) {
+    if (d->cadenas[i].unida) continue;
+    d->cadenas[num_cadenas] = d->cadenas[i];
+    d->cadenas[num_cadenas++].frecuencia =
+      d->ejecuciones[d->bloques[d->cadenas[i].cabeza].inicio];
+  }
+  qsort(d->cadenas, num_cadenas, sizeof(CADENA), comparar_cadenas);
+
+  for (i=0; i<num_cadenas; i++)
+    for (bloque=d->cadenas[i].cabeza; bloque>=0; bloque=d->bloques[bloque].sucesor)
+      d->orden[k++] = bloque;
+}
+
+//Funcion de comparacion para ordenar las cadenas
+static int comparar_cadenas(const void *a, const void *b) {
+  const CADENA *cadena_a = a, *cadena_b = b;
+
+  if (!cadena_a->cabeza || !cadena_b->cabeza) return cadena_a->cabeza ? 1 : -1;
+  if (cadena_a->frecuencia != cadena_b->frecuencia)
+    return cadena_a->frecuencia > cadena_b->frecuencia ? -1 : 1;
+  return cadena_a->cabeza - cadena_b->cabeza;
+}
+
+//Funcion que ubica un bloque en la nueva disposicion sabiendo cual queda justo despues de el
+//(-1 si es el ultimo). Elimina, invierte o agrega saltos segun haga falta
+static void ubicar_bloque(DISPOSICION *d, UBICACION *u, int bloque) {
+  BLOQUE *b = &d->bloques[bloque];
+  int proximo = b->proximo;
+  uint32_t instr = d->instr[b->fin];
+  int sig = (b->fin + 1) & (d->tam - 1);         //Direccion que le sigue de largo
+  unsigned long long no_tomados = b->ejecuciones - b->tomados;
+  bool sigue, salta;                  //Su sucesor (o el destino del salto) queda justo despues
+  int direccion;
+
+  for (direccion=b->inicio; direccion<b->fin; direccion++)
+    colocar(d, u, d->instr[direccion], d->destino[direccion], direccion, direccion);
+
+  //Fuera del segmento se sigue de largo solo si es el ultimo (el tamaño se revisa al final)
+  sigue = b->siguiente >= 0 ? b->siguiente == proximo : proximo < 0;
+  salta = b->tomado >= 0 && b->tomado == proximo;
+  switch (b->tipo) {
+  case FB_SIGUE:
+    colocar(d, u, instr, d->destino[b->fin], b->fin, b->fin);
+    if (!sigue) agregar_salto(d, u, sig, -1, b->ejecuciones);
+    else if (b->siguiente < 0) u->pendientes = b->ejecuciones;
+    break;
+  case FB_SALTO:
+    //Un salto al bloque que queda justo despues se elimina (su direccion pasa a ser la de ese
+    //bloque, para las etiquetas y los saltos que llegaban a el)
+    if (salta) {
+      d->mapa[b->fin] = u->posicion;
+      u->ahorro += b->ejecuciones;
+      u->eliminados++;
+    }
+    else
+      colocar(d, u, instr, d->destino[b->fin], b->fin, b->fin);
+    break;
+  case FB_SALTO_COND:
+    //Si el destino queda justo despues, la condicion se invierte para saltar a donde antes
+    //seguia de largo; si ningun sucesor queda despues, el condicional va al mas frecuente y el
+    //otro se alcanza con un salto agregado
+    if (sigue) {
+      colocar(d, u, instr, d->destino[b->fin], b->fin, b->fin);
+      if (b->siguiente < 0) {
+        u->pendientes = no_tomados;
+        u->linea_pendiente = b->fin;
+      }
+    }
+    else if (salta || b->tomados > no_tomados) {
+      colocar(d, u, instr ^ INVERTIR_COND, sig, b->fin, b->fin);
+      u->invertidos++;
+      if (!salta) agregar_salto(d, u, d->destino[b->fin], b->fin, b->tomados);
+    }
+    else {
+      colocar(d, u, instr, d->destino[b->fin], b->fin, b->fin);
+      agregar_salto(d, u, sig, b->fin, no_tomados);
+    }
+    break;
+  case FB_RETORNO:
+    colocar(d, u, instr, -1, b->fin, b->fin);
+    break;
+  }
+}
+
+//Funcion que coloca una instruccion en la siguiente direccion de la nueva disposicion: origen es
+//su direccion original (-1 si es un salto agregado) y linea la direccion cuya linea de listado
+//toma. El destino de un salto se guarda como direccion original y se recodifica al final
+static void colocar(DISPOSICION *d, UBICACION *u, uint32_t instr, int destino, int origen,
+                    int linea) {
+  if (u->posicion >= u->limite) {
+    u->excedido = true;
+    return;
+  }
+  if (origen >= 0) d->mapa[origen] = u->posicion;
+  if (destino == u->fin + 1) u->salida_movil = true;
+  d->nuevas[u->posicion] = instr;
+  d->destino_nuevo[u->posicion] = destino;
+  d->linea[u->posicion] = linea;
+  d->ocupada[u->posicion++] = true;
+}
+
+//Funcion que agrega un salto incondicional a la nueva disposicion (cada ejecucion cuesta dos
+//ciclos mas)
+static void agregar_salto(DISPOSICION *d, UBICACION *u, int destino, int linea,
+                          unsigned long long ejecuciones) {
+  colocar(d, u, INSTR_JMP, destino, -1, linea);
+  u->ahorro -= ejecuciones;
+  u->agregados++;
+}
+
+//Funcion que descarta la nueva disposicion de un segmento y deja la original
+static void restaurar_segmento(DISPOSICION *d, int inicio, int fin, int posicion) {
+  int direccion;
+
+  for (direccion=inicio; direccion<=fin; direccion++) {
+    d->mapa[direccion] = direccion;
+    d->nuevas[direccion] = d->instr[direccion];
+    d->destino_nuevo[direccion] = d->destino[direccion];
+    d->linea[direccion] = direccion;
+    d->ocupada[direccion] = true;
+  }
+  for (direccion=fin + 1; direccion<posicion && direccion<d->tam; direccion++) {
+    d->ocupada[direccion] = false;
+    d->linea[direccion] = -1;
+  }
+}
+
+//Funcion que escribe la nueva disposicion en la memoria de programa, recodificando todos los
+//saltos y llamadas directas, y corrige las etiquetas de programa y las lineas del listado
+static void reubicar(DISPOSICION *d) {
+  CONTEXTO_ASM *ctx = d->ctx;
+  SIMBOLO *simbolo;
+  uint32_t instr;
+  int direccion, destino;
+
+  desalojar_imagen_prg(&ctx->imagen);
+  for (direccion=0; direccion<d->tam; direccion++) {
+    if (!d->ocupada[direccion]) continue;
+    instr = d->nuevas[direccion];
+    destino = d->destino_nuevo[direccion];
+    if (destino >= 0) instr = (instr & ~0xFFFF) | ((d->mapa[destino] - direccion) & 0xFFFF);
+    escribir_dato_prg(&ctx->imagen, direccion, instr);
+  }
+  reordenar_lineas_prg(&ctx->info_listado, d->linea, d->tam);
+
+  for (simbolo=primer_simbolo(&ctx->lista_simbolos); simbolo; simbolo=simbolo->siguiente)
+    if (simbolo->definido && simbolo->reubicacion == REUB_PRG && simbolo->valor >= 0 &&
+        simbolo->valor < d->tam)
+      simbolo->valor = d->mapa[simbolo->valor];
+}
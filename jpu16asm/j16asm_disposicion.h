@@ -0,0 +1,29 @@
+#ifndef j16asm_disposicion_h_Incluida
+#define j16asm_disposicion_h_Incluida
+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+
+//Tipos de datos exportados
+//-------------------------
+//Estadisticas de una disposicion del codigo guiada por un perfil de ejecucion
+typedef struct _ESTADISTICAS_DISPOSICION {
+  int segmentos;                        //Segmentos cuyos bloques se reordenaron
+  int bloques;                          //Bloques basicos de esos segmentos
+  int saltos_eliminados;                //Saltos incondicionales que ya no hacen falta
+  int saltos_agregados;                 //Saltos incondicionales agregados para unir bloques
+  int saltos_invertidos;                //Saltos condicionales con la condicion invertida
+  unsigned long long ciclos_antes;      //Ciclos del perfil con la disposicion original
+  unsigned long long ciclos_despues;    //Ciclos estimados con la nueva disposicion
+  bool reordenado;                      //Indica si se pudieron mover instrucciones
+} ESTADISTICAS_DISPOSICION;
+
+//Declaracion previa del contexto de ensamblado (definido en j16asm.h)
+struct _CONTEXTO_ASM;
+
+//Funciones exportadas
+//--------------------
+//Funcion que reordena la memoria de programa segun un perfil de ejecucion (despues de -O)
+extern bool disponer_programa(struct _CONTEXTO_ASM *ctx, const char *nombre_perfil,
+                              ESTADISTICAS_DISPOSICION *estadisticas);
+
+#endif //j16asm_disposicion_h_Incluida
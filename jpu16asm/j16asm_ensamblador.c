@@ -0,0 +1,337 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_ensamblador.c                                                                          |
+//| Modulo del nucleo del ensamblador                                                             |
+//|                                                                                               |
+//| Este modulo lleva a cabo las tareas principales del ensamblador sobre un contexto de          |
+//| ensamblado (CONTEXTO_ASM), el cual agrupa todo el estado de un ensamblado. El paso 1 de       |
+//| compilacion se lleva a cabo por medio de invocar la funcion yyparse(), la cual es provista por|
+//| bison en el modulo de codigo fuente que genera mediante el archivo de gramatica asociado.     |
+//| El paso 2 de compilacion se lleva a cabo mediante la funcion proceso_paso_2(), las funciones  |
+//| agregar_dato_ram() y agregar_dato_prg() proveen mecanismos para agregar datos a los espacios  |
+//| de memoria que maneja JPU16 durante el paso 1 y la generacion de los datos de salida (codigo  |
+//| de maquina) se lleva a cabo en la funcion generar_salidas() de la etapa de salida.            |
+//|                                                                                               |
+//| Las actividades generadas en el paso 1 son las siguientes:                                    |
+//| - Analisis lexico - yylex() (leer el archivo de entrada y reconocer las palabras)             |
+//| - Analisis sintactico - yyparse (identificar el orden de las palabras y las estructuras que   |
+//|   forman, asociando significados a sus agrupaciones).                                         |
+//| - Identificacion de simbolos y creacion de la tabla de simbolos.                              |
+//| - Alojamiento de espacio en la memoria RAM y de programa e inicializacion de los datos.       |
+//| - Evaluacion de expresiones aritmeticas literales.                                            |
+//| - Evaluacion de expresiones simbolicas en aquellos casos donde los valores de los simbolos    |
+//|   son previamente conocidos                                                                   |
+//| - Identificacion de expresiones simbolicas en aquellos casos donde no se sabe el valor de     |
+//|   todos los simbolos con anterioridad, para ser postergadas al paso 2 mediante una cola de    |
+//|   acciones.                                                                                   |
+//|                                                                                               |
+//| Las actividades generadas en el paso 2 son las siguientes:                                    |
+//| - Realizacion de todas las actividades guardadas en la cola de acciones, las cuales indican   |
+//|   las operaciones postergadas del paso 1.                                                     |
+//| - Determinacion de los valores de los simbolos cuyo valor no era conocido en el paso 1,       |
+//|   mediante los datos registrados en la tabla de simbolos que ahora esta completa.             |
+//| - Calculo de expresiones aritmeticas mediante una pila de datos, usando notacion polaca       |
+//|   inversa.                                                                                    |
+//| - Almacenamiento de los resultados generados en la memoria RAM y de programa.                 |
+//|                                                                                               |
+//| Nota acerca de la reentrancia                                                                 |
+//| Tanto el analizador sintactico como el lexico son reentrantes (no usan variables globales),   |
+//| asi que cada contexto se puede ensamblar de forma independiente. El codigo fuente puede       |
+//| leerse de un archivo abierto (proceso_paso_1) o de un buffer en memoria                       |
+//| (proceso_paso_1_memoria), en cuyo caso el ensamblado no toca el sistema de archivos salvo     |
+//| que el codigo contenga directivas include.                                                    |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdbool.h>                   //Incluye la definicion del tipo de dato bool
+#include <math.h>                      //Permite invocar la funcion pow()
+#include <stdio.h>                     //Permite manejar archivos
+#include <stdlib.h>                    //Permite invocar malloc y free
+#include "j16asm_ensamblador.h"        //Cabecera propia
+#include "j16asm.h"                    //Importa el contexto de ensamblado
+#include "j16asm_dat_struct.h"         //Importa las estructuras de datos
+#include "j16asm_imagen_mem.h"         //Importa la imagen de las memorias de programa y RAM
+#include "j16asm_arena.h"              //Permite contar los alojamientos de memoria (-stats)
+#include "j16asm_fuentes.h"            //Permite registrar los archivos fuente
+#include "j16asm_optimizador.h"        //Permite registrar los usos de direcciones de programa
+#include "j16asm_recolector.h"         //Permite registrar los usos de direcciones (opcion -gc)
+#include "j16asm_macros.h"             //Permite desalojar la tabla de macros
+#include "j16asm_messages.h"           //Permite enviar mensajes al usuario
+
+//Dependencias externas (provistas por los modulos que generan bison y flex)
+extern int yyparse(CONTEXTO_ASM *ctx, void *escaner);     //Analizador sintactico
+extern int yylex_init_extra(CONTEXTO_ASM *ctx, void **escaner);  //Crea un analizador lexico
+extern int yylex_destroy(void *escaner);                  //Destruye un analizador lexico
+extern void yyset_in(FILE *fp_archivo, void *escaner);    //Indica el archivo de entrada
+extern struct yy_buffer_state *yy_scan_bytes(const char *codigo, int tam, void *escaner);
+
+//Declaracion previa de las funciones locales al modulo
+static int ejecutar_paso_1(CONTEXTO_ASM *ctx);
+static void cerrar_inclusiones(CONTEXTO_ASM *ctx);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion para crear un contexto de ensamblado con las capacidades de memoria indicadas
+CONTEXTO_ASM *crear_contexto(int tam_prg, int tam_ram) {
+  CONTEXTO_ASM *ctx = calloc(1, sizeof(CONTEXTO_ASM));
+
+  if (!ctx) return NULL;
+  ctx->tam_prg = tam_prg;
+  ctx->tam_ram = tam_ram;
+  reiniciar_contexto(ctx);
+  return ctx;
+}
+
+//Funcion para dejar un contexto listo para un nuevo ensamblado, liberando lo que haya quedado del
+//anterior (la configuracion se conserva)
+void reiniciar_contexto(CONTEXTO_ASM *ctx) {
+  const COLA_ACCIONES_PASO_2 cola_vacia = COLA_ACCIONES_VACIA;
+  const LISTA_SIMBOLOS lista_vacia = LISTA_SIMBOLOS_VACIA;
+  const REGISTRO_FUENTES registro_vacio = REGISTRO_FUENTES_VACIO;
+  const TABLA_MACROS tabla_vacia = TABLA_MACROS_VACIA;
+
+  cerrar_inclusiones(ctx);
+  desalojar_acciones(&ctx->cola_acciones);
+  desalojar_simbolos(&ctx->lista_simbolos);
+  desalojar_imagen(&ctx->imagen);
+  desalojar_fuentes(&ctx->registro_fuentes);
+  desalojar_info_optimizacion(&ctx->info_optimizacion);
+  reiniciar_info_recoleccion(&ctx->info_recoleccion);
+  reiniciar_info_listado(&ctx->info_listado);
+  desalojar_macros(&ctx->tabla_macros);
+  ctx->cola_acciones = cola_vacia;
+  ctx->lista_simbolos = lista_vacia;
+  ctx->registro_fuentes = registro_vacio;
+  ctx->tabla_macros = tabla_vacia;
+
+  ctx->pos_prg = 0;
+  ctx->pos_ram = 0;
+  ctx->seccion_actual = TS_PROG;
+  ctx->num_lin = 1;
+  ctx->fuente_actual = 0;
+  ctx->inclusion_terminada = false;
+  ctx->nivel_lexico = 0;
+  ctx->cuerpo_pendiente = false;
+  ctx->nivel_cuerpo = 0;
+  ctx->tam_cuerpo = 0;
+  ctx->inicio_sentencia = true;
+  ctx->etiqueta_posible = false;
+  ctx->escaner = NULL;
+}
+
+//Funcion para liberar un contexto junto con todo lo que contiene
+void destruir_contexto(CONTEXTO_ASM *ctx) {
+  if (!ctx) return;
+  reiniciar_contexto(ctx);              //Los inicializadores vacios no alojan memoria
+  desalojar_info_recoleccion(&ctx->info_recoleccion);
+  free(ctx);
+}
+
+//Funcion que implementa el paso 1 de compilacion leyendo el codigo de un archivo abierto (el
+//nombre del archivo debe estar en ctx->nombre_archivo_ent para los mensajes)
+bool proceso_paso_1(CONTEXTO_ASM *ctx, FILE *fp_archivo) {
+  if (yylex_init_extra(ctx, &ctx->escaner)) return false;
+  yyset_in(fp_archivo, ctx->escaner);
+  return ejecutar_paso_1(ctx) == 0;
+}
+
+//Funcion que implementa el paso 1 de compilacion leyendo el codigo de un buffer en memoria (el
+//buffer no necesita terminar en cero)
+bool proceso_paso_1_memoria(CONTEXTO_ASM *ctx, const char *codigo, size_t tam) {
+  if (yylex_init_extra(ctx, &ctx->escaner)) return false;
+  yy_scan_bytes(codigo, tam, ctx->escaner);
+  return ejecutar_paso_1(ctx) == 0;
+}
+
+//Funcion que implementa el paso 2 de compilacion
+bool proceso_paso_2(CONTEXTO_ASM *ctx) {
+  int *pila;                    //Pila de datos (arreglo dimensionado a la profundidad maxima)
+  int cima = 0;                 //Cantidad de datos en la pila
+  int valor;                    //Valor a almacenar en la memoria de programa o RAM
+  int valor_izquierda;          //Valor o argumento de mano izquierda
+  int valor_derecha;            //Valor o argumento de mano derecha
+  int valor_previo;             //Valor literal contenido previamente en la memoria de programa
+  int num_lin = 0;              //Numero de linea de la expresion actual (para reportar errores)
+  int fuente = 0;               //Archivo fuente de la expresion actual (para reportar errores)
+  bool usa_prg = false;         //Indica si la expresion actual usa una direccion de programa
+  int num_acciones;             //Cantidad de acciones en la cola
+  int profundidad_maxima;       //Maxima cantidad de datos que alcanza la pila
+  ACCION_PASO_2 *accion;        //Puntero a la accion actual de la cola
+  ACCION_PASO_2 *fin_acciones;  //Puntero a la posicion siguiente a la ultima accion
+
+  //Obtiene el arreglo de acciones, y aloja la pila de una sola vez con la profundidad necesaria
+  accion = obtener_acciones(&ctx->cola_acciones, &num_acciones, &profundidad_maxima);
+  fin_acciones = accion + num_acciones;
+  pila = malloc((profundidad_maxima + 1) * sizeof(int));
+  contar_alojamiento((profundidad_maxima + 1) * sizeof(int));
+
+  //El proceso del paso 2 recorre las acciones de la cola en orden, de forma lineal
+  for (; accion < fin_acciones; accion++) {
+    //Se realiza una accion diferente dependiendo del valor almacenado en la cola
+    switch (accion->tipo) {
+    case TPA_INICIO_EXPRESION:
+      num_lin = accion->num_lin;        //Cada expresion inicia con su numero de linea
+      fuente = accion->fuente;          //y el archivo donde aparece
+      usa_prg = false;
+      break;
+    case TPA_APILAR_LITERAL:
+      pila[cima++] = accion->valor;     //Para esta accion solo se apila el valor numerico
+      break;
+    case TPA_APILAR_SIMBOLO:
+      //La accion ya apunta a la entrada del simbolo, solo se verifica que haya sido declarado
+      if (!accion->simbolo->definido) {
+        //Si el simbolo nunca se declaro, se regresa un mensaje de error
+        seleccionar_fuente(ctx, fuente);
+        msg_simbolo_no_definido(ctx, num_lin, accion->simbolo->nombre);
+        free(pila);
+        return false;
+      }
+
+      //Se apila el valor equivalente del simbolo (se recuerda si es una direccion de programa,
+      //la cual el optimizador debe conocer si no es el destino de un salto)
+      pila[cima++] = accion->simbolo->valor;
+      if (accion->simbolo->reubicacion == REUB_PRG ||
+          accion->simbolo->reubicacion == REUB_INVALIDA)
+        usa_prg = true;
+      //Con la opcion -gc tambien se registra el uso de la direccion
+      registrar_uso_direccion(ctx, (VALOR_EXP) {accion->simbolo->valor,
+                                                accion->simbolo->reubicacion});
+      break;
+    case TPA_OPERACION_ARITMETICA:
+      //Primeramente se determina si la operacion indicada es de caracter unario o binario
+      if((accion->op & MASC_OPER) == OPER_NEG) {
+        //En caso de ser unaria, opera directamente sobre la cima de la pila
+        pila[cima-1] = -pila[cima-1];
+        break;
+      }
+      if((accion->op & MASC_OPER) == OPER_NOT) {
+        pila[cima-1] = ~pila[cima-1];
+        break;
+      }
+
+      //En caso de ser binaria, verifica si los argumentos deben ser intercambiados
+      cima--;
+      if (accion->op & OPER_INTERCAMBIO) {
+        valor_izquierda = pila[cima];
+        valor_derecha = pila[cima-1];
+      }
+      else {
+        valor_derecha = pila[cima];
+        valor_izquierda = pila[cima-1];
+      }
+
+      //Realiza la operacion segun lo indicado en la accion y guarda el resultado de regreso en la
+      //cima de la pila
+      switch (accion->op & MASC_OPER) {
+      case OPER_OR:  pila[cima-1] = valor_izquierda | valor_derecha;     break;
+      case OPER_XOR: pila[cima-1] = valor_izquierda ^ valor_derecha;     break;
+      case OPER_AND: pila[cima-1] = valor_izquierda & valor_derecha;     break;
+      case OPER_SHL: pila[cima-1] = valor_izquierda << valor_derecha;    break;
+      case OPER_SHR: pila[cima-1] = valor_izquierda >> valor_derecha;    break;
+      case OPER_SUM: pila[cima-1] = valor_izquierda + valor_derecha;     break;
+      case OPER_RES: pila[cima-1] = valor_izquierda - valor_derecha;     break;
+      case OPER_MUL: pila[cima-1] = valor_izquierda * valor_derecha;     break;
+      case OPER_DIV: pila[cima-1] = valor_izquierda / valor_derecha;     break;
+      case OPER_MOD: pila[cima-1] = valor_izquierda % valor_derecha;     break;
+      case OPER_EXP: pila[cima-1] = pow(valor_izquierda, valor_derecha); break;
+      default: break;
+      }
+
+      break;
+    case TPA_GUARDAR_RESULTADO_RAM:
+      //Para este caso se desapila el valor del tope de la pila (que deberia tener un resultado) y
+      //se guarda en el espacio de la memoria RAM
+      valor = pila[--cima];
+      escribir_dato_ram(&ctx->imagen, accion->direccion, valor & 0xFFFF);
+      if (usa_prg) registrar_referencia_prg(ctx, fuente, num_lin);
+      ubicar_usos_direccion(ctx, TS_DATOS, accion->direccion, false);
+      break;
+    case TPA_GUARDAR_RESULTADO_PRG:
+      //Para este caso se desapila el valor del tope de la pila (que deberia tener un resultado) y
+      //se guarda en el espacio de la memoria de programa
+      valor = pila[--cima];
+      valor_previo = leer_dato_prg(&ctx->imagen, accion->direccion);  //Opcode completo
+      if (usa_prg && !ES_SALTO_DIRECTO(valor_previo))
+        registrar_referencia_prg(ctx, fuente, num_lin);
+      ubicar_usos_direccion(ctx, TS_PROG, accion->direccion, ES_SALTO_DIRECTO(valor_previo));
+      escribir_dato_prg(&ctx->imagen, accion->direccion,             //Se suplanta el literal
+                        (valor_previo & ~0xFFFF) | ((valor + valor_previo) & 0xFFFF));
+      //Nota: Se hace la suma del resultado de la pila mas el valor que existia como literal del
+      //opcode (usualmente 0x0000) asi que el valor final es normalmente el mismo valor del
+      //resultado. Sin embargo, en saltos relativos este valor no es necesariamente cero (se trata
+      //de la misma direccion donde se encuentra el salto con signo negativo), de manera que al
+      //sumar, se obtiene automaticamente el offset del salto.
+      break;
+    }
+  }
+  free(pila);
+
+  return true;
+}
+
+//Funcion para agregar y reservar un dato en la memoria RAM
+bool agregar_dato_ram(CONTEXTO_ASM *ctx, int dato, int num_lin) {
+  //Primeramente determina si la direccion actual excede el limite de la memoria disponible
+  if (ctx->pos_ram >= ctx->tam_ram) {
+    //De exceder el limite, regresa con mensaje de error
+    msg_fin_ram(ctx, num_lin);
+    return false;
+  }
+
+  //Luego determina si la localidad esta libre
+  if (localidad_ram_ocupada(&ctx->imagen, ctx->pos_ram)) {
+    //De no estar libre, regresa con mensaje de error
+    msg_colision_ram(ctx, num_lin, ctx->pos_ram);
+    return false;
+  }
+
+  //Si todo esta bien, guarda el dato en la memoria RAM y desmarca la localidad como disponible
+  escribir_dato_ram(&ctx->imagen, ctx->pos_ram, dato & 0xFFFF);
+  ctx->pos_ram++;               //Apunta a la siguiente posicion de la memoria
+  return true;
+}
+
+//Funcion para agregar y reservar un dato en la memoria de programa
+bool agregar_dato_prg(CONTEXTO_ASM *ctx, int dato, int num_lin) {
+  //Primeramente determina si la direccion actual excede el limite de la memoria disponible
+  if (ctx->pos_prg >= ctx->tam_prg) {
+    //De exceder el limite, regresa con mensaje de error
+    msg_fin_prg(ctx, num_lin);
+    return false;
+  }
+
+  //Luego determina si la localidad esta libre
+  if (localidad_prg_ocupada(&ctx->imagen, ctx->pos_prg)) {
+    //De no estar libre, regresa con mensaje de error
+    msg_colision_prg(ctx, num_lin, ctx->pos_prg);
+    return false;
+  }
+
+  //Si todo esta bien, guarda el dato en la memoria de programa y desmarca la localidad como
+  //disponible
+  escribir_dato_prg(&ctx->imagen, ctx->pos_prg, dato);
+  ctx->pos_prg++;               //Apunta a la siguiente posicion de la memoria
+  return true;
+}
+
+//Funcion que ejecuta el analizador sintactico con el analizador lexico ya preparado, y libera este
+//ultimo al terminar (incluso si el analisis se aborta dentro de un archivo incluido)
+static int ejecutar_paso_1(CONTEXTO_ASM *ctx) {
+  int valor_retorno;
+
+  registrar_fuente(&ctx->registro_fuentes, ctx->nombre_archivo_ent);  //La entrada es el fuente 0
+  valor_retorno = yyparse(ctx, ctx->escaner);
+  cerrar_inclusiones(ctx);
+  yylex_destroy(ctx->escaner);
+  ctx->escaner = NULL;
+  return valor_retorno;
+}
+
+//Funcion para cerrar los archivos incluidos que hayan quedado abiertos (las expansiones de macros
+//y repeticiones no tienen archivo)
+static void cerrar_inclusiones(CONTEXTO_ASM *ctx) {
+  INCLUSION *inclusion;
+
+  while (ctx->nivel_inclusion) {
+    inclusion = &ctx->pila_inclusion[--ctx->nivel_inclusion];
+    if (inclusion->fp) fclose(inclusion->fp);
+  }
+}
@@ -0,0 +1,26 @@
+#ifndef j16asm_ensamblador_h_Incluida
+#define j16asm_ensamblador_h_Incluida
+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stddef.h>                     //Incluye la definicion del tipo de dato size_t
+#include <stdio.h>                      //Incluye la definicion del tipo de dato FILE
+#include "j16asm.h"                     //Incluye la definicion del contexto de ensamblado
+
+//Funciones exportadas
+//--------------------
+//Funciones para crear, reutilizar y liberar contextos
+extern CONTEXTO_ASM *crear_contexto(int tam_prg, int tam_ram);
+extern void reiniciar_contexto(CONTEXTO_ASM *ctx);
+extern void destruir_contexto(CONTEXTO_ASM *ctx);
+
+//Funciones que implementan los pasos del ensamblador (el paso 2 tambien lo invoca el enlazador
+//para cada objeto)
+extern bool proceso_paso_1(CONTEXTO_ASM *ctx, FILE *fp_archivo);
+extern bool proceso_paso_1_memoria(CONTEXTO_ASM *ctx, const char *codigo, size_t tam);
+extern bool proceso_paso_2(CONTEXTO_ASM *ctx);
+
+//Funciones para agregar datos a la memoria RAM y de programa
+extern bool agregar_dato_ram(CONTEXTO_ASM *ctx, int dato, int num_lin);
+extern bool agregar_dato_prg(CONTEXTO_ASM *ctx, int dato, int num_lin);
+
+#endif //j16asm_ensamblador_h_Incluida
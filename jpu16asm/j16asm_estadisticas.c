@@ -0,0 +1,159 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_estadisticas.c                                                                         |
+//| Modulo de medicion del ensamblado                                                             |
+//|                                                                                               |
+//| Este modulo provee las mediciones de la opcion -stats: el tiempo de reloj y los alojamientos  |
+//| de memoria de cada etapa del ensamblado (paso 1, paso 2, enlace, -gc, -O, -prof y -lst) y de  |
+//| cada formato de salida, junto con la cantidad de simbolos, la mayor longitud de la cola de    |
+//| acciones, la mayor profundidad de la pila del paso 2 y los bytes escritos en cada salida. El  |
+//| reporte se muestra en pantalla (ver j16asm_messages) y, si se pide, se escribe tambien en     |
+//| formato JSON.                                                                                 |
+//| Los alojamientos se cuentan en los puntos donde los modulos del ensamblador piden memoria     |
+//| (arenas, cola de acciones, tabla de simbolos, imagen de memoria, buffers de salida, etc.)     |
+//| mediante contar_alojamiento() (ver j16asm_arena.c). La cuenta es propia de cada hilo, de      |
+//| manera que los ensamblados en paralelo no se mezclan.                                         |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdio.h>                      //Permite manejar archivos
+#include <time.h>                       //Permite medir el tiempo transcurrido
+#include "j16asm_estadisticas.h"        //Cabecera propia
+#include "j16asm.h"                     //Importa el contexto de ensamblado
+#include "j16asm_arena.h"               //Permite obtener los alojamientos del hilo
+#include "j16asm_messages.h"            //Permite generar mensajes de error
+
+//Nombre de cada etapa (en el orden de ETAPA_MEDIDA)
+static const char *const nombres_etapas[NUM_ETAPAS_MEDIDAS] = {
+  "paso_1", "paso_2", "enlace", "recoleccion", "optimizacion", "disposicion", "listado"
+};
+
+//Declaracion previa de las funciones locales al modulo
+static void acumular(MEDICION *medicion, MARCA_MEDICION *marca);
+static void escribir_medicion(FILE *fp_archivo, const MEDICION *medicion);
+static void escribir_cadena_json(FILE *fp_archivo, const char *cadena);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion que toma la marca desde la cual se mide la siguiente etapa
+void tomar_marca(CONTEXTO_ASM *ctx, MARCA_MEDICION *marca) {
+  if (!ctx->estadisticas) return;
+  clock_gettime(CLOCK_MONOTONIC, &marca->tiempo);
+  obtener_alojamientos(&marca->alojamientos, &marca->bytes_alojados);
+}
+
+//Funcion que suma a una etapa lo transcurrido desde la marca
+void medir_etapa(CONTEXTO_ASM *ctx, ETAPA_MEDIDA etapa, MARCA_MEDICION *marca) {
+  if (!ctx->estadisticas) return;
+  acumular(&ctx->estadisticas->etapas[etapa], marca);
+}
+
+//Funcion que suma a un formato de salida lo transcurrido desde la marca, la cual se renueva para
+//medir el siguiente formato
+void medir_salida(CONTEXTO_ASM *ctx, int indice, MARCA_MEDICION *marca) {
+  if (!ctx->estadisticas) return;
+  acumular(&ctx->estadisticas->salidas[indice], marca);
+  tomar_marca(ctx, marca);
+}
+
+//Funcion que registra el tamaño de las estructuras del ensamblado (se invoca al terminar el paso
+//1, cuando la cola de acciones y la lista de simbolos estan completas)
+void medir_estructuras(CONTEXTO_ASM *ctx) {
+  ESTADISTICAS_ENSAMBLADO *estadisticas = ctx->estadisticas;
+
+  if (!estadisticas) return;
+  if (ctx->lista_simbolos.cantidad > estadisticas->simbolos)
+    estadisticas->simbolos = ctx->lista_simbolos.cantidad;
+  if (ctx->cola_acciones.cantidad > estadisticas->max_acciones)
+    estadisticas->max_acciones = ctx->cola_acciones.cantidad;
+  if (ctx->cola_acciones.profundidad_maxima > estadisticas->max_pila)
+    estadisticas->max_pila = ctx->cola_acciones.profundidad_maxima;
+}
+
+//Funcion que obtiene el nombre de una etapa
+const char *nombre_etapa(ETAPA_MEDIDA etapa) {
+  return nombres_etapas[etapa];
+}
+
+//Funcion que escribe las mediciones en formato JSON
+bool escribir_estadisticas_json(CONTEXTO_ASM *ctx, const char *nombre) {
+  const ESTADISTICAS_ENSAMBLADO *estadisticas = ctx->estadisticas;
+  unsigned long long bytes_salida = 0;
+  FILE *fp_archivo;
+  bool primero = true;
+  int i;
+
+  fp_archivo = fopen(nombre, "w");
+  if (!fp_archivo) {
+    msg_error_crear_archivo_salida(ctx, nombre);
+    return false;
+  }
+
+  fprintf(fp_archivo, "{\n  \"archivo\": ");
+  escribir_cadena_json(fp_archivo, ctx->nombre_archivo_ent);
+  fprintf(fp_archivo, ",\n  \"etapas\": {");
+  for (i=0; i<NUM_ETAPAS_MEDIDAS; i++) {
+    if (!estadisticas->etapas[i].realizada) continue;
+    fprintf(fp_archivo, "%s\n    \"%s\": ", primero ? "" : ",", nombres_etapas[i]);
+    escribir_medicion(fp_archivo, &estadisticas->etapas[i]);
+    primero = false;
+  }
+  fprintf(fp_archivo, "\n  },\n  \"salidas\": [");
+  for (i=0; i<estadisticas->num_salidas; i++) {
+    fprintf(fp_archivo, "%s\n    {\"archivo\": ", i ? "," : "");
+    escribir_cadena_json(fp_archivo, estadisticas->nombres_salidas[i]);
+    fprintf(fp_archivo, ", \"bytes\": %llu, \"medicion\": ", estadisticas->bytes_salidas[i]);
+    escribir_medicion(fp_archivo, &estadisticas->salidas[i]);
+    fprintf(fp_archivo, "}");
+    bytes_salida += estadisticas->bytes_salidas[i];
+  }
+  fprintf(fp_archivo,
+          "\n  ],\n"
+          "  \"simbolos\": %u,\n"
+          "  \"max_acciones\": %i,\n"
+          "  \"max_pila\": %i,\n"
+          "  \"bytes_salida\": %llu\n"
+          "}\n",
+          estadisticas->simbolos, estadisticas->max_acciones, estadisticas->max_pila,
+          bytes_salida);
+
+  if (ferror(fp_archivo) | fclose(fp_archivo)) {
+    msg_error_escribir_archivo_salida(ctx, nombre);
+    return false;
+  }
+  return true;
+}
+
+//Funcion que suma a una medicion lo transcurrido desde la marca
+static void acumular(MEDICION *medicion, MARCA_MEDICION *marca) {
+  struct timespec ahora;
+  unsigned long alojamientos;
+  unsigned long long bytes;
+
+  clock_gettime(CLOCK_MONOTONIC, &ahora);
+  obtener_alojamientos(&alojamientos, &bytes);
+  medicion->realizada = true;
+  medicion->segundos += (ahora.tv_sec - marca->tiempo.tv_sec) +
+                        (ahora.tv_nsec - marca->tiempo.tv_nsec) / 1e9;
+  medicion->alojamientos += alojamientos - marca->alojamientos;
+  medicion->bytes_alojados += bytes - marca->bytes_alojados;
+}
+
+//Funcion que escribe una medicion como objeto JSON
+static void escribir_medicion(FILE *fp_archivo, const MEDICION *medicion) {
+  fprintf(fp_archivo, "{\"segundos\": %.6f, \"alojamientos\": %lu, \"bytes_alojados\": %llu}",
+          medicion->segundos, medicion->alojamientos, medicion->bytes_alojados);
+}
+
+//Funcion que escribe una cadena JSON (entre comillas y con los caracteres especiales escapados)
+static void escribir_cadena_json(FILE *fp_archivo, const char *cadena) {
+  fputc('"', fp_archivo);
+  for (; *cadena; cadena++) {
+    if (*cadena == '"' || *cadena == '\\')
+      fprintf(fp_archivo, "\\%c", *cadena);
+    else if ((unsigned char) *cadena < 0x20)
+      fprintf(fp_archivo, "\\u%.4X", (unsigned char) *cadena);
+    else
+      fputc(*cadena, fp_archivo);
+  }
+  fputc('"', fp_archivo);
+}
@@ -0,0 +1,63 @@
+#ifndef j16asm_estadisticas_h_Incluida
+#define j16asm_estadisticas_h_Incluida
+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <time.h>                       //Incluye la definicion de struct timespec
+#include "j16asm.h"                     //Incluye la definicion del contexto de ensamblado
+#include "j16asm_opciones.h"            //Incluye la cantidad maxima de formatos de salida
+
+//Tipos de datos exportados
+//-------------------------
+//Etapas del ensamblado que se miden
+typedef enum _ETAPA_MEDIDA {
+  EM_PASO_1,                            //Analisis lexico y sintactico (yyparse)
+  EM_PASO_2,                            //Aplicacion de la cola de acciones
+  EM_ENLACE,                            //Enlace de objetos
+  EM_RECOLECCION,                       //Eliminacion de lo inalcanzable (-gc)
+  EM_OPTIMIZACION,                      //Optimizacion de la memoria de programa (-O)
+  EM_DISPOSICION,                       //Disposicion del codigo segun un perfil (-prof)
+  EM_LISTADO,                           //Generacion del listado (-lst)
+  NUM_ETAPAS_MEDIDAS                    //Cantidad de etapas (no es una etapa)
+} ETAPA_MEDIDA;
+
+//Tiempo y memoria que consumio una etapa
+typedef struct _MEDICION {
+  bool realizada;                       //Indica si la etapa se llevo a cabo
+  double segundos;                      //Tiempo transcurrido (de reloj)
+  unsigned long alojamientos;           //Cantidad de alojamientos de memoria
+  unsigned long long bytes_alojados;    //Cantidad de bytes pedidos en esos alojamientos
+} MEDICION;
+
+//Punto de partida de una medicion
+typedef struct _MARCA_MEDICION {
+  struct timespec tiempo;               //Momento en que se tomo la marca
+  unsigned long alojamientos;           //Alojamientos del hilo hasta ese momento
+  unsigned long long bytes_alojados;    //Bytes alojados por el hilo hasta ese momento
+} MARCA_MEDICION;
+
+//Estructura con las mediciones de un ensamblado (opcion -stats). Las salidas se miden por
+//separado aunque se generen en una sola pasada
+typedef struct _ESTADISTICAS_ENSAMBLADO {
+  MEDICION etapas[NUM_ETAPAS_MEDIDAS];  //Medicion de cada etapa
+  MEDICION salidas[MAX_SALIDAS];        //Medicion de cada formato de salida
+  const char *nombres_salidas[MAX_SALIDAS];  //Archivo de cada formato de salida
+  unsigned long long bytes_salidas[MAX_SALIDAS];  //Bytes escritos en cada archivo de salida
+  int num_salidas;                      //Cantidad de formatos de salida generados
+  unsigned int simbolos;                //Cantidad de simbolos del programa
+  int max_acciones;                     //Mayor longitud de la cola de acciones
+  int max_pila;                         //Mayor profundidad de la pila del paso 2
+} ESTADISTICAS_ENSAMBLADO;
+
+//Funciones exportadas
+//--------------------
+//Funciones para medir las etapas (no hacen nada si el contexto no tiene estadisticas)
+extern void tomar_marca(CONTEXTO_ASM *ctx, MARCA_MEDICION *marca);
+extern void medir_etapa(CONTEXTO_ASM *ctx, ETAPA_MEDIDA etapa, MARCA_MEDICION *marca);
+extern void medir_salida(CONTEXTO_ASM *ctx, int indice, MARCA_MEDICION *marca);
+extern void medir_estructuras(CONTEXTO_ASM *ctx);
+
+//Funciones para reportar las mediciones
+extern const char *nombre_etapa(ETAPA_MEDIDA etapa);
+extern bool escribir_estadisticas_json(CONTEXTO_ASM *ctx, const char *nombre);
+
+#endif //j16asm_estadisticas_h_Incluida
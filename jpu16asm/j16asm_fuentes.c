@@ -0,0 +1,140 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_fuentes.c                                                                              |
+//| Modulo de registro de archivos fuente                                                         |
+//|                                                                                               |
+//| Un programa puede repartirse en varios archivos mediante la directiva include. Este modulo    |
+//| lleva el registro de todos los archivos fuente que intervienen en el ensamblado, asignando a  |
+//| cada uno un indice (el archivo de entrada es siempre el 0). Las expresiones postergadas al    |
+//| paso 2 guardan el indice del archivo donde aparecen junto con su numero de linea, de manera   |
+//| que los errores se reporten sobre el archivo correcto. El mismo registro sirve para generar   |
+//| el archivo de dependencias (opcion -MD), el cual permite que make vuelva a ensamblar solo     |
+//| cuando alguno de los archivos incluidos cambia. Cada contexto de ensamblado tiene su propio   |
+//| registro. Los archivos de datos (directivas incbin e inchex) se registran igual, ya que el    |
+//| resultado tambien depende de ellos.                                                           |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdio.h>                      //Permite manejar archivos
+#include <stdlib.h>                     //Permite invocar realloc
+#include <string.h>                     //Permite manejar cadenas
+#include "j16asm_fuentes.h"             //Cabecera propia
+#include "j16asm.h"                     //Importa el contexto de ensamblado
+#include "j16asm_arena.h"               //Permite alojar memoria en arenas
+#include "j16asm_messages.h"            //Permite enviar mensajes al usuario
+
+//Declaracion previa de las funciones locales al modulo
+static void escribir_nombre_make(FILE *fp_archivo, const char *nombre);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion para registrar un archivo fuente y obtener su indice (un archivo que se incluye varias
+//veces conserva el indice de la primera vez)
+int registrar_fuente(REGISTRO_FUENTES *registro, const char *nombre) {
+  int i;
+
+  for (i=0; i<registro->cantidad; i++)
+    if (strcmp(registro->nombres[i], nombre) == 0) return i;
+
+  if (registro->cantidad == registro->capacidad) {
+    registro->capacidad = registro->capacidad ? registro->capacidad * 2 : 8;
+    registro->nombres = realloc(registro->nombres, registro->capacidad * sizeof(const char *));
+    contar_alojamiento(registro->capacidad * sizeof(const char *));
+  }
+  registro->nombres[registro->cantidad] = arena_duplicar_cadena(&registro->arena, nombre);
+  return registro->cantidad++;
+}
+
+//Funcion para obtener el arreglo con los nombres de todos los archivos registrados
+const char **obtener_fuentes(REGISTRO_FUENTES *registro, int *cantidad) {
+  *cantidad = registro->cantidad;
+  return registro->nombres;
+}
+
+//Funcion para desalojar de una sola vez el registro
+void desalojar_fuentes(REGISTRO_FUENTES *registro) {
+  free(registro->nombres);
+  arena_liberar(&registro->arena);
+  registro->nombres = NULL;
+  registro->cantidad = 0;
+  registro->capacidad = 0;
+}
+
+//Funcion para abrir un archivo nombrado en una directiva (include, incbin o inchex). El nombre se
+//busca primero en el directorio del archivo que contiene la directiva y luego tal cual (relativo
+//al directorio de trabajo). La ruta con la que se abrio queda en ruta; una ruta que no cabe no
+//se intenta abrir (recortada podria abrir otro archivo y registrarse mal para -MD y -watch)
+FILE *abrir_fuente(CONTEXTO_ASM *ctx, const char *nombre, const char *modo, char *ruta,
+                   size_t tam_ruta) {
+  const char *separador;
+  FILE *fp_archivo = NULL;
+
+  separador = strrchr(ctx->nombre_archivo_ent, '/');
+  if (nombre[0] != '/' && separador &&
+      snprintf(ruta, tam_ruta, "%.*s/%s", (int) (separador - ctx->nombre_archivo_ent),
+               ctx->nombre_archivo_ent, nombre) < (int) tam_ruta)
+    fp_archivo = fopen(ruta, modo);
+  if (!fp_archivo && snprintf(ruta, tam_ruta, "%s", nombre) < (int) tam_ruta)
+    fp_archivo = fopen(ruta, modo);
+  return fp_archivo;
+}
+
+//Funcion para indicar el archivo sobre el cual se reportan los mensajes a partir de este momento
+void seleccionar_fuente(CONTEXTO_ASM *ctx, int indice) {
+  if (indice < 0 || indice >= ctx->registro_fuentes.cantidad) return;
+  snprintf(ctx->nombre_archivo_ent, sizeof(ctx->nombre_archivo_ent), "%s",
+           ctx->registro_fuentes.nombres[indice]);
+}
+
+//Funcion para escribir un archivo de dependencias en la sintaxis de make. Ademas de la regla que
+//hace depender los objetivos de sus requisitos, se agrega una regla vacia por cada requisito
+//(excepto el primero), de manera que make no falle si un archivo incluido deja de existir
+bool escribir_dependencias(CONTEXTO_ASM *ctx, const char *nombre,
+                           const char *objetivos[], int num_objetivos,
+                           const char *requisitos[], int num_requisitos) {
+  FILE *fp_archivo;
+  int i;
+
+  fp_archivo = fopen(nombre, "w");
+  if (!fp_archivo) {
+    msg_error_crear_archivo_salida(ctx, nombre);
+    return false;
+  }
+
+  //Sin objetivos no hay regla que escribir (el archivo queda vacio)
+  if (num_objetivos) {
+    for (i=0; i<num_objetivos; i++) {
+      if (i) fputc(' ', fp_archivo);
+      escribir_nombre_make(fp_archivo, objetivos[i]);
+    }
+    fputc(':', fp_archivo);
+    for (i=0; i<num_requisitos; i++) {
+      fputs(" \\\n ", fp_archivo);
+      escribir_nombre_make(fp_archivo, requisitos[i]);
+    }
+    fputc('\n', fp_archivo);
+
+    for (i=1; i<num_requisitos; i++) {
+      fputc('\n', fp_archivo);
+      escribir_nombre_make(fp_archivo, requisitos[i]);
+      fputs(":\n", fp_archivo);
+    }
+  }
+
+  if (ferror(fp_archivo) | fclose(fp_archivo)) {
+    msg_error_escribir_archivo_salida(ctx, nombre);
+    return false;
+  }
+  return true;
+}
+
+//Funcion para escribir un nombre de archivo escapando los caracteres especiales para make
+static void escribir_nombre_make(FILE *fp_archivo, const char *nombre) {
+  for (; *nombre; nombre++) {
+    switch (*nombre) {
+    case ' ':
+    case '#': fputc('\\', fp_archivo); break;  //Espacios y comentarios llevan barra invertida
+    case '$': fputc('$', fp_archivo);  break;  //Los signos de dolar se duplican
+    }
+    fputc(*nombre, fp_archivo);
+  }
+}
@@ -0,0 +1,39 @@
+#ifndef j16asm_fuentes_h_Incluida
+#define j16asm_fuentes_h_Incluida
+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdio.h>                      //Incluye la definicion del tipo de dato FILE
+#include "j16asm_arena.h"               //Incluye la definicion de las arenas de memoria
+
+//Tipos de datos exportados
+//-------------------------
+//Estructura con el registro de los archivos fuente
+typedef struct _REGISTRO_FUENTES {
+  const char **nombres;                 //Nombres de los archivos (en orden de registro)
+  int cantidad;                         //Cantidad de archivos registrados
+  int capacidad;                        //Cantidad de nombres que caben en el arreglo actual
+  ARENA arena;                          //Arena donde se copian los nombres
+} REGISTRO_FUENTES;
+
+//Inicializador del registro vacio
+#define REGISTRO_FUENTES_VACIO { NULL, 0, 0, ARENA_VACIA(1024) }
+
+//Declaracion previa del contexto de ensamblado (definido en j16asm.h)
+struct _CONTEXTO_ASM;
+
+//Funciones exportadas
+//--------------------
+//Funciones asociadas al registro de archivos fuente
+extern int registrar_fuente(REGISTRO_FUENTES *registro, const char *nombre);
+extern const char **obtener_fuentes(REGISTRO_FUENTES *registro, int *cantidad);
+extern void desalojar_fuentes(REGISTRO_FUENTES *registro);
+extern void seleccionar_fuente(struct _CONTEXTO_ASM *ctx, int indice);
+extern FILE *abrir_fuente(struct _CONTEXTO_ASM *ctx, const char *nombre, const char *modo,
+                          char *ruta, size_t tam_ruta);
+
+//Funcion para generar el archivo de dependencias para make
+extern bool escribir_dependencias(struct _CONTEXTO_ASM *ctx, const char *nombre,
+                                  const char *objetivos[], int num_objetivos,
+                                  const char *requisitos[], int num_requisitos);
+
+#endif //j16asm_fuentes_h_Incluida
@@ -0,0 +1,295 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_imagen_mem.c                                                                           |
+//| Modulo con la imagen de las memorias de programa y RAM de JPU16                               |
+//|                                                                                               |
+//| Este modulo guarda los datos que genera el ensamblador para cada espacio de memoria. Cada     |
+//| espacio se divide en paginas de tamaño fijo que solo se alojan cuando se escribe en ellas por |
+//| primera vez, de manera que las regiones sin usar no ocupan memoria ni tiempo de proceso. Las  |
+//| instrucciones de programa se guardan en palabras de 32 bits (de las cuales se usan 26) y los  |
+//| datos de RAM en palabras de 16 bits. Junto con los datos, cada pagina lleva un mapa de bits   |
+//| que indica cuales localidades estan ocupadas, lo cual permite contarlas mediante conteo de    |
+//| bits (popcount) y ubicar rapidamente la siguiente localidad ocupada.                          |
+//| Las localidades libres siempre contienen cero, por lo que pueden leerse sin verificar antes   |
+//| si estan ocupadas.                                                                            |
+//| Cada contexto de ensamblado tiene su propia imagen, por lo que todas las funciones reciben la |
+//| imagen sobre la cual operan.                                                                  |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdlib.h>                     //Permite invocar malloc, calloc y free
+#include <string.h>                     //Permite invocar memcpy y memset
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include "j16asm_imagen_mem.h"          //Cabecera propia
+#include "j16asm_arena.h"               //Permite contar los alojamientos de memoria (-stats)
+
+//Declaracion previa de las funciones locales al modulo
+static int buscar_en_mapa(const uint64_t *ocupacion, int posicion);
+static int ultimo_en_mapa(const uint64_t *ocupacion);
+static int contar_mapa(const uint64_t *ocupacion);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion que ubica el primer bit activo de un mapa de ocupacion a partir de una posicion dada
+//(retorna -1 si ya no hay localidades ocupadas en la pagina)
+static int buscar_en_mapa(const uint64_t *ocupacion, int posicion) {
+  int i = posicion >> 6;
+  uint64_t bits;
+
+  //Descarta los bits que estan antes de la posicion de inicio en la primera palabra del mapa
+  bits = ocupacion[i] & (~(uint64_t) 0 << (posicion & 63));
+  while (1) {
+    if (bits) return (i << 6) + __builtin_ctzll(bits);
+    if (++i >= PALABRAS_MAPA) return -1;
+    bits = ocupacion[i];
+  }
+}
+
+//Funcion que ubica el ultimo bit activo de un mapa de ocupacion (retorna -1 si la pagina no tiene
+//localidades ocupadas)
+static int ultimo_en_mapa(const uint64_t *ocupacion) {
+  int i;
+
+  for (i=PALABRAS_MAPA-1; i>=0; i--)
+    if (ocupacion[i]) return (i << 6) + 63 - __builtin_clzll(ocupacion[i]);
+
+  return -1;
+}
+
+//Funcion que cuenta la cantidad de localidades ocupadas de una pagina
+static int contar_mapa(const uint64_t *ocupacion) {
+  int i;
+  int conteo = 0;
+
+  for (i=0; i<PALABRAS_MAPA; i++)
+    conteo += __builtin_popcountll(ocupacion[i]);
+
+  return conteo;
+}
+
+//+------------------------------------------------+
+//| Operaciones asociadas a la memoria de programa |
+//+------------------------------------------------+-----------------------------------------------
+//Funcion para leer una localidad de la memoria de programa (las localidades libres leen cero)
+uint32_t leer_dato_prg(const IMAGEN_MEM *imagen, int direccion) {
+  PAGINA_PRG *pagina = imagen->paginas_prg[direccion >> BITS_PAGINA];
+
+  return pagina ? pagina->datos[direccion & MASC_PAGINA] : 0;
+}
+
+//Funcion para escribir una localidad de la memoria de programa (la marca como ocupada)
+void escribir_dato_prg(IMAGEN_MEM *imagen, int direccion, uint32_t dato) {
+  PAGINA_PRG **pagina = &imagen->paginas_prg[direccion >> BITS_PAGINA];
+  int posicion = direccion & MASC_PAGINA;
+
+  //Aloja la pagina (con todas sus localidades libres y en cero) la primera vez que se usa
+  if (!*pagina) {
+    *pagina = calloc(1, sizeof(PAGINA_PRG));
+    contar_alojamiento(sizeof(PAGINA_PRG));
+  }
+
+  (*pagina)->datos[posicion] = dato & MASC_DATO_PRG;
+  (*pagina)->ocupacion[posicion >> 6] |= (uint64_t) 1 << (posicion & 63);
+}
+
+//Funcion para determinar si una localidad de la memoria de programa esta ocupada
+bool localidad_prg_ocupada(const IMAGEN_MEM *imagen, int direccion) {
+  PAGINA_PRG *pagina = imagen->paginas_prg[direccion >> BITS_PAGINA];
+  int posicion = direccion & MASC_PAGINA;
+
+  return pagina && (pagina->ocupacion[posicion >> 6] >> (posicion & 63) & 1);
+}
+
+//Funcion para ubicar la primera localidad ocupada de la memoria de programa a partir de una
+//direccion dada (retorna -1 si no hay mas localidades ocupadas)
+int siguiente_localidad_prg(const IMAGEN_MEM *imagen, int direccion) {
+  int posicion;
+
+  //Recorre las paginas, saltando directamente aquellas que nunca se usaron
+  for (; direccion < TAM_ESPACIO_MEM; direccion = (direccion | MASC_PAGINA) + 1) {
+    if (!imagen->paginas_prg[direccion >> BITS_PAGINA]) continue;
+    posicion = buscar_en_mapa(imagen->paginas_prg[direccion >> BITS_PAGINA]->ocupacion,
+                              direccion & MASC_PAGINA);
+    if (posicion >= 0) return (direccion & ~MASC_PAGINA) | posicion;
+  }
+
+  return -1;
+}
+
+//Funcion para ubicar la ultima localidad ocupada de la memoria de programa (retorna -1 si no hay
+//localidades ocupadas)
+int ultima_localidad_prg(const IMAGEN_MEM *imagen) {
+  int i, posicion;
+
+  //Recorre las paginas desde la ultima, saltando aquellas que nunca se usaron
+  for (i=NUM_PAGINAS-1; i>=0; i--) {
+    if (!imagen->paginas_prg[i]) continue;
+    posicion = ultimo_en_mapa(imagen->paginas_prg[i]->ocupacion);
+    if (posicion >= 0) return (i << BITS_PAGINA) | posicion;
+  }
+
+  return -1;
+}
+
+//Funcion para contar la cantidad de localidades ocupadas de la memoria de programa
+int contar_localidades_prg(const IMAGEN_MEM *imagen) {
+  int i;
+  int conteo = 0;
+
+  for (i=0; i<NUM_PAGINAS; i++)
+    if (imagen->paginas_prg[i]) conteo += contar_mapa(imagen->paginas_prg[i]->ocupacion);
+
+  return conteo;
+}
+
+//Funcion para copiar un bloque de la memoria de programa junto con su mapa de ocupacion (la
+//direccion y la cantidad deben ser multiplos del tamaño de pagina; las paginas sin usar se
+//copian como localidades libres en cero)
+void leer_bloque_prg(const IMAGEN_MEM *imagen, int direccion, int cantidad,
+                     uint32_t *datos, uint64_t *ocupacion) {
+  PAGINA_PRG *pagina;
+  int i;
+
+  for (i=0; i<cantidad; i+=TAM_PAGINA) {
+    pagina = imagen->paginas_prg[(direccion + i) >> BITS_PAGINA];
+    if (pagina) {
+      memcpy(&datos[i], pagina->datos, sizeof(pagina->datos));
+      memcpy(&ocupacion[i >> 6], pagina->ocupacion, sizeof(pagina->ocupacion));
+    } else {
+      memset(&datos[i], 0, sizeof(pagina->datos));
+      memset(&ocupacion[i >> 6], 0, sizeof(pagina->ocupacion));
+    }
+  }
+}
+
+//+----------------------------------------+
+//| Operaciones asociadas a la memoria RAM |
+//+----------------------------------------+-------------------------------------------------------
+//Funcion para leer una localidad de la memoria RAM (las localidades libres leen cero)
+uint16_t leer_dato_ram(const IMAGEN_MEM *imagen, int direccion) {
+  PAGINA_RAM *pagina = imagen->paginas_ram[direccion >> BITS_PAGINA];
+
+  return pagina ? pagina->datos[direccion & MASC_PAGINA] : 0;
+}
+
+//Funcion para escribir una localidad de la memoria RAM (la marca como ocupada)
+void escribir_dato_ram(IMAGEN_MEM *imagen, int direccion, uint16_t dato) {
+  PAGINA_RAM **pagina = &imagen->paginas_ram[direccion >> BITS_PAGINA];
+  int posicion = direccion & MASC_PAGINA;
+
+  if (!*pagina) {
+    *pagina = calloc(1, sizeof(PAGINA_RAM));
+    contar_alojamiento(sizeof(PAGINA_RAM));
+  }
+
+  (*pagina)->datos[posicion] = dato;
+  (*pagina)->ocupacion[posicion >> 6] |= (uint64_t) 1 << (posicion & 63);
+}
+
+//Funcion para determinar si una localidad de la memoria RAM esta ocupada
+bool localidad_ram_ocupada(const IMAGEN_MEM *imagen, int direccion) {
+  PAGINA_RAM *pagina = imagen->paginas_ram[direccion >> BITS_PAGINA];
+  int posicion = direccion & MASC_PAGINA;
+
+  return pagina && (pagina->ocupacion[posicion >> 6] >> (posicion & 63) & 1);
+}
+
+//Funcion para ubicar la primera localidad ocupada de la memoria RAM a partir de una direccion
+//dada (retorna -1 si no hay mas localidades ocupadas)
+int siguiente_localidad_ram(const IMAGEN_MEM *imagen, int direccion) {
+  int posicion;
+
+  for (; direccion < TAM_ESPACIO_MEM; direccion = (direccion | MASC_PAGINA) + 1) {
+    if (!imagen->paginas_ram[direccion >> BITS_PAGINA]) continue;
+    posicion = buscar_en_mapa(imagen->paginas_ram[direccion >> BITS_PAGINA]->ocupacion,
+                              direccion & MASC_PAGINA);
+    if (posicion >= 0) return (direccion & ~MASC_PAGINA) | posicion;
+  }
+
+  return -1;
+}
+
+//Funcion para ubicar la ultima localidad ocupada de la memoria RAM (retorna -1 si no hay
+//localidades ocupadas)
+int ultima_localidad_ram(const IMAGEN_MEM *imagen) {
+  int i, posicion;
+
+  for (i=NUM_PAGINAS-1; i>=0; i--) {
+    if (!imagen->paginas_ram[i]) continue;
+    posicion = ultimo_en_mapa(imagen->paginas_ram[i]->ocupacion);
+    if (posicion >= 0) return (i << BITS_PAGINA) | posicion;
+  }
+
+  return -1;
+}
+
+//Funcion para contar la cantidad de localidades ocupadas de la memoria RAM
+int contar_localidades_ram(const IMAGEN_MEM *imagen) {
+  int i;
+  int conteo = 0;
+
+  for (i=0; i<NUM_PAGINAS; i++)
+    if (imagen->paginas_ram[i]) conteo += contar_mapa(imagen->paginas_ram[i]->ocupacion);
+
+  return conteo;
+}
+
+//Funcion para copiar un bloque de la memoria RAM junto con su mapa de ocupacion (con las mismas
+//restricciones que leer_bloque_prg)
+void leer_bloque_ram(const IMAGEN_MEM *imagen, int direccion, int cantidad,
+                     uint16_t *datos, uint64_t *ocupacion) {
+  PAGINA_RAM *pagina;
+  int i;
+
+  for (i=0; i<cantidad; i+=TAM_PAGINA) {
+    pagina = imagen->paginas_ram[(direccion + i) >> BITS_PAGINA];
+    if (pagina) {
+      memcpy(&datos[i], pagina->datos, sizeof(pagina->datos));
+      memcpy(&ocupacion[i >> 6], pagina->ocupacion, sizeof(pagina->ocupacion));
+    } else {
+      memset(&datos[i], 0, sizeof(pagina->datos));
+      memset(&ocupacion[i >> 6], 0, sizeof(pagina->ocupacion));
+    }
+  }
+}
+
+//+----------------------------------------+
+//| Operaciones asociadas a toda la imagen |
+//+----------------------------------------+-------------------------------------------------------
+//Funcion para copiar una imagen sobre otra (la de destino debe estar vacia). Solo se copian las
+//paginas usadas, de manera que el costo es proporcional a la memoria ocupada
+void copiar_imagen(IMAGEN_MEM *destino, const IMAGEN_MEM *origen) {
+  int i;
+
+  for (i=0; i<NUM_PAGINAS; i++) {
+    if (origen->paginas_prg[i]) {
+      destino->paginas_prg[i] = malloc(sizeof(PAGINA_PRG));
+      memcpy(destino->paginas_prg[i], origen->paginas_prg[i], sizeof(PAGINA_PRG));
+    }
+    if (origen->paginas_ram[i]) {
+      destino->paginas_ram[i] = malloc(sizeof(PAGINA_RAM));
+      memcpy(destino->paginas_ram[i], origen->paginas_ram[i], sizeof(PAGINA_RAM));
+    }
+  }
+}
+
+//Funcion para liberar todas las paginas de ambos espacios de memoria
+void desalojar_imagen(IMAGEN_MEM *imagen) {
+  int i;
+
+  for (i=0; i<NUM_PAGINAS; i++) {
+    free(imagen->paginas_prg[i]);
+    free(imagen->paginas_ram[i]);
+    imagen->paginas_prg[i] = NULL;
+    imagen->paginas_ram[i] = NULL;
+  }
+}
+
+//Funcion para liberar las paginas de la memoria de programa (la RAM se conserva)
+void desalojar_imagen_prg(IMAGEN_MEM *imagen) {
+  int i;
+
+  for (i=0; i<NUM_PAGINAS; i++) {
+    free(imagen->paginas_prg[i]);
+    imagen->paginas_prg[i] = NULL;
+  }
+}
@@ -0,0 +1,66 @@
+#ifndef j16asm_imagen_mem_h_Incluida
+#define j16asm_imagen_mem_h_Incluida
+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+
+//Constantes exportadas
+//---------------------
+#define TAM_ESPACIO_MEM  65536          //Cantidad de localidades de cada espacio de memoria
+#define MASC_DATO_PRG    0x03FFFFFF     //Mascara de las instrucciones de programa (26 bits)
+#define MASC_DATO_RAM    0xFFFF         //Mascara de las palabras de RAM (16 bits)
+
+//Constantes de dimensionamiento de las paginas
+#define BITS_PAGINA      8                              //Bits de direccion dentro de una pagina
+#define TAM_PAGINA       (1 << BITS_PAGINA)             //Cantidad de localidades por pagina
+#define MASC_PAGINA      (TAM_PAGINA - 1)               //Mascara de posicion dentro de la pagina
+#define NUM_PAGINAS      (TAM_ESPACIO_MEM / TAM_PAGINA) //Cantidad de paginas de cada espacio
+#define PALABRAS_MAPA    (TAM_PAGINA / 64)              //Palabras de 64 bits del mapa de ocupacion
+
+//Tipos de datos exportados
+//-------------------------
+//Tipos de datos que describen las paginas de cada espacio de memoria
+typedef struct _PAGINA_PRG {
+  uint64_t ocupacion[PALABRAS_MAPA];    //Mapa de bits de las localidades ocupadas
+  uint32_t datos[TAM_PAGINA];           //Instrucciones almacenadas (26 bits utiles)
+} PAGINA_PRG;
+
+typedef struct _PAGINA_RAM {
+  uint64_t ocupacion[PALABRAS_MAPA];    //Mapa de bits de las localidades ocupadas
+  uint16_t datos[TAM_PAGINA];           //Palabras de datos almacenadas
+} PAGINA_RAM;
+
+//Estructura con la imagen de ambos espacios de memoria (una imagen en ceros esta vacia)
+typedef struct _IMAGEN_MEM {
+  PAGINA_PRG *paginas_prg[NUM_PAGINAS]; //Paginas de la memoria de programa (NULL si no se usan)
+  PAGINA_RAM *paginas_ram[NUM_PAGINAS]; //Paginas de la memoria RAM (NULL si no se usan)
+} IMAGEN_MEM;
+
+//Funciones exportadas
+//--------------------
+//Funciones asociadas a la memoria de programa
+extern uint32_t leer_dato_prg(const IMAGEN_MEM *imagen, int direccion);
+extern void escribir_dato_prg(IMAGEN_MEM *imagen, int direccion, uint32_t dato);
+extern bool localidad_prg_ocupada(const IMAGEN_MEM *imagen, int direccion);
+extern int siguiente_localidad_prg(const IMAGEN_MEM *imagen, int direccion);
+extern int ultima_localidad_prg(const IMAGEN_MEM *imagen);
+extern int contar_localidades_prg(const IMAGEN_MEM *imagen);
+extern void leer_bloque_prg(const IMAGEN_MEM *imagen, int direccion, int cantidad,
+                            uint32_t *datos, uint64_t *ocupacion);
+
+//Funciones asociadas a la memoria RAM
+extern uint16_t leer_dato_ram(const IMAGEN_MEM *imagen, int direccion);
+extern void escribir_dato_ram(IMAGEN_MEM *imagen, int direccion, uint16_t dato);
+extern bool localidad_ram_ocupada(const IMAGEN_MEM *imagen, int direccion);
+extern int siguiente_localidad_ram(const IMAGEN_MEM *imagen, int direccion);
+extern int ultima_localidad_ram(const IMAGEN_MEM *imagen);
+extern int contar_localidades_ram(const IMAGEN_MEM *imagen);
+extern void leer_bloque_ram(const IMAGEN_MEM *imagen, int direccion, int cantidad,
+                            uint16_t *datos, uint64_t *ocupacion);
+
+//Funciones asociadas a toda la imagen
+extern void copiar_imagen(IMAGEN_MEM *destino, const IMAGEN_MEM *origen);
+extern void desalojar_imagen(IMAGEN_MEM *imagen);   //Libera todas las paginas (queda vacia)
+extern void desalojar_imagen_prg(IMAGEN_MEM *imagen);  //Solo vacia la memoria de programa
+
+#endif //j16asm_imagen_mem_h_Incluida
@@ -0,0 +1,381 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_instrucciones.c                                                                        |
+//| Modulo con la tabla de instrucciones de JPU16                                                 |
+//|                                                                                               |
+//| Este modulo concentra en una sola tabla la codificacion de todas las instrucciones de JPU16:  |
+//| cada renglon describe un mnemonico con una forma de operandos, los bits fijos de su codigo y  |
+//| el campo donde se coloca cada operando. La misma tabla se usa en los dos sentidos:            |
+//| - El analizador lexico obtiene el numero de mnemonico de cada nombre de instruccion (o alias) |
+//|   y el analizador sintactico solo reconoce la forma de los operandos, de manera que la        |
+//|   codificacion se obtiene buscando en la tabla el renglon con ese mnemonico y esa forma.      |
+//| - El desensamblador busca el renglon cuyos bits fijos coinciden con un codigo y escribe el    |
+//|   mnemonico y los operandos que extrae de los campos.                                         |
+//| Agregar una instruccion (o un alias) consiste entonces en agregar un renglon a la tabla. Los  |
+//| renglones de un mismo mnemonico deben quedar juntos.                                          |
+//|                                                                                               |
+//| Nota acerca de la busqueda de mnemonicos                                                      |
+//| Los nombres se buscan en una tabla hash que se arma una unica vez a partir de la tabla de     |
+//| instrucciones (con pthread_once, ya que se puede ensamblar desde varios hilos a la vez). Los  |
+//| nombres no distinguen mayusculas de minusculas.                                               |
+//+-----------------------------------------------------------------------------------------------+
+#include <ctype.h>                      //Permite invocar tolower
+#include <pthread.h>                    //Permite armar la tabla hash una unica vez
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+#include <stdio.h>                      //Permite invocar snprintf
+#include <string.h>                     //Permite manejar cadenas
+#include "j16asm_instrucciones.h"       //Cabecera propia
+
+//Constantes del modulo
+#define MAX_LONG_MNEMONICO  8           //Longitud maxima de un nombre de instruccion
+#define TAM_HASH            256         //Ranuras de la tabla hash (potencia de 2)
+#define MASCARA_CODIGO      0x3FFFFFF   //Bits de un codigo de instruccion (26)
+#define GRUPO_BANDERAS      0b0001      //Codigo de setX y clrX (bits 25 a 22)
+#define POLARIDAD_BANDERAS  (1 << 21)   //Bit que distingue setX (1) de clrX (0)
+
+//Tabla de instrucciones (en el orden del mapa de instrucciones de JPU16)
+static const DESCRIPTOR_INSTR tabla[] = {
+  //Primer bloque de instrucciones: No operacion
+  {"nop",    FO_NINGUNO,     0x0000,                     {CO_NINGUNO, CO_NINGUNO}},
+
+  //Segundo bloque: Instrucciones de manejo de banderas (0001 p IVNZC)
+  {"clrc",   FO_NINGUNO,     0b0001000001 << 16,         {CO_NINGUNO, CO_NINGUNO}},
+  {"setc",   FO_NINGUNO,     0b0001100001 << 16,         {CO_NINGUNO, CO_NINGUNO}},
+  {"clrz",   FO_NINGUNO,     0b0001000010 << 16,         {CO_NINGUNO, CO_NINGUNO}},
+  {"setz",   FO_NINGUNO,     0b0001100010 << 16,         {CO_NINGUNO, CO_NINGUNO}},
+  {"clrn",   FO_NINGUNO,     0b0001000100 << 16,         {CO_NINGUNO, CO_NINGUNO}},
+  {"setn",   FO_NINGUNO,     0b0001100100 << 16,         {CO_NINGUNO, CO_NINGUNO}},
+  {"clrv",   FO_NINGUNO,     0b0001001000 << 16,         {CO_NINGUNO, CO_NINGUNO}},
+  {"setv",   FO_NINGUNO,     0b0001101000 << 16,         {CO_NINGUNO, CO_NINGUNO}},
+  {"clri",   FO_NINGUNO,     0b0001010000 << 16,         {CO_NINGUNO, CO_NINGUNO}},
+  {"seti",   FO_NINGUNO,     0b0001110000 << 16,         {CO_NINGUNO, CO_NINGUNO}},
+
+  //Tercer bloque: Operaciones de prueba (solo afectan banderas)
+  {"test",   FO_REG_EXP,     0b001000 << 20,             {CO_RX, CO_LIT}},
+  {"test",   FO_REG_REG,     0b001001 << 20,             {CO_RX, CO_RY}},
+  {"cmp",    FO_REG_EXP,     0b001010 << 20,             {CO_RX, CO_LIT}},
+  {"cmp",    FO_REG_REG,     0b001011 << 20,             {CO_RX, CO_RY}},
+
+  //Cuarto bloque: Instrucciones de salida de datos desde el CPU (hacia la memoria o bus de I/O).
+  //Las de salida hacia la memoria (move [dir], reg) van con las demas formas de move
+  {"out",    FO_EXP_REG,     0b001110 << 20,             {CO_LIT, CO_RX}},
+  {"out",    FO_REG_REG,     0b001111 << 20,             {CO_RY, CO_RX}},
+
+  //Quinto bloque: Instrucciones de salto (condicion 0ccc en los bits 19 a 16)
+  {"jmp",    FO_EXP,         0b010000 << 20,             {CO_REL, CO_NINGUNO}},
+  {"jmp",    FO_REG,         0b010001 << 20,             {CO_RY, CO_NINGUNO}},
+  {"jmpnc",  FO_EXP,         0b0100100000 << 16,         {CO_REL, CO_NINGUNO}},
+  {"jmpnc",  FO_REG,         0b0100110000 << 16,         {CO_RY, CO_NINGUNO}},
+  {"jmpc",   FO_EXP,         0b0100100001 << 16,         {CO_REL, CO_NINGUNO}},
+  {"jmpc",   FO_REG,         0b0100110001 << 16,         {CO_RY, CO_NINGUNO}},
+  {"jmpnz",  FO_EXP,         0b0100100010 << 16,         {CO_REL, CO_NINGUNO}},
+  {"jmpnz",  FO_REG,         0b0100110010 << 16,         {CO_RY, CO_NINGUNO}},
+  {"jmpz",   FO_EXP,         0b0100100011 << 16,         {CO_REL, CO_NINGUNO}},
+  {"jmpz",   FO_REG,         0b0100110011 << 16,         {CO_RY, CO_NINGUNO}},
+  {"jmpp",   FO_EXP,         0b0100100100 << 16,         {CO_REL, CO_NINGUNO}},
+  {"jmpp",   FO_REG,         0b0100110100 << 16,         {CO_RY, CO_NINGUNO}},
+  {"jmpn",   FO_EXP,         0b0100100101 << 16,         {CO_REL, CO_NINGUNO}},
+  {"jmpn",   FO_REG,         0b0100110101 << 16,         {CO_RY, CO_NINGUNO}},
+  {"jmpnv",  FO_EXP,         0b0100100110 << 16,         {CO_REL, CO_NINGUNO}},
+  {"jmpnv",  FO_REG,         0b0100110110 << 16,         {CO_RY, CO_NINGUNO}},
+  {"jmpv",   FO_EXP,         0b0100100111 << 16,         {CO_REL, CO_NINGUNO}},
+  {"jmpv",   FO_REG,         0b0100110111 << 16,         {CO_RY, CO_NINGUNO}},
+
+  //Sexto bloque: Instrucciones de llamada
+  {"call",   FO_EXP,         0b010100 << 20,             {CO_REL, CO_NINGUNO}},
+  {"call",   FO_REG,         0b010101 << 20,             {CO_RY, CO_NINGUNO}},
+  {"callnc", FO_EXP,         0b0101100000 << 16,         {CO_REL, CO_NINGUNO}},
+  {"callnc", FO_REG,         0b0101110000 << 16,         {CO_RY, CO_NINGUNO}},
+  {"callc",  FO_EXP,         0b0101100001 << 16,         {CO_REL, CO_NINGUNO}},
+  {"callc",  FO_REG,         0b0101110001 << 16,         {CO_RY, CO_NINGUNO}},
+  {"callnz", FO_EXP,         0b0101100010 << 16,         {CO_REL, CO_NINGUNO}},
+  {"callnz", FO_REG,         0b0101110010 << 16,         {CO_RY, CO_NINGUNO}},
+  {"callz",  FO_EXP,         0b0101100011 << 16,         {CO_REL, CO_NINGUNO}},
+  {"callz",  FO_REG,         0b0101110011 << 16,         {CO_RY, CO_NINGUNO}},
+  {"callp",  FO_EXP,         0b0101100100 << 16,         {CO_REL, CO_NINGUNO}},
+  {"callp",  FO_REG,         0b0101110100 << 16,         {CO_RY, CO_NINGUNO}},
+  {"calln",  FO_EXP,         0b0101100101 << 16,         {CO_REL, CO_NINGUNO}},
+  {"calln",  FO_REG,         0b0101110101 << 16,         {CO_RY, CO_NINGUNO}},
+  {"callnv", FO_EXP,         0b0101100110 << 16,         {CO_REL, CO_NINGUNO}},
+  {"callnv", FO_REG,         0b0101110110 << 16,         {CO_RY, CO_NINGUNO}},
+  {"callv",  FO_EXP,         0b0101100111 << 16,         {CO_REL, CO_NINGUNO}},
+  {"callv",  FO_REG,         0b0101110111 << 16,         {CO_RY, CO_NINGUNO}},
+
+  //Septimo bloque: Instrucciones de retorno
+  {"return", FO_NINGUNO,     0b011000 << 20,             {CO_NINGUNO, CO_NINGUNO}},
+  {"idret",  FO_NINGUNO,     0b011100 << 20,             {CO_NINGUNO, CO_NINGUNO}},
+  {"ieret",  FO_NINGUNO,     0b011110 << 20,             {CO_NINGUNO, CO_NINGUNO}},
+
+  //Octavo bloque: operaciones aritmeticas y logicas
+  {"not",    FO_REG,         0b100000 << 20,             {CO_RX, CO_NINGUNO}},
+  {"add",    FO_REG_EXP,     0b100010 << 20,             {CO_RX, CO_LIT}},
+  {"add",    FO_REG_REG,     0b100011 << 20,             {CO_RX, CO_RY}},
+  {"or",     FO_REG_EXP,     0b100100 << 20,             {CO_RX, CO_LIT}},
+  {"or",     FO_REG_REG,     0b100101 << 20,             {CO_RX, CO_RY}},
+  {"addc",   FO_REG_EXP,     0b100110 << 20,             {CO_RX, CO_LIT}},
+  {"addc",   FO_REG_REG,     0b100111 << 20,             {CO_RX, CO_RY}},
+  {"and",    FO_REG_EXP,     0b101000 << 20,             {CO_RX, CO_LIT}},
+  {"and",    FO_REG_REG,     0b101001 << 20,             {CO_RX, CO_RY}},
+  {"sub",    FO_REG_EXP,     0b101010 << 20,             {CO_RX, CO_LIT}},
+  {"sub",    FO_REG_REG,     0b101011 << 20,             {CO_RX, CO_RY}},
+  {"xor",    FO_REG_EXP,     0b101100 << 20,             {CO_RX, CO_LIT}},
+  {"xor",    FO_REG_REG,     0b101101 << 20,             {CO_RX, CO_RY}},
+  {"subb",   FO_REG_EXP,     0b101110 << 20,             {CO_RX, CO_LIT}},
+  {"subb",   FO_REG_REG,     0b101111 << 20,             {CO_RX, CO_RY}},
+
+  //Noveno bloque: operaciones de multiplicacion
+  {"mul",    FO_REG_EXP,     0b110000 << 20,             {CO_RX, CO_LIT}},
+  {"mul",    FO_REG_REG,     0b110001 << 20,             {CO_RX, CO_RY}},
+  {"smul",   FO_REG_EXP,     0b110010 << 20,             {CO_RX, CO_LIT}},
+  {"smul",   FO_REG_REG,     0b110011 << 20,             {CO_RX, CO_RY}},
+
+  //Decimo bloque: operaciones de desplazamiento de bits (operacion en los bits 11 a 9)
+  {"shl0",   FO_REG_EXP,     0b111000 << 20 | 0x0 << 9,  {CO_RX, CO_DESP}},
+  {"shl0",   FO_REG_REG,     0b111001 << 20 | 0x0 << 9,  {CO_RX, CO_RY}},
+  {"shl1",   FO_REG_EXP,     0b111000 << 20 | 0x1 << 9,  {CO_RX, CO_DESP}},
+  {"shl1",   FO_REG_REG,     0b111001 << 20 | 0x1 << 9,  {CO_RX, CO_RY}},
+  {"rol",    FO_REG_EXP,     0b111000 << 20 | 0x2 << 9,  {CO_RX, CO_DESP}},
+  {"rol",    FO_REG_REG,     0b111001 << 20 | 0x2 << 9,  {CO_RX, CO_RY}},
+  {"rolc",   FO_REG,         0b111000 << 20 | 0x3 << 9 | 0x1, {CO_RX, CO_NINGUNO}},
+  {"shr0",   FO_REG_EXP,     0b111000 << 20 | 0x4 << 9,  {CO_RX, CO_DESP}},
+  {"shr0",   FO_REG_REG,     0b111001 << 20 | 0x4 << 9,  {CO_RX, CO_RY}},
+  {"shr1",   FO_REG_EXP,     0b111000 << 20 | 0x5 << 9,  {CO_RX, CO_DESP}},
+  {"shr1",   FO_REG_REG,     0b111001 << 20 | 0x5 << 9,  {CO_RX, CO_RY}},
+  {"ror",    FO_REG_EXP,     0b111000 << 20 | 0x6 << 9,  {CO_RX, CO_DESP}},
+  {"ror",    FO_REG_REG,     0b111001 << 20 | 0x6 << 9,  {CO_RX, CO_RY}},
+  {"rorc",   FO_REG,         0b111000 << 20 | 0x7 << 9 | 0x1, {CO_RX, CO_NINGUNO}},
+
+  //Decimo primer bloque: Instrucciones de entrada de datos hacia el CPU (desde literal,
+  //registro, memoria o I/O)
+  {"move",   FO_REG_EXP,     0b111010 << 20,             {CO_RX, CO_LIT}},
+  {"move",   FO_REG_REG,     0b111011 << 20,             {CO_RX, CO_RY}},
+  {"move",   FO_REG_MEM_EXP, 0b111100 << 20,             {CO_RX, CO_LIT}},
+  {"move",   FO_REG_MEM_REG, 0b111101 << 20,             {CO_RX, CO_RY}},
+  {"move",   FO_MEM_EXP_REG, 0b001100 << 20,             {CO_LIT, CO_RX}},
+  {"move",   FO_MEM_REG_REG, 0b001101 << 20,             {CO_RY, CO_RX}},
+  {"in",     FO_REG_EXP,     0b111110 << 20,             {CO_RX, CO_LIT}},
+  {"in",     FO_REG_REG,     0b111111 << 20,             {CO_RX, CO_RY}},
+
+  //Nombres de instruccion que son alias
+  {"je",     FO_ALIAS, 0, {CO_NINGUNO, CO_NINGUNO}, "jmpz"},
+  {"jne",    FO_ALIAS, 0, {CO_NINGUNO, CO_NINGUNO}, "jmpnz"},
+  {"jae",    FO_ALIAS, 0, {CO_NINGUNO, CO_NINGUNO}, "jmpc"},
+  {"jb",     FO_ALIAS, 0, {CO_NINGUNO, CO_NINGUNO}, "jmpnc"},
+  {"jge",    FO_ALIAS, 0, {CO_NINGUNO, CO_NINGUNO}, "jmpp"},
+  {"jl",     FO_ALIAS, 0, {CO_NINGUNO, CO_NINGUNO}, "jmpn"},
+  {"ce",     FO_ALIAS, 0, {CO_NINGUNO, CO_NINGUNO}, "callz"},
+  {"cne",    FO_ALIAS, 0, {CO_NINGUNO, CO_NINGUNO}, "callnz"},
+  {"cae",    FO_ALIAS, 0, {CO_NINGUNO, CO_NINGUNO}, "callc"},
+  {"cb",     FO_ALIAS, 0, {CO_NINGUNO, CO_NINGUNO}, "callnc"},
+  {"cge",    FO_ALIAS, 0, {CO_NINGUNO, CO_NINGUNO}, "callp"},
+  {"cl",     FO_ALIAS, 0, {CO_NINGUNO, CO_NINGUNO}, "calln"},
+};
+#define NUM_DESCRIPTORES ((int) (sizeof(tabla) / sizeof(tabla[0])))
+
+//Formato del texto de cada forma de operandos (recibe el mnemonico y los dos operandos)
+static const char *const formato_forma[] = {
+  "%s",                                 //FO_NINGUNO
+  "%s %s",                              //FO_REG
+  "%s %s",                              //FO_EXP
+  "%s %s, %s",                          //FO_REG_EXP
+  "%s %s, %s",                          //FO_REG_REG
+  "%s %s, [%s]",                        //FO_REG_MEM_EXP
+  "%s %s, [%s]",                        //FO_REG_MEM_REG
+  "%s [%s], %s",                        //FO_MEM_EXP_REG
+  "%s [%s], %s",                        //FO_MEM_REG_REG
+  "%s %s, %s"                           //FO_EXP_REG
+};
+
+//Tabla hash de los nombres (cada ranura guarda el descriptor del nombre y el primer descriptor
+//del mnemonico al que corresponde, o -1 si esta libre)
+static struct {
+  short nombre;                         //Descriptor cuyo nombre ocupa la ranura
+  short mnemonico;                      //Primer descriptor del mnemonico (resuelve los alias)
+} ranuras[TAM_HASH];
+static pthread_once_t hash_listo = PTHREAD_ONCE_INIT;  //Control de inicializacion del hash
+
+//Declaracion previa de las funciones locales al modulo
+static void armar_hash(void);
+static unsigned int calcular_hash(const char *nombre);
+static int buscar_ranura(const char *nombre);
+static uint32_t mascara_campo(CAMPO_OPERANDO campo);
+static void escribir_operando(char *texto, size_t tam, CAMPO_OPERANDO campo, uint32_t codigo,
+                              int direccion, int tam_prg);
+static int desensamblar_banderas(uint32_t codigo, char *texto, size_t tam_texto);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion que obtiene el numero de mnemonico (el indice de su primer descriptor) de un nombre que
+//no necesita terminar en cero. Retorna -1 si el nombre no es una instruccion ni un alias
+int buscar_mnemonico(const char *nombre, size_t longitud) {
+  char minusculas[MAX_LONG_MNEMONICO + 1];
+  size_t i;
+  int ranura;
+
+  if (longitud > MAX_LONG_MNEMONICO) return -1;  //Los simbolos largos no se comparan
+  for (i=0; i<longitud; i++) minusculas[i] = tolower((unsigned char) nombre[i]);
+  minusculas[longitud] = '\0';
+
+  pthread_once(&hash_listo, armar_hash);
+  ranura = buscar_ranura(minusculas);
+  return ranuras[ranura].nombre < 0 ? -1 : ranuras[ranura].mnemonico;
+}
+
+//Funcion que codifica una instruccion: busca entre los descriptores del mnemonico el que tiene
+//la forma indicada y coloca los operandos en sus campos. Retorna false si el mnemonico no admite
+//esa forma de operandos
+bool codificar_instruccion(int mnemonico, FORMA_OPERANDOS forma, int operando_1,
+                           int operando_2, int direccion, uint32_t *codigo) {
+  const DESCRIPTOR_INSTR *d;
+  int operandos[2] = {operando_1, operando_2};
+  int i;
+
+  for (d=&tabla[mnemonico]; d<tabla+NUM_DESCRIPTORES; d++) {
+    if (strcmp(d->mnemonico, tabla[mnemonico].mnemonico) != 0) break;
+    if (d->forma != forma) continue;
+
+    *codigo = d->codigo;
+    for (i=0; i<2; i++) {
+      switch (d->campo[i]) {
+      case CO_NINGUNO:                                                      break;
+      case CO_RX:   *codigo |= operandos[i] << 16;                          break;
+      case CO_RY:   *codigo |= operandos[i] << 12;                          break;
+      case CO_LIT:  *codigo |= operandos[i] & 0xFFFF;                       break;
+      case CO_DESP: *codigo |= operandos[i] & 0x000F;                       break;
+      case CO_REL:  *codigo |= (operandos[i] - direccion) & 0xFFFF;         break;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+//Funcion que combina dos instrucciones de banderas en una sola (como las que combina el
+//optimizador). Retorna false si alguna no es setX o clrX, o si se mezclan setX con clrX
+bool combinar_banderas(uint32_t codigo_1, uint32_t codigo_2, uint32_t *codigo) {
+  if ((codigo_1 >> 22) != GRUPO_BANDERAS || (codigo_2 >> 22) != GRUPO_BANDERAS ||
+      ((codigo_1 ^ codigo_2) & POLARIDAD_BANDERAS))
+    return false;
+  *codigo = codigo_1 | codigo_2;
+  return true;
+}
+
+//Funcion que obtiene el descriptor de un codigo de instruccion: el primero cuyos bits fijos
+//coinciden con el codigo fuera de los campos de sus operandos
+const DESCRIPTOR_INSTR *decodificar_instruccion(uint32_t codigo) {
+  const DESCRIPTOR_INSTR *d;
+  uint32_t mascara;
+
+  for (d=tabla; d<tabla+NUM_DESCRIPTORES && d->forma!=FO_ALIAS; d++) {
+    mascara = MASCARA_CODIGO & ~mascara_campo(d->campo[0]) & ~mascara_campo(d->campo[1]);
+    if ((codigo & mascara) == d->codigo) return d;
+  }
+  return NULL;
+}
+
+//Funcion que escribe el texto de una instruccion con la sintaxis del ensamblador (los destinos
+//de los saltos y llamadas directas se escriben como direcciones absolutas). Un codigo que no
+//corresponde a ninguna instruccion se escribe como su valor hexadecimal
+int desensamblar_instruccion(uint32_t codigo, int direccion, int tam_prg, char *texto,
+                             size_t tam_texto) {
+  const DESCRIPTOR_INSTR *d = decodificar_instruccion(codigo);
+  char operandos[2][8];
+
+  if (!d) {
+    //Las banderas que combina el optimizador (varias setX o clrX en una sola instruccion) no
+    //tienen un mnemonico propio
+    if ((codigo >> 22) == GRUPO_BANDERAS && (codigo & 0x1F0000) && !(codigo & 0xFFFF))
+      return desensamblar_banderas(codigo, texto, tam_texto);
+    return snprintf(texto, tam_texto, "?? 0x%.7X", codigo);
+  }
+
+  escribir_operando(operandos[0], sizeof(operandos[0]), d->campo[0], codigo, direccion, tam_prg);
+  escribir_operando(operandos[1], sizeof(operandos[1]), d->campo[1], codigo, direccion, tam_prg);
+  return snprintf(texto, tam_texto, formato_forma[d->forma], d->mnemonico, operandos[0],
+                  operandos[1]);
+}
+
+//Funcion que arma la tabla hash de los nombres (los alias apuntan al mnemonico equivalente)
+static void armar_hash(void) {
+  int i, ranura;
+
+  for (i=0; i<TAM_HASH; i++) ranuras[i].nombre = -1;
+
+  //Primero los mnemonicos (cada uno apunta a su primer descriptor)
+  for (i=0; i<NUM_DESCRIPTORES; i++) {
+    if (tabla[i].forma == FO_ALIAS) continue;
+    ranura = buscar_ranura(tabla[i].mnemonico);
+    if (ranuras[ranura].nombre >= 0) continue;
+    ranuras[ranura].nombre = i;
+    ranuras[ranura].mnemonico = i;
+  }
+
+  //Luego los alias (apuntan al primer descriptor de la instruccion equivalente)
+  for (i=0; i<NUM_DESCRIPTORES; i++) {
+    if (tabla[i].forma != FO_ALIAS) continue;
+    ranura = buscar_ranura(tabla[i].mnemonico);
+    ranuras[ranura].nombre = i;
+    ranuras[ranura].mnemonico = ranuras[buscar_ranura(tabla[i].equivale)].mnemonico;
+  }
+}
+
+//Funcion hash de los nombres (FNV-1a)
+static unsigned int calcular_hash(const char *nombre) {
+  unsigned int hash = 2166136261u;
+
+  while (*nombre) hash = (hash ^ (unsigned char) *nombre++) * 16777619u;
+  return hash;
+}
+
+//Funcion que obtiene la ranura de un nombre en minusculas: la que lo contiene o la ranura libre
+//donde iria (sondeo lineal)
+static int buscar_ranura(const char *nombre) {
+  int ranura = calcular_hash(nombre) & (TAM_HASH - 1);
+
+  while (ranuras[ranura].nombre >= 0 && strcmp(tabla[ranuras[ranura].nombre].mnemonico, nombre))
+    ranura = (ranura + 1) & (TAM_HASH - 1);
+  return ranura;
+}
+
+//Funcion que obtiene los bits que ocupa un campo de operando
+static uint32_t mascara_campo(CAMPO_OPERANDO campo) {
+  switch (campo) {
+  case CO_RX:   return 0xF0000;
+  case CO_RY:   return 0x0F000;
+  case CO_LIT:  return 0x0FFFF;
+  case CO_DESP: return 0x0000F;
+  case CO_REL:  return 0x0FFFF;
+  default:      return 0;
+  }
+}
+
+//Funcion que escribe el texto de un operando extraido de su campo
+static void escribir_operando(char *texto, size_t tam, CAMPO_OPERANDO campo, uint32_t codigo,
+                              int direccion, int tam_prg) {
+  switch (campo) {
+  case CO_NINGUNO: texto[0] = '\0';                                                     break;
+  case CO_RX:      snprintf(texto, tam, "r%u", codigo >> 16 & 0xF);                     break;
+  case CO_RY:      snprintf(texto, tam, "r%u", codigo >> 12 & 0xF);                     break;
+  case CO_LIT:     snprintf(texto, tam, "0x%.4X", codigo & 0xFFFF);                     break;
+  case CO_DESP:    snprintf(texto, tam, "%u", codigo & 0xF);                            break;
+  case CO_REL:     snprintf(texto, tam, "0x%.4X",
+                            (direccion + (int16_t) codigo) & (tam_prg - 1));            break;
+  }
+}
+
+//Funcion que escribe una instruccion de banderas combinadas como la lista de las instrucciones
+//que reune (p. ej. setc | setz), la cual el ensamblador acepta de vuelta
+static int desensamblar_banderas(uint32_t codigo, char *texto, size_t tam_texto) {
+  const DESCRIPTOR_INSTR *d;
+  size_t usado = 0;
+
+  texto[0] = '\0';
+  for (d=tabla; d<tabla+NUM_DESCRIPTORES && usado<tam_texto; d++) {
+    if ((d->codigo >> 22) != GRUPO_BANDERAS || (d->codigo & ~codigo & 0x1F0000) ||
+        ((d->codigo ^ codigo) & POLARIDAD_BANDERAS))
+      continue;
+    usado += snprintf(texto + usado, tam_texto - usado, usado ? " | %s" : "%s", d->mnemonico);
+  }
+  return usado;
+}
@@ -0,0 +1,63 @@
+#ifndef j16asm_instrucciones_h_Incluida
+#define j16asm_instrucciones_h_Incluida
+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stddef.h>                     //Incluye la definicion del tipo de dato size_t
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+
+//Tipos de datos exportados
+//-------------------------
+//Formas de los operandos de una instruccion (cada una es una regla del analizador sintactico)
+typedef enum _FORMA_OPERANDOS {
+  FO_NINGUNO,                           //instr
+  FO_REG,                               //instr reg
+  FO_EXP,                               //instr exp
+  FO_REG_EXP,                           //instr reg, exp
+  FO_REG_REG,                           //instr reg, reg
+  FO_REG_MEM_EXP,                       //instr reg, [exp]
+  FO_REG_MEM_REG,                       //instr reg, [reg]
+  FO_MEM_EXP_REG,                       //instr [exp], reg
+  FO_MEM_REG_REG,                       //instr [reg], reg
+  FO_EXP_REG,                           //instr exp, reg
+  FO_ALIAS                              //Nombre alterno de otra instruccion (no es una forma)
+} FORMA_OPERANDOS;
+
+//Campos del codigo de instruccion donde se coloca cada operando
+typedef enum _CAMPO_OPERANDO {
+  CO_NINGUNO,                           //La forma no tiene ese operando
+  CO_RX,                                //Registro en los bits 19 a 16
+  CO_RY,                                //Registro en los bits 15 a 12
+  CO_LIT,                               //Literal de 16 bits (bits 15 a 0)
+  CO_DESP,                              //Cantidad de desplazamientos (bits 3 a 0)
+  CO_REL                                //Direccion relativa a la instruccion (bits 15 a 0)
+} CAMPO_OPERANDO;
+
+//Descriptor de una codificacion de instruccion: un mnemonico con una forma de operandos
+typedef struct _DESCRIPTOR_INSTR {
+  const char *mnemonico;                //Nombre de la instruccion (en minusculas)
+  FORMA_OPERANDOS forma;                //Forma de los operandos
+  uint32_t codigo;                      //Bits fijos del codigo de instruccion
+  CAMPO_OPERANDO campo[2];              //Campo de cada operando (en el orden de la sintaxis)
+  const char *equivale;                 //Instruccion equivalente (solo en los alias)
+} DESCRIPTOR_INSTR;
+
+//Funciones exportadas
+//--------------------
+//Funcion que obtiene el numero de mnemonico de un nombre (-1 si no es una instruccion)
+extern int buscar_mnemonico(const char *nombre, size_t longitud);
+
+//Funcion que codifica una instruccion a partir de su mnemonico, la forma y los operandos
+extern bool codificar_instruccion(int mnemonico, FORMA_OPERANDOS forma, int operando_1,
+                                  int operando_2, int direccion, uint32_t *codigo);
+
+//Funcion que combina dos instrucciones setX (o dos clrX) en una sola
+extern bool combinar_banderas(uint32_t codigo_1, uint32_t codigo_2, uint32_t *codigo);
+
+//Funcion que obtiene el descriptor de un codigo de instruccion (NULL si no corresponde a ninguno)
+extern const DESCRIPTOR_INSTR *decodificar_instruccion(uint32_t codigo);
+
+//Funcion que escribe el texto de una instruccion (retorna la cantidad de caracteres)
+extern int desensamblar_instruccion(uint32_t codigo, int direccion, int tam_prg, char *texto,
+                                    size_t tam_texto);
+
+#endif //j16asm_instrucciones_h_Incluida
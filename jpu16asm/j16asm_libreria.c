@@ -0,0 +1,96 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_libreria.c                                                                             |
+//| Modulo de la interfaz publica de la libreria del ensamblador                                  |
+//|                                                                                               |
+//| Este modulo expone el ensamblador como una libreria (libjpu16asm.a) que se puede incrustar en |
+//| otros programas, por ejemplo en un banco de pruebas que ensambla miles de fragmentos de codigo|
+//| generados sin crear un proceso por cada uno. Cada ensamblador es un contexto de ensamblado    |
+//| independiente; el codigo se toma de un buffer en memoria y el resultado queda en la imagen de |
+//| memoria del contexto, sin generar ningun archivo. Las funciones de esta interfaz solo         |
+//| traducen los nombres publicos a las funciones internas del ensamblador.                       |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdio.h>                      //Permite invocar snprintf
+#include "j16asm_libreria.h"            //Cabecera propia
+#include "j16asm.h"                     //Importa el contexto de ensamblado
+#include "j16asm_ensamblador.h"         //Permite crear contextos y ejecutar los pasos
+#include "j16asm_dat_struct.h"          //Importa la lista de simbolos
+#include "j16asm_imagen_mem.h"          //Importa la imagen de las memorias de programa y RAM
+
+//Declaracion previa de las funciones locales al modulo
+static bool capacidad_valida(int tam, int minimo, int maximo);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion para crear un ensamblador con las capacidades de memoria indicadas
+JPU16ASM *jpu16asm_crear(int tam_prg, int tam_ram) {
+  if (!capacidad_valida(tam_prg, 512, 16384) || !capacidad_valida(tam_ram, 1024, 32768))
+    return NULL;
+  return crear_contexto(tam_prg, tam_ram);
+}
+
+//Funcion para liberar un ensamblador
+void jpu16asm_destruir(JPU16ASM *ensamblador) {
+  destruir_contexto(ensamblador);
+}
+
+//Funcion para indicar la funcion que recibe los mensajes de error
+void jpu16asm_fijar_reporte(JPU16ASM *ensamblador, JPU16ASM_REPORTE reportar, void *datos) {
+  ensamblador->reportar = reportar;
+  ensamblador->datos_reporte = datos;
+}
+
+//Funcion para ensamblar un programa contenido en un buffer (pasos 1 y 2)
+bool jpu16asm_ensamblar(JPU16ASM *ensamblador, const char *nombre,
+                        const char *codigo, size_t tam) {
+  reiniciar_contexto(ensamblador);
+  snprintf(ensamblador->nombre_archivo_ent, sizeof(ensamblador->nombre_archivo_ent), "%s",
+           nombre);
+  return proceso_paso_1_memoria(ensamblador, codigo, tam) && proceso_paso_2(ensamblador);
+}
+
+//Funciones para consultar la imagen de memoria del ultimo ensamblado (las direcciones fuera de
+//la capacidad de la memoria se leen como libres y en cero)
+uint32_t jpu16asm_leer_prg(const JPU16ASM *ensamblador, int direccion) {
+  if (direccion < 0 || direccion >= ensamblador->tam_prg) return 0;
+  return leer_dato_prg(&ensamblador->imagen, direccion);
+}
+
+uint16_t jpu16asm_leer_ram(const JPU16ASM *ensamblador, int direccion) {
+  if (direccion < 0 || direccion >= ensamblador->tam_ram) return 0;
+  return leer_dato_ram(&ensamblador->imagen, direccion);
+}
+
+bool jpu16asm_prg_ocupada(const JPU16ASM *ensamblador, int direccion) {
+  if (direccion < 0 || direccion >= ensamblador->tam_prg) return false;
+  return localidad_prg_ocupada(&ensamblador->imagen, direccion);
+}
+
+bool jpu16asm_ram_ocupada(const JPU16ASM *ensamblador, int direccion) {
+  if (direccion < 0 || direccion >= ensamblador->tam_ram) return false;
+  return localidad_ram_ocupada(&ensamblador->imagen, direccion);
+}
+
+int jpu16asm_contar_prg(const JPU16ASM *ensamblador) {
+  return contar_localidades_prg(&ensamblador->imagen);
+}
+
+int jpu16asm_contar_ram(const JPU16ASM *ensamblador) {
+  return contar_localidades_ram(&ensamblador->imagen);
+}
+
+//Funcion para obtener el valor de un simbolo del ultimo ensamblado (regresa false si el simbolo
+//no existe o no fue definido)
+bool jpu16asm_buscar_simbolo(JPU16ASM *ensamblador, const char *nombre, int *valor) {
+  SIMBOLO *simbolo = buscar_simbolo(&ensamblador->lista_simbolos, (char *) nombre);
+
+  if (!simbolo || !simbolo->definido) return false;
+  *valor = simbolo->valor;
+  return true;
+}
+
+//Funcion para determinar si una capacidad de memoria es una potencia de 2 dentro del rango
+static bool capacidad_valida(int tam, int minimo, int maximo) {
+  return tam >= minimo && tam <= maximo && (tam & (tam - 1)) == 0;
+}
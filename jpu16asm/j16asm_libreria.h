@@ -0,0 +1,45 @@
+#ifndef j16asm_libreria_h_Incluida
+#define j16asm_libreria_h_Incluida
+
+//Interfaz publica de la libreria del ensamblador (libjpu16asm.a). Esta cabecera no depende de
+//ninguna otra cabecera del ensamblador, de manera que puede usarse desde otros proyectos
+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stddef.h>                     //Incluye la definicion del tipo de dato size_t
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+
+//Tipos de datos exportados
+//-------------------------
+//Ensamblador (opaco). Cada uno es independiente de los demas y se puede reutilizar para ensamblar
+//cualquier cantidad de programas
+typedef struct _CONTEXTO_ASM JPU16ASM;
+
+//Funcion que recibe los mensajes de error (ya con formato y fin de linea)
+typedef void (*JPU16ASM_REPORTE)(void *datos, const char *mensaje);
+
+//Funciones exportadas
+//--------------------
+//Funciones para crear y liberar un ensamblador (las capacidades son las mismas que admiten las
+//opciones -p y -r; regresa NULL si no son validas)
+extern JPU16ASM *jpu16asm_crear(int tam_prg, int tam_ram);
+extern void jpu16asm_destruir(JPU16ASM *ensamblador);
+
+//Funcion para indicar a donde se envian los mensajes de error (por omision se imprimen en stdout)
+extern void jpu16asm_fijar_reporte(JPU16ASM *ensamblador, JPU16ASM_REPORTE reportar,
+                                   void *datos);
+
+//Funcion para ensamblar un programa contenido en un buffer (el nombre solo se usa en los
+//mensajes y para ubicar los archivos incluidos). Descarta el resultado del ensamblado anterior
+extern bool jpu16asm_ensamblar(JPU16ASM *ensamblador, const char *nombre,
+                               const char *codigo, size_t tam);
+
+//Funciones para consultar la imagen de memoria y los simbolos del ultimo ensamblado
+extern uint32_t jpu16asm_leer_prg(const JPU16ASM *ensamblador, int direccion);
+extern uint16_t jpu16asm_leer_ram(const JPU16ASM *ensamblador, int direccion);
+extern bool jpu16asm_prg_ocupada(const JPU16ASM *ensamblador, int direccion);
+extern bool jpu16asm_ram_ocupada(const JPU16ASM *ensamblador, int direccion);
+extern int jpu16asm_contar_prg(const JPU16ASM *ensamblador);
+extern int jpu16asm_contar_ram(const JPU16ASM *ensamblador);
+extern bool jpu16asm_buscar_simbolo(JPU16ASM *ensamblador, const char *nombre, int *valor);
+
+#endif //j16asm_libreria_h_Incluida
@@ -0,0 +1,369 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_listado.c                                                                              |
+//| Modulo de generacion del listado del programa                                                 |
+//|                                                                                               |
+//| Este modulo genera un listado (opcion -lst) con cada instruccion de la memoria de programa: su|
+//| direccion, su codigo, los ciclos de SysClk que tarda, los ciclos acumulados desde la etiqueta |
+//| anterior y la linea del codigo fuente que la genero. Al final se agregan las cotas del tiempo |
+//| de cada rutina (ver el modulo j16asm_tiempos), desde su etiqueta hasta que retorna, y las del |
+//| vector de interrupcion, que dan el tiempo que tarda en atenderse una interrupcion.            |
+//| Para conocer la linea de cada instruccion, el analizador sintactico la registra al agregar la |
+//| instruccion y el optimizador la mueve junto con ella.                                         |
+//|                                                                                               |
+//| Nota acerca de la cantidad de vueltas de los lazos                                            |
+//| La cantidad de vueltas de un lazo se indica con un comentario en la instruccion que lo cierra |
+//| (el salto hacia atras), de manera que el ensamblado no cambia:                                |
+//|   jmpnz ciclo    ;@iteraciones 8         (exactamente 8 vueltas)                              |
+//|   jmpnz ciclo    ;@iteraciones 1 8       (entre 1 y 8 vueltas)                                |
+//| Un lazo sin esta anotacion hace que la rutina no tenga cota, lo cual se indica en el listado  |
+//| junto con la linea del salto. Una anotacion invalida se avisa en su linea y se ignora.        |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdio.h>                      //Permite manejar archivos
+#include <stdlib.h>                     //Permite invocar malloc, realloc, qsort y free
+#include <string.h>                     //Permite manejar cadenas
+#include "j16asm_listado.h"             //Cabecera propia
+#include "j16asm.h"                     //Importa el contexto de ensamblado
+#include "j16asm_imagen_mem.h"          //Importa la imagen de las memorias de programa y RAM
+#include "j16asm_dat_struct.h"          //Importa la lista de simbolos
+#include "j16asm_fuentes.h"             //Importa el registro de archivos fuente
+#include "j16asm_tiempos.h"             //Importa el analisis del tiempo de las rutinas
+#include "j16asm_recolector.h"          //Permite omitir las etiquetas que elimino la recoleccion
+#include "j16asm_arena.h"               //Permite contar los alojamientos de memoria (-stats)
+#include "j16asm_messages.h"            //Permite enviar mensajes al usuario
+
+//Constantes del modulo
+#define ANOTACION_VUELTAS  "@iteraciones"  //Anotacion con la cantidad de vueltas de un lazo
+#define TAM_UBICACION      280             //Espacio para el archivo y la linea de una instruccion
+
+//Estructura con el texto de un archivo fuente dividido en lineas
+typedef struct _TEXTO_FUENTE {
+  char *texto;                          //Contenido del archivo (cada fin de linea es un nulo)
+  char **lineas;                        //Inicio de cada linea (la primera es la linea 1)
+  int num_lineas;                       //Cantidad de lineas
+} TEXTO_FUENTE;
+
+//Textos de los motivos por los que una rutina no tiene cota (en el orden de MOTIVO_SIN_COTA)
+static const char *const texto_motivo[] = {
+  "",
+  "lazo sin cantidad de vueltas (" ANOTACION_VUELTAS ")",
+  "lazo con varias entradas",
+  "lazo o rutina sin salida",
+  "salto o llamada indirecta",
+  "llamada recursiva",
+  "la ejecucion sale del programa"
+};
+
+//Declaracion previa de las funciones locales al modulo
+static void leer_fuente(const char *nombre, TEXTO_FUENTE *fuente);
+static const char *linea_fuente(CONTEXTO_ASM *ctx, TEXTO_FUENTE *fuentes, int direccion);
+static bool leer_cota(const char *linea, COTA_LAZO *cota);
+static bool linea_repetida(CONTEXTO_ASM *ctx, int direccion);
+static int buscar_etiquetas(CONTEXTO_ASM *ctx, SIMBOLO ***etiquetas);
+static int comparar_etiquetas(const void *a, const void *b);
+static const char *ubicacion(CONTEXTO_ASM *ctx, const char **nombres, int direccion,
+                            char *texto, size_t tam_texto);
+static void escribir_tiempo(FILE *fp_archivo, CONTEXTO_ASM *ctx, const char **nombres,
+                            ANALISIS_TIEMPOS *analisis, const char *rutina, int direccion);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion que registra la linea actual del codigo fuente como la de la instruccion ubicada en una
+//direccion (solo si se va a generar el listado)
+void registrar_linea_prg(CONTEXTO_ASM *ctx, int direccion) {
+  INFO_LISTADO *info = &ctx->info_listado;
+  int i;
+
+  if (!info->registrar) return;
+  if (!info->fuentes) {
+    info->fuentes = malloc(ctx->tam_prg * sizeof(int));
+    info->lineas = malloc(ctx->tam_prg * sizeof(int));
+    for (i=0; i<ctx->tam_prg; i++) info->fuentes[i] = -1;
+  }
+  info->fuentes[direccion] = ctx->fuente_actual;
+  info->lineas[direccion] = ctx->num_lin;
+}
+
+//Funcion que mueve la linea de una instruccion que el optimizador cambio de direccion
+void mover_linea_prg(INFO_LISTADO *info, int origen, int destino) {
+  if (!info->fuentes || origen == destino) return;
+  info->fuentes[destino] = info->fuentes[origen];
+  info->lineas[destino] = info->lineas[origen];
+}
+
+//Funcion que reacomoda las lineas cuando se reordena la memoria de programa: origen indica, para
+//cada direccion, la direccion anterior cuya linea le corresponde (-1 si no tiene linea)
+void reordenar_lineas_prg(INFO_LISTADO *info, const int *origen, int tam) {
+  int *fuentes, *lineas, direccion;
+
+  if (!info->fuentes) return;
+  fuentes = malloc(tam * sizeof(int));
+  lineas = malloc(tam * sizeof(int));
+  for (direccion=0; direccion<tam; direccion++) {
+    fuentes[direccion] = origen[direccion] >= 0 ? info->fuentes[origen[direccion]] : -1;
+    lineas[direccion] = origen[direccion] >= 0 ? info->lineas[origen[direccion]] : 0;
+  }
+  free(info->fuentes);
+  free(info->lineas);
+  info->fuentes = fuentes;
+  info->lineas = lineas;
+}
+
+//Funcion para descartar las lineas registradas (la opcion de registrar se conserva)
+void reiniciar_info_listado(INFO_LISTADO *info) {
+  free(info->fuentes);
+  free(info->lineas);
+  info->fuentes = NULL;
+  info->lineas = NULL;
+}
+
+//Funcion que genera el listado. Debe invocarse antes de desalojar la lista de simbolos, ya que
+//las etiquetas marcan el inicio de cada rutina
+bool escribir_listado(CONTEXTO_ASM *ctx, const char *nombre) {
+  FILE *fp_archivo;
+  TEXTO_FUENTE *fuentes;
+  COTA_LAZO *cotas;
+  ANALISIS_TIEMPOS analisis;
+  SIMBOLO **etiquetas;
+  const char **nombres;
+  const char *linea;
+  char texto[TAM_UBICACION];
+  int num_fuentes, num_etiquetas, direccion, anterior, acumulado, i;
+
+  fp_archivo = fopen(nombre, "w");
+  if (!fp_archivo) {
+    msg_error_crear_archivo_salida(ctx, nombre);
+    return false;
+  }
+
+  //Lee el texto de los archivos fuente y obtiene la cantidad de vueltas de los lazos
+  nombres = obtener_fuentes(&ctx->registro_fuentes, &num_fuentes);
+  fuentes = malloc(num_fuentes * sizeof(TEXTO_FUENTE));
+  for (i=0; i<num_fuentes; i++) leer_fuente(nombres[i], &fuentes[i]);
+  cotas = malloc(ctx->tam_prg * sizeof(COTA_LAZO));
+  contar_alojamiento(num_fuentes * sizeof(TEXTO_FUENTE));
+  contar_alojamiento(ctx->tam_prg * sizeof(COTA_LAZO));
+  for (direccion=0; direccion<ctx->tam_prg; direccion++)
+    if (!leer_cota(linea_fuente(ctx, fuentes, direccion), &cotas[direccion]) &&
+        !linea_repetida(ctx, direccion))
+      msg_anotacion_vueltas_invalida(ctx, ubicacion(ctx, nombres, direccion, texto, sizeof(texto)),
+                                     ANOTACION_VUELTAS);
+  num_etiquetas = buscar_etiquetas(ctx, &etiquetas);
+
+  //Encabezado del listado
+  fprintf(fp_archivo,
+          "; Listado de %s\n"
+          "; Cada instruccion tarda %i ciclos de SysClk (sin contar las detenciones por SysHold)\n"
+          "; La columna Acum. suma los ciclos desde la etiqueta anterior.\n\n"
+          "Dir.    Codigo    Ciclos  Acum.  Linea                 Codigo fuente\n",
+          ctx->nombre_archivo_ent, CICLOS_INSTRUCCION);
+
+  //Cada instruccion con su linea, precedida de las etiquetas que la nombran (los ciclos
+  //acumulados vuelven a cero en cada etiqueta y despues de cada hueco)
+  acumulado = 0;
+  anterior = -1;
+  i = 0;
+  for (direccion=siguiente_localidad_prg(&ctx->imagen, 0); direccion>=0;
+       direccion=siguiente_localidad_prg(&ctx->imagen, direccion + 1)) {
+    if (direccion != anterior + 1) {
+      fputc('\n', fp_archivo);
+      acumulado = 0;
+    }
+    for (; i<num_etiquetas && etiquetas[i]->valor<=direccion; i++) {
+      fprintf(fp_archivo, "%s:\n", etiquetas[i]->nombre);
+      acumulado = 0;
+    }
+    acumulado += CICLOS_INSTRUCCION;
+    fprintf(fp_archivo, "0x%.4X  %.8X  %6i %6i  ", direccion,
+            leer_dato_prg(&ctx->imagen, direccion), CICLOS_INSTRUCCION, acumulado);
+    fprintf(fp_archivo, "%-20s", ubicacion(ctx, nombres, direccion, texto, sizeof(texto)));
+    linea = linea_fuente(ctx, fuentes, direccion);
+    if (linea) {
+      while (*linea == ' ' || *linea == '\t') linea++;
+      fprintf(fp_archivo, "  %s", linea);
+    }
+    fputc('\n', fp_archivo);
+    anterior = direccion;
+  }
+  for (; i<num_etiquetas; i++) fprintf(fp_archivo, "%s:\n", etiquetas[i]->nombre);
+
+  //Cotas del tiempo de cada rutina y del vector de interrupcion
+  fprintf(fp_archivo,
+          "\n; Tiempo de cada rutina en ciclos de SysClk, desde su etiqueta hasta que retorna\n"
+          "\nRutina                    Dir.     Mejor caso   Peor caso\n");
+  iniciar_analisis_tiempos(&analisis, &ctx->imagen, ctx->tam_prg, cotas);
+  for (i=0; i<num_etiquetas; i++)
+    if (etiquetas[i]->valor < ctx->tam_prg)
+      escribir_tiempo(fp_archivo, ctx, nombres, &analisis, etiquetas[i]->nombre,
+                      etiquetas[i]->valor);
+  if (localidad_prg_ocupada(&ctx->imagen, ctx->tam_prg - 1))
+    escribir_tiempo(fp_archivo, ctx, nombres, &analisis, "(vector de interrupcion)",
+                    ctx->tam_prg - 1);
+  desalojar_analisis_tiempos(&analisis);
+
+  for (i=0; i<num_fuentes; i++) {
+    free(fuentes[i].texto);
+    free(fuentes[i].lineas);
+  }
+  free(fuentes);
+  free(cotas);
+  free(etiquetas);
+
+  if (ferror(fp_archivo) | fclose(fp_archivo)) {
+    msg_error_escribir_archivo_salida(ctx, nombre);
+    return false;
+  }
+  return true;
+}
+
+//Funcion que lee un archivo fuente y lo divide en lineas (si no se puede leer queda vacio)
+static void leer_fuente(const char *nombre, TEXTO_FUENTE *fuente) {
+  FILE *fp_archivo = fopen(nombre, "rb");
+  long tam = 0;
+  char *p;
+
+  fuente->texto = NULL;
+  fuente->lineas = NULL;
+  fuente->num_lineas = 0;
+  if (!fp_archivo) return;
+
+  //Lee todo el archivo (agregando un nulo al final)
+  if (fseek(fp_archivo, 0, SEEK_END) == 0) tam = ftell(fp_archivo);
+  rewind(fp_archivo);
+  if (tam < 0) tam = 0;
+  fuente->texto = malloc(tam + 1);
+  contar_alojamiento(tam + 1);
+  tam = fread(fuente->texto, 1, tam, fp_archivo);
+  fuente->texto[tam] = '\0';
+  fclose(fp_archivo);
+
+  //Cada fin de linea se sustituye por un nulo (junto con el retorno de carro que lo precede)
+  for (p=fuente->texto; ; ) {
+    if (!(fuente->num_lineas & (fuente->num_lineas - 1)))
+      fuente->lineas = realloc(fuente->lineas, (fuente->num_lineas ? fuente->num_lineas * 2 : 1) *
+                                               sizeof(char *));
+    fuente->lineas[fuente->num_lineas++] = p;
+    p = strchr(p, '\n');
+    if (!p) break;
+    if (p > fuente->texto && p[-1] == '\r') p[-1] = '\0';
+    *p++ = '\0';
+  }
+}
+
+//Funcion que obtiene el texto de la linea que genero la instruccion de una direccion (NULL si no
+//se conoce)
+static const char *linea_fuente(CONTEXTO_ASM *ctx, TEXTO_FUENTE *fuentes, int direccion) {
+  INFO_LISTADO *info = &ctx->info_listado;
+  TEXTO_FUENTE *fuente;
+
+  if (!info->fuentes || info->fuentes[direccion] < 0 ||
+      !localidad_prg_ocupada(&ctx->imagen, direccion))
+    return NULL;
+  fuente = &fuentes[info->fuentes[direccion]];
+  if (info->lineas[direccion] < 1 || info->lineas[direccion] > fuente->num_lineas) return NULL;
+  return fuente->lineas[info->lineas[direccion] - 1];
+}
+
+//Funcion que obtiene la cantidad de vueltas anotada en el comentario de una linea (sin anotacion
+//el lazo no tiene cota). El comentario inicia en el primer punto y coma que no esta dentro de una
+//cadena o un caracter entre comillas. Regresa false si la anotacion es invalida
+static bool leer_cota(const char *linea, COTA_LAZO *cota) {
+  const char *p;
+  int minimo, maximo;
+
+  cota->minimo = 1;
+  cota->maximo = -1;
+  for (p=linea; p && *p && *p!=';'; p++) {
+    if (*p == '"') {
+      p = strchr(p + 1, '"');           //Las cadenas se saltan completas
+      if (!p) return true;
+    }
+    else if (*p == '\'' && p[1] && p[2] == '\'') {
+      p += 2;                           //Los caracteres entre comillas tambien
+    }
+  }
+  if (!p || *p != ';' || !(p = strstr(p, ANOTACION_VUELTAS))) return true;
+
+  //Con un solo numero la cantidad es exacta, con dos es un rango
+  switch (sscanf(p + strlen(ANOTACION_VUELTAS), "%i %i", &minimo, &maximo)) {
+  case 1: maximo = minimo; break;
+  case 2: break;
+  default: return false;
+  }
+  if (minimo < 1 || maximo < minimo) return false;
+  cota->minimo = minimo;
+  cota->maximo = maximo;
+  return true;
+}
+
+//Funcion que indica si la linea de una direccion ya genero una instruccion anterior (una
+//repeticion o una macro, o un salto agregado por -prof), para avisar una sola vez por linea
+static bool linea_repetida(CONTEXTO_ASM *ctx, int direccion) {
+  INFO_LISTADO *info = &ctx->info_listado;
+  int anterior;
+
+  for (anterior=0; anterior<direccion; anterior++)
+    if (info->fuentes[anterior] == info->fuentes[direccion] &&
+        info->lineas[anterior] == info->lineas[direccion] &&
+        localidad_prg_ocupada(&ctx->imagen, anterior))
+      return true;
+  return false;
+}
+
+//Funcion que obtiene las etiquetas de programa ordenadas por direccion (retorna la cantidad). Los
+//simbolos de inicio de modulo ($code y $data) no son etiquetas del codigo fuente
+static int buscar_etiquetas(CONTEXTO_ASM *ctx, SIMBOLO ***etiquetas) {
+  SIMBOLO *simbolo;
+  int cantidad = 0;
+
+  *etiquetas = NULL;
+  for (simbolo=primer_simbolo(&ctx->lista_simbolos); simbolo; simbolo=simbolo->siguiente) {
+    if (!simbolo->definido || simbolo->reubicacion != REUB_PRG || simbolo->nombre[0] == '$' ||
+        simbolo->valor < 0 || simbolo->valor > ctx->tam_prg ||
+        etiqueta_descartada(ctx, simbolo->nombre))
+      continue;
+    if (!(cantidad & (cantidad - 1)))
+      *etiquetas = realloc(*etiquetas, (cantidad ? cantidad * 2 : 1) * sizeof(SIMBOLO *));
+    (*etiquetas)[cantidad++] = simbolo;
+  }
+  if (cantidad) qsort(*etiquetas, cantidad, sizeof(SIMBOLO *), comparar_etiquetas);
+  return cantidad;
+}
+
+//Funcion de comparacion para ordenar las etiquetas por direccion (y por nombre en la misma)
+static int comparar_etiquetas(const void *a, const void *b) {
+  const SIMBOLO *x = *(SIMBOLO * const *) a, *y = *(SIMBOLO * const *) b;
+
+  if (x->valor != y->valor) return x->valor - y->valor;
+  return strcmp(x->nombre, y->nombre);
+}
+
+//Funcion que da formato al archivo y la linea de la instruccion de una direccion (o solo a la
+//direccion si no se conoce la linea)
+static const char *ubicacion(CONTEXTO_ASM *ctx, const char **nombres, int direccion,
+                            char *texto, size_t tam_texto) {
+  INFO_LISTADO *info = &ctx->info_listado;
+
+  if (!info->fuentes || info->fuentes[direccion] < 0)
+    snprintf(texto, tam_texto, "0x%.4X", direccion);  //Sin linea, solo la direccion
+  else
+    snprintf(texto, tam_texto, "%s:%i", nombres[info->fuentes[direccion]],
+             info->lineas[direccion]);
+  return texto;
+}
+
+//Funcion que escribe las cotas del tiempo de una rutina, o el motivo por el que no las tiene
+static void escribir_tiempo(FILE *fp_archivo, CONTEXTO_ASM *ctx, const char **nombres,
+                            ANALISIS_TIEMPOS *analisis, const char *rutina, int direccion) {
+  TIEMPO_RUTINA tiempo = calcular_tiempo_rutina(analisis, direccion);
+  char texto[TAM_UBICACION];
+
+  fprintf(fp_archivo, "%-24s  0x%.4X  ", rutina, direccion);
+  if (tiempo.motivo == SC_NINGUNO) {
+    fprintf(fp_archivo, "%11lli %11lli\n", tiempo.mejor, tiempo.peor);
+    return;
+  }
+  fprintf(fp_archivo, "sin cota: %s en %s\n", texto_motivo[tiempo.motivo],
+          ubicacion(ctx, nombres, tiempo.direccion_motivo, texto, sizeof(texto)));
+}
@@ -0,0 +1,30 @@
+#ifndef j16asm_listado_h_Incluida
+#define j16asm_listado_h_Incluida
+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+
+//Tipos de datos exportados
+//-------------------------
+//Estructura con lo que el ensamblado recoge para el listado: la linea del codigo fuente de cada
+//instruccion (los arreglos se alojan al registrar la primera)
+typedef struct _INFO_LISTADO {
+  bool registrar;                       //El ensamblado registra la linea de cada instruccion
+  int *fuentes;                         //Archivo fuente de cada direccion (-1 si no hay)
+  int *lineas;                          //Linea del archivo fuente de cada direccion
+} INFO_LISTADO;
+
+//Declaracion previa del contexto de ensamblado (definido en j16asm.h)
+struct _CONTEXTO_ASM;
+
+//Funciones exportadas
+//--------------------
+//Funciones que usa el ensamblado para recoger la informacion
+extern void registrar_linea_prg(struct _CONTEXTO_ASM *ctx, int direccion);
+extern void mover_linea_prg(INFO_LISTADO *info, int origen, int destino);
+extern void reordenar_lineas_prg(INFO_LISTADO *info, const int *origen, int tam);
+extern void reiniciar_info_listado(INFO_LISTADO *info);
+
+//Funcion que genera el listado con los ciclos de cada instruccion y las cotas de cada rutina
+extern bool escribir_listado(struct _CONTEXTO_ASM *ctx, const char *nombre);
+
+#endif //j16asm_listado_h_Incluida
@@ -0,0 +1,543 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_lote.c                                                                                 |
+//| Modulo del modo de lotes                                                                      |
+//|                                                                                               |
+//| Este modulo ensambla todos los trabajos de un manifiesto en paralelo. Cada linea del          |
+//| manifiesto es un trabajo con la misma forma que la linea de comandos (archivo de entrada y    |
+//| opciones), de manera que un mismo programa se puede generar con distintas capacidades de      |
+//| memoria y distintos archivos de salida.                                                       |
+//| El proceso se divide en dos fases, cada una repartida entre un grupo de hilos que van tomando |
+//| la siguiente tarea pendiente:                                                                 |
+//| - Fase de fuentes: cada archivo de entrada distinto se ensambla (pasos 1 y 2) una sola vez,   |
+//|   con las mayores capacidades de memoria que le piden sus trabajos.                           |
+//| - Fase de trabajos: cada trabajo copia la imagen de memoria ya ensamblada de su archivo y     |
+//|   genera sus salidas con sus propias capacidades. La imagen no depende de las capacidades     |
+//|   (estas solo limitan hasta donde se puede escribir), asi que basta verificar que la ultima   |
+//|   localidad ocupada quepa en las memorias del trabajo. Si no cabe, o si el ensamblado         |
+//|   compartido fallo con otras capacidades, el trabajo se ensambla aparte para que reporte      |
+//|   exactamente los mismos errores que una invocacion individual.                               |
+//| Los trabajos con distinto nivel de optimizacion (-O) no comparten el ensamblado, y con la     |
+//| optimizacion activa tampoco lo comparten los que piden distinta capacidad de programa, ya que |
+//| el resultado depende de ella (la ultima direccion es el vector de interrupcion).              |
+//| Los mensajes de cada ensamblado se capturan mediante la funcion de reporte del contexto y se  |
+//| imprimen al terminar, en el orden del manifiesto, junto con el tiempo de cada trabajo y un    |
+//| resumen del rendimiento total.                                                                |
+//+-----------------------------------------------------------------------------------------------+
+#include <pthread.h>                    //Permite crear los hilos de trabajo
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdio.h>                      //Permite manejar archivos
+#include <stdlib.h>                     //Permite invocar malloc, realloc y free
+#include <string.h>                     //Permite manejar cadenas
+#include <time.h>                       //Permite medir el tiempo transcurrido
+#include <unistd.h>                     //Permite consultar la cantidad de procesadores
+#include "j16asm_lote.h"                //Cabecera propia
+#include "j16asm.h"                     //Importa el contexto de ensamblado
+#include "j16asm_ensamblador.h"         //Permite crear contextos y ejecutar los pasos
+#include "j16asm_imagen_mem.h"          //Importa la imagen de las memorias de programa y RAM
+#include "j16asm_opciones.h"            //Permite interpretar las opciones de cada trabajo
+#include "j16asm_salida.h"              //Permite generar los archivos de salida
+#include "j16asm_objeto.h"              //Permite reconocer los archivos objeto
+#include "j16asm_fuentes.h"             //Permite generar los archivos de dependencias
+#include "j16asm_optimizador.h"         //Permite optimizar la memoria de programa
+#include "j16asm_recolector.h"          //Permite eliminar el codigo y los datos inalcanzables
+#include "j16asm_messages.h"            //Permite enviar mensajes al usuario
+
+//Tipos de datos locales al modulo
+//Texto que crece a medida que se le agregan mensajes
+typedef struct _TEXTO {
+  char *datos;                          //Texto acumulado (terminado en cero)
+  size_t usado;                         //Cantidad de caracteres del texto
+  size_t capacidad;                     //Tamaño del arreglo alojado
+} TEXTO;
+
+//Archivo fuente distinto del lote (su ensamblado lo comparten todos los trabajos que lo usan)
+typedef struct _FUENTE_LOTE {
+  const char *nombre;                   //Nombre del archivo de entrada
+  int nivel_optimizacion;               //Nivel de optimizacion que piden sus trabajos
+  bool recolectar;                      //Indica si sus trabajos piden la opcion -gc
+  int tam_prg;                          //Mayor capacidad de programa que piden sus trabajos
+  int tam_ram;                          //Mayor capacidad de RAM que piden sus trabajos
+  CONTEXTO_ASM *ctx;                    //Contexto con el resultado del ensamblado
+  bool exito;                           //Indica si el ensamblado fue exitoso
+  TEXTO mensajes;                       //Mensajes generados por el ensamblado
+  double segundos;                      //Tiempo que tomo el ensamblado
+} FUENTE_LOTE;
+
+//Trabajo del lote (una linea del manifiesto)
+typedef struct _TRABAJO {
+  char **argumentos;                    //Argumentos de la linea (apuntan al texto del manifiesto)
+  OPCIONES_ENSAMBLADO opciones;         //Opciones interpretadas
+  int fuente;                           //Indice del archivo fuente del trabajo
+  bool exito;                           //Indica si el trabajo fue exitoso
+  bool compartido;                      //Indica si se uso el ensamblado compartido
+  int instrucciones;                    //Cantidad de instrucciones generadas
+  int palabras;                         //Cantidad de palabras de RAM generadas
+  TEXTO mensajes;                       //Mensajes generados por el trabajo
+  double segundos;                      //Tiempo que tomo el trabajo
+} TRABAJO;
+
+//Estado de todo el lote (compartido por los hilos)
+typedef struct _LOTE {
+  TRABAJO *trabajos;                    //Trabajos en el orden del manifiesto
+  int num_trabajos;                     //Cantidad de trabajos
+  FUENTE_LOTE *fuentes;                 //Archivos fuente distintos
+  int num_fuentes;                      //Cantidad de archivos fuente distintos
+  void (*tarea)(struct _LOTE *lote, int indice); //Tarea de la fase actual
+  int num_tareas;                       //Cantidad de tareas de la fase actual
+  int siguiente;                        //Indice de la siguiente tarea pendiente
+  pthread_mutex_t candado;              //Protege el indice de la siguiente tarea
+} LOTE;
+
+//Declaracion previa de las funciones locales al modulo
+static char *leer_manifiesto(const char *nombre_manifiesto);
+static bool interpretar_manifiesto(LOTE *lote, const char *nombre_manifiesto, char *texto);
+static bool agregar_trabajo(LOTE *lote, char **argumentos, int num_argumentos);
+static int buscar_fuente(LOTE *lote, const OPCIONES_ENSAMBLADO *opciones);
+static void ejecutar_en_paralelo(LOTE *lote, void (*tarea)(LOTE *lote, int indice),
+                                 int num_tareas, int num_hilos);
+static void *hilo_de_trabajo(void *datos);
+static void ensamblar_fuente(LOTE *lote, int indice);
+static void ejecutar_trabajo(LOTE *lote, int indice);
+static bool ensamblar_archivo(CONTEXTO_ASM *ctx, int nivel_optimizacion, bool recolectar);
+static CONTEXTO_ASM *crear_contexto_lote(const char *nombre, int tam_prg, int tam_ram,
+                                         TEXTO *mensajes);
+static void agregar_texto(void *datos, const char *mensaje);
+static double tiempo_actual();
+static void liberar_lote(LOTE *lote);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion para ensamblar todos los trabajos de un manifiesto
+int ensamblar_lote(const char *nombre_manifiesto, int num_hilos) {
+  LOTE lote;
+  char *texto;
+  double inicio, segundos_fuentes = 0, segundos_trabajos = 0;
+  long instrucciones = 0;
+  int i, num_exitosos = 0;
+
+  //Lee el manifiesto completo (los argumentos de los trabajos apuntan a su texto)
+  texto = leer_manifiesto(nombre_manifiesto);
+  if (!texto) {
+    msg_lote_error_abrir_manifiesto(nombre_manifiesto);
+    return 1;
+  }
+
+  //Interpreta todos los trabajos antes de comenzar, de manera que un error en el manifiesto no
+  //deje el lote a medias
+  memset(&lote, 0, sizeof(LOTE));
+  if (!interpretar_manifiesto(&lote, nombre_manifiesto, texto)) {
+    liberar_lote(&lote);
+    free(texto);
+    return 1;
+  }
+
+  //Por omision se usa un hilo por cada procesador disponible
+  if (num_hilos < 1) num_hilos = sysconf(_SC_NPROCESSORS_ONLN);
+  if (num_hilos < 1) num_hilos = 1;
+  msg_lote_inicio(lote.num_trabajos, lote.num_fuentes, num_hilos);
+
+  //Primero se ensambla cada archivo fuente distinto y luego se ejecutan los trabajos
+  pthread_mutex_init(&lote.candado, NULL);
+  inicio = tiempo_actual();
+  ejecutar_en_paralelo(&lote, ensamblar_fuente, lote.num_fuentes, num_hilos);
+  ejecutar_en_paralelo(&lote, ejecutar_trabajo, lote.num_trabajos, num_hilos);
+  inicio = tiempo_actual() - inicio;
+  pthread_mutex_destroy(&lote.candado);
+
+  //Reporta el resultado de cada trabajo en el orden del manifiesto
+  for (i=0; i<lote.num_trabajos; i++) {
+    TRABAJO *trabajo = &lote.trabajos[i];
+
+    msg_lote_trabajo(i + 1, trabajo->opciones.nombre_archivo_ent, trabajo->opciones.tam_prg,
+                     trabajo->opciones.tam_ram, trabajo->exito, trabajo->compartido,
+                     trabajo->instrucciones, trabajo->palabras, trabajo->segundos);
+    if (trabajo->mensajes.usado) msg_lote_mensajes_trabajo(trabajo->mensajes.datos);
+    if (trabajo->exito) num_exitosos++;
+    instrucciones += trabajo->instrucciones;
+    segundos_trabajos += trabajo->segundos;
+  }
+  for (i=0; i<lote.num_fuentes; i++)
+    segundos_fuentes += lote.fuentes[i].segundos;
+
+  msg_lote_resumen(lote.num_trabajos, num_exitosos, lote.num_fuentes, inicio, segundos_fuentes,
+                   segundos_trabajos, instrucciones);
+
+  liberar_lote(&lote);
+  free(texto);
+  return num_exitosos == lote.num_trabajos ? 0 : 1;
+}
+
+//+-------------------------------------+
+//| Interpretacion del manifiesto       |
+//+-------------------------------------+----------------------------------------------------------
+//Funcion para leer todo el manifiesto a memoria (retorna NULL si no se puede leer)
+static char *leer_manifiesto(const char *nombre_manifiesto) {
+  FILE *fp_archivo;
+  char *texto = NULL;
+  size_t usado = 0, capacidad = 0, leidos;
+
+  fp_archivo = fopen(nombre_manifiesto, "r");
+  if (!fp_archivo) return NULL;
+
+  do {
+    //Duplica el buffer cada vez que se llena (siempre queda lugar para el cero final)
+    if (capacidad - usado < 4096) {
+      capacidad = capacidad ? capacidad * 2 : 65536;
+      texto = realloc(texto, capacidad);
+    }
+    leidos = fread(texto + usado, 1, capacidad - usado - 1, fp_archivo);
+    usado += leidos;
+  } while (leidos);
+
+  fclose(fp_archivo);
+  texto[usado] = '\0';
+  return texto;
+}
+
+//Funcion para interpretar cada linea del manifiesto como un trabajo. Los argumentos se separan
+//por espacios y el texto desde un # hasta el final de la linea se ignora
+static bool interpretar_manifiesto(LOTE *lote, const char *nombre_manifiesto, char *texto) {
+  char *linea, *fin_linea, *c;
+  char **argumentos;
+  int num_argumentos;
+  int num_lin = 0;
+
+  for (linea = texto; *linea; linea = fin_linea + 1) {
+    //Delimita la linea actual
+    num_lin++;
+    fin_linea = strchr(linea, '\n');
+    if (!fin_linea) fin_linea = linea + strlen(linea) - 1;   //La ultima linea no tiene fin
+    else *fin_linea = '\0';
+
+    //Separa los argumentos (como mucho hay uno por cada dos caracteres de la linea)
+    argumentos = malloc((strlen(linea) / 2 + 1) * sizeof(char *));
+    num_argumentos = 0;
+    for (c = linea; *c && *c != '#';) {
+      if (*c == ' ' || *c == '\t' || *c == '\r') {
+        *c++ = '\0';
+        continue;
+      }
+      argumentos[num_argumentos++] = c;
+      while (*c && *c != ' ' && *c != '\t' && *c != '\r' && *c != '#') c++;
+    }
+    *c = '\0';                          //Descarta el comentario
+
+    //Las lineas sin argumentos no generan trabajos
+    if (!num_argumentos) {
+      free(argumentos);
+      continue;
+    }
+
+    if (!agregar_trabajo(lote, argumentos, num_argumentos)) {
+      msg_lote_error_linea(nombre_manifiesto, num_lin);
+      return false;
+    }
+  }
+
+  if (!lote->num_trabajos) {
+    msg_lote_vacio(nombre_manifiesto);
+    return false;
+  }
+  return true;
+}
+
+//Funcion para agregar un trabajo al lote a partir de sus argumentos (toma posesion del arreglo)
+static bool agregar_trabajo(LOTE *lote, char **argumentos, int num_argumentos) {
+  TRABAJO *trabajo;
+  FUENTE_LOTE *fuente;
+  int indice;
+
+  //Agrega el trabajo al final del arreglo (crece de a potencias de 2)
+  if (!(lote->num_trabajos & (lote->num_trabajos - 1)))
+    lote->trabajos = realloc(lote->trabajos,
+                             (lote->num_trabajos ? lote->num_trabajos * 2 : 1) * sizeof(TRABAJO));
+  trabajo = &lote->trabajos[lote->num_trabajos++];
+  memset(trabajo, 0, sizeof(TRABAJO));
+  trabajo->argumentos = argumentos;
+
+  if (!interpretar_opciones(&trabajo->opciones, num_argumentos, argumentos)) return false;
+
+  //Los trabajos solo ensamblan: crear objetos o enlazar requiere varias invocaciones encadenadas
+  if (trabajo->opciones.nombre_archivo_obj) {
+    msg_lote_opcion_no_permitida("-o");
+    return false;
+  }
+  if (trabajo->opciones.num_objetos || es_archivo_objeto(trabajo->opciones.nombre_archivo_ent)) {
+    msg_lote_opcion_no_permitida("-l");
+    return false;
+  }
+
+  //El listado requiere la lista de simbolos, la cual no se conserva en los ensamblados compartidos
+  if (trabajo->opciones.nombre_archivo_lst) {
+    msg_lote_opcion_no_permitida("-lst");
+    return false;
+  }
+
+  //Las mediciones de un trabajo se mezclarian con las del ensamblado compartido y las de los
+  //demas hilos
+  if (trabajo->opciones.estadisticas || trabajo->opciones.nombre_archivo_json) {
+    msg_lote_opcion_no_permitida(trabajo->opciones.estadisticas ? "-stats" : "-stats-json");
+    return false;
+  }
+
+  //El mapa requiere la lista de simbolos, y la capacidad automatica la reduccion del ensamblado,
+  //ninguno de los cuales se conserva en los ensamblados compartidos
+  if (trabajo->opciones.nombre_archivo_map) {
+    msg_lote_opcion_no_permitida("-map");
+    return false;
+  }
+
+  //El perfil de ejecucion reordena el programa, el cual se comparte entre los trabajos con el
+  //mismo archivo de entrada
+  if (trabajo->opciones.nombre_archivo_perfil) {
+    msg_lote_opcion_no_permitida("-prof");
+    return false;
+  }
+
+  //El MEM incremental depende del estado que dejo la invocacion anterior, el cual no se comparte
+  //entre trabajos
+  if (trabajo->opciones.nombre_archivo_mdelta) {
+    msg_lote_opcion_no_permitida("-mdelta");
+    return false;
+  }
+  if (trabajo->opciones.tam_prg == CAPACIDAD_AUTOMATICA ||
+      trabajo->opciones.tam_ram == CAPACIDAD_AUTOMATICA) {
+    msg_lote_opcion_no_permitida(trabajo->opciones.tam_prg == CAPACIDAD_AUTOMATICA ?
+                                 "-p auto" : "-r auto");
+    return false;
+  }
+
+  //El lote termina cuando terminan sus trabajos, asi que no puede quedarse vigilando
+  if (trabajo->opciones.vigilar) {
+    msg_lote_opcion_no_permitida("-watch");
+    return false;
+  }
+
+  //Los trabajos con el mismo archivo de entrada comparten su ensamblado, el cual se hace con las
+  //mayores capacidades que se piden
+  indice = buscar_fuente(lote, &trabajo->opciones);
+  fuente = &lote->fuentes[indice];
+  if (fuente->tam_prg < trabajo->opciones.tam_prg) fuente->tam_prg = trabajo->opciones.tam_prg;
+  if (fuente->tam_ram < trabajo->opciones.tam_ram) fuente->tam_ram = trabajo->opciones.tam_ram;
+  trabajo->fuente = indice;
+  return true;
+}
+
+//Funcion que obtiene el indice del archivo fuente del lote que puede compartir un trabajo con
+//las opciones indicadas (lo agrega si no existe). La optimizacion y la recoleccion dependen de
+//la capacidad de programa, por lo que en ese caso tambien debe coincidir. Los trabajos guardan el
+//indice, ya que el arreglo se puede mover al crecer
+static int buscar_fuente(LOTE *lote, const OPCIONES_ENSAMBLADO *opciones) {
+  FUENTE_LOTE *fuente;
+  int i;
+
+  for (i=0; i<lote->num_fuentes; i++) {
+    fuente = &lote->fuentes[i];
+    if (strcmp(fuente->nombre, opciones->nombre_archivo_ent) == 0 &&
+        fuente->nivel_optimizacion == opciones->nivel_optimizacion &&
+        fuente->recolectar == opciones->recolectar &&
+        ((!opciones->nivel_optimizacion && !opciones->recolectar) ||
+         fuente->tam_prg == opciones->tam_prg))
+      return i;
+  }
+
+  if (!(lote->num_fuentes & (lote->num_fuentes - 1)))
+    lote->fuentes = realloc(lote->fuentes,
+                            (lote->num_fuentes ? lote->num_fuentes * 2 : 1) * sizeof(FUENTE_LOTE));
+  memset(&lote->fuentes[lote->num_fuentes], 0, sizeof(FUENTE_LOTE));
+  lote->fuentes[lote->num_fuentes].nombre = opciones->nombre_archivo_ent;
+  lote->fuentes[lote->num_fuentes].nivel_optimizacion = opciones->nivel_optimizacion;
+  lote->fuentes[lote->num_fuentes].recolectar = opciones->recolectar;
+  return lote->num_fuentes++;
+}
+
+
+//+-------------------------------------+
+//| Ejecucion en paralelo               |
+//+-------------------------------------+----------------------------------------------------------
+//Funcion para ejecutar todas las tareas de una fase repartidas entre los hilos (el hilo actual
+//tambien trabaja). Regresa cuando todas las tareas terminaron
+static void ejecutar_en_paralelo(LOTE *lote, void (*tarea)(LOTE *lote, int indice),
+                                 int num_tareas, int num_hilos) {
+  pthread_t hilos[num_hilos];
+  int i, creados = 0;
+
+  lote->tarea = tarea;
+  lote->num_tareas = num_tareas;
+  lote->siguiente = 0;
+
+  //No tiene sentido crear mas hilos que tareas
+  if (num_hilos > num_tareas) num_hilos = num_tareas;
+  for (i=1; i<num_hilos; i++)
+    if (pthread_create(&hilos[creados], NULL, hilo_de_trabajo, lote) == 0) creados++;
+
+  hilo_de_trabajo(lote);
+  for (i=0; i<creados; i++)
+    pthread_join(hilos[i], NULL);
+}
+
+//Funcion que ejecuta cada hilo: toma la siguiente tarea pendiente hasta que no queden mas
+static void *hilo_de_trabajo(void *datos) {
+  LOTE *lote = datos;
+  int indice;
+
+  while (1) {
+    pthread_mutex_lock(&lote->candado);
+    indice = lote->siguiente++;
+    pthread_mutex_unlock(&lote->candado);
+    if (indice >= lote->num_tareas) return NULL;
+    lote->tarea(lote, indice);
+  }
+}
+
+//Tarea de la fase de fuentes: ensambla un archivo fuente distinto con las mayores capacidades
+//que piden sus trabajos
+static void ensamblar_fuente(LOTE *lote, int indice) {
+  FUENTE_LOTE *fuente = &lote->fuentes[indice];
+  double inicio = tiempo_actual();
+
+  fuente->ctx = crear_contexto_lote(fuente->nombre, fuente->tam_prg, fuente->tam_ram,
+                                    &fuente->mensajes);
+  fuente->exito = ensamblar_archivo(fuente->ctx, fuente->nivel_optimizacion, fuente->recolectar);
+  fuente->segundos = tiempo_actual() - inicio;
+}
+
+//Tarea de la fase de trabajos: obtiene la imagen de memoria del trabajo (del ensamblado
+//compartido o ensamblando aparte) y genera sus salidas
+static void ejecutar_trabajo(LOTE *lote, int indice) {
+  TRABAJO *trabajo = &lote->trabajos[indice];
+  FUENTE_LOTE *fuente = &lote->fuentes[trabajo->fuente];
+  CONTEXTO_ASM *ctx;                  //Contexto del trabajo (con sus propias capacidades)
+  CONTEXTO_ASM *ensamblado;           //Contexto donde se ensamblo el archivo fuente
+  const FORMATO_SALIDA *formatos[MAX_SALIDAS];  //Formatos de las salidas solicitadas
+  const char *nombres[MAX_SALIDAS];             //Nombres de los archivos de salida
+  int num_salidas;                    //Cantidad de archivos de salida solicitados
+  const char **requisitos;            //Archivos de los que dependen las salidas (para -MD)
+  int num_requisitos;                 //Cantidad de archivos de los que dependen las salidas
+  double inicio = tiempo_actual();
+
+  ctx = crear_contexto_lote(fuente->nombre, trabajo->opciones.tam_prg,
+                            trabajo->opciones.tam_ram, &trabajo->mensajes);
+
+  //El ensamblado compartido sirve si todo lo que genero cabe en las memorias del trabajo
+  if (fuente->exito && ultima_localidad_prg(&fuente->ctx->imagen) < ctx->tam_prg &&
+      ultima_localidad_ram(&fuente->ctx->imagen) < ctx->tam_ram) {
+    copiar_imagen(&ctx->imagen, &fuente->ctx->imagen);
+    if (fuente->mensajes.usado) agregar_texto(&trabajo->mensajes, fuente->mensajes.datos);
+    ensamblado = fuente->ctx;
+    trabajo->compartido = true;
+    trabajo->exito = true;
+  }
+  //Si el ensamblado compartido fallo con las mismas capacidades, el trabajo falla igual
+  else if (!fuente->exito && fuente->tam_prg == ctx->tam_prg && fuente->tam_ram == ctx->tam_ram) {
+    if (fuente->mensajes.usado) agregar_texto(&trabajo->mensajes, fuente->mensajes.datos);
+    trabajo->compartido = true;
+    trabajo->exito = false;
+  }
+  //En cualquier otro caso se ensambla aparte con las capacidades del trabajo
+  else {
+    ensamblado = ctx;
+    trabajo->exito = ensamblar_archivo(ctx, trabajo->opciones.nivel_optimizacion,
+                                       trabajo->opciones.recolectar);
+  }
+
+  if (trabajo->exito) {
+    //Las salidas dependen del archivo de entrada y de todos los que se incluyeron
+    requisitos = obtener_fuentes(&ensamblado->registro_fuentes, &num_requisitos);
+
+    //Genera las salidas en una sola pasada y, si se solicito, el archivo de dependencias
+    num_salidas = listar_salidas(&trabajo->opciones, formatos, nombres);
+    if (num_salidas && !generar_salidas(ctx, formatos, nombres, num_salidas))
+      trabajo->exito = false;
+    else if (trabajo->opciones.nombre_archivo_dep &&
+             !escribir_dependencias(ctx, trabajo->opciones.nombre_archivo_dep, nombres,
+                                    num_salidas, requisitos, num_requisitos))
+      trabajo->exito = false;
+
+    trabajo->instrucciones = contar_localidades_prg(&ctx->imagen);
+    trabajo->palabras = contar_localidades_ram(&ctx->imagen);
+  }
+
+  destruir_contexto(ctx);
+  trabajo->segundos = tiempo_actual() - inicio;
+}
+
+//Funcion que ensambla (pasos 1 y 2) el archivo de entrada de un contexto y, si se pide, elimina
+//lo inalcanzable y optimiza la memoria de programa
+static bool ensamblar_archivo(CONTEXTO_ASM *ctx, int nivel_optimizacion, bool recolectar) {
+  FILE *fp_archivo;
+  bool exito;
+  ESTADISTICAS_OPTIMIZACION estadisticas;
+  ESTADISTICAS_RECOLECCION recoleccion;
+
+  fp_archivo = fopen(ctx->nombre_archivo_ent, "r");
+  if (!fp_archivo) {
+    msg_error_abrir_archivo_entrada(ctx);
+    return false;
+  }
+
+  ctx->info_recoleccion.registrar = recolectar;
+  exito = proceso_paso_1(ctx, fp_archivo);
+  fclose(fp_archivo);
+  if (!exito || !proceso_paso_2(ctx)) return false;
+  if (recolectar && !recolectar_basura(ctx, ctx->nombre_archivo_ent, &recoleccion)) return false;
+  if (nivel_optimizacion) optimizar_programa(ctx, &estadisticas);
+
+  //Una vez terminado el paso 2, la lista de simbolos y la cola de acciones ya no son necesarias
+  desalojar_simbolos(&ctx->lista_simbolos);
+  desalojar_acciones(&ctx->cola_acciones);
+  return true;
+}
+
+//+-------------------------------------+
+//| Funciones auxiliares                |
+//+-------------------------------------+----------------------------------------------------------
+//Funcion para crear un contexto cuyos mensajes se acumulan en un texto
+static CONTEXTO_ASM *crear_contexto_lote(const char *nombre, int tam_prg, int tam_ram,
+                                         TEXTO *mensajes) {
+  CONTEXTO_ASM *ctx = crear_contexto(tam_prg, tam_ram);
+
+  ctx->reportar = agregar_texto;
+  ctx->datos_reporte = mensajes;
+  snprintf(ctx->nombre_archivo_ent, sizeof(ctx->nombre_archivo_ent), "%s", nombre);
+  return ctx;
+}
+
+//Funcion de reporte que agrega un mensaje al final de un texto
+static void agregar_texto(void *datos, const char *mensaje) {
+  TEXTO *texto = datos;
+  size_t longitud = strlen(mensaje);
+
+  if (texto->usado + longitud + 1 > texto->capacidad) {
+    texto->capacidad = (texto->usado + longitud + 1) * 2;
+    texto->datos = realloc(texto->datos, texto->capacidad);
+  }
+  memcpy(texto->datos + texto->usado, mensaje, longitud + 1);
+  texto->usado += longitud;
+}
+
+//Funcion para obtener el tiempo actual en segundos
+static double tiempo_actual() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//Funcion para liberar todo lo que se aloja para el lote
+static void liberar_lote(LOTE *lote) {
+  int i;
+
+  for (i=0; i<lote->num_trabajos; i++) {
+    liberar_opciones(&lote->trabajos[i].opciones);
+    free(lote->trabajos[i].argumentos);
+    free(lote->trabajos[i].mensajes.datos);
+  }
+  for (i=0; i<lote->num_fuentes; i++) {
+    if (lote->fuentes[i].ctx) destruir_contexto(lote->fuentes[i].ctx);
+    free(lote->fuentes[i].mensajes.datos);
+  }
+  free(lote->trabajos);
+  free(lote->fuentes);
+}
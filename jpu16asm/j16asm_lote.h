@@ -0,0 +1,10 @@
+#ifndef j16asm_lote_h_Incluida
+#define j16asm_lote_h_Incluida
+
+//Funciones exportadas
+//--------------------
+//Funcion para ensamblar todos los trabajos de un manifiesto (con cero hilos se usa uno por cada
+//procesador disponible). Retorna el codigo de salida del programa
+extern int ensamblar_lote(const char *nombre_manifiesto, int num_hilos);
+
+#endif //j16asm_lote_h_Incluida
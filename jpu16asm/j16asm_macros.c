@@ -0,0 +1,362 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_macros.c                                                                               |
+//| Modulo de macros y repeticiones                                                               |
+//|                                                                                               |
+//| Este modulo implementa las directivas macro y rept, las cuales permiten generar secuencias de |
+//| codigo parametrizadas y desenrollar lazos al ensamblar:                                       |
+//|   macro nombre param1, param2        rept 4                                                   |
+//|     ...                                ...                                                    |
+//|   endm                               endm                                                     |
+//| Ambas directivas se cierran con endm y pueden anidarse. El analizador lexico entrega el       |
+//| cuerpo como un solo texto sin analizar, el cual se guarda en la tabla de macros (o se expande |
+//| de inmediato en el caso de rept). Invocar una macro (su nombre seguido de los argumentos      |
+//| separados por comas) genera el texto del cuerpo con cada parametro sustituido por su          |
+//| argumento, el cual el analizador sintactico entrega al analizador lexico de la misma forma    |
+//| que un archivo incluido. Una repeticion genera el cuerpo una vez por cada vuelta. Las lineas  |
+//| expandidas conservan el archivo y el numero de linea que tienen en la definicion, por lo que  |
+//| los mensajes de error y el listado (-lst) se refieren al cuerpo.                              |
+//|                                                                                               |
+//| Nota acerca de las etiquetas locales                                                          |
+//| Dentro del cuerpo, un nombre precedido de @ (p. ej. @sigue) es local a cada expansion: se     |
+//| sustituye por el nombre seguido de dos guiones bajos y el numero de la expansion (sigue__3),  |
+//| de manera que el cuerpo puede definir etiquetas aunque se expanda varias veces. Los nombres   |
+//| de este tipo dentro de una directiva macro o rept anidada quedan para cuando esta se expanda. |
+//| Los comentarios, las cadenas y los caracteres se copian sin cambios.                          |
+//+-----------------------------------------------------------------------------------------------+
+#include <ctype.h>                      //Permite clasificar caracteres
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdio.h>                      //Permite invocar snprintf
+#include <stdlib.h>                     //Permite invocar malloc, realloc y free
+#include <string.h>                     //Permite manejar cadenas
+#include <strings.h>                    //Permite comparar cadenas sin distinguir mayusculas
+#include "j16asm_macros.h"              //Cabecera propia
+#include "j16asm.h"                     //Importa el contexto de ensamblado
+#include "j16asm_arena.h"               //Permite alojar memoria en arenas
+#include "j16asm_instrucciones.h"       //Permite verificar que el nombre no sea una instruccion
+#include "j16asm_messages.h"            //Permite enviar mensajes al usuario
+
+//Directivas cuyo nombre no puede tener una macro (el analizador lexico las reconoce primero)
+static const char *const directivas[] = {
+  "data", "code", "word", "equ", "public", "include", "macro", "rept", "endm", "fill", "incbin",
+  "inchex", "table"
+};
+
+//Estructura con un texto que crece a medida que se genera
+typedef struct _TEXTO {
+  char *datos;                          //Contenido (terminado en nulo)
+  int tam;                              //Cantidad de caracteres
+  int capacidad;                        //Cantidad de caracteres que caben en el arreglo actual
+} TEXTO;
+
+//Estructura con un fragmento de otro texto (p. ej. un argumento de una invocacion)
+typedef struct _FRAGMENTO {
+  const char *inicio;                   //Primer caracter
+  int longitud;                         //Cantidad de caracteres
+} FRAGMENTO;
+
+//Declaracion previa de las funciones locales al modulo
+static const char *saltar_espacios(const char *texto);
+static int longitud_nombre(const char *texto);
+static bool es_nombre_reservado(const char *nombre, int longitud);
+static const char *copiar_nombre(ARENA *arena, const char *nombre, int longitud);
+static int separar_argumentos(const char *argumentos, FRAGMENTO *lista);
+static int buscar_parametro(const MACRO *macro, const char *nombre, int longitud);
+static char *generar_expansion(TABLA_MACROS *tabla, const char *cuerpo, const MACRO *macro,
+                               const FRAGMENTO *argumentos, int *tam);
+static void agregar_texto(TEXTO *texto, const char *datos, int tam);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion para definir una macro a partir del texto que sigue a la directiva macro (su nombre y
+//sus parametros separados por comas) y de su cuerpo
+bool definir_macro(CONTEXTO_ASM *ctx, const char *cabecera, const char *cuerpo) {
+  TABLA_MACROS *tabla = &ctx->tabla_macros;
+  MACRO *macro;
+  const char *texto;
+  int longitud;
+
+  //El nombre no puede coincidir con el de una instruccion, un registro o una directiva, porque el
+  //analizador lexico los reconoce antes que a las macros
+  texto = saltar_espacios(cabecera);
+  longitud = longitud_nombre(texto);
+  if (!longitud || es_nombre_reservado(texto, longitud)) {
+    msg_definicion_macro_invalida(ctx, ctx->num_lin);
+    return false;
+  }
+
+  macro = arena_alojar(&tabla->arena, sizeof(MACRO));
+  macro->nombre = copiar_nombre(&tabla->arena, texto, longitud);
+  macro->num_parametros = 0;
+  if (buscar_macro(tabla, macro->nombre)) {
+    msg_macro_redefinida(ctx, ctx->num_lin, macro->nombre);
+    return false;
+  }
+
+  //Lee la lista de parametros (puede estar vacia)
+  texto = saltar_espacios(texto + longitud);
+  while (*texto) {
+    longitud = longitud_nombre(texto);
+    if (!longitud || macro->num_parametros == MAX_PARAMETROS_MACRO) {
+      msg_definicion_macro_invalida(ctx, ctx->num_lin);
+      return false;
+    }
+    macro->parametros[macro->num_parametros++] = copiar_nombre(&tabla->arena, texto, longitud);
+    texto = saltar_espacios(texto + longitud);
+    if (*texto == ',') {
+      texto = saltar_espacios(texto + 1);
+      if (!*texto) longitud = 0;          //Falta el parametro que sigue a la coma
+    } else if (*texto)
+      longitud = 0;                       //Sobra algo despues del parametro
+    if (!longitud) {
+      msg_definicion_macro_invalida(ctx, ctx->num_lin);
+      return false;
+    }
+  }
+
+  macro->cuerpo = arena_duplicar_cadena(&tabla->arena, cuerpo);
+  macro->fuente = ctx->fuente_actual;
+  macro->num_lin = ctx->num_lin;
+
+  if (tabla->cantidad == tabla->capacidad) {
+    tabla->capacidad = tabla->capacidad ? tabla->capacidad * 2 : 8;
+    tabla->macros = realloc(tabla->macros, tabla->capacidad * sizeof(MACRO *));
+    contar_alojamiento(tabla->capacidad * sizeof(MACRO *));
+  }
+  tabla->macros[tabla->cantidad++] = macro;
+  return true;
+}
+
+//Funcion para buscar una macro por su nombre (distingue mayusculas como los simbolos). Regresa
+//NULL si no esta definida
+MACRO *buscar_macro(TABLA_MACROS *tabla, const char *nombre) {
+  int i;
+
+  for (i=0; i<tabla->cantidad; i++)
+    if (strcmp(tabla->macros[i]->nombre, nombre) == 0) return tabla->macros[i];
+  return NULL;
+}
+
+//Funcion para guardar el cuerpo de una repeticion mientras se expanden sus vueltas
+const char *guardar_cuerpo(TABLA_MACROS *tabla, const char *cuerpo) {
+  return arena_duplicar_cadena(&tabla->arena, cuerpo);
+}
+
+//Funcion para desalojar de una sola vez la tabla de macros
+void desalojar_macros(TABLA_MACROS *tabla) {
+  free(tabla->macros);
+  arena_liberar(&tabla->arena);
+  tabla->macros = NULL;
+  tabla->cantidad = 0;
+  tabla->capacidad = 0;
+  tabla->num_expansiones = 0;
+}
+
+//Funcion que genera el texto de una invocacion de macro. Los argumentos se separan por comas
+//(salvo dentro de parentesis, corchetes o comillas) y deben ser tantos como los parametros.
+//Regresa NULL si la cantidad no coincide
+char *expandir_macro(CONTEXTO_ASM *ctx, MACRO *macro, const char *argumentos, int *tam) {
+  FRAGMENTO lista[MAX_PARAMETROS_MACRO];
+  int cantidad = separar_argumentos(argumentos, lista);
+
+  if (cantidad != macro->num_parametros) {
+    msg_argumentos_macro(ctx, ctx->num_lin, macro->nombre, macro->num_parametros, cantidad);
+    return NULL;
+  }
+  return generar_expansion(&ctx->tabla_macros, macro->cuerpo, macro, lista, tam);
+}
+
+//Funcion que genera el texto de una vuelta de una repeticion
+char *expandir_repeticion(TABLA_MACROS *tabla, const char *cuerpo, int *tam) {
+  return generar_expansion(tabla, cuerpo, NULL, NULL, tam);
+}
+
+//Funcion que indica si una linea abre un bloque (directivas macro y rept, regresa 1), si lo
+//cierra (directiva endm, regresa -1) o ninguna de las dos (regresa 0)
+int cambio_nivel_bloque(const char *linea, size_t tam) {
+  const char *fin = linea + tam;
+  int longitud = 0;
+
+  while (linea < fin && (*linea == ' ' || *linea == '\t')) linea++;
+  while (linea + longitud < fin && (isalnum((unsigned char) linea[longitud]) ||
+                                    linea[longitud] == '_'))
+    longitud++;
+
+  if ((longitud == 5 && strncasecmp(linea, "macro", 5) == 0) ||
+      (longitud == 4 && strncasecmp(linea, "rept", 4) == 0))
+    return 1;
+  if (longitud == 4 && strncasecmp(linea, "endm", 4) == 0) return -1;
+  return 0;
+}
+
+//Funcion que cuenta las lineas de un texto (los fines de linea que contiene)
+int contar_lineas(const char *texto) {
+  int cantidad = 0;
+
+  for (; *texto; texto++)
+    if (*texto == '\n') cantidad++;
+  return cantidad;
+}
+
+//Funcion que salta los espacios y tabuladores al inicio de un texto
+static const char *saltar_espacios(const char *texto) {
+  while (*texto == ' ' || *texto == '\t') texto++;
+  return texto;
+}
+
+//Funcion que obtiene la longitud del nombre (con la forma de un simbolo) al inicio de un texto,
+//o 0 si el texto no inicia con un nombre
+static int longitud_nombre(const char *texto) {
+  int longitud = 0;
+
+  if (!isalpha((unsigned char) *texto) && *texto != '_') return 0;
+  while (isalnum((unsigned char) texto[longitud]) || texto[longitud] == '_') longitud++;
+  return longitud;
+}
+
+//Funcion que indica si un nombre es el de una instruccion, un registro o una directiva
+static bool es_nombre_reservado(const char *nombre, int longitud) {
+  size_t i;
+
+  if (buscar_mnemonico(nombre, longitud) >= 0) return true;
+  if ((nombre[0] == 'r' || nombre[0] == 'R') &&
+      ((longitud == 2 && isdigit((unsigned char) nombre[1])) ||
+       (longitud == 3 && nombre[1] == '1' && nombre[2] >= '0' && nombre[2] <= '5')))
+    return true;
+  for (i=0; i<sizeof(directivas) / sizeof(directivas[0]); i++)
+    if ((int) strlen(directivas[i]) == longitud &&
+        strncasecmp(directivas[i], nombre, longitud) == 0)
+      return true;
+  return false;
+}
+
+//Funcion que copia un nombre (que no termina en nulo) a la arena
+static const char *copiar_nombre(ARENA *arena, const char *nombre, int longitud) {
+  char *copia = arena_alojar(arena, longitud + 1);
+
+  memcpy(copia, nombre, longitud);
+  copia[longitud] = '\0';
+  return copia;
+}
+
+//Funcion que separa los argumentos de una invocacion (sin los espacios que los rodean) y regresa
+//su cantidad. Solo se guardan los primeros MAX_PARAMETROS_MACRO, pero se cuentan todos
+static int separar_argumentos(const char *argumentos, FRAGMENTO *lista) {
+  const char *inicio, *fin;
+  int cantidad = 0, anidamiento = 0;
+  char comilla = '\0';
+
+  if (!argumentos || !*saltar_espacios(argumentos)) return 0;
+
+  for (inicio = fin = argumentos; ; fin++) {
+    if (comilla) {
+      if (*fin == comilla) comilla = '\0';
+      if (*fin) continue;
+    }
+    if (*fin == '"' || *fin == '\'') comilla = *fin;
+    else if (*fin == '(' || *fin == '[') anidamiento++;
+    else if ((*fin == ')' || *fin == ']') && anidamiento) anidamiento--;
+    else if ((*fin == ',' && !anidamiento) || !*fin) {
+      //Termina el argumento actual, quitando los espacios que lo rodean
+      if (cantidad < MAX_PARAMETROS_MACRO) {
+        inicio = saltar_espacios(inicio);
+        lista[cantidad].inicio = inicio;
+        lista[cantidad].longitud = fin - inicio;
+        while (lista[cantidad].longitud && (inicio[lista[cantidad].longitud - 1] == ' ' ||
+                                            inicio[lista[cantidad].longitud - 1] == '\t'))
+          lista[cantidad].longitud--;
+      }
+      cantidad++;
+      if (!*fin) break;
+      inicio = fin + 1;
+    }
+  }
+  return cantidad;
+}
+
+//Funcion que busca un nombre entre los parametros de una macro y regresa su indice (-1 si no es
+//un parametro)
+static int buscar_parametro(const MACRO *macro, const char *nombre, int longitud) {
+  int i;
+
+  for (i=0; i<macro->num_parametros; i++)
+    if (strncmp(macro->parametros[i], nombre, longitud) == 0 &&
+        macro->parametros[i][longitud] == '\0')
+      return i;
+  return -1;
+}
+
+//Funcion que genera el texto de una expansion: copia el cuerpo sustituyendo los parametros de la
+//macro (si la hay) por sus argumentos y los nombres locales (@nombre) por nombre__N, donde N es el
+//numero de la expansion. Los nombres locales de los bloques anidados no se sustituyen
+static char *generar_expansion(TABLA_MACROS *tabla, const char *cuerpo, const MACRO *macro,
+                               const FRAGMENTO *argumentos, int *tam) {
+  TEXTO texto = { NULL, 0, 0 };
+  char sufijo[16];              //Sufijo de los nombres locales de esta expansion
+  int longitud_sufijo;
+  const char *linea, *fin_linea, *p, *fin;
+  int nivel = 0, cambio, longitud, parametro;
+
+  longitud_sufijo = snprintf(sufijo, sizeof(sufijo), "__%i", ++tabla->num_expansiones);
+  agregar_texto(&texto, "", 0);  //Aloja el texto aunque el cuerpo este vacio
+
+  for (linea = cuerpo; *linea; linea = fin_linea) {
+    fin_linea = strchr(linea, '\n');
+    fin_linea = fin_linea ? fin_linea + 1 : linea + strlen(linea);
+    cambio = cambio_nivel_bloque(linea, fin_linea - linea);
+    if (cambio < 0) nivel--;    //La directiva endm ya no es parte del bloque que cierra
+
+    for (p = linea; p < fin_linea; ) {
+      if (*p == ';') {
+        //Los comentarios se copian sin cambios hasta el final de la linea
+        agregar_texto(&texto, p, fin_linea - p);
+        break;
+      }
+      if (*p == '"' || *p == '\'') {
+        //Las cadenas y los caracteres se copian hasta la comilla que los cierra
+        for (fin = p + 1; fin < fin_linea && *fin != *p && *fin != '\n'; fin++);
+        if (fin < fin_linea && *fin == *p) fin++;
+        agregar_texto(&texto, p, fin - p);
+        p = fin;
+      } else if (isdigit((unsigned char) *p)) {
+        //Los numeros se copian completos (p. ej. 0x1F no contiene el nombre x1F)
+        for (fin = p; fin < fin_linea && (isalnum((unsigned char) *fin) || *fin == '_'); fin++);
+        agregar_texto(&texto, p, fin - p);
+        p = fin;
+      } else if ((longitud = longitud_nombre(p))) {
+        //Un parametro se sustituye por su argumento, cualquier otro nombre queda igual
+        parametro = macro ? buscar_parametro(macro, p, longitud) : -1;
+        if (parametro >= 0)
+          agregar_texto(&texto, argumentos[parametro].inicio, argumentos[parametro].longitud);
+        else
+          agregar_texto(&texto, p, longitud);
+        p += longitud;
+      } else if (*p == '@' && !nivel && (longitud = longitud_nombre(p + 1))) {
+        //Un nombre local recibe el sufijo de la expansion
+        agregar_texto(&texto, p + 1, longitud);
+        agregar_texto(&texto, sufijo, longitud_sufijo);
+        p += longitud + 1;
+      } else {
+        agregar_texto(&texto, p, 1);
+        p++;
+      }
+    }
+    if (cambio > 0) nivel++;
+  }
+
+  *tam = texto.tam;
+  return texto.datos;
+}
+
+//Funcion que agrega caracteres al final de un texto (el cual queda terminado en nulo)
+static void agregar_texto(TEXTO *texto, const char *datos, int tam) {
+  if (texto->tam + tam + 1 > texto->capacidad) {
+    while (texto->tam + tam + 1 > texto->capacidad)
+      texto->capacidad = texto->capacidad ? texto->capacidad * 2 : 256;
+    texto->datos = realloc(texto->datos, texto->capacidad);
+    contar_alojamiento(texto->capacidad);
+  }
+  memcpy(&texto->datos[texto->tam], datos, tam);
+  texto->tam += tam;
+  texto->datos[texto->tam] = '\0';
+}
@@ -0,0 +1,56 @@
+#ifndef j16asm_macros_h_Incluida
+#define j16asm_macros_h_Incluida
+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stddef.h>                     //Incluye la definicion del tipo de dato size_t
+#include "j16asm_arena.h"               //Incluye la definicion de las arenas de memoria
+
+//Constantes exportadas
+//---------------------
+#define MAX_PARAMETROS_MACRO 16         //Cantidad maxima de parametros de una macro
+
+//Tipos de datos exportados
+//-------------------------
+//Estructura con la definicion de una macro
+typedef struct _MACRO {
+  const char *nombre;                   //Nombre con el que se invoca
+  const char *parametros[MAX_PARAMETROS_MACRO];  //Nombres de los parametros
+  int num_parametros;                   //Cantidad de parametros
+  const char *cuerpo;                   //Lineas del cuerpo (sin la directiva endm)
+  int fuente;                           //Indice del archivo donde se define
+  int num_lin;                          //Linea de la directiva macro
+} MACRO;
+
+//Estructura con las macros definidas en un ensamblado
+typedef struct _TABLA_MACROS {
+  MACRO **macros;                       //Macros en el orden de su definicion
+  int cantidad;                         //Cantidad de macros definidas
+  int capacidad;                        //Cantidad de macros que caben en el arreglo actual
+  int num_expansiones;                  //Expansiones generadas (distinguen las etiquetas locales)
+  ARENA arena;                          //Arena donde se guardan las macros y los cuerpos
+} TABLA_MACROS;
+
+//Inicializador de la tabla vacia
+#define TABLA_MACROS_VACIA { NULL, 0, 0, 0, ARENA_VACIA(4096) }
+
+//Declaracion previa del contexto de ensamblado (definido en j16asm.h)
+struct _CONTEXTO_ASM;
+
+//Funciones exportadas
+//--------------------
+//Funciones asociadas a la tabla de macros
+extern bool definir_macro(struct _CONTEXTO_ASM *ctx, const char *cabecera, const char *cuerpo);
+extern MACRO *buscar_macro(TABLA_MACROS *tabla, const char *nombre);
+extern const char *guardar_cuerpo(TABLA_MACROS *tabla, const char *cuerpo);
+extern void desalojar_macros(TABLA_MACROS *tabla);
+
+//Funciones para generar el texto de las expansiones (alojado con malloc)
+extern char *expandir_macro(struct _CONTEXTO_ASM *ctx, MACRO *macro, const char *argumentos,
+                            int *tam);
+extern char *expandir_repeticion(TABLA_MACROS *tabla, const char *cuerpo, int *tam);
+
+//Funciones para delimitar los cuerpos y contar sus lineas
+extern int cambio_nivel_bloque(const char *linea, size_t tam);
+extern int contar_lineas(const char *texto);
+
+#endif //j16asm_macros_h_Incluida
@@ -0,0 +1,192 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_mapa.c                                                                                 |
+//| Modulo del dimensionamiento automatico y del mapa de memoria                                  |
+//|                                                                                               |
+//| Este modulo elige la menor capacidad valida de cada memoria donde cabe el programa (opciones  |
+//| -p auto y -r auto) y genera el mapa de memoria (opcion -map): la ocupacion de cada memoria y  |
+//| de cada bloque RAMB16, y lo que ocupa cada etiqueta.                                          |
+//| Con capacidad automatica se ensambla con la mayor capacidad y se reduce al terminar el paso 2 |
+//| (o el enlace): la imagen no depende de la capacidad, la cual solo limita hasta donde se puede |
+//| escribir. La reduccion se hace antes de -gc y -O, ya que ambos toman la ultima direccion de   |
+//| la memoria de programa como vector de interrupcion, y se repite despues, por si estos         |
+//| liberaron el final de alguna memoria.                                                         |
+//| Lo que ocupa una etiqueta son las localidades ocupadas desde su direccion hasta la siguiente  |
+//| etiqueta de la misma memoria (o hasta el final de la memoria).                                |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdio.h>                      //Permite manejar archivos
+#include <stdlib.h>                     //Permite invocar realloc, qsort y free
+#include <string.h>                     //Permite manejar cadenas
+#include "j16asm_mapa.h"                //Cabecera propia
+#include "j16asm.h"                     //Importa el contexto de ensamblado
+#include "j16asm_imagen_mem.h"          //Importa la imagen de las memorias de programa y RAM
+#include "j16asm_dat_struct.h"          //Importa la lista de simbolos
+#include "j16asm_opciones.h"            //Importa las capacidades validas de las memorias
+#include "j16asm_salida.h"              //Importa el tamaño de los bloques RAMB16
+#include "j16asm_recolector.h"          //Permite omitir las etiquetas que elimino la recoleccion
+#include "j16asm_messages.h"            //Permite enviar mensajes al usuario
+
+//Tipos de datos locales al modulo
+//Descripcion de una de las dos memorias (para recorrer ambas con el mismo codigo)
+typedef struct _MEMORIA_MAPA {
+  const char *titulo;                   //Nombre de la memoria en el mapa
+  const char *unidades;                 //Nombre de lo que se guarda en cada localidad
+  TIPO_REUBICACION reubicacion;         //Tipo de las etiquetas de la memoria
+  int capacidad;                        //Capacidad actual de la memoria
+  int capacidad_minima;                 //Menor capacidad valida donde cabe el programa
+  int tam_bloque;                       //Localidades por bloque RAMB16
+  bool automatica;                      //Indica si la capacidad se eligio automaticamente
+  bool (*ocupada)(const IMAGEN_MEM *imagen, int direccion);  //Consulta de una localidad
+} MEMORIA_MAPA;
+
+//Declaracion previa de las funciones locales al modulo
+static int capacidad_suficiente(int ultima_localidad, int minima);
+static void escribir_memoria(FILE *fp_archivo, CONTEXTO_ASM *ctx, const MEMORIA_MAPA *memoria);
+static int contar_ocupadas(CONTEXTO_ASM *ctx, const MEMORIA_MAPA *memoria, int inicio, int fin,
+                           int *primera, int *ultima);
+static int buscar_etiquetas(CONTEXTO_ASM *ctx, const MEMORIA_MAPA *memoria,
+                            SIMBOLO ***etiquetas);
+static int comparar_etiquetas(const void *a, const void *b);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion que reduce las capacidades automaticas a la menor capacidad valida donde cabe lo que
+//hay en cada memoria
+void ajustar_capacidades(CONTEXTO_ASM *ctx, bool prg_automatica, bool ram_automatica) {
+  if (prg_automatica)
+    ctx->tam_prg = capacidad_suficiente(ultima_localidad_prg(&ctx->imagen), TAM_PRG_MINIMO);
+  if (ram_automatica)
+    ctx->tam_ram = capacidad_suficiente(ultima_localidad_ram(&ctx->imagen), TAM_RAM_MINIMO);
+}
+
+//Funcion para generar el mapa de memoria (las capacidades automaticas se indican como tales)
+bool escribir_mapa(CONTEXTO_ASM *ctx, const char *nombre, bool prg_automatica,
+                   bool ram_automatica) {
+  FILE *fp_archivo;
+  MEMORIA_MAPA memorias[2] = {
+    { "Memoria de programa", "instrucciones", REUB_PRG, ctx->tam_prg,
+      capacidad_suficiente(ultima_localidad_prg(&ctx->imagen), TAM_PRG_MINIMO),
+      TAM_BLOQUE_PRG, prg_automatica, localidad_prg_ocupada },
+    { "Memoria RAM", "palabras", REUB_RAM, ctx->tam_ram,
+      capacidad_suficiente(ultima_localidad_ram(&ctx->imagen), TAM_RAM_MINIMO),
+      TAM_BLOQUE_RAM, ram_automatica, localidad_ram_ocupada }
+  };
+  int bloques_prg = ctx->tam_prg / TAM_BLOQUE_PRG, bloques_ram = ctx->tam_ram / TAM_BLOQUE_RAM;
+  bool exito;
+
+  fp_archivo = fopen(nombre, "w");
+  if (!fp_archivo) {
+    msg_error_crear_archivo_salida(ctx, nombre);
+    return false;
+  }
+
+  //Encabezado con el resumen de ambas memorias y la cantidad de bloques que se instancian
+  fprintf(fp_archivo,
+          "; Mapa de memoria de %s\n"
+          "; Bloques RAMB16: %i (%i de programa y %i de RAM)\n"
+          "; Capacidades: -p %i%s -r %i%s (bastan -p %i -r %i)\n",
+          ctx->nombre_archivo_ent, bloques_prg + bloques_ram, bloques_prg, bloques_ram,
+          ctx->tam_prg, prg_automatica ? " (auto)" : "", ctx->tam_ram,
+          ram_automatica ? " (auto)" : "", memorias[0].capacidad_minima,
+          memorias[1].capacidad_minima);
+
+  escribir_memoria(fp_archivo, ctx, &memorias[0]);
+  escribir_memoria(fp_archivo, ctx, &memorias[1]);
+
+  exito = !ferror(fp_archivo);
+  if (fclose(fp_archivo)) exito = false;
+  if (!exito) msg_error_escribir_archivo_salida(ctx, nombre);
+  return exito;
+}
+
+//Funcion que obtiene la menor capacidad valida (potencia de 2 desde la minima) que incluye una
+//localidad (-1 si la memoria esta vacia)
+static int capacidad_suficiente(int ultima_localidad, int minima) {
+  while (minima <= ultima_localidad) minima *= 2;
+  return minima;
+}
+
+//Funcion que escribe la seccion del mapa de una memoria: su ocupacion, la de cada bloque RAMB16
+//y lo que ocupa cada etiqueta
+static void escribir_memoria(FILE *fp_archivo, CONTEXTO_ASM *ctx, const MEMORIA_MAPA *memoria) {
+  SIMBOLO **etiquetas;
+  int num_etiquetas, ocupadas, primera, ultima, fin, i, j;
+
+  //Ocupacion de toda la memoria
+  ocupadas = contar_ocupadas(ctx, memoria, 0, memoria->capacidad, &primera, &ultima);
+  fprintf(fp_archivo, "\n%s: %i de %i %s ocupadas (%.1f%%)", memoria->titulo, ocupadas,
+          memoria->capacidad, memoria->unidades, 100.0 * ocupadas / memoria->capacidad);
+  if (ocupadas) fprintf(fp_archivo, ", de 0x%.4X a 0x%.4X\n", primera, ultima);
+  else fprintf(fp_archivo, "\n");
+
+  //Ocupacion de cada bloque RAMB16
+  fprintf(fp_archivo, "  Bloque  Direcciones      Ocupadas\n");
+  for (i=0; i<memoria->capacidad; i+=memoria->tam_bloque) {
+    ocupadas = contar_ocupadas(ctx, memoria, i, i + memoria->tam_bloque, &primera, &ultima);
+    fprintf(fp_archivo, "  %6i  0x%.4X-0x%.4X  %8i%s\n", i / memoria->tam_bloque, i,
+            i + memoria->tam_bloque - 1, ocupadas, ocupadas ? "" : "  (vacio)");
+  }
+
+  //Lo que ocupa cada etiqueta, hasta la siguiente con otra direccion (y los bloques que toca)
+  num_etiquetas = buscar_etiquetas(ctx, memoria, &etiquetas);
+  if (num_etiquetas)
+    fprintf(fp_archivo, "  Direccion  Ocupadas  Bloques  Etiqueta\n");
+  for (i=0; i<num_etiquetas; i++) {
+    for (j=i+1; j<num_etiquetas && etiquetas[j]->valor==etiquetas[i]->valor; j++);
+    fin = j < num_etiquetas ? etiquetas[j]->valor : memoria->capacidad;
+    ocupadas = contar_ocupadas(ctx, memoria, etiquetas[i]->valor, fin, &primera, &ultima);
+    fprintf(fp_archivo, "  0x%.4X     %8i  ", etiquetas[i]->valor, ocupadas);
+    if (!ocupadas) fprintf(fp_archivo, "%7s", "-");
+    else if (primera / memoria->tam_bloque == ultima / memoria->tam_bloque)
+      fprintf(fp_archivo, "%7i", primera / memoria->tam_bloque);
+    else fprintf(fp_archivo, "%3i-%-3i", primera / memoria->tam_bloque,
+                 ultima / memoria->tam_bloque);
+    fprintf(fp_archivo, "  %s\n", etiquetas[i]->nombre);
+  }
+  free(etiquetas);
+}
+
+//Funcion que cuenta las localidades ocupadas de un rango de direcciones, indicando la primera y
+//la ultima de ellas
+static int contar_ocupadas(CONTEXTO_ASM *ctx, const MEMORIA_MAPA *memoria, int inicio, int fin,
+                           int *primera, int *ultima) {
+  int cantidad = 0, direccion;
+
+  *primera = *ultima = -1;
+  for (direccion=inicio; direccion<fin && direccion<memoria->capacidad; direccion++) {
+    if (!memoria->ocupada(&ctx->imagen, direccion)) continue;
+    if (!cantidad++) *primera = direccion;
+    *ultima = direccion;
+  }
+  return cantidad;
+}
+
+//Funcion que obtiene las etiquetas de una memoria ordenadas por direccion (retorna la cantidad).
+//Los simbolos de inicio de modulo ($code y $data) no son etiquetas del codigo fuente
+static int buscar_etiquetas(CONTEXTO_ASM *ctx, const MEMORIA_MAPA *memoria,
+                            SIMBOLO ***etiquetas) {
+  SIMBOLO *simbolo;
+  int cantidad = 0;
+
+  *etiquetas = NULL;
+  for (simbolo=primer_simbolo(&ctx->lista_simbolos); simbolo; simbolo=simbolo->siguiente) {
+    if (!simbolo->definido || simbolo->reubicacion != memoria->reubicacion ||
+        simbolo->nombre[0] == '$' || simbolo->valor < 0 || simbolo->valor > memoria->capacidad ||
+        etiqueta_descartada(ctx, simbolo->nombre))
+      continue;
+    if (!(cantidad & (cantidad - 1)))
+      *etiquetas = realloc(*etiquetas, (cantidad ? cantidad * 2 : 1) * sizeof(SIMBOLO *));
+    (*etiquetas)[cantidad++] = simbolo;
+  }
+  if (cantidad) qsort(*etiquetas, cantidad, sizeof(SIMBOLO *), comparar_etiquetas);
+  return cantidad;
+}
+
+//Funcion de comparacion para ordenar las etiquetas por direccion (y por nombre en la misma)
+static int comparar_etiquetas(const void *a, const void *b) {
+  const SIMBOLO *x = *(SIMBOLO * const *) a, *y = *(SIMBOLO * const *) b;
+
+  if (x->valor != y->valor) return x->valor - y->valor;
+  return strcmp(x->nombre, y->nombre);
+}
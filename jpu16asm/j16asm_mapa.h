@@ -0,0 +1,16 @@
+#ifndef j16asm_mapa_h_Incluida
+#define j16asm_mapa_h_Incluida
+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include "j16asm.h"                     //Incluye la definicion del contexto de ensamblado
+
+//Funciones exportadas
+//--------------------
+//Funcion para reducir las capacidades automaticas a lo que ocupa el programa (-p/-r auto)
+extern void ajustar_capacidades(CONTEXTO_ASM *ctx, bool prg_automatica, bool ram_automatica);
+
+//Funcion para generar el mapa de memoria (-map)
+extern bool escribir_mapa(CONTEXTO_ASM *ctx, const char *nombre, bool prg_automatica,
+                          bool ram_automatica);
+
+#endif //j16asm_mapa_h_Incluida
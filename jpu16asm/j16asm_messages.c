@@ -5,10 +5,34 @@
 //| En este modulo se agrupan todas las funciones que se encargan de imprimir los mensajes que    |
 //| genera el ensamblador. Esto se hace de esta manera para facilitar la ubicacion de todos los   |
 //| mensajes en vista a la posible internacionalizacion del programa.                             |
+//| Los mensajes de la linea de comandos se imprimen directamente, mientras que los que genera el |
+//| ensamblado en si se envian a la funcion de reporte del contexto (o a la salida estandar si no |
+//| tiene una), de manera que quien use el ensamblador como biblioteca pueda capturarlos.         |
 //+-----------------------------------------------------------------------------------------------+
+#include <stdarg.h>           //Permite manejar listas variables de argumentos
 #include <stdio.h>            //Permite invocar la funcion printf
 #include "j16asm_messages.h"  //Cabecera propia
-#include "j16asm.h"           //Permite el acceso al nombre del archivo procesado
+#include "j16asm.h"           //Permite el acceso al contexto de ensamblado
+
+#define TAM_MENSAJE 1024      //Tamaño maximo de un mensaje
+
+//Declaracion previa de las funciones locales al modulo
+static void emitir(CONTEXTO_ASM *ctx, const char *formato, ...);
+
+//Funcion para enviar un mensaje del ensamblado a traves del contexto
+static void emitir(CONTEXTO_ASM *ctx, const char *formato, ...) {
+  char mensaje[TAM_MENSAJE];
+  va_list argumentos;
+
+  va_start(argumentos, formato);
+  vsnprintf(mensaje, sizeof(mensaje), formato, argumentos);
+  va_end(argumentos);
+
+  if (ctx->reportar)
+    ctx->reportar(ctx->datos_reporte, mensaje);
+  else
+    fputs(mensaje, stdout);
+}
 
 //Mensajes generados por el modulo principal
 //------------------------------------------
@@ -30,17 +54,60 @@ void msg_mem_ram_usada(int n) {
 
 void msg_lc_ayuda_invocacion() {
   printf("Forma de uso: jpu16asm codigo_fuente [opciones]\n"
+         "              jpu16asm -lote manifiesto [-j hilos]\n"
          "  opciones:\n"
          "    -v  archivo     Genera la salida en formato vhdl normal\n"
          "    -vr archivo     Genera la salida en formato vhdl usando primitivas RAMB16\n"
          "                    (para poder actualizar programas sin realizar sintesis)\n"
          "    -m  archivo     Genera la salida en formato MEM\n"
          "    -b  archivo     Genera un mapa de los bloques de RAM (RAMB16) en formato BMM\n"
+         "    -mdelta archivo Genera un archivo MEM con solo los bloques RAMB16 que\n"
+         "                    cambiaron desde la ultima vez (vacio si ninguno cambio),\n"
+         "                    para actualizar con data2mem el bitfile ya actualizado\n"
+         "    -d  archivo     Genera el desensamblado de las memorias (se puede volver a\n"
+         "                    ensamblar)\n"
          "    -p  numero      Especifica la capacidad de la memoria de programa\n"
-         "                    (512 instrucciones por defecto)\n"
+         "                    (512 instrucciones por defecto, auto elige la menor donde\n"
+         "                    cabe el programa)\n"
          "    -r  numero      Especifica la capacidad de la memoria RAM\n"
-         "                    (1024 palabras por defecto)\n"
-         "  Se puede invocar jpu16asm sin opciones para solo hacer un chequeo sintactico\n");
+         "                    (1024 palabras por defecto, auto elige la menor donde cabe\n"
+         "                    el programa)\n"
+         "    -o  archivo     Genera un objeto reubicable para enlazarlo despues\n"
+         "    -l  objeto      Agrega un objeto al enlace (el archivo de entrada tambien\n"
+         "                    debe ser un objeto)\n"
+         "    -MD archivo     Genera un archivo de dependencias para make con los archivos\n"
+         "                    incluidos (o los objetos enlazados)\n"
+         "    -O  nivel       Optimiza la memoria de programa (0 no optimiza, 1 encadena\n"
+         "                    saltos, convierte llamadas de cola y elimina instrucciones\n"
+         "                    sin efecto). No se puede usar con objetos\n"
+         "    -gc             Elimina las rutinas y los datos que el programa nunca\n"
+         "                    alcanza. No se puede usar con objetos\n"
+         "    -lst archivo    Genera un listado con los ciclos de cada instruccion y las\n"
+         "                    cotas del tiempo de cada rutina (los lazos se acotan con\n"
+         "                    ;@iteraciones en el salto que los cierra). No se puede usar\n"
+         "                    con objetos\n"
+         "    -prof archivo   Reordena los bloques del programa segun un perfil de\n"
+         "                    ejecucion (lineas direccion ejecuciones [tomados]) para que\n"
+         "                    el camino frecuente no salte, y estima los ciclos ahorrados.\n"
+         "                    No se puede usar con objetos\n"
+         "    -map archivo    Genera un mapa de memoria con la ocupacion de cada memoria,\n"
+         "                    de cada bloque RAMB16 y de cada etiqueta. No se puede usar\n"
+         "                    con objetos\n"
+         "    -stats          Muestra el tiempo y los alojamientos de memoria de cada\n"
+         "                    etapa y de cada salida, la cantidad de simbolos y el\n"
+         "                    maximo de la cola de acciones y de la pila del paso 2\n"
+         "    -stats-json archivo  Escribe las mismas mediciones en formato JSON\n"
+         "    -watch          Se queda vigilando el archivo de entrada y los que incluye,\n"
+         "                    y vuelve a ensamblar cada vez que alguno se guarda (solo\n"
+         "                    reemplaza las salidas que cambian). Termina con Ctrl+C\n"
+         "  Se puede invocar jpu16asm sin opciones para solo hacer un chequeo sintactico\n"
+         "  Si el archivo de entrada es un objeto, se enlaza junto con los indicados\n"
+         "  mediante -l (en ese orden) y se generan las salidas solicitadas\n"
+         "  Con -lote se ensamblan en paralelo todos los trabajos del manifiesto, uno por\n"
+         "  linea, cada uno con la forma codigo_fuente [opciones] (excepto -o, -l, -lst,\n"
+         "  -map, -mdelta, -prof, -stats, -stats-json, -watch, -p auto y -r auto); las lineas en\n"
+         "  blanco y el texto a partir de # se ignoran.\n"
+         "  Por omision se usa un hilo por cada procesador disponible\n");
 }
 
 void msg_lc_error_argumentos_faltantes() {
@@ -55,89 +122,431 @@ void msg_lc_error_argumento_invalido(const char *argumento) {
 
 void msg_lc_error_capacidad_ram(int num_pal) {
   printf("Error: Capacidad de memoria de RAM no valida: %i palabras\n", num_pal);
-  printf("Las cantidades validas son 1024, 2048, 4096, 8192, 16384 y 32768 palabras\n");
+  printf("Las cantidades validas son 1024, 2048, 4096, 8192, 16384 y 32768 palabras, o auto para\n"
+         "elegir la menor donde cabe el programa\n");
 }
 
 void msg_lc_error_capacidad_prg(int num_inst) {
   printf("Error: Capacidad de memoria de programa no valida: %i instrucciones\n", num_inst);
-  printf("Las cantidades validas son 512, 1024, 2048, 4096, 8192 y 16384 instrucciones\n");
+  printf("Las cantidades validas son 512, 1024, 2048, 4096, 8192 y 16384 instrucciones, o auto\n"
+         "para elegir la menor donde cabe el programa\n");
+}
+
+void msg_lc_error_objeto_requerido() {
+  printf("Error: la opcion -l requiere que el archivo de entrada sea un objeto\n");
+}
+
+void msg_lc_error_objeto_enlazado() {
+  printf("Error: la opcion -o no se puede usar al enlazar objetos\n");
+}
+
+void msg_error_abrir_archivo_entrada(CONTEXTO_ASM *ctx) {
+  emitir(ctx, "Error al abrir el archivo: %s\n", ctx->nombre_archivo_ent);
+}
+
+void msg_lc_error_cantidad_hilos(const char *argumento) {
+  printf("Error: cantidad de hilos no valida: %s\n", argumento);
+}
+
+void msg_lc_error_nivel_optimizacion(const char *argumento) {
+  printf("Error: nivel de optimizacion no valido: %s\n", argumento);
+  printf("Los niveles validos son 0 (sin optimizar) y 1\n");
+}
+
+void msg_lc_error_optimizacion_objeto() {
+  printf("Error: la opcion -O no se puede usar al generar ni al enlazar objetos\n");
+}
+
+void msg_lc_error_recoleccion_objeto() {
+  printf("Error: la opcion -gc no se puede usar al generar ni al enlazar objetos\n");
+}
+
+void msg_lc_error_listado_objeto() {
+  printf("Error: la opcion -lst no se puede usar al generar ni al enlazar objetos\n");
+}
+
+void msg_lc_error_mapa_objeto() {
+  printf("Error: la opcion -map no se puede usar al generar ni al enlazar objetos\n");
+}
+
+void msg_lc_error_delta_objeto() {
+  printf("Error: la opcion -mdelta no se puede usar al generar objetos\n");
+}
+
+void msg_lc_error_perfil_objeto() {
+  printf("Error: la opcion -prof no se puede usar al generar ni al enlazar objetos\n");
+}
+
+void msg_mem_delta(int bloques_cambiados, int num_bloques) {
+  printf(" - MEM incremental: %i de %i bloques RAMB16 cambiaron\n", bloques_cambiados,
+         num_bloques);
+}
+
+void msg_capacidades_automaticas(int tam_prg, int tam_ram, bool prg_automatica,
+                                 bool ram_automatica) {
+  printf(" - Capacidad elegida:");
+  if (prg_automatica) printf(" -p %i", tam_prg);
+  if (ram_automatica) printf(" -r %i", tam_ram);
+  printf("\n");
+}
+
+void msg_error_crear_archivo_salida(CONTEXTO_ASM *ctx, const char *nombre_archivo) {
+  emitir(ctx, "Error al crear el archivo: %s\n", nombre_archivo);
+}
+
+void msg_error_escribir_archivo_salida(CONTEXTO_ASM *ctx, const char *nombre_archivo) {
+  emitir(ctx, "Error al escribir el archivo: %s\n", nombre_archivo);
+}
+
+void msg_fin_ram(CONTEXTO_ASM *ctx, int num_lin) {
+  emitir(ctx, "%s:%i: Error: Final de la memoria ram sobrepasado (%i palabras)\n",
+         ctx->nombre_archivo_ent, num_lin, ctx->tam_ram);
+}
+
+void msg_colision_ram(CONTEXTO_ASM *ctx, int num_lin, int pos_ram) {
+  emitir(ctx, "%s:%i: Error al ubicar el dato en la direccion 0x%.4X - La localidad ya esta en uso\n",
+         ctx->nombre_archivo_ent, num_lin, pos_ram);
+}
+
+void msg_fin_prg(CONTEXTO_ASM *ctx, int num_lin) {
+  emitir(ctx, "%s:%i: Error: Final de la memoria de programa sobrepasado (%i instrucciones)\n",
+         ctx->nombre_archivo_ent, num_lin, ctx->tam_prg);
+}
+
+void msg_colision_prg(CONTEXTO_ASM *ctx, int num_lin, int pos_prg) {
+  emitir(ctx, "%s:%i: Error al ubicar la instruccion en la direccion 0x%.4X - La localidad ya esta en uso\n",
+         ctx->nombre_archivo_ent, num_lin, pos_prg);
+}
+
+void msg_simbolo_no_definido(CONTEXTO_ASM *ctx, int num_lin, const char *nombre) {
+  emitir(ctx, "%s:%i: Error: simbolo no definido: %s\n", ctx->nombre_archivo_ent, num_lin, nombre);
+}
+
+//Mensajes generados por el modulo de objetos y enlace
+//----------------------------------------------------
+void msg_exito_enlace(int num_objetos) {
+  printf("Enlace de %i objetos: OK\n", num_objetos);
+}
+
+void msg_simbolo_publico_no_definido(CONTEXTO_ASM *ctx, const char *nombre) {
+  emitir(ctx, "%s: Error: simbolo publico no definido: %s\n", ctx->nombre_archivo_ent, nombre);
+}
+
+void msg_simbolo_publico_duplicado(CONTEXTO_ASM *ctx, const char *nombre_objeto,
+                                   const char *nombre) {
+  emitir(ctx, "%s: Error: simbolo publico definido en mas de un objeto: %s\n",
+         nombre_objeto, nombre);
+}
+
+void msg_error_abrir_objeto(CONTEXTO_ASM *ctx, const char *nombre_objeto) {
+  emitir(ctx, "Error al abrir el objeto: %s\n", nombre_objeto);
+}
+
+void msg_objeto_invalido(CONTEXTO_ASM *ctx, const char *nombre_objeto) {
+  emitir(ctx, "%s: Error: el archivo no es un objeto valido de jpu16asm\n", nombre_objeto);
+}
+
+void msg_enlace_fin_prg(CONTEXTO_ASM *ctx, const char *nombre_objeto) {
+  emitir(ctx, "%s: Error: Final de la memoria de programa sobrepasado al enlazar (%i instrucciones)\n",
+         nombre_objeto, ctx->tam_prg);
+}
+
+void msg_enlace_fin_ram(CONTEXTO_ASM *ctx, const char *nombre_objeto) {
+  emitir(ctx, "%s: Error: Final de la memoria ram sobrepasado al enlazar (%i palabras)\n",
+         nombre_objeto, ctx->tam_ram);
+}
+
+//Mensajes generados por el optimizador
+//-------------------------------------
+void msg_optimizacion(const ESTADISTICAS_OPTIMIZACION *estadisticas) {
+  printf("Optimizacion: OK\n");
+  printf(" - %i instrucciones eliminadas (cada una ahorra 2 ciclos por ejecucion)\n",
+         estadisticas->eliminadas);
+  printf(" - %i saltos encadenados, %i llamadas de cola\n", estadisticas->saltos_encadenados,
+         estadisticas->llamadas_de_cola);
 }
 
-void msg_error_abrir_archivo_entrada() {
-  printf("Error al abrir el archivo: %s\n", nombre_archivo_ent);
+void msg_optimizacion_salto_indirecto(CONTEXTO_ASM *ctx, int direccion) {
+  emitir(ctx, "%s: Aviso: no se eliminan instrucciones porque hay un salto indirecto en la direccion 0x%.4X\n",
+         ctx->nombre_archivo_ent, direccion);
 }
 
-void msg_error_crear_archivo_salida(const char *nombre_archivo) {
-  printf("Error al crear el archivo: %s\n", nombre_archivo);
+void msg_optimizacion_referencia_prg(CONTEXTO_ASM *ctx, int num_lin) {
+  emitir(ctx, "%s:%i: Aviso: no se eliminan instrucciones porque se usa una direccion de programa como dato\n",
+         ctx->nombre_archivo_ent, num_lin);
 }
 
-void msg_fin_ram(int num_lin) {
-  printf("%s:%i: Error: Final de la memoria ram sobrepasado (%i palabras)\n",
-         nombre_archivo_ent, num_lin, tam_ram);
+//Mensajes generados por la disposicion guiada por un perfil
+//----------------------------------------------------------
+void msg_disposicion(const ESTADISTICAS_DISPOSICION *estadisticas) {
+  unsigned long long ahorro = estadisticas->ciclos_antes - estadisticas->ciclos_despues;
+
+  printf("Disposicion: OK\n");
+  printf(" - %i segmentos reordenados (%i bloques basicos)\n", estadisticas->segmentos,
+         estadisticas->bloques);
+  printf(" - %i saltos eliminados, %i saltos agregados, %i condiciones invertidas\n",
+         estadisticas->saltos_eliminados, estadisticas->saltos_agregados,
+         estadisticas->saltos_invertidos);
+  printf(" - Ciclos segun el perfil: %llu antes, %llu estimados (%llu ahorrados, %.1f%%)\n",
+         estadisticas->ciclos_antes, estadisticas->ciclos_despues, ahorro,
+         estadisticas->ciclos_antes ? 100.0 * ahorro / estadisticas->ciclos_antes : 0.0);
+}
+
+void msg_disposicion_salto_indirecto(CONTEXTO_ASM *ctx, int direccion) {
+  emitir(ctx, "%s: Aviso: no se reordena el codigo porque hay un salto indirecto en la direccion 0x%.4X\n",
+         ctx->nombre_archivo_ent, direccion);
+}
+
+void msg_disposicion_referencia_prg(CONTEXTO_ASM *ctx, int num_lin) {
+  emitir(ctx, "%s:%i: Aviso: no se reordena el codigo porque se usa una direccion de programa como dato\n",
+         ctx->nombre_archivo_ent, num_lin);
+}
+
+void msg_error_abrir_perfil(CONTEXTO_ASM *ctx, const char *nombre_perfil) {
+  emitir(ctx, "%s: Error al abrir el perfil de ejecucion\n", nombre_perfil);
+}
+
+void msg_perfil_invalido(CONTEXTO_ASM *ctx, const char *nombre_perfil, int num_lin,
+                         const char *detalle) {
+  emitir(ctx, "%s:%i: Error en el perfil de ejecucion: %s\n", nombre_perfil, num_lin, detalle);
+}
+
+//Mensajes generados por el recolector
+//------------------------------------
+void msg_recoleccion(const ESTADISTICAS_RECOLECCION *estadisticas) {
+  printf("Recoleccion: OK\n");
+  printf(" - %i rutinas eliminadas (%i instrucciones)\n", estadisticas->bloques_prg,
+         estadisticas->instrucciones);
+  printf(" - %i bloques de datos eliminados (%i palabras)\n", estadisticas->bloques_ram,
+         estadisticas->palabras);
+  printf(" - Capacidad minima: -p %i -r %i\n", estadisticas->tam_prg_minimo,
+         estadisticas->tam_ram_minimo);
+}
+
+void msg_recoleccion_bloque(CONTEXTO_ASM *ctx, const char *nombre, bool es_ram, int cantidad,
+                            int direccion) {
+  emitir(ctx, "%s: Eliminado: %s (%i %s en la direccion 0x%.4X)\n", ctx->nombre_archivo_ent,
+         nombre, cantidad, es_ram ? "palabras" : "instrucciones", direccion);
+}
+
+//Mensajes generados por el listado
+//----------------------------------
+void msg_anotacion_vueltas_invalida(CONTEXTO_ASM *ctx, const char *ubicacion,
+                                    const char *anotacion) {
+  emitir(ctx, "%s: Aviso: anotacion %s invalida (se espera vueltas o minimo maximo, con "
+         "0 < minimo <= maximo), el lazo queda sin cota\n", ubicacion, anotacion);
+}
+
+//Mensajes de las mediciones (-stats)
+//-----------------------------------
+void msg_estadisticas(const ESTADISTICAS_ENSAMBLADO *estadisticas) {
+  const MEDICION *medicion;
+  unsigned long long bytes_salida = 0;
+  int i;
+
+  printf("Estadisticas:\n");
+  printf("   %-14s %12s %12s %14s %14s\n", "Etapa", "Tiempo (ms)", "Alojamientos",
+         "Bytes alojados", "Bytes escritos");
+  for (i=0; i<NUM_ETAPAS_MEDIDAS; i++) {
+    medicion = &estadisticas->etapas[i];
+    if (!medicion->realizada) continue;
+    printf("   %-14s %12.3f %12lu %14llu %14s\n", nombre_etapa(i), medicion->segundos * 1e3,
+           medicion->alojamientos, medicion->bytes_alojados, "-");
+  }
+  for (i=0; i<estadisticas->num_salidas; i++) {
+    medicion = &estadisticas->salidas[i];
+    printf("   %-14s %12.3f %12lu %14llu %14llu  %s\n", "salida", medicion->segundos * 1e3,
+           medicion->alojamientos, medicion->bytes_alojados, estadisticas->bytes_salidas[i],
+           estadisticas->nombres_salidas[i]);
+    bytes_salida += estadisticas->bytes_salidas[i];
+  }
+  printf(" - %u simbolos\n", estadisticas->simbolos);
+  printf(" - Cola de acciones: %i acciones como maximo\n", estadisticas->max_acciones);
+  printf(" - Pila del paso 2: %i datos como maximo\n", estadisticas->max_pila);
+  printf(" - %llu bytes escritos en los archivos de salida\n", bytes_salida);
+}
+
+//Mensajes generados por el modo de vigilancia
+//---------------------------------------------
+void msg_vigilancia_ensamblado(bool exito, double segundos, int salidas_reemplazadas,
+                               int archivos_vigilados) {
+  printf("Vigilancia: %s en %.3f ms, %i %s, vigilando %i %s (Ctrl+C termina)\n",
+         exito ? "OK" : "ERROR", segundos * 1e3, salidas_reemplazadas,
+         salidas_reemplazadas == 1 ? "salida reemplazada" : "salidas reemplazadas",
+         archivos_vigilados, archivos_vigilados == 1 ? "archivo" : "archivos");
+}
+
+void msg_error_vigilancia(const char *causa) {
+  printf("Error: no se pueden vigilar los archivos de entrada (%s)\n", causa);
 }
 
-void msg_colision_ram(int num_lin, int pos_ram) {
-  printf("%s:%i: Error al ubicar el dato en la direccion 0x%.4X - La localidad ya esta en uso\n",
-         nombre_archivo_ent, num_lin, pos_ram);
+void msg_error_vigilancia_archivo(const char *nombre, const char *causa) {
+  printf("Advertencia: no se puede vigilar el archivo %s (%s)\n", nombre, causa);
 }
 
-void msg_fin_prg(int num_lin) {
-  printf("%s:%i: Error: Final de la memoria de programa sobrepasado (%i instrucciones)\n",
-         nombre_archivo_ent, num_lin, tam_prg);
+//Mensajes generados por el modo de lotes
+//---------------------------------------
+void msg_lote_error_abrir_manifiesto(const char *nombre_manifiesto) {
+  printf("Error al abrir el manifiesto: %s\n", nombre_manifiesto);
 }
 
-void msg_colision_prg(int num_lin, int pos_prg) {
-  printf("%s:%i: Error al ubicar la instruccion en la direccion 0x%.4X - La localidad ya esta en uso\n",
-         nombre_archivo_ent, num_lin, pos_prg);
+void msg_lote_error_linea(const char *nombre_manifiesto, int num_lin) {
+  printf("Error en el manifiesto %s, linea %i:\n", nombre_manifiesto, num_lin);
 }
 
-void msg_simbolo_no_definido(int num_lin, const char *nombre) {
-  printf("%s:%i: Error: simbolo no definido: %s\n", nombre_archivo_ent, num_lin, nombre);
+void msg_lote_opcion_no_permitida(const char *opcion) {
+  printf("Error: la opcion %s no se puede usar en el modo de lotes\n", opcion);
+}
+
+void msg_lote_vacio(const char *nombre_manifiesto) {
+  printf("Error: el manifiesto %s no contiene trabajos\n", nombre_manifiesto);
+}
+
+void msg_lote_inicio(int num_trabajos, int num_fuentes, int num_hilos) {
+  printf("Ensamblando %i trabajos (%i archivos fuente distintos) con %i hilos\n",
+         num_trabajos, num_fuentes, num_hilos);
+}
+
+void msg_lote_trabajo(int indice, const char *nombre, int tam_prg, int tam_ram, bool exito,
+                      bool compartido, int instrucciones, int palabras, double segundos) {
+  if (exito)
+    printf("[%4i] OK    %9.3f ms %7i instr %7i pal  %s (-p %i -r %i)%s\n", indice,
+           segundos * 1e3, instrucciones, palabras, nombre, tam_prg, tam_ram,
+           compartido ? "" : " [ensamblado aparte]");
+  else
+    printf("[%4i] ERROR %9.3f ms                             %s (-p %i -r %i)\n", indice,
+           segundos * 1e3, nombre, tam_prg, tam_ram);
+}
+
+void msg_lote_mensajes_trabajo(const char *mensajes) {
+  fputs(mensajes, stdout);
+}
+
+void msg_lote_resumen(int num_trabajos, int num_exitosos, int num_fuentes, double segundos,
+                      double segundos_fuentes, double segundos_trabajos, long instrucciones) {
+  printf("Resumen: %i trabajos, %i con exito, %i con errores\n", num_trabajos, num_exitosos,
+         num_trabajos - num_exitosos);
+  printf(" - %i archivos fuente ensamblados una sola vez en %.3f ms (tiempo acumulado)\n",
+         num_fuentes, segundos_fuentes * 1e3);
+  printf(" - %.3f ms acumulados en los trabajos\n", segundos_trabajos * 1e3);
+  printf(" - %.3f ms en total: %.1f trabajos/s, %.0f instrucciones/s\n", segundos * 1e3,
+         num_trabajos / segundos, instrucciones / segundos);
 }
 
 //Mensajes generados por el analizador sintactico
 //-----------------------------------------------
-void msg_expr_simbolo_no_definido(int num_lin) {
-  printf("%s:%i: Error en la expresion: uno o mas simbolos aun no han sido definidos\n", nombre_archivo_ent, num_lin);
+void msg_expr_simbolo_no_definido(CONTEXTO_ASM *ctx, int num_lin) {
+  emitir(ctx, "%s:%i: Error en la expresion: uno o mas simbolos aun no han sido definidos\n",
+         ctx->nombre_archivo_ent, num_lin);
+}
+
+void msg_simbolo_redefinido(CONTEXTO_ASM *ctx, int num_lin, const char *nombre) {
+  emitir(ctx, "%s:%i: Error: Simbolo redefinido: %s\n", ctx->nombre_archivo_ent, num_lin, nombre);
+}
+
+void msg_datos_seccion_incorrecta(CONTEXTO_ASM *ctx, int num_lin) {
+  emitir(ctx, "%s:%i: Error: Dato definido fuera de seccion de datos\n",
+         ctx->nombre_archivo_ent, num_lin);
+}
+
+void msg_instr_seccion_incorrecta(CONTEXTO_ASM *ctx, int num_lin) {
+  emitir(ctx, "%s:%i: Error: Instruccion definida fuera de seccion de codigo\n",
+         ctx->nombre_archivo_ent, num_lin);
+}
+
+void msg_expr_no_reubicable(CONTEXTO_ASM *ctx, int num_lin) {
+  emitir(ctx, "%s:%i: Error en la expresion: las direcciones del modulo no se pueden reubicar al enlazar\n",
+         ctx->nombre_archivo_ent, num_lin);
+}
+
+void msg_error_abrir_inclusion(CONTEXTO_ASM *ctx, int num_lin, const char *nombre) {
+  emitir(ctx, "%s:%i: Error al abrir el archivo incluido: %s\n",
+         ctx->nombre_archivo_ent, num_lin, nombre);
+}
+
+void msg_inclusion_demasiado_profunda(CONTEXTO_ASM *ctx, int num_lin, const char *nombre) {
+  emitir(ctx, "%s:%i: Error: demasiados archivos incluidos anidados al incluir %s\n",
+         ctx->nombre_archivo_ent, num_lin, nombre);
 }
 
-void msg_simbolo_redefinido(int num_lin, const char *nombre) {
-  printf("%s:%i: Error: Simbolo redefinido: %s\n", nombre_archivo_ent, num_lin, nombre);
+void msg_definicion_macro_invalida(CONTEXTO_ASM *ctx, int num_lin) {
+  emitir(ctx, "%s:%i: Error: definicion de macro invalida (nombre reservado o parametros "
+         "mal escritos)\n", ctx->nombre_archivo_ent, num_lin);
 }
 
-void msg_datos_seccion_incorrecta(int num_lin) {
-  printf("%s:%i: Error: Dato definido fuera de seccion de datos\n", nombre_archivo_ent, num_lin);
+void msg_macro_redefinida(CONTEXTO_ASM *ctx, int num_lin, const char *nombre) {
+  emitir(ctx, "%s:%i: Error: Macro redefinida: %s\n", ctx->nombre_archivo_ent, num_lin, nombre);
 }
 
-void msg_instr_seccion_incorrecta(int num_lin) {
-  printf("%s:%i: Error: Instruccion definida fuera de seccion de codigo\n", nombre_archivo_ent, num_lin);
+void msg_bloque_sin_endm(CONTEXTO_ASM *ctx, int num_lin) {
+  emitir(ctx, "%s:%i: Error: falta la directiva endm que cierra el bloque\n",
+         ctx->nombre_archivo_ent, num_lin);
 }
 
-void msg_error_sintaxis(int num_lin) {
-  printf("%s:%i: Error de sintaxis\n", nombre_archivo_ent, num_lin);
+void msg_argumentos_macro(CONTEXTO_ASM *ctx, int num_lin, const char *nombre, int esperados,
+                          int recibidos) {
+  emitir(ctx, "%s:%i: Error: la macro %s requiere %i argumentos y recibio %i\n",
+         ctx->nombre_archivo_ent, num_lin, nombre, esperados, recibidos);
+}
+
+void msg_expansion_demasiado_profunda(CONTEXTO_ASM *ctx, int num_lin, const char *nombre) {
+  emitir(ctx, "%s:%i: Error: demasiadas expansiones anidadas al expandir %s\n",
+         ctx->nombre_archivo_ent, num_lin, nombre);
+}
+
+void msg_repeticion_invalida(CONTEXTO_ASM *ctx, int num_lin, int vueltas) {
+  emitir(ctx, "%s:%i: Error: cantidad de repeticiones invalida: %i\n",
+         ctx->nombre_archivo_ent, num_lin, vueltas);
+}
+
+void msg_cantidad_datos_invalida(CONTEXTO_ASM *ctx, int num_lin, int cantidad) {
+  emitir(ctx, "%s:%i: Error: cantidad de datos invalida: %i\n",
+         ctx->nombre_archivo_ent, num_lin, cantidad);
+}
+
+void msg_error_abrir_datos(CONTEXTO_ASM *ctx, int num_lin, const char *nombre) {
+  emitir(ctx, "%s:%i: Error al abrir el archivo de datos: %s\n",
+         ctx->nombre_archivo_ent, num_lin, nombre);
+}
+
+void msg_archivo_datos_invalido(CONTEXTO_ASM *ctx, int num_lin, const char *nombre,
+                                const char *detalle) {
+  emitir(ctx, "%s:%i: Error en el archivo de datos %s: %s\n",
+         ctx->nombre_archivo_ent, num_lin, nombre, detalle);
+}
+
+void msg_tabla_invalida(CONTEXTO_ASM *ctx, int num_lin, const char *detalle) {
+  emitir(ctx, "%s:%i: Error en la tabla: %s\n", ctx->nombre_archivo_ent, num_lin, detalle);
+}
+
+void msg_error_sintaxis(CONTEXTO_ASM *ctx, int num_lin) {
+  emitir(ctx, "%s:%i: Error de sintaxis\n", ctx->nombre_archivo_ent, num_lin);
 }
 
 //-----------------------------------------------
 //Funciones para mensajes de depuracion solamente
 //-----------------------------------------------
-void msg_error_archivo(int num_lin, const char *mensaje, const char *elemento) {
+void msg_error_archivo(CONTEXTO_ASM *ctx, int num_lin, const char *mensaje, const char *elemento) {
   if (!elemento)
-    printf("%s:%i: %s\n", nombre_archivo_ent, num_lin, mensaje);
+    emitir(ctx, "%s:%i: %s\n", ctx->nombre_archivo_ent, num_lin, mensaje);
   else
-    printf("%s:%i: %s %s\n", nombre_archivo_ent, num_lin, mensaje, elemento);
+    emitir(ctx, "%s:%i: %s %s\n", ctx->nombre_archivo_ent, num_lin, mensaje, elemento);
 }
 
-void msg_error_interno(const char *mensaje) {
-  printf("%s: Error interno del ensamblador: %s", nombre_archivo_ent, mensaje);
+void msg_error_interno(CONTEXTO_ASM *ctx, const char *mensaje) {
+  emitir(ctx, "%s: Error interno del ensamblador: %s", ctx->nombre_archivo_ent, mensaje);
 }
 
 void msg_encolar_accion(ACCION_PASO_2 *accion) {
   switch (accion->tipo) {
+  case TPA_INICIO_EXPRESION:
+    printf("encolar inicio de expresion (linea %i)\n", accion->num_lin);
+    break;
   case TPA_APILAR_LITERAL:
     printf("encolar literal: %i\n", accion->valor);
     break;
   case TPA_APILAR_SIMBOLO:
-    printf("encolar simbolo: %s\n", accion->nombre);
+    printf("encolar simbolo: %s\n", accion->simbolo->nombre);
     break;
   case TPA_OPERACION_ARITMETICA:
     printf("encolar operacion: ");    
@@ -173,11 +582,14 @@ void msg_encolar_accion(ACCION_PASO_2 *accion) {
 
 void msg_realizar_accion(ACCION_PASO_2 *accion) {
   switch (accion->tipo) {
+  case TPA_INICIO_EXPRESION:
+    printf("iniciar expresion (linea %i)\n", accion->num_lin);
+    break;
   case TPA_APILAR_LITERAL:
     printf("apilar literal: %i\n", accion->valor);
     break;
   case TPA_APILAR_SIMBOLO:
-    printf("apilar simbolo: %s\n", accion->nombre);
+    printf("apilar simbolo: %s\n", accion->simbolo->nombre);
     break;
   case TPA_OPERACION_ARITMETICA:
     printf("aplicar operacion: ");    
@@ -1,7 +1,9 @@
 #ifndef j16asm_messages_h_Incluida
 #define j16asm_messages_h_Incluida
 
-#include "j16asm_dat_struct.h"
+#include "j16asm.h"
+#include "j16asm_estadisticas.h"
+#include "j16asm_disposicion.h"
 
 //Mensajes generados por el modulo principal
 extern void msg_exito_etapa(int n);
@@ -12,24 +14,108 @@ extern void msg_lc_error_argumentos_faltantes();
 extern void msg_lc_error_argumento_invalido(const char *argumento);
 extern void msg_lc_error_capacidad_ram(int num_pal);
 extern void msg_lc_error_capacidad_prg(int num_inst);
-extern void msg_error_abrir_archivo_entrada();
-extern void msg_error_crear_archivo_salida(const char *nombre_archivo);
-extern void msg_fin_ram(int num_lin);
-extern void msg_colision_ram(int num_lin, int pos_ram);
-extern void msg_fin_prg(int num_lin);
-extern void msg_colision_prg(int num_lin, int pos_prg);
-extern void msg_simbolo_no_definido(int num_lin, const char *nombre);
+extern void msg_lc_error_objeto_requerido();
+extern void msg_lc_error_objeto_enlazado();
+extern void msg_lc_error_cantidad_hilos(const char *argumento);
+extern void msg_lc_error_nivel_optimizacion(const char *argumento);
+extern void msg_lc_error_optimizacion_objeto();
+extern void msg_lc_error_recoleccion_objeto();
+extern void msg_lc_error_listado_objeto();
+extern void msg_lc_error_mapa_objeto();
+extern void msg_lc_error_delta_objeto();
+extern void msg_lc_error_perfil_objeto();
+extern void msg_mem_delta(int bloques_cambiados, int num_bloques);
+extern void msg_capacidades_automaticas(int tam_prg, int tam_ram, bool prg_automatica,
+                                        bool ram_automatica);
+extern void msg_error_abrir_archivo_entrada(CONTEXTO_ASM *ctx);
+extern void msg_error_crear_archivo_salida(CONTEXTO_ASM *ctx, const char *nombre_archivo);
+extern void msg_error_escribir_archivo_salida(CONTEXTO_ASM *ctx, const char *nombre_archivo);
+extern void msg_fin_ram(CONTEXTO_ASM *ctx, int num_lin);
+extern void msg_colision_ram(CONTEXTO_ASM *ctx, int num_lin, int pos_ram);
+extern void msg_fin_prg(CONTEXTO_ASM *ctx, int num_lin);
+extern void msg_colision_prg(CONTEXTO_ASM *ctx, int num_lin, int pos_prg);
+extern void msg_simbolo_no_definido(CONTEXTO_ASM *ctx, int num_lin, const char *nombre);
+
+//Mensajes generados por el modulo de objetos y enlace
+extern void msg_exito_enlace(int num_objetos);
+extern void msg_simbolo_publico_no_definido(CONTEXTO_ASM *ctx, const char *nombre);
+extern void msg_simbolo_publico_duplicado(CONTEXTO_ASM *ctx, const char *nombre_objeto,
+                                          const char *nombre);
+extern void msg_error_abrir_objeto(CONTEXTO_ASM *ctx, const char *nombre_objeto);
+extern void msg_objeto_invalido(CONTEXTO_ASM *ctx, const char *nombre_objeto);
+extern void msg_enlace_fin_prg(CONTEXTO_ASM *ctx, const char *nombre_objeto);
+extern void msg_enlace_fin_ram(CONTEXTO_ASM *ctx, const char *nombre_objeto);
+
+//Mensajes generados por el optimizador
+extern void msg_optimizacion(const ESTADISTICAS_OPTIMIZACION *estadisticas);
+extern void msg_optimizacion_salto_indirecto(CONTEXTO_ASM *ctx, int direccion);
+extern void msg_optimizacion_referencia_prg(CONTEXTO_ASM *ctx, int num_lin);
+
+//Mensajes generados por la disposicion guiada por un perfil
+extern void msg_disposicion(const ESTADISTICAS_DISPOSICION *estadisticas);
+extern void msg_disposicion_salto_indirecto(CONTEXTO_ASM *ctx, int direccion);
+extern void msg_disposicion_referencia_prg(CONTEXTO_ASM *ctx, int num_lin);
+extern void msg_error_abrir_perfil(CONTEXTO_ASM *ctx, const char *nombre_perfil);
+extern void msg_perfil_invalido(CONTEXTO_ASM *ctx, const char *nombre_perfil, int num_lin,
+                                const char *detalle);
+
+//Mensajes generados por el recolector
+extern void msg_recoleccion(const ESTADISTICAS_RECOLECCION *estadisticas);
+extern void msg_recoleccion_bloque(CONTEXTO_ASM *ctx, const char *nombre, bool es_ram,
+                                   int cantidad, int direccion);
+
+//Mensajes generados por el listado
+extern void msg_anotacion_vueltas_invalida(CONTEXTO_ASM *ctx, const char *ubicacion,
+                                           const char *anotacion);
+
+//Mensajes de las mediciones (-stats)
+extern void msg_estadisticas(const ESTADISTICAS_ENSAMBLADO *estadisticas);
+
+//Mensajes generados por el modo de vigilancia
+extern void msg_vigilancia_ensamblado(bool exito, double segundos, int salidas_reemplazadas,
+                                      int archivos_vigilados);
+extern void msg_error_vigilancia(const char *causa);
+extern void msg_error_vigilancia_archivo(const char *nombre, const char *causa);
+
+//Mensajes generados por el modo de lotes
+extern void msg_lote_error_abrir_manifiesto(const char *nombre_manifiesto);
+extern void msg_lote_error_linea(const char *nombre_manifiesto, int num_lin);
+extern void msg_lote_opcion_no_permitida(const char *opcion);
+extern void msg_lote_vacio(const char *nombre_manifiesto);
+extern void msg_lote_inicio(int num_trabajos, int num_fuentes, int num_hilos);
+extern void msg_lote_trabajo(int indice, const char *nombre, int tam_prg, int tam_ram, bool exito,
+                             bool compartido, int instrucciones, int palabras, double segundos);
+extern void msg_lote_mensajes_trabajo(const char *mensajes);
+extern void msg_lote_resumen(int num_trabajos, int num_exitosos, int num_fuentes, double segundos,
+                             double segundos_fuentes, double segundos_trabajos,
+                             long instrucciones);
 
 //Mensajes generados por el analizador sintactico
-extern void msg_expr_simbolo_no_definido(int num_lin);
-extern void msg_simbolo_redefinido(int num_lin, const char *nombre);
-extern void msg_datos_seccion_incorrecta(int num_lin);
-extern void msg_instr_seccion_incorrecta(int num_lin);
-extern void msg_error_sintaxis(int num_lin);
+extern void msg_expr_simbolo_no_definido(CONTEXTO_ASM *ctx, int num_lin);
+extern void msg_simbolo_redefinido(CONTEXTO_ASM *ctx, int num_lin, const char *nombre);
+extern void msg_datos_seccion_incorrecta(CONTEXTO_ASM *ctx, int num_lin);
+extern void msg_instr_seccion_incorrecta(CONTEXTO_ASM *ctx, int num_lin);
+extern void msg_expr_no_reubicable(CONTEXTO_ASM *ctx, int num_lin);
+extern void msg_error_abrir_inclusion(CONTEXTO_ASM *ctx, int num_lin, const char *nombre);
+extern void msg_inclusion_demasiado_profunda(CONTEXTO_ASM *ctx, int num_lin, const char *nombre);
+extern void msg_definicion_macro_invalida(CONTEXTO_ASM *ctx, int num_lin);
+extern void msg_macro_redefinida(CONTEXTO_ASM *ctx, int num_lin, const char *nombre);
+extern void msg_bloque_sin_endm(CONTEXTO_ASM *ctx, int num_lin);
+extern void msg_argumentos_macro(CONTEXTO_ASM *ctx, int num_lin, const char *nombre, int esperados,
+                                 int recibidos);
+extern void msg_expansion_demasiado_profunda(CONTEXTO_ASM *ctx, int num_lin, const char *nombre);
+extern void msg_repeticion_invalida(CONTEXTO_ASM *ctx, int num_lin, int vueltas);
+extern void msg_cantidad_datos_invalida(CONTEXTO_ASM *ctx, int num_lin, int cantidad);
+extern void msg_error_abrir_datos(CONTEXTO_ASM *ctx, int num_lin, const char *nombre);
+extern void msg_archivo_datos_invalido(CONTEXTO_ASM *ctx, int num_lin, const char *nombre,
+                                       const char *detalle);
+extern void msg_tabla_invalida(CONTEXTO_ASM *ctx, int num_lin, const char *detalle);
+extern void msg_error_sintaxis(CONTEXTO_ASM *ctx, int num_lin);
 
 //Funciones para mensajes de depuracion solamente
-//extern void msg_error_archivo(int num_lin, const char *mensaje, const char *elemento);
-//extern void msg_error_interno(const char *mensaje);
+//extern void msg_error_archivo(CONTEXTO_ASM *ctx, int num_lin, const char *mensaje,
+//                              const char *elemento);
+//extern void msg_error_interno(CONTEXTO_ASM *ctx, const char *mensaje);
 //extern void msg_encolar_accion(ACCION_PASO_2 *accion);
 //extern void msg_realizar_accion(ACCION_PASO_2 *accion);
 //extern void msg_apilar(int valor);
@@ -0,0 +1,431 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_objeto.c                                                                               |
+//| Modulo de generacion y enlace de objetos reubicables                                          |
+//|                                                                                               |
+//| Este modulo permite ensamblar un programa por partes. Con la opcion -o, en vez de realizar el |
+//| paso 2, el ensamblador guarda en un objeto el contenido de la memoria de programa y RAM del   |
+//| modulo, sus simbolos publicos y la cola de acciones del paso 2 tal cual quedo al terminar el  |
+//| paso 1. El enlazador carga varios objetos, ubicando el codigo y los datos de cada uno a       |
+//| continuacion de los del objeto anterior, y luego ejecuta el paso 2 sobre las acciones de cada |
+//| objeto para resolver las referencias entre modulos.                                           |
+//|                                                                                               |
+//| Nota acerca de la reubicacion                                                                 |
+//| Los objetos se ensamblan como si su codigo y sus datos comenzaran en la direccion 0. Toda     |
+//| direccion del modulo que aparece como argumento se encola en el paso 1 como una expresion que |
+//| suma el inicio del codigo ($code) o de los datos ($data) del modulo, de manera que el         |
+//| enlazador corrige todas las direcciones con el mismo mecanismo del paso 2. Los simbolos       |
+//| locales ya definidos se guardan en el objeto como literales relativos a su memoria, y solo    |
+//| los simbolos externos se guardan por nombre. Los saltos y llamadas relativos se codifican     |
+//| como el destino menos la direccion de la instruccion, asi que al mover el codigo el enlazador |
+//| les resta el inicio del codigo del modulo (si el destino esta en el mismo modulo, la          |
+//| correccion encolada vuelve a sumarlo y el desplazamiento queda intacto).                      |
+//|                                                                                               |
+//| Formato del objeto (texto, un registro por linea, valores en decimal salvo los datos):        |
+//|   JPU16OBJ 1                    Firma y version del formato                                   |
+//|   F fuente                      Nombre de un codigo fuente (el de entrada y los incluidos, en |
+//|                                 orden, para reportar errores)                                 |
+//|   C tamaño / D tamaño           Tamaño del codigo y de los datos del modulo                   |
+//|   P dir dato...                 Instrucciones consecutivas desde dir (hexadecimal)            |
+//|   R dir dato...                 Palabras de RAM consecutivas desde dir (hexadecimal)          |
+//|   S nombre valor N|P|R          Simbolo publico (absoluto o relativo al codigo o datos)       |
+//|   E linea fuente                Inicio de una expresion del paso 2 (fuente es el numero del   |
+//|                                 registro F correspondiente, 0 si se omite)                    |
+//|   L valor                       Apilar literal                                                |
+//|   B P|R valor                   Apilar direccion relativa al codigo o datos del modulo        |
+//|   X nombre                      Apilar simbolo externo                                        |
+//|   O operacion                   Operacion aritmetica (incluye la bandera de intercambio)      |
+//|   G P|R dir                     Guardar el resultado en la memoria de programa o RAM          |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+#include <stdio.h>                      //Permite manejar archivos
+#include <stdlib.h>                     //Permite invocar malloc y free
+#include <string.h>                     //Permite manejar cadenas
+#include "j16asm_objeto.h"              //Cabecera propia
+#include "j16asm.h"                     //Importa el contexto de ensamblado
+#include "j16asm_ensamblador.h"         //Importa el paso 2
+#include "j16asm_dat_struct.h"          //Importa la cola de acciones y la lista de simbolos
+#include "j16asm_imagen_mem.h"          //Importa la imagen con los datos de memoria
+#include "j16asm_fuentes.h"             //Importa el registro de archivos fuente
+#include "j16asm_messages.h"            //Permite enviar mensajes al usuario
+
+//Constantes del formato de los objetos
+#define FIRMA_OBJETO     "JPU16OBJ"     //Primera palabra de todo objeto
+#define VERSION_OBJETO   1              //Version del formato
+#define DATOS_POR_LINEA  8              //Cantidad maxima de datos por registro P o R
+#define TAM_LINEA        512            //Tamaño maximo de una linea del objeto
+
+//Estructura con los datos de un objeto que se esta enlazando
+typedef struct _OBJETO {
+  int tam_prg;                          //Tamaño del codigo del modulo
+  int tam_ram;                          //Tamaño de los datos del modulo
+  int base_prg;                         //Direccion donde se ubico el codigo del modulo
+  int base_ram;                         //Direccion donde se ubicaron los datos del modulo
+} OBJETO;
+
+//Declaracion previa de las funciones locales al modulo
+static int calcular_tamano_prg(CONTEXTO_ASM *ctx);
+static int calcular_tamano_ram(CONTEXTO_ASM *ctx);
+static char letra_reubicacion(TIPO_REUBICACION reub);
+static bool es_salto_relativo(uint32_t dato);
+static bool cargar_objeto(CONTEXTO_ASM *ctx, const char *nombre, OBJETO *objeto);
+static bool cargar_expresiones(CONTEXTO_ASM *ctx, const char *nombre, OBJETO *objeto);
+static int base_reubicacion(OBJETO *objeto, char letra);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion para determinar si un archivo es un objeto (por su firma)
+bool es_archivo_objeto(const char *nombre) {
+  FILE *fp_archivo;
+  char firma[sizeof(FIRMA_OBJETO)];
+  bool resultado;
+
+  fp_archivo = fopen(nombre, "r");
+  if (!fp_archivo) return false;
+  resultado = fgets(firma, sizeof(firma), fp_archivo) && strcmp(firma, FIRMA_OBJETO) == 0;
+  fclose(fp_archivo);
+  return resultado;
+}
+
+//Funcion para escribir el objeto del modulo ensamblado (se invoca en vez del paso 2)
+bool escribir_objeto(CONTEXTO_ASM *ctx, const char *nombre) {
+  FILE *fp_archivo;
+  SIMBOLO *simbolo;
+  ACCION_PASO_2 *accion;
+  ACCION_PASO_2 *fin_acciones;
+  const char **fuentes;
+  int num_fuentes;
+  int num_acciones;
+  int profundidad_maxima;
+  int direccion;
+  int i;
+
+  //Antes de crear el archivo, verifica que todos los simbolos publicos esten definidos
+  for (simbolo = primer_simbolo(&ctx->lista_simbolos); simbolo; simbolo = simbolo->siguiente) {
+    if (simbolo->publico && !simbolo->definido) {
+      msg_simbolo_publico_no_definido(ctx, simbolo->nombre);
+      return false;
+    }
+  }
+
+  fp_archivo = fopen(nombre, "w");
+  if (!fp_archivo) {
+    msg_error_crear_archivo_salida(ctx, nombre);
+    return false;
+  }
+
+  //Escribe la cabecera con la firma, los nombres de los fuentes y los tamaños del modulo
+  fprintf(fp_archivo, "%s %i\n", FIRMA_OBJETO, VERSION_OBJETO);
+  fuentes = obtener_fuentes(&ctx->registro_fuentes, &num_fuentes);
+  for (i=0; i<num_fuentes; i++)
+    fprintf(fp_archivo, "F %s\n", fuentes[i]);
+  fprintf(fp_archivo, "C %i\n", calcular_tamano_prg(ctx));
+  fprintf(fp_archivo, "D %i\n", calcular_tamano_ram(ctx));
+
+  //Escribe el contenido de la memoria de programa en tramos de localidades consecutivas
+  for (direccion = siguiente_localidad_prg(&ctx->imagen, 0); direccion >= 0;
+       direccion = siguiente_localidad_prg(&ctx->imagen, direccion)) {
+    fprintf(fp_archivo, "P %i", direccion);
+    for (i=0; i<DATOS_POR_LINEA && direccion < TAM_ESPACIO_MEM &&
+              localidad_prg_ocupada(&ctx->imagen, direccion); i++, direccion++)
+      fprintf(fp_archivo, " %.7X", leer_dato_prg(&ctx->imagen, direccion));
+    fprintf(fp_archivo, "\n");
+  }
+
+  //Luego el contenido de la memoria RAM de la misma forma
+  for (direccion = siguiente_localidad_ram(&ctx->imagen, 0); direccion >= 0;
+       direccion = siguiente_localidad_ram(&ctx->imagen, direccion)) {
+    fprintf(fp_archivo, "R %i", direccion);
+    for (i=0; i<DATOS_POR_LINEA && direccion < TAM_ESPACIO_MEM &&
+              localidad_ram_ocupada(&ctx->imagen, direccion); i++, direccion++)
+      fprintf(fp_archivo, " %.4X", leer_dato_ram(&ctx->imagen, direccion));
+    fprintf(fp_archivo, "\n");
+  }
+
+  //Escribe los simbolos publicos
+  for (simbolo = primer_simbolo(&ctx->lista_simbolos); simbolo; simbolo = simbolo->siguiente)
+    if (simbolo->publico)
+      fprintf(fp_archivo, "S %s %i %c\n", simbolo->nombre, simbolo->valor,
+              letra_reubicacion(simbolo->reubicacion));
+
+  //Finalmente escribe la cola de acciones. Los simbolos definidos en el modulo se sustituyen por
+  //su valor (relativo a su memoria si son direcciones) y los demas quedan como externos
+  accion = obtener_acciones(&ctx->cola_acciones, &num_acciones, &profundidad_maxima);
+  for (fin_acciones = accion + num_acciones; accion < fin_acciones; accion++) {
+    switch (accion->tipo) {
+    case TPA_INICIO_EXPRESION:
+      fprintf(fp_archivo, "E %i %i\n", accion->num_lin, accion->fuente);
+      break;
+    case TPA_APILAR_LITERAL:
+      fprintf(fp_archivo, "L %i\n", accion->valor);
+      break;
+    case TPA_APILAR_SIMBOLO:
+      if (!accion->simbolo->definido)
+        fprintf(fp_archivo, "X %s\n", accion->simbolo->nombre);
+      else if (accion->simbolo->reubicacion == REUB_NINGUNA)
+        fprintf(fp_archivo, "L %i\n", accion->simbolo->valor);
+      else
+        fprintf(fp_archivo, "B %c %i\n", letra_reubicacion(accion->simbolo->reubicacion),
+                accion->simbolo->valor);
+      break;
+    case TPA_OPERACION_ARITMETICA:
+      fprintf(fp_archivo, "O %i\n", accion->op);
+      break;
+    case TPA_GUARDAR_RESULTADO_RAM:
+      fprintf(fp_archivo, "G R %i\n", accion->direccion);
+      break;
+    case TPA_GUARDAR_RESULTADO_PRG:
+      fprintf(fp_archivo, "G P %i\n", accion->direccion);
+      break;
+    }
+  }
+
+  //Al cerrar el archivo se verifica que todo haya sido escrito correctamente
+  if (ferror(fp_archivo) | fclose(fp_archivo)) {
+    msg_error_escribir_archivo_salida(ctx, nombre);
+    return false;
+  }
+  return true;
+}
+
+//Funcion para enlazar varios objetos en la imagen de memoria (en el orden indicado)
+bool enlazar_objetos(CONTEXTO_ASM *ctx, const char *nombres[], int cantidad) {
+  OBJETO *objetos;
+  int base_prg = 0;
+  int base_ram = 0;
+  bool exito;
+  int i;
+
+  objetos = calloc(cantidad, sizeof(OBJETO));
+
+  //En la primera pasada se carga el contenido y los simbolos publicos de todos los objetos, de
+  //manera que al resolver las expresiones ya se conozcan todos los simbolos externos
+  for (i=0; i<cantidad; i++) {
+    objetos[i].base_prg = base_prg;
+    objetos[i].base_ram = base_ram;
+    if (!cargar_objeto(ctx, nombres[i], &objetos[i])) {
+      free(objetos);
+      return false;
+    }
+
+    //El siguiente objeto se ubica a continuacion del actual
+    base_prg += objetos[i].tam_prg;
+    base_ram += objetos[i].tam_ram;
+  }
+
+  //En la segunda pasada se aplica el paso 2 a las expresiones de cada objeto por separado, de
+  //manera que los errores se reporten con el nombre del codigo fuente correspondiente
+  for (i=0; i<cantidad; i++) {
+    exito = cargar_expresiones(ctx, nombres[i], &objetos[i]) && proceso_paso_2(ctx);
+    desalojar_acciones(&ctx->cola_acciones);
+    if (!exito) {
+      free(objetos);
+      return false;
+    }
+  }
+
+  free(objetos);
+  return true;
+}
+
+//Funcion para calcular el tamaño del codigo del modulo (hasta la ultima localidad ocupada)
+static int calcular_tamano_prg(CONTEXTO_ASM *ctx) {
+  return ultima_localidad_prg(&ctx->imagen) + 1;
+}
+
+//Funcion para calcular el tamaño de los datos del modulo (hasta la ultima localidad ocupada)
+static int calcular_tamano_ram(CONTEXTO_ASM *ctx) {
+  return ultima_localidad_ram(&ctx->imagen) + 1;
+}
+
+//Funcion que obtiene la letra que identifica un tipo de reubicacion en el objeto
+static char letra_reubicacion(TIPO_REUBICACION reub) {
+  switch (reub) {
+  case REUB_PRG: return 'P';
+  case REUB_RAM: return 'R';
+  default:       return 'N';
+  }
+}
+
+//Funcion que obtiene la direccion donde se ubico la memoria identificada por una letra del objeto
+static int base_reubicacion(OBJETO *objeto, char letra) {
+  switch (letra) {
+  case 'P': return objeto->base_prg;
+  case 'R': return objeto->base_ram;
+  default:  return 0;
+  }
+}
+
+//Funcion para determinar si una instruccion es un salto o llamada relativo con argumento literal
+//(jmp, jmpXX, call y callXX con direccion)
+static bool es_salto_relativo(uint32_t dato) {
+  switch (dato >> 20 & 0x3F) {
+  case 0b010000: case 0b010010: case 0b010100: case 0b010110: return true;
+  default: return false;
+  }
+}
+
+//Funcion para cargar el contenido y los simbolos publicos de un objeto
+static bool cargar_objeto(CONTEXTO_ASM *ctx, const char *nombre, OBJETO *objeto) {
+  FILE *fp_archivo;
+  char linea[TAM_LINEA];
+  char nombre_simbolo[TAM_LINEA];
+  char letra;
+  char *p;
+  int version;
+  int direccion;
+  int valor;
+  int avance;
+  unsigned int dato;
+  SIMBOLO *simbolo;
+  bool valido = true;
+
+  fp_archivo = fopen(nombre, "r");
+  if (!fp_archivo) {
+    msg_error_abrir_objeto(ctx, nombre);
+    return false;
+  }
+
+  //Verifica la firma y la version del formato
+  if (!fgets(linea, sizeof(linea), fp_archivo) ||
+      sscanf(linea, FIRMA_OBJETO " %i", &version) != 1 || version != VERSION_OBJETO) {
+    msg_objeto_invalido(ctx, nombre);
+    fclose(fp_archivo);
+    return false;
+  }
+
+  //Procesa los registros de la cabecera, el contenido y los simbolos (los fuentes y las
+  //expresiones se cargan en la segunda pasada)
+  while (valido && fgets(linea, sizeof(linea), fp_archivo)) {
+    switch (linea[0]) {
+    case 'C':
+      valido = sscanf(linea, "C %i", &objeto->tam_prg) == 1;
+      if (valido && objeto->base_prg + objeto->tam_prg > ctx->tam_prg) {
+        msg_enlace_fin_prg(ctx, nombre);
+        fclose(fp_archivo);
+        return false;
+      }
+      break;
+    case 'D':
+      valido = sscanf(linea, "D %i", &objeto->tam_ram) == 1;
+      if (valido && objeto->base_ram + objeto->tam_ram > ctx->tam_ram) {
+        msg_enlace_fin_ram(ctx, nombre);
+        fclose(fp_archivo);
+        return false;
+      }
+      break;
+    case 'P':
+    case 'R':
+      //Los datos se ubican a partir del inicio de la memoria correspondiente del modulo
+      valido = sscanf(linea, "%c %i%n", &letra, &direccion, &avance) == 2 && direccion >= 0;
+      direccion += base_reubicacion(objeto, letra);
+      for (p = linea + avance; valido && sscanf(p, " %x%n", &dato, &avance) == 1; p += avance) {
+        if (letra == 'R') {
+          escribir_dato_ram(&ctx->imagen, direccion++, dato);
+          continue;
+        }
+
+        //Los saltos relativos se corrigen segun la nueva ubicacion de la instruccion
+        if (es_salto_relativo(dato))
+          dato = (dato & ~0xFFFF) | ((dato - objeto->base_prg) & 0xFFFF);
+        escribir_dato_prg(&ctx->imagen, direccion++, dato);
+      }
+      break;
+    case 'S':
+      valido = sscanf(linea, "S %s %i %c", nombre_simbolo, &valor, &letra) == 3;
+      if (!valido) break;
+
+      //Los simbolos publicos pasan a la lista global con su valor ya reubicado
+      simbolo = reservar_simbolo(&ctx->lista_simbolos, nombre_simbolo);
+      if (simbolo->definido) {
+        msg_simbolo_publico_duplicado(ctx, nombre, nombre_simbolo);
+        fclose(fp_archivo);
+        return false;
+      }
+      definir_simbolo(simbolo, valor + base_reubicacion(objeto, letra), REUB_NINGUNA);
+      break;
+    default:
+      break;
+    }
+  }
+
+  fclose(fp_archivo);
+  if (!valido) msg_objeto_invalido(ctx, nombre);
+  return valido;
+}
+
+//Funcion para cargar las expresiones de un objeto en la cola de acciones, sustituyendo las
+//direcciones del modulo por su ubicacion final
+static bool cargar_expresiones(CONTEXTO_ASM *ctx, const char *nombre, OBJETO *objeto) {
+  FILE *fp_archivo;
+  char linea[TAM_LINEA];
+  char nombre_simbolo[TAM_LINEA];
+  char letra;
+  int valor;
+  int num_lin = 0;
+  int fuente = 0;
+  int *fuentes = NULL;                  //Indices en el registro de los fuentes del objeto
+  SIMBOLO *simbolo;
+  int num_fuentes = 0;
+  bool valido = true;
+
+  fp_archivo = fopen(nombre, "r");
+  if (!fp_archivo) {
+    msg_error_abrir_objeto(ctx, nombre);
+    return false;
+  }
+
+  while (valido && fgets(linea, sizeof(linea), fp_archivo)) {
+    switch (linea[0]) {
+    case 'F':
+      //El nombre del fuente ocupa el resto de la linea, y se registra para reportar errores
+      linea[strcspn(linea, "\n")] = '\0';
+      fuentes = realloc(fuentes, (num_fuentes + 1) * sizeof(int));
+      fuentes[num_fuentes++] = registrar_fuente(&ctx->registro_fuentes, &linea[2]);
+      break;
+    case 'E':
+      //La cola agrega la cabecera con el numero de linea y el fuente al encolar la primera accion
+      //(los objetos sin fuente en el registro E usan el primero)
+      fuente = 0;
+      valido = sscanf(linea, "E %i %i", &num_lin, &fuente) >= 1 &&
+               fuente >= 0 && fuente < num_fuentes;
+      if (valido) fijar_fuente_acciones(&ctx->cola_acciones, fuentes[fuente]);
+      break;
+    case 'L':
+      valido = sscanf(linea, "L %i", &valor) == 1;
+      if (valido) encolar_literal(&ctx->cola_acciones, valor, num_lin);
+      break;
+    case 'B':
+      valido = sscanf(linea, "B %c %i", &letra, &valor) == 2;
+      if (valido)
+        encolar_literal(&ctx->cola_acciones, valor + base_reubicacion(objeto, letra), num_lin);
+      break;
+    case 'X':
+      valido = sscanf(linea, "X %s", nombre_simbolo) == 1;
+      if (!valido) break;
+      simbolo = reservar_simbolo(&ctx->lista_simbolos, nombre_simbolo);
+      encolar_simbolo(&ctx->cola_acciones, simbolo, num_lin);
+      break;
+    case 'O':
+      valido = sscanf(linea, "O %i", &valor) == 1;
+      if (valido) encolar_operacion(&ctx->cola_acciones, valor, num_lin);
+      break;
+    case 'G':
+      valido = sscanf(linea, "G %c %i", &letra, &valor) == 2;
+      if (!valido) break;
+      if (letra == 'R')
+        encolar_resultado_ram(&ctx->cola_acciones, valor + objeto->base_ram, num_lin);
+      else
+        encolar_resultado_prg(&ctx->cola_acciones, valor + objeto->base_prg, num_lin);
+      break;
+    default:
+      break;
+    }
+  }
+
+  fclose(fp_archivo);
+  free(fuentes);
+  if (!valido) msg_objeto_invalido(ctx, nombre);
+  return valido;
+}
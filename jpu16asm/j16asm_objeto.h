@@ -0,0 +1,13 @@
+#ifndef j16asm_objeto_h_Incluida
+#define j16asm_objeto_h_Incluida
+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include "j16asm.h"                     //Incluye la definicion del contexto de ensamblado
+
+//Funciones exportadas
+//--------------------
+extern bool es_archivo_objeto(const char *nombre);
+extern bool escribir_objeto(CONTEXTO_ASM *ctx, const char *nombre);
+extern bool enlazar_objetos(CONTEXTO_ASM *ctx, const char *nombres[], int cantidad);
+
+#endif //j16asm_objeto_h_Incluida
@@ -0,0 +1,194 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_opciones.c                                                                             |
+//| Modulo de interpretacion de las opciones de ensamblado                                        |
+//|                                                                                               |
+//| Este modulo interpreta las opciones con que se solicita un ensamblado (archivo de entrada,    |
+//| capacidades de memoria y archivos de salida), ya sea que provengan de la linea de comandos o  |
+//| de una linea del manifiesto del modo de lotes, y arma la lista de formatos de salida          |
+//| solicitados para la etapa de salida.                                                          |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdlib.h>                     //Permite invocar atoi, malloc y free
+#include <string.h>                     //Permite manejar cadenas
+#include "j16asm_opciones.h"            //Cabecera propia
+#include "j16asm_output_vhdl.h"         //Importa el formato vhdl
+#include "j16asm_output_vhdl_ramb16.h"  //Importa el formato vhdl con primitivas RAMB16
+#include "j16asm_output_mem_bmm.h"      //Importa los formatos mem y bmm
+#include "j16asm_output_desensamblado.h"  //Importa el formato desensamblado
+#include "j16asm_messages.h"            //Permite enviar mensajes al usuario
+
+//Declaracion previa de las funciones locales al modulo
+static const char **campo_archivo(OPCIONES_ENSAMBLADO *opciones, const char *argumento);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion para interpretar las opciones de un ensamblado. El primer argumento es el archivo de
+//entrada y los demas son opciones, casi todas seguidas de su valor (-gc, -stats y -watch no
+//llevan valor). Si hay un error lo reporta y retorna false
+bool interpretar_opciones(OPCIONES_ENSAMBLADO *opciones, int argc, char *argv[]) {
+  const char **campo;
+  int i;
+
+  //Todas las opciones inician con su valor por omision
+  memset(opciones, 0, sizeof(OPCIONES_ENSAMBLADO));
+  opciones->nombre_archivo_ent = argv[0];
+  opciones->tam_prg = 512;
+  opciones->tam_ram = 1024;
+  opciones->objetos = malloc(argc * sizeof(const char *));
+  opciones->objetos[0] = argv[0];
+
+  //Recorre los argumentos (cada opcion con valor consume tambien el argumento que le sigue)
+  for (i=1; i<argc; i++) {
+    //Verifica si el argumento actual es una de las opciones que indican un archivo de salida
+    if ((campo = campo_archivo(opciones, argv[i]))) {
+      //De ser asi, verifica que exista otro argumento mas adelante
+      if (i+1 >= argc) {
+        msg_lc_error_argumentos_faltantes();    //Si es el ultimo argumento, emite un error
+        return false;
+      }
+      *campo = argv[++i];                       //Toma el siguiente argumento (nombre de archivo)
+    }
+
+    //Verifica si el argumento es -p
+    else if (strcmp(argv[i], "-p") == 0) {
+      if (i+1 >= argc) {
+        msg_lc_error_argumentos_faltantes();
+        return false;
+      }
+      //Con auto se elige la menor capacidad donde cabe el programa
+      if (strcmp(argv[++i], "auto") == 0) {
+        opciones->tam_prg = CAPACIDAD_AUTOMATICA;
+        continue;
+      }
+      opciones->tam_prg = atoi(argv[i]);
+      if (opciones->tam_prg != 512 && opciones->tam_prg != 1024 && opciones->tam_prg != 2048 &&
+          opciones->tam_prg != 4096 && opciones->tam_prg != 8192 && opciones->tam_prg != 16384) {
+        msg_lc_error_capacidad_prg(opciones->tam_prg);
+        return false;
+      }
+    }
+
+    //Verifica si el argumento es -r
+    else if (strcmp(argv[i], "-r") == 0) {
+      if (i+1 >= argc) {
+        msg_lc_error_argumentos_faltantes();
+        return false;
+      }
+      //Con auto se elige la menor capacidad donde cabe el programa
+      if (strcmp(argv[++i], "auto") == 0) {
+        opciones->tam_ram = CAPACIDAD_AUTOMATICA;
+        continue;
+      }
+      opciones->tam_ram = atoi(argv[i]);
+      if (opciones->tam_ram != 1024 && opciones->tam_ram != 2048 && opciones->tam_ram != 4096 &&
+          opciones->tam_ram != 8192 && opciones->tam_ram != 16384 && opciones->tam_ram != 32768) {
+        msg_lc_error_capacidad_ram(opciones->tam_ram);
+        return false;
+      }
+    }
+
+    //Verifica si el argumento es -O
+    else if (strcmp(argv[i], "-O") == 0) {
+      if (i+1 >= argc) {
+        msg_lc_error_argumentos_faltantes();
+        return false;
+      }
+      if (strcmp(argv[++i], "0") != 0 && strcmp(argv[i], "1") != 0) {
+        msg_lc_error_nivel_optimizacion(argv[i]);
+        return false;
+      }
+      opciones->nivel_optimizacion = atoi(argv[i]);
+    }
+
+    //Verifica si el argumento es -gc (no lleva valor)
+    else if (strcmp(argv[i], "-gc") == 0) {
+      opciones->recolectar = true;
+    }
+
+    //Verifica si el argumento es -stats (no lleva valor)
+    else if (strcmp(argv[i], "-stats") == 0) {
+      opciones->estadisticas = true;
+    }
+
+    //Verifica si el argumento es -watch (no lleva valor)
+    else if (strcmp(argv[i], "-watch") == 0) {
+      opciones->vigilar = true;
+    }
+
+    //Verifica si el argumento es -l (puede aparecer varias veces)
+    else if (strcmp(argv[i], "-l") == 0) {
+      if (i+1 >= argc) {
+        msg_lc_error_argumentos_faltantes();
+        return false;
+      }
+      opciones->objetos[++opciones->num_objetos] = argv[++i]; //La primera es la de entrada
+    }
+
+    //Emite un mensaje de error generico para todos los demas argumentos
+    else {
+      msg_lc_error_argumento_invalido(argv[i]);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//Funcion para armar la lista de formatos de salida solicitados junto con el nombre de cada
+//archivo (retorna la cantidad; los arreglos deben tener espacio para MAX_SALIDAS formatos)
+int listar_salidas(const OPCIONES_ENSAMBLADO *opciones, const FORMATO_SALIDA *formatos[],
+                   const char *nombres[]) {
+  int num_salidas = 0;
+
+  if (opciones->nombre_archivo_vhd) {
+    formatos[num_salidas] = &formato_vhdl;
+    nombres[num_salidas++] = opciones->nombre_archivo_vhd;
+  }
+
+  if (opciones->nombre_archivo_vhd_r) {
+    formatos[num_salidas] = &formato_vhdl_ramb16;
+    nombres[num_salidas++] = opciones->nombre_archivo_vhd_r;
+  }
+
+  if (opciones->nombre_archivo_mem) {
+    formatos[num_salidas] = &formato_mem;
+    nombres[num_salidas++] = opciones->nombre_archivo_mem;
+  }
+
+  if (opciones->nombre_archivo_bmm) {
+    formatos[num_salidas] = &formato_bmm;
+    nombres[num_salidas++] = opciones->nombre_archivo_bmm;
+  }
+
+  if (opciones->nombre_archivo_des) {
+    formatos[num_salidas] = &formato_desensamblado;
+    nombres[num_salidas++] = opciones->nombre_archivo_des;
+  }
+
+  return num_salidas;
+}
+
+//Funcion para liberar la memoria asociada a las opciones
+void liberar_opciones(OPCIONES_ENSAMBLADO *opciones) {
+  free(opciones->objetos);
+  opciones->objetos = NULL;
+}
+
+//Funcion que obtiene el campo donde se guarda el nombre de archivo de una opcion (retorna NULL si
+//el argumento no es una opcion de archivo)
+static const char **campo_archivo(OPCIONES_ENSAMBLADO *opciones, const char *argumento) {
+  if (strcmp(argumento, "-v") == 0) return &opciones->nombre_archivo_vhd;
+  if (strcmp(argumento, "-vr") == 0) return &opciones->nombre_archivo_vhd_r;
+  if (strcmp(argumento, "-m") == 0) return &opciones->nombre_archivo_mem;
+  if (strcmp(argumento, "-b") == 0) return &opciones->nombre_archivo_bmm;
+  if (strcmp(argumento, "-d") == 0) return &opciones->nombre_archivo_des;
+  if (strcmp(argumento, "-o") == 0) return &opciones->nombre_archivo_obj;
+  if (strcmp(argumento, "-MD") == 0) return &opciones->nombre_archivo_dep;
+  if (strcmp(argumento, "-lst") == 0) return &opciones->nombre_archivo_lst;
+  if (strcmp(argumento, "-stats-json") == 0) return &opciones->nombre_archivo_json;
+  if (strcmp(argumento, "-map") == 0) return &opciones->nombre_archivo_map;
+  if (strcmp(argumento, "-mdelta") == 0) return &opciones->nombre_archivo_mdelta;
+  if (strcmp(argumento, "-prof") == 0) return &opciones->nombre_archivo_perfil;
+  return NULL;
+}
@@ -0,0 +1,51 @@
+#ifndef j16asm_opciones_h_Incluida
+#define j16asm_opciones_h_Incluida
+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include "j16asm_salida.h"              //Incluye la definicion de los formatos de salida
+
+//Constantes exportadas
+//---------------------
+#define MAX_SALIDAS  5                  //Cantidad de formatos de salida (v, vr, m, b y d)
+#define CAPACIDAD_AUTOMATICA  0         //Capacidad que se elige segun el programa (-p/-r auto)
+#define TAM_PRG_MINIMO  512             //Menor capacidad de la memoria de programa
+#define TAM_PRG_MAXIMO  16384           //Mayor capacidad de la memoria de programa
+#define TAM_RAM_MINIMO  1024            //Menor capacidad de la memoria RAM
+#define TAM_RAM_MAXIMO  32768           //Mayor capacidad de la memoria RAM
+
+//Tipos de datos exportados
+//-------------------------
+//Estructura con las opciones de un ensamblado tal como se indican en la linea de comandos (los
+//nombres apuntan a los argumentos originales, los cuales deben seguir existiendo)
+typedef struct _OPCIONES_ENSAMBLADO {
+  const char *nombre_archivo_ent;       //Nombre del archivo de entrada
+  const char *nombre_archivo_vhd;       //Nombre del archivo en formato vhdl (-v)
+  const char *nombre_archivo_vhd_r;     //Nombre del archivo en formato vhdl con RAMB16 (-vr)
+  const char *nombre_archivo_mem;       //Nombre del archivo en formato mem (-m)
+  const char *nombre_archivo_bmm;       //Nombre del archivo en formato bmm (-b)
+  const char *nombre_archivo_des;       //Nombre del archivo desensamblado (-d)
+  const char *nombre_archivo_obj;       //Nombre del objeto reubicable (-o)
+  const char *nombre_archivo_dep;       //Nombre del archivo de dependencias (-MD)
+  const char *nombre_archivo_lst;       //Nombre del listado con los ciclos (-lst)
+  const char *nombre_archivo_json;      //Nombre del archivo con las mediciones (-stats-json)
+  const char *nombre_archivo_map;       //Nombre del mapa de memoria (-map)
+  const char *nombre_archivo_mdelta;    //Nombre del MEM con los bloques que cambiaron (-mdelta)
+  const char *nombre_archivo_perfil;    //Nombre del perfil de ejecucion (-prof)
+  int tam_prg;                          //Cantidad maxima de instrucciones (o CAPACIDAD_AUTOMATICA)
+  int tam_ram;                          //Cantidad maxima de palabras de RAM (o CAPACIDAD_AUTOMATICA)
+  int nivel_optimizacion;               //Nivel de optimizacion de la memoria de programa (-O)
+  bool recolectar;                      //Elimina el codigo y los datos inalcanzables (-gc)
+  bool estadisticas;                    //Reporta el tiempo y la memoria de cada etapa (-stats)
+  bool vigilar;                         //Reensambla cada vez que cambia la entrada (-watch)
+  const char **objetos;                 //Objetos a enlazar (el primero es el de entrada)
+  int num_objetos;                      //Cantidad de objetos indicados mediante -l
+} OPCIONES_ENSAMBLADO;
+
+//Funciones exportadas
+//--------------------
+extern bool interpretar_opciones(OPCIONES_ENSAMBLADO *opciones, int argc, char *argv[]);
+extern int listar_salidas(const OPCIONES_ENSAMBLADO *opciones, const FORMATO_SALIDA *formatos[],
+                          const char *nombres[]);
+extern void liberar_opciones(OPCIONES_ENSAMBLADO *opciones);
+
+#endif //j16asm_opciones_h_Incluida
@@ -0,0 +1,382 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_optimizador.c                                                                          |
+//| Modulo de optimizacion de la memoria de programa                                              |
+//|                                                                                               |
+//| Este modulo implementa una optimizacion opcional (opcion -O) que se aplica sobre la imagen de |
+//| la memoria de programa una vez terminado el paso 2, cuando todos los saltos ya tienen su      |
+//| destino final.                                                                                |
+//| Las transformaciones que se aplican son las siguientes:                                       |
+//| - Encadenamiento de saltos: un salto o llamada directa cuyo destino es un salto incondicional |
+//|   directo se redirige al destino final (un salto condicional tambien se encadena a traves de  |
+//|   otro salto con la misma condicion).                                                         |
+//| - Llamadas de cola: una llamada directa seguida de return se convierte en un salto, y si la   |
+//|   llamada es incondicional el return queda inalcanzable y se elimina.                         |
+//| - Eliminacion de saltos a la instruccion siguiente.                                           |
+//| - Eliminacion de move rX, rX (no modifica registros ni banderas).                             |
+//| - Eliminacion de instrucciones que solo modifican banderas (setX, clrX, test, cmp) cuando la  |
+//|   siguiente tambien solo modifica banderas y escribe todas las de la anterior. Dos setX o     |
+//|   clrX seguidas con la misma polaridad se combinan en una sola instruccion.                   |
+//|                                                                                               |
+//| Nota acerca de la seguridad de las transformaciones                                           |
+//| Eliminar instrucciones mueve las que le siguen, por lo que solo se hace si el ensamblador     |
+//| conoce todos los lugares donde aparecen direcciones de programa: los saltos y llamadas        |
+//| directas (se recodifican) y las etiquetas (se corrigen en la lista de simbolos). Si alguna    |
+//| direccion de programa se usa como dato (p. ej. se carga en un registro para un salto          |
+//| indirecto o se guarda en RAM), o si el programa tiene saltos o llamadas indirectas, entonces  |
+//| no se eliminan instrucciones (solo se encadenan saltos y se convierten llamadas de cola, lo   |
+//| cual no mueve nada) y se avisa al usuario. Tampoco se mueven las instrucciones ubicadas con   |
+//| code direccion, la direccion 0 (reinicio) ni la ultima direccion (vector de interrupcion): la |
+//| memoria se divide en segmentos que inician en esas direcciones o despues de un hueco, y las   |
+//| instrucciones solo se compactan dentro de su segmento (la ultima de cada segmento nunca se    |
+//| elimina, de manera que el segmento no cambia de inicio ni queda vacio).                       |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+#include <stdlib.h>                     //Permite invocar malloc, calloc y free
+#include "j16asm_optimizador.h"         //Cabecera propia
+#include "j16asm.h"                     //Importa el contexto de ensamblado
+#include "j16asm_imagen_mem.h"          //Importa la imagen de las memorias de programa y RAM
+#include "j16asm_dat_struct.h"          //Importa la lista de simbolos
+#include "j16asm_fuentes.h"             //Importa el registro de archivos fuente
+#include "j16asm_arena.h"               //Permite contar los alojamientos de memoria (-stats)
+#include "j16asm_messages.h"            //Permite enviar mensajes al usuario
+
+//Constantes del modulo
+#define MAX_RONDAS       16             //Cantidad maxima de recorridos sobre el programa
+#define MAX_ENCADENADOS  16             //Cantidad maxima de saltos que se siguen al encadenar
+
+//Estados de cada localidad de la memoria de programa (banderas combinables)
+#define LOC_OCUPADA      0x01           //La localidad contiene una instruccion
+#define LOC_ELIMINADA    0x02           //La instruccion fue eliminada
+#define LOC_DESTINO      0x04           //Es el destino de algun salto o llamada directa
+#define LOC_FIJA         0x08           //Inicio de segmento (la instruccion no se puede mover)
+#define LOC_FIN          0x10           //Ultima instruccion de su segmento
+#define LOC_COMPACTABLE  0x20           //Su segmento admite eliminar instrucciones
+#define LOC_MODIFICADA   0x40           //El destino del salto cambio
+
+//Codigos de instruccion relevantes (ver el analizador sintactico)
+#define INSTR_RETURN     (0b011000 << 20)
+#define INSTR_JMP        0b010000       //Salto incondicional directo (bits 25 a 20)
+
+//Banderas de JPU16 (en el orden de la mascara de las instrucciones setX y clrX)
+#define BANDERA_C        0x01
+#define BANDERA_Z        0x02
+#define BANDERA_N        0x04
+#define BANDERA_V        0x08
+
+//Estructura con el programa que se esta optimizando
+typedef struct _PROGRAMA {
+  CONTEXTO_ASM *ctx;                    //Contexto de ensamblado
+  int tam;                              //Capacidad de la memoria de programa
+  uint32_t *instr;                      //Instrucciones del programa (indexadas por direccion)
+  int *destino;                         //Direccion destino de cada salto o llamada directa
+  uint8_t *estado;                      //Estado de cada localidad (banderas LOC_xxx)
+  int *mapa;                            //Nueva direccion de cada localidad (tam + 1 entradas)
+  ESTADISTICAS_OPTIMIZACION *estadisticas;
+} PROGRAMA;
+
+//Declaracion previa de las funciones locales al modulo
+static int banderas_escritas(uint32_t instr);
+static bool es_cambio_banderas(uint32_t instr);
+static void dividir_segmentos(PROGRAMA *p, bool compactar);
+static void marcar_destinos(PROGRAMA *p);
+static int siguiente(const PROGRAMA *p, int direccion);
+static int sobreviviente(const PROGRAMA *p, int direccion);
+static bool eliminar(PROGRAMA *p, int direccion);
+static bool encadenar(PROGRAMA *p, int direccion);
+static int optimizar_instruccion(PROGRAMA *p, int direccion);
+static void reubicar(PROGRAMA *p);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion que registra un uso de una direccion de programa fuera de un salto o llamada directa
+void registrar_referencia_prg(CONTEXTO_ASM *ctx, int fuente, int num_lin) {
+  INFO_OPTIMIZACION *info = &ctx->info_optimizacion;
+
+  if (!info->referencias_prg++) {       //Solo se recuerda la primera (para el aviso)
+    info->fuente_referencia = fuente;
+    info->lin_referencia = num_lin;
+  }
+}
+
+//Funcion que registra una direccion de programa fijada con la directiva code
+void registrar_direccion_fija(CONTEXTO_ASM *ctx, int direccion) {
+  INFO_OPTIMIZACION *info = &ctx->info_optimizacion;
+
+  if (info->num_fijas == info->capacidad_fijas) {
+    info->capacidad_fijas = info->capacidad_fijas ? info->capacidad_fijas * 2 : 16;
+    info->fijas = realloc(info->fijas, info->capacidad_fijas * sizeof(int));
+  }
+  info->fijas[info->num_fijas++] = direccion;
+}
+
+//Funcion para liberar la informacion recogida (queda vacia)
+void desalojar_info_optimizacion(INFO_OPTIMIZACION *info) {
+  const INFO_OPTIMIZACION info_vacia = INFO_OPTIMIZACION_VACIA;
+
+  free(info->fijas);
+  *info = info_vacia;
+}
+
+//Funcion que optimiza la memoria de programa del contexto. Debe invocarse despues del paso 2 y
+//antes de desalojar la lista de simbolos (las etiquetas se corrigen si se mueven instrucciones)
+void optimizar_programa(CONTEXTO_ASM *ctx, ESTADISTICAS_OPTIMIZACION *estadisticas) {
+  PROGRAMA p;
+  INFO_OPTIMIZACION *info = &ctx->info_optimizacion;
+  bool compactar = true;
+  int direccion, cambios, rondas;
+
+  estadisticas->eliminadas = 0;
+  estadisticas->saltos_encadenados = 0;
+  estadisticas->llamadas_de_cola = 0;
+
+  //Copia el programa a arreglos indexados por direccion (mas comodos de recorrer y modificar)
+  p.ctx = ctx;
+  p.tam = ctx->tam_prg;
+  p.estadisticas = estadisticas;
+  p.instr = calloc(p.tam, sizeof(uint32_t));
+  p.destino = malloc(p.tam * sizeof(int));
+  p.estado = calloc(p.tam, sizeof(uint8_t));
+  p.mapa = malloc((p.tam + 1) * sizeof(int));
+  contar_alojamiento(p.tam * sizeof(uint32_t));
+  contar_alojamiento(p.tam * sizeof(int));
+  contar_alojamiento(p.tam * sizeof(uint8_t));
+  contar_alojamiento((p.tam + 1) * sizeof(int));
+  for (direccion=0; direccion<p.tam; direccion++) {
+    p.destino[direccion] = -1;
+    if (!localidad_prg_ocupada(&ctx->imagen, direccion)) continue;
+    p.estado[direccion] = LOC_OCUPADA;
+    p.instr[direccion] = leer_dato_prg(&ctx->imagen, direccion);
+    if (ES_SALTO_DIRECTO(p.instr[direccion]))
+      p.destino[direccion] = (direccion + (int16_t) p.instr[direccion]) & (p.tam - 1);
+
+    //Un salto indirecto puede llegar a cualquier direccion, asi que nada se puede mover
+    if (compactar && ES_SALTO_INDIRECTO(p.instr[direccion])) {
+      msg_optimizacion_salto_indirecto(ctx, direccion);
+      compactar = false;
+    }
+  }
+
+  //Tampoco se puede mover nada si alguna direccion de programa se usa como dato
+  if (compactar && info->referencias_prg) {
+    seleccionar_fuente(ctx, info->fuente_referencia);
+    msg_optimizacion_referencia_prg(ctx, info->lin_referencia);
+    compactar = false;
+  }
+  estadisticas->compactado = compactar;
+
+  //Aplica las transformaciones hasta que ya no haya cambios
+  dividir_segmentos(&p, compactar);
+  for (rondas=0, cambios=1; cambios && rondas<MAX_RONDAS; rondas++) {
+    cambios = 0;
+    marcar_destinos(&p);
+    for (direccion=0; direccion<p.tam; direccion++)
+      if ((p.estado[direccion] & (LOC_OCUPADA | LOC_ELIMINADA)) == LOC_OCUPADA)
+        cambios += optimizar_instruccion(&p, direccion);
+  }
+
+  //Finalmente mueve las instrucciones y corrige saltos y etiquetas
+  reubicar(&p);
+
+  free(p.instr);
+  free(p.destino);
+  free(p.estado);
+  free(p.mapa);
+}
+
+//Funcion que obtiene las banderas que escribe una instruccion que solo modifica banderas (cero si
+//la instruccion hace algo mas)
+static int banderas_escritas(uint32_t instr) {
+  if (instr >> 22 == 0b0001) return instr >> 16 & 0x1F;                 //setX y clrX (IVNZC)
+  if (instr >> 21 == 0b00100) return BANDERA_Z | BANDERA_N;             //test
+  if (instr >> 21 == 0b00101) return BANDERA_C | BANDERA_Z | BANDERA_N | BANDERA_V; //cmp
+  return 0;
+}
+
+//Funcion que determina si una instruccion es setX o clrX
+static bool es_cambio_banderas(uint32_t instr) {
+  return instr >> 22 == 0b0001;
+}
+
+//Funcion que divide la memoria de programa en segmentos de instrucciones contiguas. Un segmento
+//inicia despues de un hueco o en una direccion fija (ubicada con code, el reinicio o el vector de
+//interrupcion), y solo se compacta si no continua en otro segmento inmediatamente despues
+static void dividir_segmentos(PROGRAMA *p, bool compactar) {
+  INFO_OPTIMIZACION *info = &p->ctx->info_optimizacion;
+  int direccion, inicio, i;
+
+  for (i=0; i<info->num_fijas; i++)
+    if (info->fijas[i] >= 0 && info->fijas[i] < p->tam) p->estado[info->fijas[i]] |= LOC_FIJA;
+  p->estado[0] |= LOC_FIJA;
+  p->estado[p->tam - 1] |= LOC_FIJA;
+
+  for (direccion=0; direccion<p->tam; direccion++) {
+    if (!(p->estado[direccion] & LOC_OCUPADA)) continue;
+
+    //Busca el final del segmento que inicia aqui
+    inicio = direccion;
+    while (direccion + 1 < p->tam && (p->estado[direccion + 1] & (LOC_OCUPADA | LOC_FIJA)) ==
+           LOC_OCUPADA)
+      direccion++;
+    p->estado[inicio] |= LOC_FIJA;
+    p->estado[direccion] |= LOC_FIN;
+
+    //Si el segmento siguiente esta pegado a este, el final no se puede mover
+    if (!compactar || (direccion + 1 < p->tam && (p->estado[direccion + 1] & LOC_OCUPADA)))
+      continue;
+    for (i=inicio; i<=direccion; i++) p->estado[i] |= LOC_COMPACTABLE;
+  }
+}
+
+//Funcion que marca las localidades que son destino de algun salto o llamada directa
+static void marcar_destinos(PROGRAMA *p) {
+  int direccion;
+
+  for (direccion=0; direccion<p->tam; direccion++) p->estado[direccion] &= ~LOC_DESTINO;
+  for (direccion=0; direccion<p->tam; direccion++)
+    if (p->destino[direccion] >= 0 && !(p->estado[direccion] & LOC_ELIMINADA))
+      p->estado[sobreviviente(p, p->destino[direccion])] |= LOC_DESTINO;
+}
+
+//Funcion que obtiene la instruccion que se ejecuta despues de la indicada dentro del mismo
+//segmento (saltando las eliminadas), o -1 si es la ultima del segmento
+static int siguiente(const PROGRAMA *p, int direccion) {
+  if (p->estado[direccion] & LOC_FIN) return -1;
+  return sobreviviente(p, direccion + 1);
+}
+
+//Funcion que obtiene la primera instruccion no eliminada a partir de una direccion (la ultima de
+//cada segmento nunca se elimina, asi que siempre existe si la direccion esta ocupada)
+static int sobreviviente(const PROGRAMA *p, int direccion) {
+  while (p->estado[direccion] & LOC_ELIMINADA) direccion++;
+  return direccion;
+}
+
+//Funcion que elimina una instruccion si su segmento lo permite (retorna false si no se pudo)
+static bool eliminar(PROGRAMA *p, int direccion) {
+  if ((p->estado[direccion] & (LOC_COMPACTABLE | LOC_FIN)) != LOC_COMPACTABLE) return false;
+  p->estado[direccion] |= LOC_ELIMINADA;
+  p->estadisticas->eliminadas++;
+  return true;
+}
+
+//Funcion que redirige un salto o llamada directa al destino final de una cadena de saltos
+static bool encadenar(PROGRAMA *p, int direccion) {
+  uint32_t instr = p->instr[direccion], instr_destino;
+  int destino_final = p->destino[direccion], destino, pasos;
+
+  for (pasos=0; pasos<MAX_ENCADENADOS; pasos++) {
+    if (!(p->estado[destino_final] & LOC_OCUPADA)) break;
+    destino = sobreviviente(p, destino_final);
+    instr_destino = p->instr[destino];
+
+    //Se sigue un salto incondicional directo, o un salto condicional con la misma condicion si
+    //el que se encadena es un salto condicional (no una llamada)
+    if (instr_destino >> 20 != INSTR_JMP &&
+        (instr >> 22 & 1 || !(instr >> 21 & 1) || instr_destino >> 16 != instr >> 16))
+      break;
+    if (destino == direccion || p->destino[destino] == destino) break;     //Ciclos
+    destino_final = p->destino[destino];
+  }
+
+  if (destino_final == p->destino[direccion]) return false;
+  p->destino[direccion] = destino_final;
+  p->estado[direccion] |= LOC_MODIFICADA;
+  p->estadisticas->saltos_encadenados++;
+  return true;
+}
+
+//Funcion que aplica las transformaciones a una instruccion (retorna la cantidad de cambios)
+static int optimizar_instruccion(PROGRAMA *p, int direccion) {
+  uint32_t instr = p->instr[direccion];
+  int sig = siguiente(p, direccion);
+  int cambios = 0, banderas;
+
+  if (ES_SALTO_DIRECTO(instr)) {
+    cambios += encadenar(p, direccion);
+
+    //Una llamada seguida de return se convierte en salto (el return del destino regresa
+    //directamente a quien llamo a esta rutina)
+    if (instr >> 22 & 1 && sig >= 0 && p->instr[sig] == INSTR_RETURN) {
+      p->instr[direccion] = instr &= ~(1 << 22);
+      p->estadisticas->llamadas_de_cola++;
+      cambios++;
+    }
+
+    //Un salto a la instruccion siguiente no hace nada
+    if (!(instr >> 22 & 1) && sig >= 0 && (p->estado[p->destino[direccion]] & LOC_OCUPADA) &&
+        sobreviviente(p, p->destino[direccion]) == sig && eliminar(p, direccion))
+      return cambios + 1;
+
+    //Un return despues de un salto incondicional solo se alcanza si es destino de otro salto
+    if (instr >> 20 == INSTR_JMP && sig >= 0 && p->instr[sig] == INSTR_RETURN &&
+        !(p->estado[sig] & (LOC_DESTINO | LOC_FIJA)) && eliminar(p, sig))
+      cambios++;
+    return cambios;
+  }
+
+  //move rX, rX no modifica nada (move no afecta las banderas)
+  if (instr >> 20 == 0b111011 && (instr >> 16 & 0xF) == (instr >> 12 & 0xF))
+    return eliminar(p, direccion);
+
+  //Una instruccion que solo escribe banderas no sirve si la siguiente sobrescribe todas ellas
+  //sin leerlas (setX, clrX, test y cmp no leen banderas)
+  banderas = banderas_escritas(instr);
+  if (!banderas || sig < 0 || !banderas_escritas(p->instr[sig])) return 0;
+  if ((banderas & ~banderas_escritas(p->instr[sig])) == 0) return eliminar(p, direccion);
+
+  //Dos setX (o clrX) seguidas se combinan en una sola si a la segunda no se llega por un salto
+  if (es_cambio_banderas(instr) && es_cambio_banderas(p->instr[sig]) &&
+      (instr >> 21 & 1) == (p->instr[sig] >> 21 & 1) &&
+      !(p->estado[sig] & (LOC_DESTINO | LOC_FIJA)) && eliminar(p, sig)) {
+    p->instr[direccion] |= p->instr[sig] & (0x1F << 16);
+    return 1;
+  }
+  return 0;
+}
+
+//Funcion que mueve las instrucciones que quedan al inicio de su segmento y corrige los saltos y
+//las etiquetas de programa con la nueva ubicacion de cada direccion
+static void reubicar(PROGRAMA *p) {
+  CONTEXTO_ASM *ctx = p->ctx;
+  SIMBOLO *simbolo;
+  int direccion, nueva, destino, inicio;
+
+  //Arma el mapa de direcciones: una instruccion eliminada pasa a ser la siguiente que queda, y la
+  //direccion posterior a un segmento pasa a ser la posterior a su nuevo final
+  for (direccion=0; direccion<=p->tam; direccion++) p->mapa[direccion] = direccion;
+  for (direccion=0; direccion<p->tam; direccion++) {
+    if (!(p->estado[direccion] & LOC_OCUPADA)) continue;
+    for (inicio=direccion, nueva=direccion; ; direccion++) {
+      if (!(p->estado[direccion] & LOC_ELIMINADA)) p->mapa[direccion] = nueva++;
+      if (p->estado[direccion] & LOC_FIN) break;
+    }
+    for (destino=direccion; destino>=inicio; destino--)
+      if (p->estado[destino] & LOC_ELIMINADA) p->mapa[destino] = p->mapa[destino + 1];
+    if (!(p->estado[direccion] & LOC_COMPACTABLE)) continue;
+    if (direccion + 1 == p->tam || !(p->estado[direccion + 1] & LOC_OCUPADA))
+      p->mapa[direccion + 1] = nueva;
+  }
+
+  //Reescribe la memoria de programa con las instrucciones que quedan, recodificando los saltos
+  //que se movieron o cuyo destino se movio o cambio
+  desalojar_imagen_prg(&ctx->imagen);
+  for (direccion=0; direccion<p->tam; direccion++) {
+    if ((p->estado[direccion] & (LOC_OCUPADA | LOC_ELIMINADA)) != LOC_OCUPADA) continue;
+    nueva = p->mapa[direccion];
+    destino = p->destino[direccion];
+    if (destino >= 0 && (p->estado[direccion] & LOC_MODIFICADA || nueva != direccion ||
+                         p->mapa[destino] != destino))
+      p->instr[direccion] = (p->instr[direccion] & ~0xFFFF) |
+                            ((p->mapa[destino] - nueva) & 0xFFFF);
+    escribir_dato_prg(&ctx->imagen, nueva, p->instr[direccion]);
+    mover_linea_prg(&ctx->info_listado, direccion, nueva);  //La linea se mueve con ella
+  }
+
+  //Corrige las etiquetas de programa
+  for (simbolo=primer_simbolo(&ctx->lista_simbolos); simbolo; simbolo=simbolo->siguiente)
+    if (simbolo->definido && simbolo->reubicacion == REUB_PRG && simbolo->valor >= 0 &&
+        simbolo->valor <= p->tam)
+      simbolo->valor = p->mapa[simbolo->valor];
+}
@@ -0,0 +1,54 @@
+#ifndef j16asm_optimizador_h_Incluida
+#define j16asm_optimizador_h_Incluida
+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+
+//Constantes exportadas
+//---------------------
+//Macro que determina si una instruccion es un salto o llamada directa (con destino relativo en el
+//literal de la instruccion): los codigos 010000, 010010, 010100 y 010110 en los bits 25 a 20
+#define ES_SALTO_DIRECTO(instr) (((instr) >> 20 & 0b111001) == 0b010000)
+
+//Macro que determina si una instruccion es un salto o llamada indirecta (a traves de registro):
+//los codigos 010001, 010011, 010101 y 010111 en los bits 25 a 20
+#define ES_SALTO_INDIRECTO(instr) (((instr) >> 20 & 0b111001) == 0b010001)
+
+//Tipos de datos exportados
+//-------------------------
+//Estructura con lo que el ensamblado recoge para el optimizador (ademas de la imagen de memoria)
+typedef struct _INFO_OPTIMIZACION {
+  bool usa_direccion_prg;               //La linea actual usa una direccion de programa como valor
+  int referencias_prg;                  //Usos de direcciones de programa fuera de los saltos
+  int fuente_referencia;                //Archivo fuente de la primera de ellas
+  int lin_referencia;                   //Linea de la primera de ellas
+  int *fijas;                           //Direcciones de programa fijadas con la directiva code
+  int num_fijas;                        //Cantidad de direcciones fijadas
+  int capacidad_fijas;                  //Cantidad de direcciones que caben en el arreglo actual
+} INFO_OPTIMIZACION;
+
+//Inicializador de la informacion vacia
+#define INFO_OPTIMIZACION_VACIA { false, 0, 0, 0, NULL, 0, 0 }
+
+//Estadisticas de una optimizacion
+typedef struct _ESTADISTICAS_OPTIMIZACION {
+  int eliminadas;                       //Instrucciones eliminadas (cada una ahorra 2 ciclos)
+  int saltos_encadenados;               //Saltos y llamadas redirigidos al destino final
+  int llamadas_de_cola;                 //Llamadas seguidas de return convertidas en saltos
+  bool compactado;                      //Indica si se pudieron eliminar instrucciones
+} ESTADISTICAS_OPTIMIZACION;
+
+//Declaracion previa del contexto de ensamblado (definido en j16asm.h)
+struct _CONTEXTO_ASM;
+
+//Funciones exportadas
+//--------------------
+//Funciones que usa el ensamblado para recoger la informacion
+extern void registrar_referencia_prg(struct _CONTEXTO_ASM *ctx, int fuente, int num_lin);
+extern void registrar_direccion_fija(struct _CONTEXTO_ASM *ctx, int direccion);
+extern void desalojar_info_optimizacion(INFO_OPTIMIZACION *info);
+
+//Funcion que optimiza la memoria de programa (despues del paso 2)
+extern void optimizar_programa(struct _CONTEXTO_ASM *ctx,
+                               ESTADISTICAS_OPTIMIZACION *estadisticas);
+
+#endif //j16asm_optimizador_h_Incluida
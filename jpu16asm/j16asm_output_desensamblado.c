@@ -0,0 +1,83 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_output_desensamblado.c                                                                 |
+//| Modulo de generacion del desensamblado de las memorias                                        |
+//|                                                                                               |
+//| Este modulo implementa un formato de salida que escribe el contenido de la imagen de memoria  |
+//| como codigo fuente: cada instruccion de la memoria de programa se desensambla mediante la     |
+//| tabla de instrucciones (ver el modulo j16asm_instrucciones) y cada palabra de la RAM se       |
+//| escribe como una directiva word. Cada linea lleva como comentario la direccion y el codigo,   |
+//| y las localidades libres se omiten, iniciando una directiva code o data con direccion cada    |
+//| vez que se reanuda el contenido. Los saltos y llamadas directas se escriben con su destino    |
+//| absoluto, de manera que el archivo se puede volver a ensamblar para obtener la misma imagen   |
+//| (las banderas combinadas por el optimizador se escriben como lista, p. ej. setc | setz).     |
+//+-----------------------------------------------------------------------------------------------+
+#include <stddef.h>                     //Incluye la definicion de NULL
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+#include "j16asm_output_desensamblado.h"  //Cabecera propia
+#include "j16asm_instrucciones.h"       //Importa el desensamblado de instrucciones
+#include "j16asm_salida.h"              //Importa las funciones de formato de la etapa de salida
+
+//Constantes del modulo
+#define TAM_TEXTO_INSTR     48          //Espacio para el texto de una instruccion
+#define ANCHO_INSTR         30          //Ancho de la instruccion (luego sigue el comentario)
+
+//Declaracion previa de las funciones locales al modulo
+static void generar_des_inicio(ARCHIVO_SALIDA *salida);
+static void generar_des_prg(ARCHIVO_SALIDA *salida, int indice,
+                            const uint32_t *datos, const uint64_t *ocupacion);
+static void generar_des_medio(ARCHIVO_SALIDA *salida);
+static void generar_des_ram(ARCHIVO_SALIDA *salida, int indice,
+                            const uint16_t *datos, const uint64_t *ocupacion);
+
+//Descriptor del formato exportado a la etapa de salida
+const FORMATO_SALIDA formato_desensamblado = {
+  generar_des_inicio, generar_des_prg, generar_des_medio, generar_des_ram, NULL
+};
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion para generar el inicio del desensamblado
+static void generar_des_inicio(ARCHIVO_SALIDA *salida) {
+  salida_formato(salida, "; Memoria de programa (%i instrucciones)\n", salida->tam_prg);
+}
+
+//Funcion de generacion de las instrucciones de un bloque de la memoria de programa
+static void generar_des_prg(ARCHIVO_SALIDA *salida, int indice,
+                            const uint32_t *datos, const uint64_t *ocupacion) {
+  char texto[TAM_TEXTO_INSTR];
+  int i, direccion;
+
+  for (i=0; i<TAM_BLOQUE_PRG; i++) {
+    if (!LOCALIDAD_OCUPADA(ocupacion, i)) continue;  //Las localidades libres se omiten
+    direccion = indice*TAM_BLOQUE_PRG + i;
+
+    //Al inicio de cada tramo ocupado se indica su direccion
+    if (i == 0 || !LOCALIDAD_OCUPADA(ocupacion, i-1))
+      salida_formato(salida, "code 0x%.4X\n", direccion);
+
+    //Se escribe la instruccion seguida de su direccion y su codigo como comentario
+    desensamblar_instruccion(datos[i], direccion, salida->tam_prg, texto, sizeof(texto));
+    salida_formato(salida, "  %-*s ; 0x%.4X  %.8X\n", ANCHO_INSTR, texto, direccion, datos[i]);
+  }
+}
+
+//Funcion para generar la separacion entre la memoria de programa y la RAM
+static void generar_des_medio(ARCHIVO_SALIDA *salida) {
+  salida_formato(salida, "\n; Memoria RAM (%i palabras)\n", salida->tam_ram);
+}
+
+//Funcion de generacion de los datos de un bloque de la memoria RAM
+static void generar_des_ram(ARCHIVO_SALIDA *salida, int indice,
+                            const uint16_t *datos, const uint64_t *ocupacion) {
+  int i, direccion;
+
+  for (i=0; i<TAM_BLOQUE_RAM; i++) {
+    if (!LOCALIDAD_OCUPADA(ocupacion, i)) continue;
+    direccion = indice*TAM_BLOQUE_RAM + i;
+    if (i == 0 || !LOCALIDAD_OCUPADA(ocupacion, i-1))
+      salida_formato(salida, "data 0x%.4X\n", direccion);
+    salida_formato(salida, "  word 0x%.4X%*s ; 0x%.4X\n", datos[i], ANCHO_INSTR - 11, "",
+                   direccion);
+  }
+}
@@ -0,0 +1,10 @@
+#ifndef j16asm_output_desensamblado_h_Incluida
+#define j16asm_output_desensamblado_h_Incluida
+
+#include "j16asm_salida.h"              //Incluye la definicion del tipo FORMATO_SALIDA
+
+//Datos exportados
+//----------------
+extern const FORMATO_SALIDA formato_desensamblado;
+
+#endif //j16asm_output_desensamblado_h_Incluida
@@ -10,113 +10,128 @@
 //| la utilidad data2mem de Xilinx a la hora de sustituir el contenido de los bloques de memoria  |
 //| del FPGA.                                                                                     |
 //+-----------------------------------------------------------------------------------------------+
-#include <stdbool.h>                //Incluye la definicion del tipo de dato bool
-#include <stdio.h>                  //Permite manejar archivos
+#include <stddef.h>                 //Incluye la definicion de NULL
+#include <stdint.h>                 //Incluye los tipos de datos de tamaño fijo
 #include "j16asm_output_mem_bmm.h"  //Cabecera propia
-#include "j16asm.h"                 //Importa los arreglos con los datos de memoria
-#include "j16asm_messages.h"        //Permite enviar mensajes al usuario
+#include "j16asm_salida.h"          //Importa las funciones de formato de la etapa de salida
+
+//Constantes de distribucion de los datos en los archivos MEM
+#define DATOS_POR_LINEA_PRG  8          //Instrucciones por linea de texto
+#define DATOS_POR_LINEA_RAM  16         //Palabras de RAM por linea de texto
+
+//Declaracion previa de las funciones locales al modulo
+static void generar_mem_prg(ARCHIVO_SALIDA *salida, int indice,
+                            const uint32_t *datos, const uint64_t *ocupacion);
+static void generar_mem_ram(ARCHIVO_SALIDA *salida, int indice,
+                            const uint16_t *datos, const uint64_t *ocupacion);
+static void generar_bmm_inicio(ARCHIVO_SALIDA *salida);
+static void generar_bmm_prg(ARCHIVO_SALIDA *salida, int indice,
+                            const uint32_t *datos, const uint64_t *ocupacion);
+static void generar_bmm_medio(ARCHIVO_SALIDA *salida);
+static void generar_bmm_ram(ARCHIVO_SALIDA *salida, int indice,
+                            const uint16_t *datos, const uint64_t *ocupacion);
+static void generar_bmm_final(ARCHIVO_SALIDA *salida);
+
+//Descriptores de los formatos exportados a la etapa de salida
+const FORMATO_SALIDA formato_mem = {
+  NULL, generar_mem_prg, NULL, generar_mem_ram, NULL
+};
+
+const FORMATO_SALIDA formato_bmm = {
+  generar_bmm_inicio, generar_bmm_prg, generar_bmm_medio, generar_bmm_ram, generar_bmm_final
+};
 
 //+------------------------------+
 //| Inicio del codigo del modulo |
 //+------------------------------+-----------------------------------------------------------------
-//Funcion de generacion de archivos con formato MEM (contenido para BRAM en hexadecimal)
-bool generar_salida_mem() {
-  FILE *fp_archivo = NULL;
+//Funcion de generacion de las lineas MEM de un bloque de la memoria de programa
+static void generar_mem_prg(ARCHIVO_SALIDA *salida, int indice,
+                            const uint32_t *datos, const uint64_t *ocupacion) {
   int i, j;
-  const int DatosPorLineaPrg = 8;
-  const int DatosPorLineaRam = 16;
-
-  //Primeramente se crea el archivo de salida
-  fp_archivo = fopen(nombre_archivo_mem, "w");
-  if (!fp_archivo) {
-    msg_error_crear_archivo_salida(nombre_archivo_mem);
-    return false;
-  }
 
-  //Luego se rastrea la memoria de programa para generar los datos de salida (linea por linea)
-  for (i=0; i<tam_prg; i+=DatosPorLineaPrg) {
-    //Se genera el inicio de una linea de texto
-    fprintf(fp_archivo, "@%.5X", i*4);
+  //Se rastrea el bloque para generar los datos de salida (linea por linea)
+  for (i=0; i<TAM_BLOQUE_PRG; i+=DATOS_POR_LINEA_PRG) {
+    //Se genera el inicio de una linea de texto con la direccion en bytes
+    salida_cadena(salida, "@");
+    salida_hex(salida, (indice*TAM_BLOQUE_PRG + i) * 4, 5);
 
     //Se generan los datos que contiene la linea
-    for (j=0; j<DatosPorLineaPrg; j++) {
+    for (j=0; j<DATOS_POR_LINEA_PRG; j++) {
       //Nota: El inicio de la linea actual es apuntado por la variable "i", pero la posicion dentro
       //de la linea es apuntada por la variable "j"
-      fprintf(fp_archivo, " %.8X", datos_prg[i+j] & ~MASC_LIBRE);
+      salida_cadena(salida, " ");
+      salida_hex(salida, datos[i+j], 8);
     }
 
     //Se genera el final de la linea de texto
-    fprintf(fp_archivo, "\n");
+    salida_cadena(salida, "\n");
   }
+}
 
-  //En esta etapa se generan los datos correspondientes a la RAM (linea por linea tambien)
-  for (i=0; i<tam_ram; i+=DatosPorLineaRam) {
-    //Se genera el inicio de una linea de texto
-    fprintf(fp_archivo, "@%.5X", i*2 + 0x10000);
+//Funcion de generacion de las lineas MEM de un bloque de la memoria RAM
+static void generar_mem_ram(ARCHIVO_SALIDA *salida, int indice,
+                            const uint16_t *datos, const uint64_t *ocupacion) {
+  int i, j;
 
-    //Se generan los datos que contiene la linea
-    for (j=0; j<DatosPorLineaRam; j++) {
-      fprintf(fp_archivo, " %.4X", datos_ram[i+j] & ~MASC_LIBRE);
+  //La RAM se ubica a partir de la direccion 0x10000 del espacio global (linea por linea tambien)
+  for (i=0; i<TAM_BLOQUE_RAM; i+=DATOS_POR_LINEA_RAM) {
+    salida_cadena(salida, "@");
+    salida_hex(salida, (indice*TAM_BLOQUE_RAM + i) * 2 + 0x10000, 5);
+
+    for (j=0; j<DATOS_POR_LINEA_RAM; j++) {
+      salida_cadena(salida, " ");
+      salida_hex(salida, datos[i+j], 4);
     }
 
-    //Se genera el final de la linea de texto
-    fprintf(fp_archivo, "\n");
+    salida_cadena(salida, "\n");
   }
-
-  //Al final del proceso, cierra el archivo
-  fclose(fp_archivo);
-  return true;                //Retorna con exito
 }
 
-//Funcion de generacion de archivos con formato BMM (mapas de memoria para BRAM)
-bool generar_salida_bmm() {
-  FILE *fp_archivo = NULL;
-  int i;
-
-  //Primeramente se crea el archivo de salida
-  fp_archivo = fopen(nombre_archivo_bmm, "w");
-  if (!fp_archivo) {
-    msg_error_crear_archivo_salida(nombre_archivo_mem);
-    return false;
-  }
-
-  //Luego se genera la cabecera del archivo, que contiene el tipo de procesador y su ID
-  fprintf(fp_archivo, "ADDRESS_MAP JPU16 PPC405 0\n");
+//Funcion para generar el inicio del archivo BMM y del espacio de memoria de programa
+static void generar_bmm_inicio(ARCHIVO_SALIDA *salida) {
+  //Primeramente se genera la cabecera del archivo, que contiene el tipo de procesador y su ID
+  salida_cadena(salida, "ADDRESS_MAP JPU16 PPC405 0\n");
 
   //Se escribe la definicion del espacio de memoria para el programa
-  fprintf(fp_archivo, "   ADDRESS_SPACE MemoriaPrograma RAMB16 [0x%.5X:0x%.5X]\n",
-          0, tam_prg*4-1);
+  salida_formato(salida, "   ADDRESS_SPACE MemoriaPrograma RAMB16 [0x%.5X:0x%.5X]\n",
+                 0, salida->tam_prg*4-1);
+}
 
-  //Se generan los bloques de bus para cada uno de los bloques de memoria de programa
-  for (i=0; i<tam_prg/512; i++)
-    fprintf(fp_archivo,
-            "      BUS_BLOCK\n"
-            "         CPU/PROG_MEM/MemoriaProg%i [31:0];\n"
-            "      END_BUS_BLOCK;\n",
-            i);
+//Funcion para generar el bloque de bus de un bloque de memoria de programa
+static void generar_bmm_prg(ARCHIVO_SALIDA *salida, int indice,
+                            const uint32_t *datos, const uint64_t *ocupacion) {
+  salida_formato(salida,
+                 "      BUS_BLOCK\n"
+                 "         CPU/PROG_MEM/MemoriaProg%i [31:0];\n"
+                 "      END_BUS_BLOCK;\n",
+                 indice);
+}
 
+//Funcion para generar el cierre del espacio de programa y el inicio del espacio de RAM
+static void generar_bmm_medio(ARCHIVO_SALIDA *salida) {
   //Se escribe el final de la definicion del espacio de memoria
-  fprintf(fp_archivo, "   END_ADDRESS_SPACE;\n");
+  salida_cadena(salida, "   END_ADDRESS_SPACE;\n");
 
   //Se escribe la definicion del espacio de memoria para la RAM
-  fprintf(fp_archivo, "   ADDRESS_SPACE MemoriaRam RAMB16 [0x%.5X:0x%.5X]\n",
-          0x10000, 0x10000 + tam_ram*2 - 1);
+  salida_formato(salida, "   ADDRESS_SPACE MemoriaRam RAMB16 [0x%.5X:0x%.5X]\n",
+                 0x10000, 0x10000 + salida->tam_ram*2 - 1);
+}
 
-  //Se generan los bloques de bus para cada uno de los bloques de la memoria de datos
-  for (i=0; i<tam_ram/1024; i++)
-    fprintf(fp_archivo,
-            "      BUS_BLOCK\n"
-            "         CPU/RAM/MemoriaRam%i [15:0];\n"
-            "      END_BUS_BLOCK;\n",
-            i);
+//Funcion para generar el bloque de bus de un bloque de memoria RAM
+static void generar_bmm_ram(ARCHIVO_SALIDA *salida, int indice,
+                            const uint16_t *datos, const uint64_t *ocupacion) {
+  salida_formato(salida,
+                 "      BUS_BLOCK\n"
+                 "         CPU/RAM/MemoriaRam%i [15:0];\n"
+                 "      END_BUS_BLOCK;\n",
+                 indice);
+}
 
+//Funcion para generar el final del archivo BMM
+static void generar_bmm_final(ARCHIVO_SALIDA *salida) {
   //Se escribe el final de la definicion del espacio de memoria
-  fprintf(fp_archivo, "   END_ADDRESS_SPACE;\n");
+  salida_cadena(salida, "   END_ADDRESS_SPACE;\n");
 
   //Se escribe el final de la definicion del mapa de memoria
-  fprintf(fp_archivo, "END_ADDRESS_MAP;");
-
-  //Al final del proceso, cierra el archivo
-  fclose(fp_archivo);
-  return true;                //Retorna con exito
+  salida_cadena(salida, "END_ADDRESS_MAP;");
 }
\ No newline at end of file
@@ -1,9 +1,11 @@
 #ifndef j16asm_output_mem_bmm_h_Incluida
 #define j16asm_output_mem_bmm_h_Incluida
 
-//Funciones exportadas
-//--------------------
-extern bool generar_salida_mem();
-extern bool generar_salida_bmm();
+#include "j16asm_salida.h"              //Incluye la definicion del tipo FORMATO_SALIDA
+
+//Datos exportados
+//----------------
+extern const FORMATO_SALIDA formato_mem;
+extern const FORMATO_SALIDA formato_bmm;
 
 #endif //j16asm_output_mem_bmm_h_Incluida
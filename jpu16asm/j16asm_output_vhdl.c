@@ -13,10 +13,9 @@
 //| requiere que se hagan sintesis completas al actualizar el codigo fuente del programa, lo cual |
 //| consume tiempo.                                                                               |
 //+-----------------------------------------------------------------------------------------------+
-#include <stdio.h>              //Permite invocar las funciones de manejo de archivos
+#include <stdint.h>             //Incluye los tipos de datos de tamaño fijo
 #include "j16asm_output_vhdl.h" //Cabecera propia
-#include "j16asm.h"             //Importa los arreglos con los datos de memoria
-#include "j16asm_messages.h"    //Permite generar mensajes de error
+#include "j16asm_salida.h"      //Importa las funciones de formato de la etapa de salida
 
 //+----------------------------------+
 //| Plantillas de codigo fuente VHDL |
@@ -126,107 +125,109 @@ static const char plantilla_vhdl_3[] =
 //-------------------------------------------------------------------------------------------------
 
 //Declaracion previa de las funciones locales al modulo
-static void generar_datos_prg(FILE *fp_archivo);
-static void generar_datos_ram(FILE *fp_archivo);
+static void generar_inicio(ARCHIVO_SALIDA *salida);
+static void generar_bloque_prg(ARCHIVO_SALIDA *salida, int indice,
+                               const uint32_t *datos, const uint64_t *ocupacion);
+static void generar_medio(ARCHIVO_SALIDA *salida);
+static void generar_bloque_ram(ARCHIVO_SALIDA *salida, int indice,
+                               const uint16_t *datos, const uint64_t *ocupacion);
+static void generar_final(ARCHIVO_SALIDA *salida);
+
+//Descriptor del formato exportado a la etapa de salida
+const FORMATO_SALIDA formato_vhdl = {
+  generar_inicio, generar_bloque_prg, generar_medio, generar_bloque_ram, generar_final
+};
 
 //+------------------------------+
 //| Inicio del codigo del modulo |
 //+------------------------------+-----------------------------------------------------------------
-//Funcion para generar los datos de salida del ensamblador en formato VHDL
-bool generar_salida_vhdl() {
-  FILE *fp_archivo = NULL;
+//Funcion para generar el inicio del archivo (hasta la apertura de la constante de programa)
+static void generar_inicio(ARCHIVO_SALIDA *salida) {
   int i;
   int nbits_dir_prg;
   int nbits_dir_ram;
 
-  //Primeramente se crea el archivo de salida
-  fp_archivo = fopen(nombre_archivo_vhd, "w");
-  if (!fp_archivo) {
-    msg_error_crear_archivo_salida(nombre_archivo_vhd);
-    return false;
-  }
-
   //Se determina la cantidad de bits que contendra el bus de direcciones de programa
   nbits_dir_prg = 0;  //Inicia la cuenta a 0
-  for (i=tam_prg; i>>=1; nbits_dir_prg++);
+  for (i=salida->tam_prg; i>>=1; nbits_dir_prg++);
 
   //Se determina la cantidad de bits que contendra el bus de direcciones de RAM
   nbits_dir_ram = 0;
-  for (i=tam_ram; i>>=1; nbits_dir_ram++);
+  for (i=salida->tam_ram; i>>=1; nbits_dir_ram++);
 
   //Generacion del codigo VHDL asociado al paquete con las definiciones de tamaños
   //-----------------------------------------------------------------------------------------------
 
   //Se procede a escribir la plantilla inicial
-  fprintf(fp_archivo, plantilla_vhdl_0);
+  salida_cadena(salida, plantilla_vhdl_0);
 
   //Se escriben las lineas de codigo con las dimensiones de la memoria
-  fprintf(fp_archivo, codigo_vhdl_0, nbits_dir_prg, nbits_dir_ram);
+  salida_formato(salida, codigo_vhdl_0, nbits_dir_prg, nbits_dir_ram);
 
   //Generacion del codigo VHDL asociado a la memoria de programa
   //-----------------------------------------------------------------------------------------------
 
   //Se escribe la plantilla con la definicion de entidad y arquitectura de la memoria de programa
-  fprintf(fp_archivo, plantilla_vhdl_1);
-
-  //Se generan las constantes con los datos de la memoria de programa
-  generar_datos_prg(fp_archivo);
-
-  //Se escribe la plantilla con la definicion de la parte operativa de la arquitectura de la
-  //memoria de programa y la apertura de la definicion de la memoria RAM del procesador
-  fprintf(fp_archivo, plantilla_vhdl_2);
+  salida_cadena(salida, plantilla_vhdl_1);
+}
 
-  //Generacion del codigo VHDL asociado a la memoria RAM
-  //-----------------------------------------------------------------------------------------------
+//Funcion para generar las lineas de inicializacion de un bloque de la memoria de programa
+static void generar_bloque_prg(ARCHIVO_SALIDA *salida, int indice,
+                               const uint32_t *datos, const uint64_t *ocupacion) {
+  int i;
 
-  //Se generan las constantes con los datos iniciales de la memoria RAM
-  generar_datos_ram(fp_archivo);
+  //Recorre unicamente las localidades usadas del bloque (las libres se saltan directamente)
+  for (i=0; i<TAM_BLOQUE_PRG; i++) {
+    if (!LOCALIDAD_OCUPADA(ocupacion, i)) continue;
 
-  //Se escribe la plantilla con la definicion de la parte operativa de la arquitectura
-  fprintf(fp_archivo, plantilla_vhdl_3);
+    //Escribe el inicio de la linea con su direccion
+    salida_cadena(salida, "      ");
+    salida_decimal(salida, indice*TAM_BLOQUE_PRG + i);
+    salida_cadena(salida, " => B\"");
 
-  //Al final del proceso, cierra el archivo
-  fclose(fp_archivo);
-  return true;                //Retorna con exito
-}
+    //Luego escribe el codigo de operacion en notacion binaria con separadores (6_4_16 bits)
+    salida_binario(salida, datos[i] >> 20, 6);
+    salida_cadena(salida, "_");
+    salida_binario(salida, datos[i] >> 16, 4);
+    salida_cadena(salida, "_");
+    salida_binario(salida, datos[i], 16);
 
-//Funcion para generar los datos de inicializacion de los bloques de RAM con el programa
-void generar_datos_prg(FILE *fp_archivo) {
-  int i;
-  int pos_mem;
-
-  for (pos_mem=0; pos_mem<tam_prg; pos_mem++) {
-    //Verifica si la localidad de programa esta usada
-    if (!(datos_prg[pos_mem] & MASC_LIBRE)) {
-      //De estar usada, escribe el inicio de la linea con su direccion
-      fprintf(fp_archivo, "      %i => B\"", pos_mem);
-
-      //Luego escribe el codigo de operacion en notacion binaria con separadores
-      for (i=25; i>=0; i--) {
-        fprintf(fp_archivo, "%i", (datos_prg[pos_mem] & 1 << i) != 0);
-        if (i == 16 || i == 20) fprintf(fp_archivo, "_");
-      }
-
-      //Escribe el final de la linea
-      fprintf(fp_archivo, "\",\n");
-    }
+    //Escribe el final de la linea
+    salida_cadena(salida, "\",\n");
   }
+}
 
+//Funcion para generar el cierre de la memoria de programa y la apertura de la memoria RAM
+static void generar_medio(ARCHIVO_SALIDA *salida) {
   //Agrega la linea que rellena las localidades sin usar
-  fprintf(fp_archivo, "      others => B\"000000_0000_0000000000000000\"\n");
+  salida_cadena(salida, "      others => B\"000000_0000_0000000000000000\"\n");
+
+  //Se escribe la plantilla con la definicion de la parte operativa de la arquitectura de la
+  //memoria de programa y la apertura de la definicion de la memoria RAM del procesador
+  salida_cadena(salida, plantilla_vhdl_2);
 }
 
-//Funcion para generar los datos de inicializacion de los bloques de RAM con los datos
-void generar_datos_ram(FILE *fp_archivo) {
-  int pos_mem;
+//Funcion para generar las lineas de inicializacion de un bloque de la memoria RAM
+static void generar_bloque_ram(ARCHIVO_SALIDA *salida, int indice,
+                               const uint16_t *datos, const uint64_t *ocupacion) {
+  int i;
 
-  for (pos_mem=0; pos_mem<tam_ram; pos_mem++) {
-    //Verifica si la localidad de RAM esta usada
-    if (!(datos_ram[pos_mem] & MASC_LIBRE))
-      //De estar usada, escribe su contenido
-      fprintf(fp_archivo, "      %i => X\"%.4X\",\n", pos_mem, datos_ram[pos_mem]);
+  //Recorre unicamente las localidades de RAM usadas, escribiendo su contenido
+  for (i=0; i<TAM_BLOQUE_RAM; i++) {
+    if (!LOCALIDAD_OCUPADA(ocupacion, i)) continue;
+    salida_cadena(salida, "      ");
+    salida_decimal(salida, indice*TAM_BLOQUE_RAM + i);
+    salida_cadena(salida, " => X\"");
+    salida_hex(salida, datos[i], 4);
+    salida_cadena(salida, "\",\n");
   }
+}
 
+//Funcion para generar el final del archivo
+static void generar_final(ARCHIVO_SALIDA *salida) {
   //Agrega la linea que rellena las localidades sin usar
-  fprintf(fp_archivo, "      others => X\"0000\"\n");
+  salida_cadena(salida, "      others => X\"0000\"\n");
+
+  //Se escribe la plantilla con la definicion de la parte operativa de la arquitectura
+  salida_cadena(salida, plantilla_vhdl_3);
 }
\ No newline at end of file
@@ -14,10 +14,9 @@
 //| completas a la hora de actualizar el codigo fuente del programa y agilizando dramaticamente   |
 //| el ciclo de desarrollo de aplicaciones.                                                       |
 //+-----------------------------------------------------------------------------------------------+
-#include <stdio.h>                     //Permite invocar las funciones de manejo de archivos
+#include <stdint.h>                    //Incluye los tipos de datos de tamaño fijo
 #include "j16asm_output_vhdl_ramb16.h" //Cabecera propia
-#include "j16asm.h"                    //Importa los arreglos con los datos de memoria
-#include "j16asm_messages.h"           //Permite generar mensajes de error
+#include "j16asm_salida.h"             //Importa las funciones de formato de la etapa de salida
 
 //+----------------------------------+
 //| Plantillas de codigo fuente VHDL |
@@ -164,217 +163,222 @@ static const char plantilla_vhdl_7[] =
 //-------------------------------------------------------------------------------------------------
 
 //Declaracion previa de las funciones locales al modulo
-static void generar_ramb16_prg(FILE *fp_archivo, int indice);
-static void generar_ramb16_ram(FILE *fp_archivo, int indice);
+static void generar_inicio(ARCHIVO_SALIDA *salida);
+static void generar_ramb16_prg(ARCHIVO_SALIDA *salida, int indice,
+                               const uint32_t *datos, const uint64_t *ocupacion);
+static void generar_medio(ARCHIVO_SALIDA *salida);
+static void generar_ramb16_ram(ARCHIVO_SALIDA *salida, int indice,
+                               const uint16_t *datos, const uint64_t *ocupacion);
+static void generar_final(ARCHIVO_SALIDA *salida);
+static void generar_initp(ARCHIVO_SALIDA *salida);
+
+//Descriptor del formato exportado a la etapa de salida
+const FORMATO_SALIDA formato_vhdl_ramb16 = {
+  generar_inicio, generar_ramb16_prg, generar_medio, generar_ramb16_ram, generar_final
+};
 
 //+------------------------------+
 //| Inicio del codigo del modulo |
 //+------------------------------+-----------------------------------------------------------------
-//Funcion para generar los datos de salida del ensamblador en formato VHDL usando primitivas RAMB16
-bool generar_salida_vhdl_ramb16() {
-  FILE *fp_archivo = NULL;
+//Funcion para generar el inicio del archivo (hasta antes de los bloques de programa)
+static void generar_inicio(ARCHIVO_SALIDA *salida) {
   int i;
   int nbits_dir_prg;
   int nbits_dir_ram;
   int num_bloques_prg;
-  int num_bloques_ram;
-
-  //Primeramente se crea el archivo de salida
-  fp_archivo = fopen(nombre_archivo_vhd_r, "w");
-  if (!fp_archivo) {
-    msg_error_crear_archivo_salida(nombre_archivo_vhd);
-    return false;
-  }
 
   //Se determina la cantidad de bits que contendra el bus de direcciones de programa
   nbits_dir_prg = 0;  //Inicia la cuenta a 0
-  for (i=tam_prg; i>>=1; nbits_dir_prg++);
+  for (i=salida->tam_prg; i>>=1; nbits_dir_prg++);
 
   //Se determina la cantidad de bits que contendra el bus de direcciones de RAM
   nbits_dir_ram = 0;
-  for (i=tam_ram; i>>=1; nbits_dir_ram++);
+  for (i=salida->tam_ram; i>>=1; nbits_dir_ram++);
 
-  //Determina la cantidad de bloques para la memoria de programa y RAM
-  num_bloques_prg = tam_prg / 512;
-  num_bloques_ram = tam_ram / 1024;
+  //Determina la cantidad de bloques para la memoria de programa
+  num_bloques_prg = salida->tam_prg / TAM_BLOQUE_PRG;
 
   //Generacion del codigo VHDL asociado al paquete con las definiciones de tamaños
   //-----------------------------------------------------------------------------------------------
 
   //Se procede a escribir la plantilla inicial
-  fprintf(fp_archivo, plantilla_vhdl_0);
+  salida_cadena(salida, plantilla_vhdl_0);
 
   //Se escriben las lineas de codigo con las dimensiones de la memoria
-  fprintf(fp_archivo, codigo_vhdl_0, nbits_dir_prg, nbits_dir_ram);
+  salida_formato(salida, codigo_vhdl_0, nbits_dir_prg, nbits_dir_ram);
 
   //Generacion del codigo VHDL asociado a la memoria de programa
   //-----------------------------------------------------------------------------------------------
 
   //Se escribe la plantilla con la definicion de entidad y arquitectura de la memoria de programa
-  fprintf(fp_archivo, plantilla_vhdl_1);
+  salida_cadena(salida, plantilla_vhdl_1);
 
   //Se escribe la linea con la definicion del tipo de dato del bus que interconecta los bloques
-  fprintf(fp_archivo, codigo_vhdl_1, num_bloques_prg-1);
+  salida_formato(salida, codigo_vhdl_1, num_bloques_prg-1);
 
   //Se escribe la linea con la declaracion del bus de interconexion
-  fprintf(fp_archivo, plantilla_vhdl_2);
+  salida_cadena(salida, plantilla_vhdl_2);
 
   //Se escribe la linea con la declaracion de las señales de seleccion de bloque
-  fprintf(fp_archivo, codigo_vhdl_2, num_bloques_prg-1);
+  salida_formato(salida, codigo_vhdl_2, num_bloques_prg-1);
 
   //Dependiendo de si se generan uno o varios bloques, se escriben las lineas de codigo que
   //describen las operaciones de seleccion de bloque
   if (num_bloques_prg > 1)
-    fprintf(fp_archivo, codigo_vhdl_3_m, num_bloques_prg-1);
+    salida_formato(salida, codigo_vhdl_3_m, num_bloques_prg-1);
   else
-    fprintf(fp_archivo, codigo_vhdl_3_u);
+    salida_cadena(salida, codigo_vhdl_3_u);
+}
 
-  //Procede a generar los bloques de memoria con los datos del programa
-  for (i=0; i<num_bloques_prg; i++)
-    generar_ramb16_prg(fp_archivo, i);
+//Funcion para generar el cierre de la memoria de programa y la parte declarativa de la RAM
+static void generar_medio(ARCHIVO_SALIDA *salida) {
+  int num_bloques_prg = salida->tam_prg / TAM_BLOQUE_PRG;
+  int num_bloques_ram = salida->tam_ram / TAM_BLOQUE_RAM;
 
   //Dependiendo de la cantidad de bloques, genera el codigo de interconexion de los bloques a
   //traves de un mux, o bien solo conecta el unico bloque a la salida
   if (num_bloques_prg > 1)
-    fprintf(fp_archivo, plantilla_vhdl_3_m);
+    salida_cadena(salida, plantilla_vhdl_3_m);
   else
-    fprintf(fp_archivo, plantilla_vhdl_3_u);
+    salida_cadena(salida, plantilla_vhdl_3_u);
 
   //Se escribe la plantilla de cierre de la parte operativa de la memoria de programa e inicio de
   //la parte declarativa de la memoria de datos
-  fprintf(fp_archivo, plantilla_vhdl_4);
+  salida_cadena(salida, plantilla_vhdl_4);
 
   //Generacion del codigo VHDL asociado a la memoria de datos (RAM)
   //-----------------------------------------------------------------------------------------------
 
   //Se escribe la linea con la definicion del tipo de dato del bus que interconecta los bloques
-  fprintf(fp_archivo, codigo_vhdl_4, num_bloques_ram-1);
+  salida_formato(salida, codigo_vhdl_4, num_bloques_ram-1);
 
   //Se escribe la linea con la declaracion del bus de interconexion
-  fprintf(fp_archivo, plantilla_vhdl_5);
+  salida_cadena(salida, plantilla_vhdl_5);
 
   //Se escribe la linea con la declaracion de las señales de seleccion de bloque
-  fprintf(fp_archivo, codigo_vhdl_5, num_bloques_ram-1);
+  salida_formato(salida, codigo_vhdl_5, num_bloques_ram-1);
 
   //Se escriben las lineas de codigo que describen las operaciones de seleccion de bloque
   if (num_bloques_ram > 1)
-    fprintf(fp_archivo, codigo_vhdl_6_m, num_bloques_ram-1);
+    salida_formato(salida, codigo_vhdl_6_m, num_bloques_ram-1);
   else
-    fprintf(fp_archivo, codigo_vhdl_6_u);
-
-  //Procede a generar los bloques de memoria con los datos de RAM
-  for (i=0; i<num_bloques_ram; i++)
-    generar_ramb16_ram(fp_archivo, i);
+    salida_cadena(salida, codigo_vhdl_6_u);
+}
 
+//Funcion para generar el final del archivo
+static void generar_final(ARCHIVO_SALIDA *salida) {
   //Dependiendo de la cantidad de bloques, genera el codigo de interconexion de los bloques a
   //traves de un mux, o bien solo conecta el unico bloque a la salida
-  if (num_bloques_ram > 1)
-    fprintf(fp_archivo, plantilla_vhdl_6_m);
+  if (salida->tam_ram / TAM_BLOQUE_RAM > 1)
+    salida_cadena(salida, plantilla_vhdl_6_m);
   else
-    fprintf(fp_archivo, plantilla_vhdl_6_u);
+    salida_cadena(salida, plantilla_vhdl_6_u);
 
   //Se escribe la plantilla de cierre de la parte operativa de la memoria RAM
-  fprintf(fp_archivo, plantilla_vhdl_7);
-
-  //Al final del proceso, cierra el archivo
-  fclose(fp_archivo);
-  return true;                //Retorna con exito
+  salida_cadena(salida, plantilla_vhdl_7);
 }
 
 //Funcion de generacion de codigo de bloques tipo RAMB16 para la memoria de programa
-void generar_ramb16_prg(FILE *fp_archivo, int indice) {
+static void generar_ramb16_prg(ARCHIVO_SALIDA *salida, int indice,
+                               const uint32_t *datos, const uint64_t *ocupacion) {
   int i, j;
 
   //Se genera la cabecera del bloque
-  fprintf(fp_archivo,
-          "   MemoriaProg%i: RAMB16_S36\n"
-          "   generic map (\n"
-          "      INIT => X\"000000000\",       --Valor inicial del registro de salida\n"
-          "      SRVAL => X\"000000000\",      --Valor de set/reset del registro de salida\n"
-          "      WRITE_MODE => \"READ_FIRST\", --Modalidad de lectura antes de escritura\n",
-          indice);
+  salida_formato(salida,
+                 "   MemoriaProg%i: RAMB16_S36\n"
+                 "   generic map (\n"
+                 "      INIT => X\"000000000\",       --Valor inicial del registro de salida\n"
+                 "      SRVAL => X\"000000000\",      "
+                 "--Valor de set/reset del registro de salida\n"
+                 "      WRITE_MODE => \"READ_FIRST\", --Modalidad de lectura antes de escritura\n",
+                 indice);
 
   //Se generan los argumentos genericos INIT_XX que contienen los datos iniciales de la memoria
+  //(las palabras de cada linea se escriben de la mas alta a la mas baja)
   for (i=0; i<0x40; i++) {
-    fprintf(fp_archivo, "      INIT_%.2X => X\"", i);
+    salida_cadena(salida, "      INIT_");
+    salida_hex(salida, i, 2);
+    salida_cadena(salida, " => X\"");
     for (j=7; j>=0; j--)
-      fprintf(fp_archivo, "%.8X", datos_prg[indice*512+i*8+j] & 0x03FFFFFF);
-    fprintf(fp_archivo, "\",\n");
+      salida_hex(salida, datos[i*8+j], 8);
+    salida_cadena(salida, "\",\n");
   }
 
   //Se generan los argumentos genericos INITP_XX que contienen los bits de paridad (no usados)
-  for (i=0; i<8; i++) {
-    fprintf(fp_archivo, "      INITP_%.2X => X\"", i);
-    for (j=0; j<8; j++)
-      fprintf(fp_archivo, "00000000");
-    if (i != 7)
-      fprintf(fp_archivo, "\",\n");
-    else
-      fprintf(fp_archivo, "\")\n");
-  }
+  generar_initp(salida);
 
   //Se genera el segmento de mapeo de puertos del bloque
-  fprintf(fp_archivo,
-          "   port map (\n"
-          "      DO => BusProg(%i),              --Salida de datos de 32 bits\n"
-          "      DOP => open,                   --Salida de paridad de 4 bits\n"
-          "      ADDR => Direccion(8 downto 0), --Entrada de direcciones de 9 bits\n"
-          "      CLK => SysClk,                 --Entrada de reloj\n"
-          "      DI => X\"00000000\",             --Entrada de datos de 32 bits\n"
-          "      DIP => \"0000\",                 --Entrada de paridad de 4 bits\n"
-          "      EN => CS(%i),                   --Entrada de habilitacion (seleccion)\n"
-          "      SSR => '0',                    --Entrada sincrona de set/reset\n"
-          "      WE => '0'                      --Entrada de habilitacion de escritura\n"
-          "   );\n"
-          "\n",
-          indice, indice);
+  salida_formato(salida,
+                 "   port map (\n"
+                 "      DO => BusProg(%i),              --Salida de datos de 32 bits\n"
+                 "      DOP => open,                   --Salida de paridad de 4 bits\n"
+                 "      ADDR => Direccion(8 downto 0), --Entrada de direcciones de 9 bits\n"
+                 "      CLK => SysClk,                 --Entrada de reloj\n"
+                 "      DI => X\"00000000\",             --Entrada de datos de 32 bits\n"
+                 "      DIP => \"0000\",                 --Entrada de paridad de 4 bits\n"
+                 "      EN => CS(%i),                   --Entrada de habilitacion (seleccion)\n"
+                 "      SSR => '0',                    --Entrada sincrona de set/reset\n"
+                 "      WE => '0'                      --Entrada de habilitacion de escritura\n"
+                 "   );\n"
+                 "\n",
+                 indice, indice);
 }
 
 //Funcion de generacion de codigo de bloques tipo RAMB16 para la memoria de datos
-void generar_ramb16_ram(FILE *fp_archivo, int indice) {
+static void generar_ramb16_ram(ARCHIVO_SALIDA *salida, int indice,
+                               const uint16_t *datos, const uint64_t *ocupacion) {
   int i, j;
 
   //Se genera la cabecera del bloque
-  fprintf(fp_archivo,
-          "   MemoriaRam%i: RAMB16_S18\n"
-          "   generic map (\n"
-          "      INIT => X\"00000\",           --Valor inicial del registro de salida\n"
-          "      SRVAL => X\"00000\",          --Valor de set/reset del registro de salida\n"
-          "      WRITE_MODE => \"READ_FIRST\", --Modalidad de lectura antes de escritura\n",
-          indice);
+  salida_formato(salida,
+                 "   MemoriaRam%i: RAMB16_S18\n"
+                 "   generic map (\n"
+                 "      INIT => X\"00000\",           --Valor inicial del registro de salida\n"
+                 "      SRVAL => X\"00000\",          "
+                 "--Valor de set/reset del registro de salida\n"
+                 "      WRITE_MODE => \"READ_FIRST\", --Modalidad de lectura antes de escritura\n",
+                 indice);
 
   //Se generan los argumentos genericos INIT_XX que contienen los datos iniciales de la memoria
   for (i=0; i<0x40; i++) {
-    fprintf(fp_archivo, "      INIT_%.2X => X\"", i);
+    salida_cadena(salida, "      INIT_");
+    salida_hex(salida, i, 2);
+    salida_cadena(salida, " => X\"");
     for (j=15; j>=0; j--)
-      fprintf(fp_archivo, "%.4X", datos_ram[indice*1024+i*16+j] & 0x0000FFFF);
-    fprintf(fp_archivo, "\",\n");
+      salida_hex(salida, datos[i*16+j], 4);
+    salida_cadena(salida, "\",\n");
   }
 
   //Se generan los argumentos genericos INITP_XX que contienen los bits de paridad (no usados)
-  for (i=0; i<8; i++) {
-    fprintf(fp_archivo, "      INITP_%.2X => X\"", i);
-    for (j=0; j<8; j++)
-      fprintf(fp_archivo, "00000000");
-    if (i != 7)
-      fprintf(fp_archivo, "\",\n");
-    else
-      fprintf(fp_archivo, "\")\n");
-  }
+  generar_initp(salida);
 
   //Se genera el segmento de mapeo de puertos del bloque
-  fprintf(fp_archivo,
-          "   port map (\n"
-          "      DO => BusRam(%i),               --Salida de datos de 16 bits\n"
-          "      DOP => open,                   --Salida de paridad de 2 bits\n"
-          "      ADDR => Direccion(9 downto 0), --Entrada de direcciones de 10 bits\n"
-          "      CLK => SysClk,                 --Entrada de reloj\n"
-          "      DI => DatoEnt,                 --Entrada de datos de 16 bits\n"
-          "      DIP => \"00\",                   --Entrada de paridad de 2 bits\n"
-          "      EN => CS(%i),                   --Entrada de habilitacion (seleccion)\n"
-          "      SSR => '0',                    --Entrada sincrona de set/reset\n"
-          "      WE => Wen                      --Entrada de habilitacion de escritura\n"
-          "   );\n"
-          "\n",
-          indice, indice);
+  salida_formato(salida,
+                 "   port map (\n"
+                 "      DO => BusRam(%i),               --Salida de datos de 16 bits\n"
+                 "      DOP => open,                   --Salida de paridad de 2 bits\n"
+                 "      ADDR => Direccion(9 downto 0), --Entrada de direcciones de 10 bits\n"
+                 "      CLK => SysClk,                 --Entrada de reloj\n"
+                 "      DI => DatoEnt,                 --Entrada de datos de 16 bits\n"
+                 "      DIP => \"00\",                   --Entrada de paridad de 2 bits\n"
+                 "      EN => CS(%i),                   --Entrada de habilitacion (seleccion)\n"
+                 "      SSR => '0',                    --Entrada sincrona de set/reset\n"
+                 "      WE => Wen                      --Entrada de habilitacion de escritura\n"
+                 "   );\n"
+                 "\n",
+                 indice, indice);
+}
+
+//Funcion que genera los argumentos INITP_XX de un bloque (los bits de paridad no se usan, por lo
+//que siempre contienen ceros)
+static void generar_initp(ARCHIVO_SALIDA *salida) {
+  int i;
+
+  for (i=0; i<8; i++) {
+    salida_cadena(salida, "      INITP_");
+    salida_hex(salida, i, 2);
+    salida_cadena(salida, " => X\"00000000000000000000000000000000"
+                          "00000000000000000000000000000000");
+    salida_cadena(salida, i != 7 ? "\",\n" : "\")\n");
+  }
 }
\ No newline at end of file
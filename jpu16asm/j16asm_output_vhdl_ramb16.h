@@ -1,10 +1,10 @@
 #ifndef j16asm_output_vhdl_ramb16_h_Incluida
 #define j16asm_output_vhdl_ramb16_h_Incluida
 
-#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include "j16asm_salida.h"              //Incluye la definicion del tipo FORMATO_SALIDA
 
-//Funciones exportadas
-//--------------------
-extern bool generar_salida_vhdl_ramb16();
+//Datos exportados
+//----------------
+extern const FORMATO_SALIDA formato_vhdl_ramb16;
 
 #endif //j16asm_output_vhdl_ramb16_h_Incluida
\ No newline at end of file
@@ -8,63 +8,115 @@
 //| El producto de procesar este archivo es un modulo de codigo fuente automaticamente generado,  |
 //| el cual provee la funcion yyparse() que implementa el paso 1 del ensamblador.                 |
 //+-----------------------------------------------------------------------------------------------+
+//Cabeceras requeridas por las declaraciones de la cabecera generada (yyparse recibe el contexto)
+%code requires {
+  #include "j16asm.h"                   //Importa el contexto de ensamblado
+}
+
 %{
   //Se definen todas las cabeceras, dependencias externas y declaraciones previas que iran a
   //parar al archivo de codigo fuente generado
+  #include <limits.h>                   //Incluye la longitud maxima de una ruta
   #include <math.h>                     //Permite invocar la funcion pow()
-  #include "j16asm.h"                   //Importa las funciones y variables de manejo de RAM y ROM
+  #include <stdio.h>                    //Permite manejar archivos (para los archivos incluidos)
+  #include <stdlib.h>                   //Permite invocar free
+  #include <string.h>                   //Permite manejar cadenas
+  #include "j16asm.h"                   //Importa el contexto de ensamblado
+  #include "j16asm_ensamblador.h"       //Importa las funciones de manejo de RAM y ROM
+  #include "j16asm_fuentes.h"           //Importa el registro de archivos fuente
+  #include "j16asm_instrucciones.h"     //Importa la tabla de codificacion de instrucciones
+  #include "j16asm_optimizador.h"       //Permite registrar los usos de direcciones de programa
+  #include "j16asm_recolector.h"        //Permite registrar bloques y usos de direcciones (-gc)
+  #include "j16asm_listado.h"           //Permite registrar la linea de cada instruccion (-lst)
+  #include "j16asm_macros.h"            //Permite definir y expandir macros y repeticiones
+  #include "j16asm_tablas.h"            //Permite generar tablas y leer archivos de datos
   #include "j16asm_messages.h"          //Importa funciones para generar mensajes
 
-  #define NULL 0
+  //Abreviaturas del estado del contexto usadas en las acciones de la gramatica (se eliminan antes
+  //de las funciones locales, las cuales usan el contexto de forma explicita)
+  #define num_lin        (ctx->num_lin)
+  #define seccion_actual (ctx->seccion_actual)
+  #define pos_prg        (ctx->pos_prg)
+  #define pos_ram        (ctx->pos_ram)
+  #define modo_objeto    (ctx->modo_objeto)
+  #define cola           (&ctx->cola_acciones)
 
   //Dependencias externas
-  extern int yylex (void);      //Funcion del analizador lexico
-
-  //Tipos de dato de uso local
-  typedef enum _TIPO_SECCION {  //Enumeracion de las posibles secciones de memoria donde se generan datos
-    TS_DATOS, TS_PROG,
-  } TIPO_SECCION;
-
-  //Variables de uso local
-  static TIPO_SECCION seccion_actual = TS_PROG;         //Seccion actual del codigo fuente
-  static int num_lin = 1;                               //Conteo del numero de lineas
-
-  //Declaracion previa de las funciones locales
-  static void yyerror(char const *s);   //funcion de manejo de errores invocada por el analizador sintactico
+  extern void apilar_archivo_lexico(void *escaner, FILE *fp_archivo);  //Continua en otro archivo
+  extern void apilar_texto_lexico(void *escaner, const char *texto, int tam);  //O en una expansion
 %}
 
+//El analizador es reentrante: todo su estado esta en el contexto y en el analizador lexico
+%define api.pure full
+%parse-param {CONTEXTO_ASM *ctx} {void *escaner}
+%lex-param {void *escaner}
+
 //Se definen los tipos de datos que maneja el analizador sintactico
 %union {
   int valor;            //Valor numerico (tambien numero registro de CPU desde r0 a r15)
-  char *nombre;         //Nombre de un simbolo (constante, variable o etiqueta) desconocido
-  SIMBOLO *simbolo;     //Puntero a un simbolo conocido que existe en la lista de simbolos
+  VALOR_EXP expresion;  //Valor de una expresion literal junto con su tipo de reubicacion
+  SIMBOLO *simbolo;     //Puntero a la entrada de un simbolo en la lista de simbolos
+  char *cadena;         //Cadena entre comillas o texto sin analizar (alojados con malloc)
+  MACRO *macro;         //Macro que se invoca
+}
+
+%code {
+  //Dependencias externas
+  extern int yylex(YYSTYPE *yylval, void *escaner);    //Funcion del analizador lexico
+
+  //Declaracion previa de las funciones locales
+  static void yyerror(CONTEXTO_ASM *ctx, void *escaner, char const *s); //Manejo de errores
+  static VALOR_EXP operar_literal(VALOR_EXP izquierda, OPERACION op, VALOR_EXP derecha);
+  static SIMBOLO *simbolo_base(CONTEXTO_ASM *ctx, TIPO_REUBICACION reub);
+  static bool encolar_valor(CONTEXTO_ASM *ctx, VALOR_EXP expresion);
+  static bool encolar_reubicacion(CONTEXTO_ASM *ctx, VALOR_EXP expresion);
+  static bool iniciar_inclusion(CONTEXTO_ASM *ctx, void *escaner, const char *nombre);
+  static void terminar_inclusion(CONTEXTO_ASM *ctx);
+  static bool registrar_macro(CONTEXTO_ASM *ctx, const char *cabecera, const char *cuerpo);
+  static bool iniciar_macro(CONTEXTO_ASM *ctx, void *escaner, MACRO *macro,
+                            const char *argumentos);
+  static bool iniciar_repeticion(CONTEXTO_ASM *ctx, void *escaner, VALOR_EXP vueltas,
+                                 const char *cuerpo);
+  static bool rellenar_ram(CONTEXTO_ASM *ctx, VALOR_EXP cantidad, VALOR_EXP valor);
+  static bool agregar_bloque_ram(CONTEXTO_ASM *ctx, int *datos, int cantidad);
+  static void leer_expansion(CONTEXTO_ASM *ctx, void *escaner, const char *texto, int tam,
+                             int fuente, int lin_inicio);
+  static bool codificar(CONTEXTO_ASM *ctx, int mnemonico, FORMA_OPERANDOS forma, int operando_1,
+                        int operando_2, int *codigo);
+  static bool agregar_bandera(CONTEXTO_ASM *ctx, int codigo, int mnemonico, int *resultado);
 }
 
 //Definicion de los token terminales
 //----------------------------------
 //Token especiales
 %token FIN_ARCHIVO 0            //Indica el final del archivo
+%token FIN_INCLUSION            //Indica el final de un archivo incluido
 
-//Token de nombres de instrucciones
-%token TI_NOP
-%token TI_CLRC TI_SETC TI_CLRZ TI_SETZ TI_CLRN TI_SETN TI_CLRV TI_SETV TI_CLRI TI_SETI
-%token TI_MOVE TI_IN TI_OUT
-%token TI_JMP TI_JMPNC TI_JMPC TI_JMPNZ TI_JMPZ TI_JMPP TI_JMPN TI_JMPNV TI_JMPV
-%token TI_CALL TI_CALLNC TI_CALLC TI_CALLNZ TI_CALLZ TI_CALLP TI_CALLN TI_CALLNV TI_CALLV
-%token TI_RETURN TI_IDRET TI_IERET
-%token TI_NOT TI_ADD TI_OR TI_ADDC TI_AND TI_SUB TI_XOR TI_SUBB TI_TEST TI_CMP
-%token TI_MUL TI_SMUL
-%token TI_SHL0 TI_SHL1 TI_ROL TI_ROLC TI_SHR0 TI_SHR1 TI_ROR TI_RORC
+//Token de nombres de instrucciones (el valor es el numero de mnemonico en la tabla de
+//instrucciones, los alias ya vienen resueltos)
+%token <valor> T_INSTR
 
 //Token de elementos del lenguaje
 %token TD_DATA                  //Directiva para ubicar datos en RAM
 %token TD_CODE                  //Directiva para ubicar instrucciones en memoria de programa
 %token TD_WORD                  //Directiva para generar datos en RAM
 %token TD_EQU                   //Directiva para generar simbolos con valores arbitrarios
+%token TD_PUBLIC                //Directiva para exportar simbolos hacia otros modulos
+%token TD_INCLUDE               //Directiva para incluir el contenido de otro archivo
+%token TD_MACRO                 //Directiva para definir una macro
+%token TD_REPT                  //Directiva para repetir un bloque de lineas
+%token TD_FILL                  //Directiva para llenar un bloque de RAM con un mismo valor
+%token TD_INCBIN                //Directiva para incluir en RAM un archivo de datos binario
+%token TD_INCHEX                //Directiva para incluir en RAM un archivo de datos hexadecimal
+%token TD_TABLE                 //Directiva para generar una tabla
+%token <cadena> T_CUERPO        //Lineas de una macro o repeticion hasta su endm (NULL si falta)
+%token <macro> T_MACRO          //Nombre de una macro definida previamente
+%token <cadena> T_ARGUMENTOS    //Resto de la linea de una macro o tabla (sin analizar)
 %token <valor> T_REG            //Registros (r0 - r15)
 %token <valor> T_LIT            //Valores literales
-%token <nombre> T_SIM_DESC      //Simbolos (constantes, variables y etiquetas) cuyo valor no ha sido definido aun
+%token <simbolo> T_SIM_DESC     //Simbolos (constantes, variables y etiquetas) cuyo valor no ha sido definido aun
 %token <simbolo> T_SIM_CON      //Simbolos cuyo valor equivalente es previamente conocido
+%token <cadena> T_CADENA        //Cadenas entre comillas (nombres de archivo)
 
 //Token de operadores compuestos de dos caracteres
 %token TOP_SHL TOP_SHR TOP_EXP
@@ -72,8 +124,10 @@
 //Tipos de token no terminales que poseen un valor asociado
 //---------------------------------------------------------
 %type <valor> instr
+%type <valor> lista_banderas
 %type <valor> exp
-%type <valor> exp_lit
+%type <expresion> exp_lit
+%type <cadena> argumentos
 
 //Se define la prioridad de los operadores y su asociatividad
 //-----------------------------------------------------------
@@ -92,31 +146,120 @@
 //El programa puede consistir de un archivo vacio o bien cualquier cantidad de lineas
 entrada:
   /* archivo vacio */           {}
-  | entrada linea               { num_lin++; } //Coleccion de cualquier cantidad de lineas
+  | entrada linea               { //Coleccion de cualquier cantidad de lineas
+                                  //Al terminar un archivo incluido se continua con la linea
+                                  //siguiente a la directiva en el archivo que lo incluyo
+                                  if (ctx->info_optimizacion.usa_direccion_prg) {
+                                    //Una direccion de programa usada fuera de una instruccion
+                                    //(equ, word o code) tambien impide mover instrucciones
+                                    registrar_referencia_prg(ctx, ctx->fuente_actual, num_lin);
+                                    ctx->info_optimizacion.usa_direccion_prg = false;
+                                  }
+                                  terminar_linea_recoleccion(ctx);
+                                  if (ctx->inclusion_terminada) terminar_inclusion(ctx);
+                                  num_lin++;
+                                }
 ;
 
 //Una linea puede ser terminada por el caracter especial \n o bien por el final mismo del archivo
 fin_lin:
   '\n'                                  {} //Final de linea normal
   | FIN_ARCHIVO                         {} //Un final de archivo tambien termina una linea
+  | FIN_INCLUSION                       { ctx->inclusion_terminada = true; } //O el de un incluido
 ;
 
 //Definicion de la sintaxis de las lineas de codigo
 linea:
   '\n'                                  {} //Una linea puede estar vacia
+  | FIN_INCLUSION                       { ctx->inclusion_terminada = true; } //Fin de un incluido
+  | TD_INCLUDE T_CADENA '\n'            {
+                                          //Nota: Se exige un fin de linea (no el del archivo)
+                                          //porque el archivo incluido se apila antes de leer
+                                          //el siguiente token, lo cual no es posible despues
+                                          //del final
+                                          bool exito = iniciar_inclusion(ctx, escaner, $2);
+                                          free($2);
+                                          if (!exito) YYABORT;
+                                        }
+  | TD_MACRO argumentos '\n' T_CUERPO   {
+                                          //El cuerpo se guarda tal cual y se analiza en cada
+                                          //invocacion
+                                          bool exito = registrar_macro(ctx, $2 ? $2 : "", $4);
+                                          free($2);
+                                          free($4);
+                                          if (!exito) YYABORT;
+                                        }
+  | TD_REPT exp_lit '\n' T_CUERPO       {
+                                          //Nota: Como en include, la primera vuelta se apila
+                                          //antes de leer el siguiente token
+                                          bool exito = iniciar_repeticion(ctx, escaner, $2, $4);
+                                          free($4);
+                                          if (!exito) YYABORT;
+                                        }
+  | TD_REPT exp_sim '\n' T_CUERPO       { free($4); msg_expr_simbolo_no_definido(ctx, num_lin); YYABORT; }
+  | uso_macro                           {}
+  | etiqueta uso_macro                  {} //La etiqueta queda en la primera instruccion de la macro
   | etiqueta fin_lin                    {} //Una linea puede tener solo una etiqueta (el token es procesado mas abajo)
   | TD_DATA fin_lin                     { seccion_actual = TS_DATOS; }
-  | TD_DATA exp_lit fin_lin             { seccion_actual = TS_DATOS; pos_ram = $2; }
+  | TD_DATA exp_lit fin_lin             {
+                                          cerrar_bloque(ctx, TS_DATOS);  //Lo que sigue no es del bloque
+                                          seccion_actual = TS_DATOS;
+                                          pos_ram = $2.valor;
+                                        }
   | TD_CODE fin_lin                     { seccion_actual = TS_PROG; }
-  | TD_CODE exp_lit fin_lin             { seccion_actual = TS_PROG; pos_prg = $2; }
-  | T_SIM_DESC TD_EQU exp_lit fin_lin   { agregar_simbolo($1, $3, num_lin); }
-  | T_SIM_DESC TD_EQU exp_sim fin_lin   { msg_expr_simbolo_no_definido(num_lin); YYABORT; }
-  | T_SIM_CON TD_EQU exp_lit fin_lin    { msg_simbolo_redefinido(num_lin, $1->nombre); YYABORT; }
-  | T_SIM_CON TD_EQU exp_sim fin_lin    { msg_simbolo_redefinido(num_lin, $1->nombre); YYABORT; }
+  | TD_CODE exp_lit fin_lin             {
+                                          cerrar_bloque(ctx, TS_PROG);
+                                          seccion_actual = TS_PROG;
+                                          pos_prg = $2.valor;
+                                          registrar_direccion_fija(ctx, pos_prg);  //No se mueve
+                                        }
+  | T_SIM_DESC TD_EQU exp_lit fin_lin   {
+                                          //El simbolo hereda la reubicacion de la expresion (p. ej. etiqueta + 1)
+                                          if (modo_objeto && $3.reub == REUB_INVALIDA) {
+                                            msg_expr_no_reubicable(ctx, num_lin);
+                                            YYABORT;
+                                          }
+                                          definir_simbolo($1, $3.valor, $3.reub);
+                                        }
+  | T_SIM_DESC TD_EQU exp_sim fin_lin   { msg_expr_simbolo_no_definido(ctx, num_lin); YYABORT; }
+  | T_SIM_CON TD_EQU exp_lit fin_lin    { msg_simbolo_redefinido(ctx, num_lin, $1->nombre); YYABORT; }
+  | T_SIM_CON TD_EQU exp_sim fin_lin    { msg_simbolo_redefinido(ctx, num_lin, $1->nombre); YYABORT; }
   | datos_ram fin_lin                   {} //Aqui no se hace nada, los token individuales son procesados mas adelante
   | etiqueta datos_ram fin_lin          {} //Igual que el anterior, esta parte solo valida sintaxis
+  | bloque_ram fin_lin                  {}
+  | etiqueta bloque_ram fin_lin         {}
   | dato_prg fin_lin                    {}
   | etiqueta dato_prg fin_lin           {}
+  | TD_PUBLIC lista_publicos fin_lin    {} //Los simbolos se marcan como publicos mas abajo
+;
+
+//Definicion de la sintaxis de las invocaciones de macros: igual que en include, se exige un fin de
+//linea porque la expansion se apila antes de leer el siguiente token
+uso_macro:
+  T_MACRO argumentos '\n'              {
+                                          bool exito = iniciar_macro(ctx, escaner, $1, $2);
+                                          free($2);
+                                          if (!exito) YYABORT;
+                                        }
+;
+
+//Definicion del resto de la linea que sigue a una macro (sus argumentos), a la directiva macro (el
+//nombre y los parametros) o a la directiva table (la cantidad y la expresion), sin analizar
+argumentos:
+  /* sin argumentos */                  { $$ = NULL; }
+  | T_ARGUMENTOS                        { $$ = $1; }
+;
+
+//Definicion de la sintaxis de la lista de simbolos exportados (pueden declararse antes o despues de
+//ser definidos)
+lista_publicos:
+  simbolo_publico                       {}
+  | lista_publicos ',' simbolo_publico  {}
+;
+
+simbolo_publico:
+  T_SIM_DESC                    { $1->publico = true; }
+  | T_SIM_CON                   { $1->publico = true; }
 ;
 
 //Definicion de la sintaxis de los datos de RAM
@@ -124,10 +267,13 @@ datos_ram:
   TD_WORD exp                   { //Los datos de RAM se pueden declarar con la directiva word
                                   if (seccion_actual != TS_DATOS) {
                                     //Verifica que los datos sean declarados dentro de una seccion de datos
-                                    msg_datos_seccion_incorrecta(num_lin);
+                                    msg_datos_seccion_incorrecta(ctx, num_lin);
                                     YYABORT;
                                   }
-                                  if (!agregar_dato_ram($2, num_lin)) YYABORT;
+                                  if (!descartar_dato(ctx)) {
+                                    if (!agregar_dato_ram(ctx, $2, num_lin)) YYABORT;
+                                    ubicar_usos_direccion(ctx, TS_DATOS, pos_ram - 1, false);
+                                  }
                                   //Nota: Si el token exp es una expresion simbolica, entonces el dato que se recibe aca
                                   //es 0x00 (de manera temporal), de manera que solo se reserva la localidad de memoria
                                   //para ser posteriormente rellenada con el valor resultante en el paso 2
@@ -135,7 +281,42 @@ datos_ram:
   | datos_ram ',' exp           { //Una declaracion de datos puede tener mas de uno si la lista se separa con comas
                                   //Nota: no es necesario verificar que datos adicionales esten en su seccion correcta
                                   //porque eso se ya se hace cuando se encuentra el token TD_WORD
-                                  if (!agregar_dato_ram($3, num_lin)) YYABORT;
+                                  if (!descartar_dato(ctx)) {
+                                    if (!agregar_dato_ram(ctx, $3, num_lin)) YYABORT;
+                                    ubicar_usos_direccion(ctx, TS_DATOS, pos_ram - 1, false);
+                                  }
+                                }
+;
+
+//Definicion de la sintaxis de los bloques de datos de RAM, los cuales generan varios datos a la vez
+bloque_ram:
+  TD_FILL exp_lit               { //El valor de relleno es opcional (cero si se omite)
+                                  VALOR_EXP cero = { 0, REUB_NINGUNA };
+                                  if (!rellenar_ram(ctx, $2, cero)) YYABORT;
+                                }
+  | TD_FILL exp_lit ',' exp_lit { if (!rellenar_ram(ctx, $2, $4)) YYABORT; }
+  | TD_FILL exp_sim             { msg_expr_simbolo_no_definido(ctx, num_lin); YYABORT; }
+  | TD_FILL exp_sim ',' exp     { msg_expr_simbolo_no_definido(ctx, num_lin); YYABORT; }
+  | TD_FILL exp_lit ',' exp_sim { msg_expr_simbolo_no_definido(ctx, num_lin); YYABORT; }
+  | TD_INCBIN T_CADENA          {
+                                  int cantidad;
+                                  int *datos = leer_archivo_datos(ctx, $2, false, &cantidad);
+                                  free($2);
+                                  if (!agregar_bloque_ram(ctx, datos, cantidad)) YYABORT;
+                                }
+  | TD_INCHEX T_CADENA          {
+                                  int cantidad;
+                                  int *datos = leer_archivo_datos(ctx, $2, true, &cantidad);
+                                  free($2);
+                                  if (!agregar_bloque_ram(ctx, datos, cantidad)) YYABORT;
+                                }
+  | TD_TABLE argumentos         {
+                                  //La expresion se analiza aparte porque admite funciones y
+                                  //valores reales, y se evalua una vez por cada indice
+                                  int cantidad;
+                                  int *datos = calcular_tabla(ctx, $2 ? $2 : "", &cantidad);
+                                  free($2);
+                                  if (!agregar_bloque_ram(ctx, datos, cantidad)) YYABORT;
                                 }
 ;
 
@@ -144,10 +325,19 @@ dato_prg:
   instr                         { //Los datos de la memoria de programa son las instrucciones
                                   if (seccion_actual != TS_PROG) {
                                     //Verifica que las instrucciones sean declaradas dentro de una seccion de codigo
-                                    msg_instr_seccion_incorrecta(num_lin);
+                                    msg_instr_seccion_incorrecta(ctx, num_lin);
                                     YYABORT;
                                   }
-                                  if (!agregar_dato_prg($1, num_lin)) YYABORT;
+                                  if (!descartar_dato(ctx)) {  //Salvo en un bloque eliminado (-gc)
+                                    if (!agregar_dato_prg(ctx, $1, num_lin)) YYABORT;
+                                    registrar_linea_prg(ctx, pos_prg - 1);  //Para el listado
+                                    //El optimizador debe conocer las direcciones de programa que no
+                                    //son el destino de un salto o llamada directa
+                                    if (ctx->info_optimizacion.usa_direccion_prg && !ES_SALTO_DIRECTO($1))
+                                      registrar_referencia_prg(ctx, ctx->fuente_actual, num_lin);
+                                    ctx->info_optimizacion.usa_direccion_prg = false;
+                                    ubicar_usos_direccion(ctx, TS_PROG, pos_prg - 1, ES_SALTO_DIRECTO($1));
+                                  }
                                   //Nota: El valor numerico asociado a una instruccion es su opcode resultante. En caso
                                   //que la misma posea una expresion simbolica, entonces su valor temporal posee los bits
                                   //que la codifican junto con un argumento literal cuyo valor es (usualmente) 0x00, y su
@@ -161,285 +351,115 @@ etiqueta:
                                   switch (seccion_actual) {
                                   case TS_DATOS:
                                     //Si esta en una seccion de datos, entonces la etiqueta corresponde a la RAM
-                                    agregar_simbolo($1, pos_ram, num_lin);
+                                    definir_simbolo($1, pos_ram, REUB_RAM);
                                     break;
                                   case TS_PROG:
                                     //Si esta en una seccion de codigo, entonces la etiqueta corresponde a la memoria
                                     //de programa
-                                    agregar_simbolo($1, pos_prg, num_lin);
+                                    definir_simbolo($1, pos_prg, REUB_PRG);
                                     break;
                                   }
+                                  iniciar_bloque(ctx, $1);  //La etiqueta inicia un bloque (-gc)
                                 }
-  | T_SIM_CON ':'               { msg_simbolo_redefinido(num_lin, $1->nombre); YYABORT; }
+  | T_SIM_CON ':'               { msg_simbolo_redefinido(ctx, num_lin, $1->nombre); YYABORT; }
 ;
 
-//Definicion de la sintaxis de las instrucciones
+//Definicion de la sintaxis de las instrucciones: una regla por cada forma de los operandos. El
+//codigo de cada instruccion se obtiene de la tabla de j16asm_instrucciones, la cual indica que
+//formas acepta cada mnemonico (una forma no aceptada es un error de sintaxis)
 instr:
-  //Primer bloque de instrucciones: No operacion 
-    //nop
-  TI_NOP          { $$ = 0x0000; }                //El valor generado es el opcode
-
-  //Segundo bloque: Instrucciones de manejo de banderas
-    //clrc
-  | TI_CLRC       { $$ = 0b0001000001 << 16; }
-    //setc
-  | TI_SETC       { $$ = 0b0001100001 << 16; }
-    //clrz
-  | TI_CLRZ       { $$ = 0b0001000010 << 16; }
-    //setz
-  | TI_SETZ       { $$ = 0b0001100010 << 16; }
-    //clrn
-  | TI_CLRN       { $$ = 0b0001000100 << 16; }
-    //setn
-  | TI_SETN       { $$ = 0b0001100100 << 16; }
-    //clrv
-  | TI_CLRV       { $$ = 0b0001001000 << 16; }
-    //setv
-  | TI_SETV       { $$ = 0b0001101000 << 16; }
-    //clri
-  | TI_CLRI       { $$ = 0b0001010000 << 16; }
-    //seti
-  | TI_SETI       { $$ = 0b0001110000 << 16; }
-
-  //Tercer bloque: Operaciones de prueba (solo afectan banderas)
-    //test reg, lit
-  | TI_TEST T_REG ',' exp       { $$ = (0b001000 << 20) | ($2 << 16) | ($4 & 0xFFFF); }
-    //test reg, reg
-  | TI_TEST T_REG ',' T_REG     { $$ = (0b001001 << 20) | ($2 << 16) | ($4 << 12);    }
-    //cmp reg, lit
-  | TI_CMP  T_REG ',' exp       { $$ = (0b001010 << 20) | ($2 << 16) | ($4 & 0xFFFF); }
-    //cmp reg, reg
-  | TI_CMP  T_REG ',' T_REG     { $$ = (0b001011 << 20) | ($2 << 16) | ($4 << 12);    }
-
-  //Cuarto bloque: Instrucciones de salida de datos desde el CPU (hacia la memoria o bus de I/O)
+    //nop, clrc, return, ...
+  T_INSTR                           { if (!codificar(ctx, $1, FO_NINGUNO, 0, 0, &$$)) YYABORT; }
+    //jmp reg, rolc reg, ...
+  | T_INSTR T_REG                   { if (!codificar(ctx, $1, FO_REG, $2, 0, &$$)) YYABORT; }
+    //jmp dir, call dir, ...
+  | T_INSTR exp                     { if (!codificar(ctx, $1, FO_EXP, $2, 0, &$$)) YYABORT; }
+    //add reg, lit, shl0 reg, lit, in reg, dir, ...
+  | T_INSTR T_REG ',' exp           { if (!codificar(ctx, $1, FO_REG_EXP, $2, $4, &$$)) YYABORT; }
+    //add reg, reg, ...
+  | T_INSTR T_REG ',' T_REG         { if (!codificar(ctx, $1, FO_REG_REG, $2, $4, &$$)) YYABORT; }
+    //move reg, [dir]
+  | T_INSTR T_REG ',' '[' exp ']'   { if (!codificar(ctx, $1, FO_REG_MEM_EXP, $2, $5, &$$)) YYABORT; }
+    //move reg, [reg]
+  | T_INSTR T_REG ',' '[' T_REG ']' { if (!codificar(ctx, $1, FO_REG_MEM_REG, $2, $5, &$$)) YYABORT; }
     //move [dir], reg
-  | TI_MOVE '[' exp   ']' ',' T_REG     { $$ = (0b001100 << 20) | ($6 << 16) | ($3 & 0xFFFF); }
+  | T_INSTR '[' exp ']' ',' T_REG   { if (!codificar(ctx, $1, FO_MEM_EXP_REG, $3, $6, &$$)) YYABORT; }
     //move [reg], reg
-  | TI_MOVE '[' T_REG ']' ',' T_REG     { $$ = (0b001101 << 20) | ($6 << 16) | ($3 << 12);    }
+  | T_INSTR '[' T_REG ']' ',' T_REG { if (!codificar(ctx, $1, FO_MEM_REG_REG, $3, $6, &$$)) YYABORT; }
     //out dir, reg
-  | TI_OUT      exp       ',' T_REG     { $$ = (0b001110 << 20) | ($4 << 16) | ($2 & 0xFFFF); }
-    //out reg, reg
-  | TI_OUT      T_REG     ',' T_REG     { $$ = (0b001111 << 20) | ($4 << 16) | ($2 << 12);    }
-
-  //Quinto bloque: Instrucciones de salto
-    //jmp dir
-  | TI_JMP exp          { $$ = (0b010000 << 20) | (($2-pos_prg) & 0xFFFF); }
-    //jmp reg
-  | TI_JMP T_REG        { $$ = (0b010001 << 20) | ($2 << 12);    }
-    //jmpnc dir
-  | TI_JMPNC exp        { $$ = (0b0100100000 << 16) | (($2-pos_prg) & 0xFFFF); }
-    //jmpnc reg
-  | TI_JMPNC T_REG      { $$ = (0b0100110000 << 16) | ($2 << 12); }
-    //jmpc dir
-  | TI_JMPC exp         { $$ = (0b0100100001 << 16) | (($2-pos_prg) & 0xFFFF); }
-    //jmpc reg
-  | TI_JMPC T_REG       { $$ = (0b0100110001 << 16) | ($2 << 12); }
-    //jmpnz dir
-  | TI_JMPNZ exp        { $$ = (0b0100100010 << 16) | (($2-pos_prg) & 0xFFFF); }
-    //jmpnz reg
-  | TI_JMPNZ T_REG      { $$ = (0b0100110010 << 16) | ($2 << 12); }
-    //jmpz dir
-  | TI_JMPZ exp         { $$ = (0b0100100011 << 16) | (($2-pos_prg) & 0xFFFF); }
-    //jmpz reg
-  | TI_JMPZ T_REG       { $$ = (0b0100110011 << 16) | ($2 << 12); }
-    //jmpp dir
-  | TI_JMPP exp         { $$ = (0b0100100100 << 16) | (($2-pos_prg) & 0xFFFF); }
-    //jmpp reg
-  | TI_JMPP T_REG       { $$ = (0b0100110100 << 16) | ($2 << 12); }
-    //jmpn dir
-  | TI_JMPN exp         { $$ = (0b0100100101 << 16) | (($2-pos_prg) & 0xFFFF); }
-    //jmpn reg
-  | TI_JMPN T_REG       { $$ = (0b0100110101 << 16) | ($2 << 12); }
-    //jmpnv dir
-  | TI_JMPNV exp        { $$ = (0b0100100110 << 16) | (($2-pos_prg) & 0xFFFF); }
-    //jmpnv reg
-  | TI_JMPNV T_REG      { $$ = (0b0100110110 << 16) | ($2 << 12); }
-    //jmpv dir
-  | TI_JMPV exp         { $$ = (0b0100100111 << 16) | (($2-pos_prg) & 0xFFFF); }
-    //jmpv reg
-  | TI_JMPV T_REG       { $$ = (0b0100110111 << 16) | ($2 << 12); }
-
-  //Sexto bloque: Instrucciones de llamada
-    //call dir
-  | TI_CALL exp         { $$ = (0b010100 << 20) | (($2-pos_prg) & 0xFFFF); }
-    //call reg
-  | TI_CALL T_REG       { $$ = (0b010101 << 20) | ($2 << 12);    }
-    //callnc dir
-  | TI_CALLNC exp       { $$ = (0b0101100000 << 16) | (($2-pos_prg) & 0xFFFF); }
-    //callnc reg
-  | TI_CALLNC T_REG     { $$ = (0b0101110000 << 16) | ($2 << 12); }
-    //callc dir
-  | TI_CALLC exp        { $$ = (0b0101100001 << 16) | (($2-pos_prg) & 0xFFFF); }
-    //callc reg
-  | TI_CALLC T_REG      { $$ = (0b0101110001 << 16) | ($2 << 12); }
-    //callnz dir
-  | TI_CALLNZ exp       { $$ = (0b0101100010 << 16) | (($2-pos_prg) & 0xFFFF); }
-    //callnz reg
-  | TI_CALLNZ T_REG     { $$ = (0b0101110010 << 16) | ($2 << 12); }
-    //callz dir
-  | TI_CALLZ exp        { $$ = (0b0101100011 << 16) | (($2-pos_prg) & 0xFFFF); }
-    //callz reg
-  | TI_CALLZ T_REG      { $$ = (0b0101110011 << 16) | ($2 << 12); }
-    //callp dir
-  | TI_CALLP exp        { $$ = (0b0101100100 << 16) | (($2-pos_prg) & 0xFFFF); }
-    //callp reg
-  | TI_CALLP T_REG      { $$ = (0b0101110100 << 16) | ($2 << 12); }
-    //calln dir
-  | TI_CALLN exp        { $$ = (0b0101100101 << 16) | (($2-pos_prg) & 0xFFFF); }
-    //calln reg
-  | TI_CALLN T_REG      { $$ = (0b0101110101 << 16) | ($2 << 12); }
-    //callnv dir
-  | TI_CALLNV exp       { $$ = (0b0101100110 << 16) | (($2-pos_prg) & 0xFFFF); }
-    //callnv reg
-  | TI_CALLNV T_REG     { $$ = (0b0101110110 << 16) | ($2 << 12); }
-    //callv dir
-  | TI_CALLV exp        { $$ = (0b0101100111 << 16) | (($2-pos_prg) & 0xFFFF); }
-    //callv reg
-  | TI_CALLV T_REG      { $$ = (0b0101110111 << 16) | ($2 << 12); }
-
-  //Septimo bloque: Instrucciones de retorno
-    //return
-  | TI_RETURN     { $$ = 0b011000 << 20; }
-    //idret
-  | TI_IDRET      { $$ = 0b011100 << 20; }
-    //ieret
-  | TI_IERET      { $$ = 0b011110 << 20; }
-
-  //Octavo bloque: operaciones aritmeticas y logicas
-    //not reg
-  | TI_NOT T_REG                { $$ = (0b100000 << 20) | ($2 << 16); }
-    //add reg, lit
-  | TI_ADD T_REG ',' exp        { $$ = (0b100010 << 20) | ($2 << 16) | ($4 & 0xFFFF); }
-    //add reg, reg
-  | TI_ADD T_REG ',' T_REG      { $$ = (0b100011 << 20) | ($2 << 16) | ($4 << 12); }
-    //or reg, lit
-  | TI_OR T_REG ',' exp         { $$ = (0b100100 << 20) | ($2 << 16) | ($4 & 0xFFFF); }
-    //or reg, reg
-  | TI_OR T_REG ',' T_REG       { $$ = (0b100101 << 20) | ($2 << 16) | ($4 << 12); }
-    //addc reg, lit
-  | TI_ADDC T_REG ',' exp       { $$ = (0b100110 << 20) | ($2 << 16) | ($4 & 0xFFFF); }
-    //addc reg, reg
-  | TI_ADDC T_REG ',' T_REG     { $$ = (0b100111 << 20) | ($2 << 16) | ($4 << 12); }
-    //and reg, lit
-  | TI_AND T_REG ',' exp        { $$ = (0b101000 << 20) | ($2 << 16) | ($4 & 0xFFFF); }
-    //and reg, reg
-  | TI_AND T_REG ',' T_REG      { $$ = (0b101001 << 20) | ($2 << 16) | ($4 << 12); }
-    //sub reg, lit
-  | TI_SUB T_REG ',' exp        { $$ = (0b101010 << 20) | ($2 << 16) | ($4 & 0xFFFF); }
-    //sub reg, reg
-  | TI_SUB T_REG ',' T_REG      { $$ = (0b101011 << 20) | ($2 << 16) | ($4 << 12); }
-    //xor reg, lit
-  | TI_XOR T_REG ',' exp        { $$ = (0b101100 << 20) | ($2 << 16) | ($4 & 0xFFFF); }
-    //xor reg, reg
-  | TI_XOR T_REG ',' T_REG      { $$ = (0b101101 << 20) | ($2 << 16) | ($4 << 12); }
-    //subb reg, lit
-  | TI_SUBB T_REG ',' exp       { $$ = (0b101110 << 20) | ($2 << 16) | ($4 & 0xFFFF); }
-    //subb reg, reg
-  | TI_SUBB T_REG ',' T_REG     { $$ = (0b101111 << 20) | ($2 << 16) | ($4 << 12); }
-
-  //Noveno bloque: operaciones de multiplicacion
-    //mul reg, lit
-  | TI_MUL T_REG ',' exp        { $$ = (0b110000 << 20) | ($2 << 16) | ($4 & 0xFFFF); }
-    //mul reg, reg
-  | TI_MUL T_REG ',' T_REG      { $$ = (0b110001 << 20) | ($2 << 16) | ($4 << 12); }
-    //smul reg, lit
-  | TI_SMUL T_REG ',' exp       { $$ = (0b110010 << 20) | ($2 << 16) | ($4 & 0xFFFF); }
-    //smul reg, reg
-  | TI_SMUL T_REG ',' T_REG      { $$ = (0b110011 << 20) | ($2 << 16) | ($4 << 12); }
-
-  //Decimo bloque: operaciones de desplazamiento de bits
-    //shl0 reg, lit
-  | TI_SHL0 T_REG ',' exp     { $$ = (0b111000 << 20) | (0x0 << 9) | ($2 << 16) | ($4 & 0x000F); }
-    //shl0 reg, reg
-  | TI_SHL0 T_REG ',' T_REG   { $$ = (0b111001 << 20) | (0x0 << 9) | ($2 << 16) | ($4 << 12); }
-    //shl1 reg, lit
-  | TI_SHL1 T_REG ',' exp     { $$ = (0b111000 << 20) | (0x1 << 9) | ($2 << 16) | ($4 & 0x000F); }
-    //shl1 reg, reg
-  | TI_SHL1 T_REG ',' T_REG   { $$ = (0b111001 << 20) | (0x1 << 9) | ($2 << 16) | ($4 << 12); }
-    //rol reg, lit
-  | TI_ROL T_REG ',' exp      { $$ = (0b111000 << 20) | (0x2 << 9) | ($2 << 16) | ($4 & 0x000F); }
-    //rol reg, reg
-  | TI_ROL T_REG ',' T_REG    { $$ = (0b111001 << 20) | (0x2 << 9) | ($2 << 16) | ($4 << 12); }
-    //rolc reg
-  | TI_ROLC T_REG             { $$ = (0b111000 << 20) | (0x3 << 9) | ($2 << 16) | 0x1; }
-    //shr0 reg, lit
-  | TI_SHR0 T_REG ',' exp     { $$ = (0b111000 << 20) | (0x4 << 9) | ($2 << 16) | ($4 & 0x000F); }
-    //shr0 reg, reg
-  | TI_SHR0 T_REG ',' T_REG   { $$ = (0b111001 << 20) | (0x4 << 9) | ($2 << 16) | ($4 << 12); }
-    //shr1 reg, lit
-  | TI_SHR1 T_REG ',' exp     { $$ = (0b111000 << 20) | (0x5 << 9) | ($2 << 16) | ($4 & 0x000F); }
-    //shr1 reg, reg
-  | TI_SHR1 T_REG ',' T_REG   { $$ = (0b111001 << 20) | (0x5 << 9) | ($2 << 16) | ($4 << 12); }
-    //ror reg, lit
-  | TI_ROR T_REG ',' exp      { $$ = (0b111000 << 20) | (0x6 << 9) | ($2 << 16) | ($4 & 0x000F); }
-    //ror reg, reg
-  | TI_ROR T_REG ',' T_REG    { $$ = (0b111001 << 20) | (0x6 << 9) | ($2 << 16) | ($4 << 12); }
-    //rorc reg
-  | TI_RORC T_REG             { $$ = (0b111000 << 20) | (0x7 << 9) | ($2 << 16) | 0x1; }
-
-  //Decimo primer bloque: Instrucciones de entrada de datos hacia el CPU (desde literal, registro, memoria o I/O)
-    //move reg, lit
-  | TI_MOVE T_REG ',' exp               { $$ = (0b111010 << 20) | ($2 << 16) | ($4 & 0xFFFF); }
-    //move reg, reg
-  | TI_MOVE T_REG ',' T_REG             { $$ = (0b111011 << 20) | ($2 << 16) | ($4 << 12); }
-    //move reg, [dir]
-  | TI_MOVE T_REG ',' '[' exp   ']'     { $$ = (0b111100 << 20) | ($2 << 16) | ($5 & 0xFFFF); }
-    //move reg, [reg]
-  | TI_MOVE T_REG ',' '[' T_REG ']'     { $$ = (0b111101 << 20) | ($2 << 16) | ($5 << 12); }
-    //in reg, dir
-  | TI_IN T_REG ',' exp                 { $$ = (0b111110 << 20) | ($2 << 16) | ($4 & 0xFFFF); }
-    //in reg, reg
-  | TI_IN T_REG ',' T_REG               { $$ = (0b111111 << 20) | ($2 << 16) | ($4 << 12); }
+  | T_INSTR exp ',' T_REG           { if (!codificar(ctx, $1, FO_EXP_REG, $2, $4, &$$)) YYABORT; }
+    //setc | setz, clrc | clrn | clrv, ... (varias banderas en una sola instruccion)
+  | lista_banderas                  { $$ = $1; }
+;
+
+//Definicion de la sintaxis de las listas de banderas: setX (o clrX) separadas por '|', las
+//cuales se combinan en una sola instruccion (la misma que genera el optimizador)
+lista_banderas:
+  T_INSTR '|' T_INSTR               { if (!codificar(ctx, $1, FO_NINGUNO, 0, 0, &$$) ||
+                                          !agregar_bandera(ctx, $$, $3, &$$)) YYABORT; }
+  | lista_banderas '|' T_INSTR      { if (!agregar_bandera(ctx, $1, $3, &$$)) YYABORT; }
 ;
 
 //Definicion de los tipos de expresiones aritmeticas
 exp:
   //Las expresiones literales incluyen solo valores numericos conocidos
-  exp_lit       { $$ = $1; }    //Retorna directamente el valor calculado
+  exp_lit       {
+                  $$ = $1.valor;  //Retorna directamente el valor calculado
+                  //Si el valor es una direccion del modulo y se genera un objeto, se encola su correccion
+                  //para cuando se conozca la ubicacion final del modulo
+                  if (modo_objeto && $1.reub != REUB_NINGUNA && !encolar_reubicacion(ctx, $1)) YYABORT;
+                }
   //Las expresiones simbolicas son aquellas que incluyen al menos un simbolo (constante, etiqueta o variable)
   | exp_sim     {
                   $$ = 0;       //Retorna cero de momento (generara un resultado despues)
                   switch (seccion_actual) {
-                  case TS_DATOS: encolar_resultado_ram(pos_ram, num_lin); break;  //Guardara el resultado en RAM
-                  case TS_PROG:  encolar_resultado_prg(pos_prg, num_lin); break;  //Guardara resultado en memoria de prog.
+                  case TS_DATOS: encolar_resultado_ram(cola, pos_ram, num_lin); break;  //Guardara el resultado en RAM
+                  case TS_PROG:  encolar_resultado_prg(cola, pos_prg, num_lin); break;  //Guardara resultado en memoria de prog.
                   }
                 }
 ;
 
 exp_lit:
   //Un token literal (un numero) califica como expresion literal de forma implicita
-  T_LIT                         { $$ = $1; }
+  T_LIT                         { $$.valor = $1; $$.reub = REUB_NINGUNA; }
   //Un token simbolico previamente conocido puede ser promovido sin problemas a expresion literal, devolviendo su valor
   //numerico equivalente
-  | T_SIM_CON                   { $$ = $1->valor; }
+  | T_SIM_CON                   {
+                                  $$.valor = $1->valor;
+                                  $$.reub = $1->reubicacion;
+                                  if ($$.reub == REUB_PRG || $$.reub == REUB_INVALIDA)
+                                    ctx->info_optimizacion.usa_direccion_prg = true;
+                                  registrar_uso_direccion(ctx, $$);
+                                }
   //El simbolo $ representa la localidad de memoria actual
   | '$'                         {
                                   switch (seccion_actual) {
-                                  case TS_DATOS: $$ = pos_ram; break;  //Aca significa localidad actual de RAM
-                                  case TS_PROG:  $$ = pos_prg; break;  //Y aca localidad actual de memoria de programa
+                                  case TS_DATOS: $$.valor = pos_ram; $$.reub = REUB_RAM; break;  //Aca significa localidad actual de RAM
+                                  case TS_PROG:  $$.valor = pos_prg; $$.reub = REUB_PRG; break;  //Y aca localidad actual de programa
                                   }
+                                  if ($$.reub == REUB_PRG) ctx->info_optimizacion.usa_direccion_prg = true;
                                 }
   //Definicion de la sintaxis de los operadores
-  | exp_lit '|' exp_lit         { $$ = $1 | $3; }
-  | exp_lit '^' exp_lit         { $$ = $1 ^ $3; }
-  | exp_lit '&' exp_lit         { $$ = $1 & $3; }
-  | exp_lit TOP_SHL exp_lit     { $$ = $1 << $3; }
-  | exp_lit TOP_SHR exp_lit     { $$ = $1 >> $3; }
-  | exp_lit '+' exp_lit         { $$ = $1 + $3; }
-  | exp_lit '-' exp_lit         { $$ = $1 - $3; }
-  | exp_lit '*' exp_lit         { $$ = $1 * $3; }
-  | exp_lit '/' exp_lit         { $$ = $1 / $3; }
-  | exp_lit '%' exp_lit         { $$ = $1 % $3; }
-  | '-' exp_lit %prec TOP_NEG   { $$ = -$2; }
-  | '~' exp_lit                 { $$ = ~$2; }
-  | exp_lit TOP_EXP exp_lit     { $$ = pow($1, $3); }
+  | exp_lit '|' exp_lit         { $$ = operar_literal($1, OPER_OR, $3); }
+  | exp_lit '^' exp_lit         { $$ = operar_literal($1, OPER_XOR, $3); }
+  | exp_lit '&' exp_lit         { $$ = operar_literal($1, OPER_AND, $3); }
+  | exp_lit TOP_SHL exp_lit     { $$ = operar_literal($1, OPER_SHL, $3); }
+  | exp_lit TOP_SHR exp_lit     { $$ = operar_literal($1, OPER_SHR, $3); }
+  | exp_lit '+' exp_lit         { $$ = operar_literal($1, OPER_SUM, $3); }
+  | exp_lit '-' exp_lit         { $$ = operar_literal($1, OPER_RES, $3); }
+  | exp_lit '*' exp_lit         { $$ = operar_literal($1, OPER_MUL, $3); }
+  | exp_lit '/' exp_lit         { $$ = operar_literal($1, OPER_DIV, $3); }
+  | exp_lit '%' exp_lit         { $$ = operar_literal($1, OPER_MOD, $3); }
+  | '-' exp_lit %prec TOP_NEG   { $$ = operar_literal($2, OPER_NEG, $2); }
+  | '~' exp_lit                 { $$ = operar_literal($2, OPER_NOT, $2); }
+  | exp_lit TOP_EXP exp_lit     { $$ = operar_literal($1, OPER_EXP, $3); }
   | '(' exp_lit ')'             { $$ = $2; }
 ;
 
 exp_sim:
   //Un simbolo cuyo valor no se conoce es encolado para poder determinarlo despues en el paso 2, ademas un token simbolico
   //califica automaticamente como expresion simbolica
-  T_SIM_DESC                    { encolar_simbolo($1, num_lin); }
+  T_SIM_DESC                    { encolar_simbolo(cola, $1, num_lin); }
 
   //Si se mezcla una expresion simbolica con algo mas, pueden darse los siguientes casos
   //1- Si se mezcla con una expresion literal a la izquierda, entonces se encola dicho literal para ser agregado a la pila,
@@ -452,59 +472,389 @@ exp_sim:
   //Notese que los operadores unarios por su naturaleza impiden mezclar las expresiones simbolicas con otras expresiones,
   //por lo que se encola unicamente su operacion
 
-  | exp_lit '|' exp_sim         { encolar_literal($1, num_lin); encolar_operacion(OPER_OR | OPER_INTERCAMBIO, num_lin); }
-  | exp_sim '|' exp_lit         { encolar_literal($3, num_lin); encolar_operacion(OPER_OR, num_lin); }
-  | exp_sim '|' exp_sim         { encolar_operacion(OPER_OR, num_lin); }
+  | exp_lit '|' exp_sim         { if (!encolar_valor(ctx, $1)) YYABORT; encolar_operacion(cola, OPER_OR | OPER_INTERCAMBIO, num_lin); }
+  | exp_sim '|' exp_lit         { if (!encolar_valor(ctx, $3)) YYABORT; encolar_operacion(cola, OPER_OR, num_lin); }
+  | exp_sim '|' exp_sim         { encolar_operacion(cola, OPER_OR, num_lin); }
 
-  | exp_lit '^' exp_sim         { encolar_literal($1, num_lin); encolar_operacion(OPER_XOR | OPER_INTERCAMBIO, num_lin); }
-  | exp_sim '^' exp_lit         { encolar_literal($3, num_lin); encolar_operacion(OPER_XOR, num_lin); }
-  | exp_sim '^' exp_sim         { encolar_operacion(OPER_XOR, num_lin); }
+  | exp_lit '^' exp_sim         { if (!encolar_valor(ctx, $1)) YYABORT; encolar_operacion(cola, OPER_XOR | OPER_INTERCAMBIO, num_lin); }
+  | exp_sim '^' exp_lit         { if (!encolar_valor(ctx, $3)) YYABORT; encolar_operacion(cola, OPER_XOR, num_lin); }
+  | exp_sim '^' exp_sim         { encolar_operacion(cola, OPER_XOR, num_lin); }
 
-  | exp_lit '&' exp_sim         { encolar_literal($1, num_lin); encolar_operacion(OPER_AND | OPER_INTERCAMBIO, num_lin); }
-  | exp_sim '&' exp_lit         { encolar_literal($3, num_lin); encolar_operacion(OPER_AND, num_lin); }
-  | exp_sim '&' exp_sim         { encolar_operacion(OPER_AND, num_lin); }
+  | exp_lit '&' exp_sim         { if (!encolar_valor(ctx, $1)) YYABORT; encolar_operacion(cola, OPER_AND | OPER_INTERCAMBIO, num_lin); }
+  | exp_sim '&' exp_lit         { if (!encolar_valor(ctx, $3)) YYABORT; encolar_operacion(cola, OPER_AND, num_lin); }
+  | exp_sim '&' exp_sim         { encolar_operacion(cola, OPER_AND, num_lin); }
 
-  | exp_lit TOP_SHL exp_sim     { encolar_literal($1, num_lin); encolar_operacion(OPER_SHL | OPER_INTERCAMBIO, num_lin); }
-  | exp_sim TOP_SHL exp_lit     { encolar_literal($3, num_lin); encolar_operacion(OPER_SHL, num_lin); }
-  | exp_sim TOP_SHL exp_sim     { encolar_operacion(OPER_SHL, num_lin); }
+  | exp_lit TOP_SHL exp_sim     { if (!encolar_valor(ctx, $1)) YYABORT; encolar_operacion(cola, OPER_SHL | OPER_INTERCAMBIO, num_lin); }
+  | exp_sim TOP_SHL exp_lit     { if (!encolar_valor(ctx, $3)) YYABORT; encolar_operacion(cola, OPER_SHL, num_lin); }
+  | exp_sim TOP_SHL exp_sim     { encolar_operacion(cola, OPER_SHL, num_lin); }
 
-  | exp_lit TOP_SHR exp_sim     { encolar_literal($1, num_lin); encolar_operacion(OPER_SHR | OPER_INTERCAMBIO, num_lin); }
-  | exp_sim TOP_SHR exp_lit     { encolar_literal($3, num_lin); encolar_operacion(OPER_SHR, num_lin); }
-  | exp_sim TOP_SHR exp_sim     { encolar_operacion(OPER_SHR, num_lin); }
+  | exp_lit TOP_SHR exp_sim     { if (!encolar_valor(ctx, $1)) YYABORT; encolar_operacion(cola, OPER_SHR | OPER_INTERCAMBIO, num_lin); }
+  | exp_sim TOP_SHR exp_lit     { if (!encolar_valor(ctx, $3)) YYABORT; encolar_operacion(cola, OPER_SHR, num_lin); }
+  | exp_sim TOP_SHR exp_sim     { encolar_operacion(cola, OPER_SHR, num_lin); }
 
-  | exp_lit '+' exp_sim         { encolar_literal($1, num_lin); encolar_operacion(OPER_SUM | OPER_INTERCAMBIO, num_lin); }
-  | exp_sim '+' exp_lit         { encolar_literal($3, num_lin); encolar_operacion(OPER_SUM, num_lin); }
-  | exp_sim '+' exp_sim         { encolar_operacion(OPER_SUM, num_lin); }
+  | exp_lit '+' exp_sim         { if (!encolar_valor(ctx, $1)) YYABORT; encolar_operacion(cola, OPER_SUM | OPER_INTERCAMBIO, num_lin); }
+  | exp_sim '+' exp_lit         { if (!encolar_valor(ctx, $3)) YYABORT; encolar_operacion(cola, OPER_SUM, num_lin); }
+  | exp_sim '+' exp_sim         { encolar_operacion(cola, OPER_SUM, num_lin); }
 
-  | exp_lit '-' exp_sim         { encolar_literal($1, num_lin); encolar_operacion(OPER_RES | OPER_INTERCAMBIO, num_lin); }
-  | exp_sim '-' exp_lit         { encolar_literal($3, num_lin); encolar_operacion(OPER_RES, num_lin); }
-  | exp_sim '-' exp_sim         { encolar_operacion(OPER_RES, num_lin); }
+  | exp_lit '-' exp_sim         { if (!encolar_valor(ctx, $1)) YYABORT; encolar_operacion(cola, OPER_RES | OPER_INTERCAMBIO, num_lin); }
+  | exp_sim '-' exp_lit         { if (!encolar_valor(ctx, $3)) YYABORT; encolar_operacion(cola, OPER_RES, num_lin); }
+  | exp_sim '-' exp_sim         { encolar_operacion(cola, OPER_RES, num_lin); }
 
-  | exp_lit '*' exp_sim         { encolar_literal($1, num_lin); encolar_operacion(OPER_MUL | OPER_INTERCAMBIO, num_lin); }
-  | exp_sim '*' exp_lit         { encolar_literal($3, num_lin); encolar_operacion(OPER_MUL, num_lin); }
-  | exp_sim '*' exp_sim         { encolar_operacion(OPER_MUL, num_lin); }
+  | exp_lit '*' exp_sim         { if (!encolar_valor(ctx, $1)) YYABORT; encolar_operacion(cola, OPER_MUL | OPER_INTERCAMBIO, num_lin); }
+  | exp_sim '*' exp_lit         { if (!encolar_valor(ctx, $3)) YYABORT; encolar_operacion(cola, OPER_MUL, num_lin); }
+  | exp_sim '*' exp_sim         { encolar_operacion(cola, OPER_MUL, num_lin); }
 
-  | exp_lit '/' exp_sim         { encolar_literal($1, num_lin); encolar_operacion(OPER_DIV | OPER_INTERCAMBIO, num_lin); }
-  | exp_sim '/' exp_lit         { encolar_literal($3, num_lin); encolar_operacion(OPER_DIV, num_lin); }
-  | exp_sim '/' exp_sim         { encolar_operacion(OPER_DIV, num_lin); }
+  | exp_lit '/' exp_sim         { if (!encolar_valor(ctx, $1)) YYABORT; encolar_operacion(cola, OPER_DIV | OPER_INTERCAMBIO, num_lin); }
+  | exp_sim '/' exp_lit         { if (!encolar_valor(ctx, $3)) YYABORT; encolar_operacion(cola, OPER_DIV, num_lin); }
+  | exp_sim '/' exp_sim         { encolar_operacion(cola, OPER_DIV, num_lin); }
 
-  | exp_lit '%' exp_sim         { encolar_literal($1, num_lin); encolar_operacion(OPER_MOD | OPER_INTERCAMBIO, num_lin); }
-  | exp_sim '%' exp_lit         { encolar_literal($3, num_lin); encolar_operacion(OPER_MOD, num_lin); }
-  | exp_sim '%' exp_sim         { encolar_operacion(OPER_MOD, num_lin); }
+  | exp_lit '%' exp_sim         { if (!encolar_valor(ctx, $1)) YYABORT; encolar_operacion(cola, OPER_MOD | OPER_INTERCAMBIO, num_lin); }
+  | exp_sim '%' exp_lit         { if (!encolar_valor(ctx, $3)) YYABORT; encolar_operacion(cola, OPER_MOD, num_lin); }
+  | exp_sim '%' exp_sim         { encolar_operacion(cola, OPER_MOD, num_lin); }
 
-  | '-' exp_sim %prec TOP_NEG   { encolar_operacion(OPER_NEG, num_lin); }
-  | '~' exp_sim                 { encolar_operacion(OPER_NOT, num_lin); }
+  | '-' exp_sim %prec TOP_NEG   { encolar_operacion(cola, OPER_NEG, num_lin); }
+  | '~' exp_sim                 { encolar_operacion(cola, OPER_NOT, num_lin); }
 
-  | exp_lit TOP_EXP exp_sim     { encolar_literal($1, num_lin); encolar_operacion(OPER_EXP | OPER_INTERCAMBIO, num_lin); }
-  | exp_sim TOP_EXP exp_lit     { encolar_literal($3, num_lin); encolar_operacion(OPER_EXP, num_lin); }
-  | exp_sim TOP_EXP exp_sim     { encolar_operacion(OPER_EXP, num_lin); }
+  | exp_lit TOP_EXP exp_sim     { if (!encolar_valor(ctx, $1)) YYABORT; encolar_operacion(cola, OPER_EXP | OPER_INTERCAMBIO, num_lin); }
+  | exp_sim TOP_EXP exp_lit     { if (!encolar_valor(ctx, $3)) YYABORT; encolar_operacion(cola, OPER_EXP, num_lin); }
+  | exp_sim TOP_EXP exp_sim     { encolar_operacion(cola, OPER_EXP, num_lin); }
 
   | '(' exp_sim ')'             {}  //Los parentesis no provocan operaciones relevantes sobre la pila, sin embargo su
                                     //presencia aca permite implentar la regla de agrupacion
 ;
 %%
+//Las funciones locales usan el contexto de forma explicita
+#undef num_lin
+#undef seccion_actual
+#undef pos_prg
+#undef pos_ram
+#undef modo_objeto
+#undef cola
 
 //Funcion de manejo de errores (llamada por yyparse cuando hay errores)
-void yyerror(char const *s) {
-  msg_error_sintaxis(num_lin);
+void yyerror(CONTEXTO_ASM *ctx, void *escaner, char const *s) {
+  msg_error_sintaxis(ctx, ctx->num_lin);
+}
+
+//Funcion para operar dos expresiones literales, determinando a la vez la reubicacion del resultado
+//(en las operaciones unarias el argumento derecho se ignora)
+VALOR_EXP operar_literal(VALOR_EXP izquierda, OPERACION op, VALOR_EXP derecha) {
+  VALOR_EXP resultado;
+
+  //Primeramente se calcula el valor numerico
+  switch (op) {
+  case OPER_OR:  resultado.valor = izquierda.valor | derecha.valor;     break;
+  case OPER_XOR: resultado.valor = izquierda.valor ^ derecha.valor;     break;
+  case OPER_AND: resultado.valor = izquierda.valor & derecha.valor;     break;
+  case OPER_SHL: resultado.valor = izquierda.valor << derecha.valor;    break;
+  case OPER_SHR: resultado.valor = izquierda.valor >> derecha.valor;    break;
+  case OPER_SUM: resultado.valor = izquierda.valor + derecha.valor;     break;
+  case OPER_RES: resultado.valor = izquierda.valor - derecha.valor;     break;
+  case OPER_MUL: resultado.valor = izquierda.valor * derecha.valor;     break;
+  case OPER_DIV: resultado.valor = izquierda.valor / derecha.valor;     break;
+  case OPER_MOD: resultado.valor = izquierda.valor % derecha.valor;     break;
+  case OPER_NEG: resultado.valor = -izquierda.valor;                    break;
+  case OPER_NOT: resultado.valor = ~izquierda.valor;                    break;
+  case OPER_EXP: resultado.valor = pow(izquierda.valor, derecha.valor); break;
+  }
+
+  //Luego se determina la reubicacion: una direccion se puede desplazar sumandole o restandole un
+  //valor absoluto, y la diferencia entre dos direcciones de la misma memoria es absoluta. Cualquier
+  //otra operacion que involucre direcciones no se puede corregir al enlazar
+  if (op == OPER_NEG || op == OPER_NOT)
+    derecha.reub = REUB_NINGUNA;
+  if (izquierda.reub == REUB_NINGUNA && derecha.reub == REUB_NINGUNA)
+    resultado.reub = REUB_NINGUNA;
+  else if (op == OPER_SUM && (izquierda.reub == REUB_NINGUNA || derecha.reub == REUB_NINGUNA))
+    resultado.reub = izquierda.reub | derecha.reub;
+  else if (op == OPER_RES && derecha.reub == REUB_NINGUNA)
+    resultado.reub = izquierda.reub;
+  else if (op == OPER_RES && izquierda.reub == derecha.reub && izquierda.reub != REUB_INVALIDA)
+    resultado.reub = REUB_NINGUNA;
+  else
+    resultado.reub = REUB_INVALIDA;
+
+  return resultado;
+}
+
+//Funcion que obtiene el simbolo que representa el inicio del codigo o los datos del modulo. Su
+//valor es cero mientras se ensambla, y el enlazador lo sustituye por la ubicacion final del modulo
+//(los nombres inician con $ para que no puedan coincidir con simbolos del codigo fuente)
+SIMBOLO *simbolo_base(CONTEXTO_ASM *ctx, TIPO_REUBICACION reub) {
+  const char *nombre = reub == REUB_PRG ? "$code" : "$data";
+  SIMBOLO *simbolo = reservar_simbolo(&ctx->lista_simbolos, nombre);
+
+  if (!simbolo->definido) definir_simbolo(simbolo, 0, reub);
+  return simbolo;
+}
+
+//Funcion para encolar una expresion literal dentro de una expresion simbolica. En modo objeto, si
+//el literal es una direccion del modulo se le suma el inicio de su memoria correspondiente
+bool encolar_valor(CONTEXTO_ASM *ctx, VALOR_EXP expresion) {
+  encolar_literal(&ctx->cola_acciones, expresion.valor, ctx->num_lin);
+  if (!ctx->modo_objeto || expresion.reub == REUB_NINGUNA) return true;
+
+  if (expresion.reub == REUB_INVALIDA) {
+    msg_expr_no_reubicable(ctx, ctx->num_lin);
+    return false;
+  }
+  encolar_simbolo(&ctx->cola_acciones, simbolo_base(ctx, expresion.reub), ctx->num_lin);
+  encolar_operacion(&ctx->cola_acciones, OPER_SUM, ctx->num_lin);
+  return true;
+}
+
+//Funcion para encolar la correccion de una direccion del modulo que aparece como argumento literal
+//(solo se usa en modo objeto)
+bool encolar_reubicacion(CONTEXTO_ASM *ctx, VALOR_EXP expresion) {
+  if (expresion.reub == REUB_INVALIDA) {
+    msg_expr_no_reubicable(ctx, ctx->num_lin);
+    return false;
+  }
+
+  switch (ctx->seccion_actual) {
+  case TS_DATOS:
+    //La RAM recibe el resultado completo, por lo que se encola la direccion mas el inicio
+    encolar_literal(&ctx->cola_acciones, expresion.valor, ctx->num_lin);
+    encolar_simbolo(&ctx->cola_acciones, simbolo_base(ctx, expresion.reub), ctx->num_lin);
+    encolar_operacion(&ctx->cola_acciones, OPER_SUM, ctx->num_lin);
+    encolar_resultado_ram(&ctx->cola_acciones, ctx->pos_ram, ctx->num_lin);
+    break;
+  case TS_PROG:
+    //En la memoria de programa el resultado se suma al literal de la instruccion, el cual ya
+    //contiene la direccion, asi que solo hace falta sumar el inicio
+    encolar_simbolo(&ctx->cola_acciones, simbolo_base(ctx, expresion.reub), ctx->num_lin);
+    encolar_resultado_prg(&ctx->cola_acciones, ctx->pos_prg, ctx->num_lin);
+    break;
+  }
+  return true;
+}
+
+//Funcion que implementa la directiva fill: reserva una cantidad de localidades de RAM con el mismo
+//valor. En modo objeto, si el valor es una direccion del modulo se encola su correccion en cada una
+bool rellenar_ram(CONTEXTO_ASM *ctx, VALOR_EXP cantidad, VALOR_EXP valor) {
+  int i;
+
+  if (ctx->seccion_actual != TS_DATOS) {
+    msg_datos_seccion_incorrecta(ctx, ctx->num_lin);
+    return false;
+  }
+  if (ctx->modo_objeto && cantidad.reub != REUB_NINGUNA) {
+    msg_expr_no_reubicable(ctx, ctx->num_lin);
+    return false;
+  }
+  if (cantidad.valor < 0) {
+    msg_cantidad_datos_invalida(ctx, ctx->num_lin, cantidad.valor);
+    return false;
+  }
+  if (descartar_dato(ctx)) return true;
+
+  for (i=0; i<cantidad.valor; i++) {
+    if (ctx->modo_objeto && valor.reub != REUB_NINGUNA && !encolar_reubicacion(ctx, valor))
+      return false;
+    if (!agregar_dato_ram(ctx, valor.valor, ctx->num_lin)) return false;
+  }
+  if (cantidad.valor) ubicar_usos_direccion(ctx, TS_DATOS, ctx->pos_ram - cantidad.valor, false);
+  return true;
+}
+
+//Funcion que agrega a la RAM los datos generados por las directivas incbin, inchex y table, y
+//luego los desaloja (un arreglo NULL indica que ya se reporto un error)
+bool agregar_bloque_ram(CONTEXTO_ASM *ctx, int *datos, int cantidad) {
+  bool exito = datos != NULL;
+  int i;
+
+  if (exito && ctx->seccion_actual != TS_DATOS) {
+    msg_datos_seccion_incorrecta(ctx, ctx->num_lin);
+    exito = false;
+  }
+  if (exito && !descartar_dato(ctx)) {
+    for (i=0; i<cantidad && exito; i++) exito = agregar_dato_ram(ctx, datos[i], ctx->num_lin);
+    if (exito && cantidad) ubicar_usos_direccion(ctx, TS_DATOS, ctx->pos_ram - cantidad, false);
+  }
+  free(datos);
+  return exito;
+}
+
+//Funcion para comenzar a leer un archivo incluido. El nombre se busca primero en el directorio del
+//archivo que contiene la directiva y luego tal cual (relativo al directorio de trabajo)
+bool iniciar_inclusion(CONTEXTO_ASM *ctx, void *escaner, const char *nombre) {
+  char ruta[PATH_MAX];
+  FILE *fp_archivo;
+  INCLUSION *inclusion;
+
+  //Limita el anidamiento (tambien evita la recursion infinita de un archivo que se incluye solo)
+  if (ctx->nivel_inclusion == PROFUNDIDAD_MAX_INCLUSION) {
+    msg_inclusion_demasiado_profunda(ctx, ctx->num_lin, nombre);
+    return false;
+  }
+
+  fp_archivo = abrir_fuente(ctx, nombre, "r", ruta, sizeof(ruta));
+  if (!fp_archivo) {
+    msg_error_abrir_inclusion(ctx, ctx->num_lin, nombre);
+    return false;
+  }
+
+  //Guarda la ubicacion de la directiva y pasa al nuevo archivo. El conteo de lineas inicia en cero
+  //porque al terminar de procesar la linea de la directiva se incrementa. El archivo se guarda en
+  //la pila para cerrarlo al terminar (o si el ensamblado se aborta dentro de el)
+  inclusion = &ctx->pila_inclusion[ctx->nivel_inclusion++];
+  inclusion->num_lin = ctx->num_lin;
+  inclusion->fuente = ctx->fuente_actual;
+  inclusion->fp = fp_archivo;
+  inclusion->cuerpo = NULL;
+  inclusion->vueltas = 0;
+  ctx->fuente_actual = registrar_fuente(&ctx->registro_fuentes, ruta);
+  seleccionar_fuente(ctx, ctx->fuente_actual);
+  fijar_fuente_acciones(&ctx->cola_acciones, ctx->fuente_actual);
+  apilar_archivo_lexico(escaner, fp_archivo);
+  ctx->num_lin = 0;
+  return true;
+}
+
+//Funcion para regresar al archivo que contiene la directiva include del archivo que termino (o la
+//invocacion de la macro o la directiva rept cuya expansion termino)
+void terminar_inclusion(CONTEXTO_ASM *ctx) {
+  INCLUSION *inclusion = &ctx->pila_inclusion[ctx->nivel_inclusion - 1];
+  char *texto;
+  int tam;
+
+  ctx->inclusion_terminada = false;
+
+  //Si a la repeticion le quedan vueltas, la siguiente inicia otra vez en la directiva rept
+  if (inclusion->vueltas) {
+    inclusion->vueltas--;
+    texto = expandir_repeticion(&ctx->tabla_macros, inclusion->cuerpo, &tam);
+    leer_expansion(ctx, ctx->escaner, texto, tam, ctx->fuente_actual, inclusion->lin_cuerpo);
+    free(texto);
+    return;
+  }
+
+  ctx->nivel_inclusion--;
+  if (inclusion->fp) fclose(inclusion->fp);
+  ctx->num_lin = inclusion->num_lin;
+  ctx->fuente_actual = inclusion->fuente;
+  seleccionar_fuente(ctx, ctx->fuente_actual);
+  fijar_fuente_acciones(&ctx->cola_acciones, ctx->fuente_actual);
+}
+
+//Funcion para definir una macro con el texto que sigue a la directiva macro y su cuerpo. La linea
+//actual pasa a ser la de la directiva endm
+bool registrar_macro(CONTEXTO_ASM *ctx, const char *cabecera, const char *cuerpo) {
+  if (!cuerpo) {
+    msg_bloque_sin_endm(ctx, ctx->num_lin);
+    return false;
+  }
+  if (!definir_macro(ctx, cabecera, cuerpo)) return false;
+  ctx->num_lin += contar_lineas(cuerpo) + 1;
+  return true;
+}
+
+//Funcion para comenzar a leer la expansion de una macro
+bool iniciar_macro(CONTEXTO_ASM *ctx, void *escaner, MACRO *macro, const char *argumentos) {
+  INCLUSION *inclusion;
+  char *texto;
+  int tam;
+
+  //Limita el anidamiento (tambien evita la recursion infinita de una macro que se invoca sola)
+  if (ctx->nivel_inclusion == PROFUNDIDAD_MAX_INCLUSION) {
+    msg_expansion_demasiado_profunda(ctx, ctx->num_lin, macro->nombre);
+    return false;
+  }
+  texto = expandir_macro(ctx, macro, argumentos, &tam);
+  if (!texto) return false;
+
+  //Guarda la ubicacion de la invocacion, igual que con los archivos incluidos
+  inclusion = &ctx->pila_inclusion[ctx->nivel_inclusion++];
+  inclusion->num_lin = ctx->num_lin;
+  inclusion->fuente = ctx->fuente_actual;
+  inclusion->fp = NULL;
+  inclusion->cuerpo = NULL;
+  inclusion->vueltas = 0;
+  leer_expansion(ctx, escaner, texto, tam, macro->fuente, macro->num_lin);
+  free(texto);
+  return true;
+}
+
+//Funcion para comenzar a leer la primera vuelta de una repeticion. Las vueltas restantes se
+//expanden al terminar cada una (ver terminar_inclusion)
+bool iniciar_repeticion(CONTEXTO_ASM *ctx, void *escaner, VALOR_EXP vueltas, const char *cuerpo) {
+  INCLUSION *inclusion;
+  char *texto;
+  int tam, lineas;
+
+  if (!cuerpo) {
+    msg_bloque_sin_endm(ctx, ctx->num_lin);
+    return false;
+  }
+  if (ctx->modo_objeto && vueltas.reub != REUB_NINGUNA) {
+    msg_expr_no_reubicable(ctx, ctx->num_lin);
+    return false;
+  }
+  if (vueltas.valor < 0) {
+    msg_repeticion_invalida(ctx, ctx->num_lin, vueltas.valor);
+    return false;
+  }
+
+  //Sin vueltas el cuerpo simplemente se salta hasta la linea de endm
+  lineas = contar_lineas(cuerpo) + 1;
+  if (!vueltas.valor) {
+    ctx->num_lin += lineas;
+    return true;
+  }
+  if (ctx->nivel_inclusion == PROFUNDIDAD_MAX_INCLUSION) {
+    msg_expansion_demasiado_profunda(ctx, ctx->num_lin, "rept");
+    return false;
+  }
+
+  //Al terminar la ultima vuelta se continua con la linea que sigue a endm
+  inclusion = &ctx->pila_inclusion[ctx->nivel_inclusion++];
+  inclusion->num_lin = ctx->num_lin + lineas;
+  inclusion->fuente = ctx->fuente_actual;
+  inclusion->fp = NULL;
+  inclusion->cuerpo = guardar_cuerpo(&ctx->tabla_macros, cuerpo);
+  inclusion->lin_cuerpo = ctx->num_lin;
+  inclusion->vueltas = vueltas.valor - 1;
+  texto = expandir_repeticion(&ctx->tabla_macros, inclusion->cuerpo, &tam);
+  leer_expansion(ctx, escaner, texto, tam, ctx->fuente_actual, ctx->num_lin);
+  free(texto);
+  return true;
+}
+
+//Funcion que entrega al analizador lexico el texto de una expansion. Sus lineas conservan el
+//archivo y los numeros de linea de la definicion del cuerpo (para los mensajes y el listado)
+void leer_expansion(CONTEXTO_ASM *ctx, void *escaner, const char *texto, int tam, int fuente,
+                    int lin_inicio) {
+  ctx->fuente_actual = fuente;
+  seleccionar_fuente(ctx, fuente);
+  fijar_fuente_acciones(&ctx->cola_acciones, fuente);
+  apilar_texto_lexico(escaner, texto, tam);
+  ctx->num_lin = lin_inicio;    //Al terminar la linea actual pasa a la primera del cuerpo
+}
+
+//Funcion que obtiene el codigo de una instruccion ubicada en la posicion actual del programa. Si
+//el mnemonico no acepta la forma de los operandos se reporta un error de sintaxis
+bool codificar(CONTEXTO_ASM *ctx, int mnemonico, FORMA_OPERANDOS forma, int operando_1,
+               int operando_2, int *codigo) {
+  uint32_t resultado;
+
+  if (!codificar_instruccion(mnemonico, forma, operando_1, operando_2, ctx->pos_prg, &resultado)) {
+    msg_error_sintaxis(ctx, ctx->num_lin);
+    return false;
+  }
+  *codigo = resultado;
+  return true;
+}
+
+//Funcion que agrega una instruccion setX o clrX a una lista de banderas ya codificada
+bool agregar_bandera(CONTEXTO_ASM *ctx, int codigo, int mnemonico, int *resultado) {
+  int bandera;
+  uint32_t combinado;
+
+  if (!codificar(ctx, mnemonico, FO_NINGUNO, 0, 0, &bandera)) return false;
+  if (!combinar_banderas(codigo, bandera, &combinado)) {
+    msg_error_sintaxis(ctx, ctx->num_lin);
+    return false;
+  }
+  *resultado = combinado;
+  return true;
 }
@@ -0,0 +1,387 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_recolector.c                                                                           |
+//| Modulo de recoleccion del codigo y los datos que no se usan                                   |
+//|                                                                                               |
+//| Este modulo implementa la opcion -gc, la cual elimina las rutinas y los bloques de datos que  |
+//| el programa nunca alcanza, de manera que un programa armado con bibliotecas compartidas       |
+//| (incluidas con include) ocupe solo lo que realmente usa y pueda caber en menos bloques de     |
+//| RAM de la FPGA.                                                                               |
+//| Durante el ensamblado se registran los bloques (lo que sigue a cada etiqueta hasta la         |
+//| siguiente etiqueta de la misma seccion, o hasta una directiva code o data con direccion) y    |
+//| cada uso de una direccion como valor (p. ej. move r1, tabla o word rutina) junto con el lugar |
+//| donde aparece. Al terminar el paso 2 se recorre el programa desde sus raices: el reinicio     |
+//| (direccion 0), la entrada de interrupcion (ultima direccion) y todo lo que no esta bajo       |
+//| ninguna etiqueta. Una instruccion alcanzable hace alcanzable a la siguiente (salvo los saltos |
+//| incondicionales y los retornos), al destino de sus saltos y llamadas directas y a las         |
+//| direcciones que usa como valor; un dato alcanzable hace alcanzables las direcciones que       |
+//| contiene. Un bloque se conserva completo si cualquiera de sus direcciones es alcanzable.      |
+//| Los bloques que quedan sin alcanzar se eliminan volviendo a ensamblar el archivo mientras se  |
+//| descartan sus instrucciones y datos, de manera que el propio ensamblador vuelve a ubicar todo |
+//| lo que queda y a calcular todas las expresiones (incluidas las diferencias de etiquetas).     |
+//| Nota: el analisis supone que el codigo y los datos se alcanzan a traves de etiquetas. Un      |
+//| programa que usa direcciones numericas fijas debe ubicarlas con code o data direccion.        |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+#include <stdio.h>                      //Permite manejar archivos
+#include <stdlib.h>                     //Permite invocar malloc, realloc, qsort y free
+#include <string.h>                     //Permite manejar cadenas
+#include "j16asm_recolector.h"          //Cabecera propia
+#include "j16asm.h"                     //Importa el contexto de ensamblado
+#include "j16asm_ensamblador.h"         //Permite volver a ensamblar el archivo
+#include "j16asm_imagen_mem.h"          //Importa la imagen de las memorias de programa y RAM
+#include "j16asm_optimizador.h"         //Importa la identificacion de saltos directos
+#include "j16asm_arena.h"               //Permite contar los alojamientos de memoria (-stats)
+#include "j16asm_messages.h"            //Permite enviar mensajes al usuario
+
+//Estructura con el estado del recorrido del programa
+typedef struct _RECORRIDO {
+  CONTEXTO_ASM *ctx;                    //Contexto de ensamblado
+  int tam[2];                           //Capacidad de cada memoria (indexado por seccion)
+  int *bloque_de[2];                    //Bloque al que pertenece cada direccion (-1 si ninguno)
+  bool *visitada[2];                    //Direcciones ya recorridas
+  bool *vivo;                           //Bloques alcanzables
+  int *pendientes;                      //Direcciones por recorrer (seccion * 65536 + direccion)
+  int num_pendientes;                   //Cantidad de direcciones por recorrer
+} RECORRIDO;
+
+//Declaracion previa de las funciones locales al modulo
+static void *ampliar(void *arreglo, int *capacidad, int cantidad, size_t tam_elemento);
+static bool localidad_ocupada(CONTEXTO_ASM *ctx, int seccion, int direccion);
+static bool continua_en_siguiente(uint32_t instr);
+static void marcar(RECORRIDO *r, int seccion, int direccion);
+static void visitar(RECORRIDO *r, int seccion, int direccion);
+static void recorrer(RECORRIDO *r, int seccion, int direccion);
+static int comparar_referencias(const void *a, const void *b);
+static int comparar_nombres(const void *a, const void *b);
+static int capacidad_minima(int cantidad, int minima);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion que se invoca al definir una etiqueta: inicia un nuevo bloque en la seccion actual, y al
+//volver a ensamblar indica si lo que sigue se descarta
+void iniciar_bloque(CONTEXTO_ASM *ctx, SIMBOLO *etiqueta) {
+  INFO_RECOLECCION *info = &ctx->info_recoleccion;
+  int seccion = ctx->seccion_actual;
+  BLOQUE_ETIQUETA *bloque;
+
+  if (info->num_descartadas)
+    info->descartando[seccion] = bsearch(&etiqueta->nombre, info->descartadas,
+                                         info->num_descartadas, sizeof(char *),
+                                         comparar_nombres) != NULL;
+  if (!info->registrar) return;
+
+  cerrar_bloque(ctx, seccion);
+  info->bloques = ampliar(info->bloques, &info->capacidad_bloques, info->num_bloques,
+                          sizeof(BLOQUE_ETIQUETA));
+  bloque = &info->bloques[info->num_bloques];
+  bloque->etiqueta = etiqueta;
+  bloque->seccion = seccion;
+  bloque->inicio = seccion == TS_PROG ? ctx->pos_prg : ctx->pos_ram;
+  bloque->fin = -1;
+  info->bloque_abierto[seccion] = info->num_bloques++;
+}
+
+//Funcion que termina el bloque abierto de una seccion (se invoca antes de cambiar la posicion con
+//una directiva code o data, ya que lo que sigue no pertenece al bloque)
+void cerrar_bloque(CONTEXTO_ASM *ctx, int seccion) {
+  INFO_RECOLECCION *info = &ctx->info_recoleccion;
+
+  info->descartando[seccion] = false;
+  if (info->bloque_abierto[seccion] < 0) return;
+  info->bloques[info->bloque_abierto[seccion]].fin =
+    seccion == TS_PROG ? ctx->pos_prg : ctx->pos_ram;
+  info->bloque_abierto[seccion] = -1;
+}
+
+//Funcion que registra el uso de una direccion como valor en el dato que se esta ensamblando (su
+//ubicacion se conoce al agregar el dato)
+void registrar_uso_direccion(CONTEXTO_ASM *ctx, VALOR_EXP valor) {
+  INFO_RECOLECCION *info = &ctx->info_recoleccion;
+
+  if (!info->registrar || (valor.reub != REUB_PRG && valor.reub != REUB_RAM)) return;
+  info->pendientes = ampliar(info->pendientes, &info->capacidad_pendientes, info->num_pendientes,
+                             sizeof(VALOR_EXP));
+  info->pendientes[info->num_pendientes++] = valor;
+}
+
+//Funcion que asigna a las direcciones usadas la ubicacion del dato donde aparecen. El destino de
+//los saltos y llamadas directas no se registra, ya que se obtiene de la propia instruccion
+void ubicar_usos_direccion(CONTEXTO_ASM *ctx, int seccion, int direccion, bool es_salto) {
+  INFO_RECOLECCION *info = &ctx->info_recoleccion;
+  REFERENCIA_DIR *referencia;
+  int i;
+
+  for (i=0; i<info->num_pendientes && !es_salto; i++) {
+    info->referencias = ampliar(info->referencias, &info->capacidad_referencias,
+                                info->num_referencias, sizeof(REFERENCIA_DIR));
+    referencia = &info->referencias[info->num_referencias++];
+    referencia->seccion_origen = seccion;
+    referencia->origen = direccion;
+    referencia->seccion_destino = info->pendientes[i].reub == REUB_PRG ? TS_PROG : TS_DATOS;
+    referencia->destino = info->pendientes[i].valor;
+  }
+  info->num_pendientes = 0;
+}
+
+//Funcion que indica si el dato que se esta ensamblando se descarta (en cuyo caso deshace las
+//expresiones que encolo)
+bool descartar_dato(CONTEXTO_ASM *ctx) {
+  INFO_RECOLECCION *info = &ctx->info_recoleccion;
+
+  if (!info->descartando[ctx->seccion_actual]) return false;
+  descartar_acciones(&ctx->cola_acciones, info->marca_acciones);
+  ctx->info_optimizacion.usa_direccion_prg = false;
+  return true;
+}
+
+//Funcion que se invoca al terminar cada linea. Las direcciones usadas fuera de un dato (equ y
+//directivas) no se registran: las usa quien use el simbolo definido
+void terminar_linea_recoleccion(CONTEXTO_ASM *ctx) {
+  ctx->info_recoleccion.num_pendientes = 0;
+  ctx->info_recoleccion.marca_acciones = ctx->cola_acciones.cantidad;
+}
+
+//Funcion para dejar la informacion lista para un nuevo ensamblado (se conservan las etiquetas a
+//descartar y la indicacion de registrar)
+void reiniciar_info_recoleccion(INFO_RECOLECCION *info) {
+  free(info->bloques);
+  free(info->referencias);
+  free(info->pendientes);
+  info->bloques = NULL;
+  info->num_bloques = info->capacidad_bloques = 0;
+  info->referencias = NULL;
+  info->num_referencias = info->capacidad_referencias = 0;
+  info->pendientes = NULL;
+  info->num_pendientes = info->capacidad_pendientes = 0;
+  info->bloque_abierto[TS_DATOS] = info->bloque_abierto[TS_PROG] = -1;
+  info->descartando[TS_DATOS] = info->descartando[TS_PROG] = false;
+  info->marca_acciones = 0;
+}
+
+//Funcion para liberar toda la informacion
+void desalojar_info_recoleccion(INFO_RECOLECCION *info) {
+  int i;
+
+  reiniciar_info_recoleccion(info);
+  for (i=0; i<info->num_descartadas; i++)
+    free(info->descartadas[i]);
+  free(info->descartadas);
+  info->descartadas = NULL;
+  info->num_descartadas = 0;
+  info->registrar = false;
+}
+
+//Funcion que elimina los bloques inalcanzables de un programa ya ensamblado (pasos 1 y 2, con la
+//informacion registrada). Si hay algo que eliminar, reporta cada bloque y vuelve a ensamblar el
+//archivo descartandolos. Retorna false si el nuevo ensamblado falla
+bool recolectar_basura(CONTEXTO_ASM *ctx, const char *nombre_archivo,
+                       ESTADISTICAS_RECOLECCION *estadisticas) {
+  INFO_RECOLECCION *info = &ctx->info_recoleccion;
+  RECORRIDO r;
+  BLOQUE_ETIQUETA *bloque;
+  FILE *fp_archivo;
+  int seccion, direccion, i, cantidad;
+  bool exito = true;
+
+  memset(estadisticas, 0, sizeof(ESTADISTICAS_RECOLECCION));
+
+  //Prepara el recorrido: cada direccion conoce su bloque (los que siguen abiertos terminan en la
+  //posicion final de su seccion)
+  memset(&r, 0, sizeof(RECORRIDO));
+  r.ctx = ctx;
+  r.tam[TS_PROG] = ctx->tam_prg;
+  r.tam[TS_DATOS] = ctx->tam_ram;
+  cerrar_bloque(ctx, TS_PROG);
+  cerrar_bloque(ctx, TS_DATOS);
+  for (seccion=0; seccion<2; seccion++) {
+    r.bloque_de[seccion] = malloc(r.tam[seccion] * sizeof(int));
+    r.visitada[seccion] = calloc(r.tam[seccion], sizeof(bool));
+    contar_alojamiento(r.tam[seccion] * sizeof(int));
+    contar_alojamiento(r.tam[seccion] * sizeof(bool));
+    for (direccion=0; direccion<r.tam[seccion]; direccion++) r.bloque_de[seccion][direccion] = -1;
+  }
+  for (i=0; i<info->num_bloques; i++) {
+    bloque = &info->bloques[i];
+    for (direccion=bloque->inicio; direccion<bloque->fin && direccion<r.tam[bloque->seccion];
+         direccion++)
+      r.bloque_de[bloque->seccion][direccion] = i;
+  }
+  r.vivo = calloc(info->num_bloques + 1, sizeof(bool));
+  r.pendientes = malloc((ctx->tam_prg + ctx->tam_ram) * sizeof(int));
+  contar_alojamiento((info->num_bloques + 1) * sizeof(bool));
+  contar_alojamiento((ctx->tam_prg + ctx->tam_ram) * sizeof(int));
+  if (info->num_referencias)
+    qsort(info->referencias, info->num_referencias, sizeof(REFERENCIA_DIR), comparar_referencias);
+
+  //Las raices son el reinicio, la entrada de interrupcion y todo lo que no esta bajo una etiqueta
+  marcar(&r, TS_PROG, 0);
+  marcar(&r, TS_PROG, ctx->tam_prg - 1);
+  for (seccion=0; seccion<2; seccion++)
+    for (direccion=0; direccion<r.tam[seccion]; direccion++)
+      if (r.bloque_de[seccion][direccion] < 0) visitar(&r, seccion, direccion);
+
+  //Recorre todo lo alcanzable
+  while (r.num_pendientes) {
+    direccion = r.pendientes[--r.num_pendientes];
+    recorrer(&r, direccion >> 16, direccion & 0xFFFF);
+  }
+
+  //Reporta los bloques que no se alcanzaron y guarda sus etiquetas para descartarlos
+  for (i=0; i<info->num_bloques; i++) {
+    bloque = &info->bloques[i];
+    if (r.vivo[i]) continue;
+    for (cantidad=0, direccion=bloque->inicio; direccion<bloque->fin; direccion++)
+      cantidad += localidad_ocupada(ctx, bloque->seccion, direccion);
+    if (!cantidad) continue;            //Las etiquetas sin contenido no ocupan nada
+
+    msg_recoleccion_bloque(ctx, bloque->etiqueta->nombre, bloque->seccion == TS_DATOS,
+                           cantidad, bloque->inicio);
+    if (bloque->seccion == TS_PROG) {
+      estadisticas->bloques_prg++;
+      estadisticas->instrucciones += cantidad;
+    }
+    else {
+      estadisticas->bloques_ram++;
+      estadisticas->palabras += cantidad;
+    }
+    info->descartadas = realloc(info->descartadas, (info->num_descartadas + 1) * sizeof(char *));
+    info->descartadas[info->num_descartadas++] = strdup(bloque->etiqueta->nombre);
+  }
+
+  for (seccion=0; seccion<2; seccion++) {
+    free(r.bloque_de[seccion]);
+    free(r.visitada[seccion]);
+  }
+  free(r.vivo);
+  free(r.pendientes);
+
+  //Si hay algo que eliminar, vuelve a ensamblar el archivo descartando esos bloques
+  if (info->num_descartadas) {
+    qsort(info->descartadas, info->num_descartadas, sizeof(char *), comparar_nombres);
+    info->registrar = false;
+    reiniciar_contexto(ctx);
+    if (nombre_archivo != ctx->nombre_archivo_ent)
+      snprintf(ctx->nombre_archivo_ent, sizeof(ctx->nombre_archivo_ent), "%s", nombre_archivo);
+    fp_archivo = fopen(nombre_archivo, "r");
+    if (!fp_archivo) {
+      msg_error_abrir_archivo_entrada(ctx);
+      return false;
+    }
+    exito = proceso_paso_1(ctx, fp_archivo);
+    fclose(fp_archivo);
+    exito = exito && proceso_paso_2(ctx);
+  }
+
+  estadisticas->tam_prg_minimo = capacidad_minima(contar_localidades_prg(&ctx->imagen), 512);
+  estadisticas->tam_ram_minimo = capacidad_minima(contar_localidades_ram(&ctx->imagen), 1024);
+  return exito;
+}
+
+//Funcion que indica si una etiqueta inicia un bloque que la recoleccion elimino (la etiqueta sigue
+//definida, pero en la direccion de lo que sigue al bloque)
+bool etiqueta_descartada(CONTEXTO_ASM *ctx, const char *nombre) {
+  INFO_RECOLECCION *info = &ctx->info_recoleccion;
+
+  return info->num_descartadas &&
+         bsearch(&nombre, info->descartadas, info->num_descartadas, sizeof(char *),
+                 comparar_nombres) != NULL;
+}
+
+//Funcion para ampliar un arreglo si ya no cabe otro elemento (duplica su capacidad)
+static void *ampliar(void *arreglo, int *capacidad, int cantidad, size_t tam_elemento) {
+  if (cantidad < *capacidad) return arreglo;
+  *capacidad = *capacidad ? *capacidad * 2 : 64;
+  return realloc(arreglo, *capacidad * tam_elemento);
+}
+
+//Funcion que indica si una localidad de la memoria de una seccion esta ocupada
+static bool localidad_ocupada(CONTEXTO_ASM *ctx, int seccion, int direccion) {
+  if (seccion == TS_PROG) return localidad_prg_ocupada(&ctx->imagen, direccion);
+  return localidad_ram_ocupada(&ctx->imagen, direccion);
+}
+
+//Funcion que indica si despues de una instruccion se ejecuta la siguiente (todas salvo los
+//saltos incondicionales, return, idret e ieret)
+static bool continua_en_siguiente(uint32_t instr) {
+  switch (instr >> 20) {
+  case 0b010000: case 0b010001: case 0b011000: case 0b011100: case 0b011110: return false;
+  default: return true;
+  }
+}
+
+//Funcion que hace alcanzable una direccion (y con ella todo su bloque)
+static void marcar(RECORRIDO *r, int seccion, int direccion) {
+  int bloque, i;
+  BLOQUE_ETIQUETA *b;
+
+  if (direccion < 0 || direccion >= r->tam[seccion]) return;
+  bloque = r->bloque_de[seccion][direccion];
+  if (bloque < 0) {
+    visitar(r, seccion, direccion);
+    return;
+  }
+  if (r->vivo[bloque]) return;
+
+  r->vivo[bloque] = true;
+  b = &r->ctx->info_recoleccion.bloques[bloque];
+  for (i=b->inicio; i<b->fin && i<r->tam[seccion]; i++) visitar(r, seccion, i);
+}
+
+//Funcion que agrega una direccion ocupada a las que faltan recorrer (si no se agrego antes)
+static void visitar(RECORRIDO *r, int seccion, int direccion) {
+  if (r->visitada[seccion][direccion] || !localidad_ocupada(r->ctx, seccion, direccion)) return;
+  r->visitada[seccion][direccion] = true;
+  r->pendientes[r->num_pendientes++] = seccion << 16 | direccion;
+}
+
+//Funcion que recorre una direccion alcanzable: marca las direcciones que usa como valor y, si es
+//una instruccion, la siguiente que se ejecuta y el destino de sus saltos
+static void recorrer(RECORRIDO *r, int seccion, int direccion) {
+  INFO_RECOLECCION *info = &r->ctx->info_recoleccion;
+  REFERENCIA_DIR clave, *referencia, *fin;
+  uint32_t instr;
+  int tam_prg = r->tam[TS_PROG];
+
+  //Las referencias estan ordenadas por su origen: se busca la primera de esta direccion
+  clave.seccion_origen = seccion;
+  clave.origen = direccion;
+  referencia = info->referencias;
+  fin = info->referencias + info->num_referencias;
+  while (referencia < fin) {            //Busqueda binaria del limite inferior
+    REFERENCIA_DIR *medio = referencia + (fin - referencia) / 2;
+    if (comparar_referencias(medio, &clave) < 0) referencia = medio + 1;
+    else fin = medio;
+  }
+  for (fin = info->referencias + info->num_referencias;
+       referencia < fin && !comparar_referencias(referencia, &clave); referencia++)
+    marcar(r, referencia->seccion_destino, referencia->destino);
+
+  if (seccion != TS_PROG) return;
+  instr = leer_dato_prg(&r->ctx->imagen, direccion);
+  if (ES_SALTO_DIRECTO(instr))
+    marcar(r, TS_PROG, (direccion + (int16_t) instr) & (tam_prg - 1));
+  if (continua_en_siguiente(instr))
+    marcar(r, TS_PROG, (direccion + 1) & (tam_prg - 1));
+}
+
+//Funcion que compara dos referencias por su origen (para ordenarlas con qsort)
+static int comparar_referencias(const void *a, const void *b) {
+  const REFERENCIA_DIR *ra = a, *rb = b;
+
+  if (ra->seccion_origen != rb->seccion_origen) return ra->seccion_origen - rb->seccion_origen;
+  return ra->origen - rb->origen;
+}
+
+//Funcion que compara dos nombres de etiqueta (para ordenarlos y buscarlos)
+static int comparar_nombres(const void *a, const void *b) {
+  return strcmp(*(char * const *) a, *(char * const *) b);
+}
+
+//Funcion que obtiene la menor capacidad valida (potencia de 2 desde la minima) donde cabe una
+//cantidad de instrucciones o palabras
+static int capacidad_minima(int cantidad, int minima) {
+  while (minima < cantidad) minima *= 2;
+  return minima;
+}
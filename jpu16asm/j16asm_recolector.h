@@ -0,0 +1,79 @@
+#ifndef j16asm_recolector_h_Incluida
+#define j16asm_recolector_h_Incluida
+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include "j16asm_dat_struct.h"          //Incluye la definicion de los simbolos y valores
+
+//Tipos de datos exportados
+//-------------------------
+//Bloque de codigo o datos: lo que sigue a una etiqueta hasta la siguiente etiqueta de la misma
+//seccion (o hasta una directiva code o data con direccion)
+typedef struct _BLOQUE_ETIQUETA {
+  SIMBOLO *etiqueta;                    //Etiqueta que inicia el bloque
+  int seccion;                          //Seccion del bloque (TIPO_SECCION)
+  int inicio;                           //Primera direccion del bloque
+  int fin;                              //Direccion siguiente a la ultima (-1 si sigue abierto)
+} BLOQUE_ETIQUETA;
+
+//Uso de una direccion de programa o RAM como valor dentro de una instruccion o dato
+typedef struct _REFERENCIA_DIR {
+  int seccion_origen;                   //Seccion donde aparece el valor (TIPO_SECCION)
+  int origen;                           //Direccion donde aparece el valor
+  int seccion_destino;                  //Seccion a la que apunta el valor (TIPO_SECCION)
+  int destino;                          //Direccion a la que apunta el valor
+} REFERENCIA_DIR;
+
+//Estructura con lo que el ensamblado recoge para la recoleccion, y las etiquetas de los bloques
+//que se descartan al volver a ensamblar
+typedef struct _INFO_RECOLECCION {
+  bool registrar;                       //El ensamblado registra bloques y referencias
+  BLOQUE_ETIQUETA *bloques;             //Bloques en el orden del codigo fuente
+  int num_bloques;                      //Cantidad de bloques
+  int capacidad_bloques;                //Cantidad de bloques que caben en el arreglo actual
+  int bloque_abierto[2];                //Bloque actual de cada seccion (-1 si no hay)
+  REFERENCIA_DIR *referencias;          //Usos de direcciones como valor
+  int num_referencias;                  //Cantidad de referencias
+  int capacidad_referencias;            //Cantidad de referencias que caben en el arreglo actual
+  VALOR_EXP *pendientes;                //Direcciones usadas en el dato actual (sin ubicar aun)
+  int num_pendientes;                   //Cantidad de direcciones pendientes
+  int capacidad_pendientes;             //Cantidad de pendientes que caben en el arreglo actual
+  char **descartadas;                   //Etiquetas de los bloques a descartar (ordenadas)
+  int num_descartadas;                  //Cantidad de etiquetas a descartar
+  bool descartando[2];                  //Indica si se descarta lo que sigue en cada seccion
+  int marca_acciones;                   //Acciones encoladas al comenzar la linea actual
+} INFO_RECOLECCION;
+
+//Estadisticas de una recoleccion
+typedef struct _ESTADISTICAS_RECOLECCION {
+  int bloques_prg;                      //Rutinas eliminadas
+  int instrucciones;                    //Instrucciones eliminadas
+  int bloques_ram;                      //Bloques de datos eliminados
+  int palabras;                         //Palabras de RAM eliminadas
+  int tam_prg_minimo;                   //Menor capacidad de programa donde cabe lo que queda
+  int tam_ram_minimo;                   //Menor capacidad de RAM donde cabe lo que queda
+} ESTADISTICAS_RECOLECCION;
+
+//Declaracion previa del contexto de ensamblado (definido en j16asm.h)
+struct _CONTEXTO_ASM;
+
+//Funciones exportadas
+//--------------------
+//Funciones que usa el ensamblado para recoger la informacion y descartar los bloques
+extern void iniciar_bloque(struct _CONTEXTO_ASM *ctx, SIMBOLO *etiqueta);
+extern void cerrar_bloque(struct _CONTEXTO_ASM *ctx, int seccion);
+extern void registrar_uso_direccion(struct _CONTEXTO_ASM *ctx, VALOR_EXP valor);
+extern void ubicar_usos_direccion(struct _CONTEXTO_ASM *ctx, int seccion, int direccion,
+                                  bool es_salto);
+extern bool descartar_dato(struct _CONTEXTO_ASM *ctx);
+extern void terminar_linea_recoleccion(struct _CONTEXTO_ASM *ctx);
+extern void reiniciar_info_recoleccion(INFO_RECOLECCION *info);
+extern void desalojar_info_recoleccion(INFO_RECOLECCION *info);
+
+//Funcion que elimina el codigo y los datos inalcanzables volviendo a ensamblar el archivo
+extern bool recolectar_basura(struct _CONTEXTO_ASM *ctx, const char *nombre_archivo,
+                              ESTADISTICAS_RECOLECCION *estadisticas);
+
+//Funcion que indica si una etiqueta inicia un bloque que la recoleccion elimino
+extern bool etiqueta_descartada(struct _CONTEXTO_ASM *ctx, const char *nombre);
+
+#endif //j16asm_recolector_h_Incluida
@@ -0,0 +1,349 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_salida.c                                                                               |
+//| Modulo de la etapa de generacion de archivos de salida                                        |
+//|                                                                                               |
+//| Este modulo coordina la generacion de todos los archivos de salida solicitados. En vez de que |
+//| cada formato recorra la imagen de memoria por su cuenta, la misma se recorre una unica vez,   |
+//| bloque por bloque (en bloques del tamaño de un RAMB16), y cada bloque se entrega a todos los  |
+//| formatos activos. Cada formato se describe mediante una estructura FORMATO_SALIDA con las     |
+//| funciones que generan cada etapa del archivo (ver j16asm_salida.h).                           |
+//| El texto de cada archivo se arma en un buffer de gran tamaño mediante funciones de formato    |
+//| especializadas (los numeros hexadecimales y binarios se convierten por medio de tablas), y    |
+//| solo se escribe al archivo cuando el buffer se llena o al terminar, de manera que cada        |
+//| archivo se escribe con muy pocas llamadas al sistema.                                         |
+//| Si el contexto pide conservar las salidas (modo de vigilancia), cada archivo se escribe en un |
+//| archivo temporal que solo reemplaza al original si su contenido es distinto; asi un archivo   |
+//| que no cambio conserva su fecha y make no rehace lo que depende de el.                        |
+//+-----------------------------------------------------------------------------------------------+
+#include <pthread.h>                    //Permite inicializar las tablas una unica vez
+#include <stdarg.h>                     //Permite manejar listas variables de argumentos
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+#include <stdio.h>                      //Permite manejar archivos
+#include <stdlib.h>                     //Permite invocar malloc y free
+#include <string.h>                     //Permite manejar cadenas
+#include <sys/stat.h>                   //Permite consultar el tamaño de un archivo
+#include "j16asm_salida.h"              //Cabecera propia
+#include "j16asm.h"                     //Importa el contexto de ensamblado
+#include "j16asm_imagen_mem.h"          //Importa la imagen con los datos de memoria
+#include "j16asm_arena.h"               //Permite contar los alojamientos de memoria (-stats)
+#include "j16asm_estadisticas.h"        //Permite medir cada formato de salida (-stats)
+#include "j16asm_messages.h"            //Permite generar mensajes de error
+
+//Tablas de conversion
+static const char digitos_hex[] = "0123456789ABCDEF";  //Digito hexadecimal de cada nibble
+static char pares_hex[256][2];                          //Par de digitos hexadecimales de cada byte
+static char nibbles_bin[16][4];                         //Digitos binarios de cada nibble
+static pthread_once_t tablas_listas = PTHREAD_ONCE_INIT;  //Control de inicializacion de las tablas
+
+//Declaracion previa de las funciones locales al modulo
+static void inicializar_tablas(void);
+static bool abrir_salida(ARCHIVO_SALIDA *salida, const char *nombre, bool temporal);
+static bool cerrar_salida(ARCHIVO_SALIDA *salida);
+static void descartar_salida(ARCHIVO_SALIDA *salida);
+static bool contenido_igual(const char *nombre_1, const char *nombre_2, unsigned long long tam);
+static void vaciar_buffer(ARCHIVO_SALIDA *salida);
+static char *reservar(ARCHIVO_SALIDA *salida, size_t cantidad);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion para generar todos los archivos de salida recorriendo la imagen de memoria una vez
+bool generar_salidas(CONTEXTO_ASM *ctx, const FORMATO_SALIDA *formatos[], const char *nombres[],
+                     int cantidad) {
+  return generar_salidas_bloques(ctx, formatos, nombres, cantidad, NULL, NULL);
+}
+
+//Funcion para generar los archivos de salida con solo algunos bloques de cada memoria (los que
+//indican los arreglos de seleccion; un arreglo NULL selecciona todos los bloques de su memoria)
+bool generar_salidas_bloques(CONTEXTO_ASM *ctx, const FORMATO_SALIDA *formatos[],
+                             const char *nombres[], int cantidad, const bool *bloques_prg,
+                             const bool *bloques_ram) {
+  ARCHIVO_SALIDA salidas[cantidad];
+  uint32_t datos_prg[TAM_BLOQUE_PRG];
+  uint16_t datos_ram[TAM_BLOQUE_RAM];
+  uint64_t ocupacion[TAM_BLOQUE_RAM / 64];
+  MARCA_MEDICION marca;                 //Inicio de lo que se mide de cada formato (-stats)
+  bool exito = true;
+  int i, j;
+
+  //Las tablas se llenan una unica vez aunque se generen salidas desde varios hilos a la vez
+  pthread_once(&tablas_listas, inicializar_tablas);
+
+  //Primeramente se crean todos los archivos de salida (con -stats, cada formato se mide por
+  //separado aunque todos se generen en la misma pasada; la lectura de la imagen no se cuenta)
+  tomar_marca(ctx, &marca);
+  for (i=0; i<cantidad; i++) {
+    if (!abrir_salida(&salidas[i], nombres[i], ctx->conservar_salidas)) {
+      //Si alguno no se puede crear, elimina los que ya fueron creados y regresa con error
+      msg_error_crear_archivo_salida(ctx, nombres[i]);
+      while (i--) descartar_salida(&salidas[i]);
+      return false;
+    }
+    salidas[i].tam_prg = ctx->tam_prg;  //Los formatos toman las dimensiones de la memoria de aqui
+    salidas[i].tam_ram = ctx->tam_ram;
+    medir_salida(ctx, i, &marca);
+  }
+
+  //Se genera el inicio de todos los archivos
+  for (j=0; j<cantidad; j++) {
+    if (formatos[j]->inicio) formatos[j]->inicio(&salidas[j]);
+    medir_salida(ctx, j, &marca);
+  }
+
+  //Se recorre la memoria de programa bloque por bloque, entregando cada uno a todos los formatos
+  for (i=0; i<ctx->tam_prg/TAM_BLOQUE_PRG; i++) {
+    if (bloques_prg && !bloques_prg[i]) continue;
+    leer_bloque_prg(&ctx->imagen, i*TAM_BLOQUE_PRG, TAM_BLOQUE_PRG, datos_prg, ocupacion);
+    tomar_marca(ctx, &marca);
+    for (j=0; j<cantidad; j++) {
+      if (formatos[j]->bloque_prg) formatos[j]->bloque_prg(&salidas[j], i, datos_prg, ocupacion);
+      medir_salida(ctx, j, &marca);
+    }
+  }
+
+  //Se genera la parte intermedia de todos los archivos
+  for (j=0; j<cantidad; j++) {
+    if (formatos[j]->medio) formatos[j]->medio(&salidas[j]);
+    medir_salida(ctx, j, &marca);
+  }
+
+  //Se recorre la memoria RAM de la misma forma
+  for (i=0; i<ctx->tam_ram/TAM_BLOQUE_RAM; i++) {
+    if (bloques_ram && !bloques_ram[i]) continue;
+    leer_bloque_ram(&ctx->imagen, i*TAM_BLOQUE_RAM, TAM_BLOQUE_RAM, datos_ram, ocupacion);
+    tomar_marca(ctx, &marca);
+    for (j=0; j<cantidad; j++) {
+      if (formatos[j]->bloque_ram) formatos[j]->bloque_ram(&salidas[j], i, datos_ram, ocupacion);
+      medir_salida(ctx, j, &marca);
+    }
+  }
+
+  //Finalmente se genera el final de todos los archivos y se cierran (contando los que cambiaron)
+  ctx->salidas_reemplazadas = 0;
+  for (j=0; j<cantidad; j++) {
+    if (formatos[j]->final) formatos[j]->final(&salidas[j]);
+    if (!cerrar_salida(&salidas[j])) {
+      msg_error_escribir_archivo_salida(ctx, nombres[j]);
+      exito = false;
+    }
+    if (salidas[j].reemplazado) ctx->salidas_reemplazadas++;
+    medir_salida(ctx, j, &marca);
+  }
+
+  //Con -stats se registra ademas cuanto se escribio en cada archivo
+  if (ctx->estadisticas) {
+    ctx->estadisticas->num_salidas = cantidad;
+    for (j=0; j<cantidad; j++) {
+      ctx->estadisticas->nombres_salidas[j] = nombres[j];
+      ctx->estadisticas->bytes_salidas[j] = salidas[j].escritos;
+    }
+  }
+
+  return exito;
+}
+
+//Funcion para llenar las tablas de conversion de numeros a texto
+static void inicializar_tablas(void) {
+  int i, j;
+
+  for (i=0; i<256; i++) {
+    pares_hex[i][0] = digitos_hex[i >> 4];
+    pares_hex[i][1] = digitos_hex[i & 0xF];
+  }
+
+  for (i=0; i<16; i++)
+    for (j=0; j<4; j++)
+      nibbles_bin[i][j] = '0' + (i >> (3-j) & 1);
+}
+
+//Funcion para crear un archivo de salida y alojar su buffer (si se pide un temporal, el texto se
+//escribe en nombre.tmp y el archivo solo se reemplaza al cerrarlo si cambio)
+static bool abrir_salida(ARCHIVO_SALIDA *salida, const char *nombre, bool temporal) {
+  salida->nombre = nombre;
+  salida->nombre_temporal = NULL;
+  if (temporal) {
+    salida->nombre_temporal = malloc(strlen(nombre) + 5);
+    contar_alojamiento(strlen(nombre) + 5);
+    sprintf(salida->nombre_temporal, "%s.tmp", nombre);
+  }
+  salida->fp = fopen(temporal ? salida->nombre_temporal : nombre, "w");
+  if (!salida->fp) {
+    free(salida->nombre_temporal);
+    return false;
+  }
+
+  //El archivo se deja sin buffer propio de stdio, ya que el texto se acumula en el buffer de
+  //salida y se escribe en porciones grandes
+  setvbuf(salida->fp, NULL, _IONBF, 0);
+  salida->buffer = malloc(TAM_BUFFER_SAL);
+  contar_alojamiento(TAM_BUFFER_SAL);
+  salida->usado = 0;
+  salida->escritos = 0;
+  salida->error = false;
+  salida->reemplazado = false;
+  return true;
+}
+
+//Funcion para escribir el contenido pendiente del buffer y cerrar un archivo de salida. Si se
+//escribio un temporal, este reemplaza al archivo solo si su contenido es distinto
+static bool cerrar_salida(ARCHIVO_SALIDA *salida) {
+  vaciar_buffer(salida);
+  if (fclose(salida->fp)) salida->error = true;
+  free(salida->buffer);
+
+  if (!salida->nombre_temporal) salida->reemplazado = !salida->error;
+  else {
+    if (salida->error ||
+        contenido_igual(salida->nombre_temporal, salida->nombre, salida->escritos))
+      remove(salida->nombre_temporal);
+    else if (rename(salida->nombre_temporal, salida->nombre)) {
+      remove(salida->nombre_temporal);
+      salida->error = true;
+    }
+    else salida->reemplazado = true;
+    free(salida->nombre_temporal);
+  }
+  return !salida->error;
+}
+
+//Funcion para cerrar y eliminar un archivo de salida incompleto
+static void descartar_salida(ARCHIVO_SALIDA *salida) {
+  fclose(salida->fp);
+  free(salida->buffer);
+  remove(salida->nombre_temporal ? salida->nombre_temporal : salida->nombre);
+  free(salida->nombre_temporal);
+}
+
+//Funcion para determinar si dos archivos tienen el mismo contenido (tam es el tamaño del primero;
+//si el segundo no existe o tiene otro tamaño ni siquiera se leen)
+static bool contenido_igual(const char *nombre_1, const char *nombre_2, unsigned long long tam) {
+  struct stat info;
+  FILE *fp_1, *fp_2;
+  char *datos_1, *datos_2;
+  size_t leidos;
+  bool iguales = true;
+
+  if (stat(nombre_2, &info) || (unsigned long long) info.st_size != tam) return false;
+  fp_1 = fopen(nombre_1, "r");
+  fp_2 = fopen(nombre_2, "r");
+  datos_1 = malloc(2 * TAM_BUFFER_SAL);
+  contar_alojamiento(2 * TAM_BUFFER_SAL);
+  datos_2 = datos_1 + TAM_BUFFER_SAL;
+
+  //Compara ambos archivos porcion por porcion hasta encontrar una diferencia
+  if (!fp_1 || !fp_2) iguales = false;
+  while (iguales && (leidos = fread(datos_1, 1, TAM_BUFFER_SAL, fp_1)) > 0)
+    iguales = fread(datos_2, 1, leidos, fp_2) == leidos && !memcmp(datos_1, datos_2, leidos);
+
+  if (fp_1) fclose(fp_1);
+  if (fp_2) fclose(fp_2);
+  free(datos_1);
+  return iguales;
+}
+
+//Funcion para escribir al archivo todo el contenido del buffer
+static void vaciar_buffer(ARCHIVO_SALIDA *salida) {
+  if (salida->usado && fwrite(salida->buffer, 1, salida->usado, salida->fp) != salida->usado)
+    salida->error = true;
+  salida->escritos += salida->usado;
+  salida->usado = 0;
+}
+
+//Funcion para reservar espacio al final del buffer (vacia el buffer si no hay espacio suficiente)
+static char *reservar(ARCHIVO_SALIDA *salida, size_t cantidad) {
+  char *p;
+
+  if (salida->usado + cantidad > TAM_BUFFER_SAL) vaciar_buffer(salida);
+  p = salida->buffer + salida->usado;
+  salida->usado += cantidad;
+  return p;
+}
+
+//+--------------------------------------------------+
+//| Funciones de formato para los archivos de salida |
+//+--------------------------------------------------+---------------------------------------------
+//Funcion para agregar una cadena de texto
+void salida_cadena(ARCHIVO_SALIDA *salida, const char *cadena) {
+  size_t longitud = strlen(cadena);
+
+  //Las cadenas mas grandes que el buffer completo se escriben directamente al archivo
+  if (longitud > TAM_BUFFER_SAL) {
+    vaciar_buffer(salida);
+    if (fwrite(cadena, 1, longitud, salida->fp) != longitud) salida->error = true;
+    return;
+  }
+
+  memcpy(reservar(salida, longitud), cadena, longitud);
+}
+
+//Funcion para agregar texto con formato (al estilo de printf, util para las plantillas)
+void salida_formato(ARCHIVO_SALIDA *salida, const char *formato, ...) {
+  va_list argumentos;
+  size_t disponible;
+  int longitud;
+
+  //Intenta dar formato directamente en el espacio libre del buffer
+  disponible = TAM_BUFFER_SAL - salida->usado;
+  va_start(argumentos, formato);
+  longitud = vsnprintf(salida->buffer + salida->usado, disponible, formato, argumentos);
+  va_end(argumentos);
+
+  //Si el texto no cupo, vacia el buffer y lo vuelve a generar desde el inicio del mismo
+  if ((size_t) longitud >= disponible) {
+    vaciar_buffer(salida);
+    va_start(argumentos, formato);
+    longitud = vsnprintf(salida->buffer, TAM_BUFFER_SAL, formato, argumentos);
+    va_end(argumentos);
+  }
+
+  salida->usado += longitud;
+}
+
+//Funcion para agregar un numero en hexadecimal con la cantidad de digitos indicada
+void salida_hex(ARCHIVO_SALIDA *salida, uint32_t valor, int digitos) {
+  char *p = reservar(salida, digitos);
+
+  //Si la cantidad de digitos es impar, el primero se obtiene de la tabla de nibbles
+  if (digitos & 1)
+    *p++ = digitos_hex[valor >> (--digitos * 4) & 0xF];
+
+  //Los demas digitos se obtienen de dos en dos de la tabla de bytes
+  while (digitos) {
+    digitos -= 2;
+    memcpy(p, pares_hex[valor >> (digitos * 4) & 0xFF], 2);
+    p += 2;
+  }
+}
+
+//Funcion para agregar los bits menos significativos de un numero en binario
+void salida_binario(ARCHIVO_SALIDA *salida, uint32_t valor, int bits) {
+  char *p = reservar(salida, bits);
+
+  //Los bits que no completan un nibble se generan de forma individual
+  while (bits & 3)
+    *p++ = '0' + (valor >> --bits & 1);
+
+  //Los demas se obtienen de 4 en 4 de la tabla de nibbles
+  while (bits) {
+    bits -= 4;
+    memcpy(p, nibbles_bin[valor >> bits & 0xF], 4);
+    p += 4;
+  }
+}
+
+//Funcion para agregar un numero en decimal
+void salida_decimal(ARCHIVO_SALIDA *salida, int valor) {
+  char digitos[12];
+  int i = sizeof(digitos);
+  unsigned int magnitud = valor < 0 ? -(unsigned int) valor : (unsigned int) valor;
+
+  //Genera los digitos de derecha a izquierda
+  do {
+    digitos[--i] = '0' + magnitud % 10;
+    magnitud /= 10;
+  } while (magnitud);
+  if (valor < 0) digitos[--i] = '-';
+
+  memcpy(reservar(salida, sizeof(digitos) - i), &digitos[i], sizeof(digitos) - i);
+}
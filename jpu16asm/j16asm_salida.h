@@ -0,0 +1,67 @@
+#ifndef j16asm_salida_h_Incluida
+#define j16asm_salida_h_Incluida
+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+#include <stdio.h>                      //Incluye la definicion del tipo de dato FILE
+#include "j16asm.h"                     //Incluye la definicion del contexto de ensamblado
+
+//Constantes exportadas
+//---------------------
+#define TAM_BLOQUE_PRG   512            //Instrucciones por bloque de memoria (RAMB16) de programa
+#define TAM_BLOQUE_RAM   1024           //Palabras por bloque de memoria (RAMB16) de RAM
+#define TAM_BUFFER_SAL   262144         //Tamaño del buffer de cada archivo de salida
+
+//Tipos de datos exportados
+//-------------------------
+//Estructura que describe un archivo de salida con su buffer de escritura
+typedef struct _ARCHIVO_SALIDA {
+  const char *nombre;                   //Nombre del archivo (util para reportar errores)
+  char *nombre_temporal;                //Archivo que se escribe en su lugar (NULL si es el mismo)
+  FILE *fp;                             //Handle del archivo abierto
+  char *buffer;                         //Buffer donde se da formato al texto antes de escribirlo
+  size_t usado;                         //Cantidad de bytes ocupados del buffer
+  unsigned long long escritos;          //Cantidad de bytes escritos en el archivo
+  bool error;                           //Indica si hubo un error al escribir el archivo
+  bool reemplazado;                     //Indica si se reemplazo el contenido anterior del archivo
+  int tam_prg;                          //Capacidad de la memoria de programa (instrucciones)
+  int tam_ram;                          //Capacidad de la memoria RAM (palabras)
+} ARCHIVO_SALIDA;
+
+//Estructura que describe un formato de salida mediante las funciones que generan cada una de sus
+//etapas (cualquiera de ellas puede ser NULL si el formato no genera nada en dicha etapa)
+typedef struct _FORMATO_SALIDA {
+  //Genera el inicio del archivo (antes de los datos de la memoria de programa)
+  void (*inicio)(ARCHIVO_SALIDA *salida);
+  //Genera los datos de un bloque de la memoria de programa
+  void (*bloque_prg)(ARCHIVO_SALIDA *salida, int indice,
+                     const uint32_t *datos, const uint64_t *ocupacion);
+  //Genera la parte intermedia del archivo (entre la memoria de programa y la RAM)
+  void (*medio)(ARCHIVO_SALIDA *salida);
+  //Genera los datos de un bloque de la memoria RAM
+  void (*bloque_ram)(ARCHIVO_SALIDA *salida, int indice,
+                     const uint16_t *datos, const uint64_t *ocupacion);
+  //Genera el final del archivo
+  void (*final)(ARCHIVO_SALIDA *salida);
+} FORMATO_SALIDA;
+
+//Funciones exportadas
+//--------------------
+//Funcion para generar todos los archivos de salida recorriendo la imagen de memoria una vez
+extern bool generar_salidas(CONTEXTO_ASM *ctx, const FORMATO_SALIDA *formatos[],
+                            const char *nombres[], int cantidad);
+extern bool generar_salidas_bloques(CONTEXTO_ASM *ctx, const FORMATO_SALIDA *formatos[],
+                                    const char *nombres[], int cantidad,
+                                    const bool *bloques_prg, const bool *bloques_ram);
+
+//Funciones para dar formato al texto de los archivos de salida
+extern void salida_cadena(ARCHIVO_SALIDA *salida, const char *cadena);
+extern void salida_formato(ARCHIVO_SALIDA *salida, const char *formato, ...);
+extern void salida_hex(ARCHIVO_SALIDA *salida, uint32_t valor, int digitos);
+extern void salida_binario(ARCHIVO_SALIDA *salida, uint32_t valor, int bits);
+extern void salida_decimal(ARCHIVO_SALIDA *salida, int valor);
+
+//Funcion para determinar si una localidad esta marcada en un mapa de ocupacion
+#define LOCALIDAD_OCUPADA(ocupacion, i) ((ocupacion)[(i) >> 6] >> ((i) & 63) & 1)
+
+#endif //j16asm_salida_h_Incluida
@@ -0,0 +1,597 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_tablas.c                                                                               |
+//| Modulo de generacion de tablas de datos                                                       |
+//|                                                                                               |
+//| Este modulo genera al ensamblar el contenido de las directivas que llenan bloques de RAM con  |
+//| varios datos a la vez:                                                                        |
+//|   table cantidad, expresion     genera cantidad datos evaluando la expresion para cada indice |
+//|   incbin "archivo"              incluye un archivo binario (2 bytes por dato, el alto antes)  |
+//|   inchex "archivo"              incluye un archivo de texto con datos en hexadecimal          |
+//| Las tablas sirven sobre todo para funciones trascendentes (seno, logaritmo, curvas de la      |
+//| unidad PWM, etc.), las cuales el programa lee de la RAM en vez de calcularlas.                |
+//| La expresion de una tabla se compila una sola vez a una secuencia de operaciones en notacion  |
+//| polaca inversa, la cual luego se evalua para cada indice sin volver a analizar el texto. Se   |
+//| evalua en punto flotante (la division no trunca) y cada resultado se redondea al entero mas   |
+//| cercano, el cual debe caber en 16 bits (con o sin signo). Ademas de los operadores del        |
+//| ensamblador se pueden usar los nombres i (el indice, desde 0 hasta cantidad - 1), n (la       |
+//| cantidad), pi y las funciones de la tabla de funciones (sin, log, sqrt, etc.), los cuales     |
+//| tienen prioridad sobre los simbolos del programa. Los simbolos deben estar definidos antes de |
+//| la directiva, y en modo objeto solo se admiten constantes (la tabla no se puede reubicar al   |
+//| enlazar).                                                                                     |
+//| En los archivos hexadecimales los datos se separan con espacios, comas o fines de linea,      |
+//| pueden llevar el prefijo 0x y el resto de una linea despues de ; o # es un comentario.        |
+//+-----------------------------------------------------------------------------------------------+
+#include <ctype.h>                      //Permite clasificar caracteres
+#include <limits.h>                     //Incluye la longitud maxima de una ruta
+#include <math.h>                       //Incluye las funciones matematicas de las tablas
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdio.h>                      //Permite manejar archivos
+#include <stdlib.h>                     //Permite invocar malloc, strtod y free
+#include <string.h>                     //Permite manejar cadenas
+#include "j16asm_tablas.h"              //Cabecera propia
+#include "j16asm.h"                     //Importa el contexto de ensamblado
+#include "j16asm_arena.h"               //Permite contar la memoria alojada
+#include "j16asm_dat_struct.h"          //Permite buscar los simbolos de las expresiones
+#include "j16asm_fuentes.h"             //Permite abrir y registrar los archivos de datos
+#include "j16asm_imagen_mem.h"          //Incluye el tamaño de los espacios de memoria
+#include "j16asm_messages.h"            //Permite enviar mensajes al usuario
+#include "j16asm_recolector.h"          //Permite registrar las direcciones usadas (-gc)
+
+//Constantes locales
+#define MAX_ELEMENTOS_TABLA 256         //Cantidad maxima de elementos de una expresion compilada
+#define TAM_DETALLE         128         //Tamaño de la descripcion de un error
+#define TAM_NOMBRE          64          //Longitud maxima de los nombres de una expresion
+#define TAM_VALOR_HEX       16          //Longitud maxima de un dato de un archivo hexadecimal
+
+//Tipos de elementos de una expresion compilada
+typedef enum _CODIGO_ELEMENTO {
+  EL_CONSTANTE,                         //Apila un valor constante
+  EL_INDICE,                            //Apila el indice actual
+  EL_CANTIDAD,                          //Apila la cantidad de datos de la tabla
+  EL_OR, EL_XOR, EL_AND, EL_SHL, EL_SHR, EL_MOD, EL_NOT,  //Operaciones enteras
+  EL_SUM, EL_RES, EL_MUL, EL_DIV, EL_NEG, EL_EXP,         //Operaciones en punto flotante
+  EL_FUNCION_1,                         //Funcion de un argumento
+  EL_FUNCION_2                          //Funcion de dos argumentos
+} CODIGO_ELEMENTO;
+
+//Estructura con un elemento de una expresion compilada
+typedef struct _ELEMENTO {
+  CODIGO_ELEMENTO codigo;               //Operacion que realiza
+  double valor;                         //Valor de una constante
+  double (*funcion_1)(double);          //Funcion de un argumento
+  double (*funcion_2)(double, double);  //Funcion de dos argumentos
+} ELEMENTO;
+
+//Estructura con una expresion compilada (en notacion polaca inversa)
+typedef struct _EXPRESION_TABLA {
+  ELEMENTO elementos[MAX_ELEMENTOS_TABLA];  //Elementos en el orden en que se evaluan
+  int cantidad;                         //Cantidad de elementos
+  int profundidad;                      //Cantidad de valores que tendra la pila en el punto actual
+  int profundidad_maxima;               //Maxima cantidad de valores que alcanzara la pila
+} EXPRESION_TABLA;
+
+//Estructura con el estado del analisis de una expresion
+typedef struct _ANALISIS_TABLA {
+  CONTEXTO_ASM *ctx;                    //Contexto de ensamblado (para buscar los simbolos)
+  const char *texto;                    //Siguiente caracter a analizar
+  bool permitir_indice;                 //Indica si se admiten los nombres i y n
+  EXPRESION_TABLA *expresion;           //Expresion que se genera
+  char detalle[TAM_DETALLE];            //Descripcion del primer error (vacia si no hay)
+} ANALISIS_TABLA;
+
+//Estructura con un operador binario
+typedef struct _OPERADOR_TABLA {
+  const char *simbolo;                  //Texto del operador
+  CODIGO_ELEMENTO codigo;               //Operacion que genera
+  int nivel;                            //Nivel de precedencia (0 es la menor)
+} OPERADOR_TABLA;
+
+//Estructura con una funcion que se puede usar en las expresiones
+typedef struct _FUNCION_TABLA {
+  const char *nombre;                   //Nombre con el que se invoca
+  double (*funcion_1)(double);          //Funcion de un argumento (o NULL)
+  double (*funcion_2)(double, double);  //Funcion de dos argumentos (o NULL)
+} FUNCION_TABLA;
+
+//Operadores binarios con la misma precedencia que en la gramatica del ensamblador (** se analiza
+//aparte porque asocia de derecha a izquierda)
+static const OPERADOR_TABLA operadores[] = {
+  {"|", EL_OR, 0}, {"^", EL_XOR, 1}, {"&", EL_AND, 2}, {"<<", EL_SHL, 3}, {">>", EL_SHR, 3},
+  {"+", EL_SUM, 4}, {"-", EL_RES, 4}, {"*", EL_MUL, 5}, {"/", EL_DIV, 5}, {"%", EL_MOD, 5}
+};
+#define NUM_OPERADORES   (sizeof(operadores) / sizeof(operadores[0]))
+#define NIVELES_BINARIOS 6              //Cantidad de niveles de precedencia de los operadores
+
+//Funciones que se pueden usar en las expresiones
+static const FUNCION_TABLA funciones[] = {
+  {"sin", sin, NULL}, {"cos", cos, NULL}, {"tan", tan, NULL}, {"asin", asin, NULL},
+  {"acos", acos, NULL}, {"atan", atan, NULL}, {"sinh", sinh, NULL}, {"cosh", cosh, NULL},
+  {"tanh", tanh, NULL}, {"sqrt", sqrt, NULL}, {"exp", exp, NULL}, {"log", log, NULL},
+  {"log2", log2, NULL}, {"log10", log10, NULL}, {"abs", fabs, NULL}, {"floor", floor, NULL},
+  {"ceil", ceil, NULL}, {"round", round, NULL}, {"trunc", trunc, NULL},
+  {"min", NULL, fmin}, {"max", NULL, fmax}, {"atan2", NULL, atan2}, {"pow", NULL, pow}
+};
+#define NUM_FUNCIONES (sizeof(funciones) / sizeof(funciones[0]))
+
+//Declaracion previa de las funciones locales al modulo
+static bool leer_cantidad(ANALISIS_TABLA *analisis, EXPRESION_TABLA *expresion, int *cantidad);
+static int *generar_datos(ANALISIS_TABLA *analisis, EXPRESION_TABLA *expresion, int cantidad);
+static bool compilar_expresion(ANALISIS_TABLA *analisis, EXPRESION_TABLA *expresion,
+                               bool permitir_indice);
+static bool analizar_nivel(ANALISIS_TABLA *analisis, int nivel);
+static bool analizar_unario(ANALISIS_TABLA *analisis);
+static bool analizar_primario(ANALISIS_TABLA *analisis);
+static bool analizar_numero(ANALISIS_TABLA *analisis);
+static bool analizar_nombre(ANALISIS_TABLA *analisis);
+static bool analizar_simbolo(ANALISIS_TABLA *analisis, const char *nombre);
+static const OPERADOR_TABLA *buscar_operador(const char *texto, int nivel);
+static bool agregar_elemento(ANALISIS_TABLA *analisis, CODIGO_ELEMENTO codigo, double valor);
+static void saltar_espacios(ANALISIS_TABLA *analisis);
+static bool fallar(ANALISIS_TABLA *analisis, const char *detalle);
+static double evaluar_expresion(const EXPRESION_TABLA *expresion, double indice,
+                                double cantidad, double *pila);
+static double operar_entero(CODIGO_ELEMENTO codigo, double izquierda, double derecha);
+static bool leer_binario(FILE *fp_archivo, int *datos, int *cantidad, char *detalle);
+static bool leer_hexadecimal(FILE *fp_archivo, int *datos, int *cantidad, char *detalle);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion que genera los datos de la directiva table a partir del texto que la sigue (la cantidad
+//y la expresion separadas por una coma). Regresa NULL si hay errores
+int *calcular_tabla(CONTEXTO_ASM *ctx, const char *texto, int *cantidad) {
+  ANALISIS_TABLA analisis = { ctx, texto, false, NULL, "" };
+  EXPRESION_TABLA *expresion;
+  int *datos = NULL;
+
+  //La misma expresion compilada sirve primero para la cantidad y luego para los datos
+  expresion = malloc(sizeof(EXPRESION_TABLA));
+  contar_alojamiento(sizeof(EXPRESION_TABLA));
+  if (leer_cantidad(&analisis, expresion, cantidad))
+    datos = generar_datos(&analisis, expresion, *cantidad);
+
+  if (analisis.detalle[0]) msg_tabla_invalida(ctx, ctx->num_lin, analisis.detalle);
+  free(expresion);
+  return datos;
+}
+
+//Funcion que lee los datos de las directivas incbin (binario) e inchex (hexadecimal). El archivo
+//se registra como fuente para que el archivo de dependencias (-MD) y la vigilancia (-watch) lo
+//tomen en cuenta. Regresa NULL si hay errores
+int *leer_archivo_datos(CONTEXTO_ASM *ctx, const char *nombre, bool hexadecimal,
+                        int *cantidad) {
+  char ruta[PATH_MAX], detalle[TAM_DETALLE];
+  FILE *fp_archivo;
+  int *datos;
+  bool exito;
+
+  fp_archivo = abrir_fuente(ctx, nombre, hexadecimal ? "r" : "rb", ruta, sizeof(ruta));
+  if (!fp_archivo) {
+    msg_error_abrir_datos(ctx, ctx->num_lin, nombre);
+    return NULL;
+  }
+  registrar_fuente(&ctx->registro_fuentes, ruta);
+
+  //Ningun archivo puede tener mas datos que los que caben en la memoria
+  datos = malloc(TAM_ESPACIO_MEM * sizeof(int));
+  contar_alojamiento(TAM_ESPACIO_MEM * sizeof(int));
+  *cantidad = 0;
+  if (hexadecimal)
+    exito = leer_hexadecimal(fp_archivo, datos, cantidad, detalle);
+  else
+    exito = leer_binario(fp_archivo, datos, cantidad, detalle);
+  fclose(fp_archivo);
+
+  if (!exito) {
+    msg_archivo_datos_invalido(ctx, ctx->num_lin, nombre, detalle);
+    free(datos);
+    return NULL;
+  }
+  return datos;
+}
+
+//+--------------------------------+
+//| Compilacion de las expresiones |
+//+--------------------------------+---------------------------------------------------------------
+//Funcion que compila y evalua la cantidad de datos de una tabla (la cual no puede depender del
+//indice), dejando el analisis al inicio de la expresion de los datos
+static bool leer_cantidad(ANALISIS_TABLA *analisis, EXPRESION_TABLA *expresion, int *cantidad) {
+  double *pila, total;
+
+  if (!compilar_expresion(analisis, expresion, false)) return false;
+  if (*analisis->texto != ',')
+    return fallar(analisis, "se esperaba una coma despues de la cantidad");
+  analisis->texto++;
+
+  pila = malloc(expresion->profundidad_maxima * sizeof(double));
+  total = round(evaluar_expresion(expresion, 0, 0, pila));
+  free(pila);
+  if (!(total >= 0 && total <= TAM_ESPACIO_MEM)) {
+    snprintf(analisis->detalle, TAM_DETALLE, "cantidad de datos invalida: %g", total);
+    return false;
+  }
+  *cantidad = (int) total;
+  return true;
+}
+
+//Funcion que compila la expresion de los datos de una tabla y la evalua una vez por indice (con la
+//misma pila). Cada resultado se redondea y debe caber en 16 bits
+static int *generar_datos(ANALISIS_TABLA *analisis, EXPRESION_TABLA *expresion, int cantidad) {
+  double *pila, valor;
+  int *datos;
+  int i;
+
+  if (!compilar_expresion(analisis, expresion, true)) return NULL;
+  if (*analisis->texto) {
+    fallar(analisis, "sobra texto al final de la expresion");
+    return NULL;
+  }
+
+  datos = malloc((cantidad + 1) * sizeof(int));  //Una tabla vacia tambien regresa un arreglo
+  pila = malloc(expresion->profundidad_maxima * sizeof(double));
+  contar_alojamiento((cantidad + 1) * sizeof(int));
+  for (i=0; i<cantidad; i++) {
+    valor = round(evaluar_expresion(expresion, i, cantidad, pila));
+    if (!(valor >= -32768 && valor <= 65535)) {
+      if (isnan(valor))
+        snprintf(analisis->detalle, TAM_DETALLE, "el valor del indice %i no es un numero", i);
+      else
+        snprintf(analisis->detalle, TAM_DETALLE, "el valor del indice %i no cabe en 16 bits: %g",
+                 i, valor);
+      free(datos);
+      datos = NULL;
+      break;
+    }
+    datos[i] = (int) valor;
+  }
+  free(pila);
+  return datos;
+}
+
+//Funcion que compila una expresion hasta el primer caracter que no forma parte de ella (una coma o
+//el final del texto)
+static bool compilar_expresion(ANALISIS_TABLA *analisis, EXPRESION_TABLA *expresion,
+                               bool permitir_indice) {
+  analisis->expresion = expresion;
+  analisis->permitir_indice = permitir_indice;
+  expresion->cantidad = 0;
+  expresion->profundidad = 0;
+  expresion->profundidad_maxima = 0;
+
+  saltar_espacios(analisis);
+  if (!*analisis->texto) return fallar(analisis, "falta la expresion");
+  if (!analizar_nivel(analisis, 0)) return false;
+  if (*analisis->texto && *analisis->texto != ',')
+    return fallar(analisis, "caracter inesperado en la expresion");
+  return true;
+}
+
+//Funcion que analiza los operadores binarios de un nivel de precedencia (cada operando es una
+//expresion del nivel siguiente)
+static bool analizar_nivel(ANALISIS_TABLA *analisis, int nivel) {
+  const OPERADOR_TABLA *operador;
+
+  if (nivel == NIVELES_BINARIOS) return analizar_unario(analisis);
+  if (!analizar_nivel(analisis, nivel + 1)) return false;
+  while ((operador = buscar_operador(analisis->texto, nivel))) {
+    analisis->texto += strlen(operador->simbolo);
+    if (!analizar_nivel(analisis, nivel + 1)) return false;
+    if (!agregar_elemento(analisis, operador->codigo, 0)) return false;
+  }
+  return true;
+}
+
+//Funcion que analiza los operadores unarios y la exponenciacion (la cual tiene mayor precedencia
+//que el signo negativo y asocia de derecha a izquierda)
+static bool analizar_unario(ANALISIS_TABLA *analisis) {
+  char caracter;
+
+  saltar_espacios(analisis);
+  caracter = *analisis->texto;
+  if (caracter == '-' || caracter == '~' || caracter == '+') {
+    analisis->texto++;
+    if (!analizar_unario(analisis)) return false;
+    if (caracter == '+') return true;
+    return agregar_elemento(analisis, caracter == '-' ? EL_NEG : EL_NOT, 0);
+  }
+
+  if (!analizar_primario(analisis)) return false;
+  if (strncmp(analisis->texto, "**", 2) != 0) return true;
+  analisis->texto += 2;
+  if (!analizar_unario(analisis)) return false;
+  return agregar_elemento(analisis, EL_EXP, 0);
+}
+
+//Funcion que analiza un valor: un numero, un nombre, una funcion o una expresion entre parentesis
+static bool analizar_primario(ANALISIS_TABLA *analisis) {
+  const char *texto = analisis->texto;
+  bool exito;
+
+  if (*texto == '(') {
+    analisis->texto++;
+    if (!analizar_nivel(analisis, 0)) return false;
+    if (*analisis->texto != ')') return fallar(analisis, "falta un parentesis de cierre");
+    analisis->texto++;
+    exito = true;
+  } else if (texto[0] == '\'' && texto[1] && texto[2] == '\'') {
+    analisis->texto += 3;              //Un caracter vale su codigo ascii
+    exito = agregar_elemento(analisis, EL_CONSTANTE, (unsigned char) texto[1]);
+  } else if (isdigit((unsigned char) *texto) || *texto == '.')
+    exito = analizar_numero(analisis);
+  else if (isalpha((unsigned char) *texto) || *texto == '_')
+    exito = analizar_nombre(analisis);
+  else
+    return fallar(analisis, "se esperaba un valor");
+
+  saltar_espacios(analisis);
+  return exito;
+}
+
+//Funcion que analiza un numero con los mismos prefijos que el ensamblador (0b, 0o, 0d y 0x). Los
+//numeros decimales pueden tener parte fraccionaria y exponente (p. ej. 0.5 o 1e3)
+static bool analizar_numero(ANALISIS_TABLA *analisis) {
+  const char *texto = analisis->texto;
+  const char *prefijos = "bBoOdDxX";
+  const int bases[] = { 2, 2, 8, 8, 10, 10, 16, 16 };
+  const char *prefijo;
+  char *fin;
+  double valor;
+
+  prefijo = texto[0] == '0' && texto[1] ? strchr(prefijos, texto[1]) : NULL;
+  if (prefijo) {
+    valor = strtoul(&texto[2], &fin, bases[prefijo - prefijos]);
+    if (fin == &texto[2]) fin = (char *) texto;
+  } else
+    valor = strtod(texto, &fin);
+
+  if (fin == texto || isalnum((unsigned char) *fin) || *fin == '_' || *fin == '.')
+    return fallar(analisis, "numero invalido");
+  analisis->texto = fin;
+  return agregar_elemento(analisis, EL_CONSTANTE, valor);
+}
+
+//Funcion que analiza un nombre: el indice, la cantidad, pi, una funcion (seguida de sus
+//argumentos entre parentesis) o un simbolo del programa
+static bool analizar_nombre(ANALISIS_TABLA *analisis) {
+  char nombre[TAM_NOMBRE];
+  const FUNCION_TABLA *funcion = NULL;
+  int longitud = 0, argumentos = 0;
+  size_t i;
+
+  while (isalnum((unsigned char) analisis->texto[longitud]) || analisis->texto[longitud] == '_')
+    longitud++;
+  if (longitud >= TAM_NOMBRE) return fallar(analisis, "nombre demasiado largo");
+  memcpy(nombre, analisis->texto, longitud);
+  nombre[longitud] = '\0';
+  analisis->texto += longitud;
+  saltar_espacios(analisis);
+
+  //Los nombres propios de las tablas tienen prioridad sobre los simbolos
+  if (strcmp(nombre, "i") == 0 || strcmp(nombre, "n") == 0) {
+    if (!analisis->permitir_indice)
+      return fallar(analisis, "la cantidad no puede depender del indice");
+    return agregar_elemento(analisis, nombre[0] == 'i' ? EL_INDICE : EL_CANTIDAD, 0);
+  }
+  if (strcmp(nombre, "pi") == 0) return agregar_elemento(analisis, EL_CONSTANTE, M_PI);
+  if (*analisis->texto != '(') return analizar_simbolo(analisis, nombre);
+
+  //Una funcion recibe sus argumentos separados por comas
+  for (i=0; i<NUM_FUNCIONES && !funcion; i++)
+    if (strcmp(funciones[i].nombre, nombre) == 0) funcion = &funciones[i];
+  if (!funcion) {
+    snprintf(analisis->detalle, TAM_DETALLE, "funcion desconocida: %s", nombre);
+    return false;
+  }
+  do {
+    analisis->texto++;
+    if (!analizar_nivel(analisis, 0)) return false;
+    argumentos++;
+  } while (*analisis->texto == ',');
+  if (*analisis->texto != ')') return fallar(analisis, "falta un parentesis de cierre");
+  analisis->texto++;
+  if (argumentos != (funcion->funcion_1 ? 1 : 2)) {
+    snprintf(analisis->detalle, TAM_DETALLE, "la funcion %s recibe %i argumento(s)", nombre,
+             funcion->funcion_1 ? 1 : 2);
+    return false;
+  }
+
+  if (!agregar_elemento(analisis, funcion->funcion_1 ? EL_FUNCION_1 : EL_FUNCION_2, 0))
+    return false;
+  analisis->expresion->elementos[analisis->expresion->cantidad - 1].funcion_1 = funcion->funcion_1;
+  analisis->expresion->elementos[analisis->expresion->cantidad - 1].funcion_2 = funcion->funcion_2;
+  return true;
+}
+
+//Funcion que agrega el valor de un simbolo del programa, el cual debe estar definido. Igual que en
+//una expresion literal, se registra el uso de las direcciones para el optimizador y el recolector
+static bool analizar_simbolo(ANALISIS_TABLA *analisis, const char *nombre) {
+  CONTEXTO_ASM *ctx = analisis->ctx;
+  SIMBOLO *simbolo = buscar_simbolo(&ctx->lista_simbolos, (char *) nombre);
+  VALOR_EXP valor;
+
+  if (!simbolo || !simbolo->definido) {
+    snprintf(analisis->detalle, TAM_DETALLE, "simbolo no definido: %s", nombre);
+    return false;
+  }
+  if (ctx->modo_objeto && simbolo->reubicacion != REUB_NINGUNA) {
+    snprintf(analisis->detalle, TAM_DETALLE, "la direccion %s no se puede reubicar al enlazar",
+             nombre);
+    return false;
+  }
+
+  valor.valor = simbolo->valor;
+  valor.reub = simbolo->reubicacion;
+  if (valor.reub == REUB_PRG || valor.reub == REUB_INVALIDA)
+    ctx->info_optimizacion.usa_direccion_prg = true;
+  registrar_uso_direccion(ctx, valor);
+  return agregar_elemento(analisis, EL_CONSTANTE, simbolo->valor);
+}
+
+//Funcion que busca un operador binario de un nivel de precedencia al inicio del texto
+static const OPERADOR_TABLA *buscar_operador(const char *texto, int nivel) {
+  size_t i;
+
+  if (strncmp(texto, "**", 2) == 0) return NULL;  //La exponenciacion no es de ningun nivel
+  for (i=0; i<NUM_OPERADORES; i++)
+    if (operadores[i].nivel == nivel &&
+        strncmp(texto, operadores[i].simbolo, strlen(operadores[i].simbolo)) == 0)
+      return &operadores[i];
+  return NULL;
+}
+
+//Funcion que agrega un elemento a la expresion y lleva la cuenta de la profundidad de la pila
+static bool agregar_elemento(ANALISIS_TABLA *analisis, CODIGO_ELEMENTO codigo, double valor) {
+  EXPRESION_TABLA *expresion = analisis->expresion;
+  ELEMENTO *elemento;
+
+  if (expresion->cantidad == MAX_ELEMENTOS_TABLA)
+    return fallar(analisis, "expresion demasiado larga");
+  elemento = &expresion->elementos[expresion->cantidad++];
+  elemento->codigo = codigo;
+  elemento->valor = valor;
+  elemento->funcion_1 = NULL;
+  elemento->funcion_2 = NULL;
+
+  switch (codigo) {
+  case EL_CONSTANTE: case EL_INDICE: case EL_CANTIDAD:
+    expresion->profundidad++;         //Los valores se apilan
+    break;
+  case EL_NOT: case EL_NEG: case EL_FUNCION_1:
+    break;                            //Las operaciones unarias sustituyen el tope
+  default:
+    expresion->profundidad--;         //Las binarias sustituyen los dos valores del tope por uno
+    break;
+  }
+  if (expresion->profundidad > expresion->profundidad_maxima)
+    expresion->profundidad_maxima = expresion->profundidad;
+  return true;
+}
+
+//Funcion para avanzar hasta el siguiente caracter que no sea un espacio
+static void saltar_espacios(ANALISIS_TABLA *analisis) {
+  while (*analisis->texto == ' ' || *analisis->texto == '\t') analisis->texto++;
+}
+
+//Funcion que guarda la descripcion de un error (siempre regresa false)
+static bool fallar(ANALISIS_TABLA *analisis, const char *detalle) {
+  snprintf(analisis->detalle, TAM_DETALLE, "%s", detalle);
+  return false;
+}
+
+//+-------------------------------+
+//| Evaluacion de las expresiones |
+//+-------------------------------+----------------------------------------------------------------
+//Funcion que evalua una expresion compilada para un indice. La pila debe tener lugar para la
+//profundidad maxima de la expresion. Un resultado invalido (p. ej. la raiz de un negativo) es NaN
+static double evaluar_expresion(const EXPRESION_TABLA *expresion, double indice,
+                                double cantidad, double *pila) {
+  const ELEMENTO *elemento = expresion->elementos;
+  const ELEMENTO *fin = elemento + expresion->cantidad;
+  int tope = -1;
+
+  for (; elemento < fin; elemento++) {
+    switch (elemento->codigo) {
+    case EL_CONSTANTE: pila[++tope] = elemento->valor;                             break;
+    case EL_INDICE:    pila[++tope] = indice;                                      break;
+    case EL_CANTIDAD:  pila[++tope] = cantidad;                                    break;
+    case EL_SUM:       tope--; pila[tope] = pila[tope] + pila[tope + 1];           break;
+    case EL_RES:       tope--; pila[tope] = pila[tope] - pila[tope + 1];           break;
+    case EL_MUL:       tope--; pila[tope] = pila[tope] * pila[tope + 1];           break;
+    case EL_DIV:       tope--; pila[tope] = pila[tope] / pila[tope + 1];           break;
+    case EL_EXP:       tope--; pila[tope] = pow(pila[tope], pila[tope + 1]);       break;
+    case EL_NEG:       pila[tope] = -pila[tope];                                   break;
+    case EL_FUNCION_1: pila[tope] = elemento->funcion_1(pila[tope]);               break;
+    case EL_FUNCION_2: tope--; pila[tope] = elemento->funcion_2(pila[tope], pila[tope + 1]);
+                       break;
+    case EL_NOT:       pila[tope] = operar_entero(EL_NOT, pila[tope], 0);          break;
+    default:           tope--; pila[tope] = operar_entero(elemento->codigo, pila[tope],
+                                                          pila[tope + 1]);         break;
+    }
+  }
+  return pila[0];
+}
+
+//Funcion que aplica una operacion entera. Los operandos se redondean y deben caber en 32 bits
+static double operar_entero(CODIGO_ELEMENTO codigo, double izquierda, double derecha) {
+  long long a, b;
+
+  if (!(fabs(izquierda) < 2147483648.0 && fabs(derecha) < 2147483648.0)) return NAN;
+  a = llround(izquierda);
+  b = llround(derecha);
+  switch (codigo) {
+  case EL_OR:  return a | b;
+  case EL_XOR: return a ^ b;
+  case EL_AND: return a & b;
+  case EL_SHL: return b >= 0 && b < 32 ? ldexp(a, b) : NAN;
+  case EL_SHR: return b >= 0 && b < 32 ? a >> b : NAN;
+  case EL_MOD: return b ? a % b : NAN;
+  case EL_NOT: return ~a;
+  default:     return NAN;
+  }
+}
+
+//+----------------------------------+
+//| Lectura de los archivos de datos |
+//+----------------------------------+-------------------------------------------------------------
+//Funcion que lee un archivo binario: cada dato ocupa dos bytes, primero el mas significativo
+static bool leer_binario(FILE *fp_archivo, int *datos, int *cantidad, char *detalle) {
+  int alto, bajo;
+
+  while ((alto = getc(fp_archivo)) != EOF) {
+    bajo = getc(fp_archivo);
+    if (bajo == EOF) {
+      snprintf(detalle, TAM_DETALLE, "la cantidad de bytes es impar");
+      return false;
+    }
+    if (*cantidad == TAM_ESPACIO_MEM) {
+      snprintf(detalle, TAM_DETALLE, "tiene mas datos que los que caben en la memoria");
+      return false;
+    }
+    datos[(*cantidad)++] = alto << 8 | bajo;
+  }
+  return true;
+}
+
+//Funcion que lee un archivo de texto con datos en hexadecimal
+static bool leer_hexadecimal(FILE *fp_archivo, int *datos, int *cantidad, char *detalle) {
+  char valor[TAM_VALOR_HEX + 1], *digitos, *fin;
+  int caracter, longitud, num_lin = 1;
+
+  while ((caracter = getc(fp_archivo)) != EOF) {
+    if (caracter == '\n')
+      num_lin++;
+    else if (caracter == ';' || caracter == '#') {
+      //El resto de la linea es un comentario
+      while ((caracter = getc(fp_archivo)) != EOF && caracter != '\n');
+      ungetc(caracter, fp_archivo);
+    } else if (!isspace(caracter) && caracter != ',') {
+      //Toma el dato completo hasta el siguiente separador
+      longitud = 0;
+      do {
+        if (longitud < TAM_VALOR_HEX) valor[longitud++] = caracter;
+        caracter = getc(fp_archivo);
+      } while (caracter != EOF && !isspace(caracter) && caracter != ',' && caracter != ';' &&
+               caracter != '#');
+      ungetc(caracter, fp_archivo);
+      valor[longitud] = '\0';
+
+      digitos = valor[0] == '0' && (valor[1] == 'x' || valor[1] == 'X') ? &valor[2] : valor;
+      if (strlen(digitos) < 1 || strlen(digitos) > 4 || !isxdigit((unsigned char) digitos[0])) {
+        snprintf(detalle, TAM_DETALLE, "linea %i: dato hexadecimal invalido: %s", num_lin,
+                 valor);
+        return false;
+      }
+      if (*cantidad == TAM_ESPACIO_MEM) {
+        snprintf(detalle, TAM_DETALLE, "tiene mas datos que los que caben en la memoria");
+        return false;
+      }
+      datos[(*cantidad)++] = strtoul(digitos, &fin, 16);
+      if (*fin) {
+        snprintf(detalle, TAM_DETALLE, "linea %i: dato hexadecimal invalido: %s", num_lin,
+                 valor);
+        return false;
+      }
+    }
+  }
+  return true;
+}
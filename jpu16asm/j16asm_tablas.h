@@ -0,0 +1,17 @@
+#ifndef j16asm_tablas_h_Incluida
+#define j16asm_tablas_h_Incluida
+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+
+//Declaracion previa del contexto de ensamblado (definido en j16asm.h)
+struct _CONTEXTO_ASM;
+
+//Funciones exportadas
+//--------------------
+//Funciones que generan los datos de las directivas table, incbin e inchex (el arreglo se aloja con
+//malloc y es NULL si hay errores)
+extern int *calcular_tabla(struct _CONTEXTO_ASM *ctx, const char *texto, int *cantidad);
+extern int *leer_archivo_datos(struct _CONTEXTO_ASM *ctx, const char *nombre, bool hexadecimal,
+                               int *cantidad);
+
+#endif //j16asm_tablas_h_Incluida
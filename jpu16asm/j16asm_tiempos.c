@@ -0,0 +1,555 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_tiempos.c                                                                              |
+//| Modulo de analisis estatico del tiempo de ejecucion                                           |
+//|                                                                                               |
+//| Este modulo calcula cotas del tiempo que tarda una rutina desde su primera instruccion hasta  |
+//| que retorna, en el mejor y en el peor caso. En JPU16 cada instruccion tarda dos ciclos de     |
+//| SysClk (CicloInst alterna en cada ciclo), salvo cuando SysHold detiene al CPU, lo cual no se  |
+//| puede acotar de forma estatica y no se toma en cuenta.                                        |
+//| El analisis recorre el grafo de flujo de la rutina a partir de la imagen de la memoria de     |
+//| programa:                                                                                     |
+//| - Los saltos directos continuan en su destino; los condicionales en su destino o en la        |
+//|   instruccion siguiente.                                                                      |
+//| - Las llamadas directas suman el tiempo de la rutina llamada (calculado una sola vez). En el  |
+//|   mejor caso una llamada condicional no se realiza.                                           |
+//| - return, idret e ieret terminan la rutina.                                                   |
+//| - Los saltos y llamadas indirectas, la recursion y llegar a una localidad sin instruccion     |
+//|   impiden acotar la rutina.                                                                   |
+//|                                                                                               |
+//| Nota acerca de los lazos                                                                      |
+//| Un lazo es un salto hacia atras en el recorrido en profundidad del grafo (el destino es la    |
+//| cabecera del lazo). La cantidad de vueltas se indica en el codigo fuente en la instruccion que|
+//| cierra el lazo (ver el modulo j16asm_listado) y sin ella el lazo no se puede acotar. Los lazos|
+//| se reducen de adentro hacia afuera: el cuerpo de cada uno es un grafo aciclico (los internos  |
+//| ya estan reducidos a su cabecera), asi que se obtiene el camino mas largo y el mas corto desde|
+//| la cabecera hasta cada instruccion. Un lazo de N vueltas cuesta entonces N-1 vueltas completas|
+//| mas el camino desde la cabecera hasta la instruccion por la que sale, y pasa a ser un solo    |
+//| nodo con ese costo. Si un lazo tiene varias salidas se toma la mas larga en el peor caso y la |
+//| mas corta en el mejor, lo cual mantiene ambas cotas seguras.                                  |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+#include <stdlib.h>                     //Permite invocar malloc, calloc y free
+#include "j16asm_tiempos.h"             //Cabecera propia
+
+//Estados del calculo de cada rutina
+#define RUTINA_PENDIENTE  0             //Aun no se calcula
+#define RUTINA_EN_CURSO   1             //Se esta calculando (una llamada a ella es recursiva)
+#define RUTINA_CALCULADA  2             //El resultado ya esta en el arreglo de tiempos
+
+//Efecto de una instruccion sobre el flujo del programa
+typedef enum _FLUJO {
+  FL_SIGUIENTE,                         //Continua con la instruccion siguiente
+  FL_SALTO,                             //Salto directo incondicional
+  FL_SALTO_COND,                        //Salto directo condicional
+  FL_LLAMADA,                           //Llamada directa incondicional
+  FL_LLAMADA_COND,                      //Llamada directa condicional
+  FL_RETORNO,                           //return, idret o ieret
+  FL_INDIRECTO                          //Salto o llamada a traves de un registro
+} FLUJO;
+
+//Estructura con el grafo de flujo de una rutina. Los nodos son las instrucciones alcanzables
+//desde la primera, numeradas en el orden en que se encuentran (el nodo 0 es la primera)
+typedef struct _GRAFO {
+  ANALISIS_TIEMPOS *analisis;           //Analisis al que pertenece la rutina
+  int num_nodos;                        //Cantidad de instrucciones alcanzables
+  int *direccion;                       //Direccion de cada nodo
+  int *indice;                          //Nodo de cada direccion (-1 si no es alcanzable)
+  int (*sucesor)[2];                    //Nodos que pueden seguir a cada uno (-1 si no hay)
+  int *pred_inicio;                     //Inicio de los predecesores de cada nodo (num_nodos + 1)
+  int *predecesor;                      //Predecesores de todos los nodos, agrupados por nodo
+  long long *peor, *mejor;              //Costo de cada nodo (o del lazo que representa)
+  bool *termina;                        //El nodo (o el lazo que representa) puede retornar
+  int *rep;                             //Cabecera del lazo que absorbio cada nodo (o el mismo)
+  int *marca;                           //Conjunto al que pertenece cada nodo en un recorrido
+  int ultima_marca;                     //Ultima marca usada (cada recorrido usa una nueva)
+  int *miembros;                        //Nodos del recorrido de toda la rutina
+  int *grado, *entrantes, *inicio;      //Aristas de salida y de entrada de cada representante
+  int *destino;                         //Destinos de las aristas, agrupados por origen
+  int (*arista)[2];                     //Aristas entre representantes (origen y destino)
+  int *cola;                            //Cola del orden topologico y de las busquedas
+  long long *dist_peor, *dist_mejor;    //Camino mas largo y mas corto hasta cada representante
+} GRAFO;
+
+//Estructura con un lazo: su cabecera, las instrucciones que lo cierran y su cuerpo
+typedef struct _LAZO {
+  int cabecera;                         //Nodo al que saltan las instrucciones que lo cierran
+  int *cierres;                         //Nodos que cierran el lazo (saltan a la cabecera)
+  int num_cierres;                      //Cantidad de nodos que cierran el lazo
+  int *cuerpo;                          //Nodos del lazo (incluye la cabecera)
+  int tam_cuerpo;                       //Cantidad de nodos del lazo
+  COTA_LAZO cota;                       //Cantidad de vueltas
+  int sin_cota;                         //Nodo que lo cierra sin indicar las vueltas (-1 si no hay)
+} LAZO;
+
+//Declaracion previa de las funciones locales al modulo
+static FLUJO clasificar(uint32_t instr);
+static bool armar_grafo(GRAFO *g, int entrada, TIEMPO_RUTINA *resultado);
+static bool buscar_lazos(GRAFO *g, LAZO **lazos, int *num_lazos, TIEMPO_RUTINA *resultado);
+static bool armar_cuerpo(GRAFO *g, LAZO *lazo, TIEMPO_RUTINA *resultado);
+static bool reducir_lazo(GRAFO *g, LAZO *lazo, TIEMPO_RUTINA *resultado);
+static bool recorrer(GRAFO *g, const int *miembros, int num_miembros, int marca, int raiz);
+static void terminar_resultado(GRAFO *g, TIEMPO_RUTINA *resultado, int entrada);
+static int comparar_lazos(const void *a, const void *b);
+static void alojar_grafo(GRAFO *g, ANALISIS_TIEMPOS *analisis);
+static void liberar_grafo(GRAFO *g);
+static bool sin_cota(TIEMPO_RUTINA *resultado, MOTIVO_SIN_COTA motivo, int direccion);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion para preparar el analisis de un programa. Las cotas de los lazos se indican por
+//direccion, en la instruccion que cierra cada lazo
+void iniciar_analisis_tiempos(ANALISIS_TIEMPOS *analisis, const IMAGEN_MEM *imagen,
+                              int tam_prg, const COTA_LAZO *cotas) {
+  analisis->imagen = imagen;
+  analisis->tam_prg = tam_prg;
+  analisis->cotas = cotas;
+  analisis->estado = calloc(tam_prg, sizeof(char));
+  analisis->tiempos = calloc(tam_prg, sizeof(TIEMPO_RUTINA));
+}
+
+//Funcion que obtiene las cotas del tiempo de la rutina que inicia en una direccion (el resultado
+//se guarda para las llamadas posteriores)
+TIEMPO_RUTINA calcular_tiempo_rutina(ANALISIS_TIEMPOS *analisis, int direccion) {
+  GRAFO g;
+  LAZO *lazos = NULL;
+  TIEMPO_RUTINA resultado = { 0, 0, SC_NINGUNO, 0 };
+  int num_lazos = 0, i;
+
+  if (analisis->estado[direccion] == RUTINA_CALCULADA) return analisis->tiempos[direccion];
+  analisis->estado[direccion] = RUTINA_EN_CURSO;
+
+  //Arma el grafo (calculando de paso las rutinas llamadas), busca los lazos y los reduce de
+  //adentro hacia afuera (los de menor cuerpo primero)
+  alojar_grafo(&g, analisis);
+  if (armar_grafo(&g, direccion, &resultado) &&
+      buscar_lazos(&g, &lazos, &num_lazos, &resultado)) {
+    if (num_lazos) qsort(lazos, num_lazos, sizeof(LAZO), comparar_lazos);
+    for (i=0; i<num_lazos && resultado.motivo == SC_NINGUNO; i++)
+      reducir_lazo(&g, &lazos[i], &resultado);
+
+    //Lo que queda es aciclico: la rutina dura lo que el camino mas largo (o corto) hasta
+    //alguna instruccion que retorna
+    if (resultado.motivo == SC_NINGUNO) {
+      g.ultima_marca++;
+      for (i=0; i<g.num_nodos; i++) {
+        g.marca[i] = g.ultima_marca;
+        g.miembros[i] = i;
+      }
+      if (!recorrer(&g, g.miembros, g.num_nodos, g.ultima_marca, g.rep[0]))
+        sin_cota(&resultado, SC_LAZO_IRREDUCIBLE, direccion);
+      else
+        terminar_resultado(&g, &resultado, direccion);
+    }
+  }
+
+  for (i=0; i<num_lazos; i++) {
+    free(lazos[i].cierres);
+    free(lazos[i].cuerpo);
+  }
+  free(lazos);
+  liberar_grafo(&g);
+
+  analisis->tiempos[direccion] = resultado;
+  analisis->estado[direccion] = RUTINA_CALCULADA;
+  return resultado;
+}
+
+//Funcion para liberar los resultados del analisis
+void desalojar_analisis_tiempos(ANALISIS_TIEMPOS *analisis) {
+  free(analisis->estado);
+  free(analisis->tiempos);
+  analisis->estado = NULL;
+  analisis->tiempos = NULL;
+}
+
+//Funcion que determina el efecto de una instruccion sobre el flujo del programa a partir de los
+//bits 25 a 20 del codigo (ver la tabla de instrucciones)
+static FLUJO clasificar(uint32_t instr) {
+  switch (instr >> 20 & 0x3F) {
+  case 0b010000: return FL_SALTO;                     //jmp dir
+  case 0b010010: return FL_SALTO_COND;                //jmpX dir
+  case 0b010100: return FL_LLAMADA;                   //call dir
+  case 0b010110: return FL_LLAMADA_COND;              //callX dir
+  case 0b010001:                                      //jmp reg
+  case 0b010011:                                      //jmpX reg
+  case 0b010101:                                      //call reg
+  case 0b010111: return FL_INDIRECTO;                 //callX reg
+  case 0b011000:                                      //return
+  case 0b011100:                                      //idret
+  case 0b011110: return FL_RETORNO;                   //ieret
+  default:       return FL_SIGUIENTE;
+  }
+}
+
+//Funcion que arma el grafo de flujo de la rutina recorriendo las instrucciones alcanzables desde
+//la entrada, y obtiene el costo de cada una (las llamadas incluyen a la rutina llamada)
+static bool armar_grafo(GRAFO *g, int entrada, TIEMPO_RUTINA *resultado) {
+  ANALISIS_TIEMPOS *analisis = g->analisis;
+  TIEMPO_RUTINA llamada;
+  uint32_t instr;
+  FLUJO flujo;
+  int nodo, direccion, siguiente, destino, i, k, total;
+
+  //Las instrucciones se numeran en el orden en que se encuentran (la cola son los mismos nodos)
+  g->indice[entrada] = 0;
+  g->direccion[0] = entrada;
+  g->num_nodos = 1;
+  for (nodo=0; nodo<g->num_nodos; nodo++) {
+    direccion = g->direccion[nodo];
+    if (!localidad_prg_ocupada(analisis->imagen, direccion))
+      return sin_cota(resultado, SC_FUERA, direccion);
+    instr = leer_dato_prg(analisis->imagen, direccion);
+    flujo = clasificar(instr);
+    siguiente = (direccion + 1) & (analisis->tam_prg - 1);
+    destino = (direccion + (int16_t) instr) & (analisis->tam_prg - 1);
+
+    //Costo de la instruccion (mas el de la rutina llamada)
+    g->peor[nodo] = g->mejor[nodo] = CICLOS_INSTRUCCION;
+    g->termina[nodo] = flujo == FL_RETORNO;
+    g->rep[nodo] = nodo;
+    if (flujo == FL_LLAMADA || flujo == FL_LLAMADA_COND) {
+      if (analisis->estado[destino] == RUTINA_EN_CURSO)
+        return sin_cota(resultado, SC_RECURSION, direccion);
+      llamada = calcular_tiempo_rutina(analisis, destino);
+      if (llamada.motivo != SC_NINGUNO) {
+        *resultado = llamada;           //El motivo es el mismo que el de la rutina llamada
+        return false;
+      }
+      g->peor[nodo] += llamada.peor;
+      if (flujo == FL_LLAMADA) g->mejor[nodo] += llamada.mejor;
+    }
+
+    //Sucesores de la instruccion
+    g->sucesor[nodo][0] = g->sucesor[nodo][1] = -1;
+    switch (flujo) {
+    case FL_INDIRECTO:    return sin_cota(resultado, SC_INDIRECTO, direccion);
+    case FL_RETORNO:      break;
+    case FL_SALTO:        g->sucesor[nodo][0] = destino;                                  break;
+    case FL_SALTO_COND:   g->sucesor[nodo][0] = destino; g->sucesor[nodo][1] = siguiente; break;
+    default:              g->sucesor[nodo][0] = siguiente;                                break;
+    }
+    if (g->sucesor[nodo][1] == g->sucesor[nodo][0])
+      g->sucesor[nodo][1] = -1;         //Un salto condicional a la siguiente es una sola arista
+
+    //Los sucesores que no se han encontrado se agregan al final de la lista de nodos
+    for (k=0; k<2; k++) {
+      direccion = g->sucesor[nodo][k];
+      if (direccion < 0) continue;
+      if (g->indice[direccion] < 0) {
+        g->indice[direccion] = g->num_nodos;
+        g->direccion[g->num_nodos++] = direccion;
+      }
+      g->sucesor[nodo][k] = g->indice[direccion];
+    }
+  }
+
+  //Arma la lista de predecesores de cada nodo (para obtener el cuerpo de los lazos)
+  for (nodo=0; nodo<=g->num_nodos; nodo++) g->pred_inicio[nodo] = 0;
+  for (nodo=0; nodo<g->num_nodos; nodo++)
+    for (k=0; k<2; k++)
+      if (g->sucesor[nodo][k] >= 0) g->pred_inicio[g->sucesor[nodo][k] + 1]++;
+  for (nodo=0, total=0; nodo<=g->num_nodos; nodo++) {
+    total += g->pred_inicio[nodo];
+    g->pred_inicio[nodo] = total;
+    g->grado[nodo] = total;             //Posicion donde se agrega el siguiente predecesor
+  }
+  for (nodo=0; nodo<g->num_nodos; nodo++)
+    for (k=0; k<2; k++)
+      if ((i = g->sucesor[nodo][k]) >= 0) g->predecesor[g->grado[i]++] = nodo;
+  return true;
+}
+
+//Funcion que busca los lazos de la rutina mediante un recorrido en profundidad: cada arista hacia
+//un nodo que aun esta en la pila cierra un lazo con cabecera en ese nodo. Los lazos con la misma
+//cabecera se juntan en uno solo
+static bool buscar_lazos(GRAFO *g, LAZO **lazos, int *num_lazos, TIEMPO_RUTINA *resultado) {
+  const COTA_LAZO *cotas = g->analisis->cotas;
+  //Los arreglos de las aristas aun no se usan, asi que sirven para el recorrido
+  int *pila = g->cola, *siguiente = g->inicio, *lazo_de = g->entrantes;
+  int *color = g->grado;                //0: sin visitar, 1: en la pila, 2: terminado
+  COTA_LAZO cota;
+  LAZO *lazo;
+  int tope, nodo, sucesor, i;
+
+  for (i=0; i<g->num_nodos; i++) {
+    color[i] = 0;
+    siguiente[i] = 0;
+    lazo_de[i] = -1;
+  }
+
+  pila[0] = 0;
+  tope = 1;
+  color[0] = 1;
+  while (tope) {
+    nodo = pila[tope - 1];
+    if (siguiente[nodo] == 2) {
+      color[nodo] = 2;
+      tope--;
+      continue;
+    }
+    sucesor = g->sucesor[nodo][siguiente[nodo]++];
+    if (sucesor < 0) continue;
+    if (color[sucesor] == 0) {
+      color[sucesor] = 1;
+      pila[tope++] = sucesor;
+      continue;
+    }
+    if (color[sucesor] != 1) continue;
+
+    //La arista cierra un lazo: la instruccion que salta debe indicar la cantidad de vueltas (se
+    //verifica despues de armar los cuerpos, ya que un lazo irreducible no se acota de todos modos)
+    cota = cotas[g->direccion[nodo]];
+    if (lazo_de[sucesor] < 0) {
+      if (!(*num_lazos & (*num_lazos - 1)))
+        *lazos = realloc(*lazos, (*num_lazos ? *num_lazos * 2 : 1) * sizeof(LAZO));
+      lazo_de[sucesor] = (*num_lazos)++;
+      lazo = &(*lazos)[lazo_de[sucesor]];
+      lazo->cabecera = sucesor;
+      lazo->cierres = NULL;
+      lazo->num_cierres = 0;
+      lazo->cuerpo = NULL;
+      lazo->tam_cuerpo = 0;
+      lazo->cota = cota;
+      lazo->sin_cota = -1;
+    }
+    else {
+      //Con varias instrucciones que cierran el lazo se toman los extremos de sus cotas
+      lazo = &(*lazos)[lazo_de[sucesor]];
+      if (cota.maximo > lazo->cota.maximo) lazo->cota.maximo = cota.maximo;
+      if (cota.minimo < lazo->cota.minimo) lazo->cota.minimo = cota.minimo;
+    }
+    if (cota.maximo < 0 && lazo->sin_cota < 0) lazo->sin_cota = nodo;
+    if (!(lazo->num_cierres & (lazo->num_cierres - 1)))
+      lazo->cierres = realloc(lazo->cierres,
+                              (lazo->num_cierres ? lazo->num_cierres * 2 : 1) * sizeof(int));
+    lazo->cierres[lazo->num_cierres++] = nodo;
+  }
+
+  //Obtiene el cuerpo de cada lazo y verifica que todos tengan cota
+  for (i=0; i<*num_lazos; i++)
+    if (!armar_cuerpo(g, &(*lazos)[i], resultado)) return false;
+  for (i=0; i<*num_lazos; i++)
+    if ((*lazos)[i].sin_cota >= 0)
+      return sin_cota(resultado, SC_LAZO, g->direccion[(*lazos)[i].sin_cota]);
+  return true;
+}
+
+//Funcion que obtiene el cuerpo de un lazo: los nodos desde los cuales se llega a alguna de las
+//instrucciones que lo cierran sin pasar por la cabecera. Si asi se llega a la entrada de la
+//rutina, al lazo se puede entrar sin pasar por la cabecera (no es reducible)
+static bool armar_cuerpo(GRAFO *g, LAZO *lazo, TIEMPO_RUTINA *resultado) {
+  int *cola = g->cola;
+  int marca = ++g->ultima_marca;
+  int inicio, fin, nodo, i, k;
+
+  g->marca[lazo->cabecera] = marca;
+  cola[0] = lazo->cabecera;
+  fin = 1;
+
+  for (i=0; i<lazo->num_cierres; i++) {
+    nodo = lazo->cierres[i];
+    if (g->marca[nodo] == marca) continue;
+    g->marca[nodo] = marca;
+    cola[fin++] = nodo;
+  }
+
+  //Busca hacia atras desde las instrucciones que cierran el lazo
+  for (inicio=1; inicio<fin; inicio++) {
+    nodo = cola[inicio];
+    if (nodo == 0) return sin_cota(resultado, SC_LAZO_IRREDUCIBLE, g->direccion[lazo->cabecera]);
+    for (k=g->pred_inicio[nodo]; k<g->pred_inicio[nodo + 1]; k++) {
+      if (g->marca[g->predecesor[k]] == marca) continue;
+      g->marca[g->predecesor[k]] = marca;
+      cola[fin++] = g->predecesor[k];
+    }
+  }
+
+  lazo->cuerpo = malloc(fin * sizeof(int));
+  for (i=0; i<fin; i++) lazo->cuerpo[i] = cola[i];
+  lazo->tam_cuerpo = fin;
+  return true;
+}
+
+//Funcion que reduce un lazo a su cabecera: calcula el costo de una vuelta y el de la ultima (hasta
+//la salida) por el camino mas largo y el mas corto, y la cabecera pasa a representar al lazo
+static bool reducir_lazo(GRAFO *g, LAZO *lazo, TIEMPO_RUTINA *resultado) {
+  int marca = ++g->ultima_marca;
+  int cabecera = lazo->cabecera;
+  long long vuelta_peor = -1, vuelta_mejor = -1, salida_peor = -1, salida_mejor = -1;
+  bool termina = false, sale;
+  int i, k, nodo, rep, sucesor;
+
+  for (i=0; i<lazo->tam_cuerpo; i++) g->marca[lazo->cuerpo[i]] = marca;
+  if (!recorrer(g, lazo->cuerpo, lazo->tam_cuerpo, marca, cabecera))
+    return sin_cota(resultado, SC_LAZO_IRREDUCIBLE, g->direccion[cabecera]);
+
+  //Una vuelta completa termina en alguna de las instrucciones que cierran el lazo
+  for (i=0; i<lazo->num_cierres; i++) {
+    rep = g->rep[lazo->cierres[i]];
+    if (g->dist_peor[rep] > vuelta_peor) vuelta_peor = g->dist_peor[rep];
+    if (vuelta_mejor < 0 || g->dist_mejor[rep] < vuelta_mejor) vuelta_mejor = g->dist_mejor[rep];
+  }
+
+  //La ultima vuelta termina en una instruccion que sale del lazo o que retorna
+  for (i=0; i<lazo->tam_cuerpo; i++) {
+    nodo = lazo->cuerpo[i];
+    rep = g->rep[nodo];
+    sale = g->termina[nodo];
+    for (k=0; k<2; k++) {
+      sucesor = g->sucesor[nodo][k];
+      if (sucesor >= 0 && g->marca[sucesor] != marca) sale = true;
+    }
+    if (!sale) continue;
+    if (g->dist_peor[rep] > salida_peor) salida_peor = g->dist_peor[rep];
+    if (salida_mejor < 0 || g->dist_mejor[rep] < salida_mejor) salida_mejor = g->dist_mejor[rep];
+  }
+  if (salida_peor < 0) return sin_cota(resultado, SC_SIN_SALIDA, g->direccion[lazo->cierres[0]]);
+
+  //El lazo completo pasa a ser un solo nodo representado por la cabecera
+  for (i=0; i<lazo->tam_cuerpo; i++) {
+    termina |= g->termina[lazo->cuerpo[i]];
+    g->rep[lazo->cuerpo[i]] = cabecera;
+  }
+  g->termina[cabecera] = termina;
+  g->peor[cabecera] = (lazo->cota.maximo - 1) * vuelta_peor + salida_peor;
+  g->mejor[cabecera] = (lazo->cota.minimo - 1) * vuelta_mejor + salida_mejor;
+  return true;
+}
+
+//Funcion que calcula el camino mas largo y el mas corto desde la raiz hasta cada representante de
+//un conjunto de nodos (marcados con la marca indicada), sin contar las aristas hacia la raiz ni
+//las que quedan dentro de un lazo ya reducido. Retorna false si las aristas forman un ciclo
+static bool recorrer(GRAFO *g, const int *miembros, int num_miembros, int marca, int raiz) {
+  int i, k, nodo, origen, destino, num_aristas = 0, num_reps = 0, procesados, fin, total;
+
+  //Arma la lista de aristas entre representantes
+  for (i=0; i<num_miembros; i++) {
+    origen = g->rep[miembros[i]];
+    if (g->marca[origen] != marca) return false;  //Lazos que se cruzan sin estar anidados
+    g->grado[origen] = g->entrantes[origen] = 0;
+    g->dist_peor[origen] = g->dist_mejor[origen] = -1;
+  }
+  for (i=0; i<num_miembros; i++) {
+    nodo = miembros[i];
+    origen = g->rep[nodo];
+    if (origen == nodo) num_reps++;
+    for (k=0; k<2; k++) {
+      if (g->sucesor[nodo][k] < 0 || g->marca[g->sucesor[nodo][k]] != marca) continue;
+      destino = g->rep[g->sucesor[nodo][k]];
+      if (destino == origen || destino == raiz) continue;
+      g->arista[num_aristas][0] = origen;
+      g->arista[num_aristas++][1] = destino;
+      g->grado[origen]++;
+      g->entrantes[destino]++;
+    }
+  }
+
+  //Agrupa los destinos por origen
+  for (i=0, total=0; i<num_miembros; i++) {
+    nodo = miembros[i];
+    if (g->rep[nodo] != nodo) continue;
+    g->inicio[nodo] = total;
+    total += g->grado[nodo];
+    g->grado[nodo] = g->inicio[nodo];   //Posicion donde se agrega el siguiente destino
+  }
+  for (i=0; i<num_aristas; i++) g->destino[g->grado[g->arista[i][0]]++] = g->arista[i][1];
+
+  //Recorre los representantes en orden topologico a partir de la raiz
+  g->dist_peor[raiz] = g->peor[raiz];
+  g->dist_mejor[raiz] = g->mejor[raiz];
+  g->cola[0] = raiz;
+  for (procesados=0, fin=1; procesados<fin; procesados++) {
+    origen = g->cola[procesados];
+    for (i=g->inicio[origen]; i<g->grado[origen]; i++) {
+      destino = g->destino[i];
+      if (g->dist_peor[destino] < g->dist_peor[origen] + g->peor[destino])
+        g->dist_peor[destino] = g->dist_peor[origen] + g->peor[destino];
+      if (g->dist_mejor[destino] < 0 ||
+          g->dist_mejor[destino] > g->dist_mejor[origen] + g->mejor[destino])
+        g->dist_mejor[destino] = g->dist_mejor[origen] + g->mejor[destino];
+      if (--g->entrantes[destino] == 0) g->cola[fin++] = destino;
+    }
+  }
+  return procesados == num_reps;
+}
+
+//Funcion que obtiene el resultado de la rutina una vez reducidos los lazos: el camino mas largo y
+//el mas corto hasta alguna instruccion que retorna
+static void terminar_resultado(GRAFO *g, TIEMPO_RUTINA *resultado, int entrada) {
+  int i;
+
+  resultado->peor = resultado->mejor = -1;
+  for (i=0; i<g->num_nodos; i++) {
+    if (g->rep[i] != i || !g->termina[i] || g->dist_peor[i] < 0) continue;
+    if (g->dist_peor[i] > resultado->peor) resultado->peor = g->dist_peor[i];
+    if (resultado->mejor < 0 || g->dist_mejor[i] < resultado->mejor)
+      resultado->mejor = g->dist_mejor[i];
+  }
+  if (resultado->peor < 0) sin_cota(resultado, SC_SIN_SALIDA, entrada);
+}
+
+//Funcion de comparacion para ordenar los lazos de menor a mayor cuerpo (los internos primero)
+static int comparar_lazos(const void *a, const void *b) {
+  return ((const LAZO *) a)->tam_cuerpo - ((const LAZO *) b)->tam_cuerpo;
+}
+
+//Funcion que aloja los arreglos del grafo con espacio para todo el programa
+static void alojar_grafo(GRAFO *g, ANALISIS_TIEMPOS *analisis) {
+  int tam = analisis->tam_prg, i;
+
+  g->analisis = analisis;
+  g->num_nodos = 0;
+  g->ultima_marca = 0;
+  g->direccion = malloc(tam * sizeof(int));
+  g->indice = malloc(tam * sizeof(int));
+  g->sucesor = malloc(tam * sizeof(*g->sucesor));
+  g->pred_inicio = malloc((tam + 1) * sizeof(int));
+  g->predecesor = malloc(2 * tam * sizeof(int));
+  g->peor = malloc(tam * sizeof(long long));
+  g->mejor = malloc(tam * sizeof(long long));
+  g->termina = malloc(tam * sizeof(bool));
+  g->rep = malloc(tam * sizeof(int));
+  g->marca = calloc(tam, sizeof(int));
+  g->miembros = malloc(tam * sizeof(int));
+  g->grado = malloc(tam * sizeof(int));
+  g->entrantes = malloc(tam * sizeof(int));
+  g->inicio = malloc(tam * sizeof(int));
+  g->destino = malloc(2 * tam * sizeof(int));
+  g->arista = malloc(2 * tam * sizeof(*g->arista));
+  g->cola = malloc(tam * sizeof(int));
+  g->dist_peor = malloc(tam * sizeof(long long));
+  g->dist_mejor = malloc(tam * sizeof(long long));
+  for (i=0; i<tam; i++) g->indice[i] = -1;
+}
+
+//Funcion que libera los arreglos del grafo
+static void liberar_grafo(GRAFO *g) {
+  free(g->direccion);
+  free(g->indice);
+  free(g->sucesor);
+  free(g->pred_inicio);
+  free(g->predecesor);
+  free(g->peor);
+  free(g->mejor);
+  free(g->termina);
+  free(g->rep);
+  free(g->marca);
+  free(g->miembros);
+  free(g->grado);
+  free(g->entrantes);
+  free(g->inicio);
+  free(g->destino);
+  free(g->arista);
+  free(g->cola);
+  free(g->dist_peor);
+  free(g->dist_mejor);
+}
+
+//Funcion que indica que la rutina no tiene cota y el motivo (retorna false para abortar)
+static bool sin_cota(TIEMPO_RUTINA *resultado, MOTIVO_SIN_COTA motivo, int direccion) {
+  resultado->motivo = motivo;
+  resultado->direccion_motivo = direccion;
+  return false;
+}
@@ -0,0 +1,55 @@
+#ifndef j16asm_tiempos_h_Incluida
+#define j16asm_tiempos_h_Incluida
+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include "j16asm_imagen_mem.h"          //Incluye la imagen de las memorias de programa y RAM
+
+//Constantes exportadas
+//---------------------
+#define CICLOS_INSTRUCCION  2           //Ciclos de SysClk de cada instruccion (sin SysHold)
+
+//Tipos de datos exportados
+//-------------------------
+//Cantidad de vueltas de un lazo, indicada en la instruccion que lo cierra
+typedef struct _COTA_LAZO {
+  int minimo;                           //Menor cantidad de vueltas (al menos 1)
+  int maximo;                           //Mayor cantidad de vueltas (negativo si no se indico)
+} COTA_LAZO;
+
+//Motivos por los que no se puede acotar el tiempo de una rutina
+typedef enum _MOTIVO_SIN_COTA {
+  SC_NINGUNO,                           //La rutina tiene cota
+  SC_LAZO,                              //Lazo sin cantidad de vueltas indicada
+  SC_LAZO_IRREDUCIBLE,                  //Lazo al que se puede entrar por varios lugares
+  SC_SIN_SALIDA,                        //Lazo del que nunca se sale (o rutina sin retorno)
+  SC_INDIRECTO,                         //Salto o llamada a traves de un registro
+  SC_RECURSION,                         //Llamada recursiva
+  SC_FUERA                              //La ejecucion llega a una localidad sin instruccion
+} MOTIVO_SIN_COTA;
+
+//Resultado del analisis de una rutina: desde su primera instruccion hasta que retorna
+typedef struct _TIEMPO_RUTINA {
+  long long mejor;                      //Ciclos en el mejor caso
+  long long peor;                       //Ciclos en el peor caso
+  MOTIVO_SIN_COTA motivo;               //Motivo por el que no hay cota (SC_NINGUNO si la hay)
+  int direccion_motivo;                 //Instruccion que impide acotar la rutina
+} TIEMPO_RUTINA;
+
+//Estructura con el programa que se analiza y los resultados de las rutinas ya calculadas (las
+//llamadas usan el resultado de la rutina llamada)
+typedef struct _ANALISIS_TIEMPOS {
+  const IMAGEN_MEM *imagen;             //Imagen con la memoria de programa
+  int tam_prg;                          //Capacidad de la memoria de programa
+  const COTA_LAZO *cotas;               //Cota indicada en cada direccion (tam_prg entradas)
+  char *estado;                         //Estado del calculo de la rutina de cada direccion
+  TIEMPO_RUTINA *tiempos;               //Resultado de la rutina de cada direccion
+} ANALISIS_TIEMPOS;
+
+//Funciones exportadas
+//--------------------
+extern void iniciar_analisis_tiempos(ANALISIS_TIEMPOS *analisis, const IMAGEN_MEM *imagen,
+                                     int tam_prg, const COTA_LAZO *cotas);
+extern TIEMPO_RUTINA calcular_tiempo_rutina(ANALISIS_TIEMPOS *analisis, int direccion);
+extern void desalojar_analisis_tiempos(ANALISIS_TIEMPOS *analisis);
+
+#endif //j16asm_tiempos_h_Incluida
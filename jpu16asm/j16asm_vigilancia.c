@@ -0,0 +1,203 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16asm_vigilancia.c                                                                           |
+//| Modulo del modo de vigilancia                                                                 |
+//|                                                                                               |
+//| Este modulo mantiene el ensamblador en ejecucion vigilando (mediante inotify) el archivo de   |
+//| entrada y todos los que este incluye (o los objetos, si se esta enlazando). Cada vez que      |
+//| alguno se termina de guardar, el programa se vuelve a ensamblar en el mismo contexto y solo   |
+//| se reemplazan los archivos de salida cuyo contenido cambio, de modo que make (o data2mem)     |
+//| solo ve los cambios reales.                                                                   |
+//| No se reensambla solo la region que cambio: en un ensamblador de dos pasos cualquier linea    |
+//| puede mover las direcciones de todo lo que le sigue, y cualquier simbolo se puede usar antes  |
+//| de definirse. Ensamblar el programa completo toma pocos milisegundos; lo que se ahorra es el  |
+//| arranque del proceso y la reescritura de las salidas que no cambiaron.                        |
+//| Se vigilan los directorios y no los archivos, ya que muchos editores guardan escribiendo un   |
+//| archivo nuevo y renombrandolo sobre el original (lo cual anula la vigilancia de un archivo).  |
+//+-----------------------------------------------------------------------------------------------+
+#include <errno.h>                      //Permite distinguir las interrupciones de los errores
+#include <limits.h>                     //Incluye las longitudes maximas de rutas y nombres
+#include <poll.h>                       //Permite consultar si hay eventos pendientes
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdio.h>                      //Permite manejar archivos
+#include <stdlib.h>                     //Permite invocar realloc y free
+#include <string.h>                     //Permite manejar cadenas
+#include <sys/inotify.h>                //Permite vigilar los cambios en los directorios
+#include <time.h>                       //Permite medir el tiempo de cada ensamblado
+#include <unistd.h>                     //Permite leer y cerrar el descriptor de inotify
+#include "j16asm_vigilancia.h"          //Cabecera propia
+#include "j16asm_ensamblador.h"         //Permite reiniciar el contexto antes de cada ensamblado
+#include "j16asm_fuentes.h"             //Permite obtener los archivos que se incluyeron
+#include "j16asm_objeto.h"              //Permite reconocer los archivos objeto
+#include "j16asm_messages.h"            //Permite enviar mensajes al usuario
+
+//Tipos de datos locales al modulo
+//Archivo cuyos cambios provocan un nuevo ensamblado
+typedef struct _ARCHIVO_VIGILADO {
+  int directorio;                       //Vigilancia (de inotify) del directorio que lo contiene
+  char nombre[NAME_MAX + 1];            //Nombre del archivo sin el directorio
+} ARCHIVO_VIGILADO;
+
+//Estado de la vigilancia
+typedef struct _VIGILANCIA {
+  int fd;                               //Descriptor de inotify
+  ARCHIVO_VIGILADO *archivos;           //Archivos vigilados
+  int cantidad;                         //Cantidad de archivos vigilados
+  int capacidad;                        //Cantidad de archivos que caben en el arreglo actual
+} VIGILANCIA;
+
+//Declaracion previa de las funciones locales al modulo
+static void vigilar_archivos(VIGILANCIA *vigilancia, CONTEXTO_ASM *ctx,
+                             const OPCIONES_ENSAMBLADO *opciones);
+static void vigilar_archivo(VIGILANCIA *vigilancia, const char *ruta);
+static bool esperar_cambio(VIGILANCIA *vigilancia);
+static bool leer_eventos(VIGILANCIA *vigilancia, bool *cambio);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion que ensambla una y otra vez el archivo de entrada cada vez que cambia alguno de los
+//archivos de los que depende. Solo termina si falla la vigilancia (retorna el codigo de salida)
+int vigilar_ensamblado(CONTEXTO_ASM *ctx, OPCIONES_ENSAMBLADO *opciones,
+                       FUNCION_ENSAMBLADO ensamblar) {
+  VIGILANCIA vigilancia = { -1, NULL, 0, 0 };
+  struct timespec inicio, fin;
+  bool exito;
+
+  vigilancia.fd = inotify_init1(IN_CLOEXEC);
+  if (vigilancia.fd < 0) {
+    msg_error_vigilancia(strerror(errno));
+    return 1;
+  }
+
+  //El archivo de entrada se vigila desde antes del primer ensamblado, para no perder un cambio
+  //que ocurra mientras se ensambla
+  vigilar_archivo(&vigilancia, opciones->nombre_archivo_ent);
+  ctx->conservar_salidas = true;
+
+  do {
+    //Se ensambla todo desde cero en el mismo contexto
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    reiniciar_contexto(ctx);
+    ctx->salidas_reemplazadas = 0;
+    exito = ensamblar(ctx, opciones) == 0;
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+
+    //Los archivos incluidos pueden cambiar de un ensamblado a otro
+    vigilar_archivos(&vigilancia, ctx, opciones);
+    msg_vigilancia_ensamblado(exito, (fin.tv_sec - inicio.tv_sec) +
+                              (fin.tv_nsec - inicio.tv_nsec) * 1e-9,
+                              ctx->salidas_reemplazadas, vigilancia.cantidad);
+    fflush(stdout);
+  } while (esperar_cambio(&vigilancia));
+
+  close(vigilancia.fd);
+  free(vigilancia.archivos);
+  return 1;
+}
+
+//Funcion para armar la lista de archivos vigilados a partir del ultimo ensamblado
+static void vigilar_archivos(VIGILANCIA *vigilancia, CONTEXTO_ASM *ctx,
+                             const OPCIONES_ENSAMBLADO *opciones) {
+  const char **fuentes;
+  int num_fuentes;
+  int i;
+
+  //El archivo de entrada siempre se vigila (aunque no se haya podido abrir)
+  vigilancia->cantidad = 0;
+  vigilar_archivo(vigilancia, opciones->nombre_archivo_ent);
+
+  //Al enlazar se vigilan los objetos, y al ensamblar los archivos que se alcanzaron a incluir
+  if (es_archivo_objeto(opciones->nombre_archivo_ent))
+    for (i=1; i<=opciones->num_objetos; i++) vigilar_archivo(vigilancia, opciones->objetos[i]);
+  else {
+    fuentes = obtener_fuentes(&ctx->registro_fuentes, &num_fuentes);
+    for (i=0; i<num_fuentes; i++) vigilar_archivo(vigilancia, fuentes[i]);
+  }
+}
+
+//Funcion para agregar un archivo a la lista de vigilados, vigilando su directorio (las
+//vigilancias de los directorios que ya no se usan se conservan, sus eventos solo se ignoran)
+static void vigilar_archivo(VIGILANCIA *vigilancia, const char *ruta) {
+  char directorio[PATH_MAX];
+  const char *separador = strrchr(ruta, '/');
+  const char *nombre = separador ? separador + 1 : ruta;
+  ARCHIVO_VIGILADO *archivo;
+  int descriptor;
+  int i;
+
+  //Un nombre o directorio que no cabe no se vigila recortado (se vigilaria otro directorio o
+  //nunca coincidiria el nombre), sino que se reporta
+  if (strlen(nombre) > NAME_MAX || (separador && separador - ruta >= PATH_MAX)) {
+    msg_error_vigilancia_archivo(ruta, strerror(ENAMETOOLONG));
+    return;
+  }
+
+  //Separa el directorio del nombre (sin directorio se trata del actual)
+  if (!separador) strcpy(directorio, ".");
+  else snprintf(directorio, sizeof(directorio), "%.*s",
+                separador == ruta ? 1 : (int) (separador - ruta), ruta);
+
+  //Si el directorio ya esta vigilado, inotify devuelve la misma vigilancia
+  descriptor = inotify_add_watch(vigilancia->fd, directorio, IN_CLOSE_WRITE | IN_MOVED_TO);
+  if (descriptor < 0) {
+    msg_error_vigilancia_archivo(ruta, strerror(errno));
+    return;
+  }
+
+  //Un archivo incluido varias veces solo se registra una
+  for (i=0; i<vigilancia->cantidad; i++)
+    if (vigilancia->archivos[i].directorio == descriptor &&
+        strcmp(vigilancia->archivos[i].nombre, nombre) == 0)
+      return;
+
+  if (vigilancia->cantidad == vigilancia->capacidad) {
+    vigilancia->capacidad = vigilancia->capacidad ? 2 * vigilancia->capacidad : 16;
+    vigilancia->archivos = realloc(vigilancia->archivos,
+                                   vigilancia->capacidad * sizeof(ARCHIVO_VIGILADO));
+  }
+  archivo = &vigilancia->archivos[vigilancia->cantidad++];
+  archivo->directorio = descriptor;
+  strcpy(archivo->nombre, nombre);      //Su longitud ya se verifico
+}
+
+//Funcion que espera hasta que se termine de guardar alguno de los archivos vigilados. Los
+//eventos que ya estan pendientes se consumen tambien, ya que un mismo guardado suele generar
+//varios (retorna false si falla la lectura de eventos)
+static bool esperar_cambio(VIGILANCIA *vigilancia) {
+  struct pollfd pendientes = { vigilancia->fd, POLLIN, 0 };
+  bool cambio = false;
+
+  while (!cambio)
+    if (!leer_eventos(vigilancia, &cambio)) return false;
+  while (poll(&pendientes, 1, 0) > 0)
+    if (!leer_eventos(vigilancia, &cambio)) return false;
+  return true;
+}
+
+//Funcion para leer un grupo de eventos de inotify (se bloquea si no hay ninguno). Indica en
+//cambio si alguno corresponde a un archivo vigilado (o si se perdieron eventos)
+static bool leer_eventos(VIGILANCIA *vigilancia, bool *cambio) {
+  char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+  const struct inotify_event *evento;
+  ssize_t leidos;
+  char *p;
+  int i;
+
+  leidos = read(vigilancia->fd, buffer, sizeof(buffer));
+  if (leidos < 0) {
+    if (errno == EINTR) return true;
+    msg_error_vigilancia(strerror(errno));
+    return false;
+  }
+
+  for (p=buffer; p<buffer+leidos; p+=sizeof(struct inotify_event)+evento->len) {
+    evento = (const struct inotify_event *) p;
+    if (evento->mask & IN_Q_OVERFLOW) *cambio = true;
+    if (!evento->len) continue;
+    for (i=0; i<vigilancia->cantidad; i++)
+      if (vigilancia->archivos[i].directorio == evento->wd &&
+          strcmp(vigilancia->archivos[i].nombre, evento->name) == 0)
+        *cambio = true;
+  }
+  return true;
+}
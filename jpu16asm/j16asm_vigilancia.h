@@ -0,0 +1,19 @@
+#ifndef j16asm_vigilancia_h_Incluida
+#define j16asm_vigilancia_h_Incluida
+
+#include "j16asm.h"                     //Incluye la definicion del contexto de ensamblado
+#include "j16asm_opciones.h"            //Incluye la definicion de las opciones de ensamblado
+
+//Tipos de datos exportados
+//-------------------------
+//Funcion que lleva a cabo un ensamblado completo con las opciones indicadas (retorna el codigo
+//de salida del programa)
+typedef int (*FUNCION_ENSAMBLADO)(CONTEXTO_ASM *ctx, OPCIONES_ENSAMBLADO *opciones);
+
+//Funciones exportadas
+//--------------------
+//Funcion para ensamblar cada vez que cambia alguno de los archivos de entrada (opcion -watch)
+extern int vigilar_ensamblado(CONTEXTO_ASM *ctx, OPCIONES_ENSAMBLADO *opciones,
+                              FUNCION_ENSAMBLADO ensamblar);
+
+#endif //j16asm_vigilancia_h_Incluida
@@ -0,0 +1,25 @@
+;Programa de prueba de la disposicion guiada por un perfil (make check). En el lazo el camino
+;frecuente (7 de cada 8 vueltas) salta sobre el caso raro con un jmp, asi que con el perfil de la
+;simulacion el codigo se reordena para que ese camino siga de largo. Simulado antes y despues de
+;-prof debe terminar en el mismo estado
+
+data
+total:  word 0
+
+code
+inicio:
+  move r1, 64
+  move r2, 0
+lazo:
+  test r1, 7
+  jmpz raro                     ;Se toma 1 de cada 8 vueltas
+  add  r2, 1
+  jmp  siguiente
+raro:
+  add  r2, 100
+siguiente:
+  sub  r1, 1
+  jmpnz lazo
+  move [total], r2
+fin:
+  jmp  fin
@@ -0,0 +1,17 @@
+;Modulo principal de la prueba del enlazador (make check): usa una rutina y una variable que exporta
+;el otro modulo (enlace_rutinas.asm) con la directiva public. El programa enlazado debe terminar en
+;el mismo estado que el mismo codigo ensamblado en un solo archivo (enlace_unico.asm)
+
+data
+resultado: word 0
+
+code
+inicio:
+  move r1, 7
+  call triplicar
+  move [resultado], r1
+  move r2, [factor]
+  move r3, factor
+  move r4, resultado
+fin:
+  jmp  fin
@@ -0,0 +1,12 @@
+;Modulo de rutinas de la prueba del enlazador (ver enlace_principal.asm)
+
+  public triplicar, factor
+
+data
+factor: word 3
+
+code
+triplicar:
+  move r5, [factor]
+  mul  r1, r5
+  return
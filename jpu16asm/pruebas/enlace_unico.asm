@@ -0,0 +1,4 @@
+;Los dos modulos de la prueba del enlazador en un solo archivo, en el mismo orden en que se enlazan
+
+include "enlace_principal.asm"
+include "enlace_rutinas.asm"
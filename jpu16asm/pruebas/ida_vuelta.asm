@@ -0,0 +1,106 @@
+;Programa de prueba de ida y vuelta del desensamblador (make check): se ensambla con -O 1, el
+;desensamblado (-d) se vuelve a ensamblar y ambas imagenes deben ser identicas. Usa todas las
+;formas de operandos y varias secuencias de setX y clrX que el optimizador combina en una sola
+;instruccion (sin saltos indirectos, para que el optimizador pueda eliminar instrucciones)
+
+puerto  equ 0x20
+
+data
+tabla:  word 1, 2, 3, 0xFFFF
+valor:  word tabla
+
+code
+inicio:
+  setc
+  setz
+  clrn
+  clrv
+  clri
+  seti
+  setn
+  setv
+  setc | setz
+  clrc
+  clrz
+  clrn
+  setc | setz
+  setn
+  call rutina
+  jmp  inicio
+
+rutina:
+  move r1, tabla
+  move r2, [valor]
+  move r3, [r1]
+  move [valor], r3
+  move [r1], r2
+  move r4, r5
+  in   r6, puerto
+  in   r7, r1
+  out  puerto, r6
+  out  r1, r7
+  test r1, 0x8000
+  test r1, r2
+  cmp  r3, 10
+  cmp  r3, r4
+  jmpz fin
+  jmpnz fin
+  jmpc fin
+  jmpnc fin
+  jmpp fin
+  jmpn fin
+  jmpv fin
+  jmpnv fin
+  callz rutina
+  callnz rutina
+  callc rutina
+  callnc rutina
+  callp rutina
+  calln rutina
+  callv rutina
+  callnv rutina
+  not  r1
+  add  r1, 1
+  add  r1, r2
+  addc r1, 2
+  addc r1, r2
+  sub  r1, 3
+  sub  r1, r2
+  subb r1, 4
+  subb r1, r2
+  and  r1, 0x00FF
+  and  r1, r2
+  or   r1, 0x0F00
+  or   r1, r2
+  xor  r1, 0xF0F0
+  xor  r1, r2
+  mul  r1, 5
+  mul  r1, r2
+  smul r1, -6
+  smul r1, r2
+  shl0 r1, 1
+  shl0 r1, r2
+  shl1 r1, 2
+  shl1 r1, r2
+  rol  r1, 3
+  rol  r1, r2
+  rolc r1
+  shr0 r1, 4
+  shr0 r1, r2
+  shr1 r1, 5
+  shr1 r1, r2
+  ror  r1, 6
+  ror  r1, r2
+  rorc r1
+  nop
+fin:
+  clrc
+  clrz
+  return
+
+code 0x0100
+interrupcion:
+  setc
+  setz
+  idret
+  ieret
@@ -0,0 +1,24 @@
+;Programa de prueba del listado (make check): contar tiene un lazo de 1 a 8 vueltas, asi que tarda
+;2 + 4 + 2 = 8 ciclos en el mejor caso y 2 + 8 * 4 + 2 = 36 en el peor. La anotacion del lazo de
+;esperar es invalida (0 vueltas): se avisa en su linea y la rutina queda sin cota
+
+code
+inicio:
+  call contar
+  call esperar
+fin:
+  jmp  fin
+
+contar:
+  move r1, 8
+lazo:
+  sub  r1, 1
+  jmpnz lazo                    ;@iteraciones 1 8
+  return
+
+esperar:
+  move r2, 3
+espera:
+  sub  r2, 1
+  jmpnz espera                  ;@iteraciones 0
+  return
@@ -0,0 +1,24 @@
+;Programa de prueba de macros y repeticiones (make check). La macro esperar define una etiqueta
+;local (@lazo), la cual debe tener un nombre distinto en cada una de las dos invocaciones, y las
+;repeticiones anidadas generan 2 * 3 instrucciones add mas 2 instrucciones sub. El mapa (-map)
+;muestra los nombres de las etiquetas y el desensamblado (-d) el codigo generado
+
+  macro esperar registro, vueltas
+  move registro, vueltas
+@lazo:
+  sub  registro, 1
+  jmpnz @lazo
+  endm
+
+code
+inicio:
+  esperar r1, 4
+  esperar r2, 7
+  rept 2
+  rept 3
+  add  r3, 1
+  endm
+  sub  r4, 1
+  endm
+fin:
+  jmp  fin
@@ -0,0 +1,34 @@
+;Programa de prueba del optimizador (make check): tiene un salto condicional a un salto
+;incondicional, el cual se encadena a su destino final, y una rutina que termina en una llamada
+;seguida de return, la cual pasa a ser un salto. Simulado antes y despues de -O 1 debe terminar
+;en el mismo estado
+
+data
+total:  word 0
+veces:  word 0
+
+code
+inicio:
+  move r1, 0
+  move r2, 4
+lazo:
+  call acumular
+  sub  r2, 1
+  jmpnz puente                  ;Se encadena directamente a lazo
+  move [total], r1
+fin:
+  jmp  fin
+
+puente:
+  jmp  lazo
+
+acumular:
+  add  r1, r2
+  call contar                   ;Llamada de cola: pasa a ser jmp contar y el return se elimina
+  return
+
+contar:
+  move r3, [veces]
+  add  r3, 1
+  move [veces], r3
+  return
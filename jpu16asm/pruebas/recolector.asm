@@ -0,0 +1,26 @@
+;Programa de prueba de la recoleccion (make check): la rutina muerta no se usa en ninguna parte y
+;se elimina, mientras que rutina_vector solo se usa a traves de su direccion guardada con word (y
+;se llama por registro), asi que se conserva. Simulado antes y despues de -gc debe terminar en el
+;mismo estado
+
+data
+vector:   word rutina_vector
+resultado: word 0
+
+code
+inicio:
+  move r1, [vector]
+  call r1
+  move [resultado], r2
+  move r1, 0                    ;La direccion de la rutina cambia al recolectar, asi que se borra
+  move [vector], r1             ;para comparar solo el resultado
+fin:
+  jmp  fin
+
+muerta:
+  move r2, 0x0BAD
+  return
+
+rutina_vector:
+  move r2, 0x1234
+  return
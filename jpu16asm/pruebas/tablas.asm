@@ -0,0 +1,23 @@
+;Programa de prueba de los bloques de datos (make check). La tabla de seno debe dar 0, 383, 707,
+;924, 1000, 924, ... -383 (redondeados, los negativos en complemento a 2), incbin debe tomar el
+;byte mas significativo de cada palabra primero (datos.bin tiene 12 34 AB CD y lo genera el
+;makefile) e inchex debe leer datos.hex. Ademas table y fill se usan como nombres comunes fuera
+;del inicio de una sentencia o seguidos de : o equ
+
+fill    equ 2
+
+data
+seno:    table 16, 1000 * sin(2 * pi * i / n)
+binario: incbin "datos.bin"
+hex:     inchex "datos.hex"
+table:   word 0x0101
+         fill fill, 0xFFFF
+
+code
+inicio:
+  move r1, [table+1]
+  move r2, table
+  move r3, [table + fill]
+  move r4, fill
+fin:
+  jmp  fin
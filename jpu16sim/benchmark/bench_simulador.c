@@ -0,0 +1,222 @@
+//+-----------------------------------------------------------------------------------------------+
+//| bench_simulador.c                                                                             |
+//| Prueba de rendimiento del simulador                                                           |
+//|                                                                                               |
+//| Este programa ensambla en memoria (con la libreria del ensamblador) varios programas y los    |
+//| simula con cada forma de ejecutar las instrucciones (interprete, predecodificado y traducido  |
+//| a x86-64), reportando los millones de instrucciones por segundo (MIPS) de cada una y la       |
+//| aceleracion respecto al interprete, tomando la mejor de varias repeticiones. Los programas    |
+//| son:                                                                                          |
+//| - El de simulation_example: un contador que escribe a un puerto en cada vuelta.               |
+//| - Una carga sintetica de larga duracion: CRC-16 bit por bit y multiplicacion con acumulacion  |
+//|   sobre una tabla de 256 palabras en RAM, con llamadas y saltos condicionales.                |
+//| - La misma carga con un dispositivo que reescribe una instruccion del programa en cada vuelta |
+//|   de la tabla (lo que invalida su predecodificacion y su traduccion).                         |
+//| Al terminar cada simulacion se verifica que el estado final (registros, banderas, pila, RAM,  |
+//| ciclos e instrucciones) sea igual con todas las formas de ejecucion.                          |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+#include <stdio.h>                      //Permite imprimir los resultados
+#include <string.h>                     //Permite comparar el estado de los procesadores
+#include <time.h>                       //Permite medir el tiempo transcurrido
+#include "j16asm_libreria.h"            //Importa la interfaz publica del ensamblador
+#include "../j16sim_cpu.h"              //Importa el procesador simulado
+
+#define TAM_PRG 512                     //Capacidad de la memoria de programa
+#define TAM_RAM 1024                    //Capacidad de la memoria RAM
+#define CICLOS 200000000ULL             //Ciclos que se simula cada programa
+#define REPETICIONES 3                  //Cada simulacion se repite varias veces (se toma la mejor)
+#define PUERTO_PARCHE 0x300             //Puerto del dispositivo que reescribe el programa
+#define NUM_MODOS 3                     //Formas de ejecucion que se comparan
+
+//Programa de simulation_example (simulation_example.asm sin comentarios)
+static const char contador_asm[] =
+  "code\n"
+  "  move r0, 0\n"
+  "lazo:\n"
+  "  add r0, 1\n"
+  "  out 0x1234, r0\n"
+  "  jmp lazo\n";
+
+//Carga sintetica: CRC-16 de una tabla en RAM (un bit a la vez) y suma de productos de sus
+//palabras por el CRC parcial. Al terminar cada vuelta escribe el CRC al puerto del parche, cuyo
+//dispositivo (si se usa) cambia el polinomio de la instruccion en la etiqueta polinomio
+static const char sintetico_asm[] =
+  "data\n"
+  "tabla: table 256, i * 97 + 13\n"
+  "code\n"
+  "  move r1, 0xFFFF\n"
+  "inicio:\n"
+  "  move r2, tabla\n"
+  "  move r3, 256\n"
+  "palabra:\n"
+  "  move r4, [r2]\n"
+  "  xor r1, r4\n"
+  "  move r5, 16\n"
+  "bit:\n"
+  "  shr0 r1, 1\n"
+  "  jmpnc sin_polinomio\n"
+  "polinomio:\n"
+  "  xor r1, 0xA001\n"
+  "sin_polinomio:\n"
+  "  sub r5, 1\n"
+  "  jmpnz bit\n"
+  "  move r6, r4\n"
+  "  mul r6, r1\n"
+  "  add r7, r6\n"
+  "  addc r8, 0\n"
+  "  call contar\n"
+  "  add r2, 1\n"
+  "  sub r3, 1\n"
+  "  jmpnz palabra\n"
+  "  move [0x200], r1\n"
+  "  out 0x300, r1\n"
+  "  jmp inicio\n"
+  "contar:\n"
+  "  add r9, 1\n"
+  "  return\n";
+
+//Programa de prueba ya ensamblado
+typedef struct _PROGRAMA {
+  const char *nombre;                   //Nombre que se reporta
+  uint32_t prg[TAM_PRG];                //Imagen de la memoria de programa
+  uint16_t ram[TAM_RAM];                //Imagen de la memoria RAM
+  int dir_parche;                       //Direccion que reescribe el dispositivo (o -1)
+} PROGRAMA;
+
+//Dispositivos del bus: cuentan las escrituras y, si se indico, reescriben una instruccion
+typedef struct _DISPOSITIVOS {
+  uint64_t escrituras;                  //Escrituras al bus
+  int dir_parche;                       //Direccion de la instruccion que se reescribe (o -1)
+} DISPOSITIVOS;
+
+//Declaracion previa de las funciones locales al modulo
+static bool ensamblar(JPU16ASM *ensamblador, PROGRAMA *programa, const char *nombre,
+                      const char *codigo, const char *parche);
+static double simular(const PROGRAMA *programa, MODO_EJECUCION modo, CPU_JPU16 **cpu);
+static void escribir_io(CPU_JPU16 *cpu, uint16_t direccion, uint16_t dato);
+static bool mismo_estado(const CPU_JPU16 *a, const CPU_JPU16 *b);
+static double tiempo_ns();
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+int main() {
+  static const MODO_EJECUCION modos[NUM_MODOS] = {
+    MODO_INTERPRETE, MODO_PREDECODIFICADO, MODO_TRADUCIDO
+  };
+  static PROGRAMA programas[3];
+  CPU_JPU16 *cpu[NUM_MODOS];
+  double t[NUM_MODOS];
+  JPU16ASM *ensamblador;
+  int i, m;
+
+  //Los programas se ensamblan una sola vez
+  ensamblador = jpu16asm_crear(TAM_PRG, TAM_RAM);
+  if (!ensamblar(ensamblador, &programas[0], "simulation_example", contador_asm, NULL) ||
+      !ensamblar(ensamblador, &programas[1], "sintetico", sintetico_asm, NULL) ||
+      !ensamblar(ensamblador, &programas[2], "sintetico + parche", sintetico_asm, "polinomio")) {
+    jpu16asm_destruir(ensamblador);
+    return 1;
+  }
+  jpu16asm_destruir(ensamblador);
+
+  printf("%-20s %12s %16s %12s %10s %10s\n", "programa", "interprete", "predecodificado",
+         "traducido", "acel. pre", "acel. tra");
+  for (i=0; i<3; i++) {
+    for (m=0; m<NUM_MODOS; m++) {
+      t[m] = simular(&programas[i], modos[m], &cpu[m]);
+      if (m && !mismo_estado(cpu[0], cpu[m])) {
+        printf("Error: el estado final de %s difiere entre las formas de ejecucion\n",
+               programas[i].nombre);
+        return 1;
+      }
+    }
+    //Si no se pudo usar el traductor, el procesador cambia al modo predecodificado
+    if (cpu[2]->modo != MODO_TRADUCIDO) printf("Aviso: el traductor no esta disponible\n");
+    printf("%-20s %7.1f MIPS %11.1f MIPS %7.1f MIPS %9.2fx %9.2fx\n", programas[i].nombre,
+           cpu[0]->instrucciones / (t[0] * 1e3), cpu[1]->instrucciones / (t[1] * 1e3),
+           cpu[2]->instrucciones / (t[2] * 1e3), t[0] / t[1], t[0] / t[2]);
+    for (m=0; m<NUM_MODOS; m++) destruir_cpu(cpu[m]);
+  }
+
+  return 0;
+}
+
+//Funcion que ensambla un programa y guarda su imagen de memoria (y la direccion de la etiqueta
+//que reescribe el dispositivo, si se indica)
+static bool ensamblar(JPU16ASM *ensamblador, PROGRAMA *programa, const char *nombre,
+                      const char *codigo, const char *parche) {
+  int i;
+
+  if (!jpu16asm_ensamblar(ensamblador, nombre, codigo, strlen(codigo))) {
+    printf("Error al ensamblar %s\n", nombre);
+    return false;
+  }
+  programa->nombre = nombre;
+  for (i=0; i<TAM_PRG; i++) programa->prg[i] = jpu16asm_leer_prg(ensamblador, i);
+  for (i=0; i<TAM_RAM; i++) programa->ram[i] = jpu16asm_leer_ram(ensamblador, i);
+  programa->dir_parche = -1;
+  if (parche) jpu16asm_buscar_simbolo(ensamblador, parche, &programa->dir_parche);
+  return true;
+}
+
+//Funcion que simula un programa desde el reinicio con la forma de ejecucion indicada. Retorna el
+//mejor tiempo de las repeticiones en milisegundos, y el procesador de la ultima (para comparar
+//su estado final)
+static double simular(const PROGRAMA *programa, MODO_EJECUCION modo, CPU_JPU16 **cpu) {
+  static DISPOSITIVOS dispositivos;
+  double inicio, t, mejor = 0;
+  int repeticion, i;
+
+  for (repeticion=0; repeticion<REPETICIONES; repeticion++) {
+    if (repeticion) destruir_cpu(*cpu);
+    *cpu = crear_cpu(TAM_PRG, TAM_RAM);
+    for (i=0; i<TAM_PRG; i++) escribir_prg(*cpu, i, programa->prg[i]);
+    memcpy((*cpu)->ram, programa->ram, sizeof(programa->ram));
+    dispositivos.escrituras = 0;
+    dispositivos.dir_parche = programa->dir_parche;
+    (*cpu)->bus.escribir = escribir_io;
+    (*cpu)->bus.datos = &dispositivos;
+    (*cpu)->modo = modo;
+
+    inicio = tiempo_ns();
+    ejecutar_cpu(*cpu, CICLOS);
+    t = (tiempo_ns() - inicio) / 1e6;
+    if (!repeticion || t < mejor) mejor = t;
+  }
+  return mejor;
+}
+
+//Funcion que atiende las escrituras al bus: las cuenta y, en el puerto del parche, alterna el
+//literal de la instruccion a reescribir entre 0xA001 y 0x8408
+static void escribir_io(CPU_JPU16 *cpu, uint16_t direccion, uint16_t dato) {
+  DISPOSITIVOS *dispositivos = cpu->bus.datos;
+  uint32_t instr;
+
+  dispositivos->escrituras++;
+  if (direccion == PUERTO_PARCHE && dispositivos->dir_parche >= 0) {
+    instr = cpu->prg[dispositivos->dir_parche];
+    instr = (instr & ~0xFFFF) | ((instr & 0xFFFF) == 0xA001 ? 0x8408 : 0xA001);
+    escribir_prg(cpu, dispositivos->dir_parche, instr);
+  }
+}
+
+//Funcion que compara el estado visible de dos procesadores
+static bool mismo_estado(const CPU_JPU16 *a, const CPU_JPU16 *b) {
+  return !memcmp(a->r, b->r, sizeof(a->r)) && a->c == b->c && a->z == b->z && a->n == b->n &&
+         a->v == b->v && a->i == b->i && a->pc == b->pc && a->sp == b->sp &&
+         !memcmp(a->pila, b->pila, sizeof(a->pila)) && a->ciclos == b->ciclos &&
+         a->instrucciones == b->instrucciones &&
+         !memcmp(a->ram, b->ram, a->tam_ram * sizeof(uint16_t)) &&
+         !memcmp(a->prg, b->prg, a->tam_prg * sizeof(uint32_t));
+}
+
+//Funcion para obtener el tiempo actual en nanosegundos
+static double tiempo_ns() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
@@ -0,0 +1,199 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16sim.c                                                                                      |
+//| Modulo principal del simulador                                                                |
+//|                                                                                               |
+//| Este modulo provee la funcion principal del simulador de linea de comandos. Ensambla el       |
+//| programa en memoria mediante la libreria del ensamblador (libjpu16asm.a), de manera que la    |
+//| imagen de memoria se carga directamente sin pasar por ningun archivo de salida, conecta los   |
+//| dispositivos del bus de I/O, ejecuta la simulacion midiendo su tiempo y reporta el estado     |
+//| final del procesador, y opcionalmente el contenido de la RAM y el perfil de ejecucion (para   |
+//| la opcion -prof del ensamblador).                                                             |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdio.h>                      //Permite manejar archivos
+#include <stdlib.h>                     //Permite invocar malloc y free
+#include <time.h>                       //Permite medir el tiempo de la simulacion
+#include "j16asm_libreria.h"            //Importa la interfaz publica del ensamblador
+#include "j16sim_cpu.h"                 //Importa el procesador simulado
+#include "j16sim_es.h"                  //Importa los dispositivos del bus de I/O
+#include "j16sim_opciones.h"            //Permite interpretar las opciones de simulacion
+#include "j16sim_messages.h"            //Permite enviar mensajes al usuario
+
+//Declaracion previa de las funciones locales al modulo
+static int simular(JPU16ASM *ensamblador, CPU_JPU16 *cpu, DISPOSITIVOS_ES *dispositivos,
+                   const OPCIONES_SIMULACION *opciones);
+static bool ensamblar_programa(JPU16ASM *ensamblador, const char *nombre_archivo);
+static void cargar_programa(CPU_JPU16 *cpu, const JPU16ASM *ensamblador);
+static bool ubicar_paro(CPU_JPU16 *cpu, JPU16ASM *ensamblador, const char *paro);
+static bool guardar_perfil(const CPU_JPU16 *cpu, const char *nombre_archivo);
+static double tiempo_s();
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion principal del programa
+int main(int argc, char *argv[]) {
+  static DISPOSITIVOS_ES dispositivos;  //Dispositivos del bus de I/O (estatico por su tamaño)
+  OPCIONES_SIMULACION opciones;         //Opciones indicadas en la linea de comandos
+  JPU16ASM *ensamblador;                //Ensamblador que genera la imagen de memoria
+  CPU_JPU16 *cpu;                       //Procesador simulado
+  int valor_retorno;
+
+  //Verifica si se invoco el programa sin argumentos
+  if (argc < 2) {
+    msg_sim_lc_ayuda_invocacion();   //De ser asi imprime la ayuda y sale
+    return 0;
+  }
+
+  //Interpreta el archivo de entrada y las opciones que le siguen
+  if (!interpretar_opciones_simulacion(&opciones, &dispositivos, argc - 1, argv + 1))
+    return 1;
+  if (opciones.ram_inicio + opciones.ram_cantidad > opciones.tam_ram) {
+    msg_sim_lc_error_rango_ram(opciones.ram_inicio, opciones.ram_cantidad, opciones.tam_ram);
+    return 1;
+  }
+
+  //El ensamblador y el procesador se crean con las mismas capacidades de memoria
+  ensamblador = jpu16asm_crear(opciones.tam_prg, opciones.tam_ram);
+  cpu = crear_cpu(opciones.tam_prg, opciones.tam_ram);
+  valor_retorno = simular(ensamblador, cpu, &dispositivos, &opciones);
+  destruir_cpu(cpu);
+  jpu16asm_destruir(ensamblador);
+  return valor_retorno;
+}
+
+//Funcion que ensambla el programa, lo carga en el procesador, lo simula y reporta el resultado
+static int simular(JPU16ASM *ensamblador, CPU_JPU16 *cpu, DISPOSITIVOS_ES *dispositivos,
+                   const OPCIONES_SIMULACION *opciones) {
+  MOTIVO_PARO motivo;
+  double inicio, segundos;
+  bool exito = true;
+
+  //El programa se ensambla en memoria y su imagen se copia a las memorias del procesador
+  if (!ensamblar_programa(ensamblador, opciones->nombre_archivo_ent)) return 1;
+  cargar_programa(cpu, ensamblador);
+  msg_sim_programa_cargado(jpu16asm_contar_prg(ensamblador), jpu16asm_contar_ram(ensamblador));
+  if (opciones->paro && !ubicar_paro(cpu, ensamblador, opciones->paro)) return 1;
+
+  //Se conectan los dispositivos (el registro de escrituras se abre solo si se solicito)
+  if (opciones->nombre_archivo_out) {
+    dispositivos->fp_salidas = fopen(opciones->nombre_archivo_out, "w");
+    if (!dispositivos->fp_salidas) {
+      msg_sim_error_crear_archivo(opciones->nombre_archivo_out);
+      return 1;
+    }
+  }
+  conectar_dispositivos(cpu, dispositivos);
+  if (opciones->nombre_archivo_perfil) habilitar_perfil(cpu);
+  if (opciones->interprete) cpu->modo = MODO_INTERPRETE;
+  else if (opciones->traducir) cpu->modo = MODO_TRADUCIDO;
+
+  //Se lleva a cabo la simulacion midiendo su tiempo
+  inicio = tiempo_s();
+  motivo = ejecutar_cpu(cpu, opciones->limite_ciclos);
+  segundos = tiempo_s() - inicio;
+
+  //Se reporta el resultado y se cierran los archivos generados
+  msg_sim_resultado(cpu, motivo, segundos);
+  if (opciones->traducir && cpu->modo == MODO_PREDECODIFICADO) msg_sim_sin_traductor();
+  msg_sim_estado_cpu(cpu);
+  msg_sim_actividad_es(dispositivos);
+  if (opciones->ram_cantidad)
+    msg_sim_contenido_ram(cpu, opciones->ram_inicio, opciones->ram_cantidad);
+
+  if (dispositivos->fp_salidas) {
+    if (fclose(dispositivos->fp_salidas)) {
+      msg_sim_error_escribir_archivo(opciones->nombre_archivo_out);
+      exito = false;
+    }
+    dispositivos->fp_salidas = NULL;
+  }
+  if (opciones->nombre_archivo_perfil && !guardar_perfil(cpu, opciones->nombre_archivo_perfil))
+    exito = false;
+  return exito ? 0 : 1;
+}
+
+//Funcion que lee el programa completo y lo ensambla (los errores los reporta el ensamblador)
+static bool ensamblar_programa(JPU16ASM *ensamblador, const char *nombre_archivo) {
+  FILE *fp_archivo;
+  char *codigo;
+  long tam;
+  bool exito;
+
+  fp_archivo = fopen(nombre_archivo, "rb");
+  if (!fp_archivo) {
+    msg_sim_error_abrir_archivo(nombre_archivo);
+    return false;
+  }
+  fseek(fp_archivo, 0, SEEK_END);
+  tam = ftell(fp_archivo);
+  rewind(fp_archivo);
+  codigo = malloc(tam + 1);
+  if (tam < 0 || fread(codigo, 1, tam, fp_archivo) != (size_t) tam) {
+    msg_sim_error_abrir_archivo(nombre_archivo);
+    fclose(fp_archivo);
+    free(codigo);
+    return false;
+  }
+  fclose(fp_archivo);
+
+  exito = jpu16asm_ensamblar(ensamblador, nombre_archivo, codigo, tam);
+  free(codigo);
+  return exito;
+}
+
+//Funcion que copia la imagen de memoria del ensamblador a las memorias del procesador (las
+//localidades libres quedan en cero, es decir nop en la memoria de programa)
+static void cargar_programa(CPU_JPU16 *cpu, const JPU16ASM *ensamblador) {
+  int i;
+
+  for (i=0; i<cpu->tam_prg; i++) escribir_prg(cpu, i, jpu16asm_leer_prg(ensamblador, i));
+  for (i=0; i<cpu->tam_ram; i++) cpu->ram[i] = jpu16asm_leer_ram(ensamblador, i);
+}
+
+//Funcion que fija la direccion de paro a partir de una etiqueta del programa o de un numero
+static bool ubicar_paro(CPU_JPU16 *cpu, JPU16ASM *ensamblador, const char *paro) {
+  char *fin;
+  int valor;
+
+  if (!jpu16asm_buscar_simbolo(ensamblador, paro, &valor)) {
+    valor = (int) strtol(paro, &fin, 0);
+    if (fin == paro || *fin != '\0') valor = -1;
+  }
+  if (valor < 0 || valor >= cpu->tam_prg) {
+    msg_sim_error_direccion_paro(paro);
+    return false;
+  }
+  cpu->dir_paro = valor;
+  return true;
+}
+
+//Funcion que guarda el perfil de ejecucion con el formato que lee la opcion -prof del
+//ensamblador (una linea por direccion ejecutada)
+static bool guardar_perfil(const CPU_JPU16 *cpu, const char *nombre_archivo) {
+  FILE *fp_perfil;
+  int num_direcciones;
+
+  fp_perfil = fopen(nombre_archivo, "w");
+  if (!fp_perfil) {
+    msg_sim_error_crear_archivo(nombre_archivo);
+    return false;
+  }
+  fprintf(fp_perfil, "; Perfil de ejecucion (%llu ciclos): direccion ejecuciones [tomados]\n",
+          (unsigned long long) cpu->ciclos);
+  num_direcciones = escribir_perfil(cpu, fp_perfil);
+  if (fclose(fp_perfil)) {
+    msg_sim_error_escribir_archivo(nombre_archivo);
+    return false;
+  }
+  msg_sim_perfil_generado(nombre_archivo, num_direcciones);
+  return true;
+}
+
+//Funcion para obtener el tiempo actual en segundos
+static double tiempo_s() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
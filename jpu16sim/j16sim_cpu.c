@@ -0,0 +1,823 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16sim_cpu.c                                                                                  |
+//| Modulo del procesador simulado                                                                |
+//|                                                                                               |
+//| Este modulo simula el juego de instrucciones de JPU16 con exactitud de ciclos, siguiendo la   |
+//| logica de los archivos VHDL del procesador (jpu16src): cada instruccion tarda 2 ciclos de     |
+//| reloj, incluidos los saltos, llamadas y retornos, y una interrupcion ocupa los 2 ciclos de la |
+//| instruccion que aborta. Se modelan los 16 registros, las banderas C, Z, N, V e I con las      |
+//| sombras que guarda una interrupcion y restauran idret/ieret, la pila de llamadas de 32        |
+//| niveles (PilaPC, que da la vuelta al desbordarse), las memorias de programa y RAM y el bus de |
+//| I/O, cuyos dispositivos se conectan mediante funciones (ver el modulo j16sim_es).             |
+//|                                                                                               |
+//| Detalles de la simulacion tomados del hardware:                                               |
+//| - La linea de interrupcion se muestrea al inicio de cada instruccion y solo se atiende con la |
+//|   bandera I activa; la instruccion abortada se repite al retornar, pues la pila guarda su     |
+//|   direccion. Al atenderse se limpia I, las banderas pasan a las sombras y el PC salta a la    |
+//|   ultima direccion de la memoria de programa.                                                 |
+//| - Los codigos sin unidad asignada (11010 y 11011 en los bits 25 a 21) escriben cero en el     |
+//|   registro X, igual que el bus R sin ninguna fuente activa.                                   |
+//| - En los desplazamientos la cantidad de posiciones son los 4 bits bajos del operando, y el    |
+//|   acarreo es el ultimo bit que sale.                                                          |
+//| - Un salto a si mismo (jmp $) es un lazo de espera: si ninguna interrupcion lo puede terminar |
+//|   la simulacion se detiene, y si no se adelanta hasta el siguiente evento del bus sin         |
+//|   ejecutar cada repeticion.                                                                   |
+//|                                                                                               |
+//| Formas de ejecucion:                                                                          |
+//| - Interprete: decodifica cada instruccion con un switch cada vez que la ejecuta. Tambien      |
+//|   lleva el perfil de ejecucion y ejecuta las formas poco comunes en el modo predecodificado.  |
+//| - Predecodificado (por omision): cada instruccion se decodifica una sola vez a una entrada    |
+//|   con la direccion del codigo que la ejecuta (una etiqueta, mediante la extension "labels as  |
+//|   values" de gcc) y sus operandos, y cada instruccion salta directamente al codigo de la      |
+//|   siguiente. Una entrada solo se vuelve a decodificar si se escribe su instruccion            |
+//|   (escribir_prg). Para que el despacho quede al final de cada instruccion, la funcion se      |
+//|   compila sin crossjumping (que lo juntaria en un solo salto indirecto).                      |
+//| - Traducido: los bloques basicos se traducen a codigo x86-64 (modulo j16sim_traductor) y las  |
+//|   instrucciones que no se traducen se ejecutan con el interprete; el bus y las interrupciones |
+//|   se revisan entre bloques.                                                                   |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+#include <stdio.h>                      //Permite escribir el perfil de ejecucion
+#include <stdlib.h>                     //Permite invocar malloc, calloc y free
+#include "j16sim_cpu.h"                 //Cabecera propia
+#include "j16sim_traductor.h"           //Permite traducir los bloques basicos a codigo x86-64
+
+//Instruccion predecodificada: el codigo que la ejecuta y sus operandos ya extraidos
+typedef struct _MICRO_OP {
+  const void *manejador;                //Etiqueta del codigo que ejecuta la instruccion
+  union {
+    const uint16_t *q;                  //Segundo operando (registro Y o el literal de la entrada)
+    const uint8_t *bandera;             //Bandera que evaluan los saltos y llamadas condicionales
+  };
+  struct _MICRO_OP *destino;            //Instruccion destino de un salto o llamada
+  uint16_t literal;                     //Literal o banderas que se modifican
+  uint8_t rx;                           //Registro X
+  uint8_t valor;                        //Valor de la condicion, de las banderas o de la bandera I,
+                                        //u operacion de desplazamiento
+} MICRO_OP;
+
+//Variables locales al modulo
+static const void *sin_decodificar;     //Codigo de las entradas predecodificadas invalidas
+
+//Declaracion previa de las funciones locales al modulo
+static MOTIVO_PARO ejecutar_interprete(CPU_JPU16 *cpu, uint64_t limite_ciclos);
+static inline bool interpretar(CPU_JPU16 *cpu, uint64_t limite_ciclos)
+  __attribute__((always_inline));
+static MOTIVO_PARO ejecutar_predecodificado(CPU_JPU16 *cpu, uint64_t limite_ciclos)
+  __attribute__((optimize("no-crossjumping")));
+static MOTIVO_PARO ejecutar_traducido(CPU_JPU16 *cpu, uint64_t limite_ciclos);
+static void interrumpir(CPU_JPU16 *cpu);
+static bool condicion_valida(const CPU_JPU16 *cpu, uint32_t instr);
+static uint16_t sumar(CPU_JPU16 *cpu, uint16_t a, uint16_t b, uint8_t acarreo, bool resta);
+static uint16_t desplazar(CPU_JPU16 *cpu, uint16_t a, int posiciones, int operacion);
+static bool lazo_infinito(const CPU_JPU16 *cpu);
+static void esperar_evento(CPU_JPU16 *cpu, uint64_t limite_ciclos);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion para crear un procesador con las memorias en cero
+CPU_JPU16 *crear_cpu(int tam_prg, int tam_ram) {
+  CPU_JPU16 *cpu = calloc(1, sizeof(CPU_JPU16));
+
+  cpu->prg = calloc(tam_prg, sizeof(uint32_t));
+  cpu->ram = calloc(tam_ram, sizeof(uint16_t));
+  cpu->tam_prg = tam_prg;
+  cpu->tam_ram = tam_ram;
+  cpu->dir_paro = SIN_DIRECCION;
+  cpu->modo = MODO_PREDECODIFICADO;
+  reiniciar_cpu(cpu);
+  return cpu;
+}
+
+//Funcion para liberar un procesador
+void destruir_cpu(CPU_JPU16 *cpu) {
+  free(cpu->ejecuciones);
+  free(cpu->tomados);
+  free(cpu->predecodificado);
+  if (cpu->traductor) destruir_traductor(cpu->traductor);
+  free(cpu->prg);
+  free(cpu->ram);
+  free(cpu);
+}
+
+//Funcion que lleva el procesador a su estado de encendido. Los registros, la pila y las banderas
+//sombra solo valen cero al configurar la FPGA (la entrada Reset no los limpia), pero se limpian
+//aqui para que cada simulacion inicie igual
+void reiniciar_cpu(CPU_JPU16 *cpu) {
+  int i;
+
+  for (i=0; i<16; i++) cpu->r[i] = 0;
+  for (i=0; i<TAM_PILA_PC; i++) cpu->pila[i] = 0;
+  cpu->c = cpu->z = cpu->n = cpu->v = cpu->i = 0;
+  cpu->sombra_c = cpu->sombra_z = cpu->sombra_n = cpu->sombra_v = 0;
+  cpu->pc = 0;
+  cpu->sp = 0;
+  cpu->linea_int = false;
+  cpu->ciclo_evento = cpu->bus.evento ? 0 : SIN_EVENTO;
+  cpu->ciclos = 0;
+  cpu->instrucciones = 0;
+  cpu->interrupciones = 0;
+}
+
+//Funcion que escribe una instruccion en la memoria de programa. Su entrada predecodificada se
+//marca para decodificarse de nuevo la siguiente vez que se ejecute y los bloques traducidos que
+//la contienen se descartan (el procesador no puede escribir su propia memoria de programa, pero
+//un dispositivo del bus si, p. ej. un cargador)
+void escribir_prg(CPU_JPU16 *cpu, int direccion, uint32_t instr) {
+  cpu->prg[direccion] = instr;
+  if (cpu->predecodificado) cpu->predecodificado[direccion].manejador = sin_decodificar;
+  if (cpu->traductor) invalidar_traduccion(cpu->traductor, direccion);
+}
+
+//Funcion que habilita el conteo de ejecuciones de cada direccion
+void habilitar_perfil(CPU_JPU16 *cpu) {
+  if (!cpu->ejecuciones) cpu->ejecuciones = calloc(cpu->tam_prg, sizeof(uint32_t));
+  if (!cpu->tomados) cpu->tomados = calloc(cpu->tam_prg, sizeof(uint32_t));
+}
+
+//Funcion que escribe una linea por cada direccion ejecutada: "0xdireccion ejecuciones", seguida
+//de las veces que salto en el caso de los saltos condicionales. Retorna la cantidad de lineas
+int escribir_perfil(const CPU_JPU16 *cpu, FILE *fp_perfil) {
+  int num_direcciones = 0;
+  int dir;
+
+  for (dir=0; dir<cpu->tam_prg; dir++) {
+    if (!cpu->ejecuciones[dir]) continue;
+    fprintf(fp_perfil, "0x%04X %lu", dir, (unsigned long) cpu->ejecuciones[dir]);
+    if (CODIGO(cpu->prg[dir]) == OP_JMP_COND)
+      fprintf(fp_perfil, " %lu", (unsigned long) cpu->tomados[dir]);
+    fprintf(fp_perfil, "\n");
+    num_direcciones++;
+  }
+  return num_direcciones;
+}
+
+//Funcion que ejecuta instrucciones hasta alcanzar el limite de ciclos, la direccion de paro (sin
+//contar la instruccion donde inicia) o un lazo del que el programa ya no puede salir. Cada
+//instruccion es atomica: en el hardware sus efectos ocurren a lo largo de sus 2 ciclos, pero
+//ninguna otra instruccion los puede observar a medias
+MOTIVO_PARO ejecutar_cpu(CPU_JPU16 *cpu, uint64_t limite_ciclos) {
+  if (cpu->ejecuciones || cpu->modo == MODO_INTERPRETE)
+    return ejecutar_interprete(cpu, limite_ciclos);
+  if (cpu->modo == MODO_TRADUCIDO) return ejecutar_traducido(cpu, limite_ciclos);
+  return ejecutar_predecodificado(cpu, limite_ciclos);
+}
+
+//Funcion que ejecuta instrucciones decodificando cada una cada vez que se ejecuta
+static MOTIVO_PARO ejecutar_interprete(CPU_JPU16 *cpu, uint64_t limite_ciclos) {
+  const uint64_t inicio = cpu->ciclos;
+
+  while (cpu->ciclos < limite_ciclos) {
+    //Los dispositivos se actualizan al inicio de la instruccion, y la linea de interrupcion se
+    //atiende si la bandera I esta activa (igual que la señal SolInt de la unidad de control)
+    if (cpu->ciclos >= cpu->ciclo_evento) cpu->bus.evento(cpu);
+    if (cpu->linea_int && cpu->i) {
+      interrumpir(cpu);
+      continue;
+    }
+
+    if (cpu->pc == cpu->dir_paro && cpu->ciclos != inicio) return PARO_DIRECCION;
+    if (interpretar(cpu, limite_ciclos)) return PARO_LAZO;
+  }
+
+  return PARO_CICLOS;
+}
+
+//Funcion que decodifica y ejecuta la instruccion del PC (sin revisar el bus ni las
+//interrupciones). Retorna true, sin ejecutarla, si es un salto a si mismo del que el programa ya
+//no puede salir
+static inline bool interpretar(CPU_JPU16 *cpu, uint64_t limite_ciclos) {
+  const int masc_prg = cpu->tam_prg - 1;
+  const int masc_ram = cpu->tam_ram - 1;
+  const int pc = cpu->pc;               //Direccion actual
+  const uint32_t instr = cpu->prg[pc];
+  const int rx = RX(instr);
+  uint16_t q;                           //Segundo operando (literal o registro Y, bus Q)
+  int sig;                              //Direccion siguiente
+
+  //Toma los operandos de la instruccion
+  sig = (pc + 1) & masc_prg;
+  q = (instr & MODO_REGISTRO) ? cpu->r[RY(instr)] : (uint16_t) instr;
+
+  switch (CODIGO(instr)) {
+  case OP_NOP:
+  case OP_NOP_B:
+    break;
+
+  //Las banderas seleccionadas por los bits 20 a 16 (I, V, N, Z y C) toman el valor del bit 21
+  case OP_CLRX:
+  case OP_SETX:
+    if (instr & (1 << 16)) cpu->c = CODIGO(instr) & 1;
+    if (instr & (1 << 17)) cpu->z = CODIGO(instr) & 1;
+    if (instr & (1 << 18)) cpu->n = CODIGO(instr) & 1;
+    if (instr & (1 << 19)) cpu->v = CODIGO(instr) & 1;
+    if (instr & (1 << 20)) cpu->i = CODIGO(instr) & 1;
+    break;
+
+  case OP_TEST:
+    cpu->z = (cpu->r[rx] & q) == 0;
+    cpu->n = (cpu->r[rx] & q) >> 15;
+    break;
+
+  case OP_CMP:
+    sumar(cpu, cpu->r[rx], q, 1, true);
+    break;
+
+  case OP_MOVE_A_RAM:
+    cpu->ram[q & masc_ram] = cpu->r[rx];
+    break;
+
+  case OP_OUT:
+    if (cpu->bus.escribir) cpu->bus.escribir(cpu, q, cpu->r[rx]);
+    break;
+
+  //Saltos y llamadas: el destino es relativo a la instruccion o absoluto (registro Y)
+  case OP_JMP_COND:
+  case OP_CALL_COND:
+    if (!condicion_valida(cpu, instr)) break;
+    if (cpu->tomados && CODIGO(instr) == OP_JMP_COND) cpu->tomados[pc]++;
+    //Continua en el caso siguiente
+  case OP_JMP:
+  case OP_CALL:
+    if (CODIGO(instr) & 0x2) {
+      cpu->sp = (cpu->sp - 1) & (TAM_PILA_PC - 1);
+      cpu->pila[cpu->sp] = sig;
+    }
+    sig = (instr & MODO_REGISTRO) ? q & masc_prg : (pc + (int) instr) & masc_prg;
+    //Un salto a si mismo es un lazo de espera: si nada lo puede terminar se detiene la
+    //simulacion (sin ejecutarlo), y si no se adelanta hasta el siguiente evento del bus
+    if (sig == pc && CODIGO(instr) == OP_JMP) {
+      if (lazo_infinito(cpu)) return true;
+      esperar_evento(cpu, limite_ciclos);
+    }
+    break;
+
+  //Los retornos toman la direccion del tope de la pila; los de interrupcion ademas restauran
+  //las banderas sombra y fijan la bandera I
+  case OP_IDRET:
+  case OP_IERET:
+    cpu->c = cpu->sombra_c;
+    cpu->z = cpu->sombra_z;
+    cpu->n = cpu->sombra_n;
+    cpu->v = cpu->sombra_v;
+    cpu->i = CODIGO(instr) & 1;
+    //Continua en el caso siguiente
+  case OP_RETURN:
+  case OP_RETURN_B:
+    sig = cpu->pila[cpu->sp];
+    cpu->sp = (cpu->sp + 1) & (TAM_PILA_PC - 1);
+    break;
+
+  //Logica binaria y suma/resta
+  case OP_NOT:
+  case OP_OR:
+  case OP_AND:
+  case OP_XOR:
+    switch (CODIGO(instr)) {
+    case OP_NOT: q = ~cpu->r[rx]; break;
+    case OP_OR:  q = cpu->r[rx] | q; break;
+    case OP_AND: q = cpu->r[rx] & q; break;
+    default:     q = cpu->r[rx] ^ q; break;
+    }
+    cpu->r[rx] = q;
+    cpu->z = q == 0;
+    cpu->n = q >> 15;
+    break;
+
+  case OP_ADD:  cpu->r[rx] = sumar(cpu, cpu->r[rx], q, 0, false); break;
+  case OP_ADDC: cpu->r[rx] = sumar(cpu, cpu->r[rx], q, cpu->c, false); break;
+  case OP_SUB:  cpu->r[rx] = sumar(cpu, cpu->r[rx], q, 1, true); break;
+  case OP_SUBB: cpu->r[rx] = sumar(cpu, cpu->r[rx], q, cpu->c, true); break;
+
+  //Multiplicacion: se guarda la parte baja; C es su bit mas significativo, N el del producto
+  //completo y Z se calcula a partir de los operandos
+  case OP_MUL:
+  case OP_SMUL: {
+    uint32_t producto;
+
+    if (CODIGO(instr) == OP_MUL) producto = (uint32_t) cpu->r[rx] * q;
+    else producto = (uint32_t) ((int32_t) (int16_t) cpu->r[rx] * (int16_t) q);
+    cpu->c = (producto >> 15) & 1;
+    cpu->z = cpu->r[rx] == 0 || q == 0;
+    cpu->n = producto >> 31;
+    cpu->r[rx] = (uint16_t) producto;
+    break;
+  }
+
+  case OP_NULA:
+  case OP_NULA_B:
+    cpu->r[rx] = 0;
+    break;
+
+  case OP_DESPLAZAR:
+    cpu->r[rx] = desplazar(cpu, cpu->r[rx], q & 0xF, OPER_DESP(instr));
+    break;
+
+  case OP_MOVE:
+    cpu->r[rx] = q;
+    break;
+
+  case OP_MOVE_DE_RAM:
+    cpu->r[rx] = cpu->ram[q & masc_ram];
+    break;
+
+  case OP_IN:
+    cpu->r[rx] = cpu->bus.leer ? cpu->bus.leer(cpu, q) : 0;
+    break;
+  }
+
+  cpu->ciclos += CICLOS_INSTR;
+  cpu->instrucciones++;
+  if (cpu->ejecuciones) cpu->ejecuciones[pc]++;
+  cpu->pc = sig;
+  return false;
+}
+
+//Funcion que ejecuta instrucciones a partir de la memoria de programa predecodificada: cada
+//entrada tiene la direccion del codigo que ejecuta su instruccion (una etiqueta de esta funcion)
+//y sus operandos ya extraidos, y cada instruccion salta directamente al codigo de la siguiente
+//sin pasar por un switch. El bus, las interrupciones y el limite de ciclos solo se revisan cuando
+//algo los pudo cambiar: al llegar al siguiente evento del bus o al limite, y despues de in, out,
+//las instrucciones que cambian la bandera I y los retornos de interrupcion. Las formas poco
+//comunes (saltos a si mismo, saltos y llamadas condicionales por registro y la direccion de paro)
+//se ejecutan con el interprete
+static MOTIVO_PARO ejecutar_predecodificado(CPU_JPU16 *cpu, uint64_t limite_ciclos) {
+  //Codigo de cada instruccion, segun sus bits 25 a 21 (los casos especiales se eligen al
+  //decodificarla)
+  static const void *const manejadores[32] = {
+    [OP_NOP] = &&op_nop, [OP_NOP_B] = &&op_nop,
+    [OP_CLRX] = &&op_banderas, [OP_SETX] = &&op_banderas,
+    [OP_TEST] = &&op_test, [OP_CMP] = &&op_cmp,
+    [OP_MOVE_A_RAM] = &&op_move_a_ram, [OP_OUT] = &&op_out,
+    [OP_JMP] = &&op_jmp, [OP_JMP_COND] = &&op_jmp_cond,
+    [OP_CALL] = &&op_call, [OP_CALL_COND] = &&op_call_cond,
+    [OP_RETURN] = &&op_return, [OP_RETURN_B] = &&op_return,
+    [OP_IDRET] = &&op_xxret, [OP_IERET] = &&op_xxret,
+    [OP_NOT] = &&op_not, [OP_ADD] = &&op_add, [OP_OR] = &&op_or, [OP_ADDC] = &&op_addc,
+    [OP_AND] = &&op_and, [OP_SUB] = &&op_sub, [OP_XOR] = &&op_xor, [OP_SUBB] = &&op_subb,
+    [OP_MUL] = &&op_mul, [OP_SMUL] = &&op_smul,
+    [OP_NULA] = &&op_nula, [OP_NULA_B] = &&op_nula,
+    [OP_DESPLAZAR] = &&op_desplazar, [OP_MOVE] = &&op_move,
+    [OP_MOVE_DE_RAM] = &&op_move_de_ram, [OP_IN] = &&op_in
+  };
+  const int masc_prg = cpu->tam_prg - 1;
+  const int masc_ram = cpu->tam_ram - 1;
+  const uint64_t inicio = cpu->ciclos;
+  uint16_t *const r = cpu->r;
+  MICRO_OP *ops;                        //Memoria de programa predecodificada
+  MICRO_OP *op;                         //Instruccion actual
+  uint64_t ciclos;                      //Ciclo de inicio de la instruccion actual
+  uint64_t limite_rapido;               //Ciclo hasta donde no hay que revisar el bus
+  uint32_t instr, producto;
+  uint16_t q;
+  int pc;
+
+  //La memoria predecodificada se crea la primera vez con todas las entradas por decodificar (mas
+  //una al final que regresa a la direccion 0), y la direccion de paro se marca en ella (sin la
+  //marca de la direccion anterior)
+  if (!cpu->predecodificado) {
+    cpu->predecodificado = malloc((cpu->tam_prg + 1) * sizeof(MICRO_OP));
+    sin_decodificar = &&decodificar;
+    for (pc=0; pc<cpu->tam_prg; pc++) cpu->predecodificado[pc].manejador = sin_decodificar;
+    cpu->predecodificado[cpu->tam_prg].manejador = &&op_vuelta;
+    cpu->paro_predecodificado = SIN_DIRECCION;
+  }
+  ops = cpu->predecodificado;
+  if (cpu->paro_predecodificado != cpu->dir_paro) {
+    if (cpu->paro_predecodificado != SIN_DIRECCION)
+      ops[cpu->paro_predecodificado].manejador = sin_decodificar;
+    if (cpu->dir_paro != SIN_DIRECCION) ops[cpu->dir_paro].manejador = sin_decodificar;
+    cpu->paro_predecodificado = cpu->dir_paro;
+  }
+
+//Macros para pasar del estado del procesador a las variables locales y viceversa (las
+//instrucciones ejecutadas se cuentan a partir de los ciclos, pues cada una suma 2)
+#define PC_ACTUAL ((int) (op - ops) & masc_prg)
+#define CARGAR_ESTADO()                                             \
+  do {                                                              \
+    op = &ops[cpu->pc];                                             \
+    ciclos = cpu->ciclos;                                           \
+  } while (0)
+#define GUARDAR_ESTADO()                                            \
+  do {                                                              \
+    cpu->instrucciones += (ciclos - cpu->ciclos) / CICLOS_INSTR;    \
+    cpu->ciclos = ciclos;                                           \
+    cpu->pc = PC_ACTUAL;                                            \
+  } while (0)
+
+//Macro que termina una instruccion y salta al codigo de la siguiente (o a revisar el bus y las
+//interrupciones, si se llego al siguiente evento o al limite de ciclos)
+#define DESPACHAR(siguiente)                                        \
+  do {                                                              \
+    ciclos += CICLOS_INSTR;                                         \
+    op = (siguiente);                                               \
+    if (ciclos >= limite_rapido) goto revisar;                      \
+    goto *op->manejador;                                            \
+  } while (0)
+
+//Macro que termina una instruccion que pudo cambiar la linea de interrupcion, la bandera I, los
+//eventos del bus o la memoria de programa
+#define DESPACHAR_Y_REVISAR(siguiente)                              \
+  do {                                                              \
+    ciclos += CICLOS_INSTR;                                         \
+    op = (siguiente);                                               \
+    goto revisar;                                                   \
+  } while (0)
+
+  CARGAR_ESTADO();
+
+  //Revision del limite de ciclos, del bus y de la linea de interrupcion, en el mismo orden que
+  //el interprete
+revisar:
+  GUARDAR_ESTADO();
+  if (ciclos >= limite_ciclos) return PARO_CICLOS;
+  if (ciclos >= cpu->ciclo_evento) cpu->bus.evento(cpu);
+  if (cpu->linea_int && cpu->i) {
+    interrumpir(cpu);
+    CARGAR_ESTADO();
+    goto revisar;
+  }
+  limite_rapido = cpu->ciclo_evento < limite_ciclos ? cpu->ciclo_evento : limite_ciclos;
+  op = &ops[cpu->pc];
+  goto *op->manejador;
+
+  //La entrada despues de la ultima direccion continua en la direccion 0
+op_vuelta:
+  op = ops;
+  goto *op->manejador;
+
+  //Decodificacion de una entrada (la primera vez que se ejecuta, o despues de escribir la
+  //instruccion); al terminar se ejecuta la instruccion
+decodificar:
+  pc = PC_ACTUAL;
+  instr = cpu->prg[pc];
+  op->manejador = manejadores[CODIGO(instr)];
+  op->q = (instr & MODO_REGISTRO) ? &r[RY(instr)] : &op->literal;
+  op->destino = NULL;
+  op->literal = (uint16_t) instr;
+  op->rx = RX(instr);
+  op->valor = 0;
+  switch (CODIGO(instr)) {
+  case OP_CLRX:
+  case OP_SETX:
+    op->literal = (instr >> 16) & 0x1F;
+    op->valor = CODIGO(instr) & 1;
+    if (op->literal & 0x10) op->manejador = &&op_banderas_i;
+    break;
+
+  case OP_JMP:
+    if (instr & MODO_REGISTRO) {
+      op->manejador = &&op_jmp_registro;
+      break;
+    }
+    op->destino = &ops[(pc + (int) instr) & masc_prg];
+    if (op->destino == op) op->manejador = &&op_interpretar;
+    break;
+
+  case OP_JMP_COND:
+  case OP_CALL_COND:
+    op->valor = (instr >> 16) & 1;
+    switch ((instr >> 17) & 0x3) {
+    case 0:  op->bandera = &cpu->c; break;
+    case 1:  op->bandera = &cpu->z; break;
+    case 2:  op->bandera = &cpu->n; break;
+    default: op->bandera = &cpu->v; break;
+    }
+    //Continua en el caso siguiente
+  case OP_CALL:
+    if (instr & MODO_REGISTRO) {
+      op->manejador = CODIGO(instr) == OP_CALL ? &&op_call_registro : &&op_interpretar;
+      break;
+    }
+    op->destino = &ops[(pc + (int) instr) & masc_prg];
+    break;
+
+  case OP_IDRET:
+  case OP_IERET:
+  case OP_DESPLAZAR:
+    op->valor = CODIGO(instr) == OP_DESPLAZAR ? OPER_DESP(instr) : CODIGO(instr) & 1;
+    break;
+  }
+  if (pc == cpu->dir_paro) op->manejador = &&op_paro;
+  goto *op->manejador;
+
+  //Instrucciones que se ejecutan con el interprete
+op_paro:
+  if (ciclos != inicio) {
+    GUARDAR_ESTADO();
+    return PARO_DIRECCION;
+  }
+  //Continua en el caso siguiente
+op_interpretar:
+  GUARDAR_ESTADO();
+  if (interpretar(cpu, limite_ciclos)) return PARO_LAZO;
+  CARGAR_ESTADO();
+  goto revisar;
+
+  //Instrucciones predecodificadas
+op_nop:
+  DESPACHAR(op + 1);
+
+op_banderas:
+  if (op->literal & 0x1) cpu->c = op->valor;
+  if (op->literal & 0x2) cpu->z = op->valor;
+  if (op->literal & 0x4) cpu->n = op->valor;
+  if (op->literal & 0x8) cpu->v = op->valor;
+  DESPACHAR(op + 1);
+
+op_banderas_i:
+  if (op->literal & 0x1) cpu->c = op->valor;
+  if (op->literal & 0x2) cpu->z = op->valor;
+  if (op->literal & 0x4) cpu->n = op->valor;
+  if (op->literal & 0x8) cpu->v = op->valor;
+  cpu->i = op->valor;
+  DESPACHAR_Y_REVISAR(op + 1);
+
+op_test:
+  q = r[op->rx] & *op->q;
+  cpu->z = q == 0;
+  cpu->n = q >> 15;
+  DESPACHAR(op + 1);
+
+op_cmp:
+  sumar(cpu, r[op->rx], *op->q, 1, true);
+  DESPACHAR(op + 1);
+
+op_move_a_ram:
+  cpu->ram[*op->q & masc_ram] = r[op->rx];
+  DESPACHAR(op + 1);
+
+op_out:
+  GUARDAR_ESTADO();
+  if (cpu->bus.escribir) cpu->bus.escribir(cpu, *op->q, r[op->rx]);
+  DESPACHAR_Y_REVISAR(op + 1);
+
+op_jmp:
+  DESPACHAR(op->destino);
+
+op_jmp_registro:
+  if ((*op->q & masc_prg) == PC_ACTUAL) goto op_interpretar;
+  DESPACHAR(&ops[*op->q & masc_prg]);
+
+op_jmp_cond:
+  DESPACHAR(*op->bandera == op->valor ? op->destino : op + 1);
+
+op_call_cond:
+  if (*op->bandera != op->valor) DESPACHAR(op + 1);
+  //Continua en el caso siguiente
+op_call:
+  cpu->sp = (cpu->sp - 1) & (TAM_PILA_PC - 1);
+  cpu->pila[cpu->sp] = (PC_ACTUAL + 1) & masc_prg;
+  DESPACHAR(op->destino);
+
+op_call_registro:
+  cpu->sp = (cpu->sp - 1) & (TAM_PILA_PC - 1);
+  cpu->pila[cpu->sp] = (PC_ACTUAL + 1) & masc_prg;
+  DESPACHAR(&ops[*op->q & masc_prg]);
+
+op_return:
+  q = cpu->pila[cpu->sp];
+  cpu->sp = (cpu->sp + 1) & (TAM_PILA_PC - 1);
+  DESPACHAR(&ops[q]);
+
+op_xxret:
+  cpu->c = cpu->sombra_c;
+  cpu->z = cpu->sombra_z;
+  cpu->n = cpu->sombra_n;
+  cpu->v = cpu->sombra_v;
+  cpu->i = op->valor;
+  q = cpu->pila[cpu->sp];
+  cpu->sp = (cpu->sp + 1) & (TAM_PILA_PC - 1);
+  DESPACHAR_Y_REVISAR(&ops[q]);
+
+op_not:
+  q = ~r[op->rx];
+  goto op_logica;
+op_or:
+  q = r[op->rx] | *op->q;
+  goto op_logica;
+op_and:
+  q = r[op->rx] & *op->q;
+  goto op_logica;
+op_xor:
+  q = r[op->rx] ^ *op->q;
+op_logica:
+  r[op->rx] = q;
+  cpu->z = q == 0;
+  cpu->n = q >> 15;
+  DESPACHAR(op + 1);
+
+op_add:
+  r[op->rx] = sumar(cpu, r[op->rx], *op->q, 0, false);
+  DESPACHAR(op + 1);
+
+op_addc:
+  r[op->rx] = sumar(cpu, r[op->rx], *op->q, cpu->c, false);
+  DESPACHAR(op + 1);
+
+op_sub:
+  r[op->rx] = sumar(cpu, r[op->rx], *op->q, 1, true);
+  DESPACHAR(op + 1);
+
+op_subb:
+  r[op->rx] = sumar(cpu, r[op->rx], *op->q, cpu->c, true);
+  DESPACHAR(op + 1);
+
+op_mul:
+  producto = (uint32_t) r[op->rx] * *op->q;
+  goto op_producto;
+op_smul:
+  producto = (uint32_t) ((int32_t) (int16_t) r[op->rx] * (int16_t) *op->q);
+op_producto:
+  cpu->c = (producto >> 15) & 1;
+  cpu->z = r[op->rx] == 0 || *op->q == 0;
+  cpu->n = producto >> 31;
+  r[op->rx] = (uint16_t) producto;
+  DESPACHAR(op + 1);
+
+op_nula:
+  r[op->rx] = 0;
+  DESPACHAR(op + 1);
+
+op_desplazar:
+  r[op->rx] = desplazar(cpu, r[op->rx], *op->q & 0xF, op->valor);
+  DESPACHAR(op + 1);
+
+op_move:
+  r[op->rx] = *op->q;
+  DESPACHAR(op + 1);
+
+op_move_de_ram:
+  r[op->rx] = cpu->ram[*op->q & masc_ram];
+  DESPACHAR(op + 1);
+
+op_in:
+  GUARDAR_ESTADO();
+  q = cpu->bus.leer ? cpu->bus.leer(cpu, *op->q) : 0;
+  r[op->rx] = q;
+  DESPACHAR_Y_REVISAR(op + 1);
+
+#undef PC_ACTUAL
+#undef CARGAR_ESTADO
+#undef GUARDAR_ESTADO
+#undef DESPACHAR
+#undef DESPACHAR_Y_REVISAR
+}
+
+//Funcion que ejecuta instrucciones con los bloques basicos traducidos a codigo x86-64 (modulo
+//j16sim_traductor). El bus, las interrupciones y la direccion de paro se revisan igual que en el
+//interprete, pero entre bloques: los bloques se ejecutan mientras terminen antes del siguiente
+//evento del bus o del limite, y las instrucciones que no se traducen (o las de un bloque que no
+//termina a tiempo, y las que siguen a un bloque corto) se interpretan. Si no se puede crear el
+//traductor, el modo cambia a predecodificado
+static MOTIVO_PARO ejecutar_traducido(CPU_JPU16 *cpu, uint64_t limite_ciclos) {
+  const uint64_t inicio = cpu->ciclos;
+  uint64_t limite_rapido;               //Ciclo hasta donde no hay que revisar el bus
+  uint64_t hasta;                       //Ciclo hasta donde se interpreta
+  int por_interpretar;                  //Instrucciones a interpretar antes de volver a los bloques
+  MOTIVO_PARO motivo;
+
+  if (!cpu->traductor) cpu->traductor = crear_traductor(cpu);
+  if (!cpu->traductor) {
+    cpu->modo = MODO_PREDECODIFICADO;
+    return ejecutar_predecodificado(cpu, limite_ciclos);
+  }
+
+  while (cpu->ciclos < limite_ciclos) {
+    if (cpu->ciclos >= cpu->ciclo_evento) cpu->bus.evento(cpu);
+    if (cpu->linea_int && cpu->i) {
+      interrumpir(cpu);
+      continue;
+    }
+
+    //La direccion de paro nunca forma parte de un bloque
+    if (cpu->pc == cpu->dir_paro) {
+      if (cpu->ciclos != inicio) return PARO_DIRECCION;
+      por_interpretar = 1;
+    }
+    else {
+      limite_rapido = cpu->ciclo_evento < limite_ciclos ? cpu->ciclo_evento : limite_ciclos;
+      por_interpretar = ejecutar_bloques(cpu->traductor, cpu, limite_rapido);
+      if (!por_interpretar) continue;
+    }
+
+    //Una sola instruccion se interpreta con el limite de la simulacion (un lazo de espera se
+    //adelanta hasta el evento); varias, con el interprete completo (revisa de nuevo el bus y las
+    //interrupciones, y la direccion de paro a partir de la segunda)
+    if (por_interpretar == 1) {
+      if (interpretar(cpu, limite_ciclos)) return PARO_LAZO;
+      continue;
+    }
+    hasta = cpu->ciclos + CICLOS_INSTR * por_interpretar;
+    motivo = ejecutar_interprete(cpu, hasta < limite_ciclos ? hasta : limite_ciclos);
+    if (motivo != PARO_CICLOS) return motivo;
+  }
+
+  return PARO_CICLOS;
+}
+
+//Funcion que atiende una solicitud de interrupcion. La instruccion en curso se aborta (no escribe
+//registros, banderas, memoria ni el bus) y se repite al retornar, pues la pila guarda su propia
+//direccion. Las banderas pasan a las sombras y el PC al vector (la ultima direccion)
+static void interrumpir(CPU_JPU16 *cpu) {
+  uint8_t c = cpu->c, z = cpu->z, n = cpu->n, v = cpu->v;
+
+  //Si la instruccion abortada es idret o ieret, la restauracion de las banderas tiene prioridad
+  //en el registro de banderas y se lleva a cabo de todos modos
+  if (CODIGO(cpu->prg[cpu->pc]) == OP_IDRET || CODIGO(cpu->prg[cpu->pc]) == OP_IERET) {
+    cpu->c = cpu->sombra_c;
+    cpu->z = cpu->sombra_z;
+    cpu->n = cpu->sombra_n;
+    cpu->v = cpu->sombra_v;
+  }
+  cpu->sombra_c = c;
+  cpu->sombra_z = z;
+  cpu->sombra_n = n;
+  cpu->sombra_v = v;
+  cpu->i = 0;
+
+  cpu->sp = (cpu->sp - 1) & (TAM_PILA_PC - 1);
+  cpu->pila[cpu->sp] = cpu->pc;
+  cpu->pc = cpu->tam_prg - 1;
+  cpu->ciclos += CICLOS_INSTR;
+  cpu->interrupciones++;
+}
+
+//Funcion que evalua la condicion de un salto o llamada: la bandera de los bits 18 y 17 (C, Z, N o
+//V) debe ser igual al bit 16
+static bool condicion_valida(const CPU_JPU16 *cpu, uint32_t instr) {
+  uint8_t bandera;
+
+  switch ((instr >> 17) & 0x3) {
+  case 0:  bandera = cpu->c; break;
+  case 1:  bandera = cpu->z; break;
+  case 2:  bandera = cpu->n; break;
+  default: bandera = cpu->v; break;
+  }
+  return bandera == ((instr >> 16) & 1);
+}
+
+//Funcion que realiza una suma o resta (a + b + acarreo, o a + ~b + acarreo) y actualiza todas las
+//banderas de la ALU. En la resta el acarreo vale 1 cuando no hay prestamo
+static uint16_t sumar(CPU_JPU16 *cpu, uint16_t a, uint16_t b, uint8_t acarreo, bool resta) {
+  uint32_t resultado = (uint32_t) a + (uint16_t) (resta ? ~b : b) + acarreo;
+
+  cpu->c = resultado >> 16;
+  cpu->z = (uint16_t) resultado == 0;
+  cpu->n = (resultado >> 15) & 1;
+  //Hay sobreflujo si el resultado cambia de signo respecto al primer operando, cuando los signos
+  //de los operandos son iguales (suma) o distintos (resta)
+  if (resta) cpu->v = (((a ^ b) & (a ^ resultado)) >> 15) & 1;
+  else cpu->v = ((~(a ^ b) & (a ^ resultado)) >> 15) & 1;
+  return (uint16_t) resultado;
+}
+
+//Funcion que realiza un desplazamiento o rotacion y actualiza las banderas C, Z y N. El acarreo
+//es el ultimo bit que sale (sin cambio si no se mueve ninguno); rolc y rorc siempre rotan una
+//posicion a traves del acarreo, pero este se elige igual que en las demas (el ensamblador siempre
+//codifica 1 posicion, de manera que sale el bit 15 o el 0)
+static uint16_t desplazar(CPU_JPU16 *cpu, uint16_t a, int posiciones, int operacion) {
+  uint16_t resultado;
+  uint16_t relleno = (operacion & 1) ? 0xFFFF : 0;
+  int p = posiciones;
+
+  switch (operacion) {
+  case D_SHL0:
+  case D_SHL1: resultado = p ? (a << p) | (relleno >> (16 - p)) : a; break;
+  case D_ROL:  resultado = p ? (a << p) | (a >> (16 - p)) : a; break;
+  case D_ROLC: resultado = (a << 1) | cpu->c; break;
+  case D_SHR0:
+  case D_SHR1: resultado = p ? (a >> p) | (relleno << (16 - p)) : a; break;
+  case D_ROR:  resultado = p ? (a >> p) | (a << (16 - p)) : a; break;
+  default:     resultado = (a >> 1) | (cpu->c << 15); break;
+  }
+
+  if (p) cpu->c = (operacion & 0x4) ? (a >> (p - 1)) & 1 : (a >> (16 - p)) & 1;
+  cpu->z = resultado == 0;
+  cpu->n = resultado >> 15;
+  return resultado;
+}
+
+//Funcion que determina si un salto a si mismo nunca termina: la bandera I esta inactiva, o la
+//linea de interrupcion esta inactiva y el bus no tiene eventos que la puedan cambiar
+static bool lazo_infinito(const CPU_JPU16 *cpu) {
+  return !cpu->i || (!cpu->linea_int && cpu->ciclo_evento == SIN_EVENTO);
+}
+
+//Funcion que adelanta un lazo de espera (salto a si mismo) hasta la ultima repeticion que inicia
+//antes del siguiente evento del bus o del limite de ciclos, como si se hubiera ejecutado cada vez
+//(no se adelanta si es la direccion de paro, pues la simulacion se detiene en la que sigue)
+static void esperar_evento(CPU_JPU16 *cpu, uint64_t limite_ciclos) {
+  uint64_t hasta = cpu->ciclo_evento < limite_ciclos ? cpu->ciclo_evento : limite_ciclos;
+  uint64_t repeticiones;
+
+  //La instruccion actual aun no se cuenta, por lo que se adelantan las repeticiones que terminan
+  //antes del evento menos una
+  if (hasta <= cpu->ciclos + CICLOS_INSTR || cpu->pc == cpu->dir_paro) return;
+  repeticiones = (hasta - cpu->ciclos - 1) / CICLOS_INSTR;
+  cpu->ciclos += repeticiones * CICLOS_INSTR;
+  cpu->instrucciones += repeticiones;
+  if (cpu->ejecuciones) cpu->ejecuciones[cpu->pc] += repeticiones;
+}
@@ -0,0 +1,139 @@
+#ifndef j16sim_cpu_h_Incluida
+#define j16sim_cpu_h_Incluida
+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+#include <stdio.h>                      //Incluye la definicion del tipo FILE
+
+//Constantes exportadas
+//---------------------
+#define TAM_PILA_PC       32            //Niveles de la pila de llamadas (PilaPC)
+#define CICLOS_INSTR      2             //Ciclos de reloj que tarda cada instruccion
+#define SIN_DIRECCION     (-1)          //Indica que no hay direccion de paro
+#define SIN_EVENTO        UINT64_MAX    //Indica que el bus de I/O no tiene eventos pendientes
+
+//Campos de las instrucciones (tambien los usa el traductor a codigo x86-64)
+#define MODO_REGISTRO     (1 << 20)     //Bit que indica que el operando es el registro Y
+#define RX(instr)         (((instr) >> 16) & 0xF)   //Registro X (destino)
+#define RY(instr)         (((instr) >> 12) & 0xF)   //Registro Y (fuente)
+#define CODIGO(instr)     ((instr) >> 21)           //Bits 25 a 21 (grupo de la instruccion)
+#define OPER_DESP(instr)  (((instr) >> 9) & 0x7)    //Operacion de desplazamiento (bits 11 a 9)
+
+//Codigos de las instrucciones (bits 25 a 21)
+enum {
+  OP_NOP = 0x00, OP_NOP_B = 0x01,       //0000x: nop
+  OP_CLRX = 0x02, OP_SETX = 0x03,       //0001v: banderas de los bits 20 a 16 con el valor v
+  OP_TEST = 0x04, OP_CMP = 0x05,        //Pruebas (solo afectan banderas)
+  OP_MOVE_A_RAM = 0x06, OP_OUT = 0x07,  //Escritura a RAM y al bus de I/O
+  OP_JMP = 0x08, OP_JMP_COND = 0x09,    //010lc: saltos y llamadas, l = llamada, c = condicional
+  OP_CALL = 0x0A, OP_CALL_COND = 0x0B,
+  OP_RETURN = 0x0C, OP_RETURN_B = 0x0D, //0110x: return
+  OP_IDRET = 0x0E, OP_IERET = 0x0F,     //0111i: retornos de interrupcion (I toma el valor i)
+  OP_NOT = 0x10, OP_ADD = 0x11, OP_OR = 0x12, OP_ADDC = 0x13,
+  OP_AND = 0x14, OP_SUB = 0x15, OP_XOR = 0x16, OP_SUBB = 0x17,
+  OP_MUL = 0x18, OP_SMUL = 0x19,
+  OP_NULA = 0x1A, OP_NULA_B = 0x1B,     //Sin unidad asignada: el registro X se escribe en cero
+  OP_DESPLAZAR = 0x1C, OP_MOVE = 0x1D, OP_MOVE_DE_RAM = 0x1E, OP_IN = 0x1F
+};
+
+//Operaciones de desplazamiento (bits 11 a 9: direccion, rotacion y relleno)
+enum { D_SHL0, D_SHL1, D_ROL, D_ROLC, D_SHR0, D_SHR1, D_ROR, D_RORC };
+
+//Tipos de datos exportados
+//-------------------------
+//Declaracion previa del estado del procesador (las funciones del bus lo reciben), de las
+//instrucciones predecodificadas (definidas en el modulo del procesador) y del traductor a codigo
+//x86-64 (definido en el modulo j16sim_traductor)
+struct _CPU_JPU16;
+struct _MICRO_OP;
+struct _TRADUCTOR;
+
+//Funciones con las que el procesador accede a los dispositivos del bus de I/O. Al invocarlas, el
+//campo ciclos del procesador tiene el ciclo de inicio de la instruccion in/out (la lectura ocurre
+//en su segundo ciclo y la escritura al final de este)
+typedef uint16_t (*LEER_IO)(struct _CPU_JPU16 *cpu, uint16_t direccion);
+typedef void (*ESCRIBIR_IO)(struct _CPU_JPU16 *cpu, uint16_t direccion, uint16_t dato);
+
+//Funcion que se invoca al inicio de la primera instruccion que empieza en o despues del ciclo del
+//siguiente evento del bus. Los dispositivos la usan para cambiar la linea de interrupcion y deben
+//fijar el ciclo de su siguiente evento (o SIN_EVENTO)
+typedef void (*EVENTO_IO)(struct _CPU_JPU16 *cpu);
+
+//Bus de I/O (los dispositivos se conectan mediante estas funciones; las que valen NULL se
+//comportan como un bus vacio, que se lee en ceros)
+typedef struct _BUS_IO {
+  LEER_IO leer;                         //Lectura de un puerto (instruccion in)
+  ESCRIBIR_IO escribir;                 //Escritura a un puerto (instruccion out)
+  EVENTO_IO evento;                     //Actualizacion de los dispositivos con el tiempo
+  void *datos;                          //Datos de los dispositivos
+} BUS_IO;
+
+//Motivos por los que se detiene una simulacion
+typedef enum _MOTIVO_PARO {
+  PARO_CICLOS,                          //Se alcanzo el limite de ciclos
+  PARO_DIRECCION,                       //Se llego a la direccion de paro
+  PARO_LAZO                             //Salto a si mismo del que ninguna interrupcion lo saca
+} MOTIVO_PARO;
+
+//Formas de ejecutar las instrucciones (todas con el mismo resultado y los mismos ciclos)
+typedef enum _MODO_EJECUCION {
+  MODO_INTERPRETE,                      //Decodifica cada instruccion cada vez que la ejecuta
+  MODO_PREDECODIFICADO,                 //Decodifica cada instruccion una vez (por omision)
+  MODO_TRADUCIDO                        //Traduce los bloques basicos a codigo x86-64
+} MODO_EJECUCION;
+
+//Estado del procesador simulado. Refleja los registros de JPU16.vhd y sus componentes: banco de
+//registros, banderas con sus sombras, contador de programa, pila de llamadas, memorias y la linea
+//de interrupcion ya sincronizada
+typedef struct _CPU_JPU16 {
+  uint16_t r[16];                       //Registros de uso general (RegsR)
+  uint8_t c, z, n, v, i;                //Banderas de acarreo, cero, negativo, sobreflujo e int.
+  uint8_t sombra_c, sombra_z, sombra_n, sombra_v;  //Banderas sombra (restauradas por xxret)
+  uint16_t pc;                          //Contador de programa
+  uint8_t sp;                           //Puntero de la pila de llamadas
+  uint16_t pila[TAM_PILA_PC];           //Pila de llamadas (PilaPC)
+  uint32_t *prg;                        //Memoria de programa (26 bits por instruccion)
+  uint16_t *ram;                        //Memoria RAM
+  int tam_prg;                          //Capacidad de la memoria de programa (potencia de 2)
+  int tam_ram;                          //Capacidad de la memoria RAM (potencia de 2)
+  bool linea_int;                       //Estado de la linea externa de interrupcion (Int)
+  BUS_IO bus;                           //Dispositivos conectados al bus de I/O
+  uint64_t ciclo_evento;                //Ciclo del siguiente evento del bus (o SIN_EVENTO)
+  int dir_paro;                         //Direccion donde se detiene (o SIN_DIRECCION)
+  uint64_t ciclos;                      //Ciclos de reloj transcurridos desde el reinicio
+  uint64_t instrucciones;               //Instrucciones ejecutadas (sin contar las abortadas)
+  uint64_t interrupciones;              //Interrupciones atendidas
+  uint32_t *ejecuciones;                //Ejecuciones de cada direccion (perfil, NULL si no se usa)
+  uint32_t *tomados;                    //Veces que salto cada salto condicional (perfil)
+  MODO_EJECUCION modo;                  //Forma de ejecutar las instrucciones
+  struct _MICRO_OP *predecodificado;    //Memoria de programa predecodificada (NULL si no se usa)
+  int paro_predecodificado;             //Direccion de paro marcada en la predecodificada
+  struct _TRADUCTOR *traductor;         //Bloques traducidos a codigo x86-64 (NULL si no se usa)
+} CPU_JPU16;
+
+//Funciones exportadas
+//--------------------
+//Funciones para crear y liberar un procesador con las capacidades de memoria indicadas
+extern CPU_JPU16 *crear_cpu(int tam_prg, int tam_ram);
+extern void destruir_cpu(CPU_JPU16 *cpu);
+
+//Funcion que reinicia el procesador (registros, banderas, PC y pila en cero; las memorias y el bus
+//se conservan)
+extern void reiniciar_cpu(CPU_JPU16 *cpu);
+
+//Funcion que escribe una instruccion en la memoria de programa (invalida su predecodificacion y
+//su traduccion)
+extern void escribir_prg(CPU_JPU16 *cpu, int direccion, uint32_t instr);
+
+//Funcion que habilita el conteo de ejecuciones de cada direccion (para generar un perfil)
+extern void habilitar_perfil(CPU_JPU16 *cpu);
+
+//Funcion que escribe el perfil de ejecucion (requiere habilitar_perfil antes de ejecutar)
+extern int escribir_perfil(const CPU_JPU16 *cpu, FILE *fp_perfil);
+
+//Funcion que ejecuta instrucciones hasta alcanzar el limite de ciclos o algun otro motivo de paro
+//(con el perfil habilitado siempre se usa el interprete, pues este cuenta cada ejecucion, y si el
+//traductor no se puede usar el modo cambia a predecodificado)
+extern MOTIVO_PARO ejecutar_cpu(CPU_JPU16 *cpu, uint64_t limite_ciclos);
+
+#endif //j16sim_cpu_h_Incluida
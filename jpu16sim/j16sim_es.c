@@ -0,0 +1,70 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16sim_es.c                                                                                   |
+//| Modulo de los dispositivos del bus de I/O                                                     |
+//|                                                                                               |
+//| Este modulo hace las veces de la banca de prueba del procesador (como JPU16_TEST_BENCH.vhd):  |
+//| conecta al bus de I/O unos puertos de entrada con valores fijos (-in), un registro de todas   |
+//| las escrituras con el ciclo en que ocurren (-out) y un generador de interrupciones (-int) que |
+//| sube la linea Int cada cierta cantidad de ciclos y la baja cuando el programa escribe al      |
+//| puerto indicado, como lo haria la rutina de interrupcion al atender a un periferico.          |
+//| Otros dispositivos se pueden simular conectando funciones propias al bus del procesador (ver  |
+//| la estructura BUS_IO en j16sim_cpu.h).                                                        |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+#include <stdio.h>                      //Permite escribir el registro de escrituras
+#include "j16sim_es.h"                  //Cabecera propia
+
+//Declaracion previa de las funciones locales al modulo
+static uint16_t leer_puerto(CPU_JPU16 *cpu, uint16_t direccion);
+static void escribir_puerto(CPU_JPU16 *cpu, uint16_t direccion, uint16_t dato);
+static void generar_interrupcion(CPU_JPU16 *cpu);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion que conecta los dispositivos al bus de I/O del procesador (el generador de interrupciones
+//solo se conecta si tiene un periodo) y reinicia sus contadores
+void conectar_dispositivos(CPU_JPU16 *cpu, DISPOSITIVOS_ES *dispositivos) {
+  cpu->bus.leer = leer_puerto;
+  cpu->bus.escribir = escribir_puerto;
+  cpu->bus.evento = dispositivos->periodo_int ? generar_interrupcion : NULL;
+  cpu->bus.datos = dispositivos;
+  cpu->ciclo_evento = dispositivos->periodo_int ? cpu->ciclos : SIN_EVENTO;
+
+  dispositivos->proxima_int = cpu->ciclos + dispositivos->periodo_int;
+  dispositivos->lecturas = 0;
+  dispositivos->escrituras = 0;
+}
+
+//Funcion que atiende una lectura del bus (el valor del puerto indicado con -in, o cero)
+static uint16_t leer_puerto(CPU_JPU16 *cpu, uint16_t direccion) {
+  DISPOSITIVOS_ES *dispositivos = cpu->bus.datos;
+
+  dispositivos->lecturas++;
+  return dispositivos->entradas[direccion];
+}
+
+//Funcion que atiende una escritura al bus: la registra con su ciclo, y si es al puerto del
+//generador de interrupciones baja la linea de interrupcion
+static void escribir_puerto(CPU_JPU16 *cpu, uint16_t direccion, uint16_t dato) {
+  DISPOSITIVOS_ES *dispositivos = cpu->bus.datos;
+
+  dispositivos->escrituras++;
+  if (dispositivos->fp_salidas)
+    fprintf(dispositivos->fp_salidas, "%llu 0x%04X 0x%04X\n",
+            (unsigned long long) cpu->ciclos, direccion, dato);
+  if (dispositivos->periodo_int && direccion == dispositivos->puerto_int) cpu->linea_int = false;
+}
+
+//Funcion del generador de interrupciones: sube la linea al cumplirse cada periodo (si ya estaba
+//arriba, la solicitud anterior aun no se atiende y ambas se juntan) y programa la siguiente
+static void generar_interrupcion(CPU_JPU16 *cpu) {
+  DISPOSITIVOS_ES *dispositivos = cpu->bus.datos;
+
+  if (cpu->ciclos >= dispositivos->proxima_int) {
+    cpu->linea_int = true;
+    dispositivos->proxima_int = (cpu->ciclos / dispositivos->periodo_int + 1) *
+                                dispositivos->periodo_int;
+  }
+  cpu->ciclo_evento = dispositivos->proxima_int;
+}
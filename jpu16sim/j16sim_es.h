@@ -0,0 +1,31 @@
+#ifndef j16sim_es_h_Incluida
+#define j16sim_es_h_Incluida
+
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+#include <stdio.h>                      //Incluye la definicion del tipo FILE
+#include "j16sim_cpu.h"                 //Incluye la definicion del procesador y su bus de I/O
+
+//Constantes exportadas
+//---------------------
+#define NUM_PUERTOS  65536              //Cantidad de direcciones del bus de I/O
+
+//Tipos de datos exportados
+//-------------------------
+//Dispositivos de la banca de prueba simulada: puertos de entrada con valores fijos, un registro de
+//las escrituras al bus y un generador periodico de interrupciones
+typedef struct _DISPOSITIVOS_ES {
+  uint16_t entradas[NUM_PUERTOS];       //Valor que se lee de cada puerto (cero por omision)
+  FILE *fp_salidas;                     //Archivo donde se registran las escrituras (o NULL)
+  uint64_t periodo_int;                 //Ciclos entre solicitudes de interrupcion (0 si no hay)
+  uint16_t puerto_int;                  //Puerto cuya escritura atiende la solicitud
+  uint64_t proxima_int;                 //Ciclo de la siguiente solicitud de interrupcion
+  uint64_t lecturas;                    //Lecturas del bus (instrucciones in)
+  uint64_t escrituras;                  //Escrituras al bus (instrucciones out)
+} DISPOSITIVOS_ES;
+
+//Funciones exportadas
+//--------------------
+//Funcion que conecta los dispositivos al bus de I/O del procesador
+extern void conectar_dispositivos(CPU_JPU16 *cpu, DISPOSITIVOS_ES *dispositivos);
+
+#endif //j16sim_es_h_Incluida
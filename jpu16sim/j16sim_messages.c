@@ -0,0 +1,153 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16sim_messages.c                                                                             |
+//| Modulo de impresion de mensajes del simulador                                                 |
+//|                                                                                               |
+//| En este modulo se agrupan todas las funciones que imprimen los mensajes del simulador, al     |
+//| igual que en el ensamblador, para facilitar su ubicacion en vista a la posible                |
+//| internacionalizacion del programa.                                                            |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdio.h>                      //Permite invocar la funcion printf
+#include "j16sim_messages.h"            //Cabecera propia
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Mensajes de la linea de comandos
+//--------------------------------
+void msg_sim_lc_ayuda_invocacion() {
+  printf("Forma de uso: jpu16sim codigo_fuente [opciones]\n"
+         "  opciones:\n"
+         "    -p  numero      Especifica la capacidad de la memoria de programa\n"
+         "                    (512 instrucciones por defecto)\n"
+         "    -r  numero      Especifica la capacidad de la memoria RAM\n"
+         "                    (1024 palabras por defecto)\n"
+         "    -c  ciclos      Cantidad maxima de ciclos de reloj a simular\n"
+         "                    (10000000 por defecto)\n"
+         "    -fin etiqueta   Detiene la simulacion al llegar a la etiqueta (o direccion)\n"
+         "    -in puerto valor  Valor que se lee del puerto indicado (los demas puertos\n"
+         "                    se leen en cero). Puede repetirse\n"
+         "    -out archivo    Registra cada escritura al bus de I/O, una por linea:\n"
+         "                    ciclo puerto dato\n"
+         "    -int periodo puerto  Solicita una interrupcion cada periodo ciclos; la\n"
+         "                    solicitud se atiende (baja la linea) al escribir al puerto\n"
+         "    -ram direccion cantidad  Muestra el contenido de la RAM al terminar\n"
+         "    -prof archivo   Genera el perfil de ejecucion (lineas direccion ejecuciones\n"
+         "                    [tomados]) para la opcion -prof del ensamblador\n"
+         "    -interp         Decodifica cada instruccion cada vez que se ejecuta (por\n"
+         "                    defecto se decodifican una sola vez)\n"
+         "    -jit            Traduce los bloques basicos a codigo x86-64 (para las\n"
+         "                    simulaciones largas; sin efecto con -interp o -prof)\n"
+         "  El programa se ensambla en memoria y se simula desde la direccion 0 hasta\n"
+         "  agotar los ciclos, llegar a -fin o encontrar un salto a si mismo del que\n"
+         "  ninguna interrupcion lo puede sacar. Los numeros pueden ser decimales o\n"
+         "  hexadecimales con el prefijo 0x\n");
+}
+
+void msg_sim_lc_error_argumentos_faltantes() {
+  printf("Error: faltan argumentos\n");
+  msg_sim_lc_ayuda_invocacion();
+}
+
+void msg_sim_lc_error_argumento_invalido(const char *argumento) {
+  printf("Error: argumento invalido: %s\n", argumento);
+  msg_sim_lc_ayuda_invocacion();
+}
+
+void msg_sim_lc_error_numero_invalido(const char *argumento) {
+  printf("Error: numero invalido o fuera de rango: %s\n", argumento);
+}
+
+void msg_sim_lc_error_capacidad_ram(int num_pal) {
+  printf("Error: Capacidad de memoria de RAM no valida: %i palabras\n", num_pal);
+  printf("Las cantidades validas son 1024, 2048, 4096, 8192, 16384 y 32768 palabras\n");
+}
+
+void msg_sim_lc_error_capacidad_prg(int num_inst) {
+  printf("Error: Capacidad de memoria de programa no valida: %i instrucciones\n", num_inst);
+  printf("Las cantidades validas son 512, 1024, 2048, 4096, 8192 y 16384 instrucciones\n");
+}
+
+void msg_sim_lc_error_rango_ram(int inicio, int cantidad, int tam_ram) {
+  printf("Error: las %i palabras desde la direccion 0x%04X exceden la RAM (%i palabras)\n",
+         cantidad, inicio, tam_ram);
+}
+
+//Mensajes generados por el modulo principal
+//------------------------------------------
+void msg_sim_error_abrir_archivo(const char *nombre_archivo) {
+  printf("Error: no se pudo abrir el archivo \"%s\"\n", nombre_archivo);
+}
+
+void msg_sim_error_crear_archivo(const char *nombre_archivo) {
+  printf("Error: no se pudo crear el archivo \"%s\"\n", nombre_archivo);
+}
+
+void msg_sim_error_escribir_archivo(const char *nombre_archivo) {
+  printf("Error: no se pudo escribir el archivo \"%s\"\n", nombre_archivo);
+}
+
+void msg_sim_error_direccion_paro(const char *paro) {
+  printf("Error: \"%s\" no es una etiqueta definida ni una direccion de programa valida\n",
+         paro);
+}
+
+void msg_sim_programa_cargado(int num_inst, int num_pal) {
+  printf("Programa cargado: %i instrucciones, %i palabras de RAM inicializadas\n",
+         num_inst, num_pal);
+}
+
+void msg_sim_resultado(const CPU_JPU16 *cpu, MOTIVO_PARO motivo, double segundos) {
+  switch (motivo) {
+  case PARO_CICLOS:
+    printf("Simulacion detenida al alcanzar el limite de ciclos\n");
+    break;
+  case PARO_DIRECCION:
+    printf("Simulacion detenida al llegar a la direccion 0x%04X\n", cpu->pc);
+    break;
+  case PARO_LAZO:
+    printf("Simulacion detenida en un salto a si mismo en la direccion 0x%04X\n", cpu->pc);
+    break;
+  }
+  printf(" - %llu ciclos, %llu instrucciones, %llu interrupciones\n",
+         (unsigned long long) cpu->ciclos, (unsigned long long) cpu->instrucciones,
+         (unsigned long long) cpu->interrupciones);
+  if (segundos > 0)
+    printf(" - %.3f s, %.1f millones de instrucciones por segundo\n",
+           segundos, cpu->instrucciones / segundos / 1e6);
+}
+
+void msg_sim_estado_cpu(const CPU_JPU16 *cpu) {
+  int i;
+
+  for (i=0; i<16; i++)
+    printf("%sr%-2i = 0x%04X%s", i % 4 ? "  " : "", i, cpu->r[i], i % 4 == 3 ? "\n" : "");
+  printf("PC = 0x%04X  SP = %i  C=%i Z=%i N=%i V=%i I=%i  (sombra: C=%i Z=%i N=%i V=%i)\n",
+         cpu->pc, cpu->sp, cpu->c, cpu->z, cpu->n, cpu->v, cpu->i,
+         cpu->sombra_c, cpu->sombra_z, cpu->sombra_n, cpu->sombra_v);
+}
+
+void msg_sim_actividad_es(const DISPOSITIVOS_ES *dispositivos) {
+  printf("Bus de I/O: %llu lecturas, %llu escrituras\n",
+         (unsigned long long) dispositivos->lecturas,
+         (unsigned long long) dispositivos->escrituras);
+}
+
+void msg_sim_contenido_ram(const CPU_JPU16 *cpu, int inicio, int cantidad) {
+  int i;
+
+  for (i=0; i<cantidad; i++) {
+    if (i % 8 == 0) printf("0x%04X:", inicio + i);
+    printf(" 0x%04X", cpu->ram[inicio + i]);
+    if (i % 8 == 7 || i == cantidad - 1) printf("\n");
+  }
+}
+
+void msg_sim_sin_traductor() {
+  printf("Aviso: no se pudo usar el traductor a codigo x86-64; se simulo con las instrucciones "
+         "predecodificadas\n");
+}
+
+void msg_sim_perfil_generado(const char *nombre_archivo, int num_direcciones) {
+  printf("Perfil de ejecucion: %i direcciones ejecutadas (%s)\n", num_direcciones,
+         nombre_archivo);
+}
@@ -0,0 +1,32 @@
+#ifndef j16sim_messages_h_Incluida
+#define j16sim_messages_h_Incluida
+
+#include "j16sim_cpu.h"
+#include "j16sim_es.h"
+
+//Nota: los nombres llevan el prefijo msg_sim_ para no chocar con los mensajes del ensamblador,
+//cuya libreria se enlaza junto con el simulador
+
+//Mensajes de la linea de comandos
+extern void msg_sim_lc_ayuda_invocacion();
+extern void msg_sim_lc_error_argumentos_faltantes();
+extern void msg_sim_lc_error_argumento_invalido(const char *argumento);
+extern void msg_sim_lc_error_numero_invalido(const char *argumento);
+extern void msg_sim_lc_error_capacidad_ram(int num_pal);
+extern void msg_sim_lc_error_capacidad_prg(int num_inst);
+extern void msg_sim_lc_error_rango_ram(int inicio, int cantidad, int tam_ram);
+
+//Mensajes generados por el modulo principal
+extern void msg_sim_error_abrir_archivo(const char *nombre_archivo);
+extern void msg_sim_error_crear_archivo(const char *nombre_archivo);
+extern void msg_sim_error_escribir_archivo(const char *nombre_archivo);
+extern void msg_sim_error_direccion_paro(const char *paro);
+extern void msg_sim_programa_cargado(int num_inst, int num_pal);
+extern void msg_sim_resultado(const CPU_JPU16 *cpu, MOTIVO_PARO motivo, double segundos);
+extern void msg_sim_estado_cpu(const CPU_JPU16 *cpu);
+extern void msg_sim_actividad_es(const DISPOSITIVOS_ES *dispositivos);
+extern void msg_sim_contenido_ram(const CPU_JPU16 *cpu, int inicio, int cantidad);
+extern void msg_sim_sin_traductor();
+extern void msg_sim_perfil_generado(const char *nombre_archivo, int num_direcciones);
+
+#endif //j16sim_messages_h_Incluida
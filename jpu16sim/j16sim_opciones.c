@@ -0,0 +1,157 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16sim_opciones.c                                                                             |
+//| Modulo de interpretacion de las opciones de simulacion                                        |
+//|                                                                                               |
+//| Este modulo interpreta la linea de comandos del simulador: el programa a simular, las         |
+//| capacidades de memoria (las mismas que admite el ensamblador), el limite de ciclos, la        |
+//| direccion de paro, los archivos de salida y la configuracion de los dispositivos del bus de   |
+//| I/O.                                                                                          |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <ctype.h>                      //Permite invocar isxdigit
+#include <stdlib.h>                     //Permite invocar atoi y strtoull
+#include <string.h>                     //Permite manejar cadenas
+#include "j16sim_opciones.h"            //Cabecera propia
+#include "j16sim_messages.h"            //Permite enviar mensajes al usuario
+
+//Declaracion previa de las funciones locales al modulo
+static bool valores_disponibles(int i, int cantidad, int argc);
+static bool leer_numero(const char *texto, unsigned long long maximo, unsigned long long *valor);
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion para interpretar las opciones de una simulacion. El primer argumento es el programa y
+//los demas son opciones seguidas de ninguno, uno o dos valores. Los numeros pueden ser decimales
+//o hexadecimales (con el prefijo 0x). Si hay un error lo reporta y retorna false
+bool interpretar_opciones_simulacion(OPCIONES_SIMULACION *opciones,
+                                     DISPOSITIVOS_ES *dispositivos, int argc, char *argv[]) {
+  unsigned long long valor, valor_2;
+  int i;
+
+  //Todas las opciones inician con su valor por omision (las mismas capacidades que el
+  //ensamblador)
+  memset(opciones, 0, sizeof(OPCIONES_SIMULACION));
+  opciones->nombre_archivo_ent = argv[0];
+  opciones->tam_prg = 512;
+  opciones->tam_ram = 1024;
+  opciones->limite_ciclos = LIMITE_CICLOS_OMISION;
+
+  //Recorre los argumentos (cada opcion consume tambien los valores que le siguen)
+  for (i=1; i<argc; i++) {
+    //Verifica si el argumento es -p
+    if (strcmp(argv[i], "-p") == 0) {
+      if (!valores_disponibles(i, 1, argc)) return false;
+      opciones->tam_prg = atoi(argv[++i]);
+      if (opciones->tam_prg != 512 && opciones->tam_prg != 1024 && opciones->tam_prg != 2048 &&
+          opciones->tam_prg != 4096 && opciones->tam_prg != 8192 && opciones->tam_prg != 16384) {
+        msg_sim_lc_error_capacidad_prg(opciones->tam_prg);
+        return false;
+      }
+    }
+
+    //Verifica si el argumento es -r
+    else if (strcmp(argv[i], "-r") == 0) {
+      if (!valores_disponibles(i, 1, argc)) return false;
+      opciones->tam_ram = atoi(argv[++i]);
+      if (opciones->tam_ram != 1024 && opciones->tam_ram != 2048 && opciones->tam_ram != 4096 &&
+          opciones->tam_ram != 8192 && opciones->tam_ram != 16384 && opciones->tam_ram != 32768) {
+        msg_sim_lc_error_capacidad_ram(opciones->tam_ram);
+        return false;
+      }
+    }
+
+    //Verifica si el argumento es -c (limite de ciclos)
+    else if (strcmp(argv[i], "-c") == 0) {
+      if (!valores_disponibles(i, 1, argc)) return false;
+      if (!leer_numero(argv[++i], UINT64_MAX - 1, &opciones->limite_ciclos)) return false;
+    }
+
+    //Verifica si el argumento es -fin (la etiqueta se busca despues de ensamblar)
+    else if (strcmp(argv[i], "-fin") == 0) {
+      if (!valores_disponibles(i, 1, argc)) return false;
+      opciones->paro = argv[++i];
+    }
+
+    //Verifica si el argumento es -out o -prof
+    else if (strcmp(argv[i], "-out") == 0 || strcmp(argv[i], "-prof") == 0) {
+      if (!valores_disponibles(i, 1, argc)) return false;
+      if (argv[i][1] == 'o') opciones->nombre_archivo_out = argv[++i];
+      else opciones->nombre_archivo_perfil = argv[++i];
+    }
+
+    //Verifica si el argumento es -in (puerto y valor; puede aparecer varias veces)
+    else if (strcmp(argv[i], "-in") == 0) {
+      if (!valores_disponibles(i, 2, argc) || !leer_numero(argv[i+1], 0xFFFF, &valor) ||
+          !leer_numero(argv[i+2], 0xFFFF, &valor_2))
+        return false;
+      dispositivos->entradas[valor] = valor_2;
+      i += 2;
+    }
+
+    //Verifica si el argumento es -int (periodo en ciclos y puerto que atiende la solicitud)
+    else if (strcmp(argv[i], "-int") == 0) {
+      if (!valores_disponibles(i, 2, argc) || !leer_numero(argv[i+1], UINT64_MAX - 1, &valor) ||
+          !leer_numero(argv[i+2], 0xFFFF, &valor_2))
+        return false;
+      if (valor == 0) {
+        msg_sim_lc_error_numero_invalido(argv[i+1]);
+        return false;
+      }
+      dispositivos->periodo_int = valor;
+      dispositivos->puerto_int = valor_2;
+      i += 2;
+    }
+
+    //Verifica si el argumento es -interp
+    else if (strcmp(argv[i], "-interp") == 0)
+      opciones->interprete = true;
+
+    //Verifica si el argumento es -jit
+    else if (strcmp(argv[i], "-jit") == 0)
+      opciones->traducir = true;
+
+    //Verifica si el argumento es -ram (direccion inicial y cantidad de palabras a mostrar)
+    else if (strcmp(argv[i], "-ram") == 0) {
+      if (!valores_disponibles(i, 2, argc) || !leer_numero(argv[i+1], 0xFFFF, &valor) ||
+          !leer_numero(argv[i+2], 0x10000, &valor_2))
+        return false;
+      opciones->ram_inicio = valor;
+      opciones->ram_cantidad = valor_2;
+      i += 2;
+    }
+
+    //Emite un mensaje de error generico para todos los demas argumentos
+    else {
+      msg_sim_lc_error_argumento_invalido(argv[i]);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//Funcion que verifica que a la opcion en la posicion i le sigan la cantidad de valores indicada
+static bool valores_disponibles(int i, int cantidad, int argc) {
+  if (i + cantidad < argc) return true;
+  msg_sim_lc_error_argumentos_faltantes();
+  return false;
+}
+
+//Funcion que interpreta un numero decimal o hexadecimal (0x) que no exceda el maximo indicado
+static bool leer_numero(const char *texto, unsigned long long maximo, unsigned long long *valor) {
+  const char *digitos = texto;
+  int base = 10;
+  char *fin;
+
+  if (texto[0] == '0' && (texto[1] == 'x' || texto[1] == 'X')) {
+    digitos += 2;
+    base = 16;
+  }
+  *valor = strtoull(digitos, &fin, base);
+  if (!isxdigit((unsigned char) *digitos) || *fin != '\0' || *valor > maximo) {
+    msg_sim_lc_error_numero_invalido(texto);
+    return false;
+  }
+  return true;
+}
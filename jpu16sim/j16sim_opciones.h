@@ -0,0 +1,35 @@
+#ifndef j16sim_opciones_h_Incluida
+#define j16sim_opciones_h_Incluida
+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include "j16sim_es.h"                  //Incluye la definicion de los dispositivos de I/O
+
+//Constantes exportadas
+//---------------------
+#define LIMITE_CICLOS_OMISION  10000000ULL  //Ciclos que se simulan si no se indica -c
+
+//Tipos de datos exportados
+//-------------------------
+//Estructura con las opciones de una simulacion tal como se indican en la linea de comandos (los
+//nombres apuntan a los argumentos originales, los cuales deben seguir existiendo)
+typedef struct _OPCIONES_SIMULACION {
+  const char *nombre_archivo_ent;       //Nombre del programa a simular
+  const char *nombre_archivo_out;       //Nombre del registro de escrituras al bus (-out)
+  const char *nombre_archivo_perfil;    //Nombre del perfil de ejecucion (-prof)
+  const char *paro;                     //Etiqueta o direccion donde se detiene (-fin)
+  int tam_prg;                          //Capacidad de la memoria de programa (-p)
+  int tam_ram;                          //Capacidad de la memoria RAM (-r)
+  unsigned long long limite_ciclos;     //Ciclos que se simulan como maximo (-c)
+  int ram_inicio;                       //Primera direccion de RAM que se muestra (-ram)
+  int ram_cantidad;                     //Cantidad de palabras de RAM que se muestran (-ram)
+  bool interprete;                      //Ejecuta sin predecodificar las instrucciones (-interp)
+  bool traducir;                        //Traduce los bloques basicos a codigo x86-64 (-jit)
+} OPCIONES_SIMULACION;
+
+//Funciones exportadas
+//--------------------
+//Funcion que interpreta las opciones (las de -in e -int se guardan en los dispositivos)
+extern bool interpretar_opciones_simulacion(OPCIONES_SIMULACION *opciones,
+                                            DISPOSITIVOS_ES *dispositivos, int argc, char *argv[]);
+
+#endif //j16sim_opciones_h_Incluida
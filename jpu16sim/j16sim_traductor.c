@@ -0,0 +1,1054 @@
+//+-----------------------------------------------------------------------------------------------+
+//| j16sim_traductor.c                                                                            |
+//| Modulo del traductor de bloques basicos a codigo x86-64                                       |
+//|                                                                                               |
+//| Este modulo traduce los bloques basicos del programa simulado a codigo de la PC (x86-64),     |
+//| para las simulaciones largas. Un bloque son las instrucciones desde una direccion hasta un    |
+//| salto, llamada o retorno, o hasta antes de una instruccion que se ejecuta con el interprete   |
+//| del procesador: in, out, las que cambian la bandera I, los retornos de interrupcion, los      |
+//| saltos a si mismo y los saltos y llamadas por registro. Cada bloque se traduce la primera vez |
+//| que se ejecuta, y al terminar continua directamente en el bloque siguiente mediante una tabla |
+//| con el codigo de cada direccion (la cual lleva a la salida mientras el bloque no se traduce o |
+//| si su instruccion se interpreta). Los saltos condicionales que solo saltan 1 o 2 operaciones  |
+//| entre registros no terminan el bloque: se traducen como predicado de esas operaciones (que se |
+//| copian a su registro con cmov), pues un salto que depende de los datos seria un salto de      |
+//| x86-64 mal predicho.                                                                          |
+//|                                                                                               |
+//| Exactitud de la traduccion:                                                                   |
+//| - Ciclos: el codigo lleva un presupuesto de ciclos hasta el siguiente evento del bus o el     |
+//|   limite de la simulacion. Un bloque solo se ejecuta si su ultima instruccion empieza antes   |
+//|   de ese ciclo (si no, las instrucciones se interpretan una por una hasta el evento), y al    |
+//|   terminar suma 2 ciclos por instruccion ejecutada.                                           |
+//| - Interrupciones: dentro de los bloques no hay instrucciones que cambien la linea de          |
+//|   interrupcion ni la bandera I, y los eventos del bus nunca caen a la mitad de un bloque, de  |
+//|   manera que revisarlas entre bloques es igual que hacerlo en cada instruccion.               |
+//| - Banderas: las operaciones de 16 bits de x86-64 dan las mismas banderas que las de JPU16     |
+//|   (salvo los casos que se ajustan en cada instruccion). Se guardan en el estado del           |
+//|   procesador solo las que se usan antes de que otra instruccion del bloque las escriba, y al  |
+//|   final del bloque todas.                                                                     |
+//| - Memoria de programa: al escribirla (escribir_prg) se descartan los bloques que contienen la |
+//|   direccion; esto solo puede ocurrir durante una instruccion que se interpreta (out o in),    |
+//|   fuera del codigo traducido.                                                                 |
+//|                                                                                               |
+//| Los registros de JPU16 que mas aparecen en el programa (hasta 10) residen en registros de     |
+//| x86-64 mientras se ejecuta el codigo traducido; los demas se acceden en la memoria del estado |
+//| del procesador. Si al entrar al codigo traducido desde una direccion se llega casi enseguida  |
+//| a una instruccion que se interpreta (un lazo de I/O), desde esa direccion se interpreta, pues |
+//| entrar costaria mas. La memoria ejecutable se reserva con mmap y al llenarse se vacia. En     |
+//| otras arquitecturas no se crea el traductor y el procesador usa la memoria predecodificada.   |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stddef.h>                     //Permite obtener la posicion de los campos (offsetof)
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+#include <stdlib.h>                     //Permite invocar malloc y free
+#include <string.h>                     //Permite invocar memcpy y memset
+#include <sys/mman.h>                   //Permite reservar memoria ejecutable (mmap)
+#include "j16sim_cpu.h"                 //Importa el procesador simulado
+#include "j16sim_traductor.h"           //Cabecera propia
+
+#if defined(__x86_64__)
+
+#define MAX_INSTR_BLOQUE  64            //Instrucciones que puede tener un bloque
+#define MAX_BYTES_BLOQUE  4096          //Codigo que puede generar un bloque (con mucho margen)
+#define TAM_CODIGO        (4 << 20)     //Memoria para el codigo traducido (al llenarse se vacia)
+#define PRESUPUESTO_MAX   (1ULL << 62)  //Ciclos maximos por ejecucion (caben en un int64_t)
+#define NUM_REG_HOST      10            //Registros de x86-64 para los registros de JPU16
+#define MAX_CONDICIONALES 2             //Instrucciones que puede saltar un salto predicado
+#define MIN_INSTR_ENTRADA 4             //Instrucciones que debe ejecutar una entrada para convenir
+
+//Banderas en el analisis de vida (en el orden de los bits 16 a 19 de clrx y setx)
+#define B_C               0x1
+#define B_Z               0x2
+#define B_N               0x4
+#define B_V               0x8
+#define B_TODAS           0xF
+
+//Registros de x86-64 (con su numero en la codificacion de las instrucciones)
+enum { RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15 };
+
+//Condiciones de x86-64 (para jcc y setcc)
+enum { CC_O = 0x0, CC_C = 0x2, CC_NC = 0x3, CC_Z = 0x4, CC_NZ = 0x5, CC_S = 0x8, CC_GE = 0xD };
+
+//Estado de la traduccion de cada direccion de la memoria de programa. Un bloque corto esta
+//traducido (los demas bloques continuan en el), pero desde el simulador se interpreta
+enum { SIN_TRADUCIR, TRADUCIDA, INTERPRETADA, CORTA };
+
+//Clase de cada instruccion al formar un bloque: se traduce dentro del bloque, lo termina (saltos,
+//llamadas y retornos) o se ejecuta con el interprete (el bloque termina antes de ella)
+enum { CUERPO, TERMINAL, FUERA };
+
+//Papel de cada instruccion en un bloque: normal, salto condicional corto hacia adelante que se
+//traduce como predicado (no termina el bloque) o instruccion que ese salto omite, la cual solo
+//surte efecto si no se salta
+enum { NORMAL, PREDICADO, CONDICIONAL };
+
+//Codigo de entrada: recibe el procesador, el presupuesto de ciclos (los ciclos menos el limite,
+//negativo) y el codigo del primer bloque, y retorna el presupuesto que sobro
+typedef int64_t (*ENTRADA)(CPU_JPU16 *cpu, int64_t presupuesto, const void *bloque);
+
+//Operando r/m de una instruccion de x86-64: un registro o una direccion de memoria
+typedef struct _OPERANDO {
+  int reg;                              //Registro (o -1 si el operando esta en memoria)
+  int base;                             //Registro base de la direccion
+  int indice;                           //Registro indice de la direccion (o -1)
+  int escala;                           //Escala del indice (potencia de 2)
+  int32_t desp;                         //Desplazamiento de la direccion
+} OPERANDO;
+
+//Traductor de bloques basicos. La tabla y el codigo comparten la memoria ejecutable, de manera
+//que el codigo la accede relativa a su propia direccion
+struct _TRADUCTOR {
+  const void **tabla;                   //Codigo del bloque de cada direccion (o el de salida)
+  uint8_t *codigo;                      //Inicio del codigo (despues de la tabla)
+  uint8_t *libre;                       //Siguiente byte libre del codigo
+  size_t tam_memoria;                   //Tamaño de la memoria ejecutable
+  uint8_t *estado;                      //Estado de la traduccion de cada direccion
+  uint8_t *longitud;                    //Instrucciones del bloque traducido de cada direccion
+  ENTRADA entrar;                       //Codigo que entra a los bloques traducidos
+  const void *salir;                    //Codigo que regresa al simulador (PC en EAX)
+  int host[16];                         //Registro de x86-64 de cada registro (o -1: en memoria)
+  const uint32_t *prg;                  //Memoria de programa del procesador
+  int tam_prg;                          //Capacidad de la memoria de programa
+  int masc_prg, masc_ram;               //Mascaras de las direcciones de programa y RAM
+  int dir_paro;                         //Direccion de paro con la que se tradujo
+  bool invalido;                        //Indica que aun no se prepara la traduccion
+  int condicion[4];                     //Condicion de x86-64 que equivale a cada bandera despues
+                                        //de la ultima instruccion traducida (o -1)
+};
+
+//Registros de x86-64 que guardan registros de JPU16 (los demas estan reservados: RAX y RCX son
+//auxiliares, RBX apunta al procesador, R12 a la RAM y R15 lleva el presupuesto de ciclos)
+static const int registros_libres[NUM_REG_HOST] = {
+  RDX, RSI, RDI, RBP, R8, R9, R10, R11, R13, R14
+};
+
+//Extension del codigo de operacion de las operaciones aritmeticas y logicas de x86-64 (81 /n),
+//segun el codigo de la instruccion de JPU16
+static const int8_t extension_alu[32] = {
+  [OP_CMP] = 7, [OP_ADD] = 0, [OP_OR] = 1, [OP_ADDC] = 2,
+  [OP_AND] = 4, [OP_SUB] = 5, [OP_XOR] = 6, [OP_SUBB] = 3
+};
+
+//Extension del codigo de operacion de los desplazamientos de x86-64 (C1 /n)
+static const int8_t extension_desp[8] = {
+  [D_SHL0] = 4, [D_SHL1] = 4, [D_ROL] = 0, [D_SHR0] = 5, [D_SHR1] = 5, [D_ROR] = 1
+};
+
+//Posicion de cada bandera en el estado del procesador (en el orden de los bits de clrx y setx)
+static const int32_t pos_bandera[4] = {
+  offsetof(CPU_JPU16, c), offsetof(CPU_JPU16, z), offsetof(CPU_JPU16, n), offsetof(CPU_JPU16, v)
+};
+
+//Declaracion previa de las funciones locales al modulo
+static void reiniciar_traduccion(TRADUCTOR *traductor, int dir_paro);
+static void asignar_registros(TRADUCTOR *traductor);
+static void generar_entrada(TRADUCTOR *traductor);
+static void traducir_bloque(TRADUCTOR *traductor, int inicio);
+static int buscar_bloque(const TRADUCTOR *traductor, int inicio, bool predicar, uint32_t *instrs,
+                         uint8_t *papel, int *clase, int *pc);
+static int instrucciones_predicables(const TRADUCTOR *traductor, uint32_t instr, int pc,
+                                     int disponibles);
+static bool analizar_banderas(const uint32_t *instrs, const uint8_t *papel, int *guardar,
+                              int num_instr);
+static int clasificar(const TRADUCTOR *traductor, uint32_t instr, int pc);
+static void banderas_instruccion(uint32_t instr, int *escritas, int *leidas);
+static void traducir_instruccion(TRADUCTOR *traductor, uint32_t instr, int guardar);
+static void emitir_predicado(TRADUCTOR *traductor, uint32_t instr);
+static void traducir_condicional(TRADUCTOR *traductor, uint32_t instr);
+static void traducir_final(TRADUCTOR *traductor, uint32_t instr, int pc);
+static void emitir_salto(TRADUCTOR *traductor, int destino);
+static void emitir_apilar(TRADUCTOR *traductor, int direccion);
+static void emitir_retorno(TRADUCTOR *traductor);
+static void emitir_alu(TRADUCTOR *traductor, int extension, OPERANDO destino, uint32_t instr);
+static void emitir_probar(TRADUCTOR *traductor, OPERANDO operando);
+static void emitir_acarreo(TRADUCTOR *traductor, bool invertido);
+static void guardar_banderas(TRADUCTOR *traductor, int banderas, bool prestamo);
+static void fijar_condiciones(TRADUCTOR *traductor, int c, int z, int n, int v);
+static OPERANDO direccion_ram(TRADUCTOR *traductor, uint32_t instr);
+static int fuente_en_registro(TRADUCTOR *traductor, int num, int auxiliar);
+static OPERANDO registro_jpu(const TRADUCTOR *traductor, int num);
+static OPERANDO registro(int reg);
+static OPERANDO memoria(int base, int indice, int escala, int32_t desp);
+static void emitir_instr(TRADUCTOR *traductor, int ancho, int codigo, int reg, OPERANDO rm);
+static void emitir_8(TRADUCTOR *traductor, int valor);
+static void emitir_16(TRADUCTOR *traductor, int valor);
+static void emitir_32(TRADUCTOR *traductor, int32_t valor);
+
+//Macros de los operandos en el estado del procesador (RBX apunta a el)
+#define CAMPO(campo)   memoria(RBX, -1, 1, offsetof(CPU_JPU16, campo))
+#define BANDERA(num)   memoria(RBX, -1, 1, pos_bandera[num])
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+//Funcion para crear el traductor de un procesador. La memoria ejecutable tiene la tabla de
+//bloques seguida del codigo; lo traducido se genera la primera vez que se ejecutan los bloques
+TRADUCTOR *crear_traductor(const CPU_JPU16 *cpu) {
+  const size_t tam_tabla = cpu->tam_prg * sizeof(void *);
+  TRADUCTOR *traductor;
+  void *memoria_ejecutable;
+
+  memoria_ejecutable = mmap(NULL, tam_tabla + TAM_CODIGO, PROT_READ | PROT_WRITE | PROT_EXEC,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memoria_ejecutable == MAP_FAILED) return NULL;
+
+  traductor = malloc(sizeof(TRADUCTOR));
+  traductor->tabla = memoria_ejecutable;
+  traductor->codigo = (uint8_t *) memoria_ejecutable + tam_tabla;
+  traductor->tam_memoria = tam_tabla + TAM_CODIGO;
+  traductor->estado = malloc(cpu->tam_prg);
+  traductor->longitud = malloc(cpu->tam_prg);
+  traductor->prg = cpu->prg;
+  traductor->tam_prg = cpu->tam_prg;
+  traductor->masc_prg = cpu->tam_prg - 1;
+  traductor->masc_ram = cpu->tam_ram - 1;
+  traductor->invalido = true;
+  return traductor;
+}
+
+//Funcion para liberar un traductor
+void destruir_traductor(TRADUCTOR *traductor) {
+  munmap(traductor->tabla, traductor->tam_memoria);
+  free(traductor->estado);
+  free(traductor->longitud);
+  free(traductor);
+}
+
+//Funcion que descarta los bloques traducidos que contienen una direccion: su entrada de la tabla
+//vuelve a la salida, de manera que se traducen de nuevo al ejecutarse (su codigo queda ocupado
+//hasta que se vacia la memoria). Tambien se vuelve a clasificar la instruccion de la direccion
+void invalidar_traduccion(TRADUCTOR *traductor, int direccion) {
+  int distancia, inicio;
+
+  if (traductor->invalido) return;
+  for (distancia=0; distancia<MAX_INSTR_BLOQUE; distancia++) {
+    inicio = (direccion - distancia) & traductor->masc_prg;
+    if ((traductor->estado[inicio] == TRADUCIDA || traductor->estado[inicio] == CORTA) &&
+        traductor->longitud[inicio] > distancia) {
+      traductor->tabla[inicio] = traductor->salir;
+      traductor->estado[inicio] = SIN_TRADUCIR;
+    }
+  }
+  if (traductor->estado[direccion] == INTERPRETADA) traductor->estado[direccion] = SIN_TRADUCIR;
+}
+
+//Funcion que ejecuta bloques traducidos desde el PC. Los ciclos se llevan como un presupuesto
+//negativo (los ciclos menos el limite): cada bloque verifica al inicio que su ultima instruccion
+//empiece antes del limite y al final suma sus ciclos, de manera que ningun evento del bus queda a
+//la mitad de un bloque. Los bloques continuan directamente uno con otro mediante la tabla, hasta
+//llegar a uno sin traducir, a una instruccion que se interpreta o al limite. Si desde el PC se
+//llega a una instruccion que se interpreta casi sin ejecutar nada (p. ej. en un lazo de I/O),
+//entrar cuesta mas que interpretar: el bloque queda marcado como corto y desde el se interpreta
+//lo que equivale a un bloque completo
+int ejecutar_bloques(TRADUCTOR *traductor, CPU_JPU16 *cpu, uint64_t limite_rapido) {
+  const uint64_t ciclos = cpu->ciclos;
+  const int inicio = cpu->pc;
+  int64_t presupuesto;
+
+  if (traductor->invalido || traductor->dir_paro != cpu->dir_paro)
+    reiniciar_traduccion(traductor, cpu->dir_paro);
+  if (traductor->estado[cpu->pc] == SIN_TRADUCIR) traducir_bloque(traductor, cpu->pc);
+  if (traductor->estado[cpu->pc] == CORTA) return MAX_INSTR_BLOQUE;
+  if (traductor->estado[cpu->pc] != TRADUCIDA || limite_rapido <= ciclos) return 1;
+
+  if (limite_rapido - ciclos > PRESUPUESTO_MAX) limite_rapido = ciclos + PRESUPUESTO_MAX;
+  presupuesto = traductor->entrar(cpu, (int64_t) (ciclos - limite_rapido),
+                                  traductor->tabla[cpu->pc]);
+  cpu->ciclos = limite_rapido + presupuesto;
+  cpu->instrucciones += (cpu->ciclos - ciclos) / CICLOS_INSTR;
+  if (traductor->estado[cpu->pc] == INTERPRETADA &&
+      cpu->ciclos - ciclos < CICLOS_INSTR * MIN_INSTR_ENTRADA)
+    traductor->estado[inicio] = CORTA;
+  return cpu->ciclos == ciclos;
+}
+
+//Funcion que descarta todos los bloques: vuelve a elegir los registros que residen en x86-64
+//(segun el programa actual), genera de nuevo el codigo de entrada y salida y deja todas las
+//direcciones sin traducir, con la direccion de paro indicada
+static void reiniciar_traduccion(TRADUCTOR *traductor, int dir_paro) {
+  int pc;
+
+  asignar_registros(traductor);
+  traductor->libre = traductor->codigo;
+  generar_entrada(traductor);
+  for (pc=0; pc<traductor->tam_prg; pc++) traductor->tabla[pc] = traductor->salir;
+  memset(traductor->estado, SIN_TRADUCIR, traductor->tam_prg);
+  traductor->dir_paro = dir_paro;
+  traductor->invalido = false;
+}
+
+//Funcion que asigna los registros libres de x86-64 a los registros de JPU16 que mas aparecen en
+//la memoria de programa (los que no aparecen se quedan en memoria)
+static void asignar_registros(TRADUCTOR *traductor) {
+  int usos[16] = {0};
+  uint32_t instr;
+  int pc, num, i, mayor;
+
+  for (pc=0; pc<traductor->tam_prg; pc++) {
+    instr = traductor->prg[pc];
+    if (CODIGO(instr) < OP_TEST) continue;
+    usos[RX(instr)]++;
+    if (instr & MODO_REGISTRO) usos[RY(instr)]++;
+  }
+
+  for (num=0; num<16; num++) traductor->host[num] = -1;
+  for (i=0; i<NUM_REG_HOST; i++) {
+    mayor = -1;
+    for (num=0; num<16; num++)
+      if (traductor->host[num] < 0 && usos[num] && (mayor < 0 || usos[num] > usos[mayor]))
+        mayor = num;
+    if (mayor < 0) break;
+    traductor->host[mayor] = registros_libres[i];
+  }
+}
+
+//Funcion que genera el codigo de entrada (una funcion de C) y el de salida, al que saltan los
+//bloques para regresar al simulador con el PC siguiente en EAX
+static void generar_entrada(TRADUCTOR *traductor) {
+  static const int preservados[6] = {RBX, RBP, R12, R13, R14, R15};
+  int i, num;
+
+  //Entrada: preserva los registros que usa el codigo traducido (y alinea la pila), carga el
+  //estado y salta al primer bloque
+  traductor->entrar = (ENTRADA) traductor->libre;
+  for (i=0; i<6; i++) {
+    if (preservados[i] & 8) emitir_8(traductor, 0x41);
+    emitir_8(traductor, 0x50 + (preservados[i] & 7));                 //push
+  }
+  emitir_instr(traductor, 64, 0x83, 5, registro(RSP));                 //sub rsp, 8
+  emitir_8(traductor, 8);
+  emitir_instr(traductor, 64, 0x89, RDI, registro(RBX));               //mov rbx, rdi
+  emitir_instr(traductor, 64, 0x89, RSI, registro(R15));               //mov r15, rsi
+  emitir_instr(traductor, 64, 0x89, RDX, registro(RAX));               //mov rax, rdx
+  emitir_instr(traductor, 64, 0x8B, R12, CAMPO(ram));                  //mov r12, [ram]
+  for (num=0; num<16; num++)
+    if (traductor->host[num] >= 0)                                     //movzx host, [r]
+      emitir_instr(traductor, 32, 0x0FB7, traductor->host[num], memoria(RBX, -1, 1, 2 * num));
+  emitir_instr(traductor, 32, 0xFF, 4, registro(RAX));                 //jmp rax
+
+  //Salida: guarda el PC y los registros, y retorna el presupuesto
+  traductor->salir = traductor->libre;
+  emitir_instr(traductor, 16, 0x89, RAX, CAMPO(pc));                   //mov [pc], ax
+  for (num=0; num<16; num++)
+    if (traductor->host[num] >= 0)                                     //mov [r], host
+      emitir_instr(traductor, 16, 0x89, traductor->host[num], memoria(RBX, -1, 1, 2 * num));
+  emitir_instr(traductor, 64, 0x89, R15, registro(RAX));               //mov rax, r15
+  emitir_instr(traductor, 64, 0x83, 0, registro(RSP));                 //add rsp, 8
+  emitir_8(traductor, 8);
+  for (i=5; i>=0; i--) {
+    if (preservados[i] & 8) emitir_8(traductor, 0x41);
+    emitir_8(traductor, 0x58 + (preservados[i] & 7));                 //pop
+  }
+  emitir_8(traductor, 0xC3);                                           //ret
+}
+
+//Funcion que traduce el bloque que inicia en una direccion: las instrucciones hasta un salto,
+//llamada o retorno (incluido), hasta una que se interpreta o la direccion de paro (excluidas) o
+//hasta el maximo de instrucciones. Los saltos condicionales cortos hacia adelante se predican en
+//vez de terminar el bloque, salvo que alguna instruccion que saltan escriba una bandera que se
+//usa despues (entonces se busca de nuevo sin predicar). Si la primera instruccion se interpreta,
+//la direccion queda marcada
+static void traducir_bloque(TRADUCTOR *traductor, int inicio) {
+  uint32_t instrs[MAX_INSTR_BLOQUE];    //Instrucciones del bloque
+  uint8_t papel[MAX_INSTR_BLOQUE];      //Papel de cada instruccion en el bloque
+  int guardar[MAX_INSTR_BLOQUE];        //Banderas de cada instruccion que se usan despues
+  int num_instr, condicionales = 0, clase, pc, k;
+  bool predicar;
+  uint8_t *salida;                      //Posicion del salto a la salida del bloque
+  int32_t relativo;
+
+  for (predicar=true; ; predicar=false) {
+    num_instr = buscar_bloque(traductor, inicio, predicar, instrs, papel, &clase, &pc);
+    if (analizar_banderas(instrs, papel, guardar, num_instr) || !predicar) break;
+  }
+  if (!num_instr) {
+    traductor->estado[inicio] = INTERPRETADA;
+    return;
+  }
+  for (k=0; k<num_instr; k++) condicionales += papel[k] == CONDICIONAL;
+
+  //Si el codigo se llena se vacia por completo
+  if (traductor->libre + MAX_BYTES_BLOQUE > (uint8_t *) traductor->tabla + traductor->tam_memoria)
+    reiniciar_traduccion(traductor, traductor->dir_paro);
+
+  //Al inicio: si la ultima instruccion del camino mas largo no empieza antes del limite
+  //(presupuesto + sus ciclos previos >= 0), sale sin ejecutar nada
+  traductor->tabla[inicio] = traductor->libre;
+  traductor->estado[inicio] = TRADUCIDA;
+  traductor->longitud[inicio] = num_instr;
+  emitir_instr(traductor, 64, 0x81, 7, registro(R15));                 //cmp r15, -ciclos
+  emitir_32(traductor, -CICLOS_INSTR * (num_instr - 1));
+  emitir_8(traductor, 0x0F);                                           //jge salida
+  emitir_8(traductor, 0x80 | CC_GE);
+  salida = traductor->libre;
+  emitir_32(traductor, 0);
+
+  //Cuerpo del bloque y los ciclos de las instrucciones que siempre se ejecutan (con lea, que
+  //conserva las banderas de x86-64 para el salto final); el bloque continua en el destino de la
+  //instruccion final o en la direccion que sigue
+  fijar_condiciones(traductor, -1, -1, -1, -1);
+  for (k=0; k<num_instr-(clase == TERMINAL); k++) {
+    if (papel[k] == PREDICADO) emitir_predicado(traductor, instrs[k]);
+    else if (papel[k] == CONDICIONAL) traducir_condicional(traductor, instrs[k]);
+    else traducir_instruccion(traductor, instrs[k], guardar[k]);
+  }
+  emitir_instr(traductor, 64, 0x8D, R15,                               //lea r15, [r15 + ciclos]
+               memoria(R15, -1, 1, CICLOS_INSTR * (num_instr - condicionales)));
+  if (clase == TERMINAL) traducir_final(traductor, instrs[num_instr - 1], pc);
+  else emitir_salto(traductor, pc);
+
+  //Salida sin ejecutar el bloque
+  relativo = traductor->libre - (salida + 4);
+  memcpy(salida, &relativo, 4);
+  emitir_8(traductor, 0xB8);                                           //mov eax, inicio
+  emitir_32(traductor, inicio);
+  emitir_8(traductor, 0xE9);                                           //jmp salir
+  emitir_32(traductor, (const uint8_t *) traductor->salir - (traductor->libre + 4));
+}
+
+//Funcion que busca las instrucciones de un bloque y el papel de cada una. Retorna cuantas son, y
+//deja la clase de la ultima que se reviso y su direccion
+static int buscar_bloque(const TRADUCTOR *traductor, int inicio, bool predicar, uint32_t *instrs,
+                         uint8_t *papel, int *clase, int *pc) {
+  int num_instr = 0, pendientes = 0;
+
+  *pc = inicio;
+  *clase = CUERPO;
+  while (num_instr < MAX_INSTR_BLOQUE && (!num_instr || *pc != traductor->dir_paro)) {
+    instrs[num_instr] = traductor->prg[*pc];
+    *clase = clasificar(traductor, instrs[num_instr], *pc);
+    if (*clase == FUERA) break;
+    papel[num_instr] = NORMAL;
+    if (pendientes) {
+      papel[num_instr] = CONDICIONAL;
+      pendientes--;
+    }
+    else if (*clase == TERMINAL && predicar) {
+      pendientes = instrucciones_predicables(traductor, instrs[num_instr], *pc,
+                                             MAX_INSTR_BLOQUE - num_instr - 1);
+      if (pendientes) {
+        papel[num_instr] = PREDICADO;
+        *clase = CUERPO;
+      }
+    }
+    num_instr++;
+    if (*clase == TERMINAL) break;
+    *pc = (*pc + 1) & traductor->masc_prg;
+  }
+  return num_instr;
+}
+
+//Funcion que indica cuantas instrucciones salta un salto condicional que se puede predicar (o 0
+//si no se puede): debe saltar hacia adelante a lo mas MAX_CONDICIONALES instrucciones que quepan
+//en el bloque, sin la direccion de paro, y que sean operaciones entre registros de x86-64 o con
+//literal que no leen banderas
+static int instrucciones_predicables(const TRADUCTOR *traductor, uint32_t instr, int pc,
+                                     int disponibles) {
+  const int omitidas = ((int) instr - 1) & traductor->masc_prg;
+  uint32_t omitida;
+  int i, dir;
+
+  if (CODIGO(instr) != OP_JMP_COND || omitidas < 1 || omitidas > MAX_CONDICIONALES ||
+      omitidas > disponibles)
+    return 0;
+  for (i=1; i<=omitidas; i++) {
+    dir = (pc + i) & traductor->masc_prg;
+    omitida = traductor->prg[dir];
+    if (dir == traductor->dir_paro || traductor->host[RX(omitida)] < 0) return 0;
+    switch (CODIGO(omitida)) {
+    case OP_ADD:
+    case OP_SUB:
+    case OP_OR:
+    case OP_AND:
+    case OP_XOR:
+    case OP_MOVE:
+      if ((omitida & MODO_REGISTRO) && traductor->host[RY(omitida)] < 0) return 0;
+      break;
+
+    case OP_NOT:
+    case OP_NULA:
+    case OP_NULA_B:
+      break;
+
+    default:
+      return 0;
+    }
+  }
+  return omitidas;
+}
+
+//Funcion que analiza la vida de las banderas: cada instruccion solo guarda las que alguna
+//instruccion posterior del bloque lee antes de que otra las escriba (al final del bloque todas
+//estan vivas). Las condicionales no cuentan como escritura, pues pueden no ejecutarse; retorna
+//false si alguna escribe una bandera viva
+static bool analizar_banderas(const uint32_t *instrs, const uint8_t *papel, int *guardar,
+                              int num_instr) {
+  int vivas = B_TODAS, escritas, leidas, k;
+  bool valido = true;
+
+  for (k=num_instr-1; k>=0; k--) {
+    banderas_instruccion(instrs[k], &escritas, &leidas);
+    guardar[k] = escritas & vivas;
+    if (papel[k] != CONDICIONAL) vivas &= ~escritas;
+    else if (guardar[k]) valido = false;
+    vivas |= leidas;
+  }
+  return valido;
+}
+
+//Funcion que clasifica una instruccion al formar un bloque. Se interpretan las que pueden cambiar
+//la linea de interrupcion, la bandera I, los eventos del bus o la memoria de programa (in, out,
+//las que cambian I y los retornos de interrupcion), los saltos a si mismo (lazos de espera), los
+//saltos y llamadas por registro y los desplazamientos con la cantidad en un registro (o rolc y
+//rorc con una cantidad distinta de 1, que el ensamblador no genera)
+static int clasificar(const TRADUCTOR *traductor, uint32_t instr, int pc) {
+  switch (CODIGO(instr)) {
+  case OP_CLRX:
+  case OP_SETX:
+    return (instr & (1 << 20)) ? FUERA : CUERPO;
+
+  case OP_OUT:
+  case OP_IN:
+  case OP_IDRET:
+  case OP_IERET:
+    return FUERA;
+
+  case OP_JMP:
+  case OP_JMP_COND:
+  case OP_CALL:
+  case OP_CALL_COND:
+    if (instr & MODO_REGISTRO) return FUERA;
+    if (CODIGO(instr) == OP_JMP && ((pc + (int) instr) & traductor->masc_prg) == pc) return FUERA;
+    return TERMINAL;
+
+  case OP_RETURN:
+  case OP_RETURN_B:
+    return TERMINAL;
+
+  case OP_DESPLAZAR:
+    if (instr & MODO_REGISTRO) return FUERA;
+    if ((OPER_DESP(instr) == D_ROLC || OPER_DESP(instr) == D_RORC) && (instr & 0xF) != 1)
+      return FUERA;
+    return CUERPO;
+
+  default:
+    return CUERPO;
+  }
+}
+
+//Funcion que obtiene las banderas que escribe y las que lee una instruccion traducida
+static void banderas_instruccion(uint32_t instr, int *escritas, int *leidas) {
+  *escritas = *leidas = 0;
+  switch (CODIGO(instr)) {
+  case OP_CLRX:
+  case OP_SETX:
+    *escritas = (instr >> 16) & B_TODAS;
+    break;
+
+  case OP_TEST:
+  case OP_NOT:
+  case OP_OR:
+  case OP_AND:
+  case OP_XOR:
+    *escritas = B_Z | B_N;
+    break;
+
+  case OP_ADDC:
+  case OP_SUBB:
+    *leidas = B_C;
+    //Continua en el caso siguiente
+  case OP_CMP:
+  case OP_ADD:
+  case OP_SUB:
+    *escritas = B_TODAS;
+    break;
+
+  case OP_MUL:
+  case OP_SMUL:
+    *escritas = B_C | B_Z | B_N;
+    break;
+
+  case OP_DESPLAZAR:
+    if (OPER_DESP(instr) == D_ROLC || OPER_DESP(instr) == D_RORC) *leidas = B_C;
+    *escritas = (instr & 0xF) ? B_C | B_Z | B_N : B_Z | B_N;
+    break;
+
+  case OP_JMP_COND:
+  case OP_CALL_COND:
+    *leidas = 1 << ((instr >> 17) & 0x3);
+    break;
+  }
+}
+
+//Funcion que traduce una instruccion del cuerpo de un bloque, guardando solo las banderas
+//indicadas. Las operaciones de x86-64 de 16 bits dan las mismas banderas que las de JPU16, salvo
+//el acarreo de las restas (que en x86-64 indica prestamo) y las que no afectan a Z y N (rotaciones
+//y multiplicacion), para las que se prueba el resultado. Al final se anota que condiciones de
+//x86-64 siguen equivaliendo a las banderas, para que las use la instruccion siguiente
+static void traducir_instruccion(TRADUCTOR *traductor, uint32_t instr, int guardar) {
+  const OPERANDO x = registro_jpu(traductor, RX(instr));
+  const uint16_t literal = (uint16_t) instr;
+  const int oper = OPER_DESP(instr);
+  const int posiciones = instr & 0xF;
+  int b, extension;
+  OPERANDO dir;
+
+  switch (CODIGO(instr)) {
+  case OP_NOP:
+  case OP_NOP_B:
+    break;
+
+  case OP_CLRX:
+  case OP_SETX:
+    for (b=0; b<4; b++) {
+      if (instr & (1 << (16 + b))) traductor->condicion[b] = -1;
+      if (guardar & (1 << b)) {
+        emitir_instr(traductor, 8, 0xC6, 0, BANDERA(b));               //mov [bandera], v
+        emitir_8(traductor, CODIGO(instr) & 1);
+      }
+    }
+    break;
+
+  case OP_TEST:
+    if (instr & MODO_REGISTRO)                                         //test x, y
+      emitir_instr(traductor, 16, 0x85, fuente_en_registro(traductor, RY(instr), RCX), x);
+    else {
+      emitir_instr(traductor, 16, 0xF7, 0, x);                         //test x, literal
+      emitir_16(traductor, literal);
+    }
+    guardar_banderas(traductor, guardar, false);
+    fijar_condiciones(traductor, -1, CC_Z, CC_S, -1);
+    break;
+
+  case OP_NOT:
+    emitir_instr(traductor, 16, 0x83, 6, x);                           //xor x, 0xFFFF
+    emitir_8(traductor, 0xFF);
+    guardar_banderas(traductor, guardar, false);
+    fijar_condiciones(traductor, -1, CC_Z, CC_S, -1);
+    break;
+
+  //Suma, resta y logica: la operacion se hace directamente sobre el registro X (addc y subb
+  //toman antes el acarreo de la bandera C). Las extensiones 3, 5 y 7 son las restas, y 1, 4 y 6
+  //la logica (que no afecta a C ni a V)
+  case OP_ADDC:
+  case OP_SUBB:
+  case OP_CMP:
+  case OP_ADD:
+  case OP_SUB:
+  case OP_OR:
+  case OP_AND:
+  case OP_XOR:
+    extension = extension_alu[CODIGO(instr)];
+    emitir_alu(traductor, extension, x, instr);
+    if (extension == 1 || extension == 4 || extension == 6) {
+      guardar_banderas(traductor, guardar, false);
+      fijar_condiciones(traductor, -1, CC_Z, CC_S, -1);
+    }
+    else if (extension == 3 || extension == 5 || extension == 7) {
+      guardar_banderas(traductor, guardar, true);
+      fijar_condiciones(traductor, CC_NC, CC_Z, CC_S, CC_O);
+    }
+    else {
+      guardar_banderas(traductor, guardar, false);
+      fijar_condiciones(traductor, CC_C, CC_Z, CC_S, CC_O);
+    }
+    break;
+
+  //Multiplicacion: el producto completo de 32 bits da N (bit 31), C (bit 15) y Z (es cero solo si
+  //alguno de los operandos lo es)
+  case OP_MUL:
+  case OP_SMUL:
+    extension = CODIGO(instr) == OP_MUL ? 0x0FB7 : 0x0FBF;           //movzx o movsx
+    emitir_instr(traductor, 32, extension, RAX, x);
+    if (instr & MODO_REGISTRO)
+      emitir_instr(traductor, 32, extension, RCX, registro_jpu(traductor, RY(instr)));
+    else {
+      emitir_8(traductor, 0xB9);                                       //mov ecx, literal
+      emitir_32(traductor, CODIGO(instr) == OP_MUL ? literal : (int16_t) literal);
+    }
+    emitir_instr(traductor, 32, 0x0FAF, RAX, registro(RCX));           //imul eax, ecx
+    fijar_condiciones(traductor, -1, -1, -1, -1);
+    if (guardar & B_C) {
+      emitir_instr(traductor, 32, 0x0FBA, 4, registro(RAX));           //bt eax, 15
+      emitir_8(traductor, 15);
+      guardar_banderas(traductor, B_C, false);
+      fijar_condiciones(traductor, CC_C, -1, -1, -1);
+    }
+    if (guardar & (B_Z | B_N)) {
+      emitir_instr(traductor, 32, 0x85, RAX, registro(RAX));           //test eax, eax
+      guardar_banderas(traductor, guardar & (B_Z | B_N), false);
+      fijar_condiciones(traductor, -1, CC_Z, CC_S, -1);
+    }
+    emitir_instr(traductor, 16, 0x89, RAX, x);                         //mov x, ax
+    break;
+
+  case OP_NULA:
+  case OP_NULA_B:
+    emitir_instr(traductor, 16, 0xC7, 0, x);                           //mov x, 0
+    emitir_16(traductor, 0);
+    break;
+
+  //Desplazamientos con la cantidad en el literal. El acarreo de x86-64 es el ultimo bit que sale
+  //(o el que entra a C en rcl y rcr); el relleno con unos se agrega despues con un or
+  case OP_DESPLAZAR:
+    if (oper == D_ROLC || oper == D_RORC) {
+      emitir_acarreo(traductor, false);
+      emitir_instr(traductor, 16, 0xD1, oper == D_ROLC ? 2 : 3, x);    //rcl o rcr x, 1
+    }
+    else if (posiciones) {
+      emitir_instr(traductor, 16, 0xC1, extension_desp[oper], x);      //shl, shr, rol o ror
+      emitir_8(traductor, posiciones);
+    }
+    if (posiciones) guardar_banderas(traductor, guardar & B_C, false);
+    if (posiciones && (oper == D_SHL1 || oper == D_SHR1)) {
+      emitir_instr(traductor, 16, 0x81, 1, x);                         //or x, relleno
+      emitir_16(traductor, oper == D_SHL1 ? 0xFFFF >> (16 - posiciones)
+                                         : 0xFFFF << (16 - posiciones));
+    }
+    else if (!posiciones || oper == D_ROL || oper == D_ROR || oper == D_ROLC || oper == D_RORC)
+      emitir_probar(traductor, x);
+    guardar_banderas(traductor, guardar & (B_Z | B_N), false);
+    if (posiciones && (oper == D_SHL0 || oper == D_SHR0))
+      fijar_condiciones(traductor, CC_C, CC_Z, CC_S, -1);
+    else fijar_condiciones(traductor, -1, CC_Z, CC_S, -1);
+    break;
+
+  case OP_MOVE:
+    if (!(instr & MODO_REGISTRO)) {
+      emitir_instr(traductor, 16, 0xC7, 0, x);                         //mov x, literal
+      emitir_16(traductor, literal);
+    }
+    else if (RY(instr) != RX(instr))                                   //mov x, y
+      emitir_instr(traductor, 16, 0x89, fuente_en_registro(traductor, RY(instr), RCX), x);
+    break;
+
+  case OP_MOVE_A_RAM:
+    dir = direccion_ram(traductor, instr);
+    emitir_instr(traductor, 16, 0x89, fuente_en_registro(traductor, RX(instr), RAX), dir);
+    break;
+
+  case OP_MOVE_DE_RAM:
+    dir = direccion_ram(traductor, instr);
+    if (x.reg >= 0) emitir_instr(traductor, 16, 0x8B, x.reg, dir);     //mov x, [dir]
+    else {
+      emitir_instr(traductor, 32, 0x0FB7, RAX, dir);                   //movzx eax, [dir]
+      emitir_instr(traductor, 16, 0x89, RAX, x);                       //mov x, ax
+    }
+    break;
+  }
+}
+
+//Funcion que traduce un salto condicional predicado: en vez de saltar, deja CL en 1 si las
+//instrucciones que salta se ejecutan (la condicion no se cumple) y suma sus ciclos solo en ese
+//caso. Asi un salto que depende de los datos no se vuelve un salto de x86-64 mal predicho
+static void emitir_predicado(TRADUCTOR *traductor, uint32_t instr) {
+  const int omitidas = ((int) instr - 1) & traductor->masc_prg;
+  const int bandera = (instr >> 17) & 0x3, valor = (instr >> 16) & 1;
+  int condicion = traductor->condicion[bandera];
+
+  if (condicion >= 0) condicion = valor ? condicion ^ 1 : condicion;
+  else {
+    emitir_instr(traductor, 8, 0x80, 7, BANDERA(bandera));            //cmp [bandera], valor
+    emitir_8(traductor, valor);
+    condicion = CC_NZ;
+  }
+  emitir_instr(traductor, 8, 0x0F90 | condicion, 0, registro(RCX));    //setcc cl
+  emitir_instr(traductor, 32, 0x0FB6, RCX, registro(RCX));             //movzx ecx, cl
+  emitir_instr(traductor, 64, 0x8D, R15,                               //lea r15, [r15 + rcx*2n]
+               memoria(R15, RCX, CICLOS_INSTR * omitidas, 0));
+}
+
+//Funcion que traduce una instruccion condicional (se ejecuta si CL vale 1): el resultado se
+//calcula en EAX y se copia al registro X con cmov. Sus banderas no se guardan, pues no se usan
+static void traducir_condicional(TRADUCTOR *traductor, uint32_t instr) {
+  const int x = traductor->host[RX(instr)];
+  int resultado = RAX;
+
+  switch (CODIGO(instr)) {
+  case OP_NULA:
+  case OP_NULA_B:
+    emitir_instr(traductor, 32, 0x31, RAX, registro(RAX));             //xor eax, eax
+    break;
+
+  case OP_MOVE:
+    if (instr & MODO_REGISTRO) resultado = traductor->host[RY(instr)];
+    else {
+      emitir_8(traductor, 0xB8);                                       //mov eax, literal
+      emitir_32(traductor, (uint16_t) instr);
+    }
+    break;
+
+  case OP_NOT:
+    emitir_instr(traductor, 32, 0x89, x, registro(RAX));               //mov eax, x
+    emitir_instr(traductor, 16, 0x83, 6, registro(RAX));               //xor ax, 0xFFFF
+    emitir_8(traductor, 0xFF);
+    break;
+
+  default:
+    emitir_instr(traductor, 32, 0x89, x, registro(RAX));               //mov eax, x
+    emitir_alu(traductor, extension_alu[CODIGO(instr)], registro(RAX), instr);
+    break;
+  }
+  emitir_instr(traductor, 8, 0x84, RCX, registro(RCX));                //test cl, cl
+  emitir_instr(traductor, 16, 0x0F45, x, registro(resultado));         //cmovnz x, resultado
+  fijar_condiciones(traductor, -1, -1, -1, -1);
+}
+
+//Funcion que traduce la instruccion que termina un bloque (salto, llamada o retorno)
+static void traducir_final(TRADUCTOR *traductor, uint32_t instr, int pc) {
+  const int sig = (pc + 1) & traductor->masc_prg;
+  const int destino = (pc + (int) instr) & traductor->masc_prg;
+  const int bandera = (instr >> 17) & 0x3, valor = (instr >> 16) & 1;
+  uint8_t *omitir;                      //Posicion del salto condicional (relativo de 8 bits)
+  int condicion;
+
+  switch (CODIGO(instr)) {
+  case OP_JMP:
+    emitir_salto(traductor, destino);
+    break;
+
+  case OP_CALL:
+    emitir_apilar(traductor, sig);
+    emitir_salto(traductor, destino);
+    break;
+
+  //Condicionales: si la bandera no tiene el valor de la condicion se sigue de largo. Si la
+  //instruccion anterior dejo la bandera en las de x86-64 se usan estas directamente
+  case OP_JMP_COND:
+  case OP_CALL_COND:
+    condicion = traductor->condicion[bandera];
+    if (condicion >= 0)                                                //jcc omitir
+      emitir_8(traductor, 0x70 | (valor ? condicion ^ 1 : condicion));
+    else {
+      emitir_instr(traductor, 8, 0x80, 7, BANDERA(bandera));          //cmp [bandera], valor
+      emitir_8(traductor, valor);
+      emitir_8(traductor, 0x70 | CC_NZ);                               //jne omitir
+    }
+    omitir = traductor->libre;
+    emitir_8(traductor, 0);
+    if (CODIGO(instr) == OP_CALL_COND) emitir_apilar(traductor, sig);
+    emitir_salto(traductor, destino);
+    *omitir = traductor->libre - (omitir + 1);
+    emitir_salto(traductor, sig);
+    break;
+
+  default:
+    emitir_retorno(traductor);
+    break;
+  }
+}
+
+//Funcion que emite la continuacion a una direccion constante: el bloque de esa direccion, o la
+//salida si aun no se traduce o se interpreta (por eso la direccion tambien va en EAX)
+static void emitir_salto(TRADUCTOR *traductor, int destino) {
+  emitir_8(traductor, 0xB8);                                           //mov eax, destino
+  emitir_32(traductor, destino);
+  emitir_8(traductor, 0xFF);                                           //jmp [rip + tabla]
+  emitir_8(traductor, 0x25);
+  emitir_32(traductor, (uint8_t *) &traductor->tabla[destino] - (traductor->libre + 4));
+}
+
+//Funcion que emite la escritura de una direccion en la pila de llamadas (la pila crece hacia
+//abajo y da la vuelta)
+static void emitir_apilar(TRADUCTOR *traductor, int direccion) {
+  emitir_instr(traductor, 32, 0x0FB6, RCX, CAMPO(sp));                 //movzx ecx, [sp]
+  emitir_instr(traductor, 32, 0x83, 5, registro(RCX));                 //sub ecx, 1
+  emitir_8(traductor, 1);
+  emitir_instr(traductor, 32, 0x83, 4, registro(RCX));                 //and ecx, 31
+  emitir_8(traductor, TAM_PILA_PC - 1);
+  emitir_instr(traductor, 8, 0x88, RCX, CAMPO(sp));                    //mov [sp], cl
+  emitir_instr(traductor, 16, 0xC7, 0,                                 //mov [pila + rcx*2], dir
+               memoria(RBX, RCX, 2, offsetof(CPU_JPU16, pila)));
+  emitir_16(traductor, direccion);
+}
+
+//Funcion que emite un retorno: toma la direccion del tope de la pila y continua en su bloque
+static void emitir_retorno(TRADUCTOR *traductor) {
+  emitir_instr(traductor, 32, 0x0FB6, RCX, CAMPO(sp));                 //movzx ecx, [sp]
+  emitir_instr(traductor, 32, 0x0FB7, RAX,                             //movzx eax, [pila + rcx*2]
+               memoria(RBX, RCX, 2, offsetof(CPU_JPU16, pila)));
+  emitir_instr(traductor, 32, 0x83, 0, registro(RCX));                 //add ecx, 1
+  emitir_8(traductor, 1);
+  emitir_instr(traductor, 32, 0x83, 4, registro(RCX));                 //and ecx, 31
+  emitir_8(traductor, TAM_PILA_PC - 1);
+  emitir_instr(traductor, 8, 0x88, RCX, CAMPO(sp));                    //mov [sp], cl
+  emitir_8(traductor, 0x48);                                           //lea rcx, [rip + tabla]
+  emitir_8(traductor, 0x8D);
+  emitir_8(traductor, 0x0D);
+  emitir_32(traductor, (uint8_t *) traductor->tabla - (traductor->libre + 4));
+  emitir_instr(traductor, 32, 0xFF, 4, memoria(RCX, RAX, 8, 0));       //jmp [rcx + rax*8]
+}
+
+//Funcion que emite una operacion aritmetica o logica sobre el registro X con el literal (de 8
+//bits con signo si cabe) o el registro Y
+static void emitir_alu(TRADUCTOR *traductor, int extension, OPERANDO destino, uint32_t instr) {
+  const int16_t literal = (int16_t) instr;
+  int fuente;
+
+  if (instr & MODO_REGISTRO) {
+    fuente = fuente_en_registro(traductor, RY(instr), RCX);
+    if (extension == 2 || extension == 3) emitir_acarreo(traductor, extension == 3);
+    emitir_instr(traductor, 16, extension * 8 + 1, fuente, destino);   //op x, y
+    return;
+  }
+  if (extension == 2 || extension == 3) emitir_acarreo(traductor, extension == 3);
+  if (literal >= -128 && literal <= 127) {
+    emitir_instr(traductor, 16, 0x83, extension, destino);             //op x, literal
+    emitir_8(traductor, literal);
+  }
+  else {
+    emitir_instr(traductor, 16, 0x81, extension, destino);
+    emitir_16(traductor, literal);
+  }
+}
+
+//Funcion que emite la prueba de un registro de JPU16 (fija Z y N de x86-64 segun su valor)
+static void emitir_probar(TRADUCTOR *traductor, OPERANDO operando) {
+  if (operando.reg >= 0) emitir_instr(traductor, 16, 0x85, operando.reg, operando);
+  else {
+    emitir_instr(traductor, 16, 0x83, 7, operando);                    //cmp [x], 0
+    emitir_8(traductor, 0);
+  }
+}
+
+//Funcion que pasa la bandera C al acarreo de x86-64 (invertida para sbb, que resta el prestamo).
+//Si la instruccion anterior la dejo en el acarreo (directa o invertida) solo hay que ajustarla
+static void emitir_acarreo(TRADUCTOR *traductor, bool invertido) {
+  if (traductor->condicion[0] < 0) {
+    emitir_instr(traductor, 8, 0x80, 7, BANDERA(0));                   //cmp [c], 1
+    emitir_8(traductor, 1);
+    if (!invertido) emitir_8(traductor, 0xF5);                         //cmc
+  }
+  else if ((traductor->condicion[0] == CC_NC) != invertido) emitir_8(traductor, 0xF5);
+}
+
+//Funcion que guarda las banderas indicadas a partir de las de x86-64 (el acarreo se invierte en
+//las restas, pues en x86-64 indica prestamo)
+static void guardar_banderas(TRADUCTOR *traductor, int banderas, bool prestamo) {
+  const int acarreo = prestamo ? CC_NC : CC_C;
+
+  if (banderas & B_C) emitir_instr(traductor, 8, 0x0F90 | acarreo, 0, BANDERA(0));   //setc
+  if (banderas & B_Z) emitir_instr(traductor, 8, 0x0F90 | CC_Z, 0, BANDERA(1));      //setz
+  if (banderas & B_N) emitir_instr(traductor, 8, 0x0F90 | CC_S, 0, BANDERA(2));      //sets
+  if (banderas & B_V) emitir_instr(traductor, 8, 0x0F90 | CC_O, 0, BANDERA(3));      //seto
+}
+
+//Funcion que anota la condicion de x86-64 que equivale a cada bandera (o -1 si ninguna)
+static void fijar_condiciones(TRADUCTOR *traductor, int c, int z, int n, int v) {
+  traductor->condicion[0] = c;
+  traductor->condicion[1] = z;
+  traductor->condicion[2] = n;
+  traductor->condicion[3] = v;
+}
+
+//Funcion que obtiene la direccion de RAM del segundo operando: constante si es un literal, o
+//con el registro Y (enmascarado) en ECX
+static OPERANDO direccion_ram(TRADUCTOR *traductor, uint32_t instr) {
+  if (!(instr & MODO_REGISTRO))
+    return memoria(R12, -1, 1, 2 * ((uint16_t) instr & traductor->masc_ram));
+  emitir_instr(traductor, 32, 0x0FB7, RCX, registro_jpu(traductor, RY(instr)));
+  emitir_instr(traductor, 32, 0x81, 4, registro(RCX));                 //and ecx, mascara
+  emitir_32(traductor, traductor->masc_ram);
+  fijar_condiciones(traductor, -1, -1, -1, -1);
+  return memoria(R12, RCX, 2, 0);
+}
+
+//Funcion que obtiene un registro de JPU16 en un registro de x86-64: el suyo, o el auxiliar
+//indicado si esta en memoria (se carga en el)
+static int fuente_en_registro(TRADUCTOR *traductor, int num, int auxiliar) {
+  if (traductor->host[num] >= 0) return traductor->host[num];
+  emitir_instr(traductor, 32, 0x0FB7, auxiliar, registro_jpu(traductor, num));
+  return auxiliar;
+}
+
+//Funcion que obtiene el operando de un registro de JPU16: su registro de x86-64 o su posicion en
+//el estado del procesador
+static OPERANDO registro_jpu(const TRADUCTOR *traductor, int num) {
+  if (traductor->host[num] >= 0) return registro(traductor->host[num]);
+  return memoria(RBX, -1, 1, offsetof(CPU_JPU16, r) + 2 * num);
+}
+
+//Funciones que crean un operando en un registro o en memoria ([base + indice * escala + desp])
+static OPERANDO registro(int reg) {
+  OPERANDO operando = {reg, -1, -1, 1, 0};
+
+  return operando;
+}
+
+static OPERANDO memoria(int base, int indice, int escala, int32_t desp) {
+  OPERANDO operando = {-1, base, indice, escala, desp};
+
+  return operando;
+}
+
+//Funcion que emite una instruccion con un operando r/m: prefijo de 16 bits (66), prefijo REX
+//(operacion de 64 bits y bit alto de los registros), codigo de operacion de uno o dos bytes,
+//ModRM, SIB y desplazamiento. El inmediato, si lo tiene, lo emite quien la invoca
+static void emitir_instr(TRADUCTOR *traductor, int ancho, int codigo, int reg, OPERANDO rm) {
+  int rex = 0, modo, base;
+
+  if (ancho == 16) emitir_8(traductor, 0x66);
+  if (ancho == 64) rex |= 0x08;
+  if (reg & 8) rex |= 0x04;
+  if (rm.reg >= 0 && (rm.reg & 8)) rex |= 0x01;
+  if (rm.reg < 0 && rm.indice >= 0 && (rm.indice & 8)) rex |= 0x02;
+  if (rm.reg < 0 && (rm.base & 8)) rex |= 0x01;
+  if (rex) emitir_8(traductor, 0x40 | rex);
+  if (codigo > 0xFF) emitir_8(traductor, codigo >> 8);
+  emitir_8(traductor, codigo & 0xFF);
+
+  reg &= 7;
+  if (rm.reg >= 0) {
+    emitir_8(traductor, 0xC0 | reg << 3 | (rm.reg & 7));
+    return;
+  }
+
+  //Sin desplazamiento solo si la base no es RBP ni R13 (esa combinacion indica otro modo)
+  base = rm.base & 7;
+  if (!rm.desp && base != RBP) modo = 0;
+  else if (rm.desp >= -128 && rm.desp <= 127) modo = 1;
+  else modo = 2;
+  //Con indice, o con base RSP o R12, la direccion lleva el byte SIB
+  if (rm.indice >= 0 || base == RSP) {
+    emitir_8(traductor, modo << 6 | reg << 3 | RSP);
+    emitir_8(traductor, (__builtin_ctz(rm.escala) << 6) |
+                        ((rm.indice >= 0 ? rm.indice & 7 : RSP) << 3) | base);
+  }
+  else emitir_8(traductor, modo << 6 | reg << 3 | base);
+  if (modo == 1) emitir_8(traductor, rm.desp);
+  else if (modo == 2) emitir_32(traductor, rm.desp);
+}
+
+//Funciones que emiten un valor de 8, 16 o 32 bits (en orden little endian)
+static void emitir_8(TRADUCTOR *traductor, int valor) {
+  *traductor->libre++ = (uint8_t) valor;
+}
+
+static void emitir_16(TRADUCTOR *traductor, int valor) {
+  emitir_8(traductor, valor);
+  emitir_8(traductor, valor >> 8);
+}
+
+static void emitir_32(TRADUCTOR *traductor, int32_t valor) {
+  memcpy(traductor->libre, &valor, sizeof(valor));
+  traductor->libre += sizeof(valor);
+}
+
+#else
+
+//En otras arquitecturas no hay traductor: el procesador usa la memoria predecodificada
+TRADUCTOR *crear_traductor(const CPU_JPU16 *cpu) {
+  return NULL;
+}
+
+void destruir_traductor(TRADUCTOR *traductor) {
+}
+
+void invalidar_traduccion(TRADUCTOR *traductor, int direccion) {
+}
+
+int ejecutar_bloques(TRADUCTOR *traductor, CPU_JPU16 *cpu, uint64_t limite_rapido) {
+  return 1;
+}
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef j16sim_traductor_h_Incluida
+#define j16sim_traductor_h_Incluida
+
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+#include "j16sim_cpu.h"                 //Importa el procesador simulado
+
+//Tipos de datos exportados
+//-------------------------
+//Traductor de bloques basicos a codigo x86-64 (definido en el modulo)
+typedef struct _TRADUCTOR TRADUCTOR;
+
+//Funciones exportadas
+//--------------------
+//Funciones para crear y liberar el traductor de un procesador. Retorna NULL si la PC no es x86-64
+//o si el sistema no permite reservar memoria ejecutable
+extern TRADUCTOR *crear_traductor(const CPU_JPU16 *cpu);
+extern void destruir_traductor(TRADUCTOR *traductor);
+
+//Funcion que descarta los bloques traducidos que contienen una direccion de la memoria de
+//programa (se traducen de nuevo al ejecutarse), p. ej. al escribirla
+extern void invalidar_traduccion(TRADUCTOR *traductor, int direccion);
+
+//Funcion que ejecuta bloques traducidos a partir del PC mientras cada uno termine antes del ciclo
+//indicado, sin revisar el bus ni las interrupciones (los bloques no contienen instrucciones que
+//los cambien). Retorna 0 si ejecuto algo, o sin ejecutar nada, cuantas instrucciones conviene
+//interpretar antes de volver a intentarlo: la del PC si se debe interpretar o si su bloque no
+//termina antes de ese ciclo, o las de un bloque completo si desde el PC se llega enseguida a una
+//que se interpreta (p. ej. en un lazo de I/O)
+extern int ejecutar_bloques(TRADUCTOR *traductor, CPU_JPU16 *cpu, uint64_t limite_rapido);
+
+#endif //j16sim_traductor_h_Incluida
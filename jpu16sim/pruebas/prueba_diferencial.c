@@ -0,0 +1,433 @@
+//+-----------------------------------------------------------------------------------------------+
+//| prueba_diferencial.c                                                                          |
+//| Prueba diferencial de las formas de ejecucion del simulador                                   |
+//|                                                                                               |
+//| Este programa simula los mismos programas con el interprete, la memoria predecodificada y el  |
+//| traductor a x86-64, y verifica que las tres formas terminen en el mismo estado: registros,    |
+//| banderas (y sus sombras), PC, pila, RAM, memoria de programa, ciclos, instrucciones,          |
+//| interrupciones, el motivo de paro y el registro de todos los accesos al bus de I/O (con el    |
+//| ciclo de cada uno). El interprete no guarda nada entre instrucciones, por lo que sirve de     |
+//| referencia para las otras dos formas. Los programas son:                                      |
+//| - Programas aleatorios que llenan toda la memoria de programa (incluido el vector de          |
+//|   interrupcion en la ultima direccion): operaciones entre registros y con literales, saltos   |
+//|   y llamadas cortos (tambien los que se traducen como predicado), por registro y a si mismos, |
+//|   retornos, cambios de banderas (incluida I), accesos a RAM y al bus, y de vez en cuando un   |
+//|   codigo cualquiera. Los dispositivos del bus responden a las lecturas segun el puerto y el   |
+//|   ciclo, generan interrupciones periodicas que se atienden escribiendo a un puerto, y al      |
+//|   escribir a otro puerto reescriben una instruccion del programa (lo que invalida su entrada  |
+//|   predecodificada y los bloques traducidos que la contienen). Cada simulacion se hace en      |
+//|   tramos de ciclos al azar y a veces con una direccion de paro.                               |
+//| - Un programa fijo que reescribe, desde un dispositivo, una instruccion de su lazo principal y |
+//|   otra de una rutina (ambas ya predecodificadas y traducidas) y que luego las ejecuta, cuyo   |
+//|   resultado ademas se compara con el valor esperado.                                          |
+//| Argumentos opcionales: cantidad de programas aleatorios (400 por omision) y semilla.          |
+//+-----------------------------------------------------------------------------------------------+
+#include <stdbool.h>                    //Incluye la definicion del tipo de dato bool
+#include <stdint.h>                     //Incluye los tipos de datos de tamaño fijo
+#include <stdio.h>                      //Permite imprimir los resultados
+#include <stdlib.h>                     //Permite invocar atoi, realloc, strtoull y free
+#include <string.h>                     //Permite comparar el estado de los procesadores
+#include "j16asm_libreria.h"            //Importa la interfaz publica del ensamblador
+#include "../j16sim_cpu.h"              //Importa el procesador simulado
+
+#define TAM_PRG 512                     //Capacidad de la memoria de programa (la menor)
+#define TAM_RAM 1024                    //Capacidad de la memoria RAM (la menor)
+#define CICLOS 400000ULL                //Ciclos que se simula cada programa aleatorio
+#define NUM_PROGRAMAS 400               //Programas aleatorios por omision
+#define NUM_MODOS 3                     //Formas de ejecucion que se comparan
+#define NUM_PARCHES 16                  //Parches que puede escribir el dispositivo
+#define PUERTO_INT 0x0100               //Puerto cuya escritura atiende la interrupcion
+#define PUERTO_PARCHE 0x0300            //Puerto cuya escritura reescribe el programa
+
+//Acceso al bus de I/O registrado por los dispositivos
+typedef struct _ACCESO_IO {
+  uint64_t ciclo;                       //Ciclo en que inicia la instruccion in u out
+  uint16_t puerto;                      //Direccion del bus
+  uint16_t dato;                        //Dato escrito o leido
+  bool escritura;                       //Indica si fue una escritura (out)
+} ACCESO_IO;
+
+//Instruccion que escribe el dispositivo del parche
+typedef struct _PARCHE {
+  int direccion;                        //Direccion que se reescribe (o -1 si no hace nada)
+  uint32_t instr;                       //Instruccion que se escribe
+} PARCHE;
+
+//Dispositivos del bus de I/O de la prueba
+typedef struct _DISPOSITIVOS {
+  ACCESO_IO *accesos;                   //Registro de los accesos al bus
+  int num_accesos;                      //Cantidad de accesos registrados
+  int capacidad;                        //Cantidad de accesos que caben en el arreglo actual
+  uint64_t periodo_int;                 //Ciclos entre solicitudes de interrupcion (0 si no hay)
+  uint64_t proxima_int;                 //Ciclo de la siguiente solicitud de interrupcion
+  const PARCHE *parches;                //Parches que escribe el puerto del parche
+} DISPOSITIVOS;
+
+//Programa de prueba con la configuracion de su simulacion
+typedef struct _PROGRAMA {
+  uint32_t prg[TAM_PRG];                //Imagen de la memoria de programa
+  uint16_t ram[TAM_RAM];                //Imagen de la memoria RAM
+  PARCHE parches[NUM_PARCHES];          //Parches que escribe el puerto del parche
+  uint64_t periodo_int;                 //Ciclos entre solicitudes de interrupcion (0 si no hay)
+  int dir_paro;                         //Direccion de paro (o SIN_DIRECCION)
+  uint64_t tramos[8];                   //Limites de ciclos de cada llamada a ejecutar_cpu
+  int num_tramos;                       //Cantidad de tramos
+} PROGRAMA;
+
+//Resultado de simular un programa con una forma de ejecucion
+typedef struct _RESULTADO {
+  CPU_JPU16 *cpu;                       //Procesador en su estado final
+  DISPOSITIVOS dispositivos;            //Dispositivos con el registro de accesos
+  MOTIVO_PARO motivo;                   //Motivo de paro de la ultima llamada
+} RESULTADO;
+
+//Programa fijo que ejecuta instrucciones reescritas: cada vuelta suma a r2 (en el lazo) y a r4
+//(a la mitad de una rutina) el literal de una instruccion que el dispositivo cambia al escribir
+//al puerto del parche (parches 0 y 1 para el lazo, 2 y 3 para la rutina): en las vueltas pares
+//vale 1 y en las impares 0x100, de manera que al final r2 y r4 valen 50 * 1 + 50 * 0x100
+static const char reescritura_asm[] =
+  "code\n"
+  "  move r3, 100\n"
+  "lazo:\n"
+  "  add r2, 1\n"
+  "  call rutina\n"
+  "  move r6, r3\n"
+  "  and r6, 1\n"
+  "  out 0x300, r6\n"
+  "  or r6, 2\n"
+  "  out 0x300, r6\n"
+  "  sub r3, 1\n"
+  "  jmpnz lazo\n"
+  "fin:\n"
+  "  jmp fin\n"
+  "rutina:\n"
+  "  move r5, r3\n"
+  "sumar:\n"
+  "  add r4, 1\n"
+  "  return\n";
+
+//Estado del generador de numeros aleatorios (xorshift de 64 bits)
+static uint64_t estado_aleatorio;
+
+//Declaracion previa de las funciones locales al modulo
+static bool probar_aleatorios(int cantidad);
+static bool probar_reescritura(void);
+static void generar_programa(PROGRAMA *programa);
+static uint32_t generar_instruccion(void);
+static void simular(const PROGRAMA *programa, MODO_EJECUCION modo, RESULTADO *resultado);
+static void liberar_resultado(RESULTADO *resultado);
+static bool comparar(const RESULTADO *a, const RESULTADO *b, const char *modo, const char *nombre);
+static uint16_t leer_io(CPU_JPU16 *cpu, uint16_t direccion);
+static void escribir_io(CPU_JPU16 *cpu, uint16_t direccion, uint16_t dato);
+static void evento_io(CPU_JPU16 *cpu);
+static void registrar_acceso(DISPOSITIVOS *dispositivos, uint64_t ciclo, uint16_t puerto,
+                             uint16_t dato, bool escritura);
+static uint32_t aleatorio(uint32_t limite);
+
+//Formas de ejecucion que se comparan (la primera es la referencia) y sus nombres
+static const MODO_EJECUCION modos[NUM_MODOS] = {
+  MODO_INTERPRETE, MODO_PREDECODIFICADO, MODO_TRADUCIDO
+};
+static const char *const nombres_modos[NUM_MODOS] = {
+  "interprete", "predecodificado", "traducido"
+};
+
+//+------------------------------+
+//| Inicio del codigo del modulo |
+//+------------------------------+-----------------------------------------------------------------
+int main(int argc, char *argv[]) {
+  int cantidad = argc > 1 ? atoi(argv[1]) : NUM_PROGRAMAS;
+
+  estado_aleatorio = argc > 2 ? strtoull(argv[2], NULL, 0) : 0x4A505531360ULL;
+  if (!estado_aleatorio) estado_aleatorio = 1;  //xorshift no sale del cero
+
+  if (!probar_reescritura() || !probar_aleatorios(cantidad)) return 1;
+  printf("Prueba diferencial: OK\n");
+  return 0;
+}
+
+//Funcion que genera y compara la cantidad indicada de programas aleatorios
+static bool probar_aleatorios(int cantidad) {
+  static PROGRAMA programa;
+  RESULTADO resultados[NUM_MODOS];
+  char nombre[48];
+  uint64_t instrucciones = 0, interrupciones = 0, accesos = 0;
+  bool exito = true, traducido = true;
+  int i, m;
+
+  for (i=0; i<cantidad && exito; i++) {
+    generar_programa(&programa);
+    snprintf(nombre, sizeof(nombre), "el programa aleatorio %d", i);
+    for (m=0; m<NUM_MODOS; m++) simular(&programa, modos[m], &resultados[m]);
+    for (m=1; m<NUM_MODOS && exito; m++)
+      exito = comparar(&resultados[0], &resultados[m], nombres_modos[m], nombre);
+
+    if (resultados[2].cpu->modo != MODO_TRADUCIDO) traducido = false;
+    instrucciones += resultados[0].cpu->instrucciones;
+    interrupciones += resultados[0].cpu->interrupciones;
+    accesos += resultados[0].dispositivos.num_accesos;
+    for (m=0; m<NUM_MODOS; m++) liberar_resultado(&resultados[m]);
+  }
+
+  if (!traducido) printf("Aviso: el traductor no esta disponible\n");
+  if (exito)
+    printf("%d programas aleatorios iguales: %llu instrucciones, %llu interrupciones, "
+           "%llu accesos al bus\n", cantidad, (unsigned long long) instrucciones,
+           (unsigned long long) interrupciones, (unsigned long long) accesos);
+  return exito;
+}
+
+//Funcion que prueba el programa que ejecuta instrucciones reescritas por un dispositivo
+static bool probar_reescritura(void) {
+  static PROGRAMA programa;
+  RESULTADO resultados[NUM_MODOS];
+  JPU16ASM *ensamblador;
+  int lazo, sumar, i, m;
+  bool exito = true;
+
+  ensamblador = jpu16asm_crear(TAM_PRG, TAM_RAM);
+  if (!jpu16asm_ensamblar(ensamblador, "reescritura", reescritura_asm, strlen(reescritura_asm)) ||
+      !jpu16asm_buscar_simbolo(ensamblador, "lazo", &lazo) ||
+      !jpu16asm_buscar_simbolo(ensamblador, "sumar", &sumar)) {
+    printf("Error al ensamblar el programa de reescritura\n");
+    jpu16asm_destruir(ensamblador);
+    return false;
+  }
+  memset(&programa, 0, sizeof(programa));
+  for (i=0; i<TAM_PRG; i++) programa.prg[i] = jpu16asm_leer_prg(ensamblador, i);
+  jpu16asm_destruir(ensamblador);
+
+  //Los parches 0 y 2 cambian el literal de "add r2, 1" y "add r4, 1" a 0x100, y el 1 y el 3 lo
+  //regresan a 1 (los demas no hacen nada)
+  for (i=0; i<NUM_PARCHES; i++) programa.parches[i].direccion = -1;
+  for (i=0; i<4; i++) {
+    programa.parches[i].direccion = i < 2 ? lazo : sumar;
+    programa.parches[i].instr = (programa.prg[programa.parches[i].direccion] & ~0xFFFF) |
+                                (i & 1 ? 0x0001 : 0x0100);
+  }
+  programa.dir_paro = SIN_DIRECCION;
+  programa.tramos[0] = 1000000;
+  programa.num_tramos = 1;
+
+  for (m=0; m<NUM_MODOS; m++) {
+    simular(&programa, modos[m], &resultados[m]);
+    if (resultados[m].cpu->r[2] != 50 + 50 * 0x100 || resultados[m].cpu->r[4] != 50 + 50 * 0x100) {
+      printf("Error: con el modo %s el programa de reescritura termina con r2 = 0x%04X y "
+             "r4 = 0x%04X (se esperaba 0x3232)\n", nombres_modos[m], resultados[m].cpu->r[2],
+             resultados[m].cpu->r[4]);
+      exito = false;
+    }
+  }
+  for (m=1; m<NUM_MODOS && exito; m++)
+    exito = comparar(&resultados[0], &resultados[m], nombres_modos[m],
+                     "el programa de reescritura");
+  for (m=0; m<NUM_MODOS; m++) liberar_resultado(&resultados[m]);
+
+  if (exito) printf("Programa de reescritura: OK\n");
+  return exito;
+}
+
+//Funcion que genera un programa aleatorio con su RAM inicial, sus parches y la forma de simularlo
+static void generar_programa(PROGRAMA *programa) {
+  uint64_t ciclo;
+  int i;
+
+  for (i=0; i<TAM_PRG; i++) programa->prg[i] = generar_instruccion();
+  for (i=0; i<TAM_RAM; i++) programa->ram[i] = aleatorio(0x10000);
+  for (i=0; i<NUM_PARCHES; i++) {
+    programa->parches[i].direccion = aleatorio(TAM_PRG);
+    programa->parches[i].instr = generar_instruccion();
+  }
+
+  //La mitad de los programas reciben interrupciones (con periodos cortos, para que ocurran a
+  //menudo) y uno de cada cuatro tiene direccion de paro
+  programa->periodo_int = aleatorio(2) ? 20 + aleatorio(400) : 0;
+  programa->dir_paro = aleatorio(4) ? SIN_DIRECCION : (int) aleatorio(TAM_PRG);
+
+  //Tramos de ciclos crecientes al azar, el ultimo hasta el total
+  programa->num_tramos = 1 + aleatorio(8);
+  for (i=0, ciclo=0; i<programa->num_tramos - 1; i++) {
+    ciclo += 1 + aleatorio(CICLOS / programa->num_tramos);
+    programa->tramos[i] = ciclo;
+  }
+  programa->tramos[i] = CICLOS;
+}
+
+//Funcion que genera una instruccion al azar. Los saltos y llamadas son cortos (a veces a si
+//mismos o sobre 1 o 2 instrucciones, que el traductor convierte en predicado) y los puertos del
+//bus son pocos, para que los dispositivos se usen a menudo
+static uint32_t generar_instruccion(void) {
+  static const uint16_t puertos[] = { PUERTO_INT, PUERTO_PARCHE, 0x0010, 0x0011, 0xFFFF };
+  uint32_t modo = aleatorio(2) ? MODO_REGISTRO : 0;
+  uint32_t rx = aleatorio(16) << 16, ry = aleatorio(16) << 12;
+  uint32_t operando = modo ? ry : aleatorio(0x10000);
+  uint32_t tipo = aleatorio(100);
+  int desplazamiento;
+
+  //Un codigo cualquiera de 26 bits
+  if (tipo < 3) return aleatorio(1 << 26);
+
+  //Operaciones aritmeticas y logicas, multiplicaciones y movimientos (la mayor parte)
+  if (tipo < 45)
+    return (uint32_t) (OP_NOT + aleatorio(OP_SMUL - OP_NOT + 1)) << 21 | modo | rx | operando;
+  if (tipo < 52) return (uint32_t) OP_MOVE << 21 | modo | rx | operando;
+  if (tipo < 55) return (uint32_t) (OP_NULA + aleatorio(2)) << 21 | modo | rx | operando;
+
+  //Desplazamientos (la cantidad en los 4 bits bajos del literal o del registro Y)
+  if (tipo < 62)
+    return (uint32_t) OP_DESPLAZAR << 21 | modo | rx | aleatorio(8) << 9 |
+           (modo ? ry : aleatorio(16));
+
+  //Pruebas y cambios de banderas (sin I la mayoria de las veces)
+  if (tipo < 68) return (uint32_t) (OP_TEST + aleatorio(2)) << 21 | modo | rx | operando;
+  if (tipo < 72)
+    return (uint32_t) (OP_CLRX + aleatorio(2)) << 21 |
+           (1 + aleatorio(aleatorio(4) ? 15 : 31)) << 16;
+
+  //Accesos a la RAM y al bus de I/O
+  if (tipo < 77) return (uint32_t) OP_MOVE_A_RAM << 21 | modo | rx | operando;
+  if (tipo < 82) return (uint32_t) OP_MOVE_DE_RAM << 21 | modo | rx | operando;
+  if (tipo < 85)
+    return (uint32_t) (OP_IN + aleatorio(2) * (OP_OUT - OP_IN)) << 21 | modo | rx |
+           (modo ? ry : puertos[aleatorio(sizeof(puertos) / sizeof(puertos[0]))]);
+
+  //Saltos y llamadas: casi siempre relativos y cortos, con condicion en los bits 18 a 16
+  if (tipo < 97) {
+    desplazamiento = aleatorio(4) ? 1 + (int) aleatorio(3) : (int) aleatorio(17) - 8;
+    if (aleatorio(8) == 0) return (uint32_t) (OP_JMP + aleatorio(4)) << 21 | MODO_REGISTRO | ry;
+    return (uint32_t) (OP_JMP + aleatorio(4)) << 21 | aleatorio(8) << 16 |
+           (desplazamiento & 0xFFFF);
+  }
+
+  //Retornos (tambien de interrupcion)
+  return (uint32_t) (OP_RETURN + aleatorio(4)) << 21;
+}
+
+//Funcion que simula un programa desde el reinicio con la forma de ejecucion indicada, llamando a
+//ejecutar_cpu una vez por tramo
+static void simular(const PROGRAMA *programa, MODO_EJECUCION modo, RESULTADO *resultado) {
+  CPU_JPU16 *cpu;
+  int i;
+
+  memset(resultado, 0, sizeof(RESULTADO));
+  resultado->dispositivos.periodo_int = programa->periodo_int;
+  resultado->dispositivos.proxima_int = programa->periodo_int;
+  resultado->dispositivos.parches = programa->parches;
+
+  cpu = resultado->cpu = crear_cpu(TAM_PRG, TAM_RAM);
+  for (i=0; i<TAM_PRG; i++) escribir_prg(cpu, i, programa->prg[i]);
+  memcpy(cpu->ram, programa->ram, sizeof(programa->ram));
+  cpu->bus.leer = leer_io;
+  cpu->bus.escribir = escribir_io;
+  cpu->bus.evento = programa->periodo_int ? evento_io : NULL;
+  cpu->bus.datos = &resultado->dispositivos;
+  cpu->dir_paro = programa->dir_paro;
+  cpu->modo = modo;
+  reiniciar_cpu(cpu);
+
+  for (i=0; i<programa->num_tramos; i++)
+    resultado->motivo = ejecutar_cpu(cpu, programa->tramos[i]);
+}
+
+//Funcion que libera el procesador y el registro de accesos de un resultado
+static void liberar_resultado(RESULTADO *resultado) {
+  destruir_cpu(resultado->cpu);
+  free(resultado->dispositivos.accesos);
+}
+
+//Funcion que compara un resultado con el de referencia (el del interprete) y reporta la primera
+//diferencia que encuentra
+static bool comparar(const RESULTADO *a, const RESULTADO *b, const char *modo, const char *nombre) {
+  const CPU_JPU16 *x = a->cpu, *y = b->cpu;
+  const char *diferencia = NULL;
+  int i;
+
+  if (memcmp(x->r, y->r, sizeof(x->r))) diferencia = "los registros";
+  else if (x->c != y->c || x->z != y->z || x->n != y->n || x->v != y->v || x->i != y->i)
+    diferencia = "las banderas";
+  else if (x->sombra_c != y->sombra_c || x->sombra_z != y->sombra_z ||
+           x->sombra_n != y->sombra_n || x->sombra_v != y->sombra_v)
+    diferencia = "las banderas sombra";
+  else if (x->pc != y->pc) diferencia = "el PC";
+  else if (x->sp != y->sp || memcmp(x->pila, y->pila, sizeof(x->pila))) diferencia = "la pila";
+  else if (memcmp(x->ram, y->ram, x->tam_ram * sizeof(uint16_t))) diferencia = "la RAM";
+  else if (memcmp(x->prg, y->prg, x->tam_prg * sizeof(uint32_t)))
+    diferencia = "la memoria de programa";
+  else if (x->ciclos != y->ciclos) diferencia = "los ciclos";
+  else if (x->instrucciones != y->instrucciones) diferencia = "las instrucciones ejecutadas";
+  else if (x->interrupciones != y->interrupciones) diferencia = "las interrupciones";
+  else if (x->linea_int != y->linea_int) diferencia = "la linea de interrupcion";
+  else if (a->motivo != b->motivo) diferencia = "el motivo de paro";
+  else if (a->dispositivos.num_accesos != b->dispositivos.num_accesos)
+    diferencia = "la cantidad de accesos al bus";
+  else
+    for (i=0; i<a->dispositivos.num_accesos && !diferencia; i++)
+      if (memcmp(&a->dispositivos.accesos[i], &b->dispositivos.accesos[i], sizeof(ACCESO_IO)))
+        diferencia = "los accesos al bus";
+
+  if (!diferencia) return true;
+  printf("Error: en %s, el modo %s difiere del interprete en %s (ciclos %llu y %llu, PC 0x%04X "
+         "y 0x%04X)\n", nombre, modo, diferencia, (unsigned long long) x->ciclos,
+         (unsigned long long) y->ciclos, x->pc, y->pc);
+  return false;
+}
+
+//Funcion que atiende las lecturas del bus: el dato depende del puerto y del ciclo (de manera que
+//una lectura en otro ciclo da otro resultado)
+static uint16_t leer_io(CPU_JPU16 *cpu, uint16_t direccion) {
+  uint16_t dato = (uint16_t) ((direccion * 0x9E37u) ^ (cpu->ciclos * 0x85EBu) ^ (cpu->ciclos >> 7));
+
+  registrar_acceso(cpu->bus.datos, cpu->ciclos, direccion, dato, false);
+  return dato;
+}
+
+//Funcion que atiende las escrituras al bus: el puerto de interrupcion baja la linea y el del
+//parche escribe el parche que indican los 4 bits bajos del dato
+static void escribir_io(CPU_JPU16 *cpu, uint16_t direccion, uint16_t dato) {
+  DISPOSITIVOS *dispositivos = cpu->bus.datos;
+  const PARCHE *parche = &dispositivos->parches[dato & (NUM_PARCHES - 1)];
+
+  registrar_acceso(dispositivos, cpu->ciclos, direccion, dato, true);
+  if (direccion == PUERTO_INT) cpu->linea_int = false;
+  if (direccion == PUERTO_PARCHE && parche->direccion >= 0)
+    escribir_prg(cpu, parche->direccion, parche->instr);
+}
+
+//Funcion del generador de interrupciones: sube la linea al cumplirse cada periodo y programa la
+//siguiente solicitud
+static void evento_io(CPU_JPU16 *cpu) {
+  DISPOSITIVOS *dispositivos = cpu->bus.datos;
+
+  if (cpu->ciclos >= dispositivos->proxima_int) {
+    cpu->linea_int = true;
+    dispositivos->proxima_int = (cpu->ciclos / dispositivos->periodo_int + 1) *
+                                dispositivos->periodo_int;
+  }
+  cpu->ciclo_evento = dispositivos->proxima_int;
+}
+
+//Funcion que agrega un acceso al registro del bus
+static void registrar_acceso(DISPOSITIVOS *dispositivos, uint64_t ciclo, uint16_t puerto,
+                             uint16_t dato, bool escritura) {
+  ACCESO_IO *acceso;
+
+  if (dispositivos->num_accesos == dispositivos->capacidad) {
+    dispositivos->capacidad = dispositivos->capacidad ? 2 * dispositivos->capacidad : 1024;
+    dispositivos->accesos = realloc(dispositivos->accesos,
+                                    dispositivos->capacidad * sizeof(ACCESO_IO));
+  }
+  acceso = &dispositivos->accesos[dispositivos->num_accesos++];
+  memset(acceso, 0, sizeof(ACCESO_IO));  //El relleno tambien se compara
+  acceso->ciclo = ciclo;
+  acceso->puerto = puerto;
+  acceso->dato = dato;
+  acceso->escritura = escritura;
+}
+
+//Funcion que obtiene un numero aleatorio entre 0 y limite - 1 (xorshift de 64 bits)
+static uint32_t aleatorio(uint32_t limite) {
+  estado_aleatorio ^= estado_aleatorio << 13;
+  estado_aleatorio ^= estado_aleatorio >> 7;
+  estado_aleatorio ^= estado_aleatorio << 17;
+  return (uint32_t) ((estado_aleatorio >> 16) % limite);
+}
@@ -0,0 +1,53 @@
+;Macros de aritmetica de 32 bits para JPU16
+;
+;Cada valor de 32 bits ocupa un par de registros, que se escriben primero la parte alta y luego la
+;parte baja (por ejemplo r2, r1 para r2:r1). Las macros generan el codigo en linea, puesto que una
+;llamada (call y return) tardaria mas que la operacion misma.
+;
+;Este archivo debe incluirse antes del primer uso de las macros, normalmente al inicio del
+;programa. No genera codigo ni datos por si mismo.
+
+;move32 h, l, valor: h:l = valor (constante de 32 bits)
+macro move32 h, l, valor
+  move l, (valor) & 0xFFFF        ;Parte baja
+  move h, ((valor) >> 16) & 0xFFFF  ;Parte alta
+endm
+
+;add32 ah, al, bh, bl: ah:al = ah:al + bh:bl (C, V y N quedan como los de la suma de 32 bits)
+macro add32 ah, al, bh, bl
+  add al, bl                      ;Suma las partes bajas
+  addc ah, bh                     ;Suma las partes altas con el acarreo
+endm
+
+;sub32 ah, al, bh, bl: ah:al = ah:al - bh:bl (C = 1 si no hubo prestamo, como en sub)
+macro sub32 ah, al, bh, bl
+  sub al, bl                      ;Resta las partes bajas
+  subb ah, bh                     ;Resta las partes altas con el prestamo
+endm
+
+;neg32 h, l: h:l = -h:l (complemento a 2)
+macro neg32 h, l
+  not l                           ;Complemento a 1 de ambas partes
+  not h
+  add l, 1                        ;Suma 1 y propaga el acarreo
+  addc h, 0
+endm
+
+;shl32 h, l: h:l = h:l << 1 (C = bit que sale por la izquierda)
+macro shl32 h, l
+  shl0 l, 1                       ;Desplaza la parte baja, su msb queda en C
+  rolc h                          ;Desplaza la parte alta metiendo el bit de C
+endm
+
+;shr32 h, l: h:l = h:l >> 1 sin signo (C = bit que sale por la derecha)
+macro shr32 h, l
+  shr0 h, 1                       ;Desplaza la parte alta, su lsb queda en C
+  rorc l                          ;Desplaza la parte baja metiendo el bit de C
+endm
+
+;sar32 h, l: h:l = h:l >> 1 con signo (C = bit que sale por la derecha)
+macro sar32 h, l
+  cmp h, 0x8000                   ;C = 1 si la parte alta es negativa (copia del signo)
+  rorc h                          ;Desplaza la parte alta conservando el signo
+  rorc l                          ;Desplaza la parte baja metiendo el bit de C
+endm
@@ -0,0 +1,334 @@
+;Libreria de rutinas matematicas para JPU16
+;
+;Contiene multiplicaciones de 16x16 bits con resultado de 32 bits, multiplicacion de 32 bits,
+;divisiones con y sin signo, raiz cuadrada entera y operaciones de punto fijo Q15 con saturacion.
+;
+;Uso: incluir este archivo dentro de una seccion de codigo (por ejemplo al final del programa,
+;despues del lazo principal) e invocar las rutinas con call. Con la opcion -gc del ensamblador
+;se descartan las rutinas que el programa no usa.
+;
+;Convencion de registros:
+;- Los operandos de 16 bits se pasan en r1 y r2, y los de 32 bits en los pares r2:r1 y r4:r3
+;  (parte alta:parte baja). Los resultados se devuelven en r1 (16 bits) o r2:r1 (32 bits).
+;- Todas las rutinas pueden modificar los registros temporales r11 a r15, y las banderas. Los
+;  demas registros se conservan, excepto los que cada rutina indica como resultados.
+;- Las rutinas no usan RAM, por lo que pueden llamarse desde las interrupciones siempre que se
+;  respeten los registros temporales.
+;
+;El multiplicador de la ALU solo entrega los 16 bits bajos del producto, por lo que la parte
+;alta se arma a partir de productos parciales de 8x8 bits. Los lazos de las divisiones y de la
+;raiz de 16 bits estan desenrollados; el tiempo de cada rutina se obtiene con la opcion -lst (ver
+;el programa medicion.asm).
+
+;------------------------------------------------------------------------------------------------
+;Multiplicaciones
+;------------------------------------------------------------------------------------------------
+
+;mat_mul32u: r2:r1 = r1 * r2 (sin signo)
+mat_mul32u:
+  move r15, r1                    ;La parte baja sale directo del multiplicador
+  mul r15, r2
+  move r12, r1                    ;r12 = byte bajo de r1 (al)
+  and r12, 0xFF
+  move r13, r2                    ;r13 = byte bajo de r2 (bl)
+  and r13, 0xFF
+  move r14, r12                   ;r14 = (al * bl) >> 8
+  mul r14, r13
+  shr0 r14, 8
+  shr0 r1, 8                      ;r1 = byte alto de r1 (ah)
+  shr0 r2, 8                      ;r2 = byte alto de r2 (bh)
+  mul r12, r2                     ;r12 = al * bh
+  mul r13, r1                     ;r13 = ah * bl
+  mul r2, r1                      ;r2 = ah * bh
+  add r12, r13                    ;Suma los productos cruzados, el acarreo se junta en r13 (move
+  move r13, 0                     ;no altera las banderas)
+  addc r13, 0
+  add r12, r14                    ;Agrega la parte de al * bl que pasa de los 8 bits bajos
+  addc r13, 0
+  shr0 r12, 8                     ;La suma de los productos cruzados va desplazada 8 bits,
+  shl0 r13, 8                     ;incluyendo sus acarreos
+  add r2, r12
+  add r2, r13
+  move r1, r15                    ;Devuelve la parte baja
+  return
+
+;mat_mul32s: r2:r1 = r1 * r2 (con signo)
+;El producto con signo difiere del producto sin signo solo en la parte alta, a la que se le resta
+;cada operando cuando el otro es negativo
+mat_mul32s:
+  move r11, r1                    ;r11 = r2 si r1 es negativo
+  shr0 r11, 15
+  mul r11, r2
+  move r12, r2                    ;Le suma r1 si r2 es negativo
+  shr0 r12, 15
+  mul r12, r1
+  add r11, r12
+  call mat_mul32u                 ;Multiplica sin signo (no modifica r11)
+  sub r2, r11                     ;Corrige la parte alta
+  return
+
+;mat_mul32x32: r2:r1 = r2:r1 * r4:r3 (32 bits bajos del producto, igual con y sin signo)
+mat_mul32x32:
+  mul r2, r3                      ;Productos cruzados, de los que solo importa su parte baja
+  move r11, r4
+  mul r11, r1
+  add r11, r2
+  move r2, r3                     ;Producto completo de las partes bajas
+  call mat_mul32u
+  add r2, r11                     ;Agrega los productos cruzados a la parte alta
+  return
+
+;------------------------------------------------------------------------------------------------
+;Divisiones
+;------------------------------------------------------------------------------------------------
+;Las divisiones entre cero dejan el cociente en 0xFFFF (0xFFFFFFFF en las de 32 bits sin signo)
+
+;mat_div16u: r1 = r1 / r2, r3 = r1 % r2 (sin signo)
+mat_div16u:
+  move r3, 0                      ;El residuo parcial inicia en 0
+  test r2, r2                     ;Con divisores menores a 0x8000 usa el nucleo rapido
+  jmpp mat_div_nucleo
+  cmp r1, r2                      ;Con divisores mayores el cociente solo puede ser 0 o 1
+  jmpnc $+5
+  sub r1, r2                      ;Cociente 1
+  move r3, r1
+  move r1, 1
+  return
+  move r3, r1                     ;Cociente 0
+  move r1, 0
+  return
+
+;mat_div16s: r1 = r1 / r2, r3 = r1 % r2 (con signo, el cociente se trunca hacia 0 y el residuo
+;toma el signo del dividendo; -32768 / -1 da -32768)
+mat_div16s:
+  move r11, r1                    ;Bit 15 de r11: signo del cociente
+  xor r11, r2
+  move r12, r1                    ;Bit 15 de r12: signo del residuo
+  move r13, r2                    ;Guarda el divisor
+  test r1, r1                     ;Obtiene el valor absoluto del dividendo
+  jmpp $+3
+  not r1
+  add r1, 1
+  test r2, r2                     ;Obtiene el valor absoluto del divisor
+  jmpp $+3
+  not r2
+  add r2, 1
+  call mat_div16u                 ;Divide las magnitudes
+  move r2, r13                    ;Restaura el divisor
+  test r11, r11                   ;Aplica el signo al cociente
+  jmpp $+3
+  not r1
+  add r1, 1
+  test r12, r12                   ;Aplica el signo al residuo
+  jmpp $+3
+  not r3
+  add r3, 1
+  return
+
+;mat_div32u: r2:r1 = r2:r1 / r3, r4 = r2:r1 % r3 (sin signo, conserva r3)
+mat_div32u:
+  move r11, r1                    ;Guarda la parte baja del dividendo
+  move r1, r2                     ;Divide primero la parte alta
+  move r2, r3
+  call mat_div16u
+  move r12, r1                    ;Guarda la parte alta del cociente
+  move r1, r11                    ;Divide el residuo junto con la parte baja, con el nucleo que
+  test r2, r2                     ;corresponde al divisor
+  jmpn $+3
+  call mat_div_nucleo
+  jmp $+2
+  call mat_div_nucleo_grande
+  move r4, r3                     ;Devuelve el residuo
+  move r3, r2                     ;Restaura el divisor
+  move r2, r12                    ;Devuelve la parte alta del cociente
+  return
+
+;mat_div32s: r2:r1 = r2:r1 / r3, r4 = r2:r1 % r3 (con signo, conserva r3; mismas reglas de
+;redondeo y signo que mat_div16s)
+mat_div32s:
+  move r13, r2                    ;Bit 15 de r13: signo del cociente
+  xor r13, r3
+  move r14, r2                    ;Bit 15 de r14: signo del residuo
+  move r15, r3                    ;Guarda el divisor
+  test r2, r2                     ;Obtiene el valor absoluto del dividendo
+  jmpp $+5
+  not r1
+  not r2
+  add r1, 1
+  addc r2, 0
+  test r3, r3                     ;Obtiene el valor absoluto del divisor
+  jmpp $+3
+  not r3
+  add r3, 1
+  call mat_div32u                 ;Divide las magnitudes (no modifica r13 a r15)
+  move r3, r15                    ;Restaura el divisor
+  test r13, r13                   ;Aplica el signo al cociente
+  jmpp $+5
+  not r1
+  not r2
+  add r1, 1
+  addc r2, 0
+  test r14, r14                   ;Aplica el signo al residuo
+  jmpp $+3
+  not r4
+  add r4, 1
+  return
+
+;Nucleos de la division: dividen r3:r1 entre r2 y dejan el cociente en r1 y el residuo en r3.
+;Requieren que r3 sea menor que r2 (el cociente cabe en 16 bits) y solo usan r1 a r3.
+;Cada paso mete el bit anterior del cociente por la derecha de r1 al mismo tiempo que saca el
+;siguiente bit del dividendo, y este pasa al residuo parcial. El bit del cociente queda en C
+
+;mat_div_nucleo: para divisores menores a 0x8000 (el residuo parcial nunca pasa de 16 bits)
+mat_div_nucleo:
+  rept 16
+  rolc r1                         ;Bit del cociente adentro, bit del dividendo a C
+  rolc r3                         ;Residuo = residuo * 2 + bit
+  cmp r3, r2                      ;C = 1 si el divisor cabe
+  jmpnc $+2
+  sub r3, r2                      ;Resta el divisor (C queda en 1)
+  endm
+  rolc r1                         ;Mete el ultimo bit del cociente
+  return
+
+;mat_div_nucleo_grande: para divisores desde 0x8000 (el residuo parcial puede llegar a 17 bits)
+mat_div_nucleo_grande:
+  rept 16
+  rolc r1                         ;Bit del cociente adentro, bit del dividendo a C
+  rolc r3                         ;Residuo = residuo * 2 + bit, el bit 16 queda en C
+  jmpc $+3                        ;Con el bit 16 el divisor siempre cabe
+  cmp r3, r2                      ;C = 1 si el divisor cabe
+  jmpnc $+3
+  sub r3, r2                      ;Resta el divisor
+  setc                            ;El bit del cociente es 1 (la resta lo borra si hubo bit 16)
+  endm
+  rolc r1                         ;Mete el ultimo bit del cociente
+  return
+
+;------------------------------------------------------------------------------------------------
+;Raiz cuadrada entera
+;------------------------------------------------------------------------------------------------
+
+;mat_raiz16: r1 = parte entera de la raiz cuadrada de r1 (sin signo)
+mat_raiz16:
+  move r11, 0                     ;Raiz parcial (desplazada)
+  move r13, 0x4000                ;Potencia de 4 que se prueba
+  rept 8
+  move r12, r11                   ;r12 = raiz + potencia
+  add r12, r13
+  shr0 r11, 1
+  cmp r1, r12                     ;Si cabe, la resta y agrega la potencia a la raiz
+  jmpnc $+3
+  sub r1, r12
+  add r11, r13
+  shr0 r13, 2                     ;Siguiente potencia de 4
+  endm
+  move r1, r11                    ;Devuelve la raiz
+  return
+
+;mat_raiz32: r1 = parte entera de la raiz cuadrada de r2:r1 (sin signo, r2 queda en 0)
+;Calcula un bit de la raiz por vuelta, pasando dos bits del numero al residuo cada vez. La ultima
+;vuelta va aparte porque su valor de prueba ocupa 17 bits
+mat_raiz32:
+  move r11, 0                     ;Raiz parcial
+  move r12, 0                     ;Residuo (parte alta, a lo sumo 3 bits)
+  move r13, 0                     ;Residuo (parte baja)
+  move r15, 15                    ;Cantidad de vueltas del lazo
+mat_raiz32_lazo:
+  shl0 r1, 1                      ;Pasa los 2 bits mas significativos del numero al residuo
+  rolc r2
+  rolc r13
+  rolc r12
+  shl0 r1, 1
+  rolc r2
+  rolc r13
+  rolc r12
+  shl0 r11, 1                     ;Agrega un bit en 0 a la raiz
+  move r14, r11                   ;r14 = raiz * 2 + 1 (cabe en 16 bits porque la raiz tiene a lo
+  shl0 r14, 1                     ;sumo 15 bits dentro del lazo)
+  or r14, 1
+  test r12, r12                   ;Con la parte alta del residuo el valor siempre cabe
+  jmpnz $+3
+  cmp r13, r14
+  jmpnc $+4
+  sub r13, r14                    ;Resta el valor de prueba y pone el bit de la raiz en 1
+  subb r12, 0
+  or r11, 1
+  sub r15, 1
+  jmpnz mat_raiz32_lazo           ;@iteraciones 15
+  shl0 r1, 1                      ;Ultima vuelta: pasa los ultimos 2 bits al residuo
+  rolc r2
+  rolc r13
+  rolc r12
+  shl0 r1, 1
+  rolc r2
+  rolc r13
+  rolc r12
+  shl0 r11, 1
+  move r14, r11                   ;r15:r14 = raiz * 2 + 1
+  shl0 r14, 1
+  move r15, 0
+  rolc r15
+  or r14, 1
+  sub r13, r14                    ;C = 1 si el valor de prueba cabe en el residuo, y ese es el
+  subb r12, r15                   ;ultimo bit de la raiz
+  addc r11, 0
+  move r1, r11                    ;Devuelve la raiz
+  return
+
+;------------------------------------------------------------------------------------------------
+;Punto fijo Q15 y saturacion
+;------------------------------------------------------------------------------------------------
+;Los valores Q15 representan fracciones en el rango [-1, 1) como enteros de 16 bits con signo
+;(0x8000 = -1, 0x4000 = 0.5, 0x7FFF = 0.99997)
+
+;mat_q15_mul: r1 = r1 * r2 en Q15, redondeado y saturado (-1 * -1 da 0x7FFF)
+mat_q15_mul:
+  call mat_mul32s                 ;Producto en Q30
+  add r1, 0x4000                  ;Redondea al valor mas cercano
+  addc r2, 0
+  shl0 r1, 1                      ;r2 = bits 30 a 15 del producto, C = signo del producto
+  rolc r2
+  jmpc $+4                        ;Solo un producto positivo puede desbordarse, y el unico
+  cmp r2, 0x8000                  ;caso es -1 * -1
+  jmpnz $+2
+  move r2, 0x7FFF
+  move r1, r2
+  return
+
+;mat_sat_suma: r1 = r1 + r2 con signo, saturado a [0x8000, 0x7FFF] (tambien para Q15)
+mat_sat_suma:
+  add r1, r2
+  jmpv mat_saturar
+  return
+
+;mat_sat_resta: r1 = r1 - r2 con signo, saturado a [0x8000, 0x7FFF] (tambien para Q15)
+mat_sat_resta:
+  sub r1, r2
+  jmpv mat_saturar
+  return
+
+;mat_sat32: r1 = r2:r1 saturado a 16 bits con signo (por ejemplo para reducir un acumulador)
+mat_sat32:
+  test r1, r1                     ;La parte alta debe ser la extension del signo de la baja
+  jmpn $+4
+  test r2, r2
+  jmpnz $+5
+  return
+  cmp r2, 0xFFFF
+  jmpnz $+2
+  return
+  test r2, r2                     ;Fuera de rango: satura segun el signo del valor de 32 bits
+  jmpn $+3
+  move r1, 0x7FFF
+  return
+  move r1, 0x8000
+  return
+
+;Satura r1 despues de una suma o resta con desborde: si el resultado quedo negativo, el valor
+;real era positivo (y viceversa). Se llama con jmpv y usa las banderas de la operacion
+mat_saturar:
+  move r1, 0x7FFF                 ;move no altera las banderas
+  jmpn $+2
+  move r1, 0x8000
+  return
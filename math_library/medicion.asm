@@ -0,0 +1,109 @@
+;Programa de medicion de la libreria matematica para JPU16
+;
+;Invoca cada rutina de la libreria con operandos de ejemplo y guarda los resultados en RAM, para
+;poder revisarlos en simulacion. El tiempo de cada rutina (mejor y peor caso, en ciclos de
+;SysClk) lo calcula el ensamblador con la opcion -lst; el makefile lo extrae del listado con:
+;  $make ciclos
+;
+;Siga los pasos del archivo "readme_es.txt" para mas detalles.
+
+include "macros32.asm"            ;Las macros deben definirse antes de usarse
+
+data                              ;Resultados de cada prueba (valor esperado en el comentario)
+res_mul32u:   fill 2              ;0xFFFE 0x0001 (0xFFFF * 0xFFFF = 0xFFFE0001)
+res_mul32s:   fill 2              ;0xFFFC 0x5680 (-300 * 800 = -240000)
+res_mul32x32: fill 2              ;0x75CC 0xA2ED (0x00012345 * 0x00006789, 32 bits bajos)
+res_div16u:   fill 2              ;0x00F8 0x00E8 (60000 / 241 = 248, residuo 232)
+res_div16s:   fill 2              ;0xFE9B 0xFFFC (-10000 / 28 = -357, residuo -4)
+res_div32u:   fill 3              ;0x000B 0xA398 0x0298 (1000000000 / 1311 = 762776, residuo 664)
+res_div32s:   fill 3              ;0x0000 0x37CD 0xFFFB (-100000 / -7 = 14285, residuo -5)
+res_raiz16:   fill 1              ;0x00FF (raiz de 65535)
+res_raiz32:   fill 1              ;0xFFFF (raiz de 0xFFFFFFFF)
+res_q15_mul:  fill 2              ;0x2000 0x7FFF (0.5 * 0.5, -1 * -1)
+res_sat:      fill 3              ;0x7FFF 0x8000 0x8000 (30000 + 10000, -30000 - 10000, -70000)
+res_macros:   fill 2              ;0x0001 0x0000 (0x0000FFFF + 1)
+
+code
+inicio:
+  move r1, 0xFFFF                 ;Multiplicacion sin signo de 16x16 bits
+  move r2, 0xFFFF
+  call mat_mul32u
+  move [res_mul32u], r2
+  move [res_mul32u + 1], r1
+
+  move r1, -300                   ;Multiplicacion con signo de 16x16 bits
+  move r2, 800
+  call mat_mul32s
+  move [res_mul32s], r2
+  move [res_mul32s + 1], r1
+
+  move32 r2, r1, 0x00012345       ;Multiplicacion de 32x32 bits
+  move32 r4, r3, 0x00006789
+  call mat_mul32x32
+  move [res_mul32x32], r2
+  move [res_mul32x32 + 1], r1
+
+  move r1, 60000                  ;Division sin signo de 16 bits
+  move r2, 241
+  call mat_div16u
+  move [res_div16u], r1
+  move [res_div16u + 1], r3
+
+  move r1, -10000                 ;Division con signo de 16 bits
+  move r2, 28
+  call mat_div16s
+  move [res_div16s], r1
+  move [res_div16s + 1], r3
+
+  move32 r2, r1, 1000000000       ;Division sin signo de 32 entre 16 bits
+  move r3, 1311
+  call mat_div32u
+  move [res_div32u], r2
+  move [res_div32u + 1], r1
+  move [res_div32u + 2], r4
+
+  move32 r2, r1, -100000          ;Division con signo de 32 entre 16 bits
+  move r3, -7
+  call mat_div32s
+  move [res_div32s], r2
+  move [res_div32s + 1], r1
+  move [res_div32s + 2], r4
+
+  move r1, 65535                  ;Raiz cuadrada de 16 bits
+  call mat_raiz16
+  move [res_raiz16], r1
+
+  move32 r2, r1, 0xFFFFFFFF       ;Raiz cuadrada de 32 bits
+  call mat_raiz32
+  move [res_raiz32], r1
+
+  move r1, 0x4000                 ;Multiplicacion Q15
+  move r2, 0x4000
+  call mat_q15_mul
+  move [res_q15_mul], r1
+  move r1, 0x8000                 ;Caso de saturacion
+  move r2, 0x8000
+  call mat_q15_mul
+  move [res_q15_mul + 1], r1
+
+  move r1, 30000                  ;Suma y resta saturadas
+  move r2, 10000
+  call mat_sat_suma
+  move [res_sat], r1
+  move r1, -30000
+  move r2, 10000
+  call mat_sat_resta
+  move [res_sat + 1], r1
+  move32 r2, r1, -70000           ;Reduccion de 32 a 16 bits
+  call mat_sat32
+  move [res_sat + 2], r1
+
+  move32 r2, r1, 0x0000FFFF       ;Macros de 32 bits
+  add32 r2, r1, 0, 1
+  move [res_macros], r2
+  move [res_macros + 1], r1
+
+fin:
+  jmp fin                         ;Fin de las pruebas
+
+include "matematicas.asm"